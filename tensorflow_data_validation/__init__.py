@@ -73,12 +73,17 @@ from tensorflow_data_validation.utils.stats_gen_lib import generate_statistics_f
 from tensorflow_data_validation.utils.stats_gen_lib import generate_statistics_from_tfrecord
 
 # Import stats utilities.
+from tensorflow_data_validation.utils.stats_util import compact_stats_for_validation
 from tensorflow_data_validation.utils.stats_util import get_slice_stats
 from tensorflow_data_validation.utils.stats_util import load_statistics
+from tensorflow_data_validation.utils.stats_util import load_stats_columnar
 from tensorflow_data_validation.utils.stats_util import load_stats_text
+from tensorflow_data_validation.utils.stats_util import merge_statistics
+from tensorflow_data_validation.utils.stats_util import write_stats_columnar
 from tensorflow_data_validation.utils.stats_util import write_stats_text
 
 # Import validation lib.
+from tensorflow_data_validation.utils.validation_lib import load_anomalous_examples
 from tensorflow_data_validation.utils.validation_lib import validate_examples_in_csv
 from tensorflow_data_validation.utils.validation_lib import validate_examples_in_tfrecord
 
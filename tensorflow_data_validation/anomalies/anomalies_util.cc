@@ -0,0 +1,140 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/anomalies_util.h"
+
+#include <algorithm>
+#include <map>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/lib/core/errors.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+namespace {
+
+using tensorflow::metadata::v0::Anomalies;
+using tensorflow::metadata::v0::AnomalyInfo;
+
+// LINT.IfChange
+constexpr char kMultipleErrors[] = "Multiple errors";
+// LINT.ThenChange(../utils/anomalies_util.py)
+
+Status ParseAnomalies(const string& serialized_anomalies,
+                      Anomalies* anomalies) {
+  if (!anomalies->ParseFromString(serialized_anomalies)) {
+    return errors::InvalidArgument("Failed to parse Anomalies.");
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
+void UpdateAnomalyDescription(AnomalyInfo* anomaly_info) {
+  std::vector<const AnomalyInfo::Reason*> described_reasons;
+  bool all_schema_new_column = true;
+  for (const AnomalyInfo::Reason& reason : anomaly_info->reason()) {
+    if (reason.description().empty()) {
+      continue;
+    }
+    described_reasons.push_back(&reason);
+    all_schema_new_column &= reason.type() == AnomalyInfo::SCHEMA_NEW_COLUMN;
+  }
+  if (described_reasons.empty()) {
+    anomaly_info->clear_description();
+    anomaly_info->clear_short_description();
+  } else if (described_reasons.size() == 1 || all_schema_new_column) {
+    anomaly_info->set_description(described_reasons[0]->description());
+    anomaly_info->set_short_description(
+        described_reasons[0]->short_description());
+  } else {
+    string description;
+    for (const AnomalyInfo::Reason* reason : described_reasons) {
+      absl::StrAppend(&description, description.empty() ? "" : " ",
+                      reason->description());
+    }
+    anomaly_info->set_description(description);
+    anomaly_info->set_short_description(kMultipleErrors);
+  }
+}
+
+void RemoveAnomalyTypes(const std::set<AnomalyInfo::Type>& types_to_remove,
+                        Anomalies* anomalies) {
+  auto* anomaly_info = anomalies->mutable_anomaly_info();
+  for (auto iter = anomaly_info->begin(); iter != anomaly_info->end();) {
+    AnomalyInfo& info = iter->second;
+    auto* reasons = info.mutable_reason();
+    reasons->erase(
+        std::remove_if(reasons->begin(), reasons->end(),
+                       [&types_to_remove](const AnomalyInfo::Reason& reason) {
+                         return types_to_remove.count(reason.type()) > 0;
+                       }),
+        reasons->end());
+    if (reasons->empty()) {
+      iter = anomaly_info->erase(iter);
+      continue;
+    }
+    info.clear_diff_regions();
+    UpdateAnomalyDescription(&info);
+    ++iter;
+  }
+}
+
+Status RemoveAnomalyTypes(const std::set<AnomalyInfo::Type>& types_to_remove,
+                          std::vector<string>* serialized_anomalies) {
+  Anomalies anomalies;
+  for (string& serialized : *serialized_anomalies) {
+    TF_RETURN_IF_ERROR(ParseAnomalies(serialized, &anomalies));
+    RemoveAnomalyTypes(types_to_remove, &anomalies);
+    serialized.clear();
+    anomalies.SerializeToString(&serialized);
+  }
+  return Status::OK();
+}
+
+std::vector<string> GetAnomalyReasonSliceKeys(const Anomalies& anomalies) {
+  // The map of anomalies is unordered.
+  std::map<string, const AnomalyInfo*> ordered_anomaly_info;
+  for (const auto& name_and_info : anomalies.anomaly_info()) {
+    ordered_anomaly_info.emplace(name_and_info.first, &name_and_info.second);
+  }
+  std::vector<string> result;
+  for (const auto& name_and_info : ordered_anomaly_info) {
+    for (const AnomalyInfo::Reason& reason : name_and_info.second->reason()) {
+      const string& type_name = AnomalyInfo::Type_Name(reason.type());
+      result.push_back(absl::StrCat(
+          name_and_info.first, "_",
+          type_name.empty() ? absl::StrCat(reason.type()) : type_name));
+    }
+  }
+  return result;
+}
+
+Status GetAnomalyReasonSliceKeys(
+    const std::vector<string>& serialized_anomalies,
+    std::vector<std::vector<string>>* slice_keys) {
+  slice_keys->clear();
+  slice_keys->reserve(serialized_anomalies.size());
+  Anomalies anomalies;
+  for (const string& serialized : serialized_anomalies) {
+    TF_RETURN_IF_ERROR(ParseAnomalies(serialized, &anomalies));
+    slice_keys->push_back(GetAnomalyReasonSliceKeys(anomalies));
+  }
+  return Status::OK();
+}
+
+}  // namespace data_validation
+}  // namespace tensorflow
@@ -0,0 +1,68 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Post-processing of Anomalies protos, e.g. of the per-example anomalies
+// computed when identifying anomalous examples.
+#ifndef TENSORFLOW_DATA_VALIDATION_ANOMALIES_ANOMALIES_UTIL_H_
+#define TENSORFLOW_DATA_VALIDATION_ANOMALIES_ANOMALIES_UTIL_H_
+
+#include <set>
+#include <vector>
+
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow_metadata/proto/v0/anomalies.pb.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+// Sets the description and short description of <anomaly_info> from its
+// reasons, ignoring the reasons without a description. If there is only one
+// reason, or if all the reasons are SCHEMA_NEW_COLUMN, the descriptions of the
+// first one are used. Otherwise, the descriptions of the reasons are joined,
+// and the short description is "Multiple errors".
+void UpdateAnomalyDescription(
+    tensorflow::metadata::v0::AnomalyInfo* anomaly_info);
+
+// Removes the reasons of <types_to_remove> from <anomalies>, and updates the
+// descriptions of the anomalies from the remaining reasons. The anomalies
+// without remaining reasons are removed. The diff regions are cleared, as they
+// cannot be attributed to reasons.
+void RemoveAnomalyTypes(
+    const std::set<tensorflow::metadata::v0::AnomalyInfo::Type>&
+        types_to_remove,
+    tensorflow::metadata::v0::Anomalies* anomalies);
+
+// Same as above, but updates each of <serialized_anomalies> in place.
+Status RemoveAnomalyTypes(
+    const std::set<tensorflow::metadata::v0::AnomalyInfo::Type>&
+        types_to_remove,
+    std::vector<string>* serialized_anomalies);
+
+// Returns a slice key "<feature name>_<reason type name>" for each reason of
+// each anomaly of <anomalies>, ordered by feature name. The numbers of the
+// types without a name are used instead.
+std::vector<string> GetAnomalyReasonSliceKeys(
+    const tensorflow::metadata::v0::Anomalies& anomalies);
+
+// Same as above, for each of <serialized_anomalies>.
+Status GetAnomalyReasonSliceKeys(
+    const std::vector<string>& serialized_anomalies,
+    std::vector<std::vector<string>>* slice_keys);
+
+}  // namespace data_validation
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_DATA_VALIDATION_ANOMALIES_ANOMALIES_UTIL_H_
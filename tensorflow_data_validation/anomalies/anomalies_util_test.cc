@@ -0,0 +1,164 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/anomalies_util.h"
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow_data_validation/anomalies/test_util.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow_metadata/proto/v0/anomalies.pb.h"
+
+namespace tensorflow {
+namespace data_validation {
+namespace {
+
+using ::tensorflow::metadata::v0::Anomalies;
+using ::tensorflow::metadata::v0::AnomalyInfo;
+using testing::EqualsProto;
+using testing::ParseTextProtoOrDie;
+
+Anomalies GetTestAnomalies() {
+  return ParseTextProtoOrDie<Anomalies>(R"(
+    anomaly_info {
+      key: "feature_2"
+      value {
+        description: "Expected bytes but got string. Examples contain values "
+                     "missing from the schema."
+        severity: ERROR
+        short_description: "Multiple errors"
+        diff_regions { removed { start: 1 contents: "Test contents" } }
+        reason {
+          type: ENUM_TYPE_BYTES_NOT_STRING
+          short_description: "Bytes not string"
+          description: "Expected bytes but got string."
+        }
+        reason {
+          type: ENUM_TYPE_UNEXPECTED_STRING_VALUES
+          short_description: "Unexpected string values"
+          description: "Examples contain values missing from the schema."
+        }
+      }
+    }
+    anomaly_info {
+      key: "feature_1"
+      value {
+        description: "Expected bytes but got string."
+        severity: ERROR
+        short_description: "Bytes not string"
+        reason {
+          type: ENUM_TYPE_BYTES_NOT_STRING
+          short_description: "Bytes not string"
+          description: "Expected bytes but got string."
+        }
+      }
+    })");
+}
+
+TEST(AnomaliesUtilTest, UpdateAnomalyDescription) {
+  AnomalyInfo anomaly_info = ParseTextProtoOrDie<AnomalyInfo>(R"(
+    reason { type: SCHEMA_NEW_COLUMN short_description: "a" description: "A" }
+    reason { type: SCHEMA_NEW_COLUMN short_description: "b" description: "B" }
+  )");
+  UpdateAnomalyDescription(&anomaly_info);
+  EXPECT_EQ(anomaly_info.description(), "A");
+  EXPECT_EQ(anomaly_info.short_description(), "a");
+
+  anomaly_info.mutable_reason(1)->set_type(
+      AnomalyInfo::ENUM_TYPE_BYTES_NOT_STRING);
+  anomaly_info.add_reason()->set_short_description("c");
+  UpdateAnomalyDescription(&anomaly_info);
+  EXPECT_EQ(anomaly_info.description(), "A B");
+  EXPECT_EQ(anomaly_info.short_description(), "Multiple errors");
+
+  // The reasons without a description are ignored.
+  anomaly_info.mutable_reason(1)->clear_description();
+  UpdateAnomalyDescription(&anomaly_info);
+  EXPECT_EQ(anomaly_info.description(), "A");
+  EXPECT_EQ(anomaly_info.short_description(), "a");
+}
+
+TEST(AnomaliesUtilTest, RemoveAnomalyTypes) {
+  Anomalies anomalies = GetTestAnomalies();
+  RemoveAnomalyTypes({AnomalyInfo::ENUM_TYPE_BYTES_NOT_STRING}, &anomalies);
+  EXPECT_THAT(anomalies, EqualsProto(R"(
+    anomaly_info {
+      key: "feature_2"
+      value {
+        description: "Examples contain values missing from the schema."
+        severity: ERROR
+        short_description: "Unexpected string values"
+        reason {
+          type: ENUM_TYPE_UNEXPECTED_STRING_VALUES
+          short_description: "Unexpected string values"
+          description: "Examples contain values missing from the schema."
+        }
+      }
+    })"));
+}
+
+TEST(AnomaliesUtilTest, RemoveAnomalyTypesWithoutMatchingReasons) {
+  Anomalies anomalies = GetTestAnomalies();
+  RemoveAnomalyTypes({AnomalyInfo::SCHEMA_NEW_COLUMN}, &anomalies);
+  Anomalies expected = GetTestAnomalies();
+  (*expected.mutable_anomaly_info())["feature_2"].clear_diff_regions();
+  // The anomalies are compared by feature, as the order of maps is not
+  // deterministic.
+  ASSERT_EQ(anomalies.anomaly_info().size(), 2);
+  for (const auto& feature_and_info : expected.anomaly_info()) {
+    EXPECT_THAT(anomalies.anomaly_info().at(feature_and_info.first),
+                EqualsProto(feature_and_info.second));
+  }
+}
+
+TEST(AnomaliesUtilTest, RemoveAnomalyTypesSerialized) {
+  std::vector<string> serialized = {GetTestAnomalies().SerializeAsString(),
+                                    Anomalies().SerializeAsString()};
+  TF_ASSERT_OK(RemoveAnomalyTypes(
+      {AnomalyInfo::ENUM_TYPE_BYTES_NOT_STRING,
+       AnomalyInfo::ENUM_TYPE_UNEXPECTED_STRING_VALUES},
+      &serialized));
+  ASSERT_EQ(serialized.size(), 2);
+  for (const string& result : serialized) {
+    Anomalies anomalies;
+    ASSERT_TRUE(anomalies.ParseFromString(result));
+    EXPECT_THAT(anomalies, EqualsProto(""));
+  }
+  serialized = {"not a proto"};
+  EXPECT_FALSE(RemoveAnomalyTypes({}, &serialized).ok());
+}
+
+TEST(AnomaliesUtilTest, GetAnomalyReasonSliceKeys) {
+  EXPECT_EQ(
+      GetAnomalyReasonSliceKeys(GetTestAnomalies()),
+      std::vector<string>({"feature_1_ENUM_TYPE_BYTES_NOT_STRING",
+                           "feature_2_ENUM_TYPE_BYTES_NOT_STRING",
+                           "feature_2_ENUM_TYPE_UNEXPECTED_STRING_VALUES"}));
+
+  std::vector<std::vector<string>> slice_keys;
+  TF_ASSERT_OK(GetAnomalyReasonSliceKeys({Anomalies().SerializeAsString(),
+                                          GetTestAnomalies().SerializeAsString()},
+                                         &slice_keys));
+  ASSERT_EQ(slice_keys.size(), 2);
+  EXPECT_TRUE(slice_keys[0].empty());
+  EXPECT_EQ(slice_keys[1].size(), 3);
+  EXPECT_FALSE(GetAnomalyReasonSliceKeys({"not a proto"}, &slice_keys).ok());
+}
+
+}  // namespace
+}  // namespace data_validation
+}  // namespace tensorflow
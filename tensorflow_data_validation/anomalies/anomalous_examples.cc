@@ -0,0 +1,143 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/anomalous_examples.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/platform/fingerprint.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+AnomalousExamplesReservoir::AnomalousExamplesReservoir(
+    int64 max_exemplars_per_slice)
+    : max_exemplars_per_slice_(std::max<int64>(max_exemplars_per_slice, 0)) {}
+
+void AnomalousExamplesReservoir::AddExemplar(uint64 fingerprint,
+                                             const string& exemplar,
+                                             Slice* slice) {
+  if (max_exemplars_per_slice_ == 0) {
+    return;
+  }
+  std::set<std::pair<uint64, string>>& exemplars = slice->exemplars;
+  if (static_cast<int64>(exemplars.size()) == max_exemplars_per_slice_) {
+    // Compares the fingerprints first, so that the exemplar is only copied if
+    // it is kept.
+    const std::pair<uint64, string>& largest = *exemplars.rbegin();
+    if (fingerprint > largest.first ||
+        (fingerprint == largest.first && exemplar >= largest.second)) {
+      return;
+    }
+  }
+  if (exemplars.emplace(fingerprint, exemplar).second &&
+      static_cast<int64>(exemplars.size()) > max_exemplars_per_slice_) {
+    exemplars.erase(std::prev(exemplars.end()));
+  }
+}
+
+void AnomalousExamplesReservoir::Add(const string& slice_key,
+                                     const string& exemplar) {
+  Slice& slice = slices_[slice_key];
+  ++slice.num_examples;
+  AddExemplar(Fingerprint64(exemplar), exemplar, &slice);
+}
+
+Status AnomalousExamplesReservoir::Merge(
+    const AnomalousExamplesReservoir& other) {
+  if (other.max_exemplars_per_slice_ != max_exemplars_per_slice_) {
+    return errors::InvalidArgument(
+        "Cannot merge reservoirs of ", other.max_exemplars_per_slice_,
+        " and ", max_exemplars_per_slice_, " exemplars per slice.");
+  }
+  for (const auto& other_slice : other.slices_) {
+    Slice& slice = slices_[other_slice.first];
+    slice.num_examples += other_slice.second.num_examples;
+    for (const auto& exemplar : other_slice.second.exemplars) {
+      AddExemplar(exemplar.first, exemplar.second, &slice);
+    }
+  }
+  return Status::OK();
+}
+
+std::vector<string> AnomalousExamplesReservoir::GetSliceKeys() const {
+  std::vector<string> result;
+  result.reserve(slices_.size());
+  for (const auto& slice : slices_) {
+    result.push_back(slice.first);
+  }
+  return result;
+}
+
+std::vector<string> AnomalousExamplesReservoir::GetExemplars(
+    const string& slice_key) const {
+  std::vector<string> result;
+  auto iter = slices_.find(slice_key);
+  if (iter != slices_.end()) {
+    for (const auto& exemplar : iter->second.exemplars) {
+      result.push_back(exemplar.second);
+    }
+  }
+  return result;
+}
+
+int64 AnomalousExamplesReservoir::GetNumExamples(
+    const string& slice_key) const {
+  auto iter = slices_.find(slice_key);
+  return iter == slices_.end() ? 0 : iter->second.num_examples;
+}
+
+void AnomalousExamplesReservoir::ToProto(AnomalousExamples* proto) const {
+  proto->Clear();
+  proto->set_max_exemplars_per_slice(max_exemplars_per_slice_);
+  for (const auto& slice : slices_) {
+    AnomalousExamples::Slice* slice_proto = proto->add_slices();
+    slice_proto->set_slice_key(slice.first);
+    slice_proto->set_num_examples(slice.second.num_examples);
+    for (const auto& exemplar : slice.second.exemplars) {
+      slice_proto->add_exemplars()->set_value(exemplar.second);
+    }
+  }
+}
+
+Status AnomalousExamplesReservoir::FromProto(
+    const AnomalousExamples& proto, AnomalousExamplesReservoir* result) {
+  if (proto.max_exemplars_per_slice() < 0) {
+    return errors::InvalidArgument(
+        "Invalid number of exemplars per slice: ",
+        proto.max_exemplars_per_slice());
+  }
+  *result = AnomalousExamplesReservoir(proto.max_exemplars_per_slice());
+  for (const AnomalousExamples::Slice& slice_proto : proto.slices()) {
+    if (slice_proto.num_examples() < slice_proto.exemplars_size()) {
+      return errors::InvalidArgument(
+          "Slice ", slice_proto.slice_key(), " has more exemplars than "
+          "examples.");
+    }
+    Slice& slice = result->slices_[slice_proto.slice_key()];
+    slice.num_examples += slice_proto.num_examples();
+    for (const AnomalousExamples::Exemplar& exemplar :
+         slice_proto.exemplars()) {
+      result->AddExemplar(Fingerprint64(exemplar.value()), exemplar.value(),
+                          &slice);
+    }
+  }
+  return Status::OK();
+}
+
+}  // namespace data_validation
+}  // namespace tensorflow
@@ -0,0 +1,86 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Keeps bounded samples of the anomalous examples of each anomaly reason (see
+// IdentifyAnomalousExamples), so that exemplars of the offending examples can
+// be output without a second pass over the data.
+#ifndef TENSORFLOW_DATA_VALIDATION_ANOMALIES_ANOMALOUS_EXAMPLES_H_
+#define TENSORFLOW_DATA_VALIDATION_ANOMALIES_ANOMALOUS_EXAMPLES_H_
+
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "tensorflow_data_validation/anomalies/proto/anomalous_examples.pb.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+// Samples up to max_exemplars_per_slice distinct exemplars in each slice, e.g.
+// in each anomaly reason. The exemplars kept are those with the smallest
+// fingerprints, so the sample of a slice is uniform over its distinct
+// exemplars, does not depend on the order in which they were added, and two
+// reservoirs can be merged into the sample of the union of their exemplars.
+class AnomalousExamplesReservoir {
+ public:
+  explicit AnomalousExamplesReservoir(int64 max_exemplars_per_slice);
+
+  // Adds an anomalous example of the slice <slice_key>. <exemplar> is the
+  // serialized example, or any other bytes identifying it, e.g. its row index.
+  void Add(const string& slice_key, const string& exemplar);
+
+  // Returns an error if the reservoirs do not keep the same number of
+  // exemplars per slice.
+  Status Merge(const AnomalousExamplesReservoir& other);
+
+  // Returns the keys of the slices with anomalous examples, in order.
+  std::vector<string> GetSliceKeys() const;
+
+  // Returns the exemplars sampled in the slice <slice_key>, which are empty if
+  // the slice has no anomalous examples.
+  std::vector<string> GetExemplars(const string& slice_key) const;
+
+  // Returns the number of anomalous examples added in the slice <slice_key>,
+  // including those which were not sampled.
+  int64 GetNumExamples(const string& slice_key) const;
+
+  int64 max_exemplars_per_slice() const { return max_exemplars_per_slice_; }
+
+  void ToProto(AnomalousExamples* proto) const;
+  static Status FromProto(const AnomalousExamples& proto,
+                          AnomalousExamplesReservoir* result);
+
+ private:
+  struct Slice {
+    int64 num_examples = 0;
+    // The sampled exemplars, ordered by fingerprint.
+    std::set<std::pair<uint64, string>> exemplars;
+  };
+
+  // Adds <exemplar> to the sample of <slice>, if its fingerprint is among the
+  // max_exemplars_per_slice_ smallest.
+  void AddExemplar(uint64 fingerprint, const string& exemplar, Slice* slice);
+
+  int64 max_exemplars_per_slice_;
+  std::map<string, Slice> slices_;
+};
+
+}  // namespace data_validation
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_DATA_VALIDATION_ANOMALIES_ANOMALOUS_EXAMPLES_H_
@@ -0,0 +1,143 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/anomalous_examples.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/strings/str_cat.h"
+#include "tensorflow_data_validation/anomalies/proto/anomalous_examples.pb.h"
+#include "tensorflow_data_validation/anomalies/test_util.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+
+namespace tensorflow {
+namespace data_validation {
+namespace {
+
+using testing::EqualsProto;
+using testing::ParseTextProtoOrDie;
+
+TEST(AnomalousExamplesReservoirTest, KeepsAllExemplarsBelowBound) {
+  AnomalousExamplesReservoir reservoir(3);
+  reservoir.Add("reason_b", "b0");
+  reservoir.Add("reason_a", "a0");
+  reservoir.Add("reason_a", "a1");
+  // Identical exemplars are only sampled once, but counted each time.
+  reservoir.Add("reason_a", "a0");
+
+  EXPECT_EQ(reservoir.GetSliceKeys(),
+            std::vector<string>({"reason_a", "reason_b"}));
+  const std::vector<string> exemplars = reservoir.GetExemplars("reason_a");
+  EXPECT_EQ(std::set<string>(exemplars.begin(), exemplars.end()),
+            std::set<string>({"a0", "a1"}));
+  EXPECT_EQ(reservoir.GetNumExamples("reason_a"), 3);
+  EXPECT_EQ(reservoir.GetExemplars("reason_b"), std::vector<string>({"b0"}));
+  EXPECT_EQ(reservoir.GetNumExamples("reason_b"), 1);
+  EXPECT_TRUE(reservoir.GetExemplars("reason_c").empty());
+  EXPECT_EQ(reservoir.GetNumExamples("reason_c"), 0);
+}
+
+TEST(AnomalousExamplesReservoirTest, BoundsExemplarsPerSlice) {
+  AnomalousExamplesReservoir forward(5);
+  AnomalousExamplesReservoir backward(5);
+  for (int i = 0; i < 100; ++i) {
+    forward.Add("reason", absl::StrCat("example_", i));
+    backward.Add("reason", absl::StrCat("example_", 99 - i));
+  }
+  EXPECT_EQ(forward.GetExemplars("reason").size(), 5);
+  EXPECT_EQ(forward.GetNumExamples("reason"), 100);
+  // The sample does not depend on the order of the examples.
+  EXPECT_EQ(forward.GetExemplars("reason"), backward.GetExemplars("reason"));
+}
+
+TEST(AnomalousExamplesReservoirTest, MergeEqualsSampleOfUnion) {
+  AnomalousExamplesReservoir all(4);
+  AnomalousExamplesReservoir first(4);
+  AnomalousExamplesReservoir second(4);
+  for (int i = 0; i < 50; ++i) {
+    const string exemplar = absl::StrCat("example_", i);
+    all.Add("reason", exemplar);
+    (i % 3 == 0 ? first : second).Add("reason", exemplar);
+  }
+  second.Add("other_reason", "example_0");
+  all.Add("other_reason", "example_0");
+
+  TF_ASSERT_OK(first.Merge(second));
+  AnomalousExamples expected;
+  all.ToProto(&expected);
+  AnomalousExamples actual;
+  first.ToProto(&actual);
+  EXPECT_THAT(actual, EqualsProto(expected));
+}
+
+TEST(AnomalousExamplesReservoirTest, MergeFailsOnDifferentBounds) {
+  AnomalousExamplesReservoir reservoir(4);
+  EXPECT_FALSE(reservoir.Merge(AnomalousExamplesReservoir(5)).ok());
+}
+
+TEST(AnomalousExamplesReservoirTest, ZeroExemplarsOnlyCounts) {
+  AnomalousExamplesReservoir reservoir(0);
+  reservoir.Add("reason", "example");
+  EXPECT_TRUE(reservoir.GetExemplars("reason").empty());
+  EXPECT_EQ(reservoir.GetNumExamples("reason"), 1);
+}
+
+TEST(AnomalousExamplesReservoirTest, ProtoRoundTrip) {
+  AnomalousExamplesReservoir reservoir(2);
+  reservoir.Add("reason_a", "a0");
+  reservoir.Add("reason_a", "a1");
+  reservoir.Add("reason_a", "a2");
+  reservoir.Add("reason_b", "b0");
+  AnomalousExamples proto;
+  reservoir.ToProto(&proto);
+  EXPECT_EQ(proto.max_exemplars_per_slice(), 2);
+  ASSERT_EQ(proto.slices_size(), 2);
+  EXPECT_EQ(proto.slices(0).slice_key(), "reason_a");
+  EXPECT_EQ(proto.slices(0).num_examples(), 3);
+  EXPECT_EQ(proto.slices(0).exemplars_size(), 2);
+
+  AnomalousExamplesReservoir restored(0);
+  TF_ASSERT_OK(AnomalousExamplesReservoir::FromProto(proto, &restored));
+  AnomalousExamples restored_proto;
+  restored.ToProto(&restored_proto);
+  EXPECT_THAT(restored_proto, EqualsProto(proto));
+}
+
+TEST(AnomalousExamplesReservoirTest, FromProtoFailsOnInvalidProto) {
+  AnomalousExamplesReservoir reservoir(0);
+  EXPECT_FALSE(AnomalousExamplesReservoir::FromProto(
+                   ParseTextProtoOrDie<AnomalousExamples>(
+                       "max_exemplars_per_slice: -1"),
+                   &reservoir)
+                   .ok());
+  EXPECT_FALSE(AnomalousExamplesReservoir::FromProto(
+                   ParseTextProtoOrDie<AnomalousExamples>(R"(
+                     max_exemplars_per_slice: 2
+                     slices {
+                       slice_key: "reason"
+                       num_examples: 1
+                       exemplars { value: "a" }
+                       exemplars { value: "b" }
+                     })"),
+                   &reservoir)
+                   .ok());
+}
+
+}  // namespace
+}  // namespace data_validation
+}  // namespace tensorflow
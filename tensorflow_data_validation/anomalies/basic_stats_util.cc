@@ -0,0 +1,517 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/basic_stats_util.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <utility>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/lib/core/errors.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+namespace {
+
+using ::tensorflow::metadata::v0::CommonStatistics;
+using ::tensorflow::metadata::v0::DatasetFeatureStatistics;
+using ::tensorflow::metadata::v0::FeatureNameStatistics;
+using ::tensorflow::metadata::v0::Histogram;
+using ::tensorflow::metadata::v0::NumericStatistics;
+using ::tensorflow::metadata::v0::WeightedCommonStatistics;
+
+struct Bucket {
+  double low_value;
+  double high_value;
+  double sample_count;
+};
+
+void AddBucket(const Bucket& bucket, Histogram* histogram) {
+  Histogram::Bucket* result = histogram->add_buckets();
+  result->set_low_value(bucket.low_value);
+  result->set_high_value(bucket.high_value);
+  result->set_sample_count(bucket.sample_count);
+}
+
+// Generates equal-width buckets from finite, sorted quantile boundaries.
+Status GenerateEquiWidthBucketsFromFiniteBoundaries(
+    const std::vector<double>& quantiles, double sample_count, int num_buckets,
+    std::vector<Bucket>* result) {
+  // Returns the sample count of the quantile intervals in
+  // [start_pos, quantiles[end_index - 1]], where start_pos is in the interval
+  // starting at quantiles[start_index].
+  const auto compute_count = [&](int start_index, int end_index,
+                                 double start_pos) {
+    double count = (end_index - start_index - 1) * sample_count;
+    if (start_pos > quantiles[start_index]) {
+      count -= sample_count;
+      count += (quantiles[start_index + 1] - start_pos) * sample_count /
+               (quantiles[start_index + 1] - quantiles[start_index]);
+    }
+    return count;
+  };
+
+  const double min_value = quantiles.front();
+  const double max_value = quantiles.back();
+  const double width = (max_value - min_value) / num_buckets;
+  std::vector<double> bucket_boundaries;
+  bucket_boundaries.reserve(num_buckets);
+  for (int i = 0; i < num_buckets; ++i) {
+    bucket_boundaries.push_back(min_value + i * width);
+  }
+  if (bucket_boundaries.back() > max_value) {
+    return errors::Internal("Invalid bucket boundaries for quantiles in [",
+                            min_value, ", ", max_value, "].");
+  }
+
+  // The index of the quantile interval being processed, and the position in
+  // that interval.
+  int quantile_index = 0;
+  double quantile_pos = quantiles[quantile_index];
+  for (int i = 0; i + 1 < num_buckets; ++i) {
+    const double bucket_start = bucket_boundaries[i];
+    const double bucket_end = bucket_boundaries[i + 1];
+    double bucket_count = 0;
+    // The end of the quantile interval in which the bucket ends.
+    const int end_index =
+        std::lower_bound(quantiles.begin() + quantile_index, quantiles.end(),
+                         bucket_end) -
+        quantiles.begin();
+    if (end_index == 0 || end_index == quantiles.size()) {
+      return errors::Internal("Bucket boundary ", bucket_end,
+                              " is out of the quantiles range.");
+    }
+    // Add the count of the full quantile intervals in the bucket.
+    if (end_index > quantile_index + 1) {
+      bucket_count += compute_count(quantile_index, end_index, quantile_pos);
+      quantile_pos = quantiles[end_index - 1];
+    }
+    // Add the count of the partial last quantile interval, assuming that
+    // values are uniformly distributed in the interval.
+    bucket_count += (bucket_end - quantile_pos) * sample_count /
+                    (quantiles[end_index] - quantiles[end_index - 1]);
+    result->push_back({bucket_start, bucket_end, bucket_count});
+
+    quantile_pos = bucket_end;
+    quantile_index =
+        quantile_pos < quantiles[end_index] ? end_index - 1 : end_index;
+  }
+  // The last bucket includes its end boundary.
+  result->push_back(
+      {bucket_boundaries.back(), quantiles.back(),
+       compute_count(quantile_index, quantiles.size(), quantile_pos)});
+  return Status::OK();
+}
+
+// Converts presence and valency stats into the corresponding protos. The
+// missing count of level i is relative to the total number of values of level
+// i - 1, or of the parent feature (if any) for level 0.
+void AddPresenceAndValencyStats(const PresenceAndValencyStats* parent,
+                                const PartialBasicStats& feature,
+                                bool has_weights, CommonStatistics* result) {
+  const PresenceAndValencyStats* previous = parent;
+  for (const PresenceAndValencyStats& stats :
+       feature.presence_and_valency_stats) {
+    metadata::v0::PresenceAndValencyStatistics* proto =
+        result->add_presence_and_valency_stats();
+    if (previous != nullptr) {
+      proto->set_num_missing(previous->total_num_values -
+                             stats.num_non_missing);
+    }
+    proto->set_num_non_missing(stats.num_non_missing);
+    if (stats.num_non_missing > 0) {
+      proto->set_min_num_values(stats.min_num_values);
+      proto->set_max_num_values(stats.max_num_values);
+      proto->set_tot_num_values(stats.total_num_values);
+    }
+    if (has_weights) {
+      WeightedCommonStatistics* weighted_proto =
+          result->add_weighted_presence_and_valency_stats();
+      if (previous != nullptr) {
+        weighted_proto->set_num_missing(previous->weighted_total_num_values -
+                                        stats.weighted_num_non_missing);
+      }
+      weighted_proto->set_num_non_missing(stats.weighted_num_non_missing);
+      weighted_proto->set_tot_num_values(stats.weighted_total_num_values);
+      if (stats.weighted_num_non_missing > 0) {
+        weighted_proto->set_avg_num_values(stats.weighted_total_num_values /
+                                           stats.weighted_num_non_missing);
+      }
+    }
+    previous = &stats;
+  }
+}
+
+Status MakeCommonStats(const PartialBasicStats& feature,
+                       const PartialBasicStats* parent,
+                       const BasicStatsOptions& options,
+                       CommonStatistics* result) {
+  static const PresenceAndValencyStats kEmptyStats;
+  const PresenceAndValencyStats* parent_stats = nullptr;
+  if (parent != nullptr) {
+    parent_stats = parent->presence_and_valency_stats.empty()
+                       ? &kEmptyStats
+                       : &parent->presence_and_valency_stats.back();
+  }
+  // The stats of a 1-nested feature are already in the CommonStatistics.
+  if (feature.presence_and_valency_stats.size() > 1) {
+    AddPresenceAndValencyStats(parent_stats, feature, options.has_weights,
+                               result);
+  }
+
+  const PresenceAndValencyStats& top_level =
+      feature.presence_and_valency_stats.empty()
+          ? kEmptyStats
+          : feature.presence_and_valency_stats.front();
+  result->set_num_non_missing(top_level.num_non_missing);
+  if (parent_stats != nullptr) {
+    result->set_num_missing(parent_stats->total_num_values -
+                            top_level.num_non_missing);
+  }
+  result->set_tot_num_values(top_level.total_num_values);
+  if (top_level.num_non_missing > 0) {
+    result->set_min_num_values(top_level.min_num_values);
+    result->set_max_num_values(top_level.max_num_values);
+    result->set_avg_num_values(static_cast<double>(top_level.total_num_values) /
+                               top_level.num_non_missing);
+    if (feature.num_values_quantiles.empty()) {
+      return errors::InvalidArgument("Missing num values quantiles for ",
+                                     feature.path.Serialize(), ".");
+    }
+    TF_RETURN_IF_ERROR(GenerateQuantilesHistogram(
+        feature.num_values_quantiles.front(), top_level.num_non_missing,
+        options.num_values_histogram_buckets,
+        result->mutable_num_values_histogram()));
+  }
+
+  if (options.has_weights) {
+    WeightedCommonStatistics* weighted_stats =
+        result->mutable_weighted_common_stats();
+    weighted_stats->set_num_non_missing(top_level.weighted_num_non_missing);
+    weighted_stats->set_tot_num_values(top_level.weighted_total_num_values);
+    if (parent_stats != nullptr) {
+      weighted_stats->set_num_missing(parent_stats->weighted_total_num_values -
+                                      top_level.weighted_num_non_missing);
+    }
+    if (top_level.weighted_num_non_missing > 0) {
+      weighted_stats->set_avg_num_values(top_level.weighted_total_num_values /
+                                         top_level.weighted_num_non_missing);
+    }
+  }
+  return Status::OK();
+}
+
+// Adds the standard and quantiles histograms of <quantiles> to <histograms>.
+Status AddValueHistograms(
+    const PartialBasicStats& feature, const std::vector<double>& quantiles,
+    double total_count, const BasicStatsOptions& options,
+    google::protobuf::RepeatedPtrField<Histogram>* histograms) {
+  Histogram* standard_histogram = histograms->Add();
+  TF_RETURN_IF_ERROR(GenerateEquiWidthHistogram(
+      quantiles, feature.finite_min, feature.finite_max, total_count,
+      options.num_histogram_buckets, standard_histogram));
+  standard_histogram->set_num_nan(feature.num_nan);
+  Histogram* quantiles_histogram = histograms->Add();
+  TF_RETURN_IF_ERROR(GenerateQuantilesHistogram(
+      quantiles, total_count, options.num_quantiles_histogram_buckets,
+      quantiles_histogram));
+  quantiles_histogram->set_num_nan(feature.num_nan);
+  return Status::OK();
+}
+
+Status MakeNumericStats(const PartialBasicStats& feature,
+                        int64 total_num_values,
+                        const BasicStatsOptions& options,
+                        NumericStatistics* result) {
+  total_num_values -= feature.num_nan;
+  if (total_num_values == 0) {
+    // If there are only NaN values, only num_nan is set.
+    if (feature.num_nan > 0) {
+      Histogram* standard_histogram = result->add_histograms();
+      standard_histogram->set_type(Histogram::STANDARD);
+      standard_histogram->set_num_nan(feature.num_nan);
+      Histogram* quantiles_histogram = result->add_histograms();
+      quantiles_histogram->set_type(Histogram::QUANTILES);
+      quantiles_histogram->set_num_nan(feature.num_nan);
+    }
+    return Status::OK();
+  }
+  if (feature.quantiles.empty()) {
+    return errors::InvalidArgument("Missing quantiles for ",
+                                   feature.path.Serialize(), ".");
+  }
+
+  const double mean = feature.sum / total_num_values;
+  const double variance =
+      std::max(0.0, feature.sum_of_squares / total_num_values - mean * mean);
+  result->set_mean(mean);
+  result->set_std_dev(std::sqrt(variance));
+  result->set_num_zeros(feature.num_zeros);
+  result->set_min(feature.min);
+  result->set_max(feature.max);
+  result->set_median(FindMedian(feature.quantiles));
+  TF_RETURN_IF_ERROR(AddValueHistograms(feature, feature.quantiles,
+                                        total_num_values, options,
+                                        result->mutable_histograms()));
+
+  if (options.has_weights) {
+    if (feature.weighted_quantiles.empty()) {
+      return errors::InvalidArgument("Missing weighted quantiles for ",
+                                     feature.path.Serialize(), ".");
+    }
+    metadata::v0::WeightedNumericStatistics* weighted_stats =
+        result->mutable_weighted_numeric_stats();
+    double weighted_mean = 0;
+    double weighted_variance = 0;
+    if (feature.weighted_total_num_values != 0) {
+      weighted_mean = feature.weighted_sum / feature.weighted_total_num_values;
+      weighted_variance = std::max(
+          0.0, feature.weighted_sum_of_squares /
+                       feature.weighted_total_num_values -
+                   weighted_mean * weighted_mean);
+    }
+    weighted_stats->set_mean(weighted_mean);
+    weighted_stats->set_std_dev(std::sqrt(weighted_variance));
+    weighted_stats->set_median(FindMedian(feature.weighted_quantiles));
+    TF_RETURN_IF_ERROR(AddValueHistograms(
+        feature, feature.weighted_quantiles, feature.weighted_total_num_values,
+        options, weighted_stats->mutable_histograms()));
+  }
+  return Status::OK();
+}
+
+// Adds the histograms of the number of values of the nest levels > 1 as
+// custom stats. The histogram of level 1 is in the common stats.
+Status AddNumValuesCustomStats(const PartialBasicStats& feature,
+                               const BasicStatsOptions& options,
+                               FeatureNameStatistics* result) {
+  if (!feature.has_type) {
+    return Status::OK();
+  }
+  const auto& stats = feature.presence_and_valency_stats;
+  for (int level = 1; level < stats.size(); ++level) {
+    if (level >= feature.num_values_quantiles.size()) {
+      return errors::InvalidArgument("Missing num values quantiles for ",
+                                     feature.path.Serialize(), ".");
+    }
+    metadata::v0::CustomStatistic* custom_stat = result->add_custom_stats();
+    custom_stat->set_name(
+        absl::StrCat("level_", level + 1, "_value_list_length"));
+    TF_RETURN_IF_ERROR(GenerateQuantilesHistogram(
+        feature.num_values_quantiles[level], stats[level - 1].num_non_missing,
+        options.num_values_histogram_buckets,
+        custom_stat->mutable_histogram()));
+  }
+  return Status::OK();
+}
+
+Status MakeFeatureStats(const PartialBasicStats& feature,
+                        const PartialBasicStats* parent,
+                        const BasicStatsOptions& options,
+                        FeatureNameStatistics* result) {
+  *result->mutable_path() = feature.path.AsProto();
+  // Categorical features keep their INT type. Features whose type is unknown
+  // (i.e. that are always missing) are assumed to be STRING.
+  if (feature.is_categorical) {
+    result->set_type(FeatureNameStatistics::INT);
+  } else if (feature.is_bytes) {
+    result->set_type(FeatureNameStatistics::BYTES);
+  } else if (!feature.has_type) {
+    result->set_type(FeatureNameStatistics::STRING);
+  } else {
+    result->set_type(feature.type);
+  }
+
+  CommonStatistics common_stats;
+  TF_RETURN_IF_ERROR(MakeCommonStats(feature, parent, options, &common_stats));
+  // The total number of values at the leaf level.
+  const int64 total_num_values =
+      feature.presence_and_valency_stats.empty()
+          ? 0
+          : feature.presence_and_valency_stats.back().total_num_values;
+
+  if (feature.is_bytes) {
+    metadata::v0::BytesStatistics* bytes_stats = result->mutable_bytes_stats();
+    if (common_stats.tot_num_values() > 0) {
+      bytes_stats->set_avg_num_bytes(
+          static_cast<double>(feature.total_num_bytes) /
+          common_stats.tot_num_values());
+      bytes_stats->set_min_num_bytes(feature.min_num_bytes);
+      bytes_stats->set_max_num_bytes(feature.max_num_bytes);
+    }
+    *bytes_stats->mutable_common_stats() = common_stats;
+  }
+  if (feature.is_categorical ||
+      result->type() == FeatureNameStatistics::STRING) {
+    metadata::v0::StringStatistics* string_stats =
+        result->mutable_string_stats();
+    if (total_num_values > 0) {
+      string_stats->set_avg_length(
+          static_cast<double>(feature.total_bytes_length) / total_num_values);
+    }
+    *string_stats->mutable_common_stats() = std::move(common_stats);
+  } else if (result->type() == FeatureNameStatistics::STRUCT) {
+    *result->mutable_struct_stats()->mutable_common_stats() =
+        std::move(common_stats);
+  } else if (result->type() == FeatureNameStatistics::INT ||
+             result->type() == FeatureNameStatistics::FLOAT) {
+    NumericStatistics* numeric_stats = result->mutable_num_stats();
+    TF_RETURN_IF_ERROR(
+        MakeNumericStats(feature, total_num_values, options, numeric_stats));
+    *numeric_stats->mutable_common_stats() = std::move(common_stats);
+  }
+  return AddNumValuesCustomStats(feature, options, result);
+}
+
+}  // namespace
+
+double FindMedian(const std::vector<double>& quantiles) {
+  const int median_index = quantiles.size() / 2;
+  if (quantiles.size() % 2 == 0) {
+    // The boundaries are float32 values, and so is their mean.
+    return (static_cast<float>(quantiles[median_index - 1]) +
+            static_cast<float>(quantiles[median_index])) /
+           2.0f;
+  }
+  return quantiles[median_index];
+}
+
+Status GenerateQuantilesHistogram(const std::vector<double>& quantiles,
+                                  double total_count, int num_buckets,
+                                  Histogram* histogram) {
+  histogram->set_type(Histogram::QUANTILES);
+  const int num_intervals = quantiles.size() - 1;
+  if (num_intervals <= 0 || num_intervals % num_buckets != 0) {
+    return errors::InvalidArgument(
+        "The number of quantile intervals (", num_intervals,
+        ") must be a multiple of the number of buckets (", num_buckets, ").");
+  }
+  const double sample_count = total_count / num_intervals;
+  const int width = num_intervals / num_buckets;
+  for (int i = 0; i + width < quantiles.size(); i += width) {
+    AddBucket({quantiles[i], quantiles[i + width], sample_count * width},
+              histogram);
+  }
+  return Status::OK();
+}
+
+Status GenerateEquiWidthHistogram(const std::vector<double>& quantiles,
+                                  double finite_min, double finite_max,
+                                  double total_count, int num_buckets,
+                                  Histogram* histogram) {
+  histogram->set_type(Histogram::STANDARD);
+  if (quantiles.size() <= num_buckets) {
+    return errors::InvalidArgument("There must be more quantile boundaries (",
+                                   quantiles.size(), ") than buckets (",
+                                   num_buckets, ").");
+  }
+  // If all the values are equal, there is a single bucket.
+  if (quantiles.front() == quantiles.back()) {
+    AddBucket({quantiles.front(), quantiles.back(), total_count}, histogram);
+    return Status::OK();
+  }
+
+  constexpr double kInfinity = std::numeric_limits<double>::infinity();
+  const int num_quantiles = quantiles.size();
+  // The indices of the first and the last finite boundaries.
+  const int finite_min_index =
+      std::upper_bound(quantiles.begin(), quantiles.end(), -kInfinity) -
+      quantiles.begin();
+  const int finite_max_index =
+      std::lower_bound(quantiles.begin(), quantiles.end(), kInfinity) -
+      quantiles.begin() - 1;
+  // The sample count of a quantile interval.
+  const double sample_count = total_count / (num_quantiles - 1);
+
+  // If there are only -inf and +inf values, the count of the interval
+  // (-inf, +inf) is divided equally between (-inf, -inf) and (+inf, +inf).
+  if (finite_max_index < finite_min_index) {
+    AddBucket({-kInfinity, -kInfinity, (finite_min_index - 0.5) * sample_count},
+              histogram);
+    AddBucket({kInfinity, kInfinity,
+               (num_quantiles - finite_max_index - 1.5) * sample_count},
+              histogram);
+    return Status::OK();
+  }
+
+  // The counts of the (-inf, -inf) and (+inf, +inf) intervals.
+  double start_bucket_count = finite_min_index * sample_count;
+  double last_bucket_count =
+      (num_quantiles - finite_max_index - 1) * sample_count;
+  std::vector<double> finite_quantiles(
+      quantiles.begin() + finite_min_index,
+      quantiles.begin() + finite_max_index + 1);
+  // Add the finite min and max as boundaries if they are not already the first
+  // and last finite boundaries. The count of the added intervals is borrowed
+  // from the infinite intervals, which are merged into the first and last
+  // buckets anyway.
+  if (finite_min_index > 0 && finite_min < finite_quantiles.front()) {
+    finite_quantiles.insert(finite_quantiles.begin(), finite_min);
+    start_bucket_count -= sample_count;
+  }
+  if (finite_max_index < num_quantiles - 1 &&
+      finite_max > finite_quantiles.back()) {
+    finite_quantiles.push_back(finite_max);
+    last_bucket_count -= sample_count;
+  }
+  if (!std::is_sorted(finite_quantiles.begin(), finite_quantiles.end())) {
+    return errors::Internal("Quantiles output not sorted.");
+  }
+
+  std::vector<Bucket> buckets;
+  TF_RETURN_IF_ERROR(GenerateEquiWidthBucketsFromFiniteBoundaries(
+      finite_quantiles, sample_count, num_buckets, &buckets));
+  // Account for the -inf and +inf values in the first and last buckets.
+  if (finite_min_index > 0) {
+    buckets.front().low_value = -kInfinity;
+    buckets.front().sample_count += start_bucket_count;
+  }
+  if (finite_max_index < num_quantiles - 1) {
+    buckets.back().high_value = kInfinity;
+    buckets.back().sample_count += last_bucket_count;
+  }
+  for (const Bucket& bucket : buckets) {
+    AddBucket(bucket, histogram);
+  }
+  return Status::OK();
+}
+
+Status MakeBasicStatistics(const std::vector<PartialBasicStats>& features,
+                           const BasicStatsOptions& options,
+                           DatasetFeatureStatistics* result) {
+  std::map<Path, int> feature_index;
+  for (int i = 0; i < features.size(); ++i) {
+    feature_index.emplace(features[i].path, i);
+  }
+  for (const PartialBasicStats& feature : features) {
+    const PartialBasicStats* parent = nullptr;
+    if (feature.path.size() > 1) {
+      const auto it = feature_index.find(feature.path.GetParent());
+      if (it != feature_index.end()) {
+        parent = &features[it->second];
+      }
+    }
+    TF_RETURN_IF_ERROR(
+        MakeFeatureStats(feature, parent, options, result->add_features()));
+  }
+  return Status::OK();
+}
+
+}  // namespace data_validation
+}  // namespace tensorflow
@@ -0,0 +1,128 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Constructs the FeatureNameStatistics protos output by BasicStatsGenerator
+// from its (merged) partial statistics, including the histograms generated
+// from quantile boundaries.
+#ifndef TENSORFLOW_DATA_VALIDATION_ANOMALIES_BASIC_STATS_UTIL_H_
+#define TENSORFLOW_DATA_VALIDATION_ANOMALIES_BASIC_STATS_UTIL_H_
+
+#include <vector>
+
+#include "tensorflow_data_validation/anomalies/path.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow_metadata/proto/v0/statistics.pb.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+// Presence and valency statistics of one nest level of a feature.
+struct PresenceAndValencyStats {
+  int64 num_non_missing = 0;
+  int64 min_num_values = 0;
+  int64 max_num_values = 0;
+  int64 total_num_values = 0;
+  double weighted_num_non_missing = 0;
+  double weighted_total_num_values = 0;
+};
+
+// The partial statistics of a feature computed by BasicStatsGenerator, with
+// the quantile boundaries already extracted from the quantile summaries.
+struct PartialBasicStats {
+  Path path;
+  // False iff the type of the feature is unknown (i.e. all its values are
+  // missing).
+  bool has_type = false;
+  metadata::v0::FeatureNameStatistics::Type type =
+      metadata::v0::FeatureNameStatistics::INT;
+  bool is_bytes = false;
+  bool is_categorical = false;
+
+  // Common statistics. presence_and_valency_stats[i] holds the statistics of
+  // nest level i; it is empty if no value was ever seen for the feature.
+  std::vector<PresenceAndValencyStats> presence_and_valency_stats;
+  // num_values_quantiles[i] holds the quantiles of the number of values at
+  // nest level i. Only needed for the levels whose histogram is output (i.e.
+  // level 0 if it has non-missing values, and the other levels if has_type).
+  std::vector<std::vector<double>> num_values_quantiles;
+
+  // Numeric statistics. The quantiles are only needed if the feature has
+  // non-NaN values.
+  double sum = 0;
+  double sum_of_squares = 0;
+  int64 num_zeros = 0;
+  int64 num_nan = 0;
+  double min = 0;
+  double max = 0;
+  double finite_min = 0;
+  double finite_max = 0;
+  std::vector<double> quantiles;
+  double weighted_sum = 0;
+  double weighted_sum_of_squares = 0;
+  double weighted_total_num_values = 0;
+  std::vector<double> weighted_quantiles;
+
+  // String statistics.
+  int64 total_bytes_length = 0;
+
+  // Bytes statistics.
+  int64 total_num_bytes = 0;
+  int64 min_num_bytes = 0;
+  int64 max_num_bytes = 0;
+};
+
+struct BasicStatsOptions {
+  // Number of buckets of the quantiles histograms of the number of values.
+  int num_values_histogram_buckets = 10;
+  // Number of buckets of the standard (equi-width) histograms of the values.
+  int num_histogram_buckets = 10;
+  // Number of buckets of the quantiles histograms of the values.
+  int num_quantiles_histogram_buckets = 10;
+  bool has_weights = false;
+};
+
+// Returns the median given the quantile boundaries of float32 values. If there
+// is an even number of boundaries, this is the mean of the middle ones.
+double FindMedian(const std::vector<double>& quantiles);
+
+// Generates a QUANTILES histogram with <num_buckets> buckets from the quantile
+// boundaries of <total_count> values. (quantiles.size() - 1) must be a multiple
+// of <num_buckets>.
+Status GenerateQuantilesHistogram(const std::vector<double>& quantiles,
+                                  double total_count, int num_buckets,
+                                  metadata::v0::Histogram* histogram);
+
+// Generates a STANDARD histogram with <num_buckets> equal-width buckets from
+// the quantile boundaries of <total_count> values, assuming that values are
+// uniformly distributed between consecutive boundaries. There must be more
+// boundaries than buckets. Infinite values are accounted for in the first and
+// last buckets.
+Status GenerateEquiWidthHistogram(const std::vector<double>& quantiles,
+                                  double finite_min, double finite_max,
+                                  double total_count, int num_buckets,
+                                  metadata::v0::Histogram* histogram);
+
+// Constructs the FeatureNameStatistics of each feature in <features> and
+// appends them to <result>, in order. The missing counts of a feature are
+// relative to its parent feature, if the parent is in <features>.
+Status MakeBasicStatistics(const std::vector<PartialBasicStats>& features,
+                           const BasicStatsOptions& options,
+                           metadata::v0::DatasetFeatureStatistics* result);
+
+}  // namespace data_validation
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_DATA_VALIDATION_ANOMALIES_BASIC_STATS_UTIL_H_
@@ -0,0 +1,353 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/basic_stats_util.h"
+
+#include <limits>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "tensorflow_data_validation/anomalies/test_util.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow_metadata/proto/v0/statistics.pb.h"
+
+namespace tensorflow {
+namespace data_validation {
+namespace {
+
+using ::tensorflow::data_validation::testing::EqualsProto;
+using ::tensorflow::data_validation::testing::ParseTextProtoOrDie;
+using ::tensorflow::metadata::v0::DatasetFeatureStatistics;
+using ::tensorflow::metadata::v0::FeatureNameStatistics;
+using ::tensorflow::metadata::v0::Histogram;
+
+constexpr double kInf = std::numeric_limits<double>::infinity();
+
+struct EquiWidthHistogramTest {
+  string name;
+  std::vector<double> quantiles;
+  double finite_min;
+  double finite_max;
+  double total_count;
+  int num_buckets;
+  // Buckets as (low_value, high_value, sample_count).
+  std::vector<std::vector<double>> expected_buckets;
+};
+
+TEST(BasicStatsUtilTest, GenerateEquiWidthHistogram) {
+  const std::vector<EquiWidthHistogramTest> tests = {
+      {"finite_values_integer_boundaries",
+       {0, 1, 5, 10, 15, 20, 24},
+       0,
+       24,
+       18,
+       3,
+       {{0, 8, 7.8}, {8, 16, 4.8}, {16, 24, 5.4}}},
+      {"finite_values_float_boundaries",
+       {1, 1, 2, 3, 4, 5, 5},
+       1,
+       5,
+       6,
+       3,
+       {{1, 2.33333333, 2.33333333},
+        {2.33333333, 3.66666666, 1.33333333},
+        {3.66666666, 5, 2.33333333}}},
+      {"float32_overflow",
+       {static_cast<float>(-3.4e+38), 1, 2, 3, 4, 5,
+        static_cast<float>(3.4e+38)},
+       1,
+       5,
+       6,
+       3,
+       {{-3.3999999521443642e+38, -1.1333333173814546e+38, 0.66666666},
+        {-1.1333333173814546e+38, 1.133333317381455e+38, 4.66666666},
+        {1.133333317381455e+38, 3.3999999521443642e+38, 0.66666666}}},
+      {"same_min_max",
+       std::vector<double>(10, 1),
+       1,
+       1,
+       100,
+       3,
+       {{1, 1, 100}}},
+      {"only_neg_inf",
+       std::vector<double>(10, -kInf),
+       kInf,
+       -kInf,
+       100,
+       3,
+       {{-kInf, -kInf, 100}}},
+      {"only_neg_and_pos_inf",
+       {-kInf, -kInf, -kInf, -kInf, -kInf, kInf, kInf, kInf, kInf, kInf},
+       kInf,
+       -kInf,
+       100,
+       3,
+       {{-kInf, -kInf, 50}, {kInf, kInf, 50}}},
+      {"finite_min_max_in_quantile_boundaries_multiple_inf",
+       {-kInf, -kInf, -kInf, 0, 1, 5, 10, 15, 20, 24, kInf, kInf, kInf},
+       0,
+       24,
+       27,
+       3,
+       {{-kInf, 8, 12.6}, {8, 16, 3.6}, {16, kInf, 10.8}}},
+      {"no_finite_min_max_in_quantile_boundaries_multiple_inf",
+       {-kInf, -kInf, -kInf, 1, 5, 10, 15, 20, kInf, kInf, kInf},
+       0,
+       24,
+       27,
+       3,
+       {{-kInf, 8, 12.42}, {8, 16, 4.32}, {16, kInf, 10.26}}},
+      {"fewer_finite_boundaries_than_buckets",
+       {-kInf, -kInf, -kInf, 0, 12, 18, 24, kInf, kInf, kInf},
+       0,
+       24,
+       27,
+       6,
+       {{-kInf, 4, 10},
+        {4, 8, 1},
+        {8, 12, 1},
+        {12, 16, 2},
+        {16, 20, 2},
+        {20, kInf, 11}}},
+  };
+  for (const EquiWidthHistogramTest& test : tests) {
+    Histogram histogram;
+    TF_ASSERT_OK(GenerateEquiWidthHistogram(
+        test.quantiles, test.finite_min, test.finite_max, test.total_count,
+        test.num_buckets, &histogram))
+        << test.name;
+    EXPECT_EQ(histogram.type(), Histogram::STANDARD);
+    ASSERT_EQ(histogram.buckets_size(), test.expected_buckets.size())
+        << test.name;
+    for (int i = 0; i < histogram.buckets_size(); ++i) {
+      const Histogram::Bucket& bucket = histogram.buckets(i);
+      const std::vector<double>& expected = test.expected_buckets[i];
+      if (std::isinf(expected[0])) {
+        EXPECT_EQ(bucket.low_value(), expected[0]) << test.name;
+      } else {
+        EXPECT_NEAR(bucket.low_value(), expected[0],
+                    std::abs(expected[0]) * 1e-7 + 1e-7)
+            << test.name;
+      }
+      if (std::isinf(expected[1])) {
+        EXPECT_EQ(bucket.high_value(), expected[1]) << test.name;
+      } else {
+        EXPECT_NEAR(bucket.high_value(), expected[1],
+                    std::abs(expected[1]) * 1e-7 + 1e-7)
+            << test.name;
+      }
+      EXPECT_NEAR(bucket.sample_count(), expected[2], 1e-7) << test.name;
+    }
+  }
+}
+
+TEST(BasicStatsUtilTest, GenerateEquiWidthHistogramUnsortedQuantiles) {
+  Histogram histogram;
+  EXPECT_FALSE(
+      GenerateEquiWidthHistogram({1, 2, 1, 3}, 1, 3, 10, 2, &histogram).ok());
+}
+
+TEST(BasicStatsUtilTest, GenerateQuantilesHistogram) {
+  Histogram histogram;
+  TF_ASSERT_OK(GenerateQuantilesHistogram({1, 61, 121, 181, 241, 301, 360},
+                                          360, 3, &histogram));
+  EXPECT_THAT(histogram, EqualsProto(ParseTextProtoOrDie<Histogram>(R"(
+                buckets { low_value: 1 high_value: 121 sample_count: 120 }
+                buckets { low_value: 121 high_value: 241 sample_count: 120 }
+                buckets { low_value: 241 high_value: 360 sample_count: 120 }
+                type: QUANTILES)")));
+  EXPECT_FALSE(
+      GenerateQuantilesHistogram({1, 2, 3}, 10, 3, &histogram).ok());
+}
+
+TEST(BasicStatsUtilTest, FindMedian) {
+  EXPECT_EQ(FindMedian({5}), 5);
+  EXPECT_EQ(FindMedian({3, 5}), 4);
+  EXPECT_EQ(FindMedian({3, 4, 5}), 4);
+  EXPECT_EQ(FindMedian({3, 4, 5, 6}), 4.5);
+}
+
+TEST(BasicStatsUtilTest, MakeBasicStatistics) {
+  BasicStatsOptions options;
+  options.num_values_histogram_buckets = 2;
+  options.num_histogram_buckets = 2;
+  options.num_quantiles_histogram_buckets = 2;
+
+  // An INT feature with values [1, 2], [3] and a missing value.
+  PartialBasicStats int_feature;
+  int_feature.path = Path({"int"});
+  int_feature.has_type = true;
+  int_feature.type = FeatureNameStatistics::INT;
+  int_feature.presence_and_valency_stats = {{2, 1, 2, 3, 0, 0}};
+  int_feature.num_values_quantiles = {{1, 1, 2}};
+  int_feature.sum = 6;
+  int_feature.sum_of_squares = 14;
+  int_feature.min = 1;
+  int_feature.max = 3;
+  int_feature.finite_min = 1;
+  int_feature.finite_max = 3;
+  int_feature.quantiles = {1, 2, 3};
+
+  // A struct feature with a child list<list<bytes>> feature.
+  PartialBasicStats struct_feature;
+  struct_feature.path = Path({"struct"});
+  struct_feature.has_type = true;
+  struct_feature.type = FeatureNameStatistics::STRUCT;
+  struct_feature.presence_and_valency_stats = {{1, 2, 2, 2, 0, 0}};
+  struct_feature.num_values_quantiles = {{2, 2, 2}};
+
+  PartialBasicStats string_feature;
+  string_feature.path = Path({"struct", "string"});
+  string_feature.has_type = true;
+  string_feature.type = FeatureNameStatistics::STRING;
+  string_feature.presence_and_valency_stats = {{1, 1, 1, 1, 0, 0},
+                                               {1, 2, 2, 2, 0, 0}};
+  string_feature.num_values_quantiles = {{1, 1, 1}, {2, 2, 2}};
+  string_feature.total_bytes_length = 5;
+
+  PartialBasicStats missing_feature;
+  missing_feature.path = Path({"missing"});
+
+  DatasetFeatureStatistics result;
+  TF_ASSERT_OK(MakeBasicStatistics(
+      {int_feature, struct_feature, string_feature, missing_feature}, options,
+      &result));
+  EXPECT_THAT(result,
+              EqualsProto(ParseTextProtoOrDie<DatasetFeatureStatistics>(R"(
+                features {
+                  path { step: "int" }
+                  type: INT
+                  num_stats {
+                    common_stats {
+                      num_non_missing: 2
+                      min_num_values: 1
+                      max_num_values: 2
+                      avg_num_values: 1.5
+                      tot_num_values: 3
+                      num_values_histogram {
+                        buckets { low_value: 1 high_value: 1 sample_count: 1 }
+                        buckets { low_value: 1 high_value: 2 sample_count: 1 }
+                        type: QUANTILES
+                      }
+                    }
+                    mean: 2
+                    std_dev: 0.81649658092772626
+                    min: 1
+                    median: 2
+                    max: 3
+                    histograms {
+                      buckets { low_value: 1 high_value: 2 sample_count: 1.5 }
+                      buckets { low_value: 2 high_value: 3 sample_count: 1.5 }
+                    }
+                    histograms {
+                      buckets { low_value: 1 high_value: 2 sample_count: 1.5 }
+                      buckets { low_value: 2 high_value: 3 sample_count: 1.5 }
+                      type: QUANTILES
+                    }
+                  }
+                }
+                features {
+                  path { step: "struct" }
+                  type: STRUCT
+                  struct_stats {
+                    common_stats {
+                      num_non_missing: 1
+                      min_num_values: 2
+                      max_num_values: 2
+                      avg_num_values: 2
+                      tot_num_values: 2
+                      num_values_histogram {
+                        buckets { low_value: 2 high_value: 2 sample_count: 0.5 }
+                        buckets { low_value: 2 high_value: 2 sample_count: 0.5 }
+                        type: QUANTILES
+                      }
+                    }
+                  }
+                }
+                features {
+                  path { step: "struct" step: "string" }
+                  type: STRING
+                  string_stats {
+                    common_stats {
+                      num_non_missing: 1
+                      num_missing: 1
+                      min_num_values: 1
+                      max_num_values: 1
+                      avg_num_values: 1
+                      tot_num_values: 1
+                      num_values_histogram {
+                        buckets { low_value: 1 high_value: 1 sample_count: 0.5 }
+                        buckets { low_value: 1 high_value: 1 sample_count: 0.5 }
+                        type: QUANTILES
+                      }
+                      presence_and_valency_stats {
+                        num_missing: 1
+                        num_non_missing: 1
+                        min_num_values: 1
+                        max_num_values: 1
+                        tot_num_values: 1
+                      }
+                      presence_and_valency_stats {
+                        num_missing: 0
+                        num_non_missing: 1
+                        min_num_values: 2
+                        max_num_values: 2
+                        tot_num_values: 2
+                      }
+                    }
+                    avg_length: 2.5
+                  }
+                  custom_stats {
+                    name: "level_2_value_list_length"
+                    histogram {
+                      buckets { low_value: 2 high_value: 2 sample_count: 0.5 }
+                      buckets { low_value: 2 high_value: 2 sample_count: 0.5 }
+                      type: QUANTILES
+                    }
+                  }
+                }
+                features {
+                  path { step: "missing" }
+                  type: STRING
+                  string_stats { common_stats {} }
+                })")));
+}
+
+TEST(BasicStatsUtilTest, MakeBasicStatisticsOnlyNan) {
+  PartialBasicStats feature;
+  feature.path = Path({"float"});
+  feature.has_type = true;
+  feature.type = FeatureNameStatistics::FLOAT;
+  feature.presence_and_valency_stats = {{1, 2, 2, 2, 0, 0}};
+  feature.num_values_quantiles = {{2, 2, 2}};
+  feature.num_nan = 2;
+  BasicStatsOptions options;
+  options.num_values_histogram_buckets = 2;
+  DatasetFeatureStatistics result;
+  TF_ASSERT_OK(MakeBasicStatistics({feature}, options, &result));
+  ASSERT_EQ(result.features_size(), 1);
+  EXPECT_EQ(result.features(0).num_stats().histograms_size(), 2);
+  EXPECT_EQ(result.features(0).num_stats().histograms(0).num_nan(), 2);
+  EXPECT_EQ(result.features(0).num_stats().histograms(1).type(),
+            Histogram::QUANTILES);
+  // The num values histogram needs as many quantiles as buckets + 1.
+  EXPECT_FALSE(MakeBasicStatistics({feature}, BasicStatsOptions(), &result)
+                   .ok());
+}
+
+}  // namespace
+}  // namespace data_validation
+}  // namespace tensorflow
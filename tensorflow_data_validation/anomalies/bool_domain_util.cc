@@ -19,11 +19,15 @@ limitations under the License.
 #include <string>
 #include <vector>
 
+#include "absl/algorithm/container.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 #include "tensorflow_data_validation/anomalies/internal_types.h"
 #include "tensorflow_data_validation/anomalies/map_util.h"
 #include "tensorflow_data_validation/anomalies/statistics_view.h"
+#include "tensorflow_data_validation/anomalies/string_interner.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow_metadata/proto/v0/anomalies.pb.h"
@@ -43,31 +47,45 @@ using ::tensorflow::metadata::v0::FloatDomain;
 using ::tensorflow::metadata::v0::IntDomain;
 using ::tensorflow::metadata::v0::NumericStatistics;
 
-// NOTE: GetTrueValues() intersect GetFalseValues() must be empty.
-std::set<string> GetTrueValues() {
-  return {"TRUE", "true", "SET", "set", "1", ""};
+// NOTE: kTrueValues intersect kFalseValues must be empty.
+constexpr absl::string_view kTrueValues[] = {"TRUE", "true", "SET",
+                                             "set",  "1",    ""};
+constexpr absl::string_view kFalseValues[] = {"FALSE", "false", "CLEAR",
+                                              "clear", "0"};
+
+bool IsTrueValue(absl::string_view value) {
+  return absl::c_linear_search(kTrueValues, value);
 }
-std::set<string> GetFalseValues() {
-  return {"FALSE", "false", "CLEAR", "clear", "0"};
+
+bool IsFalseValue(absl::string_view value) {
+  return absl::c_linear_search(kFalseValues, value);
 }
 
 // Assumes that the stats type is STRING or BYTES and the
 // IsBoolDomainCandidate(stats) is true.
 BoolDomain BoolDomainFromStringField(const FeatureStatsView& stats) {
-  BoolDomain result;
-  const std::set<string> true_values = GetTrueValues();
-  for (const string& label : stats.GetStringValues()) {
-    if (ContainsKey(true_values, label)) {
-      *result.mutable_true_value() = label;
-      break;
+  StringInterner* interner = stats.string_interner();
+  // As GetStringValues() is sorted, use the smallest true and false labels.
+  absl::optional<absl::string_view> true_value;
+  absl::optional<absl::string_view> false_value;
+  for (const auto& id_and_count : stats.GetStringValueIdsWithCounts(interner)) {
+    const absl::string_view label = interner->Get(id_and_count.first);
+    if (IsTrueValue(label)) {
+      if (!true_value || label < *true_value) {
+        true_value = label;
+      }
+    } else if (IsFalseValue(label)) {
+      if (!false_value || label < *false_value) {
+        false_value = label;
+      }
     }
   }
-  const std::set<string> false_values = GetFalseValues();
-  for (const string& label : stats.GetStringValues()) {
-    if (ContainsKey(false_values, label)) {
-      *result.mutable_false_value() = label;
-      break;
-    }
+  BoolDomain result;
+  if (true_value) {
+    result.set_true_value(string(*true_value));
+  }
+  if (false_value) {
+    result.set_false_value(string(*false_value));
   }
   return result;
 }
@@ -131,16 +149,14 @@ bool IsBoolDomainCandidate(const FeatureStatsView& feature_stats) {
   }
   // Can only have one feature that represents true,
   // and one that represents false.
-  std::set<string> valid_true = GetTrueValues();
-  std::set<string> valid_false = GetFalseValues();
   bool true_seen = false;
   bool false_seen = false;
   for (const string& token : tokens) {
-    if (!true_seen && ContainsKey(valid_true, token)) {
+    if (!true_seen && IsTrueValue(token)) {
       true_seen = true;
       continue;
     }
-    if (!false_seen && ContainsKey(valid_false, token)) {
+    if (!false_seen && IsFalseValue(token)) {
       false_seen = true;
       continue;
     }
@@ -247,6 +263,7 @@ std::vector<Description> UpdateBoolDomain(const FeatureStatsView& feature_stats,
                    absl::StrCat("Floats (such as NaN) not in {0, 1}: "
                                 "converting to float_domain.")}};
         }
+        // LINT.IfChange
         for (const auto& bucket : histogram.buckets()) {
           if (bucket.sample_count() <= 0) {
             continue;
@@ -275,6 +292,7 @@ std::vector<Description> UpdateBoolDomain(const FeatureStatsView& feature_stats,
                                   "converting to float_domain.")}};
           }
         }
+        // LINT.ThenChange(compact_statistics.cc)
       }
       return {};
     }
@@ -0,0 +1,797 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/columnar_statistics.h"
+
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/call_once.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/lib/core/coding.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/protobuf.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow_metadata/proto/v0/path.pb.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+namespace {
+using ::tensorflow::metadata::v0::BytesStatistics;
+using ::tensorflow::metadata::v0::CommonStatistics;
+using ::tensorflow::metadata::v0::DatasetFeatureStatistics;
+using ::tensorflow::metadata::v0::DatasetFeatureStatisticsList;
+using ::tensorflow::metadata::v0::FeatureNameStatistics;
+using ::tensorflow::metadata::v0::NumericStatistics;
+using ::tensorflow::metadata::v0::StringStatistics;
+using ::tensorflow::metadata::v0::StructStatistics;
+
+constexpr uint32 kVersion = 1;
+constexpr int kMagicSize = sizeof(kColumnarStatisticsMagic) - 1;
+constexpr int kHeaderSize = kMagicSize + 4 + 4 + 8 + 8;
+constexpr int kDirectoryEntrySize = 4 + 4 + 8 + 8;
+
+// Column ids. Columns with "dataset" in their name have one value per dataset
+// (dataset_row_offsets has one more); the other ones have one value per row.
+enum ColumnId : uint32 {
+  kDatasetName = 0,
+  // The DatasetFeatureStatistics of the dataset, without its features.
+  kDatasetMetadata = 1,
+  kDatasetRowOffsets = 2,
+  // FeatureNameStatistics::kName or FeatureNameStatistics::kPath (or 0).
+  kFieldIdCase = 3,
+  // The name, or the serialized Path proto, of the feature.
+  kFieldId = 4,
+  kType = 5,
+  // The FeatureNameStatistics::StatsCase of the feature.
+  kStatsCase = 6,
+  // The serialized CommonStatistics of the feature. Null iff absent.
+  kCommonStats = 7,
+  // The serialized stats message of the feature, without its common
+  // statistics and histograms. Null iff the feature has no stats.
+  kStats = 8,
+  // A serialized stats message of the same type holding only the histograms
+  // of the feature. Null if there are none.
+  kHistograms = 9,
+  // A serialized FeatureNameStatistics holding only the custom statistics of
+  // the feature. Null if there are none.
+  kCustomStats = 10,
+  // A serialized FeatureNameStatistics holding any field not covered by the
+  // columns above. Null if there is none.
+  kRemainder = 11,
+};
+
+uint64 Align8(uint64 n) { return (n + 7) & ~uint64{7}; }
+
+// Builds a variable-width column.
+class BinaryColumnBuilder {
+ public:
+  void Append(const string& value) {
+    SetValid(true);
+    values_.append(value);
+    offsets_.push_back(values_.size());
+  }
+
+  void AppendNull() {
+    SetValid(false);
+    offsets_.push_back(values_.size());
+  }
+
+  // Serializes <message>, or appends a null value if <present> is false.
+  void AppendMessage(const protobuf::Message& message, bool present) {
+    if (present) {
+      Append(message.SerializeAsString());
+    } else {
+      AppendNull();
+    }
+  }
+
+  string Finish() const {
+    string result = validity_;
+    result.resize(Align8(result.size()), '\0');
+    for (const uint64 offset : offsets_) {
+      core::PutFixed64(&result, offset);
+    }
+    result.append(values_);
+    return result;
+  }
+
+ private:
+  void SetValid(bool valid) {
+    const uint64 i = offsets_.size() - 1;
+    if (i % 8 == 0) {
+      validity_.push_back('\0');
+    }
+    if (valid) {
+      validity_.back() |= (1 << (i % 8));
+    }
+  }
+
+  string validity_;
+  std::vector<uint64> offsets_ = {0};
+  string values_;
+};
+
+// Moves the histograms of <stats> into <histograms>.
+void SplitHistograms(NumericStatistics* stats, NumericStatistics* histograms) {
+  histograms->mutable_histograms()->Swap(stats->mutable_histograms());
+  if (stats->has_weighted_numeric_stats() &&
+      stats->weighted_numeric_stats().histograms_size() > 0) {
+    histograms->mutable_weighted_numeric_stats()->mutable_histograms()->Swap(
+        stats->mutable_weighted_numeric_stats()->mutable_histograms());
+  }
+}
+
+void SplitHistograms(StringStatistics* stats, StringStatistics* histograms) {
+  if (stats->has_rank_histogram()) {
+    histograms->mutable_rank_histogram()->Swap(stats->mutable_rank_histogram());
+    stats->clear_rank_histogram();
+  }
+  if (stats->has_weighted_string_stats() &&
+      stats->weighted_string_stats().has_rank_histogram()) {
+    histograms->mutable_weighted_string_stats()->mutable_rank_histogram()->Swap(
+        stats->mutable_weighted_string_stats()->mutable_rank_histogram());
+    stats->mutable_weighted_string_stats()->clear_rank_histogram();
+  }
+}
+
+void SplitHistograms(BytesStatistics*, BytesStatistics*) {}
+void SplitHistograms(StructStatistics*, StructStatistics*) {}
+
+// Appends the common stats, stats and histograms of a feature whose stats
+// are <stats>.
+template <typename T>
+void AppendStats(const T& stats, BinaryColumnBuilder* common_stats_column,
+                 BinaryColumnBuilder* stats_column,
+                 BinaryColumnBuilder* histograms_column) {
+  T rest = stats;
+  T histograms;
+  SplitHistograms(&rest, &histograms);
+  common_stats_column->AppendMessage(rest.common_stats(),
+                                     rest.has_common_stats());
+  rest.clear_common_stats();
+  stats_column->AppendMessage(rest, true);
+  histograms_column->AppendMessage(histograms, histograms.ByteSizeLong() > 0);
+}
+
+// Parses the stats of <feature> back from their columns.
+template <typename T>
+Status ParseStats(absl::string_view common_stats, bool has_common_stats,
+                  absl::string_view stats, absl::string_view histograms,
+                  bool has_histograms, T* result) {
+  if (!result->ParseFromArray(stats.data(), stats.size())) {
+    return errors::DataLoss("Unable to parse the stats column.");
+  }
+  if (has_histograms) {
+    T histograms_message;
+    if (!histograms_message.ParseFromArray(histograms.data(),
+                                           histograms.size())) {
+      return errors::DataLoss("Unable to parse the histograms column.");
+    }
+    result->MergeFrom(histograms_message);
+  }
+  if (has_common_stats &&
+      !result->mutable_common_stats()->ParseFromArray(common_stats.data(),
+                                                      common_stats.size())) {
+    return errors::DataLoss("Unable to parse the common_stats column.");
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
+Status WriteColumnarStatistics(const DatasetFeatureStatisticsList& statistics,
+                               string* output) {
+  BinaryColumnBuilder dataset_name, dataset_metadata;
+  string dataset_row_offsets;
+  string field_id_case, type, stats_case;
+  BinaryColumnBuilder field_id, common_stats, stats, histograms, custom_stats,
+      remainder;
+  uint64 num_rows = 0;
+  core::PutFixed64(&dataset_row_offsets, 0);
+  for (const DatasetFeatureStatistics& dataset : statistics.datasets()) {
+    dataset_name.Append(dataset.name());
+    DatasetFeatureStatistics metadata = dataset;
+    metadata.clear_features();
+    dataset_metadata.AppendMessage(metadata, true);
+    for (const FeatureNameStatistics& feature : dataset.features()) {
+      core::PutFixed32(&field_id_case, feature.field_id_case());
+      switch (feature.field_id_case()) {
+        case FeatureNameStatistics::kName:
+          field_id.Append(feature.name());
+          break;
+        case FeatureNameStatistics::kPath:
+          field_id.AppendMessage(feature.path(), true);
+          break;
+        default:
+          field_id.Append("");
+      }
+      core::PutFixed32(&type, feature.type());
+      core::PutFixed32(&stats_case, feature.stats_case());
+      switch (feature.stats_case()) {
+        case FeatureNameStatistics::kNumStats:
+          AppendStats(feature.num_stats(), &common_stats, &stats, &histograms);
+          break;
+        case FeatureNameStatistics::kStringStats:
+          AppendStats(feature.string_stats(), &common_stats, &stats,
+                      &histograms);
+          break;
+        case FeatureNameStatistics::kBytesStats:
+          AppendStats(feature.bytes_stats(), &common_stats, &stats,
+                      &histograms);
+          break;
+        case FeatureNameStatistics::kStructStats:
+          AppendStats(feature.struct_stats(), &common_stats, &stats,
+                      &histograms);
+          break;
+        case FeatureNameStatistics::STATS_NOT_SET:
+          common_stats.AppendNull();
+          stats.AppendNull();
+          histograms.AppendNull();
+          break;
+        default:
+          return errors::InvalidArgument("Unknown stats type of feature ",
+                                         feature.ShortDebugString());
+      }
+      FeatureNameStatistics custom;
+      *custom.mutable_custom_stats() = feature.custom_stats();
+      custom_stats.AppendMessage(custom, feature.custom_stats_size() > 0);
+      FeatureNameStatistics rest = feature;
+      rest.clear_field_id();
+      rest.clear_type();
+      rest.clear_stats();
+      rest.clear_custom_stats();
+      remainder.AppendMessage(rest, rest.ByteSizeLong() > 0);
+      ++num_rows;
+    }
+    core::PutFixed64(&dataset_row_offsets, num_rows);
+  }
+
+  const std::vector<std::pair<uint32, string>> columns = {
+      {kDatasetName, dataset_name.Finish()},
+      {kDatasetMetadata, dataset_metadata.Finish()},
+      {kDatasetRowOffsets, std::move(dataset_row_offsets)},
+      {kFieldIdCase, std::move(field_id_case)},
+      {kFieldId, field_id.Finish()},
+      {kType, std::move(type)},
+      {kStatsCase, std::move(stats_case)},
+      {kCommonStats, common_stats.Finish()},
+      {kStats, stats.Finish()},
+      {kHistograms, histograms.Finish()},
+      {kCustomStats, custom_stats.Finish()},
+      {kRemainder, remainder.Finish()},
+  };
+  output->clear();
+  output->append(kColumnarStatisticsMagic, kMagicSize);
+  core::PutFixed32(output, kVersion);
+  core::PutFixed32(output, columns.size());
+  core::PutFixed64(output, statistics.datasets_size());
+  core::PutFixed64(output, num_rows);
+  uint64 offset = Align8(kHeaderSize + columns.size() * kDirectoryEntrySize);
+  for (const auto& column : columns) {
+    core::PutFixed32(output, column.first);
+    core::PutFixed32(output, 0);
+    core::PutFixed64(output, offset);
+    core::PutFixed64(output, column.second.size());
+    offset = Align8(offset + column.second.size());
+  }
+  for (const auto& column : columns) {
+    output->resize(Align8(output->size()), '\0');
+    output->append(column.second);
+  }
+  return Status::OK();
+}
+
+Status ColumnarStatisticsReader::BinaryColumn::Get(
+    uint64 i, absl::string_view* value) const {
+  const uint64 begin = core::DecodeFixed64(offsets + 8 * i);
+  const uint64 end = core::DecodeFixed64(offsets + 8 * (i + 1));
+  if (begin > end || end > values_length) {
+    return errors::DataLoss("Invalid offsets of value ", i, ".");
+  }
+  *value = absl::string_view(values + begin, end - begin);
+  return Status::OK();
+}
+
+Status ColumnarStatisticsReader::Open(
+    const string& filename, std::unique_ptr<ColumnarStatisticsReader>* reader) {
+  std::unique_ptr<ReadOnlyMemoryRegion> region;
+  TF_RETURN_IF_ERROR(
+      Env::Default()->NewReadOnlyMemoryRegionFromFile(filename, &region));
+  reader->reset(new ColumnarStatisticsReader());
+  (*reader)->region_ = std::move(region);
+  return (*reader)->Init(absl::string_view(
+      static_cast<const char*>((*reader)->region_->data()),
+      (*reader)->region_->length()));
+}
+
+Status ColumnarStatisticsReader::FromBuffer(
+    absl::string_view data, std::unique_ptr<ColumnarStatisticsReader>* reader) {
+  reader->reset(new ColumnarStatisticsReader());
+  return (*reader)->Init(data);
+}
+
+Status ColumnarStatisticsReader::Init(absl::string_view data) {
+  if (data.size() < kHeaderSize ||
+      data.substr(0, kMagicSize) != kColumnarStatisticsMagic) {
+    return errors::InvalidArgument("Not a columnar statistics file.");
+  }
+  const char* header = data.data() + kMagicSize;
+  const uint32 version = core::DecodeFixed32(header);
+  if (version != kVersion) {
+    return errors::InvalidArgument(
+        "Unsupported columnar statistics version: ", version);
+  }
+  const uint64 num_columns = core::DecodeFixed32(header + 4);
+  const uint64 num_datasets = core::DecodeFixed64(header + 8);
+  num_rows_ = core::DecodeFixed64(header + 16);
+  if ((data.size() - kHeaderSize) / kDirectoryEntrySize < num_columns) {
+    return errors::DataLoss("Truncated columnar statistics directory.");
+  }
+  for (uint64 i = 0; i < num_columns; ++i) {
+    const char* entry = data.data() + kHeaderSize + i * kDirectoryEntrySize;
+    const uint32 id = core::DecodeFixed32(entry);
+    const uint64 offset = core::DecodeFixed64(entry + 8);
+    const uint64 length = core::DecodeFixed64(entry + 16);
+    if (offset > data.size() || length > data.size() - offset) {
+      return errors::DataLoss("Column ", id, " is out of bounds.");
+    }
+    columns_[id] = data.substr(offset, length);
+  }
+
+  // Only the locations of the columns are resolved here; their values are
+  // read (and validated) when they are accessed.
+  BinaryColumn names;
+  TF_RETURN_IF_ERROR(GetBinaryColumn(kDatasetName, num_datasets, &names));
+  TF_RETURN_IF_ERROR(
+      GetBinaryColumn(kDatasetMetadata, num_datasets, &dataset_metadata_));
+  const char* row_offsets;
+  TF_RETURN_IF_ERROR(GetFixedWidthColumn(kDatasetRowOffsets, num_datasets + 1,
+                                         8, &row_offsets));
+  TF_RETURN_IF_ERROR(
+      GetFixedWidthColumn(kFieldIdCase, num_rows_, 4, &field_id_case_));
+  TF_RETURN_IF_ERROR(GetFixedWidthColumn(kType, num_rows_, 4, &type_));
+  TF_RETURN_IF_ERROR(
+      GetFixedWidthColumn(kStatsCase, num_rows_, 4, &stats_case_));
+  TF_RETURN_IF_ERROR(GetBinaryColumn(kFieldId, num_rows_, &field_id_));
+  TF_RETURN_IF_ERROR(GetBinaryColumn(kCommonStats, num_rows_, &common_stats_));
+  TF_RETURN_IF_ERROR(GetBinaryColumn(kStats, num_rows_, &stats_));
+  TF_RETURN_IF_ERROR(GetBinaryColumn(kHistograms, num_rows_, &histograms_));
+  TF_RETURN_IF_ERROR(GetBinaryColumn(kCustomStats, num_rows_, &custom_stats_));
+  TF_RETURN_IF_ERROR(GetBinaryColumn(kRemainder, num_rows_, &remainder_));
+
+  dataset_names_.clear();
+  dataset_row_offsets_.clear();
+  for (uint64 i = 0; i < num_datasets; ++i) {
+    absl::string_view name;
+    TF_RETURN_IF_ERROR(names.Get(i, &name));
+    dataset_names_.emplace_back(name);
+  }
+  for (uint64 i = 0; i <= num_datasets; ++i) {
+    dataset_row_offsets_.push_back(core::DecodeFixed64(row_offsets + 8 * i));
+    if (dataset_row_offsets_.back() > num_rows_ ||
+        (i > 0 && dataset_row_offsets_[i - 1] > dataset_row_offsets_[i])) {
+      return errors::DataLoss("Invalid dataset row offsets.");
+    }
+  }
+  return Status::OK();
+}
+
+Status ColumnarStatisticsReader::GetColumn(uint32 id,
+                                           absl::string_view* column) const {
+  auto iter = columns_.find(id);
+  if (iter == columns_.end()) {
+    return errors::DataLoss("Missing column ", id, ".");
+  }
+  *column = iter->second;
+  return Status::OK();
+}
+
+Status ColumnarStatisticsReader::GetFixedWidthColumn(
+    uint32 id, uint64 num_values, int width, const char** column) const {
+  absl::string_view bytes;
+  TF_RETURN_IF_ERROR(GetColumn(id, &bytes));
+  // num_values comes from the file: it is bounded before the multiplication,
+  // which could otherwise overflow to the size of the column.
+  if (num_values > bytes.size() / width ||
+      bytes.size() != num_values * width) {
+    return errors::DataLoss("Column ", id, " has an invalid size.");
+  }
+  *column = bytes.data();
+  return Status::OK();
+}
+
+Status ColumnarStatisticsReader::GetBinaryColumn(uint32 id, uint64 num_values,
+                                                 BinaryColumn* column) const {
+  absl::string_view bytes;
+  TF_RETURN_IF_ERROR(GetColumn(id, &bytes));
+  // The offsets alone take 8 * (num_values + 1) bytes. Checking this first
+  // keeps the sizes below from overflowing for a corrupt num_values.
+  if (num_values >= bytes.size() / 8) {
+    return errors::DataLoss("Column ", id, " is truncated.");
+  }
+  const uint64 validity_size = Align8((num_values + 7) / 8);
+  const uint64 offsets_size = 8 * (num_values + 1);
+  if (bytes.size() < validity_size + offsets_size) {
+    return errors::DataLoss("Column ", id, " is truncated.");
+  }
+  column->validity = reinterpret_cast<const uint8*>(bytes.data());
+  column->offsets = bytes.data() + validity_size;
+  column->values = column->offsets + offsets_size;
+  column->num_values = num_values;
+  column->values_length = bytes.size() - validity_size - offsets_size;
+  return Status::OK();
+}
+
+int ColumnarStatisticsReader::FindDataset(absl::string_view name) const {
+  for (int i = 0; i < dataset_names_.size(); ++i) {
+    if (dataset_names_[i] == name) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+Status ColumnarStatisticsReader::ReadDatasetMetadata(
+    int index, DatasetFeatureStatistics* result) const {
+  if (index < 0 || index >= num_datasets()) {
+    return errors::InvalidArgument("Invalid dataset index: ", index);
+  }
+  absl::string_view metadata_bytes;
+  TF_RETURN_IF_ERROR(dataset_metadata_.Get(index, &metadata_bytes));
+  if (!result->ParseFromArray(metadata_bytes.data(), metadata_bytes.size())) {
+    return errors::DataLoss("Unable to parse the metadata of dataset ", index);
+  }
+  return Status::OK();
+}
+
+Status ColumnarStatisticsReader::ReadFeatureId(
+    uint64 row, FeatureNameStatistics* feature) const {
+  absl::string_view id;
+  TF_RETURN_IF_ERROR(field_id_.Get(row, &id));
+  switch (core::DecodeFixed32(field_id_case_ + 4 * row)) {
+    case FeatureNameStatistics::kName:
+      feature->set_name(string(id));
+      break;
+    case FeatureNameStatistics::kPath:
+      if (!feature->mutable_path()->ParseFromArray(id.data(), id.size())) {
+        return errors::DataLoss("Unable to parse the path of row ", row);
+      }
+      break;
+    default:
+      feature->clear_field_id();
+  }
+  feature->set_type(static_cast<FeatureNameStatistics::Type>(
+      core::DecodeFixed32(type_ + 4 * row)));
+  return Status::OK();
+}
+
+FeatureNameStatistics::StatsCase ColumnarStatisticsReader::GetStatsCase(
+    uint64 row) const {
+  return static_cast<FeatureNameStatistics::StatsCase>(
+      core::DecodeFixed32(stats_case_ + 4 * row));
+}
+
+Status ColumnarStatisticsReader::ReadFeature(
+    uint64 row, const ColumnarStatisticsReadOptions& options,
+    FeatureNameStatistics* feature) const {
+  feature->Clear();
+  if (remainder_.IsValid(row)) {
+    absl::string_view rest;
+    TF_RETURN_IF_ERROR(remainder_.Get(row, &rest));
+    if (!feature->ParseFromArray(rest.data(), rest.size())) {
+      return errors::DataLoss("Unable to parse the remainder of row ", row);
+    }
+  }
+  TF_RETURN_IF_ERROR(ReadFeatureId(row, feature));
+
+  const bool has_histograms =
+      options.include_histograms && histograms_.IsValid(row);
+  absl::string_view histograms_bytes;
+  if (has_histograms) {
+    TF_RETURN_IF_ERROR(histograms_.Get(row, &histograms_bytes));
+  }
+  const bool has_common_stats = common_stats_.IsValid(row);
+  absl::string_view common_stats_bytes;
+  TF_RETURN_IF_ERROR(common_stats_.Get(row, &common_stats_bytes));
+  absl::string_view stats_bytes;
+  TF_RETURN_IF_ERROR(stats_.Get(row, &stats_bytes));
+  switch (GetStatsCase(row)) {
+    case FeatureNameStatistics::kNumStats:
+      TF_RETURN_IF_ERROR(ParseStats(common_stats_bytes, has_common_stats,
+                                    stats_bytes, histograms_bytes,
+                                    has_histograms,
+                                    feature->mutable_num_stats()));
+      break;
+    case FeatureNameStatistics::kStringStats:
+      TF_RETURN_IF_ERROR(ParseStats(common_stats_bytes, has_common_stats,
+                                    stats_bytes, histograms_bytes,
+                                    has_histograms,
+                                    feature->mutable_string_stats()));
+      break;
+    case FeatureNameStatistics::kBytesStats:
+      TF_RETURN_IF_ERROR(ParseStats(common_stats_bytes, has_common_stats,
+                                    stats_bytes, histograms_bytes,
+                                    has_histograms,
+                                    feature->mutable_bytes_stats()));
+      break;
+    case FeatureNameStatistics::kStructStats:
+      TF_RETURN_IF_ERROR(ParseStats(common_stats_bytes, has_common_stats,
+                                    stats_bytes, histograms_bytes,
+                                    has_histograms,
+                                    feature->mutable_struct_stats()));
+      break;
+    case FeatureNameStatistics::STATS_NOT_SET:
+      break;
+    default:
+      return errors::DataLoss("Unknown stats type in row ", row);
+  }
+
+  if (options.include_custom_stats && custom_stats_.IsValid(row)) {
+    FeatureNameStatistics custom;
+    absl::string_view custom_bytes;
+    TF_RETURN_IF_ERROR(custom_stats_.Get(row, &custom_bytes));
+    if (!custom.ParseFromArray(custom_bytes.data(), custom_bytes.size())) {
+      return errors::DataLoss("Unable to parse the custom stats of row ", row);
+    }
+    feature->mutable_custom_stats()->Swap(custom.mutable_custom_stats());
+  }
+  return Status::OK();
+}
+
+Status ColumnarStatisticsReader::GetSelectedRows(
+    int index, const ColumnarStatisticsReadOptions& options,
+    std::vector<uint64>* rows) const {
+  rows->clear();
+  for (uint64 row = dataset_row_offsets_[index];
+       row < dataset_row_offsets_[index + 1]; ++row) {
+    if (options.feature_paths) {
+      FeatureNameStatistics id;
+      TF_RETURN_IF_ERROR(ReadFeatureId(row, &id));
+      const Path path = id.field_id_case() == FeatureNameStatistics::kPath
+                            ? Path(id.path())
+                            : Path(std::vector<string>{id.name()});
+      if (options.feature_paths->count(path) == 0) {
+        continue;
+      }
+    }
+    rows->push_back(row);
+  }
+  return Status::OK();
+}
+
+Status ColumnarStatisticsReader::ReadDataset(
+    int index, const ColumnarStatisticsReadOptions& options,
+    DatasetFeatureStatistics* result) const {
+  TF_RETURN_IF_ERROR(ReadDatasetMetadata(index, result));
+  std::vector<uint64> rows;
+  TF_RETURN_IF_ERROR(GetSelectedRows(index, options, &rows));
+  for (const uint64 row : rows) {
+    TF_RETURN_IF_ERROR(ReadFeature(row, options, result->add_features()));
+  }
+  return Status::OK();
+}
+
+Status ColumnarStatisticsReader::ReadAll(
+    const ColumnarStatisticsReadOptions& options,
+    DatasetFeatureStatisticsList* result) const {
+  result->Clear();
+  for (int i = 0; i < num_datasets(); ++i) {
+    TF_RETURN_IF_ERROR(ReadDataset(i, options, result->add_datasets()));
+  }
+  return Status::OK();
+}
+
+namespace {
+
+// A DatasetStatsBackend over the rows of one dataset of a columnar statistics
+// file. The identity of the features is decoded upfront; their statistics
+// are decoded the first time they are accessed.
+class ColumnarDatasetStatsBackend : public DatasetStatsBackend {
+ public:
+  ColumnarDatasetStatsBackend(
+      std::shared_ptr<const ColumnarStatisticsReader> reader,
+      const ColumnarStatisticsReadOptions& options,
+      const DatasetFeatureStatistics& metadata, std::vector<uint64> rows,
+      std::vector<FeatureNameStatistics> ids)
+      : reader_(std::move(reader)),
+        options_(options),
+        num_examples_(metadata.num_examples()),
+        weighted_num_examples_(metadata.weighted_num_examples()),
+        rows_(std::move(rows)),
+        ids_(std::move(ids)),
+        features_(rows_.size()) {}
+
+  double num_examples() const override { return num_examples_; }
+
+  double weighted_num_examples() const override {
+    return weighted_num_examples_;
+  }
+
+  int num_features() const override { return rows_.size(); }
+
+  FeatureNameStatistics::FieldIdCase field_id_case(int index) const override {
+    return ids_.at(index).field_id_case();
+  }
+
+  string name(int index) const override { return ids_.at(index).name(); }
+
+  Path path(int index) const override { return Path(ids_.at(index).path()); }
+
+  FeatureNameStatistics::Type type(int index) const override {
+    return ids_.at(index).type();
+  }
+
+  FeatureNameStatistics::StatsCase stats_case(int index) const override {
+    return reader_->GetStatsCase(rows_.at(index));
+  }
+
+  const CommonStatistics* common_stats(int index) const override {
+    const FeatureNameStatistics& data = feature(index);
+    switch (data.stats_case()) {
+      case FeatureNameStatistics::kNumStats:
+        return &data.num_stats().common_stats();
+      case FeatureNameStatistics::kStringStats:
+        return &data.string_stats().common_stats();
+      case FeatureNameStatistics::kBytesStats:
+        return &data.bytes_stats().common_stats();
+      case FeatureNameStatistics::kStructStats:
+        return &data.struct_stats().common_stats();
+      default:
+        return nullptr;
+    }
+  }
+
+  const NumericStatistics& num_stats(int index) const override {
+    return feature(index).num_stats();
+  }
+
+  const protobuf::RepeatedPtrField<metadata::v0::Histogram>& histograms(
+      int index, bool by_weight) const override {
+    return by_weight ? num_stats(index).weighted_numeric_stats().histograms()
+                     : num_stats(index).histograms();
+  }
+
+  const metadata::v0::RankHistogram& rank_histogram(
+      int index, bool by_weight) const override {
+    const StringStatistics& string_stats = feature(index).string_stats();
+    return by_weight ? string_stats.weighted_string_stats().rank_histogram()
+                     : string_stats.rank_histogram();
+  }
+
+  absl::optional<uint64> num_unique(int index) const override {
+    if (stats_case(index) == FeatureNameStatistics::kStringStats) {
+      return feature(index).string_stats().unique();
+    }
+    return absl::nullopt;
+  }
+
+  const protobuf::RepeatedPtrField<metadata::v0::CustomStatistic>&
+  custom_stats(int index) const override {
+    return feature(index).custom_stats();
+  }
+
+  Status status() const override {
+    mutex_lock l(mu_);
+    return status_;
+  }
+
+ private:
+  struct LazyFeature {
+    absl::once_flag once;
+    FeatureNameStatistics statistics;
+  };
+
+  // Decodes the statistics of the feature at <index> on first access.
+  const FeatureNameStatistics& feature(int index) const {
+    LazyFeature& lazy_feature = features_.at(index);
+    absl::call_once(lazy_feature.once, [&]() {
+      const Status status = reader_->ReadFeature(rows_[index], options_,
+                                                 &lazy_feature.statistics);
+      if (!status.ok()) {
+        // Keeps the stats case of the feature, with empty stats.
+        FeatureNameStatistics& statistics = lazy_feature.statistics;
+        statistics.Clear();
+        switch (reader_->GetStatsCase(rows_[index])) {
+          case FeatureNameStatistics::kNumStats:
+            statistics.mutable_num_stats();
+            break;
+          case FeatureNameStatistics::kStringStats:
+            statistics.mutable_string_stats();
+            break;
+          case FeatureNameStatistics::kBytesStats:
+            statistics.mutable_bytes_stats();
+            break;
+          case FeatureNameStatistics::kStructStats:
+            statistics.mutable_struct_stats();
+            break;
+          default:
+            break;
+        }
+        mutex_lock l(mu_);
+        if (status_.ok()) {
+          status_ = errors::DataLoss("Unable to read the statistics of row ",
+                                     rows_[index], ": ",
+                                     status.error_message());
+        }
+      }
+    });
+    return lazy_feature.statistics;
+  }
+
+  const std::shared_ptr<const ColumnarStatisticsReader> reader_;
+  const ColumnarStatisticsReadOptions options_;
+  const double num_examples_;
+  const double weighted_num_examples_;
+  // The row of each feature in the file.
+  const std::vector<uint64> rows_;
+  // The name or path and the type of each feature.
+  const std::vector<FeatureNameStatistics> ids_;
+  mutable std::vector<LazyFeature> features_;
+  mutable mutex mu_;
+  // The first error decoding the statistics of a feature.
+  mutable Status status_ GUARDED_BY(mu_);
+};
+
+}  // namespace
+
+Status MakeColumnarDatasetStatsBackend(
+    std::shared_ptr<const ColumnarStatisticsReader> reader, int index,
+    const ColumnarStatisticsReadOptions& options,
+    std::shared_ptr<const DatasetStatsBackend>* backend) {
+  DatasetFeatureStatistics metadata;
+  TF_RETURN_IF_ERROR(reader->ReadDatasetMetadata(index, &metadata));
+  std::vector<uint64> rows;
+  TF_RETURN_IF_ERROR(reader->GetSelectedRows(index, options, &rows));
+  std::vector<FeatureNameStatistics> ids(rows.size());
+  for (int i = 0; i < rows.size(); ++i) {
+    TF_RETURN_IF_ERROR(reader->ReadFeatureId(rows[i], &ids[i]));
+  }
+  *backend = std::make_shared<ColumnarDatasetStatsBackend>(
+      std::move(reader), options, metadata, std::move(rows), std::move(ids));
+  return Status::OK();
+}
+
+Status OpenDefaultColumnarDatasetStatsBackend(
+    const string& path, absl::string_view default_dataset_name,
+    std::shared_ptr<const DatasetStatsBackend>* backend) {
+  std::unique_ptr<ColumnarStatisticsReader> reader;
+  TF_RETURN_IF_ERROR(ColumnarStatisticsReader::Open(path, &reader));
+  int index = 0;
+  if (reader->num_datasets() != 1) {
+    index = reader->FindDataset(default_dataset_name);
+    if (index < 0) {
+      return errors::InvalidArgument(
+          "Only statistics with one dataset or the default slice (i.e., \"",
+          default_dataset_name, "\" slice) are currently supported: ", path);
+    }
+  }
+  return MakeColumnarDatasetStatsBackend(
+      std::move(reader), index, ColumnarStatisticsReadOptions(), backend);
+}
+
+Status ColumnarStatisticsToProto(absl::string_view data,
+                                 DatasetFeatureStatisticsList* statistics) {
+  std::unique_ptr<ColumnarStatisticsReader> reader;
+  TF_RETURN_IF_ERROR(ColumnarStatisticsReader::FromBuffer(data, &reader));
+  return reader->ReadAll(ColumnarStatisticsReadOptions(), statistics);
+}
+
+}  // namespace data_validation
+}  // namespace tensorflow
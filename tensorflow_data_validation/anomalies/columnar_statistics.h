@@ -0,0 +1,200 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// A columnar on-disk format for DatasetFeatureStatisticsList protos.
+//
+// The file has one row per (dataset, feature). Each FeatureNameStatistics is
+// split into independent columns (key, type, common statistics, the remaining
+// type-specific statistics, histograms and custom statistics), so that a
+// reader only touches the bytes of the columns and rows it needs. Rows of the
+// same dataset are contiguous, in the order of the original proto.
+//
+// Layout (all integers are little-endian):
+//   magic "TFDVCST1"
+//   uint32 version, uint32 number of columns
+//   uint64 number of datasets, uint64 number of rows
+//   column directory: {uint32 column id, uint32 reserved, uint64 offset,
+//                      uint64 length} per column
+//   column data, each column starting at an 8-byte aligned offset.
+// Fixed-width columns are plain arrays. Variable-width columns follow the
+// Arrow binary layout: a validity bitmap padded to 8 bytes, (n + 1) uint64
+// offsets and the concatenated values. Null values encode absent messages,
+// which keeps the conversion lossless.
+#ifndef TENSORFLOW_DATA_VALIDATION_ANOMALIES_COLUMNAR_STATISTICS_H_
+#define TENSORFLOW_DATA_VALIDATION_ANOMALIES_COLUMNAR_STATISTICS_H_
+
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "tensorflow_data_validation/anomalies/path.h"
+#include "tensorflow_data_validation/anomalies/statistics_view.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow_metadata/proto/v0/statistics.pb.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+// The first bytes of every columnar statistics file.
+// LINT.IfChange
+constexpr char kColumnarStatisticsMagic[] = "TFDVCST1";
+// LINT.ThenChange(../utils/stats_util.py)
+
+// Converts <statistics> to the columnar format.
+Status WriteColumnarStatistics(
+    const metadata::v0::DatasetFeatureStatisticsList& statistics,
+    string* output);
+
+// Options controlling which parts of the statistics are materialized when
+// reading a columnar statistics file.
+struct ColumnarStatisticsReadOptions {
+  // If set, only the features whose path is in <feature_paths> are read.
+  // Features identified by name match the single-step path {name}.
+  absl::optional<std::set<Path>> feature_paths;
+  // If false, histograms (numeric histograms and rank histograms) are not
+  // read.
+  bool include_histograms = true;
+  // If false, custom statistics are not read.
+  bool include_custom_stats = true;
+};
+
+// Reads columnar statistics from a buffer or a memory-mapped file. Only the
+// metadata of the file is decoded when it is opened; the statistics of a
+// dataset are decoded on demand, touching only the requested columns and rows.
+// Thread-safe once opened.
+class ColumnarStatisticsReader {
+ public:
+  // Memory maps <filename> and validates its header.
+  static Status Open(const string& filename,
+                     std::unique_ptr<ColumnarStatisticsReader>* reader);
+
+  // Reads the columnar statistics in <data>, which must outlive the reader.
+  static Status FromBuffer(absl::string_view data,
+                           std::unique_ptr<ColumnarStatisticsReader>* reader);
+
+  int num_datasets() const { return dataset_names_.size(); }
+
+  // The name of each dataset (i.e. the slice key), in order.
+  const std::vector<string>& dataset_names() const { return dataset_names_; }
+
+  // Returns the index of the dataset with the given name, or -1.
+  int FindDataset(absl::string_view name) const;
+
+  // Decodes the statistics of the dataset at <index>, as selected by
+  // <options>, into <result>.
+  Status ReadDataset(int index, const ColumnarStatisticsReadOptions& options,
+                     metadata::v0::DatasetFeatureStatistics* result) const;
+
+  // Decodes the statistics of all the datasets.
+  Status ReadAll(const ColumnarStatisticsReadOptions& options,
+                 metadata::v0::DatasetFeatureStatisticsList* result) const;
+
+  // Row-level accessors. Rows are numbered across all the datasets.
+
+  // Decodes the DatasetFeatureStatistics of the dataset at <index>, without
+  // its features.
+  Status ReadDatasetMetadata(
+      int index, metadata::v0::DatasetFeatureStatistics* result) const;
+
+  // Outputs the rows of the dataset at <index> selected by <options>.
+  Status GetSelectedRows(int index,
+                         const ColumnarStatisticsReadOptions& options,
+                         std::vector<uint64>* rows) const;
+
+  // Decodes only the name or path and the type of the feature in <row>.
+  Status ReadFeatureId(uint64 row,
+                       metadata::v0::FeatureNameStatistics* feature) const;
+
+  metadata::v0::FeatureNameStatistics::StatsCase GetStatsCase(
+      uint64 row) const;
+
+  // Decodes the statistics of the feature in <row>, as selected by <options>.
+  Status ReadFeature(uint64 row, const ColumnarStatisticsReadOptions& options,
+                     metadata::v0::FeatureNameStatistics* feature) const;
+
+ private:
+  // The location of a variable-width column of <num_values> values.
+  struct BinaryColumn {
+    const uint8* validity = nullptr;
+    const char* offsets = nullptr;
+    const char* values = nullptr;
+    uint64 num_values = 0;
+    uint64 values_length = 0;
+
+    bool IsValid(uint64 i) const { return validity[i / 8] & (1 << (i % 8)); }
+    // Returns the i-th value, after checking that its offsets are valid.
+    Status Get(uint64 i, absl::string_view* value) const;
+  };
+
+  ColumnarStatisticsReader() = default;
+
+  Status Init(absl::string_view data);
+  Status GetColumn(uint32 id, absl::string_view* column) const;
+  Status GetBinaryColumn(uint32 id, uint64 num_values,
+                         BinaryColumn* column) const;
+  Status GetFixedWidthColumn(uint32 id, uint64 num_values, int width,
+                             const char** column) const;
+
+  // Set iff the reader owns the memory-mapped file.
+  std::unique_ptr<ReadOnlyMemoryRegion> region_;
+  uint64 num_rows_ = 0;
+  // Map from column id to its bytes.
+  std::map<uint32, absl::string_view> columns_;
+  BinaryColumn dataset_metadata_;
+  const char* field_id_case_ = nullptr;
+  const char* type_ = nullptr;
+  const char* stats_case_ = nullptr;
+  BinaryColumn field_id_;
+  BinaryColumn common_stats_;
+  BinaryColumn stats_;
+  BinaryColumn histograms_;
+  BinaryColumn custom_stats_;
+  BinaryColumn remainder_;
+  std::vector<string> dataset_names_;
+  // Rows of dataset i are [dataset_row_offsets_[i], dataset_row_offsets_[i+1]).
+  std::vector<uint64> dataset_row_offsets_;
+};
+
+// Outputs a backend of a DatasetStatsView over the statistics of the dataset
+// at <index> in <reader>, as selected by <options>. The statistics of a
+// feature are only decoded when they are first accessed through the view.
+Status MakeColumnarDatasetStatsBackend(
+    std::shared_ptr<const ColumnarStatisticsReader> reader, int index,
+    const ColumnarStatisticsReadOptions& options,
+    std::shared_ptr<const DatasetStatsBackend>* backend);
+
+// Memory-maps the columnar statistics file at <path>, and outputs a backend as
+// MakeColumnarDatasetStatsBackend over its only dataset or, if it has several,
+// over the dataset named <default_dataset_name>.
+Status OpenDefaultColumnarDatasetStatsBackend(
+    const string& path, absl::string_view default_dataset_name,
+    std::shared_ptr<const DatasetStatsBackend>* backend);
+
+// Converts columnar statistics back to a DatasetFeatureStatisticsList. This is
+// the inverse of WriteColumnarStatistics.
+Status ColumnarStatisticsToProto(
+    absl::string_view data,
+    metadata::v0::DatasetFeatureStatisticsList* statistics);
+
+}  // namespace data_validation
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_DATA_VALIDATION_ANOMALIES_COLUMNAR_STATISTICS_H_
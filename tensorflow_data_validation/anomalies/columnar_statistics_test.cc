@@ -0,0 +1,275 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/columnar_statistics.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "tensorflow_data_validation/anomalies/statistics_view.h"
+#include "tensorflow_data_validation/anomalies/test_util.h"
+#include "tensorflow/core/lib/core/coding.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow_metadata/proto/v0/statistics.pb.h"
+
+namespace tensorflow {
+namespace data_validation {
+namespace {
+
+using ::tensorflow::data_validation::testing::EqualsProto;
+using ::tensorflow::data_validation::testing::ParseTextProtoOrDie;
+using ::tensorflow::metadata::v0::DatasetFeatureStatistics;
+using ::tensorflow::metadata::v0::DatasetFeatureStatisticsList;
+
+DatasetFeatureStatisticsList GetTestStatistics() {
+  return ParseTextProtoOrDie<DatasetFeatureStatisticsList>(R"(
+    datasets {
+      name: "All Examples"
+      num_examples: 10
+      weighted_num_examples: 15
+      features {
+        path { step: "num" }
+        type: FLOAT
+        num_stats {
+          common_stats { num_non_missing: 10 max_num_values: 1 }
+          mean: 1.5
+          histograms {
+            buckets { low_value: 0 high_value: 3 sample_count: 10 }
+            type: STANDARD
+          }
+          weighted_numeric_stats {
+            mean: 2
+            histograms { num_nan: 1 type: QUANTILES }
+          }
+        }
+        custom_stats { name: "custom" num: 3 }
+      }
+      features {
+        path { step: "str" }
+        type: STRING
+        string_stats {
+          common_stats { num_missing: 2 }
+          unique: 2
+          rank_histogram { buckets { label: "a" sample_count: 3 } }
+          weighted_string_stats {
+            rank_histogram { buckets { label: "a" sample_count: 4 } }
+          }
+        }
+      }
+      features {
+        path { step: "struct" }
+        type: STRUCT
+        struct_stats {}
+      }
+      features {
+        path { step: "struct" step: "bytes" }
+        type: BYTES
+        bytes_stats { unique: 1 }
+      }
+      features { path { step: "empty" } }
+    }
+    datasets {
+      name: "slice"
+      features {
+        name: "named"
+        type: INT
+        num_stats { common_stats { num_non_missing: 1 } }
+      }
+    }
+    datasets {}
+  )");
+}
+
+TEST(ColumnarStatisticsTest, RoundTrip) {
+  const DatasetFeatureStatisticsList statistics = GetTestStatistics();
+  string columnar;
+  TF_ASSERT_OK(WriteColumnarStatistics(statistics, &columnar));
+  DatasetFeatureStatisticsList result;
+  TF_ASSERT_OK(ColumnarStatisticsToProto(columnar, &result));
+  EXPECT_THAT(result, EqualsProto(statistics));
+  // Presence of empty messages is preserved.
+  EXPECT_EQ(result.datasets(0).features(2).stats_case(),
+            metadata::v0::FeatureNameStatistics::kStructStats);
+  EXPECT_FALSE(result.datasets(0).features(3).bytes_stats().has_common_stats());
+}
+
+TEST(ColumnarStatisticsTest, ReadSelectedFeaturesAndColumns) {
+  string columnar;
+  TF_ASSERT_OK(WriteColumnarStatistics(GetTestStatistics(), &columnar));
+  std::unique_ptr<ColumnarStatisticsReader> reader;
+  TF_ASSERT_OK(ColumnarStatisticsReader::FromBuffer(columnar, &reader));
+  EXPECT_THAT(reader->dataset_names(),
+              ::testing::ElementsAre("All Examples", "slice", ""));
+  EXPECT_EQ(reader->FindDataset("slice"), 1);
+  EXPECT_EQ(reader->FindDataset("missing"), -1);
+
+  ColumnarStatisticsReadOptions options;
+  options.feature_paths = std::set<Path>({Path({"num"}), Path({"named"})});
+  options.include_histograms = false;
+  options.include_custom_stats = false;
+  DatasetFeatureStatistics result;
+  TF_ASSERT_OK(reader->ReadDataset(0, options, &result));
+  EXPECT_THAT(result, EqualsProto(R"(
+    name: "All Examples"
+    num_examples: 10
+    weighted_num_examples: 15
+    features {
+      path { step: "num" }
+      type: FLOAT
+      num_stats {
+        common_stats { num_non_missing: 10 max_num_values: 1 }
+        mean: 1.5
+        weighted_numeric_stats { mean: 2 }
+      }
+    })"));
+  TF_ASSERT_OK(reader->ReadDataset(1, options, &result));
+  EXPECT_EQ(result.features_size(), 1);
+  EXPECT_EQ(result.features(0).name(), "named");
+  EXPECT_FALSE(reader->ReadDataset(3, options, &result).ok());
+}
+
+TEST(ColumnarStatisticsTest, OpenFile) {
+  const DatasetFeatureStatisticsList statistics = GetTestStatistics();
+  string columnar;
+  TF_ASSERT_OK(WriteColumnarStatistics(statistics, &columnar));
+  const string filename = ::testing::TempDir() + "/stats.columnar";
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), filename, columnar));
+  std::unique_ptr<ColumnarStatisticsReader> reader;
+  TF_ASSERT_OK(ColumnarStatisticsReader::Open(filename, &reader));
+  DatasetFeatureStatisticsList result;
+  TF_ASSERT_OK(reader->ReadAll(ColumnarStatisticsReadOptions(), &result));
+  EXPECT_THAT(result, EqualsProto(statistics));
+}
+
+TEST(ColumnarStatisticsTest, DatasetStatsBackend) {
+  string columnar;
+  TF_ASSERT_OK(WriteColumnarStatistics(GetTestStatistics(), &columnar));
+  std::unique_ptr<ColumnarStatisticsReader> reader;
+  TF_ASSERT_OK(ColumnarStatisticsReader::FromBuffer(columnar, &reader));
+  std::shared_ptr<const DatasetStatsBackend> backend;
+  TF_ASSERT_OK(MakeColumnarDatasetStatsBackend(
+      std::move(reader), 0, ColumnarStatisticsReadOptions(), &backend));
+  const DatasetStatsView view(backend, /*by_weight=*/false, absl::nullopt,
+                              nullptr, nullptr, nullptr);
+  EXPECT_EQ(view.GetNumExamples(), 10);
+  // The feature without stats is skipped, as with a proto.
+  EXPECT_EQ(view.features().size(), 4);
+  EXPECT_EQ(view.GetRootFeatures().size(), 3);
+
+  const absl::optional<FeatureStatsView> num = view.GetByPath(Path({"num"}));
+  ASSERT_TRUE(num);
+  EXPECT_EQ(num->GetNumPresent(), 10);
+  EXPECT_THAT(num->GetMinMaxNumValues(),
+              ::testing::ElementsAre(std::make_pair(0, 1)));
+  ASSERT_TRUE(num->GetStandardHistogram());
+  EXPECT_EQ(num->GetStandardHistogram()->buckets_size(), 1);
+  EXPECT_EQ(num->custom_stats().size(), 1);
+
+  const absl::optional<FeatureStatsView> str = view.GetByPath(Path({"str"}));
+  ASSERT_TRUE(str);
+  EXPECT_EQ(str->GetNumMissing(), 2);
+  EXPECT_THAT(str->GetStringValuesWithCounts(),
+              ::testing::ElementsAre(std::make_pair("a", 3.0)));
+  EXPECT_EQ(str->GetNumUnique(), 2);
+
+  const absl::optional<FeatureStatsView> bytes =
+      view.GetByPath(Path({"struct", "bytes"}));
+  ASSERT_TRUE(bytes);
+  EXPECT_EQ(bytes->GetParent()->GetPath(), Path({"struct"}));
+
+  const DatasetStatsView weighted_view(backend, /*by_weight=*/true,
+                                       absl::nullopt, nullptr, nullptr,
+                                       nullptr);
+  EXPECT_EQ(weighted_view.GetNumExamples(), 15);
+  EXPECT_THAT(weighted_view.GetByPath(Path({"str"}))
+                  ->GetStringValuesWithCounts(),
+              ::testing::ElementsAre(std::make_pair("a", 4.0)));
+}
+
+TEST(ColumnarStatisticsTest, DatasetStatsBackendInvalidStats) {
+  string columnar;
+  TF_ASSERT_OK(WriteColumnarStatistics(GetTestStatistics(), &columnar));
+  // Corrupts the wire type of the mean of "num" in its stats column, which is
+  // only parsed when the statistics of the feature are read.
+  const string mean("\x11\0\0\0\0\0\0\xf8\x3f", 9);
+  const size_t pos = columnar.find(mean);
+  ASSERT_NE(pos, string::npos);
+  columnar[pos] = '\x17';
+  std::unique_ptr<ColumnarStatisticsReader> reader;
+  TF_ASSERT_OK(ColumnarStatisticsReader::FromBuffer(columnar, &reader));
+  std::shared_ptr<const DatasetStatsBackend> backend;
+  TF_ASSERT_OK(MakeColumnarDatasetStatsBackend(
+      std::move(reader), 0, ColumnarStatisticsReadOptions(), &backend));
+  TF_EXPECT_OK(backend->status());
+  const DatasetStatsView view(backend, /*by_weight=*/false, absl::nullopt,
+                              nullptr, nullptr, nullptr);
+  const absl::optional<FeatureStatsView> num = view.GetByPath(Path({"num"}));
+  ASSERT_TRUE(num);
+  // The statistics of the feature are empty, and the error is reported by the
+  // backend.
+  EXPECT_EQ(num->GetNumPresent(), 0);
+  EXPECT_EQ(backend->status().code(), error::DATA_LOSS);
+  const absl::optional<FeatureStatsView> str = view.GetByPath(Path({"str"}));
+  ASSERT_TRUE(str);
+  EXPECT_EQ(str->GetNumMissing(), 2);
+
+  DatasetFeatureStatisticsList result;
+  EXPECT_FALSE(ColumnarStatisticsToProto(columnar, &result).ok());
+}
+
+TEST(ColumnarStatisticsTest, OverflowingCounts) {
+  string columnar;
+  TF_ASSERT_OK(WriteColumnarStatistics(GetTestStatistics(), &columnar));
+  const uint64 num_rows = core::DecodeFixed64(columnar.data() + 24);
+  // Counts whose column sizes overflow to (close to) the actual sizes.
+  for (const auto& field_and_count :
+       std::vector<std::pair<int, uint64>>{
+           {16, ~uint64{0}},
+           {24, ~uint64{0}},
+           {24, (uint64{1} << 62) + num_rows},
+           {24, (uint64{1} << 61) + num_rows}}) {
+    string corrupt = columnar;
+    char count[8];
+    core::EncodeFixed64(count, field_and_count.second);
+    corrupt.replace(field_and_count.first, 8, count, 8);
+    std::unique_ptr<ColumnarStatisticsReader> reader;
+    EXPECT_EQ(ColumnarStatisticsReader::FromBuffer(corrupt, &reader).code(),
+              error::DATA_LOSS)
+        << field_and_count.first << " " << field_and_count.second;
+  }
+}
+
+TEST(ColumnarStatisticsTest, InvalidData) {
+  DatasetFeatureStatisticsList result;
+  EXPECT_FALSE(ColumnarStatisticsToProto("", &result).ok());
+  EXPECT_FALSE(ColumnarStatisticsToProto("not a columnar file", &result).ok());
+  string columnar;
+  TF_ASSERT_OK(WriteColumnarStatistics(GetTestStatistics(), &columnar));
+  for (const int size : {16, 40, 100, static_cast<int>(columnar.size()) - 1}) {
+    EXPECT_FALSE(
+        ColumnarStatisticsToProto(absl::string_view(columnar).substr(0, size),
+                                  &result)
+            .ok())
+        << size;
+  }
+}
+
+}  // namespace
+}  // namespace data_validation
+}  // namespace tensorflow
@@ -0,0 +1,202 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/compact_statistics.h"
+
+#include <algorithm>
+
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/platform/protobuf.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+namespace {
+
+using ::tensorflow::metadata::v0::CommonStatistics;
+using ::tensorflow::metadata::v0::CustomStatistic;
+using ::tensorflow::metadata::v0::DatasetFeatureStatistics;
+using ::tensorflow::metadata::v0::DatasetFeatureStatisticsList;
+using ::tensorflow::metadata::v0::FeatureNameStatistics;
+using ::tensorflow::metadata::v0::Histogram;
+using ::tensorflow::metadata::v0::RankHistogram;
+using ::tensorflow::protobuf::RepeatedPtrField;
+
+// The names of the custom statistics read by the validation checks.
+// LINT.IfChange
+constexpr absl::string_view kValidationCustomStats[] = {
+    // Custom domains.
+    "domain_info",
+    // Image domains.
+    "image_format_histogram",
+    // Sparse features.
+    "missing_value", "missing_index", "max_length_diff", "min_length_diff",
+    // Weighted features.
+    "missing_weight", "max_weight_length_diff", "min_weight_length_diff",
+};
+// LINT.ThenChange(custom_domain_util.cc, image_domain_util.cc, schema.cc)
+
+bool IsValidationCustomStat(const CustomStatistic& custom_stat) {
+  return std::find(std::begin(kValidationCustomStats),
+                   std::end(kValidationCustomStats),
+                   custom_stat.name()) != std::end(kValidationCustomStats);
+}
+
+void CompactCommonStats(const CompactStatisticsOptions& options,
+                        CommonStatistics* common_stats) {
+  common_stats->clear_num_values_histogram();
+  common_stats->clear_feature_list_length_histogram();
+  if (!options.keep_weighted_stats) {
+    common_stats->clear_weighted_common_stats();
+    common_stats->clear_weighted_presence_and_valency_stats();
+  }
+}
+
+// Returns true if <bucket> shows values which are not in {0, 1}, so that a
+// bool_domain check would convert the feature to a float_domain.
+// LINT.IfChange
+bool HasNonBooleanValues(const Histogram& histogram,
+                         const Histogram::Bucket& bucket) {
+  return bucket.sample_count() > 0 &&
+         (bucket.high_value() < 0 || bucket.low_value() > 1 ||
+          (histogram.type() == Histogram::QUANTILES &&
+           bucket.high_value() < 1 && bucket.low_value() > 0));
+}
+// LINT.ThenChange(bool_domain_util.cc)
+
+// STANDARD histograms are read in full. Other histograms are only read for
+// their NaN counts and by the bool_domain check, which stops at the first
+// bucket with non boolean values, so only that bucket is kept.
+void CompactHistograms(RepeatedPtrField<Histogram>* histograms) {
+  for (Histogram& histogram : *histograms) {
+    if (histogram.type() == Histogram::STANDARD) {
+      continue;
+    }
+    RepeatedPtrField<Histogram::Bucket>* buckets =
+        histogram.mutable_buckets();
+    auto first_non_boolean = std::find_if(
+        buckets->begin(), buckets->end(),
+        [&histogram](const Histogram::Bucket& bucket) {
+          return HasNonBooleanValues(histogram, bucket);
+        });
+    if (first_non_boolean == buckets->end()) {
+      histogram.clear_buckets();
+      continue;
+    }
+    const int index = first_non_boolean - buckets->begin();
+    buckets->SwapElements(0, index);
+    buckets->DeleteSubrange(1, buckets->size() - 1);
+  }
+}
+
+void CompactRankHistogram(RankHistogram* rank_histogram) {
+  for (RankHistogram::Bucket& bucket : *rank_histogram->mutable_buckets()) {
+    bucket.clear_low_rank();
+    bucket.clear_high_rank();
+  }
+}
+
+void CompactFeature(const CompactStatisticsOptions& options,
+                    FeatureNameStatistics* feature) {
+  switch (feature->stats_case()) {
+    case FeatureNameStatistics::kNumStats: {
+      auto* num_stats = feature->mutable_num_stats();
+      CompactCommonStats(options, num_stats->mutable_common_stats());
+      CompactHistograms(num_stats->mutable_histograms());
+      if (!options.keep_weighted_stats) {
+        num_stats->clear_weighted_numeric_stats();
+      } else if (num_stats->has_weighted_numeric_stats()) {
+        CompactHistograms(
+            num_stats->mutable_weighted_numeric_stats()->mutable_histograms());
+      }
+      break;
+    }
+    case FeatureNameStatistics::kStringStats: {
+      auto* string_stats = feature->mutable_string_stats();
+      CompactCommonStats(options, string_stats->mutable_common_stats());
+      string_stats->clear_top_values();
+      CompactRankHistogram(string_stats->mutable_rank_histogram());
+      if (!options.keep_weighted_stats) {
+        string_stats->clear_weighted_string_stats();
+      } else if (string_stats->has_weighted_string_stats()) {
+        auto* weighted_string_stats =
+            string_stats->mutable_weighted_string_stats();
+        weighted_string_stats->clear_top_values();
+        CompactRankHistogram(weighted_string_stats->mutable_rank_histogram());
+      }
+      break;
+    }
+    case FeatureNameStatistics::kBytesStats:
+      CompactCommonStats(options,
+                         feature->mutable_bytes_stats()->mutable_common_stats());
+      break;
+    case FeatureNameStatistics::kStructStats:
+      CompactCommonStats(
+          options, feature->mutable_struct_stats()->mutable_common_stats());
+      break;
+    default:
+      // A feature without stats is ignored by the validation unless it has
+      // custom stats, so keep all of them.
+      return;
+  }
+  RepeatedPtrField<CustomStatistic>* custom_stats =
+      feature->mutable_custom_stats();
+  custom_stats->erase(
+      std::remove_if(custom_stats->begin(), custom_stats->end(),
+                     [](const CustomStatistic& custom_stat) {
+                       return !IsValidationCustomStat(custom_stat);
+                     }),
+      custom_stats->end());
+}
+
+}  // namespace
+
+void CompactStatisticsForValidation(const CompactStatisticsOptions& options,
+                                    DatasetFeatureStatistics* statistics) {
+  statistics->clear_cross_features();
+  if (!options.keep_weighted_stats) {
+    statistics->clear_weighted_num_examples();
+  }
+  for (FeatureNameStatistics& feature : *statistics->mutable_features()) {
+    CompactFeature(options, &feature);
+  }
+}
+
+void CompactStatisticsForValidation(const CompactStatisticsOptions& options,
+                                    DatasetFeatureStatisticsList* statistics) {
+  for (DatasetFeatureStatistics& dataset : *statistics->mutable_datasets()) {
+    CompactStatisticsForValidation(options, &dataset);
+  }
+}
+
+Status CompactStatisticsForValidation(const CompactStatisticsOptions& options,
+                                      const string& serialized_statistics,
+                                      string* serialized_result) {
+  DatasetFeatureStatisticsList statistics;
+  if (!statistics.ParseFromString(serialized_statistics)) {
+    return errors::InvalidArgument(
+        "Unable to parse the DatasetFeatureStatisticsList.");
+  }
+  CompactStatisticsForValidation(options, &statistics);
+  if (!statistics.SerializeToString(serialized_result)) {
+    return errors::Internal(
+        "Unable to serialize the compacted DatasetFeatureStatisticsList.");
+  }
+  return Status::OK();
+}
+
+}  // namespace data_validation
+}  // namespace tensorflow
@@ -0,0 +1,66 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Removes from statistics the fields that are never read when validating
+// them, so that statistics can be compacted once when they are written and
+// are then cheaper to store and to parse for every later validation.
+#ifndef TENSORFLOW_DATA_VALIDATION_ANOMALIES_COMPACT_STATISTICS_H_
+#define TENSORFLOW_DATA_VALIDATION_ANOMALIES_COMPACT_STATISTICS_H_
+
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow_metadata/proto/v0/statistics.pb.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+struct CompactStatisticsOptions {
+  // If false, the weighted statistics are removed as well, and the compacted
+  // statistics are always validated as unweighted.
+  bool keep_weighted_stats = true;
+};
+
+// Compacts <statistics> in place. The result gives the same anomalies as the
+// original statistics when passed to ValidateFeatureStatistics (as the
+// current statistics or as the statistics of a previous span, serving data or
+// previous version), and the same schema when passed to InferSchema or
+// UpdateSchema. Removed are:
+// - the cross feature statistics;
+// - the num_values and feature_list_length histograms;
+// - the buckets of all the numeric histograms other than STANDARD ones, except
+//   for the first bucket with values not in {0, 1}, which is read by the
+//   bool_domain check (their NaN counts are kept);
+// - the top values of string features and the ranks of rank histograms;
+// - the custom statistics that no validation check reads;
+// - if !options.keep_weighted_stats, all the weighted statistics.
+void CompactStatisticsForValidation(
+    const CompactStatisticsOptions& options,
+    metadata::v0::DatasetFeatureStatistics* statistics);
+
+// Same as above, for all the datasets of <statistics>.
+void CompactStatisticsForValidation(
+    const CompactStatisticsOptions& options,
+    metadata::v0::DatasetFeatureStatisticsList* statistics);
+
+// Same as above, but takes and outputs a serialized
+// DatasetFeatureStatisticsList.
+Status CompactStatisticsForValidation(const CompactStatisticsOptions& options,
+                                      const string& serialized_statistics,
+                                      string* serialized_result);
+
+}  // namespace data_validation
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_DATA_VALIDATION_ANOMALIES_COMPACT_STATISTICS_H_
@@ -0,0 +1,302 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/compact_statistics.h"
+
+#include <string>
+
+#include <gtest/gtest.h>
+#include "absl/types/optional.h"
+#include "tensorflow_data_validation/anomalies/feature_statistics_validator.h"
+#include "tensorflow_data_validation/anomalies/test_util.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow_metadata/proto/v0/anomalies.pb.h"
+#include "tensorflow_metadata/proto/v0/schema.pb.h"
+#include "tensorflow_metadata/proto/v0/statistics.pb.h"
+
+namespace tensorflow {
+namespace data_validation {
+namespace {
+
+using ::tensorflow::data_validation::testing::EqualsProto;
+using ::tensorflow::data_validation::testing::ParseTextProtoOrDie;
+using ::tensorflow::metadata::v0::DatasetFeatureStatistics;
+using ::tensorflow::metadata::v0::DatasetFeatureStatisticsList;
+using ::tensorflow::metadata::v0::Schema;
+
+DatasetFeatureStatistics GetTestStatistics() {
+  return ParseTextProtoOrDie<DatasetFeatureStatistics>(R"(
+    num_examples: 10
+    weighted_num_examples: 15
+    features {
+      path { step: "num" }
+      type: FLOAT
+      num_stats {
+        common_stats {
+          num_non_missing: 10
+          min_num_values: 1
+          max_num_values: 1
+          num_values_histogram { buckets { sample_count: 10 } }
+          weighted_common_stats { num_non_missing: 15 }
+        }
+        min: 1
+        max: 2
+        histograms {
+          buckets { low_value: 1 high_value: 2 sample_count: 10 }
+          type: STANDARD
+        }
+        histograms {
+          num_nan: 1
+          buckets { low_value: 1 high_value: 2 sample_count: 10 }
+          type: QUANTILES
+        }
+        weighted_numeric_stats {
+          histograms {
+            buckets { low_value: 1 high_value: 2 sample_count: 15 }
+            type: QUANTILES
+          }
+        }
+      }
+      custom_stats { name: "domain_info" str: "int_domain {}" }
+      custom_stats { name: "unused" num: 3 }
+    }
+    features {
+      path { step: "str" }
+      type: STRING
+      string_stats {
+        common_stats {
+          num_non_missing: 10
+          weighted_common_stats { num_non_missing: 15 }
+        }
+        unique: 2
+        top_values { value: "a" frequency: 8 }
+        rank_histogram {
+          buckets { low_rank: 0 high_rank: 0 label: "a" sample_count: 8 }
+          buckets { low_rank: 1 high_rank: 1 label: "b" sample_count: 2 }
+        }
+        weighted_string_stats {
+          top_values { value: "a" frequency: 12 }
+          rank_histogram {
+            buckets { label: "a" sample_count: 12 }
+            buckets { label: "b" sample_count: 3 }
+          }
+        }
+      }
+    }
+    features {
+      path { step: "sparse" }
+      custom_stats { name: "missing_value" num: 1 }
+    }
+    cross_features {
+      path_x { step: "num" }
+      path_y { step: "str" }
+      count: 10
+    })");
+}
+
+TEST(CompactStatisticsTest, KeepWeightedStats) {
+  DatasetFeatureStatistics statistics = GetTestStatistics();
+  CompactStatisticsForValidation(CompactStatisticsOptions(), &statistics);
+  EXPECT_THAT(statistics, EqualsProto(R"(
+    num_examples: 10
+    weighted_num_examples: 15
+    features {
+      path { step: "num" }
+      type: FLOAT
+      num_stats {
+        common_stats {
+          num_non_missing: 10
+          min_num_values: 1
+          max_num_values: 1
+          weighted_common_stats { num_non_missing: 15 }
+        }
+        min: 1
+        max: 2
+        histograms {
+          buckets { low_value: 1 high_value: 2 sample_count: 10 }
+          type: STANDARD
+        }
+        histograms { num_nan: 1 type: QUANTILES }
+        weighted_numeric_stats { histograms { type: QUANTILES } }
+      }
+      custom_stats { name: "domain_info" str: "int_domain {}" }
+    }
+    features {
+      path { step: "str" }
+      type: STRING
+      string_stats {
+        common_stats {
+          num_non_missing: 10
+          weighted_common_stats { num_non_missing: 15 }
+        }
+        unique: 2
+        rank_histogram {
+          buckets { label: "a" sample_count: 8 }
+          buckets { label: "b" sample_count: 2 }
+        }
+        weighted_string_stats {
+          rank_histogram {
+            buckets { label: "a" sample_count: 12 }
+            buckets { label: "b" sample_count: 3 }
+          }
+        }
+      }
+    }
+    features {
+      path { step: "sparse" }
+      custom_stats { name: "missing_value" num: 1 }
+    })"));
+}
+
+TEST(CompactStatisticsTest, RemoveWeightedStats) {
+  DatasetFeatureStatisticsList statistics;
+  *statistics.add_datasets() = GetTestStatistics();
+  CompactStatisticsOptions options;
+  options.keep_weighted_stats = false;
+  string serialized_result;
+  TF_ASSERT_OK(CompactStatisticsForValidation(
+      options, statistics.SerializeAsString(), &serialized_result));
+  DatasetFeatureStatisticsList result;
+  ASSERT_TRUE(result.ParseFromString(serialized_result));
+  ASSERT_EQ(result.datasets_size(), 1);
+  const DatasetFeatureStatistics& dataset = result.datasets(0);
+  EXPECT_EQ(dataset.weighted_num_examples(), 0);
+  EXPECT_FALSE(
+      dataset.features(0).num_stats().common_stats().has_weighted_common_stats());
+  EXPECT_FALSE(dataset.features(0).num_stats().has_weighted_numeric_stats());
+  EXPECT_FALSE(dataset.features(1).string_stats().has_weighted_string_stats());
+
+  EXPECT_FALSE(
+      CompactStatisticsForValidation(options, "invalid", &serialized_result)
+          .ok());
+}
+
+TEST(CompactStatisticsTest, SameAnomalies) {
+  const Schema schema = ParseTextProtoOrDie<Schema>(R"(
+    feature {
+      name: "num"
+      type: FLOAT
+      float_domain { min: 3 }
+    }
+    feature {
+      name: "str"
+      type: BYTES
+      string_domain { value: "a" }
+      drift_comparator { infinity_norm { threshold: 0.01 } }
+    })");
+  // The sparse feature is not in the schema.
+  DatasetFeatureStatistics statistics = GetTestStatistics();
+  statistics.mutable_features()->RemoveLast();
+  DatasetFeatureStatistics previous = statistics;
+  previous.mutable_features(1)
+      ->mutable_string_stats()
+      ->mutable_weighted_string_stats()
+      ->mutable_rank_histogram()
+      ->mutable_buckets(1)
+      ->set_sample_count(5);
+  DatasetFeatureStatistics compact_statistics = statistics;
+  CompactStatisticsForValidation(CompactStatisticsOptions(),
+                                 &compact_statistics);
+  DatasetFeatureStatistics compact_previous = previous;
+  CompactStatisticsForValidation(CompactStatisticsOptions(), &compact_previous);
+
+  metadata::v0::Anomalies expected;
+  TF_ASSERT_OK(ValidateFeatureStatistics(
+      statistics, schema, /*environment=*/absl::nullopt, previous,
+      /*serving_feature_statistics=*/absl::nullopt,
+      /*prev_version_feature_statistics=*/absl::nullopt,
+      /*features_needed=*/absl::nullopt, ValidationConfig(),
+      /*enable_diff_regions=*/false, &expected));
+  ASSERT_EQ(expected.anomaly_info().size(), 2);
+  metadata::v0::Anomalies result;
+  TF_ASSERT_OK(ValidateFeatureStatistics(
+      compact_statistics, schema, /*environment=*/absl::nullopt,
+      compact_previous, /*serving_feature_statistics=*/absl::nullopt,
+      /*prev_version_feature_statistics=*/absl::nullopt,
+      /*features_needed=*/absl::nullopt, ValidationConfig(),
+      /*enable_diff_regions=*/false, &result));
+  // anomaly_info is a map, so compare the (sorted) text formats.
+  EXPECT_EQ(result.DebugString(), expected.DebugString());
+}
+
+TEST(CompactStatisticsTest, SameBoolDomainAnomalies) {
+  const Schema schema = ParseTextProtoOrDie<Schema>(R"(
+    feature {
+      name: "bool"
+      type: FLOAT
+      bool_domain {}
+    })");
+  // Only the QUANTILES histogram shows values between 0 and 1.
+  const DatasetFeatureStatistics statistics =
+      ParseTextProtoOrDie<DatasetFeatureStatistics>(R"(
+        num_examples: 10
+        features {
+          path { step: "bool" }
+          type: FLOAT
+          num_stats {
+            common_stats {
+              num_non_missing: 10
+              min_num_values: 1
+              max_num_values: 1
+            }
+            min: 0
+            max: 1
+            histograms {
+              buckets { low_value: 0 high_value: 0.5 sample_count: 5 }
+              buckets { low_value: 0.5 high_value: 1 sample_count: 5 }
+              type: STANDARD
+            }
+            histograms {
+              buckets { low_value: 0 high_value: 0 sample_count: 3 }
+              buckets { low_value: 0.25 high_value: 0.75 sample_count: 4 }
+              buckets { low_value: 0.8 high_value: 0.9 sample_count: 0 }
+              buckets { low_value: 1 high_value: 1 sample_count: 3 }
+              type: QUANTILES
+            }
+          }
+        })");
+  DatasetFeatureStatistics compact_statistics = statistics;
+  CompactStatisticsForValidation(CompactStatisticsOptions(),
+                                 &compact_statistics);
+  EXPECT_THAT(compact_statistics.features(0).num_stats().histograms(1),
+              EqualsProto(R"(
+                buckets { low_value: 0.25 high_value: 0.75 sample_count: 4 }
+                type: QUANTILES)"));
+
+  metadata::v0::Anomalies expected;
+  TF_ASSERT_OK(ValidateFeatureStatistics(
+      statistics, schema, /*environment=*/absl::nullopt,
+      /*prev_feature_statistics=*/absl::nullopt,
+      /*serving_feature_statistics=*/absl::nullopt,
+      /*prev_version_feature_statistics=*/absl::nullopt,
+      /*features_needed=*/absl::nullopt, ValidationConfig(),
+      /*enable_diff_regions=*/false, &expected));
+  ASSERT_EQ(expected.anomaly_info().size(), 1);
+  EXPECT_EQ(expected.anomaly_info().at("bool").reason(0).type(),
+            metadata::v0::AnomalyInfo::BOOL_TYPE_UNEXPECTED_FLOAT);
+  metadata::v0::Anomalies result;
+  TF_ASSERT_OK(ValidateFeatureStatistics(
+      compact_statistics, schema, /*environment=*/absl::nullopt,
+      /*prev_feature_statistics=*/absl::nullopt,
+      /*serving_feature_statistics=*/absl::nullopt,
+      /*prev_version_feature_statistics=*/absl::nullopt,
+      /*features_needed=*/absl::nullopt, ValidationConfig(),
+      /*enable_diff_regions=*/false, &result));
+  EXPECT_EQ(result.DebugString(), expected.DebugString());
+}
+
+}  // namespace
+}  // namespace data_validation
+}  // namespace tensorflow
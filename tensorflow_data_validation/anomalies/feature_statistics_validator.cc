@@ -15,28 +15,226 @@ limitations under the License.
 
 #include "tensorflow_data_validation/anomalies/feature_statistics_validator.h"
 
+#include <algorithm>
+#include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "absl/types/optional.h"
+#include "tensorflow_data_validation/anomalies/columnar_statistics.h"
 #include "tensorflow_data_validation/anomalies/schema.h"
 #include "tensorflow_data_validation/anomalies/schema_anomalies.h"
+#include "tensorflow_data_validation/anomalies/schema_util.h"
 #include "tensorflow_data_validation/anomalies/statistics_view.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/threadpool.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow_metadata/proto/v0/schema.pb.h"
 
 using tensorflow::metadata::v0::DatasetFeatureStatistics;
+using tensorflow::metadata::v0::DatasetFeatureStatisticsList;
 
 namespace tensorflow {
 namespace data_validation {
 
 namespace {
 const int64 kDefaultEnumThreshold = 400;
+
+// Returns a backend over <shards>, or nullptr if there are none. All the
+// shards must have the same number of examples.
+Status MakeShardedBackend(
+    const std::vector<DatasetFeatureStatistics>& shards,
+    std::shared_ptr<const DatasetStatsBackend>* backend) {
+  if (shards.empty()) {
+    *backend = nullptr;
+    return Status::OK();
+  }
+  std::vector<std::shared_ptr<const DatasetStatsBackend>> shard_backends;
+  for (const DatasetFeatureStatistics& shard : shards) {
+    if (shard.num_examples() != shards[0].num_examples() ||
+        shard.weighted_num_examples() != shards[0].weighted_num_examples()) {
+      return errors::InvalidArgument(
+          "All the statistics shards must have the same num_examples and "
+          "weighted_num_examples.");
+    }
+    shard_backends.push_back(MakeUnownedProtoDatasetStatsBackend(shard));
+  }
+  *backend = MakeShardedDatasetStatsBackend(std::move(shard_backends));
+  return Status::OK();
+}
+
+// Returns the config used to validate statistics with <validation_config>.
+FeatureStatisticsToProtoConfig MakeValidationFeatureStatisticsToProtoConfig(
+    const ValidationConfig& validation_config) {
+  FeatureStatisticsToProtoConfig feature_statistics_to_proto_config;
+  feature_statistics_to_proto_config.set_enum_threshold(kDefaultEnumThreshold);
+  feature_statistics_to_proto_config.set_new_features_are_warnings(
+      validation_config.new_features_are_warnings());
+  *feature_statistics_to_proto_config.mutable_severity_overrides() =
+      validation_config.severity_overrides();
+  return feature_statistics_to_proto_config;
+}
+
+// Validates <statistics> as described in ValidateFeatureStatistics. The
+// features are validated in up to <num_work_units> parallel work units, each
+// of which handles a contiguous range of root features (with their
+// descendants). Missing features and dataset-level constraints are checked
+// once all the work units are done.
+Status ValidateStatsBackends(
+    const std::shared_ptr<const DatasetStatsBackend>& statistics,
+    const std::shared_ptr<const Schema>& schema,
+    const absl::optional<string>& environment,
+    const std::shared_ptr<const DatasetStatsBackend>& prev_span_statistics,
+    const std::shared_ptr<const DatasetStatsBackend>& serving_statistics,
+    const std::shared_ptr<const DatasetStatsBackend>& prev_version_statistics,
+    const absl::optional<FeaturesNeeded>& features_needed,
+    const FeatureStatisticsToProtoConfig& feature_statistics_to_proto_config,
+    bool enable_diff_regions, bool baseline_fingerprint_only,
+    int num_work_units, metadata::v0::Anomalies* result) {
+  const bool by_weight =
+      DatasetStatsView(statistics, /*by_weight=*/false, absl::nullopt,
+                       /*previous_span=*/nullptr, /*serving=*/nullptr,
+                       /*previous_version=*/nullptr)
+          .WeightedStatisticsExist();
+  const metadata::v0::Schema& schema_proto = schema->schema_proto();
+  if (statistics->num_examples() == 0) {
+    *result->mutable_baseline() = baseline_fingerprint_only
+                                      ? MakeFingerprintBaseline(schema_proto)
+                                      : schema_proto;
+    result->set_data_missing(true);
+    return Status::OK();
+  }
+
+  // The views share the paths interned for this validation, which are freed
+  // with them.
+  const auto path_interner = std::make_shared<PathInterner>();
+  const auto make_view =
+      [&](const std::shared_ptr<const DatasetStatsBackend>& backend)
+      -> std::shared_ptr<DatasetStatsView> {
+    if (backend == nullptr) {
+      return nullptr;
+    }
+    return std::make_shared<DatasetStatsView>(
+        backend, by_weight, environment, /*previous_span=*/nullptr,
+        /*serving=*/nullptr, /*previous_version=*/nullptr, path_interner);
+  };
+  const DatasetStatsView training(
+      statistics, by_weight, environment, make_view(prev_span_statistics),
+      make_view(serving_statistics), make_view(prev_version_statistics),
+      path_interner);
+
+  SchemaAnomalies schema_anomalies(schema);
+  const std::vector<FeatureStatsView> root_features =
+      training.GetRootFeatures();
+  num_work_units = std::max(
+      1, std::min<int>(num_work_units, root_features.size()));
+  if (num_work_units == 1) {
+    TF_RETURN_IF_ERROR(
+        schema_anomalies.FindChanges(training, features_needed,
+                                     feature_statistics_to_proto_config));
+  } else {
+    std::vector<SchemaAnomalies> partial_anomalies;
+    partial_anomalies.reserve(num_work_units);
+    for (int i = 0; i < num_work_units; ++i) {
+      partial_anomalies.emplace_back(schema);
+    }
+    std::vector<Status> statuses(num_work_units);
+    {
+      thread::ThreadPool pool(
+          Env::Default(), "validate_feature_statistics",
+          std::min(num_work_units, port::MaxParallelism()));
+      for (int i = 0; i < num_work_units; ++i) {
+        pool.Schedule([&, i]() {
+          const int begin = root_features.size() * i / num_work_units;
+          const int end = root_features.size() * (i + 1) / num_work_units;
+          statuses[i] = partial_anomalies[i].FindFeatureChanges(
+              std::vector<FeatureStatsView>(root_features.begin() + begin,
+                                            root_features.begin() + end),
+              features_needed, feature_statistics_to_proto_config);
+        });
+      }
+    }
+    for (int i = 0; i < num_work_units; ++i) {
+      TF_RETURN_IF_ERROR(statuses[i]);
+      TF_RETURN_IF_ERROR(
+          schema_anomalies.MergeFeatureAnomalies(&partial_anomalies[i]));
+    }
+    TF_RETURN_IF_ERROR(schema_anomalies.FindMissingAndDatasetChanges(
+        training, features_needed, feature_statistics_to_proto_config));
+  }
+  // Statistics which failed to decode lazily were validated as empty.
+  for (const auto* backend :
+       {&statistics, &prev_span_statistics, &serving_statistics,
+        &prev_version_statistics}) {
+    if (*backend != nullptr) {
+      TF_RETURN_IF_ERROR((*backend)->status());
+    }
+  }
+  *result = schema_anomalies.GetSchemaDiff(enable_diff_regions,
+                                          baseline_fingerprint_only);
+  return Status::OK();
+}
+
+// Indexes the datasets of <statistics_list> by name. The names must be unique.
+Status IndexDatasetsByName(
+    const DatasetFeatureStatisticsList& statistics_list,
+    std::map<string, const DatasetFeatureStatistics*>* result) {
+  result->clear();
+  for (const DatasetFeatureStatistics& dataset : statistics_list.datasets()) {
+    if (!result->emplace(dataset.name(), &dataset).second) {
+      return errors::InvalidArgument("Duplicate dataset name: ",
+                                     dataset.name());
+    }
+  }
+  return Status::OK();
+}
+
+// Parses a serialized FeaturesNeededProto. If <features_needed_string> is
+// empty or holds no features, *features_needed is nullopt.
+Status ParseFeaturesNeeded(const string& features_needed_string,
+                           absl::optional<FeaturesNeeded>* features_needed) {
+  *features_needed = gtl::nullopt;
+  if (!features_needed_string.empty()) {
+    FeaturesNeededProto parsed_proto;
+    if (!parsed_proto.ParseFromString(features_needed_string)) {
+      return tensorflow::errors::InvalidArgument(
+          "Failed to parse FeaturesNeeded");
+    }
+
+    FeaturesNeeded parsed_feature_needed;
+    TF_RETURN_IF_ERROR(
+        FromFeaturesNeededProto(parsed_proto, &parsed_feature_needed));
+    if (!parsed_feature_needed.empty()) {
+      *features_needed = parsed_feature_needed;
+    }
+  }
+  return Status::OK();
 }
 
+// Parses an optional serialized DatasetFeatureStatisticsList, which is absent
+// if <statistics_list_string> is empty.
+Status ParseOptionalStatisticsList(
+    const string& statistics_list_string,
+    absl::optional<DatasetFeatureStatisticsList>* statistics_list) {
+  *statistics_list = gtl::nullopt;
+  if (!statistics_list_string.empty()) {
+    DatasetFeatureStatisticsList parsed_list;
+    if (!parsed_list.ParseFromString(statistics_list_string)) {
+      return tensorflow::errors::InvalidArgument(
+          "Failed to parse DatasetFeatureStatisticsList proto.");
+    }
+    *statistics_list = std::move(parsed_list);
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
 FeatureStatisticsToProtoConfig GetDefaultFeatureStatisticsToProtoConfig() {
   FeatureStatisticsToProtoConfig feature_statistics_to_proto_config;
   feature_statistics_to_proto_config.set_enum_threshold(kDefaultEnumThreshold);
@@ -95,6 +293,25 @@ tensorflow::Status UpdateSchema(const string& schema_proto_string,
   return tensorflow::Status::OK();
 }
 
+tensorflow::Status GetSchemaFingerprint(const string& schema_proto_string,
+                                        uint64* fingerprint) {
+  tensorflow::metadata::v0::Schema schema;
+  if (!schema.ParseFromString(schema_proto_string)) {
+    return tensorflow::errors::InvalidArgument("Failed to parse Schema proto.");
+  }
+  *fingerprint = SchemaFingerprint(schema);
+  return tensorflow::Status::OK();
+}
+
+tensorflow::Status MakeValidationSchema(
+    const tensorflow::metadata::v0::Schema& schema_proto,
+    std::shared_ptr<const Schema>* schema) {
+  auto result = std::make_shared<Schema>();
+  TF_RETURN_IF_ERROR(result->Init(schema_proto));
+  *schema = std::move(result);
+  return Status::OK();
+}
+
 tensorflow::Status ValidateFeatureStatistics(
     const tensorflow::metadata::v0::DatasetFeatureStatistics&
         feature_statistics,
@@ -109,63 +326,176 @@ tensorflow::Status ValidateFeatureStatistics(
     const absl::optional<FeaturesNeeded>& features_needed,
     const ValidationConfig& validation_config, bool enable_diff_regions,
     tensorflow::metadata::v0::Anomalies* result) {
-  // TODO(b/113295423): Clean up the optional conversions.
-  const absl::optional<string> maybe_environment =
-      environment ? absl::optional<string>(*environment)
-                  : absl::optional<string>();
-  FeatureStatisticsToProtoConfig feature_statistics_to_proto_config;
-  feature_statistics_to_proto_config.set_enum_threshold(kDefaultEnumThreshold);
-  feature_statistics_to_proto_config.set_new_features_are_warnings(
-      validation_config.new_features_are_warnings());
-  *feature_statistics_to_proto_config.mutable_severity_overrides() =
-      validation_config.severity_overrides();
+  std::shared_ptr<const Schema> schema;
+  TF_RETURN_IF_ERROR(MakeValidationSchema(schema_proto, &schema));
+  return ValidateFeatureStatistics(
+      feature_statistics, schema, environment, prev_span_feature_statistics,
+      serving_feature_statistics, prev_version_feature_statistics,
+      features_needed, validation_config, enable_diff_regions, result);
+}
 
-  const bool by_weight =
-      DatasetStatsView(feature_statistics).WeightedStatisticsExist();
-  if (feature_statistics.num_examples() == 0) {
-    *result->mutable_baseline() = schema_proto;
-    result->set_data_missing(true);
-  } else {
-    SchemaAnomalies schema_anomalies(schema_proto);
-    std::shared_ptr<DatasetStatsView> previous_span =
-        (prev_span_feature_statistics)
-            ? std::make_shared<DatasetStatsView>(
-                  prev_span_feature_statistics.value(), by_weight,
-                  maybe_environment,
-                  /* previous_span= */ nullptr,
-                  /* serving= */ nullptr,
-                  /* previous_version= */ nullptr)
-            : nullptr;
-
-    std::shared_ptr<DatasetStatsView> serving =
-        (serving_feature_statistics) ? std::make_shared<DatasetStatsView>(
-                                           serving_feature_statistics.value(),
-                                           by_weight, maybe_environment,
-                                           /* previous_span= */ nullptr,
-                                           /* serving= */ nullptr,
-                                           /* previous_version= */ nullptr)
-                                     : nullptr;
-
-    std::shared_ptr<DatasetStatsView> previous_version =
-        (prev_version_feature_statistics)
-            ? std::make_shared<DatasetStatsView>(
-                  prev_version_feature_statistics.value(), by_weight,
-                  maybe_environment,
-                  /* previous_span= */ nullptr,
-                  /* serving= */ nullptr,
-                  /* previous_version= */ nullptr)
-            : nullptr;
-
-    const DatasetStatsView training =
-        DatasetStatsView(feature_statistics, by_weight, maybe_environment,
-                         previous_span, serving, previous_version);
-    TF_RETURN_IF_ERROR(
-        schema_anomalies.FindChanges(training, features_needed,
-                                     feature_statistics_to_proto_config));
-    *result = schema_anomalies.GetSchemaDiff(enable_diff_regions);
+tensorflow::Status ValidateFeatureStatistics(
+    const tensorflow::metadata::v0::DatasetFeatureStatistics&
+        feature_statistics,
+    const std::shared_ptr<const Schema>& schema,
+    const absl::optional<string>& environment,
+    const absl::optional<tensorflow::metadata::v0::DatasetFeatureStatistics>&
+        prev_span_feature_statistics,
+    const absl::optional<tensorflow::metadata::v0::DatasetFeatureStatistics>&
+        serving_feature_statistics,
+    const absl::optional<metadata::v0::DatasetFeatureStatistics>&
+        prev_version_feature_statistics,
+    const absl::optional<FeaturesNeeded>& features_needed,
+    const ValidationConfig& validation_config, bool enable_diff_regions,
+    tensorflow::metadata::v0::Anomalies* result) {
+  const auto make_backend =
+      [](const absl::optional<DatasetFeatureStatistics>& statistics)
+      -> std::shared_ptr<const DatasetStatsBackend> {
+    return statistics ? MakeUnownedProtoDatasetStatsBackend(*statistics)
+                      : nullptr;
+  };
+  return ValidateStatsBackends(
+      MakeUnownedProtoDatasetStatsBackend(feature_statistics), schema,
+      environment, make_backend(prev_span_feature_statistics),
+      make_backend(serving_feature_statistics),
+      make_backend(prev_version_feature_statistics), features_needed,
+      MakeValidationFeatureStatisticsToProtoConfig(validation_config),
+      enable_diff_regions, validation_config.baseline_fingerprint_only(),
+      /*num_work_units=*/1, result);
+}
+
+tensorflow::Status ValidateFeatureStatisticsBackends(
+    const std::shared_ptr<const DatasetStatsBackend>& feature_statistics,
+    const tensorflow::metadata::v0::Schema& schema_proto,
+    const absl::optional<string>& environment,
+    const std::shared_ptr<const DatasetStatsBackend>&
+        prev_span_feature_statistics,
+    const std::shared_ptr<const DatasetStatsBackend>&
+        serving_feature_statistics,
+    const std::shared_ptr<const DatasetStatsBackend>&
+        prev_version_feature_statistics,
+    const absl::optional<FeaturesNeeded>& features_needed,
+    const ValidationConfig& validation_config, bool enable_diff_regions,
+    tensorflow::metadata::v0::Anomalies* result) {
+  std::shared_ptr<const Schema> schema;
+  TF_RETURN_IF_ERROR(MakeValidationSchema(schema_proto, &schema));
+  return ValidateStatsBackends(
+      feature_statistics, schema, environment, prev_span_feature_statistics,
+      serving_feature_statistics, prev_version_feature_statistics,
+      features_needed,
+      MakeValidationFeatureStatisticsToProtoConfig(validation_config),
+      enable_diff_regions, validation_config.baseline_fingerprint_only(),
+      /*num_work_units=*/1, result);
+}
+
+tensorflow::Status ValidateShardedFeatureStatistics(
+    const std::vector<DatasetFeatureStatistics>& feature_statistics_shards,
+    const tensorflow::metadata::v0::Schema& schema_proto,
+    const absl::optional<string>& environment,
+    const std::vector<DatasetFeatureStatistics>& prev_span_shards,
+    const std::vector<DatasetFeatureStatistics>& serving_shards,
+    const std::vector<DatasetFeatureStatistics>& prev_version_shards,
+    const absl::optional<FeaturesNeeded>& features_needed,
+    const ValidationConfig& validation_config, bool enable_diff_regions,
+    tensorflow::metadata::v0::Anomalies* result) {
+  if (feature_statistics_shards.empty()) {
+    return errors::InvalidArgument("No statistics shards to validate.");
   }
+  std::shared_ptr<const DatasetStatsBackend> statistics;
+  TF_RETURN_IF_ERROR(
+      MakeShardedBackend(feature_statistics_shards, &statistics));
+  std::shared_ptr<const DatasetStatsBackend> prev_span;
+  TF_RETURN_IF_ERROR(MakeShardedBackend(prev_span_shards, &prev_span));
+  std::shared_ptr<const DatasetStatsBackend> serving;
+  TF_RETURN_IF_ERROR(MakeShardedBackend(serving_shards, &serving));
+  std::shared_ptr<const DatasetStatsBackend> prev_version;
+  TF_RETURN_IF_ERROR(MakeShardedBackend(prev_version_shards, &prev_version));
+  std::shared_ptr<const Schema> schema;
+  TF_RETURN_IF_ERROR(MakeValidationSchema(schema_proto, &schema));
+  return ValidateStatsBackends(
+      statistics, schema, environment, prev_span, serving, prev_version,
+      features_needed,
+      MakeValidationFeatureStatisticsToProtoConfig(validation_config),
+      enable_diff_regions, validation_config.baseline_fingerprint_only(),
+      feature_statistics_shards.size(), result);
+}
 
-  return tensorflow::Status::OK();
+tensorflow::Status ValidateFeatureStatisticsList(
+    const DatasetFeatureStatisticsList& feature_statistics_list,
+    const tensorflow::metadata::v0::Schema& schema_proto,
+    const absl::optional<string>& environment,
+    const absl::optional<DatasetFeatureStatisticsList>& prev_span_list,
+    const absl::optional<DatasetFeatureStatisticsList>& serving_list,
+    const absl::optional<DatasetFeatureStatisticsList>& prev_version_list,
+    const absl::optional<FeaturesNeeded>& features_needed,
+    const ValidationConfig& validation_config, bool enable_diff_regions,
+    std::map<string, tensorflow::metadata::v0::Anomalies>* result) {
+  result->clear();
+  std::map<string, const DatasetFeatureStatistics*> slices;
+  TF_RETURN_IF_ERROR(IndexDatasetsByName(feature_statistics_list, &slices));
+  if (slices.empty()) {
+    return Status::OK();
+  }
+  // The control datasets of each slice, in the order prev_span, serving and
+  // prev_version.
+  std::map<string, const DatasetFeatureStatistics*> control_slices[3];
+  const absl::optional<DatasetFeatureStatisticsList>* control_lists[3] = {
+      &prev_span_list, &serving_list, &prev_version_list};
+  for (int i = 0; i < 3; ++i) {
+    if (*control_lists[i]) {
+      TF_RETURN_IF_ERROR(
+          IndexDatasetsByName(**control_lists[i], &control_slices[i]));
+    }
+  }
+  const auto make_control_backend =
+      [&](int control, const string& name)
+      -> std::shared_ptr<const DatasetStatsBackend> {
+    auto iter = control_slices[control].find(name);
+    return iter == control_slices[control].end()
+               ? nullptr
+               : MakeUnownedProtoDatasetStatsBackend(*iter->second);
+  };
+
+  // The schema and the config are shared by all the slices.
+  std::shared_ptr<const Schema> schema;
+  TF_RETURN_IF_ERROR(MakeValidationSchema(schema_proto, &schema));
+  const FeatureStatisticsToProtoConfig feature_statistics_to_proto_config =
+      MakeValidationFeatureStatisticsToProtoConfig(validation_config);
+  std::vector<std::pair<const string*, const DatasetFeatureStatistics*>>
+      work_units;
+  work_units.reserve(slices.size());
+  for (const auto& slice : slices) {
+    work_units.emplace_back(&slice.first, slice.second);
+  }
+  std::vector<tensorflow::metadata::v0::Anomalies> anomalies(
+      work_units.size());
+  std::vector<Status> statuses(work_units.size());
+  const auto validate_slice = [&](int i) {
+    const string& name = *work_units[i].first;
+    statuses[i] = ValidateStatsBackends(
+        MakeUnownedProtoDatasetStatsBackend(*work_units[i].second), schema,
+        environment, make_control_backend(0, name),
+        make_control_backend(1, name), make_control_backend(2, name),
+        features_needed, feature_statistics_to_proto_config,
+        enable_diff_regions, validation_config.baseline_fingerprint_only(),
+        /*num_work_units=*/1, &anomalies[i]);
+  };
+  const int num_work_units = work_units.size();
+  if (num_work_units == 1) {
+    validate_slice(0);
+  } else {
+    thread::ThreadPool pool(
+        Env::Default(), "validate_feature_statistics_list",
+        std::min(num_work_units, port::MaxParallelism()));
+    for (int i = 0; i < num_work_units; ++i) {
+      pool.Schedule([&validate_slice, i]() { validate_slice(i); });
+    }
+  }
+  for (int i = 0; i < num_work_units; ++i) {
+    TF_RETURN_IF_ERROR(statuses[i]);
+    (*result)[*work_units[i].first] = std::move(anomalies[i]);
+  }
+  return Status::OK();
 }
 
 tensorflow::Status ValidateFeatureStatisticsWithSerializedInputs(
@@ -227,22 +557,75 @@ tensorflow::Status ValidateFeatureStatisticsWithSerializedInputs(
     may_be_environment = environment;
   }
 
-  absl::optional<FeaturesNeeded> features_needed = gtl::nullopt;
-  if (!features_needed_string.empty()) {
-    FeaturesNeededProto parsed_proto;
-    if (!parsed_proto.ParseFromString(features_needed_string)) {
-      return tensorflow::errors::InvalidArgument(
-          "Failed to parse FeaturesNeeded");
-    }
+  absl::optional<FeaturesNeeded> features_needed;
+  TF_RETURN_IF_ERROR(
+      ParseFeaturesNeeded(features_needed_string, &features_needed));
 
-    FeaturesNeeded parsed_feature_needed;
-    TF_RETURN_IF_ERROR(
-        FromFeaturesNeededProto(parsed_proto, &parsed_feature_needed));
-    if (!parsed_feature_needed.empty()) {
-      features_needed = parsed_feature_needed;
+  data_validation::ValidationConfig validation_config;
+  if (!validation_config.ParseFromString(validation_config_string)) {
+    return tensorflow::errors::InvalidArgument(
+        "Failed to parse ValidationConfig");
+  }
+
+  tensorflow::metadata::v0::Anomalies anomalies;
+  TF_RETURN_IF_ERROR(ValidateFeatureStatistics(
+      feature_statistics, schema, may_be_environment, previous_span_statistics,
+      serving_statistics, previous_version_statistics, features_needed,
+      validation_config, enable_diff_regions, &anomalies));
+
+  if (!anomalies.SerializeToString(anomalies_proto_string)) {
+    return tensorflow::errors::Internal(
+        "Could not serialize Anomalies output proto to string.");
+  }
+  return tensorflow::Status::OK();
+}
+
+tensorflow::Status ValidateColumnarFeatureStatisticsWithSerializedInputs(
+    const string& feature_statistics_path, const string& schema_proto_string,
+    const string& environment, const string& previous_span_statistics_path,
+    const string& serving_statistics_path,
+    const string& previous_version_statistics_path,
+    const string& features_needed_string,
+    const string& validation_config_string, const bool enable_diff_regions,
+    string* anomalies_proto_string) {
+  tensorflow::metadata::v0::Schema schema;
+  if (!schema.ParseFromString(schema_proto_string)) {
+    return tensorflow::errors::InvalidArgument("Failed to parse Schema proto.");
+  }
+
+  if (feature_statistics_path.empty()) {
+    return tensorflow::errors::InvalidArgument("No statistics path given.");
+  }
+  const auto open_backend =
+      [](const string& path,
+         std::shared_ptr<const DatasetStatsBackend>* backend) -> Status {
+    *backend = nullptr;
+    if (path.empty()) {
+      return Status::OK();
     }
+    return OpenDefaultColumnarDatasetStatsBackend(path, kDefaultSliceKey,
+                                                  backend);
+  };
+  std::shared_ptr<const DatasetStatsBackend> feature_statistics;
+  TF_RETURN_IF_ERROR(open_backend(feature_statistics_path, &feature_statistics));
+  std::shared_ptr<const DatasetStatsBackend> previous_span_statistics;
+  TF_RETURN_IF_ERROR(
+      open_backend(previous_span_statistics_path, &previous_span_statistics));
+  std::shared_ptr<const DatasetStatsBackend> serving_statistics;
+  TF_RETURN_IF_ERROR(open_backend(serving_statistics_path, &serving_statistics));
+  std::shared_ptr<const DatasetStatsBackend> previous_version_statistics;
+  TF_RETURN_IF_ERROR(open_backend(previous_version_statistics_path,
+                                  &previous_version_statistics));
+
+  absl::optional<string> may_be_environment;
+  if (!environment.empty()) {
+    may_be_environment = environment;
   }
 
+  absl::optional<FeaturesNeeded> features_needed;
+  TF_RETURN_IF_ERROR(
+      ParseFeaturesNeeded(features_needed_string, &features_needed));
+
   data_validation::ValidationConfig validation_config;
   if (!validation_config.ParseFromString(validation_config_string)) {
     return tensorflow::errors::InvalidArgument(
@@ -250,7 +633,7 @@ tensorflow::Status ValidateFeatureStatisticsWithSerializedInputs(
   }
 
   tensorflow::metadata::v0::Anomalies anomalies;
-  TF_RETURN_IF_ERROR(ValidateFeatureStatistics(
+  TF_RETURN_IF_ERROR(ValidateFeatureStatisticsBackends(
       feature_statistics, schema, may_be_environment, previous_span_statistics,
       serving_statistics, previous_version_statistics, features_needed,
       validation_config, enable_diff_regions, &anomalies));
@@ -262,6 +645,72 @@ tensorflow::Status ValidateFeatureStatisticsWithSerializedInputs(
   return tensorflow::Status::OK();
 }
 
+tensorflow::Status ValidateFeatureStatisticsListWithSerializedInputs(
+    const string& feature_statistics_list_proto_string,
+    const string& schema_proto_string, const string& environment,
+    const string& previous_span_statistics_list_proto_string,
+    const string& serving_statistics_list_proto_string,
+    const string& previous_version_statistics_list_proto_string,
+    const string& features_needed_string,
+    const string& validation_config_string, const bool enable_diff_regions,
+    std::map<string, string>* anomalies_proto_strings) {
+  tensorflow::metadata::v0::Schema schema;
+  if (!schema.ParseFromString(schema_proto_string)) {
+    return tensorflow::errors::InvalidArgument("Failed to parse Schema proto.");
+  }
+
+  DatasetFeatureStatisticsList feature_statistics_list;
+  if (!feature_statistics_list.ParseFromString(
+          feature_statistics_list_proto_string)) {
+    return tensorflow::errors::InvalidArgument(
+        "Failed to parse DatasetFeatureStatisticsList proto.");
+  }
+  absl::optional<DatasetFeatureStatisticsList> previous_span_statistics_list;
+  TF_RETURN_IF_ERROR(
+      ParseOptionalStatisticsList(previous_span_statistics_list_proto_string,
+                                  &previous_span_statistics_list));
+  absl::optional<DatasetFeatureStatisticsList> serving_statistics_list;
+  TF_RETURN_IF_ERROR(ParseOptionalStatisticsList(
+      serving_statistics_list_proto_string, &serving_statistics_list));
+  absl::optional<DatasetFeatureStatisticsList>
+      previous_version_statistics_list;
+  TF_RETURN_IF_ERROR(ParseOptionalStatisticsList(
+      previous_version_statistics_list_proto_string,
+      &previous_version_statistics_list));
+
+  absl::optional<string> may_be_environment = gtl::nullopt;
+  if (!environment.empty()) {
+    may_be_environment = environment;
+  }
+
+  absl::optional<FeaturesNeeded> features_needed;
+  TF_RETURN_IF_ERROR(
+      ParseFeaturesNeeded(features_needed_string, &features_needed));
+
+  data_validation::ValidationConfig validation_config;
+  if (!validation_config.ParseFromString(validation_config_string)) {
+    return tensorflow::errors::InvalidArgument(
+        "Failed to parse ValidationConfig");
+  }
+
+  std::map<string, tensorflow::metadata::v0::Anomalies> anomalies;
+  TF_RETURN_IF_ERROR(ValidateFeatureStatisticsList(
+      feature_statistics_list, schema, may_be_environment,
+      previous_span_statistics_list, serving_statistics_list,
+      previous_version_statistics_list, features_needed, validation_config,
+      enable_diff_regions, &anomalies));
+
+  anomalies_proto_strings->clear();
+  for (const auto& slice_anomalies : anomalies) {
+    if (!slice_anomalies.second.SerializeToString(
+            &(*anomalies_proto_strings)[slice_anomalies.first])) {
+      return tensorflow::errors::Internal(
+          "Could not serialize Anomalies output proto to string.");
+    }
+  }
+  return tensorflow::Status::OK();
+}
+
 tensorflow::Status UpdateSchema(
     const FeatureStatisticsToProtoConfig& feature_statistics_to_proto_config,
     const tensorflow::metadata::v0::Schema& schema_to_update,
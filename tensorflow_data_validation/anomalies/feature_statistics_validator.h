@@ -19,6 +19,8 @@ limitations under the License.
 #ifndef TENSORFLOW_DATA_VALIDATION_ANOMALIES_FEATURE_STATISTICS_VALIDATOR_H_
 #define TENSORFLOW_DATA_VALIDATION_ANOMALIES_FEATURE_STATISTICS_VALIDATOR_H_
 
+#include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -28,6 +30,8 @@ limitations under the License.
 #include "tensorflow_data_validation/anomalies/path.h"
 #include "tensorflow_data_validation/anomalies/proto/feature_statistics_to_proto.pb.h"
 #include "tensorflow_data_validation/anomalies/proto/validation_config.pb.h"
+#include "tensorflow_data_validation/anomalies/schema.h"
+#include "tensorflow_data_validation/anomalies/statistics_view.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/gtl/optional.h"
 #include "tensorflow/core/platform/types.h"
@@ -38,6 +42,12 @@ limitations under the License.
 namespace tensorflow {
 namespace data_validation {
 
+// Name of the default slice containing all examples, which is validated when
+// statistics have several datasets.
+// LINT.IfChange
+constexpr char kDefaultSliceKey[] = "All Examples";
+// LINT.ThenChange(../constants.py)
+
 // Gets the default FeatureStatisticsToProtoConfig.
 FeatureStatisticsToProtoConfig GetDefaultFeatureStatisticsToProtoConfig();
 
@@ -62,6 +72,13 @@ Status UpdateSchema(const string& schema_proto_string,
                     const int max_string_domain_size,
                     string* output_schema_proto_string);
 
+// Computes the fingerprint of the serialized schema, as SchemaFingerprint.
+// This is the fingerprint referenced by the baseline of the anomalies when
+// ValidationConfig.baseline_fingerprint_only is set. This method is called by
+// the Python code using PyBind11.
+Status GetSchemaFingerprint(const string& schema_proto_string,
+                            uint64* fingerprint);
+
 // Validates the statistics in <feature_statistics> with respect to the
 // <schema_proto> and returns a schema diff proto which captures the
 // changes that need to be made to <schema_proto> to make the statistics
@@ -90,6 +107,88 @@ Status ValidateFeatureStatistics(
     const ValidationConfig& validation_config, bool enable_diff_regions,
     metadata::v0::Anomalies* result);
 
+// Initializes <schema_proto> once, to validate any number of statistics
+// against it with the overload of ValidateFeatureStatistics below.
+Status MakeValidationSchema(const metadata::v0::Schema& schema_proto,
+                            std::shared_ptr<const Schema>* schema);
+
+// Same as ValidateFeatureStatistics, against a schema initialized by
+// MakeValidationSchema, which is only read and may be shared by concurrent
+// validations.
+Status ValidateFeatureStatistics(
+    const metadata::v0::DatasetFeatureStatistics& feature_statistics,
+    const std::shared_ptr<const Schema>& schema,
+    const absl::optional<string>& environment,
+    const absl::optional<metadata::v0::DatasetFeatureStatistics>&
+        prev_span_feature_statistics,
+    const absl::optional<metadata::v0::DatasetFeatureStatistics>&
+        serving_feature_statistics,
+    const absl::optional<metadata::v0::DatasetFeatureStatistics>&
+        prev_version_feature_statistics,
+    const absl::optional<FeaturesNeeded>& features_needed,
+    const ValidationConfig& validation_config, bool enable_diff_regions,
+    metadata::v0::Anomalies* result);
+
+// Same as ValidateFeatureStatistics, for statistics provided by backends (see
+// statistics_view.h), e.g. over columnar statistics files. The control
+// statistics are null if absent. Returns the error of a backend which failed
+// to decode statistics during the validation.
+Status ValidateFeatureStatisticsBackends(
+    const std::shared_ptr<const DatasetStatsBackend>& feature_statistics,
+    const metadata::v0::Schema& schema_proto,
+    const absl::optional<string>& environment,
+    const std::shared_ptr<const DatasetStatsBackend>&
+        prev_span_feature_statistics,
+    const std::shared_ptr<const DatasetStatsBackend>&
+        serving_feature_statistics,
+    const std::shared_ptr<const DatasetStatsBackend>&
+        prev_version_feature_statistics,
+    const absl::optional<FeaturesNeeded>& features_needed,
+    const ValidationConfig& validation_config, bool enable_diff_regions,
+    metadata::v0::Anomalies* result);
+
+// Same as ValidateFeatureStatistics, for statistics split into shards (e.g.
+// because they exceed the maximum size of a proto). Each shard holds the
+// statistics of a disjoint set of features of the same dataset, and all the
+// shards have the same num_examples. A struct feature and its children may be
+// in different shards. The statistics of the previous span, serving data and
+// previous version are also given as shards, which are empty if not
+// available. The features are validated in parallel, and dataset-level
+// constraints are checked once.
+Status ValidateShardedFeatureStatistics(
+    const std::vector<metadata::v0::DatasetFeatureStatistics>&
+        feature_statistics_shards,
+    const metadata::v0::Schema& schema_proto,
+    const absl::optional<string>& environment,
+    const std::vector<metadata::v0::DatasetFeatureStatistics>&
+        prev_span_shards,
+    const std::vector<metadata::v0::DatasetFeatureStatistics>& serving_shards,
+    const std::vector<metadata::v0::DatasetFeatureStatistics>&
+        prev_version_shards,
+    const absl::optional<FeaturesNeeded>& features_needed,
+    const ValidationConfig& validation_config, bool enable_diff_regions,
+    metadata::v0::Anomalies* result);
+
+// Validates each dataset (i.e. slice) of <feature_statistics_list> as
+// ValidateFeatureStatistics, and returns its anomalies in *result keyed by the
+// dataset name. The previous span, serving and previous version statistics of
+// a slice are the datasets with the same name in the corresponding lists, if
+// any. Dataset names must be unique within each list. The slices are
+// validated in parallel, sharing <schema_proto> and the validation config.
+Status ValidateFeatureStatisticsList(
+    const metadata::v0::DatasetFeatureStatisticsList& feature_statistics_list,
+    const metadata::v0::Schema& schema_proto,
+    const absl::optional<string>& environment,
+    const absl::optional<metadata::v0::DatasetFeatureStatisticsList>&
+        prev_span_feature_statistics_list,
+    const absl::optional<metadata::v0::DatasetFeatureStatisticsList>&
+        serving_feature_statistics_list,
+    const absl::optional<metadata::v0::DatasetFeatureStatisticsList>&
+        prev_version_feature_statistics_list,
+    const absl::optional<FeaturesNeeded>& features_needed,
+    const ValidationConfig& validation_config, bool enable_diff_regions,
+    std::map<string, metadata::v0::Anomalies>* result);
+
 // Similar to the above, but takes all the proto parameters as serialized
 // strings. This method is called by the Python code using PyBind11.
 Status ValidateFeatureStatisticsWithSerializedInputs(
@@ -102,6 +201,35 @@ Status ValidateFeatureStatisticsWithSerializedInputs(
     const string& validation_config_string, const bool enable_diff_regions,
     string* anomalies_proto_string);
 
+// Same as ValidateFeatureStatisticsWithSerializedInputs, for statistics in
+// columnar statistics files (see columnar_statistics.h), which are
+// memory-mapped: only the statistics of the features that the validation
+// reads are decoded. The paths of absent control statistics are empty. The
+// dataset validated in each file is its only dataset, or the default slice.
+// This method is called by the Python code using PyBind11.
+Status ValidateColumnarFeatureStatisticsWithSerializedInputs(
+    const string& feature_statistics_path, const string& schema_proto_string,
+    const string& environment, const string& previous_span_statistics_path,
+    const string& serving_statistics_path,
+    const string& previous_version_statistics_path,
+    const string& features_needed_string,
+    const string& validation_config_string, const bool enable_diff_regions,
+    string* anomalies_proto_string);
+
+// Same as ValidateFeatureStatisticsList, but takes all the proto parameters as
+// serialized strings (an empty statistics list string means the list is
+// absent), and returns the serialized Anomalies of each slice. This method is
+// called by the Python code using PyBind11.
+Status ValidateFeatureStatisticsListWithSerializedInputs(
+    const string& feature_statistics_list_proto_string,
+    const string& schema_proto_string, const string& environment,
+    const string& previous_span_statistics_list_proto_string,
+    const string& serving_statistics_list_proto_string,
+    const string& previous_version_statistics_list_proto_string,
+    const string& features_needed_string,
+    const string& validation_config_string, const bool enable_diff_regions,
+    std::map<string, string>* anomalies_proto_strings);
+
 // Updates an existing schema to match the data characteristics in
 // <feature_statistics>, but only on the paths_to_consider.
 // An empty schema_to_update is a valid input schema.
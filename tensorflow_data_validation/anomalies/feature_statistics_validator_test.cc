@@ -15,14 +15,19 @@ limitations under the License.
 
 #include "tensorflow_data_validation/anomalies/feature_statistics_validator.h"
 
+#include <algorithm>
 #include <map>
 #include <string>
+#include <vector>
 
 #include <gtest/gtest.h>
 #include "absl/types/optional.h"
+#include "tensorflow_data_validation/anomalies/columnar_statistics.h"
 #include "tensorflow_data_validation/anomalies/proto/validation_config.pb.h"
+#include "tensorflow_data_validation/anomalies/schema_util.h"
 #include "tensorflow_data_validation/anomalies/test_util.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow_metadata/proto/v0/anomalies.pb.h"
 #include "tensorflow_metadata/proto/v0/schema.pb.h"
@@ -34,6 +39,7 @@ namespace {
 
 using ::tensorflow::metadata::v0::AnomalyInfo;
 using ::tensorflow::metadata::v0::DatasetFeatureStatistics;
+using ::tensorflow::metadata::v0::DatasetFeatureStatisticsList;
 using ::tensorflow::metadata::v0::Schema;
 using testing::EqualsProto;
 using testing::ParseTextProtoOrDie;
@@ -838,6 +844,361 @@ TEST(FeatureStatisticsValidatorTest,
       /*expected_anomalies=*/{}, dataset_anomalies);
 }
 
+TEST(FeatureStatisticsValidatorTest, ShardedStatistics) {
+  const Schema schema = ParseTextProtoOrDie<Schema>(R"(
+    string_domain { name: "MyEnum" value: "A" value: "B" }
+    feature {
+      name: "enum"
+      presence: { min_count: 1 }
+      type: BYTES
+      domain: "MyEnum"
+    }
+    feature { name: "missing_column" type: BYTES }
+    feature {
+      name: "struct"
+      type: STRUCT
+      struct_domain {
+        feature {
+          name: "child"
+          type: INT
+          value_count: { min: 2 }
+        }
+      }
+    }
+    dataset_constraints { min_examples_count: 100 })");
+  const DatasetFeatureStatistics statistics =
+      ParseTextProtoOrDie<DatasetFeatureStatistics>(R"(
+        num_examples: 10
+        features: {
+          path { step: "enum" }
+          type: STRING
+          string_stats: {
+            common_stats: { num_non_missing: 10 max_num_values: 1 }
+            unique: 3
+            rank_histogram: { buckets: { label: "C" sample_count: 1 } }
+          }
+        }
+        features: {
+          path { step: "struct" }
+          type: STRUCT
+          struct_stats: {
+            common_stats: { num_non_missing: 10 max_num_values: 1 }
+          }
+        }
+        features: {
+          path { step: "struct" step: "child" }
+          type: INT
+          num_stats: {
+            common_stats: {
+              num_non_missing: 10
+              min_num_values: 1
+              max_num_values: 1
+            }
+          }
+        }
+        features: {
+          path { step: "new_feature" }
+          type: FLOAT
+          num_stats: { common_stats: { num_non_missing: 10 } }
+        })");
+  // The struct is in the first shard and its child in the second one.
+  std::vector<DatasetFeatureStatistics> shards(3);
+  for (int i = 0; i < statistics.features_size(); ++i) {
+    DatasetFeatureStatistics& shard = shards[std::min(i, 2)];
+    shard.set_num_examples(statistics.num_examples());
+    *shard.add_features() = statistics.features(i);
+  }
+  std::swap(shards[0], shards[1]);
+
+  tensorflow::metadata::v0::Anomalies expected;
+  TF_ASSERT_OK(ValidateFeatureStatistics(
+      statistics, schema, /*environment=*/gtl::nullopt,
+      /*prev_span_feature_statistics=*/gtl::nullopt,
+      /*serving_feature_statistics=*/gtl::nullopt,
+      /*prev_version_feature_statistics=*/gtl::nullopt,
+      /*features_needed=*/gtl::nullopt, ValidationConfig(),
+      /*enable_diff_regions=*/false, &expected));
+  ASSERT_EQ(expected.anomaly_info().size(), 3);
+  ASSERT_TRUE(expected.has_dataset_anomaly_info());
+
+  tensorflow::metadata::v0::Anomalies result;
+  TF_ASSERT_OK(ValidateShardedFeatureStatistics(
+      shards, schema, /*environment=*/gtl::nullopt,
+      /*prev_span_shards=*/{}, /*serving_shards=*/{},
+      /*prev_version_shards=*/{}, /*features_needed=*/gtl::nullopt,
+      ValidationConfig(), /*enable_diff_regions=*/false, &result));
+  // anomaly_info is a map, so compare the (sorted) text formats.
+  EXPECT_EQ(result.DebugString(), expected.DebugString());
+
+  shards[2].set_num_examples(11);
+  EXPECT_FALSE(ValidateShardedFeatureStatistics(
+                   shards, schema, /*environment=*/gtl::nullopt,
+                   /*prev_span_shards=*/{}, /*serving_shards=*/{},
+                   /*prev_version_shards=*/{},
+                   /*features_needed=*/gtl::nullopt, ValidationConfig(),
+                   /*enable_diff_regions=*/false, &result)
+                   .ok());
+}
+
+TEST(FeatureStatisticsValidatorTest, StatisticsList) {
+  const Schema schema = ParseTextProtoOrDie<Schema>(R"(
+    string_domain { name: "MyEnum" value: "A" value: "B" }
+    feature {
+      name: "enum"
+      presence: { min_count: 1 }
+      type: BYTES
+      domain: "MyEnum"
+      skew_comparator { infinity_norm: { threshold: 0.1 } }
+    }
+    feature { name: "missing_column" type: BYTES })");
+  const DatasetFeatureStatisticsList statistics_list =
+      ParseTextProtoOrDie<DatasetFeatureStatisticsList>(R"(
+        datasets {
+          name: "All Examples"
+          num_examples: 10
+          features: {
+            path { step: "enum" }
+            type: STRING
+            string_stats: {
+              common_stats: { num_non_missing: 10 max_num_values: 1 }
+              unique: 1
+              rank_histogram: { buckets: { label: "A" sample_count: 10 } }
+            }
+          }
+        }
+        datasets {
+          name: "slice"
+          num_examples: 4
+          features: {
+            path { step: "enum" }
+            type: STRING
+            string_stats: {
+              common_stats: { num_non_missing: 4 max_num_values: 1 }
+              unique: 2
+              rank_histogram: {
+                buckets: { label: "A" sample_count: 3 }
+                buckets: { label: "C" sample_count: 1 }
+              }
+            }
+          }
+        }
+        datasets { name: "empty_slice" })");
+  // Only the default slice has serving statistics.
+  const DatasetFeatureStatisticsList serving_list =
+      ParseTextProtoOrDie<DatasetFeatureStatisticsList>(R"(
+        datasets {
+          name: "All Examples"
+          num_examples: 10
+          features: {
+            path { step: "enum" }
+            type: STRING
+            string_stats: {
+              common_stats: { num_non_missing: 10 max_num_values: 1 }
+              unique: 1
+              rank_histogram: { buckets: { label: "B" sample_count: 10 } }
+            }
+          }
+        })");
+
+  std::map<string, tensorflow::metadata::v0::Anomalies> result;
+  TF_ASSERT_OK(ValidateFeatureStatisticsList(
+      statistics_list, schema, /*environment=*/gtl::nullopt,
+      /*prev_span_feature_statistics_list=*/gtl::nullopt, serving_list,
+      /*prev_version_feature_statistics_list=*/gtl::nullopt,
+      /*features_needed=*/gtl::nullopt, ValidationConfig(),
+      /*enable_diff_regions=*/false, &result));
+  ASSERT_EQ(result.size(), 3);
+  for (const DatasetFeatureStatistics& slice : statistics_list.datasets()) {
+    absl::optional<DatasetFeatureStatistics> serving;
+    if (slice.name() == serving_list.datasets(0).name()) {
+      serving = serving_list.datasets(0);
+    }
+    tensorflow::metadata::v0::Anomalies expected;
+    TF_ASSERT_OK(ValidateFeatureStatistics(
+        slice, schema, /*environment=*/gtl::nullopt,
+        /*prev_span_feature_statistics=*/gtl::nullopt, serving,
+        /*prev_version_feature_statistics=*/gtl::nullopt,
+        /*features_needed=*/gtl::nullopt, ValidationConfig(),
+        /*enable_diff_regions=*/false, &expected));
+    // anomaly_info is a map, so compare the (sorted) text formats.
+    EXPECT_EQ(result.at(slice.name()).DebugString(), expected.DebugString())
+        << slice.name();
+  }
+  EXPECT_TRUE(result.at("All Examples").anomaly_info().contains("enum"));
+  EXPECT_TRUE(result.at("slice").anomaly_info().contains("enum"));
+  EXPECT_TRUE(result.at("empty_slice").data_missing());
+
+  std::map<string, string> serialized_result;
+  TF_ASSERT_OK(ValidateFeatureStatisticsListWithSerializedInputs(
+      statistics_list.SerializeAsString(), schema.SerializeAsString(),
+      /*environment=*/"",
+      /*previous_span_statistics_list_proto_string=*/"",
+      serving_list.SerializeAsString(),
+      /*previous_version_statistics_list_proto_string=*/"",
+      /*features_needed_string=*/"", ValidationConfig().SerializeAsString(),
+      /*enable_diff_regions=*/false, &serialized_result));
+  ASSERT_EQ(serialized_result.size(), 3);
+  for (const auto& slice_anomalies : result) {
+    tensorflow::metadata::v0::Anomalies parsed;
+    ASSERT_TRUE(
+        parsed.ParseFromString(serialized_result.at(slice_anomalies.first)));
+    EXPECT_EQ(parsed.DebugString(), slice_anomalies.second.DebugString());
+  }
+
+  DatasetFeatureStatisticsList duplicate_list = statistics_list;
+  *duplicate_list.add_datasets() = statistics_list.datasets(1);
+  EXPECT_FALSE(ValidateFeatureStatisticsList(
+                   duplicate_list, schema, /*environment=*/gtl::nullopt,
+                   /*prev_span_feature_statistics_list=*/gtl::nullopt,
+                   /*serving_feature_statistics_list=*/gtl::nullopt,
+                   /*prev_version_feature_statistics_list=*/gtl::nullopt,
+                   /*features_needed=*/gtl::nullopt, ValidationConfig(),
+                   /*enable_diff_regions=*/false, &result)
+                   .ok());
+}
+
+TEST(FeatureStatisticsValidatorTest, ColumnarStatistics) {
+  const Schema schema = ParseTextProtoOrDie<Schema>(R"(
+    string_domain { name: "MyEnum" value: "A" }
+    feature {
+      name: "enum"
+      presence: { min_count: 1 }
+      type: BYTES
+      domain: "MyEnum"
+      skew_comparator { infinity_norm: { threshold: 0.1 } }
+    })");
+  const DatasetFeatureStatisticsList statistics_list =
+      ParseTextProtoOrDie<DatasetFeatureStatisticsList>(R"(
+        datasets {
+          name: "slice"
+          num_examples: 4
+        }
+        datasets {
+          name: "All Examples"
+          num_examples: 10
+          features: {
+            path { step: "enum" }
+            type: STRING
+            string_stats: {
+              common_stats: { num_non_missing: 10 max_num_values: 1 }
+              unique: 2
+              rank_histogram: {
+                buckets: { label: "A" sample_count: 9 }
+                buckets: { label: "C" sample_count: 1 }
+              }
+            }
+          }
+        })");
+  DatasetFeatureStatisticsList serving_list;
+  *serving_list.add_datasets() = statistics_list.datasets(1);
+  serving_list.mutable_datasets(0)
+      ->mutable_features(0)
+      ->mutable_string_stats()
+      ->mutable_rank_histogram()
+      ->mutable_buckets(1)
+      ->set_sample_count(5);
+
+  const string statistics_path =
+      ::testing::TempDir() + "/validator_statistics.columnar";
+  const string serving_path =
+      ::testing::TempDir() + "/validator_serving.columnar";
+  string columnar;
+  TF_ASSERT_OK(WriteColumnarStatistics(statistics_list, &columnar));
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), statistics_path, columnar));
+  TF_ASSERT_OK(WriteColumnarStatistics(serving_list, &columnar));
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(), serving_path, columnar));
+
+  tensorflow::metadata::v0::Anomalies expected;
+  TF_ASSERT_OK(ValidateFeatureStatistics(
+      statistics_list.datasets(1), schema, /*environment=*/gtl::nullopt,
+      /*prev_span_feature_statistics=*/gtl::nullopt, serving_list.datasets(0),
+      /*prev_version_feature_statistics=*/gtl::nullopt,
+      /*features_needed=*/gtl::nullopt, ValidationConfig(),
+      /*enable_diff_regions=*/false, &expected));
+  EXPECT_TRUE(expected.anomaly_info().contains("enum"));
+
+  string serialized_result;
+  TF_ASSERT_OK(ValidateColumnarFeatureStatisticsWithSerializedInputs(
+      statistics_path, schema.SerializeAsString(), /*environment=*/"",
+      /*previous_span_statistics_path=*/"", serving_path,
+      /*previous_version_statistics_path=*/"", /*features_needed_string=*/"",
+      ValidationConfig().SerializeAsString(), /*enable_diff_regions=*/false,
+      &serialized_result));
+  tensorflow::metadata::v0::Anomalies result;
+  ASSERT_TRUE(result.ParseFromString(serialized_result));
+  // anomaly_info is a map, so compare the (sorted) text formats.
+  EXPECT_EQ(result.DebugString(), expected.DebugString());
+
+  EXPECT_FALSE(ValidateColumnarFeatureStatisticsWithSerializedInputs(
+                   ::testing::TempDir() + "/validator_missing.columnar",
+                   schema.SerializeAsString(), /*environment=*/"",
+                   /*previous_span_statistics_path=*/"",
+                   /*serving_statistics_path=*/"",
+                   /*previous_version_statistics_path=*/"",
+                   /*features_needed_string=*/"",
+                   ValidationConfig().SerializeAsString(),
+                   /*enable_diff_regions=*/false, &serialized_result)
+                   .ok());
+}
+
+TEST(FeatureStatisticsValidatorTest, BaselineFingerprintOnly) {
+  const Schema schema = ParseTextProtoOrDie<Schema>(R"(
+    string_domain { name: "MyEnum" value: "A" value: "B" }
+    feature {
+      name: "enum"
+      presence: { min_count: 1 }
+      type: BYTES
+      domain: "MyEnum"
+    })");
+  const DatasetFeatureStatistics statistics =
+      ParseTextProtoOrDie<DatasetFeatureStatistics>(R"(
+        num_examples: 10
+        features: {
+          path { step: "enum" }
+          type: STRING
+          string_stats: {
+            common_stats: { num_non_missing: 10 max_num_values: 1 }
+            unique: 1
+            rank_histogram: { buckets: { label: "C" sample_count: 10 } }
+          }
+        })");
+  ValidationConfig validation_config;
+  validation_config.set_baseline_fingerprint_only(true);
+
+  for (const int64 num_examples : {10, 0}) {
+    DatasetFeatureStatistics current_statistics = statistics;
+    current_statistics.set_num_examples(num_examples);
+    tensorflow::metadata::v0::Anomalies expected;
+    TF_ASSERT_OK(ValidateFeatureStatistics(
+        current_statistics, schema, /*environment=*/gtl::nullopt,
+        /*prev_span_feature_statistics=*/gtl::nullopt,
+        /*serving_feature_statistics=*/gtl::nullopt,
+        /*prev_version_feature_statistics=*/gtl::nullopt,
+        /*features_needed=*/gtl::nullopt, ValidationConfig(),
+        /*enable_diff_regions=*/false, &expected));
+    tensorflow::metadata::v0::Anomalies result;
+    TF_ASSERT_OK(ValidateFeatureStatistics(
+        current_statistics, schema, /*environment=*/gtl::nullopt,
+        /*prev_span_feature_statistics=*/gtl::nullopt,
+        /*serving_feature_statistics=*/gtl::nullopt,
+        /*prev_version_feature_statistics=*/gtl::nullopt,
+        /*features_needed=*/gtl::nullopt, validation_config,
+        /*enable_diff_regions=*/false, &result));
+
+    uint64 fingerprint = 0;
+    ASSERT_TRUE(GetBaselineFingerprint(result.baseline(), &fingerprint));
+    EXPECT_EQ(fingerprint, SchemaFingerprint(schema));
+    uint64 serialized_fingerprint = 0;
+    TF_ASSERT_OK(GetSchemaFingerprint(schema.SerializeAsString(),
+                                      &serialized_fingerprint));
+    EXPECT_EQ(serialized_fingerprint, fingerprint);
+    // Only the baseline differs.
+    result.clear_baseline();
+    expected.clear_baseline();
+    EXPECT_EQ(result.DebugString(), expected.DebugString());
+  }
+}
+
 TEST(FeatureStatisticsValidatorUpdateSchema, TestLargeStringDomain) {
   DatasetFeatureStatistics statistics =
       ParseTextProtoOrDie<DatasetFeatureStatistics>(R"(
@@ -0,0 +1,73 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/internal_types.h"
+
+#include <math.h>
+
+#include "absl/strings/escaping.h"
+#include "absl/strings/str_cat.h"
+
+namespace tensorflow {
+namespace data_validation {
+namespace {
+
+// Appends <count>/<total> as a percentage. If the ratio is less than 1% then
+// "<1%" is appended, otherwise "~x%" where x is the floor of the ratio.
+// If total is zero, appends "?".
+void AppendPercentage(double count, double total, string* result) {
+  if (total == 0.0) {
+    result->append("?");
+    return;
+  }
+  const double percent = 100 * count / total;
+  if (percent < 1.0) {
+    result->append("<1%");
+  } else {
+    absl::StrAppend(result, "~", static_cast<int>(floor(percent)), "%");
+  }
+}
+
+}  // namespace
+
+string RenderLongDescription(const Description& description,
+                             int max_values) {
+  const DescriptionDetails& details = description.details;
+  if (details.empty()) {
+    return description.long_description;
+  }
+  string result = description.long_description;
+  const int num_values = details.values.size();
+  for (int i = 0; i < num_values && i < max_values; ++i) {
+    const std::pair<string, double>& value_and_count = details.values[i];
+    if (i > 0) {
+      result.append(", ");
+    }
+    absl::StrAppend(&result, absl::Utf8SafeCEscape(value_and_count.first),
+                    " (");
+    // Counts are truncated, as they always were in these descriptions.
+    AppendPercentage(static_cast<int64>(value_and_count.second),
+                     details.value_total, &result);
+    result.push_back(')');
+  }
+  if (num_values > max_values) {
+    absl::StrAppend(&result, " and ", num_values - max_values, " more");
+  }
+  result.append(details.suffix);
+  return result;
+}
+
+}  // namespace data_validation
+}  // namespace tensorflow
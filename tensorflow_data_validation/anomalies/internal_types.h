@@ -16,7 +16,9 @@ limitations under the License.
 #ifndef TENSORFLOW_DATA_VALIDATION_ANOMALIES_INTERNAL_TYPES_H_
 #define TENSORFLOW_DATA_VALIDATION_ANOMALIES_INTERNAL_TYPES_H_
 
+#include <ostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "tensorflow/core/platform/types.h"
@@ -25,19 +27,60 @@ limitations under the License.
 namespace tensorflow {
 namespace data_validation {
 
+// The maximum number of DescriptionDetails::values rendered in a long
+// description.
+constexpr int kMaxDescriptionValues = 100;
+
+// Details of an anomaly that are expensive to format, e.g. all the values of a
+// feature missing from its domain. They are kept structured, and only
+// rendered into the long description when the anomalies are reported (see
+// RenderLongDescription()), so that anomalies that are filtered or only
+// counted cost no formatting.
+struct DescriptionDetails {
+  // Values with their (weighted) counts. Rendered C-escaped, with their counts
+  // as a percentage of value_total, and separated by commas.
+  std::vector<std::pair<string, double>> values;
+  double value_total = 0;
+  // Rendered last.
+  string suffix;
+
+  bool empty() const {
+    return values.empty() && suffix.empty();
+  }
+};
+
+struct Description;
+
+// Returns the long description of <description> followed by its rendered
+// details. At most <max_values> of the values are listed.
+string RenderLongDescription(const Description& description,
+                             int max_values = kMaxDescriptionValues);
+
 // Represents the description of an anomaly, in short and long form.
 struct Description {
+  // Not explicit, so that descriptions can be written {type, short, long}.
+  Description(tensorflow::metadata::v0::AnomalyInfo::Type type,
+              string short_description, string long_description = "",
+              DescriptionDetails details = DescriptionDetails())
+      : type(type),
+        short_description(std::move(short_description)),
+        long_description(std::move(long_description)),
+        details(std::move(details)) {}
+
   tensorflow::metadata::v0::AnomalyInfo::Type type;
+  // The long description is long_description followed by the rendering of
+  // details.
   string short_description, long_description;
+  DescriptionDetails details;
 
   friend bool operator==(const Description& a, const Description& b) {
     return (a.type == b.type && a.short_description == b.short_description &&
-            a.long_description == b.long_description);
+            RenderLongDescription(a) == RenderLongDescription(b));
   }
 
   friend std::ostream& operator<<(std::ostream& strm, const Description& a) {
     return (strm << "{" << a.type << ", " << a.short_description << ", " <<
-            a.long_description << "}");
+            RenderLongDescription(a) << "}");
   }
 };
 
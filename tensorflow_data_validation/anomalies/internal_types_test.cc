@@ -0,0 +1,60 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/internal_types.h"
+
+#include <gtest/gtest.h>
+#include "tensorflow_metadata/proto/v0/anomalies.pb.h"
+
+namespace tensorflow {
+namespace data_validation {
+namespace {
+
+TEST(DescriptionTest, RenderWithoutDetails) {
+  const Description description = {
+      tensorflow::metadata::v0::AnomalyInfo::UNKNOWN_TYPE, "short", "long"};
+  EXPECT_EQ(RenderLongDescription(description), "long");
+}
+
+TEST(DescriptionTest, RenderValues) {
+  Description description = {
+      tensorflow::metadata::v0::AnomalyInfo::UNKNOWN_TYPE, "short",
+      "Values: "};
+  description.details.values = {{"a", 3}, {"b\n", 0.5}, {"c", 1}};
+  description.details.value_total = 10;
+  description.details.suffix = ".";
+  EXPECT_EQ(RenderLongDescription(description),
+            "Values: a (~30%), b\\n (<1%), c (~10%).");
+  EXPECT_EQ(RenderLongDescription(description, /*max_values=*/2),
+            "Values: a (~30%), b\\n (<1%) and 1 more.");
+  description.details.value_total = 0;
+  EXPECT_EQ(RenderLongDescription(description, /*max_values=*/1),
+            "Values: a (?) and 2 more.");
+}
+
+TEST(DescriptionTest, EqualityComparesRenderedDescriptions) {
+  Description lazy = {tensorflow::metadata::v0::AnomalyInfo::UNKNOWN_TYPE,
+                      "short", "Values: "};
+  lazy.details.values = {{"a", 1}};
+  lazy.details.value_total = 2;
+  const Description eager = {
+      tensorflow::metadata::v0::AnomalyInfo::UNKNOWN_TYPE, "short",
+      "Values: a (~50%)"};
+  EXPECT_EQ(lazy, eager);
+}
+
+}  // namespace
+}  // namespace data_validation
+}  // namespace tensorflow
@@ -0,0 +1,178 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/interned_path.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
+#include "absl/memory/memory.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+namespace data_validation {
+namespace internal {
+
+struct InternedPathNode {
+  // The interner owning the node.
+  PathInterner* interner = nullptr;
+  // nullptr for the root.
+  const InternedPathNode* parent = nullptr;
+  // Points into the step interner of the interner. Empty for the root.
+  absl::string_view step;
+  StringInterner::Id step_id = -1;
+  size_t size = 0;
+  size_t hash = 0;
+  // Guarded by the mutex of the interner.
+  absl::flat_hash_map<StringInterner::Id, std::unique_ptr<InternedPathNode>>
+      children;
+};
+
+}  // namespace internal
+
+using internal::InternedPathNode;
+
+PathInterner::PathInterner() : root_(absl::make_unique<InternedPathNode>()) {
+  root_->interner = this;
+}
+
+PathInterner::~PathInterner() = default;
+
+InternedPath PathInterner::Intern(const Path& path) {
+  std::vector<absl::string_view> steps(path.steps().begin(),
+                                       path.steps().end());
+  const std::vector<StringInterner::Id> step_ids = steps_.InternAll(steps);
+  mutex_lock l(mu_);
+  const InternedPathNode* node = root_.get();
+  for (const StringInterner::Id step_id : step_ids) {
+    node = GetOrAddChildLocked(node, step_id);
+  }
+  return InternedPath(node);
+}
+
+const InternedPathNode* PathInterner::GetChild(const InternedPathNode* node,
+                                               absl::string_view step) {
+  const StringInterner::Id step_id = steps_.Intern(step);
+  mutex_lock l(mu_);
+  return GetOrAddChildLocked(node, step_id);
+}
+
+absl::optional<InternedPath> PathInterner::Find(const Path& path) const {
+  std::vector<StringInterner::Id> step_ids;
+  step_ids.reserve(path.size());
+  for (const string& step : path.steps()) {
+    const absl::optional<StringInterner::Id> step_id = steps_.Find(step);
+    if (!step_id) {
+      return absl::nullopt;
+    }
+    step_ids.push_back(*step_id);
+  }
+  tf_shared_lock l(mu_);
+  const InternedPathNode* node = root_.get();
+  for (const StringInterner::Id step_id : step_ids) {
+    const auto iter = node->children.find(step_id);
+    if (iter == node->children.end()) {
+      return absl::nullopt;
+    }
+    node = iter->second.get();
+  }
+  return InternedPath(node);
+}
+
+Status PathInterner::Deserialize(absl::string_view str, InternedPath* result) {
+  Path path;
+  TF_RETURN_IF_ERROR(Path::Deserialize(str, &path));
+  *result = Intern(path);
+  return Status::OK();
+}
+
+const InternedPathNode* PathInterner::GetOrAddChildLocked(
+    const InternedPathNode* node, StringInterner::Id step_id) {
+  auto& children = const_cast<InternedPathNode*>(node)->children;
+  std::unique_ptr<InternedPathNode>& child = children[step_id];
+  if (child == nullptr) {
+    child = absl::make_unique<InternedPathNode>();
+    child->interner = this;
+    child->parent = node;
+    child->step = steps_.Get(step_id);
+    child->step_id = step_id;
+    child->size = node->size + 1;
+    child->hash = absl::Hash<std::pair<size_t, absl::string_view>>()(
+        {node->hash, child->step});
+  }
+  return child.get();
+}
+
+Path InternedPath::ToPath() const {
+  std::vector<string> steps(node_->size);
+  for (const InternedPathNode* node = node_; node->parent != nullptr;
+       node = node->parent) {
+    steps[node->size - 1] = string(node->step);
+  }
+  return Path(std::move(steps));
+}
+
+size_t InternedPath::size() const { return node_->size; }
+
+absl::string_view InternedPath::last_step() const {
+  CHECK(!empty()) << "InternedPath::last_step() called on an empty path";
+  return node_->step;
+}
+
+InternedPath InternedPath::GetParent() const {
+  CHECK(!empty()) << "InternedPath::GetParent() called on an empty path";
+  return InternedPath(node_->parent);
+}
+
+InternedPath InternedPath::GetChild(absl::string_view last_step) const {
+  return InternedPath(node_->interner->GetChild(node_, last_step));
+}
+
+size_t InternedPath::hash() const { return node_->hash; }
+
+const PathInterner* InternedPath::interner() const { return node_->interner; }
+
+bool operator<(const InternedPath& a, const InternedPath& b) {
+  if (a == b) {
+    return false;
+  }
+  // Bring both paths to the same depth. If one is a prefix of the other, the
+  // shorter one comes first.
+  const InternedPathNode* a_node = a.node_;
+  const InternedPathNode* b_node = b.node_;
+  while (a_node->size > b_node->size) {
+    a_node = a_node->parent;
+  }
+  while (b_node->size > a_node->size) {
+    b_node = b_node->parent;
+  }
+  if (a_node == b_node) {
+    return a.node_->size < b.node_->size;
+  }
+  // Otherwise, they are ordered by the first steps where they differ, i.e.
+  // the steps just below their longest common prefix.
+  while (a_node->parent != b_node->parent) {
+    a_node = a_node->parent;
+    b_node = b_node->parent;
+  }
+  return a_node->step < b_node->step;
+}
+
+}  // namespace data_validation
+}  // namespace tensorflow
@@ -0,0 +1,143 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_DATA_VALIDATION_ANOMALIES_INTERNED_PATH_H_
+#define TENSORFLOW_DATA_VALIDATION_ANOMALIES_INTERNED_PATH_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <utility>
+
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "tensorflow_data_validation/anomalies/path.h"
+#include "tensorflow_data_validation/anomalies/string_interner.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+namespace internal {
+struct InternedPathNode;
+}  // namespace internal
+
+class PathInterner;
+
+// A compact, hashable handle to a Path, for use as the key of hash maps.
+// The paths interned by a PathInterner form a prefix tree, whose nodes hold
+// one interned step each and are owned by the interner. An InternedPath is a
+// pointer to one of the nodes, so that:
+// - copies, equality and hashing (with a hash cached in the node) are O(1);
+// - GetParent() is O(1), and GetChild() is a hash map lookup;
+// - paths sharing a prefix share its storage.
+// An InternedPath is only valid for the lifetime of its interner, and only
+// compares equal to the paths of the same interner. Interned paths of the
+// same interner compare in the same order as the corresponding Paths.
+class InternedPath {
+ public:
+  // Returns the steps of the path.
+  Path ToPath() const;
+
+  // Same as Path::Serialize.
+  string Serialize() const { return ToPath().Serialize(); }
+
+  size_t size() const;
+  bool empty() const { return size() == 0; }
+
+  // Requires !empty().
+  absl::string_view last_step() const;
+  InternedPath GetParent() const;
+
+  // Interns the child in the interner of this path.
+  InternedPath GetChild(absl::string_view last_step) const;
+
+  size_t hash() const;
+
+  // The interner of the path.
+  const PathInterner* interner() const;
+
+  friend bool operator==(const InternedPath& a, const InternedPath& b) {
+    return a.node_ == b.node_;
+  }
+  friend bool operator!=(const InternedPath& a, const InternedPath& b) {
+    return a.node_ != b.node_;
+  }
+  // Lexicographical ordering on steps, as for Path. Both paths must have the
+  // same interner.
+  friend bool operator<(const InternedPath& a, const InternedPath& b);
+
+  template <typename H>
+  friend H AbslHashValue(H h, const InternedPath& path) {
+    return H::combine(std::move(h), path.hash());
+  }
+
+ private:
+  friend class PathInterner;
+
+  explicit InternedPath(const internal::InternedPathNode* node)
+      : node_(node) {}
+
+  const internal::InternedPathNode* node_;
+};
+
+// Interns Paths, e.g. those of the features of a DatasetStatsView, which owns
+// its interner. The interned paths are freed with the interner. Thread-safe:
+// interning takes a lock, but using the interned paths does not.
+class PathInterner {
+ public:
+  PathInterner();
+  ~PathInterner();
+
+  PathInterner(const PathInterner&) = delete;
+  PathInterner& operator=(const PathInterner&) = delete;
+
+  // The empty path.
+  InternedPath root() const { return InternedPath(root_.get()); }
+
+  // Interns <path>.
+  InternedPath Intern(const Path& path) LOCKS_EXCLUDED(mu_);
+
+  // Returns the interned path equal to <path>, or nullopt if it was never
+  // interned. Never interns new paths.
+  absl::optional<InternedPath> Find(const Path& path) const
+      LOCKS_EXCLUDED(mu_);
+
+  // Same as Path::Deserialize, interning the result.
+  Status Deserialize(absl::string_view str, InternedPath* result);
+
+ private:
+  friend class InternedPath;
+
+  const internal::InternedPathNode* GetChild(
+      const internal::InternedPathNode* node, absl::string_view step)
+      LOCKS_EXCLUDED(mu_);
+  const internal::InternedPathNode* GetOrAddChildLocked(
+      const internal::InternedPathNode* node, StringInterner::Id step_id)
+      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  StringInterner steps_;
+  mutable mutex mu_;
+  // Nodes are only mutated under mu_, through the interner.
+  std::unique_ptr<internal::InternedPathNode> root_;
+};
+
+}  // namespace data_validation
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_DATA_VALIDATION_ANOMALIES_INTERNED_PATH_H_
@@ -0,0 +1,119 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/interned_path.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow_data_validation/anomalies/path.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+
+namespace tensorflow {
+namespace data_validation {
+namespace {
+
+TEST(InternedPathTest, RoundTrip) {
+  PathInterner interner;
+  for (const Path& path :
+       {Path(), Path({"a"}), Path({"a", "b"}), Path({"a", ""}),
+        Path({"with.dot", "(parens)", "'quote'"})}) {
+    const InternedPath interned = interner.Intern(path);
+    EXPECT_EQ(interned.ToPath(), path);
+    EXPECT_EQ(interned.size(), path.size());
+    EXPECT_EQ(interned.Serialize(), path.Serialize());
+    InternedPath deserialized = interner.root();
+    TF_ASSERT_OK(interner.Deserialize(path.Serialize(), &deserialized));
+    EXPECT_EQ(deserialized, interned);
+  }
+}
+
+TEST(InternedPathTest, Equality) {
+  PathInterner interner;
+  const InternedPath a = interner.Intern(Path({"x", "y"}));
+  EXPECT_EQ(a, interner.Intern(Path({"x", "y"})));
+  EXPECT_EQ(a.hash(), interner.Intern(Path({"x", "y"})).hash());
+  EXPECT_EQ(a, interner.root().GetChild("x").GetChild("y"));
+  EXPECT_NE(a, interner.Intern(Path({"x"})));
+  EXPECT_NE(a, interner.Intern(Path({"y", "x"})));
+  EXPECT_NE(interner.Intern(Path({"xy"})), interner.Intern(Path({"x", "y"})));
+  EXPECT_TRUE(interner.root().empty());
+  EXPECT_EQ(interner.root(), interner.Intern(Path()));
+}
+
+TEST(InternedPathTest, PathsOfOtherInternersAreNotEqual) {
+  PathInterner interner;
+  PathInterner other_interner;
+  const InternedPath path = interner.Intern(Path({"x", "y"}));
+  const InternedPath other_path = other_interner.Intern(Path({"x", "y"}));
+  EXPECT_NE(path, other_path);
+  EXPECT_EQ(path.ToPath(), other_path.ToPath());
+  EXPECT_EQ(path.interner(), &interner);
+  EXPECT_EQ(other_path.interner(), &other_interner);
+  EXPECT_EQ(path.GetChild("z").interner(), &interner);
+  EXPECT_FALSE(other_interner.Find(Path({"x", "z"})));
+}
+
+TEST(InternedPathTest, ParentAndLastStep) {
+  PathInterner interner;
+  const InternedPath path = interner.Intern(Path({"a", "b", "c"}));
+  EXPECT_EQ(path.last_step(), "c");
+  EXPECT_EQ(path.GetParent(), interner.Intern(Path({"a", "b"})));
+  EXPECT_EQ(path.GetParent().GetParent().GetParent(), interner.root());
+}
+
+TEST(InternedPathTest, Find) {
+  PathInterner interner;
+  EXPECT_FALSE(interner.Find(Path({"find_test", "never_interned"})));
+  const InternedPath path = interner.Intern(Path({"find_test", "interned"}));
+  EXPECT_EQ(interner.Find(Path({"find_test", "interned"})), path);
+  EXPECT_EQ(interner.Find(Path({"find_test"})), path.GetParent());
+  // The steps exist, but not the path.
+  EXPECT_FALSE(interner.Find(Path({"interned", "find_test"})));
+}
+
+TEST(InternedPathTest, OrderIsTheOrderOfPaths) {
+  PathInterner interner;
+  std::vector<Path> paths = {Path(),           Path({"b"}),
+                             Path({"a", "c"}), Path({"a"}),
+                             Path({"a", "b"}), Path({"ab"}),
+                             Path({"a", "b", "a"}), Path({""})};
+  std::vector<InternedPath> interned_paths;
+  for (const Path& path : paths) {
+    interned_paths.push_back(interner.Intern(path));
+  }
+  std::sort(paths.begin(), paths.end());
+  std::sort(interned_paths.begin(), interned_paths.end());
+  ASSERT_EQ(interned_paths.size(), paths.size());
+  for (int i = 0; i < paths.size(); ++i) {
+    EXPECT_EQ(interned_paths[i].ToPath(), paths[i]);
+  }
+}
+
+TEST(InternedPathTest, HashMapKey) {
+  PathInterner interner;
+  absl::flat_hash_map<InternedPath, int> map;
+  map[interner.Intern(Path({"a"}))] = 1;
+  map[interner.Intern(Path({"a", "b"}))] = 2;
+  EXPECT_EQ(map.at(interner.Intern(Path({"a", "b"}))), 2);
+  EXPECT_EQ(map.at(interner.Intern(Path({"a", "b"})).GetParent()), 1);
+  EXPECT_EQ(map.count(interner.Intern(Path({"b"}))), 0);
+}
+
+}  // namespace
+}  // namespace data_validation
+}  // namespace tensorflow
@@ -0,0 +1,504 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/mergeable_sketches.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "absl/strings/escaping.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/platform/fingerprint.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+namespace {
+
+using ::tensorflow::metadata::v0::FeatureNameStatistics;
+
+constexpr double kInfinity = std::numeric_limits<double>::infinity();
+
+}  // namespace
+
+HyperLogLog::HyperLogLog(int precision)
+    : precision_(precision), registers_(size_t{1} << precision, 0) {}
+
+void HyperLogLog::Add(absl::string_view value) {
+  const uint64 hash = Fingerprint64(value);
+  const uint64 index = hash >> (64 - precision_);
+  // The rank is the position of the first 1 bit in the remaining bits, which
+  // are padded with a 1 so that it is at most 64 - precision + 1.
+  const uint64 remaining =
+      (hash << precision_) | (uint64{1} << (precision_ - 1));
+  const uint8 rank = __builtin_clzll(remaining) + 1;
+  registers_[index] = std::max(registers_[index], rank);
+}
+
+Status HyperLogLog::Merge(const HyperLogLog& other) {
+  if (other.precision_ != precision_) {
+    return errors::InvalidArgument(
+        "Cannot merge HyperLogLog sketches with precisions ", precision_,
+        " and ", other.precision_, ".");
+  }
+  for (int i = 0; i < registers_.size(); ++i) {
+    registers_[i] = std::max(registers_[i], other.registers_[i]);
+  }
+  return Status::OK();
+}
+
+int64 HyperLogLog::Estimate() const {
+  const double m = registers_.size();
+  double sum = 0;
+  int num_zeros = 0;
+  for (const uint8 rank : registers_) {
+    sum += std::ldexp(1.0, -rank);
+    if (rank == 0) {
+      ++num_zeros;
+    }
+  }
+  const double alpha = 0.7213 / (1 + 1.079 / m);
+  double estimate = alpha * m * m / sum;
+  // Use linear counting for small cardinalities. With 64-bit hashes, no
+  // correction is needed for large ones.
+  if (estimate <= 2.5 * m && num_zeros > 0) {
+    estimate = m * std::log(m / num_zeros);
+  }
+  return std::llround(estimate);
+}
+
+void HyperLogLog::ToProto(HyperLogLogSketch* proto) const {
+  proto->set_precision(precision_);
+  proto->set_registers(string(registers_.begin(), registers_.end()));
+}
+
+Status HyperLogLog::FromProto(const HyperLogLogSketch& proto,
+                              HyperLogLog* result) {
+  if (proto.precision() < 4 || proto.precision() > 18 ||
+      proto.registers().size() != size_t{1} << proto.precision()) {
+    return errors::InvalidArgument("Invalid HyperLogLog sketch with precision ",
+                                   proto.precision(), " and ",
+                                   proto.registers().size(), " registers.");
+  }
+  result->precision_ = proto.precision();
+  result->registers_.assign(proto.registers().begin(),
+                            proto.registers().end());
+  return Status::OK();
+}
+
+KllQuantiles::KllQuantiles(int k)
+    : k_(k),
+      compactors_(1),
+      min_(kInfinity),
+      max_(-kInfinity),
+      finite_min_(kInfinity),
+      finite_max_(-kInfinity) {}
+
+int KllQuantiles::Capacity(int level) const {
+  const int depth = compactors_.size() - level - 1;
+  return std::max(
+      2, static_cast<int>(std::ceil(k_ * std::pow(2.0 / 3.0, depth))));
+}
+
+void KllQuantiles::Add(double value) {
+  if (std::isnan(value)) {
+    return;
+  }
+  ++count_;
+  min_ = std::min(min_, value);
+  max_ = std::max(max_, value);
+  if (std::isfinite(value)) {
+    finite_min_ = std::min(finite_min_, value);
+    finite_max_ = std::max(finite_max_, value);
+  }
+  compactors_[0].push_back(value);
+  if (compactors_[0].size() >= Capacity(0)) {
+    Compress();
+  }
+}
+
+void KllQuantiles::Compress() {
+  bool compacted = true;
+  while (compacted) {
+    compacted = false;
+    for (int level = 0; level < compactors_.size(); ++level) {
+      if (compactors_[level].size() < Capacity(level)) {
+        continue;
+      }
+      if (level + 1 == compactors_.size()) {
+        compactors_.emplace_back();
+      }
+      std::vector<double>& items = compactors_[level];
+      std::sort(items.begin(), items.end());
+      // With an odd number of items, the last one stays at this level so that
+      // the total weight is unchanged.
+      const double* held_back =
+          items.size() % 2 == 1 ? &items.back() : nullptr;
+      const int num_pairs = items.size() / 2;
+      std::vector<double>& next = compactors_[level + 1];
+      for (int i = 0; i < num_pairs; ++i) {
+        next.push_back(items[2 * i + (odd_compaction_ ? 1 : 0)]);
+      }
+      odd_compaction_ = !odd_compaction_;
+      if (held_back != nullptr) {
+        items.front() = *held_back;
+        items.resize(1);
+      } else {
+        items.clear();
+      }
+      compacted = true;
+      break;
+    }
+  }
+}
+
+Status KllQuantiles::Merge(const KllQuantiles& other) {
+  if (other.count_ == 0) {
+    return Status::OK();
+  }
+  if (count_ == 0) {
+    *this = other;
+    return Status::OK();
+  }
+  if (other.k_ != k_) {
+    return errors::InvalidArgument("Cannot merge KLL sketches with k = ", k_,
+                                   " and ", other.k_, ".");
+  }
+  if (other.compactors_.size() > compactors_.size()) {
+    compactors_.resize(other.compactors_.size());
+  }
+  for (int level = 0; level < other.compactors_.size(); ++level) {
+    compactors_[level].insert(compactors_[level].end(),
+                              other.compactors_[level].begin(),
+                              other.compactors_[level].end());
+  }
+  count_ += other.count_;
+  min_ = std::min(min_, other.min_);
+  max_ = std::max(max_, other.max_);
+  finite_min_ = std::min(finite_min_, other.finite_min_);
+  finite_max_ = std::max(finite_max_, other.finite_max_);
+  Compress();
+  return Status::OK();
+}
+
+std::vector<double> KllQuantiles::GetQuantiles(int num_intervals) const {
+  std::vector<std::pair<double, double>> weighted_items;
+  for (int level = 0; level < compactors_.size(); ++level) {
+    const double weight = std::ldexp(1.0, level);
+    for (const double item : compactors_[level]) {
+      weighted_items.emplace_back(item, weight);
+    }
+  }
+  std::sort(weighted_items.begin(), weighted_items.end());
+  double total_weight = 0;
+  for (const auto& item : weighted_items) {
+    total_weight += item.second;
+  }
+
+  std::vector<double> result;
+  result.reserve(num_intervals + 1);
+  result.push_back(min_);
+  double cumulative_weight = 0;
+  int index = 0;
+  for (int i = 1; i < num_intervals; ++i) {
+    const double rank = total_weight * i / num_intervals;
+    while (index + 1 < weighted_items.size() &&
+           cumulative_weight + weighted_items[index].second < rank) {
+      cumulative_weight += weighted_items[index].second;
+      ++index;
+    }
+    result.push_back(weighted_items[index].first);
+  }
+  result.push_back(max_);
+  return result;
+}
+
+void KllQuantiles::ToProto(KllSketch* proto) const {
+  proto->set_k(k_);
+  for (const std::vector<double>& items : compactors_) {
+    *proto->add_compactors()->mutable_items() = {items.begin(), items.end()};
+  }
+  proto->set_count(count_);
+  proto->set_min(min_);
+  proto->set_max(max_);
+  proto->set_finite_min(finite_min_);
+  proto->set_finite_max(finite_max_);
+}
+
+Status KllQuantiles::FromProto(const KllSketch& proto, KllQuantiles* result) {
+  if (proto.k() < 8 || proto.compactors_size() == 0) {
+    return errors::InvalidArgument("Invalid KLL sketch with k = ", proto.k(),
+                                   " and ", proto.compactors_size(),
+                                   " compactors.");
+  }
+  *result = KllQuantiles(proto.k());
+  result->compactors_.clear();
+  for (const KllSketch::Compactor& compactor : proto.compactors()) {
+    result->compactors_.emplace_back(compactor.items().begin(),
+                                     compactor.items().end());
+  }
+  result->count_ = proto.count();
+  result->min_ = proto.min();
+  result->max_ = proto.max();
+  result->finite_min_ = proto.finite_min();
+  result->finite_max_ = proto.finite_max();
+  return Status::OK();
+}
+
+SpaceSaving::SpaceSaving(int capacity) : capacity_(capacity) {}
+
+double SpaceSaving::MinCount() const {
+  return counts_.size() < capacity_ ? 0 : by_count_.begin()->first;
+}
+
+void SpaceSaving::SetCount(const string& value, double count) {
+  auto it = counts_.find(value);
+  if (it != counts_.end()) {
+    by_count_.erase({it->second, value});
+    it->second = count;
+  } else {
+    counts_.emplace(value, count);
+  }
+  by_count_.emplace(count, value);
+}
+
+void SpaceSaving::Add(absl::string_view value, double count) {
+  const string key(value);
+  const auto it = counts_.find(key);
+  if (it != counts_.end()) {
+    SetCount(key, it->second + count);
+    return;
+  }
+  if (counts_.size() < capacity_) {
+    SetCount(key, count);
+    return;
+  }
+  // Replace the least frequent value, whose count the new value may have had.
+  const auto min_it = by_count_.begin();
+  const double min_count = min_it->first;
+  counts_.erase(min_it->second);
+  by_count_.erase(min_it);
+  SetCount(key, min_count + count);
+}
+
+void SpaceSaving::Merge(const SpaceSaving& other) {
+  const double min_count = MinCount();
+  const double other_min_count = other.MinCount();
+  absl::flat_hash_map<string, double> merged;
+  for (const auto& entry : counts_) {
+    const auto it = other.counts_.find(entry.first);
+    merged[entry.first] =
+        entry.second +
+        (it == other.counts_.end() ? other_min_count : it->second);
+  }
+  for (const auto& entry : other.counts_) {
+    if (counts_.find(entry.first) == counts_.end()) {
+      merged[entry.first] = entry.second + min_count;
+    }
+  }
+  capacity_ = std::max(capacity_, other.capacity_);
+  counts_.clear();
+  by_count_.clear();
+  std::vector<std::pair<double, string>> by_count;
+  for (auto& entry : merged) {
+    by_count.emplace_back(entry.second, entry.first);
+  }
+  // Keep the most frequent values.
+  const int num_kept = std::min<int>(capacity_, by_count.size());
+  std::partial_sort(by_count.begin(), by_count.begin() + num_kept,
+                    by_count.end(), std::greater<std::pair<double, string>>());
+  for (int i = 0; i < num_kept; ++i) {
+    SetCount(by_count[i].second, by_count[i].first);
+  }
+}
+
+std::vector<std::pair<string, double>> SpaceSaving::GetTopValues(
+    int num_values) const {
+  std::vector<std::pair<string, double>> result;
+  for (auto it = by_count_.rbegin();
+       it != by_count_.rend() && result.size() < num_values; ++it) {
+    result.emplace_back(it->second, it->first);
+  }
+  // Values with the same count are iterated by decreasing value.
+  std::stable_sort(result.begin(), result.end(),
+                   [](const std::pair<string, double>& a,
+                      const std::pair<string, double>& b) {
+                     return a.second > b.second ||
+                            (a.second == b.second && a.first < b.first);
+                   });
+  return result;
+}
+
+void SpaceSaving::ToProto(SpaceSavingSketch* proto) const {
+  proto->set_capacity(capacity_);
+  for (auto it = by_count_.rbegin(); it != by_count_.rend(); ++it) {
+    SpaceSavingSketch::Item* item = proto->add_items();
+    item->set_value(it->second);
+    item->set_count(it->first);
+  }
+}
+
+Status SpaceSaving::FromProto(const SpaceSavingSketch& proto,
+                              SpaceSaving* result) {
+  if (proto.capacity() <= 0 || proto.items_size() > proto.capacity()) {
+    return errors::InvalidArgument("Invalid SpaceSaving sketch with capacity ",
+                                   proto.capacity(), " and ",
+                                   proto.items_size(), " items.");
+  }
+  *result = SpaceSaving(proto.capacity());
+  for (const SpaceSavingSketch::Item& item : proto.items()) {
+    result->SetCount(item.value(), item.count());
+  }
+  return Status::OK();
+}
+
+Status ValidateFeatureSketchesOptions(const FeatureSketchesOptions& options) {
+  if (options.hyperloglog_precision < 4 || options.hyperloglog_precision > 18) {
+    return errors::InvalidArgument(
+        "The HyperLogLog precision must be in [4, 18], got ",
+        options.hyperloglog_precision, ".");
+  }
+  if (options.kll_k < 8) {
+    return errors::InvalidArgument("The KLL k must be at least 8, got ",
+                                   options.kll_k, ".");
+  }
+  if (options.top_values_capacity <= 0) {
+    return errors::InvalidArgument(
+        "The top values capacity must be positive, got ",
+        options.top_values_capacity, ".");
+  }
+  return Status::OK();
+}
+
+MergeableFeatureSketches::MergeableFeatureSketches(
+    const FeatureSketchesOptions& options)
+    : distinct_values_(options.hyperloglog_precision),
+      top_values_(options.top_values_capacity),
+      values_(options.kll_k),
+      num_values_(options.kll_k) {}
+
+void MergeableFeatureSketches::AddNumValues(int64 num_values) {
+  num_values_.Add(num_values);
+}
+
+void MergeableFeatureSketches::AddNumericValue(double value) {
+  values_.Add(value);
+}
+
+void MergeableFeatureSketches::AddStringValue(absl::string_view value) {
+  has_string_values_ = true;
+  distinct_values_.Add(value);
+  top_values_.Add(value);
+}
+
+Status MergeableFeatureSketches::Merge(const MergeableFeatureSketches& other) {
+  if (other.has_string_values_) {
+    if (has_string_values_) {
+      TF_RETURN_IF_ERROR(distinct_values_.Merge(other.distinct_values_));
+      top_values_.Merge(other.top_values_);
+    } else {
+      distinct_values_ = other.distinct_values_;
+      top_values_ = other.top_values_;
+      has_string_values_ = true;
+    }
+  }
+  TF_RETURN_IF_ERROR(values_.Merge(other.values_));
+  TF_RETURN_IF_ERROR(num_values_.Merge(other.num_values_));
+  return Status::OK();
+}
+
+void MergeableFeatureSketches::ToProto(FeatureSketches* proto) const {
+  proto->Clear();
+  if (has_string_values_) {
+    distinct_values_.ToProto(proto->mutable_distinct_values());
+    top_values_.ToProto(proto->mutable_top_values());
+  }
+  if (values_.count() > 0) {
+    values_.ToProto(proto->mutable_values());
+  }
+  if (num_values_.count() > 0) {
+    num_values_.ToProto(proto->mutable_num_values());
+  }
+}
+
+Status MergeableFeatureSketches::FromProto(const FeatureSketches& proto,
+                                           MergeableFeatureSketches* result) {
+  if (proto.has_distinct_values() != proto.has_top_values()) {
+    return errors::InvalidArgument(
+        "The distinct and top values sketches must be both present or "
+        "absent.");
+  }
+  if (proto.has_distinct_values()) {
+    TF_RETURN_IF_ERROR(
+        HyperLogLog::FromProto(proto.distinct_values(),
+                               &result->distinct_values_));
+    TF_RETURN_IF_ERROR(
+        SpaceSaving::FromProto(proto.top_values(), &result->top_values_));
+    result->has_string_values_ = true;
+  }
+  if (proto.has_values()) {
+    TF_RETURN_IF_ERROR(KllQuantiles::FromProto(proto.values(),
+                                               &result->values_));
+  }
+  if (proto.has_num_values()) {
+    TF_RETURN_IF_ERROR(
+        KllQuantiles::FromProto(proto.num_values(), &result->num_values_));
+  }
+  return Status::OK();
+}
+
+void SetFeatureSketches(const FeatureSketches& sketches,
+                        FeatureNameStatistics* feature) {
+  metadata::v0::CustomStatistic* custom_stat = nullptr;
+  for (metadata::v0::CustomStatistic& existing :
+       *feature->mutable_custom_stats()) {
+    if (existing.name() == kFeatureSketchesCustomStatName) {
+      custom_stat = &existing;
+      break;
+    }
+  }
+  if (custom_stat == nullptr) {
+    custom_stat = feature->add_custom_stats();
+    custom_stat->set_name(kFeatureSketchesCustomStatName);
+  }
+  // Custom statistics strings must be valid UTF-8.
+  string encoded;
+  absl::Base64Escape(sketches.SerializeAsString(), &encoded);
+  custom_stat->set_str(std::move(encoded));
+}
+
+Status GetFeatureSketches(const FeatureNameStatistics& feature,
+                          absl::optional<FeatureSketches>* sketches) {
+  sketches->reset();
+  for (const metadata::v0::CustomStatistic& custom_stat :
+       feature.custom_stats()) {
+    if (custom_stat.name() != kFeatureSketchesCustomStatName) {
+      continue;
+    }
+    string serialized;
+    sketches->emplace();
+    if (!absl::Base64Unescape(custom_stat.str(), &serialized) ||
+        !(*sketches)->ParseFromString(serialized)) {
+      return errors::InvalidArgument("Invalid ", kFeatureSketchesCustomStatName,
+                                     " custom statistic.");
+    }
+    return Status::OK();
+  }
+  return Status::OK();
+}
+
+}  // namespace data_validation
+}  // namespace tensorflow
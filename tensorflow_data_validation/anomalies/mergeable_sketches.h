@@ -0,0 +1,197 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Mergeable sketches of the values of features, which can be embedded in their
+// statistics so that the statistics of several datasets (e.g. the daily
+// statistics of a rolling window) can be merged without recomputing them from
+// the data (see window_statistics_util.h).
+#ifndef TENSORFLOW_DATA_VALIDATION_ANOMALIES_MERGEABLE_SKETCHES_H_
+#define TENSORFLOW_DATA_VALIDATION_ANOMALIES_MERGEABLE_SKETCHES_H_
+
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "tensorflow_data_validation/anomalies/proto/mergeable_sketches.pb.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow_metadata/proto/v0/statistics.pb.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+// The name of the custom statistic holding the FeatureSketches of a feature,
+// serialized and base64-encoded.
+constexpr char kFeatureSketchesCustomStatName[] = "tfdv_mergeable_sketches";
+
+// Estimates the number of distinct values, with a relative standard error of
+// about 1.04 / sqrt(2^precision).
+class HyperLogLog {
+ public:
+  explicit HyperLogLog(int precision = 12);
+
+  void Add(absl::string_view value);
+
+  // Returns InvalidArgument if the precisions differ.
+  Status Merge(const HyperLogLog& other);
+
+  int64 Estimate() const;
+
+  void ToProto(HyperLogLogSketch* proto) const;
+  static Status FromProto(const HyperLogLogSketch& proto, HyperLogLog* result);
+
+ private:
+  int precision_;
+  std::vector<uint8> registers_;
+};
+
+// Estimates the quantiles of numeric values, with a rank error of about
+// 1.7 / k. The compactions are deterministic, so that the same inputs always
+// give the same sketch.
+class KllQuantiles {
+ public:
+  explicit KllQuantiles(int k = 200);
+
+  // NaN values are ignored.
+  void Add(double value);
+
+  // Returns InvalidArgument if the values of k differ.
+  Status Merge(const KllQuantiles& other);
+
+  int64 count() const { return count_; }
+  double min() const { return min_; }
+  double max() const { return max_; }
+  // The min and max of the finite values (+inf and -inf if there is none).
+  double finite_min() const { return finite_min_; }
+  double finite_max() const { return finite_max_; }
+
+  // Returns the boundaries of <num_intervals> intervals with the same number
+  // of values, from the min to the max. The sketch must not be empty.
+  std::vector<double> GetQuantiles(int num_intervals) const;
+
+  void ToProto(KllSketch* proto) const;
+  static Status FromProto(const KllSketch& proto, KllQuantiles* result);
+
+ private:
+  // The capacity of the compactor at <level>.
+  int Capacity(int level) const;
+  // Compacts the compactors over capacity.
+  void Compress();
+
+  int k_;
+  // The items of compactors_[level] have a weight of 2^level.
+  std::vector<std::vector<double>> compactors_;
+  int64 count_ = 0;
+  double min_;
+  double max_;
+  double finite_min_;
+  double finite_max_;
+  // Alternates the half of the items kept by compactions.
+  bool odd_compaction_ = false;
+};
+
+// Estimates the most frequent values and their counts, which are
+// overestimated by at most the total count over the capacity.
+class SpaceSaving {
+ public:
+  explicit SpaceSaving(int capacity = 1000);
+
+  void Add(absl::string_view value, double count = 1);
+
+  // Merges the counts as in "Parallel Space Saving on Multi and Many-Core
+  // Processors" (Cafaro et al.), which keeps the error bound of the sketches.
+  void Merge(const SpaceSaving& other);
+
+  // Returns the <num_values> most frequent values with their counts, by
+  // decreasing count and then by value.
+  std::vector<std::pair<string, double>> GetTopValues(int num_values) const;
+
+  void ToProto(SpaceSavingSketch* proto) const;
+  static Status FromProto(const SpaceSavingSketch& proto, SpaceSaving* result);
+
+ private:
+  // The smallest count if the sketch is full, or 0.
+  double MinCount() const;
+  void SetCount(const string& value, double count);
+
+  int capacity_;
+  absl::flat_hash_map<string, double> counts_;
+  // The entries of counts_, by increasing count.
+  std::set<std::pair<double, string>> by_count_;
+};
+
+struct FeatureSketchesOptions {
+  int hyperloglog_precision = 12;
+  int kll_k = 200;
+  int top_values_capacity = 1000;
+};
+
+// Returns InvalidArgument unless the options are within the bounds accepted by
+// MergeableFeatureSketches::FromProto, i.e. a HyperLogLog precision in
+// [4, 18], a KLL k of at least 8 and a positive top values capacity.
+Status ValidateFeatureSketchesOptions(const FeatureSketchesOptions& options);
+
+// The sketches of the values of a feature, in which the values of examples
+// (or of their merged statistics) are accumulated.
+class MergeableFeatureSketches {
+ public:
+  explicit MergeableFeatureSketches(
+      const FeatureSketchesOptions& options = FeatureSketchesOptions());
+
+  // Adds the number of values of an example where the feature is present.
+  void AddNumValues(int64 num_values);
+  void AddNumericValue(double value);
+  void AddStringValue(absl::string_view value);
+
+  // Returns InvalidArgument if the sketches have different parameters.
+  Status Merge(const MergeableFeatureSketches& other);
+
+  const HyperLogLog& distinct_values() const { return distinct_values_; }
+  const SpaceSaving& top_values() const { return top_values_; }
+  const KllQuantiles& values() const { return values_; }
+  const KllQuantiles& num_values() const { return num_values_; }
+  bool has_string_values() const { return has_string_values_; }
+
+  // Only the non-empty sketches are output.
+  void ToProto(FeatureSketches* proto) const;
+  static Status FromProto(const FeatureSketches& proto,
+                          MergeableFeatureSketches* result);
+
+ private:
+  HyperLogLog distinct_values_;
+  SpaceSaving top_values_;
+  KllQuantiles values_;
+  KllQuantiles num_values_;
+  bool has_string_values_ = false;
+};
+
+// Sets the custom statistic kFeatureSketchesCustomStatName of <feature> to
+// <sketches>.
+void SetFeatureSketches(const FeatureSketches& sketches,
+                        metadata::v0::FeatureNameStatistics* feature);
+
+// Gets the sketches embedded in <feature> by SetFeatureSketches, or nullopt
+// if it has none.
+Status GetFeatureSketches(const metadata::v0::FeatureNameStatistics& feature,
+                          absl::optional<FeatureSketches>* sketches);
+
+}  // namespace data_validation
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_DATA_VALIDATION_ANOMALIES_MERGEABLE_SKETCHES_H_
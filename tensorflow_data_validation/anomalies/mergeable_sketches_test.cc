@@ -0,0 +1,188 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/mergeable_sketches.h"
+
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/strings/str_cat.h"
+#include "absl/types/optional.h"
+#include "tensorflow_data_validation/anomalies/test_util.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow_metadata/proto/v0/statistics.pb.h"
+
+namespace tensorflow {
+namespace data_validation {
+namespace {
+
+using ::tensorflow::metadata::v0::FeatureNameStatistics;
+using testing::EqualsProto;
+
+TEST(HyperLogLogTest, SmallCardinalityIsAlmostExact) {
+  HyperLogLog sketch;
+  for (int i = 0; i < 100; ++i) {
+    sketch.Add(absl::StrCat("value_", i % 10));
+  }
+  EXPECT_NEAR(sketch.Estimate(), 10, 1);
+}
+
+TEST(HyperLogLogTest, MergeEstimatesUnion) {
+  HyperLogLog first;
+  HyperLogLog second;
+  for (int i = 0; i < 60000; ++i) {
+    first.Add(absl::StrCat(i));
+    second.Add(absl::StrCat(i + 40000));
+  }
+  TF_ASSERT_OK(first.Merge(second));
+  EXPECT_NEAR(first.Estimate(), 100000, 5000);
+
+  HyperLogLogSketch proto;
+  first.ToProto(&proto);
+  HyperLogLog parsed;
+  TF_ASSERT_OK(HyperLogLog::FromProto(proto, &parsed));
+  EXPECT_EQ(parsed.Estimate(), first.Estimate());
+}
+
+TEST(HyperLogLogTest, MergeWithDifferentPrecisionFails) {
+  HyperLogLog first(10);
+  HyperLogLog second(12);
+  EXPECT_TRUE(errors::IsInvalidArgument(first.Merge(second)));
+}
+
+TEST(KllQuantilesTest, Quantiles) {
+  KllQuantiles first;
+  KllQuantiles second;
+  // The values 0, ..., 99999 in a scrambled order, split in two.
+  for (int i = 0; i < 100000; ++i) {
+    const double value = (i * int64{7919}) % 100000;
+    (i % 3 == 0 ? first : second).Add(value);
+  }
+  first.Add(std::numeric_limits<double>::quiet_NaN());
+  TF_ASSERT_OK(first.Merge(second));
+  EXPECT_EQ(first.count(), 100000);
+  const std::vector<double> quantiles = first.GetQuantiles(4);
+  ASSERT_EQ(quantiles.size(), 5);
+  EXPECT_EQ(quantiles[0], 0);
+  EXPECT_NEAR(quantiles[1], 25000, 2000);
+  EXPECT_NEAR(quantiles[2], 50000, 2000);
+  EXPECT_NEAR(quantiles[3], 75000, 2000);
+  EXPECT_EQ(quantiles[4], 99999);
+
+  KllSketch proto;
+  first.ToProto(&proto);
+  KllQuantiles parsed;
+  TF_ASSERT_OK(KllQuantiles::FromProto(proto, &parsed));
+  EXPECT_EQ(parsed.GetQuantiles(4), quantiles);
+}
+
+TEST(KllQuantilesTest, InfiniteValues) {
+  KllQuantiles sketch;
+  sketch.Add(-std::numeric_limits<double>::infinity());
+  sketch.Add(1);
+  sketch.Add(2);
+  EXPECT_EQ(sketch.min(), -std::numeric_limits<double>::infinity());
+  EXPECT_EQ(sketch.finite_min(), 1);
+  EXPECT_EQ(sketch.finite_max(), 2);
+}
+
+TEST(SpaceSavingTest, TopValues) {
+  SpaceSaving first(100);
+  SpaceSaving second(100);
+  for (int i = 0; i < 5000; ++i) {
+    SpaceSaving& sketch = i % 2 == 0 ? first : second;
+    sketch.Add(absl::StrCat("rare_", i));
+    if (i % 5 == 0) {
+      sketch.Add("a");
+    }
+    if (i % 10 == 0) {
+      sketch.Add("b", 1.5);
+    }
+  }
+  first.Merge(second);
+  const std::vector<std::pair<string, double>> top_values =
+      first.GetTopValues(2);
+  ASSERT_EQ(top_values.size(), 2);
+  EXPECT_EQ(top_values[0].first, "a");
+  // The counts are overestimated by at most the total count over the
+  // capacity.
+  EXPECT_GE(top_values[0].second, 1000);
+  EXPECT_LE(top_values[0].second, 1000 + 6750 / 100.0);
+  EXPECT_EQ(top_values[1].first, "b");
+  EXPECT_GE(top_values[1].second, 750);
+
+  SpaceSavingSketch proto;
+  first.ToProto(&proto);
+  EXPECT_EQ(proto.items_size(), 100);
+  SpaceSaving parsed;
+  TF_ASSERT_OK(SpaceSaving::FromProto(proto, &parsed));
+  EXPECT_EQ(parsed.GetTopValues(2), top_values);
+}
+
+TEST(MergeableFeatureSketchesTest, EmbedInFeatureStatistics) {
+  MergeableFeatureSketches sketches;
+  sketches.AddNumValues(2);
+  sketches.AddStringValue("a");
+  sketches.AddStringValue("b\xff");
+  FeatureSketches proto;
+  sketches.ToProto(&proto);
+  EXPECT_TRUE(proto.has_distinct_values());
+  EXPECT_TRUE(proto.has_num_values());
+  EXPECT_FALSE(proto.has_values());
+
+  FeatureNameStatistics feature;
+  absl::optional<FeatureSketches> embedded;
+  TF_ASSERT_OK(GetFeatureSketches(feature, &embedded));
+  EXPECT_FALSE(embedded);
+  SetFeatureSketches(FeatureSketches(), &feature);
+  SetFeatureSketches(proto, &feature);
+  ASSERT_EQ(feature.custom_stats_size(), 1);
+  TF_ASSERT_OK(GetFeatureSketches(feature, &embedded));
+  ASSERT_TRUE(embedded);
+  EXPECT_THAT(*embedded, EqualsProto(proto));
+
+  MergeableFeatureSketches parsed;
+  TF_ASSERT_OK(MergeableFeatureSketches::FromProto(*embedded, &parsed));
+  EXPECT_TRUE(parsed.has_string_values());
+  EXPECT_EQ(parsed.distinct_values().Estimate(), 2);
+
+  feature.mutable_custom_stats(0)->set_str("not base64!");
+  EXPECT_TRUE(
+      errors::IsInvalidArgument(GetFeatureSketches(feature, &embedded)));
+}
+
+TEST(MergeableFeatureSketchesTest, ValidateOptions) {
+  FeatureSketchesOptions options;
+  TF_EXPECT_OK(ValidateFeatureSketchesOptions(options));
+  options.hyperloglog_precision = 19;
+  EXPECT_TRUE(
+      errors::IsInvalidArgument(ValidateFeatureSketchesOptions(options)));
+  options = FeatureSketchesOptions();
+  options.kll_k = 7;
+  EXPECT_TRUE(
+      errors::IsInvalidArgument(ValidateFeatureSketchesOptions(options)));
+  options = FeatureSketchesOptions();
+  options.top_values_capacity = 0;
+  EXPECT_TRUE(
+      errors::IsInvalidArgument(ValidateFeatureSketchesOptions(options)));
+}
+
+}  // namespace
+}  // namespace data_validation
+}  // namespace tensorflow
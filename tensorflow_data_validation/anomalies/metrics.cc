@@ -23,7 +23,9 @@ limitations under the License.
 #include <string>
 #include <vector>
 
+#include "absl/types/optional.h"
 #include "tensorflow_data_validation/anomalies/map_util.h"
+#include "tensorflow_data_validation/anomalies/string_interner.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow_metadata/proto/v0/statistics.pb.h"
@@ -49,6 +51,17 @@ std::pair<string, double> GetLInftyNorm(const std::map<string, double>& vec) {
   return best_so_far;
 }
 
+// Returns the divisor normalizing <counts> so that they sum to 1 (i.e. their
+// sum), or 1 if they sum to 0.
+double GetNormalizationDivisor(
+    const std::vector<std::pair<StringInterner::Id, double>>& counts) {
+  double sum = 0.0;
+  for (const auto& id_and_count : counts) {
+    sum += id_and_count.second;
+  }
+  return sum == 0.0 ? 1.0 : sum;
+}
+
 // Returns a histogram consisting of the buckets in the input histogram and a
 // bucket containing NaNs.
 Histogram GetHistogramWithNanBucket(const Histogram& histogram,
@@ -240,12 +253,48 @@ std::pair<string, double> LInftyDistance(
 
 std::pair<string, double> LInftyDistance(const FeatureStatsView& a,
                                          const FeatureStatsView& b) {
-  const std::map<string, double> prob_a =
-      Normalize(a.GetStringValuesWithCounts());
-  const std::map<string, double> prob_b =
-      Normalize(b.GetStringValuesWithCounts());
+  StringInterner* interner = a.string_interner();
+  const std::vector<std::pair<StringInterner::Id, double>> counts_a =
+      a.GetStringValueIdsWithCounts(interner);
+  const std::vector<std::pair<StringInterner::Id, double>> counts_b =
+      b.GetStringValueIdsWithCounts(interner);
+  const double sum_a = GetNormalizationDivisor(counts_a);
+  const double sum_b = GetNormalizationDivisor(counts_b);
 
-  return GetLInftyNorm(GetDifference(prob_a, prob_b));
+  // Both count vectors are sorted by id: merge them. As in the map-based
+  // version, ties are broken in favor of the largest value.
+  absl::optional<StringInterner::Id> best_id;
+  double best_distance = 0.0;
+  const auto update_best = [&](StringInterner::Id id, double distance) {
+    distance = std::abs(distance);
+    if (!best_id || distance > best_distance ||
+        (distance == best_distance &&
+         interner->Get(id) > interner->Get(*best_id))) {
+      best_id = id;
+      best_distance = distance;
+    }
+  };
+  auto iter_a = counts_a.begin();
+  auto iter_b = counts_b.begin();
+  while (iter_a != counts_a.end() || iter_b != counts_b.end()) {
+    if (iter_b == counts_b.end() ||
+        (iter_a != counts_a.end() && iter_a->first < iter_b->first)) {
+      update_best(iter_a->first, iter_a->second / sum_a);
+      ++iter_a;
+    } else if (iter_a == counts_a.end() || iter_b->first < iter_a->first) {
+      update_best(iter_b->first, iter_b->second / sum_b);
+      ++iter_b;
+    } else {
+      update_best(iter_a->first,
+                  iter_a->second / sum_a - iter_b->second / sum_b);
+      ++iter_a;
+      ++iter_b;
+    }
+  }
+  if (!best_id) {
+    return {"", 0.0};
+  }
+  return {string(interner->Get(*best_id)), best_distance};
 }
 
 Status UpdateJensenShannonDivergenceResult(const FeatureStatsView& a,
@@ -98,6 +98,24 @@ TEST(LInftyDistanceTest, All) {
   }
 }
 
+TEST(LInftyDistanceTest, SameAsMapVersion) {
+  std::vector<LInftyDistanceExample> tests = GetLInftyDistanceTests();
+  // Ties are resolved in favor of the largest value.
+  tests.push_back(
+      {"Ties.", {{"b", 1}, {"a", 1}}, {{"d", 1}, {"c", 1}}, 0.5});
+  tests.push_back({"Zero counts.", {{"b", 0}, {"a", 0}}, {{"c", 0}}, 0.0});
+  for (const auto& test : tests) {
+    const DatasetForTesting training(
+        GetFeatureNameStatisticsWithTokens(test.training));
+    const DatasetForTesting serving(
+        GetFeatureNameStatisticsWithTokens(test.serving));
+    EXPECT_EQ(LInftyDistance(training.feature_stats_view(),
+                             serving.feature_stats_view()),
+              LInftyDistance(test.training, test.serving))
+        << test.name;
+  }
+}
+
 TEST(JensenShannonDivergence, SameStatistics) {
   const DatasetForTesting dataset(ParseTextProtoOrDie<FeatureNameStatistics>(R"(
     name: 'float'
@@ -0,0 +1,479 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/mutual_information.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/threadpool.h"
+
+namespace tensorflow {
+namespace data_validation {
+namespace {
+
+// The scale of the noise added to continuous values, relative to their mean
+// absolute value, as in sklearn.
+constexpr double kNoiseScale = 1e-10;
+
+constexpr double kEulerGamma = 0.57721566490153286;
+
+// A feature or the label, prepared for the estimators.
+struct Variable {
+  bool is_discrete = false;
+  // The values of a continuous variable, scaled to unit variance and with
+  // ties broken by a small noise.
+  std::vector<double> values;
+  // The dense codes of the categories of a discrete variable.
+  std::vector<int> codes;
+  int num_codes = 0;
+};
+
+// The digamma function of the integers up to <n>, from psi(1) = -gamma and
+// psi(m + 1) = psi(m) + 1 / m. The estimators only need integer arguments.
+std::vector<double> DigammaTable(size_t n) {
+  std::vector<double> table(n + 1);
+  if (n >= 1) {
+    table[1] = -kEulerGamma;
+  }
+  for (size_t m = 1; m < n; ++m) {
+    table[m + 1] = table[m] + 1.0 / m;
+  }
+  return table;
+}
+
+void PrepareDiscrete(const std::vector<double>& values, Variable* variable) {
+  variable->is_discrete = true;
+  variable->codes.resize(values.size());
+  absl::flat_hash_map<double, int> codes;
+  int nan_code = -1;
+  for (size_t i = 0; i < values.size(); ++i) {
+    int* code;
+    if (std::isnan(values[i])) {
+      code = &nan_code;
+    } else {
+      code = &codes.try_emplace(values[i], -1).first->second;
+    }
+    if (*code < 0) {
+      *code = variable->num_codes++;
+    }
+    variable->codes[i] = *code;
+  }
+}
+
+void PrepareContinuous(const std::vector<double>& values,
+                       std::mt19937_64* rng, Variable* variable) {
+  variable->is_discrete = false;
+  variable->values = values;
+  std::vector<double>& x = variable->values;
+  double max = -std::numeric_limits<double>::infinity();
+  for (const double value : x) {
+    if (!std::isnan(value)) {
+      max = std::max(max, value);
+    }
+  }
+  const double fill_value =
+      std::isinf(max) ? std::numeric_limits<int64>::max() : max * 10;
+  double sum = 0;
+  for (double& value : x) {
+    if (std::isnan(value)) {
+      value = fill_value;
+    }
+    sum += value;
+  }
+  const double mean = sum / x.size();
+  double sum_of_squares = 0;
+  for (const double value : x) {
+    sum_of_squares += (value - mean) * (value - mean);
+  }
+  const double std_dev = std::sqrt(sum_of_squares / x.size());
+  double sum_of_abs = 0;
+  for (double& value : x) {
+    if (std_dev > 0) {
+      value /= std_dev;
+    }
+    sum_of_abs += std::abs(value);
+  }
+  const double noise_scale =
+      kNoiseScale * std::max(1.0, sum_of_abs / x.size());
+  std::normal_distribution<double> noise;
+  for (double& value : x) {
+    value += noise_scale * noise(*rng);
+  }
+}
+
+void Prepare(const MutualInformationColumn& column, std::mt19937_64* rng,
+             Variable* variable) {
+  if (column.is_discrete) {
+    PrepareDiscrete(column.values, variable);
+  } else {
+    PrepareContinuous(column.values, rng, variable);
+  }
+}
+
+// The values of a variable in increasing order, and the position of each
+// value in that order.
+struct SortedValues {
+  std::vector<double> values;
+  std::vector<int> positions;
+};
+
+SortedValues Sort(const std::vector<double>& values) {
+  std::vector<int> order(values.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(),
+            [&values](int i, int j) { return values[i] < values[j]; });
+  SortedValues result;
+  result.values.resize(values.size());
+  result.positions.resize(values.size());
+  for (size_t p = 0; p < order.size(); ++p) {
+    result.values[p] = values[order[p]];
+    result.positions[order[p]] = p;
+  }
+  return result;
+}
+
+// The number of values within <radius> of the i-th value, found by galloping
+// outwards from its position. The differences are compared to the radius, as
+// center +/- radius could round onto the neighbor the radius was shrunk to
+// exclude.
+int CountWithin(const SortedValues& sorted, int i, double radius) {
+  const std::vector<double>& values = sorted.values;
+  const int n = values.size();
+  const int position = sorted.positions[i];
+  const double center = values[position];
+  int begin = position;
+  int step = 1;
+  while (begin - step >= 0 && center - values[begin - step] <= radius) {
+    begin -= step;
+    step *= 2;
+  }
+  begin = std::partition_point(
+              values.begin() + std::max(begin - step, 0),
+              values.begin() + begin,
+              [&](double value) { return center - value > radius; }) -
+          values.begin();
+  int end = position;
+  step = 1;
+  while (end + step < n && values[end + step] - center <= radius) {
+    end += step;
+    step *= 2;
+  }
+  end = std::partition_point(
+            values.begin() + end + 1, values.begin() + std::min(end + step, n),
+            [&](double value) { return value - center <= radius; }) -
+        values.begin();
+  return end - begin;
+}
+
+double DiscreteDiscreteMi(const Variable& x, const Variable& y) {
+  const size_t n = x.codes.size();
+  absl::flat_hash_map<int64, int> joint_counts;
+  std::vector<int> x_counts(x.num_codes);
+  std::vector<int> y_counts(y.num_codes);
+  for (size_t i = 0; i < n; ++i) {
+    ++joint_counts[int64{x.codes[i]} * y.num_codes + y.codes[i]];
+    ++x_counts[x.codes[i]];
+    ++y_counts[y.codes[i]];
+  }
+  double mi = 0;
+  for (const auto& entry : joint_counts) {
+    const double count = entry.second;
+    mi += count / n *
+          std::log(count * n /
+                   (static_cast<double>(x_counts[entry.first / y.num_codes]) *
+                    y_counts[entry.first % y.num_codes]));
+  }
+  return std::max(0.0, mi);
+}
+
+// The edges of the columns (or rows) of a grid of <grid_size> columns
+// holding about as many of <values> each. The outer edges are infinite.
+std::vector<double> GridEdges(const std::vector<double>& values,
+                              int grid_size) {
+  std::vector<double> sorted = values;
+  std::sort(sorted.begin(), sorted.end());
+  std::vector<double> edges(grid_size + 1);
+  edges.front() = -std::numeric_limits<double>::infinity();
+  edges.back() = std::numeric_limits<double>::infinity();
+  for (int c = 1; c < grid_size; ++c) {
+    edges[c] = sorted[int64{c} * sorted.size() / grid_size];
+  }
+  return edges;
+}
+
+// The column (or row) of the grid with <edges> containing <value>.
+int GridCell(const std::vector<double>& edges, double value) {
+  return std::upper_bound(edges.begin() + 1, edges.end() - 1, value) -
+         (edges.begin() + 1);
+}
+
+// Returns the distance in the max-norm from each point (x[i], y[i]) to its
+// k-th nearest neighbor. The points are bucketed in a grid whose rows and
+// columns hold about as many points each, k per cell on average. The cells
+// around each point are searched in rings of increasing size, until the
+// unsearched cells are farther than the k-th nearest neighbor found.
+std::vector<double> KthNeighborDistances(const std::vector<double>& x,
+                                         const std::vector<double>& y,
+                                         int k) {
+  const int n = x.size();
+  const int grid_size =
+      std::max(1, static_cast<int>(std::sqrt(n / static_cast<double>(k))));
+  const std::vector<double> x_edges = GridEdges(x, grid_size);
+  const std::vector<double> y_edges = GridEdges(y, grid_size);
+
+  // The points, sorted by cell.
+  std::vector<int> cell_x(n);
+  std::vector<int> cell_y(n);
+  std::vector<int> cell_start(grid_size * grid_size + 1);
+  for (int i = 0; i < n; ++i) {
+    cell_x[i] = GridCell(x_edges, x[i]);
+    cell_y[i] = GridCell(y_edges, y[i]);
+    ++cell_start[cell_y[i] * grid_size + cell_x[i] + 1];
+  }
+  std::partial_sum(cell_start.begin(), cell_start.end(), cell_start.begin());
+  std::vector<int> next = cell_start;
+  std::vector<int> cell_ids(n);
+  std::vector<double> cell_xs(n);
+  std::vector<double> cell_ys(n);
+  for (int i = 0; i < n; ++i) {
+    const int p = next[cell_y[i] * grid_size + cell_x[i]]++;
+    cell_ids[p] = i;
+    cell_xs[p] = x[i];
+    cell_ys[p] = y[i];
+  }
+
+  const size_t num_neighbors = k;
+  std::vector<double> result(n);
+  // The distances to the k nearest neighbors found so far, in order.
+  std::vector<double> nearest;
+  nearest.reserve(k + 1);
+  for (int i = 0; i < n; ++i) {
+    nearest.clear();
+    const int cx = cell_x[i];
+    const int cy = cell_y[i];
+    for (int r = 0;; ++r) {
+      for (int gy = std::max(cy - r, 0); gy <= std::min(cy + r, grid_size - 1);
+           ++gy) {
+        // Only the first and the last cells of the inner rows of the ring.
+        const int step = (gy == cy - r || gy == cy + r) ? 1 : 2 * r;
+        for (int gx = cx - r; gx <= cx + r; gx += step) {
+          if (gx < 0 || gx >= grid_size) {
+            continue;
+          }
+          const int cell = gy * grid_size + gx;
+          for (int p = cell_start[cell]; p < cell_start[cell + 1]; ++p) {
+            if (cell_ids[p] == i) {
+              continue;
+            }
+            const double distance = std::max(std::abs(cell_xs[p] - x[i]),
+                                             std::abs(cell_ys[p] - y[i]));
+            if (nearest.size() == num_neighbors &&
+                distance >= nearest.back()) {
+              continue;
+            }
+            nearest.insert(
+                std::upper_bound(nearest.begin(), nearest.end(), distance),
+                distance);
+            if (nearest.size() > num_neighbors) {
+              nearest.pop_back();
+            }
+          }
+        }
+      }
+      // The distance to the closest unsearched cell.
+      const double bound = std::min(
+          {x[i] - x_edges[std::max(cx - r, 0)],
+           x_edges[std::min(cx + r + 1, grid_size)] - x[i],
+           y[i] - y_edges[std::max(cy - r, 0)],
+           y_edges[std::min(cy + r + 1, grid_size)] - y[i]});
+      if (std::isinf(bound) ||
+          (nearest.size() == num_neighbors && nearest.back() <= bound)) {
+        break;
+      }
+    }
+    result[i] = nearest.back();
+  }
+  return result;
+}
+
+// The Kraskov et al. estimator.
+double ContinuousContinuousMi(const Variable& x, const Variable& y, int k,
+                              const std::vector<double>& digamma) {
+  const size_t n = x.values.size();
+  const SortedValues sorted_x = Sort(x.values);
+  const SortedValues sorted_y = Sort(y.values);
+  const std::vector<double> distances =
+      KthNeighborDistances(x.values, y.values, k);
+  double sum_digamma_x = 0;
+  double sum_digamma_y = 0;
+  for (size_t i = 0; i < n; ++i) {
+    const double radius = std::nextafter(distances[i], 0.0);
+    sum_digamma_x += digamma[CountWithin(sorted_x, i, radius)];
+    sum_digamma_y += digamma[CountWithin(sorted_y, i, radius)];
+  }
+  return std::max(0.0, digamma[n] + digamma[k] - sum_digamma_x / n -
+                           sum_digamma_y / n);
+}
+
+// The Ross estimator. Examples whose category occurs once are ignored.
+double ContinuousDiscreteMi(const Variable& c, const Variable& d, int k,
+                            const std::vector<double>& digamma) {
+  const size_t n = c.values.size();
+  std::vector<std::vector<double>> groups(d.num_codes);
+  for (size_t i = 0; i < n; ++i) {
+    groups[d.codes[i]].push_back(c.values[i]);
+  }
+  std::vector<double> kept_values;
+  std::vector<double> radii;
+  double sum_digamma_k = 0;
+  double sum_digamma_count = 0;
+  for (std::vector<double>& group : groups) {
+    const size_t count = group.size();
+    if (count <= 1) {
+      continue;
+    }
+    const int group_k = std::min<size_t>(k, count - 1);
+    std::sort(group.begin(), group.end());
+    for (size_t p = 0; p < count; ++p) {
+      size_t left = p;
+      size_t right = p + 1;
+      double distance = 0;
+      for (int found = 0; found < group_k; ++found) {
+        const double left_distance =
+            left > 0 ? group[p] - group[left - 1]
+                     : std::numeric_limits<double>::infinity();
+        const double right_distance =
+            right < count ? group[right] - group[p]
+                          : std::numeric_limits<double>::infinity();
+        if (left_distance <= right_distance) {
+          distance = left_distance;
+          --left;
+        } else {
+          distance = right_distance;
+          ++right;
+        }
+      }
+      kept_values.push_back(group[p]);
+      radii.push_back(std::nextafter(distance, 0.0));
+      sum_digamma_k += digamma[group_k];
+      sum_digamma_count += digamma[count];
+    }
+  }
+  const size_t num_kept = kept_values.size();
+  if (num_kept == 0) {
+    return 0;
+  }
+  const SortedValues sorted = Sort(kept_values);
+  double sum_digamma_m = 0;
+  for (size_t i = 0; i < num_kept; ++i) {
+    sum_digamma_m += digamma[CountWithin(sorted, i, radii[i])];
+  }
+  return std::max(0.0, digamma[num_kept] + sum_digamma_k / num_kept -
+                           sum_digamma_count / num_kept -
+                           sum_digamma_m / num_kept);
+}
+
+// <digamma> is the DigammaTable of the number of examples.
+double EstimateMi(const Variable& x, const Variable& y, int k,
+                  const std::vector<double>& digamma) {
+  if (x.is_discrete && y.is_discrete) {
+    return DiscreteDiscreteMi(x, y);
+  } else if (x.is_discrete) {
+    return ContinuousDiscreteMi(y, x, k, digamma);
+  } else if (y.is_discrete) {
+    return ContinuousDiscreteMi(x, y, k, digamma);
+  }
+  return ContinuousContinuousMi(x, y, k, digamma);
+}
+
+}  // namespace
+
+Status ComputeMutualInformation(
+    const std::vector<MutualInformationColumn>& features,
+    const MutualInformationColumn& label,
+    const MutualInformationOptions& options,
+    std::vector<absl::optional<MutualInformationResult>>* results) {
+  results->assign(features.size(), absl::nullopt);
+  const size_t n = label.values.size();
+  for (size_t i = 0; i < features.size(); ++i) {
+    if (features[i].values.size() != n) {
+      return errors::InvalidArgument("Feature ", i, " has ",
+                                     features[i].values.size(),
+                                     " values, but the label has ", n, ".");
+    }
+  }
+  if (options.num_neighbors < 1) {
+    return errors::InvalidArgument("num_neighbors must be positive, got ",
+                                   options.num_neighbors, ".");
+  }
+  if (n == 0 || (!label.is_discrete &&
+                 n <= static_cast<size_t>(options.num_neighbors))) {
+    return Status::OK();
+  }
+
+  std::mt19937_64 rng(options.seed);
+  Variable label_variable;
+  Prepare(label, &rng, &label_variable);
+  Variable shuffled_label = label_variable;
+  std::shuffle(shuffled_label.values.begin(), shuffled_label.values.end(),
+               rng);
+  std::shuffle(shuffled_label.codes.begin(), shuffled_label.codes.end(), rng);
+
+  const std::vector<double> digamma = DigammaTable(n);
+  const auto estimate = [&](size_t i) {
+    const MutualInformationColumn& feature = features[i];
+    Variable variable;
+    std::seed_seq seed{options.seed, uint64{i} + 1};
+    std::mt19937_64 feature_rng(seed);
+    Prepare(feature, &feature_rng, &variable);
+    // A discrete feature with all values unique has no neighbors.
+    if (variable.is_discrete && !label.is_discrete &&
+        static_cast<size_t>(variable.num_codes) == n) {
+      return;
+    }
+    MutualInformationResult result;
+    result.mutual_information =
+        EstimateMi(variable, label_variable, options.num_neighbors, digamma);
+    result.shuffled_mutual_information =
+        EstimateMi(variable, shuffled_label, options.num_neighbors, digamma);
+    (*results)[i] = result;
+  };
+
+  const int num_threads = std::min<int>(
+      options.num_threads == 0 ? port::MaxParallelism() : options.num_threads,
+      features.size());
+  if (num_threads <= 1) {
+    for (size_t i = 0; i < features.size(); ++i) {
+      estimate(i);
+    }
+    return Status::OK();
+  }
+  thread::ThreadPool pool(Env::Default(), "mutual_information", num_threads);
+  for (size_t i = 0; i < features.size(); ++i) {
+    pool.Schedule([&estimate, i]() { estimate(i); });
+  }
+  return Status::OK();
+}
+
+}  // namespace data_validation
+}  // namespace tensorflow
@@ -0,0 +1,75 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Estimates the mutual information (MI) between features and a label, as
+// sklearn's mutual_info_classif and mutual_info_regression do: with the
+// k-nearest-neighbors estimators of Kraskov et al. (continuous variables) and
+// Ross (one continuous and one discrete variable), and from the contingency
+// table for two discrete variables. As a baseline for the adjusted MI, the MI
+// with randomly shuffled labels is estimated in the same pass.
+#ifndef TENSORFLOW_DATA_VALIDATION_ANOMALIES_MUTUAL_INFORMATION_H_
+#define TENSORFLOW_DATA_VALIDATION_ANOMALIES_MUTUAL_INFORMATION_H_
+
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+// The values of a feature or of the label, one per example.
+struct MutualInformationColumn {
+  // Missing values of continuous columns are NaN, and are imputed with ten
+  // times the maximum value, far from the observed values.
+  std::vector<double> values;
+  // If true, the values are the (arbitrary) codes of the categories of a
+  // discrete variable, and missing values have their own code.
+  bool is_discrete = false;
+};
+
+struct MutualInformationOptions {
+  // The number of neighbors of the estimators of continuous variables.
+  int num_neighbors = 3;
+  // Seeds the noise breaking the ties between continuous values, and the
+  // shuffling of the labels.
+  uint64 seed = 0;
+  // The number of threads the features are split between. If 0, the number
+  // of cores is used.
+  int num_threads = 0;
+};
+
+struct MutualInformationResult {
+  double mutual_information = 0;
+  // The MI with the labels shuffled, which is the MI expected by chance.
+  double shuffled_mutual_information = 0;
+};
+
+// Estimates the MI between each of <features> and <label>. (*results)[i] is
+// the MI of features[i], or nullopt if it cannot be estimated: with a
+// continuous label, for discrete features with all values unique and if there
+// are not more examples than neighbors. Returns InvalidArgument if the columns
+// have different sizes.
+Status ComputeMutualInformation(
+    const std::vector<MutualInformationColumn>& features,
+    const MutualInformationColumn& label,
+    const MutualInformationOptions& options,
+    std::vector<absl::optional<MutualInformationResult>>* results);
+
+}  // namespace data_validation
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_DATA_VALIDATION_ANOMALIES_MUTUAL_INFORMATION_H_
@@ -0,0 +1,172 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/mutual_information.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+
+namespace tensorflow {
+namespace data_validation {
+namespace {
+
+MutualInformationColumn MakeColumn(const std::vector<double>& values,
+                                   bool is_discrete) {
+  MutualInformationColumn column;
+  column.values = values;
+  column.is_discrete = is_discrete;
+  return column;
+}
+
+// The labels and the codes of a feature mapping directly onto them, as in
+// sklearn_mutual_information_test.py.
+const std::vector<double> kLabels = {0, 2, 0, 1, 2, 1, 1, 0, 2, 1, 0};
+const std::vector<double> kPerfectFeature = {5, 7, 5, 6, 7, 6, 6, 5, 7, 6, 5};
+
+TEST(MutualInformationTest, DiscreteFeatureAndDiscreteLabel) {
+  std::vector<absl::optional<MutualInformationResult>> results;
+  TF_ASSERT_OK(ComputeMutualInformation(
+      {MakeColumn(kPerfectFeature, true)}, MakeColumn(kLabels, true),
+      MutualInformationOptions(), &results));
+  ASSERT_EQ(results.size(), 1);
+  ASSERT_TRUE(results[0]);
+  // The entropy of the labels.
+  EXPECT_NEAR(results[0]->mutual_information, 1.0900597, 1e-6);
+  EXPECT_LT(results[0]->shuffled_mutual_information,
+            results[0]->mutual_information);
+}
+
+TEST(MutualInformationTest, DiscreteFeatureAndContinuousLabel) {
+  std::vector<absl::optional<MutualInformationResult>> results;
+  TF_ASSERT_OK(ComputeMutualInformation(
+      {MakeColumn(kPerfectFeature, true)}, MakeColumn(kLabels, false),
+      MutualInformationOptions(), &results));
+  ASSERT_EQ(results.size(), 1);
+  ASSERT_TRUE(results[0]);
+  EXPECT_GT(results[0]->mutual_information, 1);
+  EXPECT_LT(results[0]->shuffled_mutual_information,
+            results[0]->mutual_information);
+}
+
+TEST(MutualInformationTest, MissingDiscreteValues) {
+  // Missing values are a category of their own.
+  const double nan = std::nan("");
+  const MutualInformationColumn label =
+      MakeColumn({0, 2, 0, 1, 2, 1, 1}, false);
+  std::vector<absl::optional<MutualInformationResult>> results;
+  TF_ASSERT_OK(ComputeMutualInformation(
+      {MakeColumn({1, 2, nan, nan, 2, 3, 3}, true),
+       MakeColumn({1, 2, 4, 4, 2, 3, 3}, true)},
+      label, MutualInformationOptions(), &results));
+  ASSERT_TRUE(results[0]);
+  ASSERT_TRUE(results[1]);
+  EXPECT_DOUBLE_EQ(results[0]->mutual_information,
+                   results[1]->mutual_information);
+}
+
+TEST(MutualInformationTest, MissingContinuousValues) {
+  // Missing values are imputed with ten times the maximum value.
+  const double nan = std::nan("");
+  const MutualInformationColumn label = MakeColumn({0, 1, 0, 1, 0, 1}, true);
+  std::vector<absl::optional<MutualInformationResult>> results;
+  TF_ASSERT_OK(ComputeMutualInformation(
+      {MakeColumn({0.1, 0.9, nan, 0.8, 0.2, nan}, false),
+       MakeColumn({0.1, 0.9, 9, 0.8, 0.2, 9}, false)},
+      label, MutualInformationOptions(), &results));
+  ASSERT_TRUE(results[0]);
+  ASSERT_TRUE(results[1]);
+  EXPECT_NEAR(results[0]->mutual_information, results[1]->mutual_information,
+              1e-6);
+}
+
+TEST(MutualInformationTest, ContinuousFeatures) {
+  // Bivariate normal variables with a correlation of rho have an MI of
+  // -log(1 - rho^2) / 2.
+  const double rho = 0.9;
+  std::mt19937_64 rng(42);
+  std::normal_distribution<double> normal;
+  std::vector<double> correlated, independent, label;
+  for (int i = 0; i < 2000; ++i) {
+    const double x = normal(rng);
+    correlated.push_back(x);
+    independent.push_back(normal(rng));
+    label.push_back(rho * x + std::sqrt(1 - rho * rho) * normal(rng));
+  }
+  std::vector<absl::optional<MutualInformationResult>> results;
+  MutualInformationOptions options;
+  options.num_threads = 2;
+  TF_ASSERT_OK(ComputeMutualInformation(
+      {MakeColumn(correlated, false), MakeColumn(independent, false)},
+      MakeColumn(label, false), options, &results));
+  ASSERT_EQ(results.size(), 2);
+  ASSERT_TRUE(results[0]);
+  ASSERT_TRUE(results[1]);
+  EXPECT_NEAR(results[0]->mutual_information,
+              -std::log(1 - rho * rho) / 2, 0.05);
+  EXPECT_LT(results[0]->shuffled_mutual_information, 0.05);
+  EXPECT_LT(results[1]->mutual_information, 0.05);
+}
+
+TEST(MutualInformationTest, ContinuousFeatureAndDiscreteLabel) {
+  // A feature separating two equally likely classes has an MI of log(2).
+  std::mt19937_64 rng(42);
+  std::normal_distribution<double> normal(0, 0.1);
+  std::vector<double> feature, label;
+  for (int i = 0; i < 1000; ++i) {
+    label.push_back(i % 2);
+    feature.push_back(i % 2 + normal(rng));
+  }
+  std::vector<absl::optional<MutualInformationResult>> results;
+  TF_ASSERT_OK(ComputeMutualInformation({MakeColumn(feature, false)},
+                                        MakeColumn(label, true),
+                                        MutualInformationOptions(), &results));
+  ASSERT_TRUE(results[0]);
+  EXPECT_NEAR(results[0]->mutual_information, std::log(2), 0.05);
+  EXPECT_LT(results[0]->shuffled_mutual_information, 0.05);
+}
+
+TEST(MutualInformationTest, SkipsUnsupportedFeatures) {
+  std::vector<absl::optional<MutualInformationResult>> results;
+  // All the values of the discrete feature are unique.
+  TF_ASSERT_OK(ComputeMutualInformation(
+      {MakeColumn({1, 2, 3, 4, 5}, true), MakeColumn({1, 1, 2, 2, 3}, false)},
+      MakeColumn({1, 2, 3, 4, 5}, false), MutualInformationOptions(),
+      &results));
+  ASSERT_EQ(results.size(), 2);
+  EXPECT_FALSE(results[0]);
+  EXPECT_TRUE(results[1]);
+  // Not more examples than neighbors.
+  TF_ASSERT_OK(ComputeMutualInformation({MakeColumn({1, 2, 3}, false)},
+                                        MakeColumn({1, 2, 3}, false),
+                                        MutualInformationOptions(), &results));
+  ASSERT_EQ(results.size(), 1);
+  EXPECT_FALSE(results[0]);
+}
+
+TEST(MutualInformationTest, MismatchedSizes) {
+  std::vector<absl::optional<MutualInformationResult>> results;
+  EXPECT_TRUE(errors::IsInvalidArgument(ComputeMutualInformation(
+      {MakeColumn({1, 2}, false)}, MakeColumn({1, 2, 3}, false),
+      MutualInformationOptions(), &results)));
+}
+
+}  // namespace
+}  // namespace data_validation
+}  // namespace tensorflow
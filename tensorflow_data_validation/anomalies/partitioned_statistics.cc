@@ -0,0 +1,169 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/partitioned_statistics.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "tensorflow/core/lib/core/errors.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+namespace {
+
+using metadata::v0::DatasetFeatureStatistics;
+using metadata::v0::FeatureNameStatistics;
+
+// Returns the median of <values>, which must not be empty. Reorders <values>.
+double Median(std::vector<double>* values) {
+  const size_t middle = values->size() / 2;
+  std::nth_element(values->begin(), values->begin() + middle, values->end());
+  const double upper = (*values)[middle];
+  if (values->size() % 2 == 1) {
+    return upper;
+  }
+  // The lower middle value is the largest of the values before the middle.
+  const double lower = *std::max_element(values->begin(),
+                                         values->begin() + middle);
+  return (lower + upper) / 2;
+}
+
+}  // namespace
+
+void PartitionedStatisticsCombiner::Add(
+    const DatasetFeatureStatistics& statistics) {
+  for (const FeatureNameStatistics& feature : statistics.features()) {
+    std::map<string, std::vector<double>>* feature_values = nullptr;
+    for (const auto& custom_stat : feature.custom_stats()) {
+      if (custom_stat.val_case() != metadata::v0::CustomStatistic::kNum) {
+        continue;
+      }
+      if (feature_values == nullptr) {
+        feature_values = &values_[Path(feature.path())];
+      }
+      (*feature_values)[custom_stat.name()].push_back(custom_stat.num());
+    }
+  }
+}
+
+Status PartitionedStatisticsCombiner::Add(
+    const string& serialized_statistics) {
+  DatasetFeatureStatistics statistics;
+  if (!statistics.ParseFromString(serialized_statistics)) {
+    return errors::InvalidArgument(
+        "Failed to parse DatasetFeatureStatistics.");
+  }
+  Add(statistics);
+  return Status::OK();
+}
+
+void PartitionedStatisticsCombiner::Merge(
+    const PartitionedStatisticsCombiner& other) {
+  for (const auto& feature : other.values_) {
+    std::map<string, std::vector<double>>& feature_values =
+        values_[feature.first];
+    for (const auto& statistic : feature.second) {
+      std::vector<double>& values = feature_values[statistic.first];
+      values.insert(values.end(), statistic.second.begin(),
+                    statistic.second.end());
+    }
+  }
+}
+
+DatasetFeatureStatistics PartitionedStatisticsCombiner::Summarize(
+    int min_partitions_stat_presence) const {
+  DatasetFeatureStatistics result;
+  for (const auto& feature : values_) {
+    // Ordered by name, as the statistics of the feature.
+    std::map<string, double> summary;
+    for (const auto& statistic : feature.second) {
+      std::vector<double> values = statistic.second;
+      if (values.empty() ||
+          values.size() < static_cast<size_t>(min_partitions_stat_presence)) {
+        continue;
+      }
+      const double count = values.size();
+      double sum = 0;
+      for (const double value : values) {
+        sum += value;
+      }
+      const double mean = sum / count;
+      double sum_squared_deviations = 0;
+      for (const double value : values) {
+        sum_squared_deviations += (value - mean) * (value - mean);
+      }
+      const string& name = statistic.first;
+      summary["min_" + name] = *std::min_element(values.begin(), values.end());
+      summary["max_" + name] = *std::max_element(values.begin(), values.end());
+      summary["mean_" + name] = mean;
+      summary["median_" + name] = Median(&values);
+      summary["std_dev_" + name] = std::sqrt(sum_squared_deviations / count);
+      summary["num_partitions_" + name] = count;
+    }
+    if (summary.empty()) {
+      continue;
+    }
+    FeatureNameStatistics* feature_statistics = result.add_features();
+    *feature_statistics->mutable_path() = feature.first.AsProto();
+    for (const auto& meta_statistic : summary) {
+      auto* custom_stat = feature_statistics->add_custom_stats();
+      custom_stat->set_name(meta_statistic.first);
+      custom_stat->set_num(meta_statistic.second);
+    }
+  }
+  return result;
+}
+
+void PartitionedStatisticsCombiner::ToProto(
+    PartitionedStatisticsValues* proto) const {
+  proto->Clear();
+  for (const auto& feature : values_) {
+    PartitionedStatisticsValues::Feature* feature_proto = proto->add_features();
+    *feature_proto->mutable_path() = feature.first.AsProto();
+    for (const auto& statistic : feature.second) {
+      PartitionedStatisticsValues::Statistic* statistic_proto =
+          feature_proto->add_statistics();
+      statistic_proto->set_name(statistic.first);
+      *statistic_proto->mutable_values() = {statistic.second.begin(),
+                                            statistic.second.end()};
+    }
+  }
+}
+
+Status PartitionedStatisticsCombiner::FromProto(
+    const PartitionedStatisticsValues& proto,
+    PartitionedStatisticsCombiner* result) {
+  result->values_.clear();
+  for (const PartitionedStatisticsValues::Feature& feature : proto.features()) {
+    std::map<string, std::vector<double>>& feature_values =
+        result->values_[Path(feature.path())];
+    for (const PartitionedStatisticsValues::Statistic& statistic :
+         feature.statistics()) {
+      if (feature_values.count(statistic.name()) > 0) {
+        return errors::InvalidArgument("Duplicate statistic ",
+                                       statistic.name(), " of feature ",
+                                       Path(feature.path()).Serialize());
+      }
+      feature_values[statistic.name()] = {statistic.values().begin(),
+                                          statistic.values().end()};
+    }
+  }
+  return Status::OK();
+}
+
+}  // namespace data_validation
+}  // namespace tensorflow
@@ -0,0 +1,69 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Summarizes the custom statistics computed over the partitions of a dataset
+// (see NonStreamingCustomStatsGenerator), to estimate their value over the
+// whole dataset.
+#ifndef TENSORFLOW_DATA_VALIDATION_ANOMALIES_PARTITIONED_STATISTICS_H_
+#define TENSORFLOW_DATA_VALIDATION_ANOMALIES_PARTITIONED_STATISTICS_H_
+
+#include <map>
+#include <vector>
+
+#include "tensorflow_data_validation/anomalies/path.h"
+#include "tensorflow_data_validation/anomalies/proto/partitioned_statistics.pb.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow_metadata/proto/v0/statistics.pb.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+// Accumulates the values of the numeric custom statistics of the partitions,
+// and computes their min, max, mean, median, standard deviation and number of
+// partitions.
+class PartitionedStatisticsCombiner {
+ public:
+  // Adds the custom statistics computed over a partition. The custom
+  // statistics which do not hold a number are ignored.
+  void Add(const metadata::v0::DatasetFeatureStatistics& statistics);
+  // Same as above, but takes a serialized DatasetFeatureStatistics.
+  Status Add(const string& serialized_statistics);
+
+  void Merge(const PartitionedStatisticsCombiner& other);
+
+  // Returns the meta-statistics of the statistics computed in at least
+  // <min_partitions_stat_presence> partitions, as the custom statistics
+  // "min_<name>", "max_<name>", "mean_<name>", "median_<name>",
+  // "std_dev_<name>" and "num_partitions_<name>". The median is exact, and
+  // the standard deviation is that of the population. The features are
+  // ordered by path and their custom statistics by name, and the features
+  // without meta-statistics are omitted.
+  metadata::v0::DatasetFeatureStatistics Summarize(
+      int min_partitions_stat_presence) const;
+
+  void ToProto(PartitionedStatisticsValues* proto) const;
+  static Status FromProto(const PartitionedStatisticsValues& proto,
+                          PartitionedStatisticsCombiner* result);
+
+ private:
+  // The values of the statistics of each feature, by statistic name.
+  std::map<Path, std::map<string, std::vector<double>>> values_;
+};
+
+}  // namespace data_validation
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_DATA_VALIDATION_ANOMALIES_PARTITIONED_STATISTICS_H_
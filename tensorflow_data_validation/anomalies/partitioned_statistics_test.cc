@@ -0,0 +1,154 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/partitioned_statistics.h"
+
+#include <string>
+
+#include <gtest/gtest.h>
+#include "tensorflow_data_validation/anomalies/proto/partitioned_statistics.pb.h"
+#include "tensorflow_data_validation/anomalies/test_util.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow_metadata/proto/v0/statistics.pb.h"
+
+namespace tensorflow {
+namespace data_validation {
+namespace {
+
+using ::tensorflow::metadata::v0::DatasetFeatureStatistics;
+using testing::EqualsProto;
+using testing::ParseTextProtoOrDie;
+
+TEST(PartitionedStatisticsCombinerTest, Summarize) {
+  PartitionedStatisticsCombiner combiner;
+  combiner.Add(ParseTextProtoOrDie<DatasetFeatureStatistics>(R"(
+    features {
+      path { step: "valid_feature" }
+      custom_stats { name: "MI" num: 0.5 }
+      custom_stats { name: "Cov" num: 1 }
+    }
+    features {
+      path { step: "invalid_feature" }
+      custom_stats { name: "MI" num: 0.5 }
+    })"));
+  combiner.Add(ParseTextProtoOrDie<DatasetFeatureStatistics>(R"(
+    features {
+      path { step: "valid_feature" }
+      custom_stats { name: "MI" num: 1.5 }
+      custom_stats { name: "Cov" num: 3 }
+      custom_stats { name: "description" str: "ignored" }
+    })"));
+  EXPECT_THAT(combiner.Summarize(/*min_partitions_stat_presence=*/2),
+              EqualsProto(R"(
+                features {
+                  path { step: "valid_feature" }
+                  custom_stats { name: "max_Cov" num: 3 }
+                  custom_stats { name: "max_MI" num: 1.5 }
+                  custom_stats { name: "mean_Cov" num: 2 }
+                  custom_stats { name: "mean_MI" num: 1 }
+                  custom_stats { name: "median_Cov" num: 2 }
+                  custom_stats { name: "median_MI" num: 1 }
+                  custom_stats { name: "min_Cov" num: 1 }
+                  custom_stats { name: "min_MI" num: 0.5 }
+                  custom_stats { name: "num_partitions_Cov" num: 2 }
+                  custom_stats { name: "num_partitions_MI" num: 2 }
+                  custom_stats { name: "std_dev_Cov" num: 1 }
+                  custom_stats { name: "std_dev_MI" num: 0.5 }
+                })"));
+}
+
+TEST(PartitionedStatisticsCombinerTest, SummarizeOrdersFeaturesByPath) {
+  PartitionedStatisticsCombiner combiner;
+  for (const double value : {4, 1, 3}) {
+    DatasetFeatureStatistics statistics;
+    for (const char* step : {"b", "a"}) {
+      auto* feature = statistics.add_features();
+      feature->mutable_path()->add_step(step);
+      auto* custom_stat = feature->add_custom_stats();
+      custom_stat->set_name("x");
+      custom_stat->set_num(value);
+    }
+    combiner.Add(statistics);
+  }
+  const DatasetFeatureStatistics summary =
+      combiner.Summarize(/*min_partitions_stat_presence=*/1);
+  ASSERT_EQ(summary.features_size(), 2);
+  EXPECT_EQ(summary.features(0).path().step(0), "a");
+  EXPECT_EQ(summary.features(1).path().step(0), "b");
+  // The median of an odd number of values is the middle one.
+  EXPECT_EQ(summary.features(0).custom_stats(2).name(), "median_x");
+  EXPECT_EQ(summary.features(0).custom_stats(2).num(), 3);
+}
+
+TEST(PartitionedStatisticsCombinerTest, MergeAndProtoRoundTrip) {
+  const DatasetFeatureStatistics partition_1 =
+      ParseTextProtoOrDie<DatasetFeatureStatistics>(R"(
+        features {
+          path { step: "a" }
+          custom_stats { name: "x" num: 1 }
+        })");
+  const DatasetFeatureStatistics partition_2 =
+      ParseTextProtoOrDie<DatasetFeatureStatistics>(R"(
+        features {
+          path { step: "a" step: "b" }
+          custom_stats { name: "x" num: 2 }
+        }
+        features {
+          path { step: "a" }
+          custom_stats { name: "x" num: 4 }
+        })");
+  PartitionedStatisticsCombiner combined;
+  combined.Add(partition_1);
+  combined.Add(partition_2);
+
+  PartitionedStatisticsCombiner left;
+  left.Add(partition_1);
+  PartitionedStatisticsCombiner right;
+  TF_ASSERT_OK(right.Add(partition_2.SerializeAsString()));
+  PartitionedStatisticsValues right_proto;
+  right.ToProto(&right_proto);
+  PartitionedStatisticsCombiner right_copy;
+  TF_ASSERT_OK(
+      PartitionedStatisticsCombiner::FromProto(right_proto, &right_copy));
+  left.Merge(right_copy);
+
+  PartitionedStatisticsValues expected;
+  combined.ToProto(&expected);
+  PartitionedStatisticsValues actual;
+  left.ToProto(&actual);
+  EXPECT_THAT(actual, EqualsProto(expected));
+  EXPECT_THAT(left.Summarize(/*min_partitions_stat_presence=*/1),
+              EqualsProto(combined.Summarize(
+                  /*min_partitions_stat_presence=*/1)));
+}
+
+TEST(PartitionedStatisticsCombinerTest, InvalidInputs) {
+  PartitionedStatisticsCombiner combiner;
+  EXPECT_FALSE(combiner.Add("not a proto").ok());
+  PartitionedStatisticsCombiner result;
+  EXPECT_FALSE(PartitionedStatisticsCombiner::FromProto(
+                   ParseTextProtoOrDie<PartitionedStatisticsValues>(R"(
+                     features {
+                       path { step: "a" }
+                       statistics { name: "x" values: 1 }
+                       statistics { name: "x" values: 2 }
+                     })"),
+                   &result)
+                   .ok());
+}
+
+}  // namespace
+}  // namespace data_validation
+}  // namespace tensorflow
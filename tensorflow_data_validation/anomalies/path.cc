@@ -17,12 +17,7 @@ limitations under the License.
 
 #include <algorithm>
 
-#include "absl/strings/str_cat.h"
-#include "absl/strings/str_join.h"
-#include "absl/strings/str_replace.h"
-#include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
-#include "re2/re2.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
 
@@ -30,89 +25,162 @@ namespace tensorflow {
 namespace data_validation {
 namespace {
 
-// This matches a standard step.
-// Standard steps include any proto steps (extensions and regular fields).
-// Standard steps either begin or end with parentheses with none on the inside
-// or they have no parentheses, dot, or single quotes.
-static const LazyRE2 kStandardStep = {R"((\([^()]*\))|([^().']+))",
-                                      RE2::Latin1};
-
-// This matches a serialized step with quotes.
-// This begins and ends with a single quote, and all internal single quotes are
-// doubled.
-static const LazyRE2 kSerializedWithQuotes = {"'(('')|[^'])*'", RE2::Latin1};
-
-// This matches a serialized step and the next dot.
-// Note that this is the union of the above two regexes followed by a dot.
-static const LazyRE2 kSerializedStepAndDot = {
-    R"(((('(('')|[^'])*')|(\([^()]*\))|([^()'.]+))\.))", RE2::Latin1};
+// The characters that cannot appear in an unquoted step, except as the
+// enclosing parentheses of a proto step.
+bool IsSpecialChar(char c) {
+  return c == '.' || c == '(' || c == ')' || c == '\'';
+}
 
 // Returns true if:
 // str is nonempty and has no ".", "(", ")", or "'", OR:
 // str starts with "(", ends with ")", and has no "(" or ")" in the interior.
-bool IsStandardStep(const string& str) {
-  return RE2::FullMatch(str, *kStandardStep);
+// Standard steps include any proto steps (extensions and regular fields).
+bool IsStandardStep(absl::string_view str) {
+  if (str.empty()) {
+    return false;
+  }
+  if (str.front() == '(') {
+    if (str.size() < 2 || str.back() != ')') {
+      return false;
+    }
+    const absl::string_view interior = str.substr(1, str.size() - 2);
+    return interior.find_first_of("()") == absl::string_view::npos;
+  }
+  return std::none_of(str.begin(), str.end(), IsSpecialChar);
 }
 
-string SerializeStep(const string& str) {
-  if (IsStandardStep(str)) {
-    return str;
+// Appends the serialization of a step to *result.
+void AppendSerializedStep(absl::string_view step, string* result) {
+  if (IsStandardStep(step)) {
+    result->append(step.data(), step.size());
+    return;
   }
   // Double any single quotes in the string, and encapsulate with single quotes.
-  return absl::StrCat("'", absl::StrReplaceAll(str, {{"'", "''"}}), "'");
+  result->push_back('\'');
+  for (const char c : step) {
+    if (c == '\'') {
+      result->push_back('\'');
+    }
+    result->push_back(c);
+  }
+  result->push_back('\'');
 }
 
-// Deserialize a step in-place.
-// If the step is in the standard format, do nothing.
-// Otherwise, remove beginning and ending quote and replace pairs of single
-// quotes with single quotes.
-tensorflow::Status DeserializeStep(string* to_modify) {
-  if (IsStandardStep(*to_modify)) {
+// Deserializes a step into *result.
+// If the step is in the standard format, copies it.
+// Otherwise, the step must begin and end with a single quote, and have all
+// interior single quotes doubled. Removes the beginning and ending quote, and
+// replaces pairs of single quotes with single quotes.
+tensorflow::Status DeserializeStep(absl::string_view str, string* result) {
+  if (IsStandardStep(str)) {
+    result->assign(str.data(), str.size());
     return Status::OK();
   }
-
-  // A legal serialized string here begins and ends with a single quote and
-  // has had all interior single quotes replaced with double quotes.
-  if (!RE2::FullMatch(*to_modify, *kSerializedWithQuotes)) {
-    return errors::InvalidArgument("Not a valid serialized step: ", *to_modify);
+  if (str.size() < 2 || str.front() != '\'' || str.back() != '\'') {
+    return errors::InvalidArgument("Not a valid serialized step: ", str);
+  }
+  result->clear();
+  const absl::string_view interior = str.substr(1, str.size() - 2);
+  for (size_t i = 0; i < interior.size(); ++i) {
+    if (interior[i] == '\'') {
+      if (i + 1 == interior.size() || interior[i + 1] != '\'') {
+        return errors::InvalidArgument("Not a valid serialized step: ", str);
+      }
+      ++i;
+    }
+    result->push_back(interior[i]);
   }
-  // Remove the first and last quote
-  const absl::string_view quotes_removed(to_modify->data() + 1,
-                                         to_modify->size() - 2);
-
-  // Replace each pair of quotes remaining with a single quote.
-  *to_modify = absl::StrReplaceAll(quotes_removed, {{"''", "'"}});
   return Status::OK();
 }
 
-// Find the next step delimiter.
-// See absl/strings/str_split.h
-// If the next step is not valid in some way,
-// return absl::string_view(text.end(), 0)
-struct StepDelimiter {
-  absl::string_view Find(absl::string_view text, size_t pos) {
-    if (pos >= text.size()) {
-      return absl::string_view(text.end(), 0);
+// Returns the position of the dot following the serialized step that starts
+// at <pos>, or npos if there is no such step followed by a dot. A serialized
+// step is either:
+// - a quoted step: a single quote, then any characters with single quotes
+//   doubled, then a single quote;
+// - a proto step: "(", then any characters but parentheses, then ")";
+// - any nonempty sequence of characters but ".", "(", ")" and "'".
+// If this returns npos, the rest of the string is the last step.
+size_t FindStepDelimiter(absl::string_view text, size_t pos) {
+  if (pos >= text.size()) {
+    return absl::string_view::npos;
+  }
+  size_t end = pos;
+  if (text[pos] == '\'') {
+    ++end;
+    while (end < text.size()) {
+      if (text[end] == '\'') {
+        if (end + 1 < text.size() && text[end + 1] == '\'') {
+          end += 2;
+          continue;
+        }
+        break;
+      }
+      ++end;
+    }
+    if (end == text.size()) {
+      return absl::string_view::npos;
+    }
+    // Skip the closing quote.
+    ++end;
+  } else if (text[pos] == '(') {
+    end = text.find_first_of("()", pos + 1);
+    if (end == absl::string_view::npos || text[end] != ')') {
+      return absl::string_view::npos;
     }
-    absl::string_view remaining_string = text.substr(pos);
-    absl::string_view solution;
-    // Regex captures a serialized step followed by a dot.
-    // Note that this only captures the step if it is not the last one. Since
-    // on no match we just have the rest of the string be a step, we are OK.
-    // Note that solution is a view into a view into the original text argument.
-    // Match(...,&solution, 1) will return 1 submatch (i.e. the substring of
-    // text matching the regular expression).
-    if (kSerializedStepAndDot->Match(remaining_string, 0,
-                                     remaining_string.size(), RE2::ANCHOR_START,
-                                     &solution, 1) &&
-        solution.data() != nullptr) {
-      // solution now contains the step and the dot after the step.
-      // Returns a string_view of text that is equal to ".".
-      return solution.substr(solution.size() - 1);
+    // Skip the closing parenthesis.
+    ++end;
+  } else {
+    while (end < text.size() && !IsSpecialChar(text[end])) {
+      ++end;
+    }
+    if (end == pos) {
+      return absl::string_view::npos;
+    }
+  }
+  if (end < text.size() && text[end] == '.') {
+    return end;
+  }
+  return absl::string_view::npos;
+}
+
+// Appends the serialization of <steps> to *result.
+void AppendSerializedPath(const std::vector<string>& steps, string* result) {
+  for (size_t i = 0; i < steps.size(); ++i) {
+    if (i > 0) {
+      result->push_back('.');
+    }
+    AppendSerializedStep(steps[i], result);
+  }
+}
+
+// Deserializes <str> into *steps, reusing its storage.
+tensorflow::Status DeserializeSteps(absl::string_view str,
+                                    std::vector<string>* steps) {
+  size_t num_steps = 0;
+  if (!str.empty()) {
+    size_t pos = 0;
+    while (true) {
+      const size_t delimiter = FindStepDelimiter(str, pos);
+      const size_t step_end =
+          delimiter == absl::string_view::npos ? str.size() : delimiter;
+      if (num_steps == steps->size()) {
+        steps->emplace_back();
+      }
+      TF_RETURN_IF_ERROR(DeserializeStep(str.substr(pos, step_end - pos),
+                                         &(*steps)[num_steps]));
+      ++num_steps;
+      if (delimiter == absl::string_view::npos) {
+        break;
+      }
+      // A trailing dot is followed by an (invalid) empty step.
+      pos = delimiter + 1;
     }
-    return absl::string_view(text.end(), 0);
   }
-};
+  steps->resize(num_steps);
+  return Status::OK();
+}
+
 }  // namespace
 
 Path::Path(const tensorflow::metadata::v0::Path& p)
@@ -151,12 +219,17 @@ bool operator<=(const Path& a, const Path& b) { return a.Compare(b) <= 0; }
 bool operator!=(const Path& a, const Path& b) { return a.Compare(b) != 0; }
 
 string Path::Serialize() const {
-  const string separator = ".";
-  std::vector<string> serialized_steps;
-  for (const string& step : step_) {
-    serialized_steps.push_back(SerializeStep(step));
+  string result;
+  AppendSerializedPath(step_, &result);
+  return result;
+}
+
+std::vector<string> Path::SerializeAll(const std::vector<Path>& paths) {
+  std::vector<string> result(paths.size());
+  for (size_t i = 0; i < paths.size(); ++i) {
+    AppendSerializedPath(paths[i].step_, &result[i]);
   }
-  return absl::StrJoin(serialized_steps, separator);
+  return result;
 }
 
 tensorflow::metadata::v0::Path Path::AsProto() const {
@@ -171,13 +244,18 @@ tensorflow::metadata::v0::Path Path::AsProto() const {
 // Note: for any path p:
 // p==Path::Deserialize(p.Serialize())
 tensorflow::Status Path::Deserialize(absl::string_view str, Path* result) {
-  result->step_.clear();
-  if (str.empty()) {
-    return Status::OK();
+  const tensorflow::Status status = DeserializeSteps(str, &result->step_);
+  if (!status.ok()) {
+    result->step_.clear();
   }
-  result->step_ = absl::StrSplit(str, StepDelimiter());
-  for (string& step : result->step_) {
-    TF_RETURN_IF_ERROR(DeserializeStep(&step));
+  return status;
+}
+
+tensorflow::Status Path::DeserializeAll(const std::vector<string>& strs,
+                                        std::vector<Path>* result) {
+  result->resize(strs.size());
+  for (size_t i = 0; i < strs.size(); ++i) {
+    TF_RETURN_IF_ERROR(DeserializeSteps(strs[i], &(*result)[i].step_));
   }
   return Status::OK();
 }
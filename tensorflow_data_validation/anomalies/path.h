@@ -73,6 +73,9 @@ class Path {
   // Number of steps in a path.
   size_t size() const { return step_.size(); }
 
+  // The steps of the path.
+  const std::vector<string>& steps() const { return step_; }
+
   // Since we store the steps with the separators, sometimes we need to remove
   // the separator.
   const string& last_step() const { return step_.back(); }
@@ -92,6 +95,14 @@ class Path {
   // EXPECT_EQ(p, p2);
   static tensorflow::Status Deserialize(absl::string_view str, Path* result);
 
+  // Serializes each of <paths>, as Serialize().
+  static std::vector<string> SerializeAll(const std::vector<Path>& paths);
+
+  // Deserializes each of <strs>, as Deserialize(). The storage of the paths
+  // already in *result is reused. On failure, *result is unspecified.
+  static tensorflow::Status DeserializeAll(const std::vector<string>& strs,
+                                           std::vector<Path>* result);
+
   // True if there are no steps.
   bool empty() const { return step_.empty(); }
 
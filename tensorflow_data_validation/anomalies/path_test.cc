@@ -14,8 +14,17 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow_data_validation/anomalies/path.h"
+
+#include <random>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "absl/strings/escaping.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+#include "absl/strings/str_replace.h"
+#include "absl/strings/str_split.h"
+#include "re2/re2.h"
 #include "tensorflow_data_validation/anomalies/test_util.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
@@ -27,6 +36,105 @@ namespace data_validation {
 namespace {
 using testing::ParseTextProtoOrDie;
 
+// The original, regex-based implementation of Serialize() and Deserialize(),
+// used as a reference for the hand-written one.
+namespace reference {
+
+static const LazyRE2 kStandardStep = {R"((\([^()]*\))|([^().']+))",
+                                      RE2::Latin1};
+static const LazyRE2 kSerializedWithQuotes = {"'(('')|[^'])*'", RE2::Latin1};
+static const LazyRE2 kSerializedStepAndDot = {
+    R"(((('(('')|[^'])*')|(\([^()]*\))|([^()'.]+))\.))", RE2::Latin1};
+
+bool IsStandardStep(const string& str) {
+  return RE2::FullMatch(str, *kStandardStep);
+}
+
+string SerializeStep(const string& str) {
+  if (IsStandardStep(str)) {
+    return str;
+  }
+  return absl::StrCat("'", absl::StrReplaceAll(str, {{"'", "''"}}), "'");
+}
+
+bool DeserializeStep(string* to_modify) {
+  if (IsStandardStep(*to_modify)) {
+    return true;
+  }
+  if (!RE2::FullMatch(*to_modify, *kSerializedWithQuotes)) {
+    return false;
+  }
+  const absl::string_view quotes_removed(to_modify->data() + 1,
+                                         to_modify->size() - 2);
+  *to_modify = absl::StrReplaceAll(quotes_removed, {{"''", "'"}});
+  return true;
+}
+
+struct StepDelimiter {
+  absl::string_view Find(absl::string_view text, size_t pos) {
+    if (pos >= text.size()) {
+      return absl::string_view(text.end(), 0);
+    }
+    absl::string_view remaining_string = text.substr(pos);
+    absl::string_view solution;
+    if (kSerializedStepAndDot->Match(remaining_string, 0,
+                                     remaining_string.size(), RE2::ANCHOR_START,
+                                     &solution, 1) &&
+        solution.data() != nullptr) {
+      return solution.substr(solution.size() - 1);
+    }
+    return absl::string_view(text.end(), 0);
+  }
+};
+
+string Serialize(const std::vector<string>& steps) {
+  std::vector<string> serialized_steps;
+  for (const string& step : steps) {
+    serialized_steps.push_back(SerializeStep(step));
+  }
+  return absl::StrJoin(serialized_steps, ".");
+}
+
+bool Deserialize(absl::string_view str, std::vector<string>* steps) {
+  steps->clear();
+  if (str.empty()) {
+    return true;
+  }
+  *steps = absl::StrSplit(str, StepDelimiter());
+  for (string& step : *steps) {
+    if (!DeserializeStep(&step)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace reference
+
+// Returns a random string over an alphabet made of the characters that are
+// special to the serialization, and a few others.
+string RandomString(std::mt19937* gen, int max_size) {
+  static const char kAlphabet[] = {'a', 'b', '.', '.', '(', ')', '\'', '\'',
+                                   '\0', '\n', '\xff'};
+  std::uniform_int_distribution<int> size_dist(0, max_size);
+  std::uniform_int_distribution<int> char_dist(0, sizeof(kAlphabet) - 1);
+  string result;
+  const int size = size_dist(*gen);
+  for (int i = 0; i < size; ++i) {
+    result.push_back(kAlphabet[char_dist(*gen)]);
+  }
+  return result;
+}
+
+std::vector<string> RandomSteps(std::mt19937* gen) {
+  std::uniform_int_distribution<int> size_dist(0, 4);
+  std::vector<string> result(size_dist(*gen));
+  for (string& step : result) {
+    step = RandomString(gen, 5);
+  }
+  return result;
+}
+
 MATCHER_P(EqualsPath, path,
           absl::StrCat((negation ? "doesn't equal" : "equals"),
                        path.Serialize())) {
@@ -140,6 +248,51 @@ TEST(Path, DeserializeBad) {
   }
 }
 
+TEST(Path, SerializeMatchesReference) {
+  std::mt19937 gen(1234);
+  for (int i = 0; i < 20000; ++i) {
+    const std::vector<string> steps = RandomSteps(&gen);
+    const string serialized = Path(steps).Serialize();
+    ASSERT_EQ(serialized, reference::Serialize(steps));
+    Path result;
+    TF_ASSERT_OK(Path::Deserialize(serialized, &result));
+    ASSERT_EQ(result, Path(steps)) << serialized;
+  }
+}
+
+TEST(Path, DeserializeMatchesReference) {
+  std::mt19937 gen(5678);
+  for (int i = 0; i < 50000; ++i) {
+    const string str = RandomString(&gen, 12);
+    std::vector<string> expected;
+    const bool expected_ok = reference::Deserialize(str, &expected);
+    Path result;
+    const tensorflow::Status status = Path::Deserialize(str, &result);
+    ASSERT_EQ(status.ok(), expected_ok) << absl::CEscape(str);
+    if (expected_ok) {
+      ASSERT_EQ(result, Path(expected)) << absl::CEscape(str);
+    } else {
+      EXPECT_EQ(status.code(), tensorflow::error::INVALID_ARGUMENT);
+    }
+  }
+}
+
+TEST(Path, SerializeAllAndDeserializeAll) {
+  const std::vector<Path> paths = {Path({"a", ".b", "'c'"}), Path(),
+                                   Path({""}), Path({"(x)", "y"})};
+  const std::vector<string> serialized = Path::SerializeAll(paths);
+  ASSERT_EQ(serialized.size(), paths.size());
+  for (int i = 0; i < paths.size(); ++i) {
+    EXPECT_EQ(serialized[i], paths[i].Serialize());
+  }
+  // Storage is reused, whatever the size of the result.
+  std::vector<Path> result = {Path({"to", "be", "replaced"})};
+  TF_ASSERT_OK(Path::DeserializeAll(serialized, &result));
+  EXPECT_EQ(result, paths);
+  EXPECT_EQ(Path::DeserializeAll({"a", "(b"}, &result).code(),
+            tensorflow::error::INVALID_ARGUMENT);
+}
+
 TEST(Path, GetParent) {
   EXPECT_EQ("a.b", Path({"a", "b", "c"}).GetParent().Serialize());
   EXPECT_EQ("a", Path({"a", "b"}).GetParent().Serialize());
@@ -80,42 +80,71 @@ bool ContainsValue(const Container& a, const string& value) {
   return absl::c_find(a, value) != a.end();
 }
 
-std::set<tensorflow::metadata::v0::FeatureType> AllowedFeatureTypes(
-    Feature::DomainInfoCase domain_info_case) {
+// Sets of FeatureTypes and of Feature::DomainInfoCases are represented as
+// bitmasks, so that checking them does not allocate.
+constexpr uint32 FeatureTypeBit(tensorflow::metadata::v0::FeatureType type) {
+  return uint32{1} << type;
+}
+
+constexpr uint64 DomainInfoCaseBit(Feature::DomainInfoCase domain_info_case) {
+  return uint64{1} << domain_info_case;
+}
+
+constexpr uint32 kBytesBit = FeatureTypeBit(tensorflow::metadata::v0::BYTES);
+constexpr uint32 kIntBit = FeatureTypeBit(tensorflow::metadata::v0::INT);
+constexpr uint32 kFloatBit = FeatureTypeBit(tensorflow::metadata::v0::FLOAT);
+constexpr uint32 kStructBit = FeatureTypeBit(tensorflow::metadata::v0::STRUCT);
+
+// The domains that BYTES features may have.
+constexpr uint64 kBytesDomainInfoCases =
+    DomainInfoCaseBit(Feature::DOMAIN_INFO_NOT_SET) |
+    DomainInfoCaseBit(Feature::kNaturalLanguageDomain) |
+    DomainInfoCaseBit(Feature::kImageDomain) |
+    DomainInfoCaseBit(Feature::kUrlDomain);
+
+constexpr uint32 AllowedFeatureTypes(Feature::DomainInfoCase domain_info_case) {
   switch (domain_info_case) {
     case Feature::kDomain:
-      return {tensorflow::metadata::v0::BYTES};
+      return kBytesBit;
     case Feature::kBoolDomain:
-      return {tensorflow::metadata::v0::INT, tensorflow::metadata::v0::BYTES,
-              tensorflow::metadata::v0::FLOAT};
+      return kIntBit | kBytesBit | kFloatBit;
     case Feature::kIntDomain:
-      return {tensorflow::metadata::v0::INT, tensorflow::metadata::v0::BYTES};
+      return kIntBit | kBytesBit;
     case Feature::kFloatDomain:
-      return {tensorflow::metadata::v0::FLOAT, tensorflow::metadata::v0::BYTES};
+      return kFloatBit | kBytesBit;
     case Feature::kStringDomain:
-      return {tensorflow::metadata::v0::BYTES};
+      return kBytesBit;
     case Feature::kStructDomain:
-      return {tensorflow::metadata::v0::STRUCT};
+      return kStructBit;
     case Feature::kNaturalLanguageDomain:
-      return {tensorflow::metadata::v0::BYTES};
+      return kBytesBit;
     case Feature::kImageDomain:
-      return {tensorflow::metadata::v0::BYTES};
+      return kBytesBit;
     case Feature::kMidDomain:
-      return {tensorflow::metadata::v0::BYTES};
+      return kBytesBit;
     case Feature::kUrlDomain:
-      return {tensorflow::metadata::v0::BYTES};
+      return kBytesBit;
     case Feature::kTimeDomain:
       // Consider also supporting time as floats.
-      return {tensorflow::metadata::v0::INT, tensorflow::metadata::v0::BYTES};
+      return kIntBit | kBytesBit;
     case Feature::DOMAIN_INFO_NOT_SET:
       ABSL_FALLTHROUGH_INTENDED;
     default:
-      return {tensorflow::metadata::v0::INT, tensorflow::metadata::v0::FLOAT,
-              tensorflow::metadata::v0::BYTES,
-              tensorflow::metadata::v0::STRUCT};
+      return kIntBit | kFloatBit | kBytesBit | kStructBit;
   }
 }
 
+bool IsAllowedFeatureType(Feature::DomainInfoCase domain_info_case,
+                          tensorflow::metadata::v0::FeatureType type) {
+  return type >= 0 && type < 32 &&
+         (AllowedFeatureTypes(domain_info_case) & FeatureTypeBit(type)) != 0;
+}
+
+bool IsAllowedBytesDomainInfoCase(Feature::DomainInfoCase domain_info_case) {
+  return domain_info_case < 64 &&
+         (kBytesDomainInfoCases & DomainInfoCaseBit(domain_info_case)) != 0;
+}
+
 // Remove all elements from the input array for which the input predicate
 // pred is true. Returns number of erased elements.
 template <typename T, typename Predicate>
@@ -135,10 +164,10 @@ int RemoveIf(::tensorflow::protobuf::RepeatedPtrField<T>* array,
   return end - i;
 }
 
-Feature* GetExistingFeatureHelper(
+const Feature* GetExistingFeatureHelper(
     const string& last_part,
-    tensorflow::protobuf::RepeatedPtrField<Feature>* features) {
-  for (tensorflow::metadata::v0::Feature& feature : *features) {
+    const tensorflow::protobuf::RepeatedPtrField<Feature>& features) {
+  for (const tensorflow::metadata::v0::Feature& feature : features) {
     if (feature.name() == last_part) {
       return &feature;
     }
@@ -160,11 +189,11 @@ void ClearStringDomainHelper(
   }
 }
 
-SparseFeature* GetExistingSparseFeatureHelper(
+const SparseFeature* GetExistingSparseFeatureHelper(
     const string& name,
-    tensorflow::protobuf::RepeatedPtrField<
-        tensorflow::metadata::v0::SparseFeature>* sparse_features) {
-  for (SparseFeature& sparse_feature : *sparse_features) {
+    const tensorflow::protobuf::RepeatedPtrField<
+        tensorflow::metadata::v0::SparseFeature>& sparse_features) {
+  for (const SparseFeature& sparse_feature : sparse_features) {
     if (sparse_feature.name() == name) {
       return &sparse_feature;
     }
@@ -274,10 +303,10 @@ tensorflow::Status Schema::UpdateFeature(
   return Status::OK();
 }
 
-bool Schema::FeatureIsDeprecated(const Path& path) {
-  Feature* feature = GetExistingFeature(path);
+bool Schema::FeatureIsDeprecated(const Path& path) const {
+  const Feature* feature = GetExistingFeature(path);
   if (feature == nullptr) {
-    SparseFeature* sparse_feature = GetExistingSparseFeature(path);
+    const SparseFeature* sparse_feature = GetExistingSparseFeature(path);
     if (sparse_feature != nullptr) {
       return ::tensorflow::data_validation::SparseFeatureIsDeprecated(
           *sparse_feature);
@@ -324,6 +353,23 @@ Schema::Updater::Updater(const FeatureStatisticsToProtoConfig& config)
     : config_(config),
       columns_to_ignore_(config.column_to_ignore().begin(),
                          config.column_to_ignore().end()) {
+  // By default, all anomalies are ERROR level.
+  severity_for_type_.fill(tensorflow::metadata::v0::AnomalyInfo::ERROR);
+  if (config_.new_features_are_warnings()) {
+    LOG(WARNING) << "new_features_are_warnings is deprecated. Use "
+                    "severity_overrides";
+    severity_for_type_[tensorflow::metadata::v0::AnomalyInfo::
+                           SCHEMA_NEW_COLUMN] =
+        tensorflow::metadata::v0::AnomalyInfo::WARNING;
+  }
+  // Later overrides take precedence.
+  for (const auto& severity_override : config_.severity_overrides()) {
+    if (tensorflow::metadata::v0::AnomalyInfo::Type_IsValid(
+            severity_override.type())) {
+      severity_for_type_[severity_override.type()] =
+          severity_override.severity();
+    }
+  }
   for (const ColumnConstraint& constraint : config.column_constraint()) {
     for (const PathProto& column_path : constraint.column_path()) {
       grouped_enums_[Path(column_path)] = constraint.enum_name();
@@ -337,22 +383,12 @@ void Schema::Updater::UpdateSeverityForAnomaly(
     const std::vector<Description>& descriptions,
     tensorflow::metadata::v0::AnomalyInfo::Severity* severity) const {
   for (const auto& description : descriptions) {
-    // By default, all anomalies are ERROR level.
-    tensorflow::metadata::v0::AnomalyInfo::Severity severity_for_anomaly =
-        tensorflow::metadata::v0::AnomalyInfo::ERROR;
-
-    if (config_.new_features_are_warnings() &&
-        (description.type ==
-         tensorflow::metadata::v0::AnomalyInfo::SCHEMA_NEW_COLUMN)) {
-      LOG(WARNING) << "new_features_are_warnings is deprecated. Use "
-                      "severity_overrides";
-      severity_for_anomaly = tensorflow::metadata::v0::AnomalyInfo::WARNING;
-    }
-    for (const auto& severity_override : config_.severity_overrides()) {
-      if (severity_override.type() == description.type) {
-        severity_for_anomaly = severity_override.severity();
-      }
-    }
+    const tensorflow::metadata::v0::AnomalyInfo::Severity
+        severity_for_anomaly =
+            tensorflow::metadata::v0::AnomalyInfo::Type_IsValid(
+                description.type)
+                ? severity_for_type_[description.type]
+                : tensorflow::metadata::v0::AnomalyInfo::ERROR;
     *severity = MaxSeverity(*severity, severity_for_anomaly);
   }
 }
@@ -503,7 +539,7 @@ std::vector<Path> Schema::GetAllRequiredFeatures(
 }
 
 std::vector<Path> Schema::GetMissingPaths(
-    const DatasetStatsView& dataset_stats) {
+    const DatasetStatsView& dataset_stats) const {
   std::set<Path> paths_present;
   for (const FeatureStatsView& feature_stats_view : dataset_stats.features()) {
     paths_present.insert(feature_stats_view.GetPath());
@@ -588,60 +624,57 @@ Status Schema::GetRelatedEnums(const DatasetStatsView& dataset_stats,
 
 tensorflow::metadata::v0::Schema Schema::GetSchema() const { return schema_; }
 
-bool Schema::FeatureExists(const Path& path) {
+bool Schema::FeatureExists(const Path& path) const {
   return GetExistingFeature(path) != nullptr ||
          GetExistingSparseFeature(path) != nullptr ||
          GetExistingWeightedFeature(path) != nullptr;
 }
 
-Feature* Schema::GetExistingFeature(const Path& path) {
+const Feature* Schema::GetExistingFeature(const Path& path) const {
   if (path.size() == 1) {
-    return GetExistingFeatureHelper(path.last_step(),
-                                    schema_.mutable_feature());
-  } else {
-    Path parent = path.GetParent();
-    Feature* parent_feature = GetExistingFeature(parent);
-    if (parent_feature == nullptr) {
-      return nullptr;
-    }
-    if (!parent_feature->has_struct_domain()) {
-      return nullptr;
-    }
-    return GetExistingFeatureHelper(
-        path.last_step(),
-        parent_feature->mutable_struct_domain()->mutable_feature());
+    return GetExistingFeatureHelper(path.last_step(), schema_.feature());
   }
-  return nullptr;
+  const Feature* parent_feature = GetExistingFeature(path.GetParent());
+  if (parent_feature == nullptr || !parent_feature->has_struct_domain()) {
+    return nullptr;
+  }
+  return GetExistingFeatureHelper(path.last_step(),
+                                  parent_feature->struct_domain().feature());
 }
 
-SparseFeature* Schema::GetExistingSparseFeature(const Path& path) {
+Feature* Schema::GetExistingFeature(const Path& path) {
+  return const_cast<Feature*>(
+      static_cast<const Schema*>(this)->GetExistingFeature(path));
+}
+
+const SparseFeature* Schema::GetExistingSparseFeature(const Path& path) const {
   CHECK(!path.empty());
   if (path.size() == 1) {
     return GetExistingSparseFeatureHelper(path.last_step(),
-                                          schema_.mutable_sparse_feature());
-  } else {
-    Feature* parent_feature = GetExistingFeature(path.GetParent());
-    if (parent_feature == nullptr) {
-      return nullptr;
-    }
-    if (!parent_feature->has_struct_domain()) {
-      return nullptr;
-    }
-    return GetExistingSparseFeatureHelper(
-        path.last_step(),
-        parent_feature->mutable_struct_domain()->mutable_sparse_feature());
+                                          schema_.sparse_feature());
+  }
+  const Feature* parent_feature = GetExistingFeature(path.GetParent());
+  if (parent_feature == nullptr || !parent_feature->has_struct_domain()) {
+    return nullptr;
   }
+  return GetExistingSparseFeatureHelper(
+      path.last_step(), parent_feature->struct_domain().sparse_feature());
 }
 
-WeightedFeature* Schema::GetExistingWeightedFeature(const Path& path) {
+SparseFeature* Schema::GetExistingSparseFeature(const Path& path) {
+  return const_cast<SparseFeature*>(
+      static_cast<const Schema*>(this)->GetExistingSparseFeature(path));
+}
+
+const WeightedFeature* Schema::GetExistingWeightedFeature(
+    const Path& path) const {
   CHECK(!path.empty());
   if (path.size() != 1) {
     // Weighted features are always top-level features with single-step paths.
     return nullptr;
   }
   auto name = path.last_step();
-  for (WeightedFeature& weighted_feature :
-       *schema_.mutable_weighted_feature()) {
+  for (const WeightedFeature& weighted_feature : schema_.weighted_feature()) {
     if (weighted_feature.name() == name) {
       return &weighted_feature;
     }
@@ -649,6 +682,11 @@ WeightedFeature* Schema::GetExistingWeightedFeature(const Path& path) {
   return nullptr;
 }
 
+WeightedFeature* Schema::GetExistingWeightedFeature(const Path& path) {
+  return const_cast<WeightedFeature*>(
+      static_cast<const Schema*>(this)->GetExistingWeightedFeature(path));
+}
+
 Feature* Schema::GetNewFeature(const Path& path) {
   CHECK(!path.empty());
   if (path.size() > 1) {
@@ -765,8 +803,7 @@ std::vector<Description> Schema::UpdateFeatureSelf(Feature* feature) {
                             "max should not be less than min"});
     feature->mutable_value_count()->set_max(feature->value_count().min());
   }
-  if (!ContainsKey(AllowedFeatureTypes(feature->domain_info_case()),
-                   feature->type())) {
+  if (!IsAllowedFeatureType(feature->domain_info_case(), feature->type())) {
     // Note that this clears the oneof field domain_info.
     ::tensorflow::data_validation::ClearDomain(feature);
     // TODO(b/148406400): Give more detail here.
@@ -980,11 +1017,7 @@ std::vector<Description> Schema::UpdateFeatureInternal(
   }
 
   if (view.type() == FeatureNameStatistics::BYTES &&
-      !ContainsKey(
-          std::set<Feature::DomainInfoCase>(
-              {Feature::DOMAIN_INFO_NOT_SET, Feature::kNaturalLanguageDomain,
-               Feature::kImageDomain, Feature::kUrlDomain}),
-          feature->domain_info_case())) {
+      !IsAllowedBytesDomainInfoCase(feature->domain_info_case())) {
     // Note that this clears the oneof field domain_info.
     ::tensorflow::data_validation::ClearDomain(feature);
     descriptions.push_back(
@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_DATA_VALIDATION_ANOMALIES_SCHEMA_H_
 #define TENSORFLOW_DATA_VALIDATION_ANOMALIES_SCHEMA_H_
 
+#include <array>
 #include <map>
 #include <memory>
 #include <set>
@@ -85,6 +86,11 @@ class Schema {
     const FeatureStatisticsToProtoConfig config_;
     // The columns to ignore, extracted from config_.
     const std::set<string> columns_to_ignore_;
+    // The severity of each AnomalyInfo::Type, indexed by type, extracted from
+    // the severity overrides of config_.
+    std::array<tensorflow::metadata::v0::AnomalyInfo::Severity,
+               tensorflow::metadata::v0::AnomalyInfo::Type_ARRAYSIZE>
+        severity_for_type_;
     // A map from a key to an enum, extracted from config_.
     std::map<Path, string> grouped_enums_;
   };
@@ -120,12 +126,12 @@ class Schema {
       tensorflow::metadata::v0::AnomalyInfo::Severity* severity);
 
   // Returns true iff there is a feature corresponding to the path.
-  bool FeatureExists(const Path& path);
+  bool FeatureExists(const Path& path) const;
 
   // Returns true if the feature corresponding to the view is deprecated,
   // false if it is not. If there is no feature corresponding to the
   // view, the result is undefined.
-  bool FeatureIsDeprecated(const Path& path);
+  bool FeatureIsDeprecated(const Path& path) const;
 
   // Deprecates a feature.
   void DeprecateFeature(const Path& path);
@@ -133,6 +139,11 @@ class Schema {
   // Gets the schema that represents the proto.
   tensorflow::metadata::v0::Schema GetSchema() const;
 
+  // Same as above, without copying the proto.
+  const tensorflow::metadata::v0::Schema& schema_proto() const {
+    return schema_;
+  }
+
   // Populates FeatureStatisticsToProtoConfig with groups of enums that seem
   // similar. config is the original config, and dataset_stats has
   // the relevant data.
@@ -158,7 +169,8 @@ class Schema {
 
   // Returns columns that are required to be present but are absent
   // (i.e., no FeatureNameStatistics).
-  std::vector<Path> GetMissingPaths(const DatasetStatsView& dataset_stats);
+  std::vector<Path> GetMissingPaths(
+      const DatasetStatsView& dataset_stats) const;
 
   // Updates dataset-level constraints.
   std::vector<Description> UpdateDatasetConstraints(
@@ -229,12 +241,15 @@ class Schema {
 
   // Gets an existing feature, or returns null if it doesn't exist.
   Feature* GetExistingFeature(const Path& path);
+  const Feature* GetExistingFeature(const Path& path) const;
 
   // Gets an existing sparse feature, or returns null if it doesn't exist.
   SparseFeature* GetExistingSparseFeature(const Path& path);
+  const SparseFeature* GetExistingSparseFeature(const Path& path) const;
 
   // Gets an existing weighted feature, or returns null if it doesn't exist.
   WeightedFeature* GetExistingWeightedFeature(const Path& path);
+  const WeightedFeature* GetExistingWeightedFeature(const Path& path) const;
 
   // Gets a new feature. Assumes that the feature does not already exist.
   Feature* GetNewFeature(const Path& path);
@@ -18,7 +18,6 @@ limitations under the License.
 #include <algorithm>
 #include <map>
 #include <memory>
-#include <numeric>
 #include <string>
 #include <utility>
 #include <vector>
@@ -28,8 +27,8 @@ limitations under the License.
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_split.h"
 #include "absl/strings/string_view.h"
+#include "tensorflow_data_validation/anomalies/anomalies_util.h"
 #include "tensorflow_data_validation/anomalies/internal_types.h"
-#include "tensorflow_data_validation/anomalies/map_util.h"
 #include "tensorflow_data_validation/anomalies/proto/feature_statistics_to_proto.pb.h"
 #include "tensorflow_data_validation/anomalies/schema.h"
 #include "tensorflow_data_validation/anomalies/schema_util.h"
@@ -48,9 +47,6 @@ namespace data_validation {
 namespace {
 using ::tensorflow::Status;
 
-// LINT.IfChange
-constexpr char kMultipleErrors[] = "Multiple errors";
-// LINT.ThenChange(../utils/anomalies_util.py)
 constexpr char kColumnDropped[] = "Column dropped";
 
 // For internal use only.
@@ -67,7 +63,6 @@ int NumericalSeverity(tensorflow::metadata::v0::AnomalyInfo::Severity a) {
   }
 }
 
-// LINT.IfChange
 bool AllSchemaNewColumn(const std::vector<Description>& descriptions) {
   for (const Description& description : descriptions) {
     if (description.type != metadata::v0::AnomalyInfo::SCHEMA_NEW_COLUMN) {
@@ -87,30 +82,6 @@ std::vector<Description> FilterDescriptions(
   return descriptions;
 }
 
-// Aggregates the descriptions into a single description.
-// Eventually, unification can happen in the front end.
-Description UnifyDescriptions(const std::vector<Description>& descriptions) {
-  return std::accumulate(
-      descriptions.begin(), descriptions.end(), Description(),
-      [](const Description& description_a, const Description& description_b) {
-        if (description_a.long_description.empty()) {
-          return description_b;
-        } else if (description_b.long_description.empty()) {
-          return description_a;
-        } else {
-          Description output;
-          // The actual type of the aggregate anomaly is ignored.
-          output.type = tensorflow::metadata::v0::AnomalyInfo::UNKNOWN_TYPE;
-          absl::StrAppend(&output.long_description,
-                          description_a.long_description, " ",
-                          description_b.long_description);
-          output.short_description = kMultipleErrors;
-          return output;
-        }
-      });
-}
-// LINT.ThenChange(../utils/anomalies_util.py)
-
 bool ShouldCreateFeature(const absl::optional<std::set<Path>>& features_needed,
                          const FeatureStatsView& feature) {
   return !features_needed ||
@@ -169,8 +140,15 @@ tensorflow::metadata::v0::AnomalyInfo SchemaAnomalyBase::GetAnomalyInfo(
          ::tensorflow::protobuf::RepeatedPtrFieldBackInserter(
              anomaly_info.mutable_diff_regions()));
   }
-  const std::vector<Description> filtered_descriptions =
+  std::vector<Description> filtered_descriptions =
       FilterDescriptions(descriptions_);
+  // Render the details of the descriptions, now that they are reported.
+  for (Description& description : filtered_descriptions) {
+    if (!description.details.empty()) {
+      description.long_description = RenderLongDescription(description);
+      description.details = DescriptionDetails();
+    }
+  }
   for (const Description& description : filtered_descriptions) {
     tensorflow::metadata::v0::AnomalyInfo::Reason& reason =
         *anomaly_info.add_reason();
@@ -178,14 +156,9 @@ tensorflow::metadata::v0::AnomalyInfo SchemaAnomalyBase::GetAnomalyInfo(
     reason.set_short_description(description.short_description);
     reason.set_description(description.long_description);
   }
-  {
-    // Set description of entire anomaly.
-    const Description unified_description =
-        UnifyDescriptions(filtered_descriptions);
-    anomaly_info.set_description(unified_description.long_description);
-    anomaly_info.set_short_description(unified_description.short_description);
-    anomaly_info.set_severity(severity_);
-  }
+  // Set description of entire anomaly.
+  UpdateAnomalyDescription(&anomaly_info);
+  anomaly_info.set_severity(severity_);
   return anomaly_info;
 }
 
@@ -282,17 +255,32 @@ void DatasetSchemaAnomaly::Update(const DatasetStatsView& dataset_stats_view) {
 }
 
 tensorflow::metadata::v0::Anomalies SchemaAnomalies::GetSchemaDiff(
-    bool enable_diff_regions) const {
-  const tensorflow::metadata::v0::Schema& schema_proto = serialized_baseline_;
+    bool enable_diff_regions, bool baseline_fingerprint_only) const {
+  const tensorflow::metadata::v0::Schema& schema_proto =
+      baseline_->schema_proto();
   tensorflow::metadata::v0::Anomalies result;
   result.set_anomaly_name_format(
       tensorflow::metadata::v0::Anomalies::SERIALIZED_PATH);
-  *result.mutable_baseline() = schema_proto;
+  *result.mutable_baseline() = baseline_fingerprint_only
+                                   ? MakeFingerprintBaseline(schema_proto)
+                                   : schema_proto;
   ::tensorflow::protobuf::Map<string, tensorflow::metadata::v0::AnomalyInfo>&
       result_schemas = *result.mutable_anomaly_info();
+  // Visit the features in path order, so that the result does not depend on
+  // the iteration order of anomalies_.
+  std::vector<const std::pair<const InternedPath, SchemaAnomaly>*> sorted;
+  sorted.reserve(anomalies_.size());
   for (const auto& pair : anomalies_) {
-    const Path& feature_path = pair.first;
-    const SchemaAnomaly& anomaly = pair.second;
+    sorted.push_back(&pair);
+  }
+  std::sort(sorted.begin(), sorted.end(),
+            [](const std::pair<const InternedPath, SchemaAnomaly>* a,
+               const std::pair<const InternedPath, SchemaAnomaly>* b) {
+              return a->first < b->first;
+            });
+  for (const auto* pair : sorted) {
+    const InternedPath& feature_path = pair->first;
+    const SchemaAnomaly& anomaly = pair->second;
     result_schemas[feature_path.Serialize()] =
         anomaly.GetAnomalyInfo(schema_proto, enable_diff_regions);
   }
@@ -304,19 +292,39 @@ tensorflow::metadata::v0::Anomalies SchemaAnomalies::GetSchemaDiff(
   return result;
 }
 
-tensorflow::Status SchemaAnomalies::InitSchema(Schema* schema) const {
-  return schema->Init(serialized_baseline_);
+SchemaAnomalies::SchemaAnomalies(
+    const tensorflow::metadata::v0::Schema& schema)
+    : dataset_anomalies_(absl::nullopt) {
+  auto baseline = std::make_shared<Schema>();
+  // Init only fails on a schema which is not empty.
+  TF_CHECK_OK(baseline->Init(schema));
+  baseline_ = std::move(baseline);
+}
+
+void SchemaAnomalies::UsePathInterner(
+    const std::shared_ptr<PathInterner>& path_interner) {
+  if (anomalies_.empty()) {
+    path_interner_ = path_interner;
+  }
+}
+
+InternedPath SchemaAnomalies::GetKey(const InternedPath& path) const {
+  if (path.interner() == path_interner_.get()) {
+    return path;
+  }
+  return path_interner_->Intern(path.ToPath());
 }
 
 tensorflow::Status SchemaAnomalies::GenericUpdate(
     const std::function<tensorflow::Status(SchemaAnomaly* anomaly)>& update,
-    const Path& path) {
-  if (ContainsKey(anomalies_, path)) {
-    return update(&anomalies_[path]);
+    const InternedPath& path) {
+  auto iter = anomalies_.find(path);
+  if (iter != anomalies_.end()) {
+    return update(&iter->second);
   } else {
     SchemaAnomaly schema_anomaly;
-    TF_RETURN_IF_ERROR(schema_anomaly.InitSchema(serialized_baseline_));
-    schema_anomaly.set_path(path);
+    TF_RETURN_IF_ERROR(schema_anomaly.InitSchema(baseline_->schema_proto()));
+    schema_anomaly.set_path(path.ToPath());
     TF_RETURN_IF_ERROR(update(&schema_anomaly));
     if (schema_anomaly.is_problem()) {
       anomalies_[path] = std::move(schema_anomaly);
@@ -329,7 +337,8 @@ tensorflow::Status SchemaAnomalies::GenericDatasetUpdate(
     const std::function<tensorflow::Status(DatasetSchemaAnomaly* anomaly)>&
         update) {
   DatasetSchemaAnomaly dataset_schema_anomaly;
-  TF_RETURN_IF_ERROR(dataset_schema_anomaly.InitSchema(serialized_baseline_));
+  TF_RETURN_IF_ERROR(
+      dataset_schema_anomaly.InitSchema(baseline_->schema_proto()));
   TF_RETURN_IF_ERROR(update(&dataset_schema_anomaly));
   if (dataset_schema_anomaly.is_problem()) {
     dataset_anomalies_ = std::move(dataset_schema_anomaly);
@@ -341,8 +350,8 @@ tensorflow::Status SchemaAnomalies::FindChangesRecursively(
     const FeatureStatsView& feature_stats_view,
     const absl::optional<std::set<Path>>& features_needed,
     const Schema::Updater& updater) {
-  Schema baseline;
-  TF_RETURN_IF_ERROR(InitSchema(&baseline));
+  const Schema& baseline = *baseline_;
+  const InternedPath key = GetKey(feature_stats_view.GetInternedPath());
   if (baseline.FeatureExists(feature_stats_view.GetPath())) {
     // TODO(b/148407751): Treat PLANNED separately.
     if (baseline.FeatureIsDeprecated(feature_stats_view.GetPath())) {
@@ -352,10 +361,10 @@ tensorflow::Status SchemaAnomalies::FindChangesRecursively(
         [&feature_stats_view, &updater](SchemaAnomaly* schema_anomaly) {
           return schema_anomaly->Update(updater, feature_stats_view);
         },
-        feature_stats_view.GetPath()));
-    if (ContainsKey(anomalies_, feature_stats_view.GetPath()) &&
-        anomalies_[feature_stats_view.GetPath()].FeatureIsDeprecated(
-            feature_stats_view.GetPath())) {
+        key));
+    auto iter = anomalies_.find(key);
+    if (iter != anomalies_.end() &&
+        iter->second.FeatureIsDeprecated(feature_stats_view.GetPath())) {
       return Status::OK();
     }
     for (const FeatureStatsView& child : feature_stats_view.GetChildren()) {
@@ -365,16 +374,17 @@ tensorflow::Status SchemaAnomalies::FindChangesRecursively(
   } else if (ShouldCreateFeature(features_needed, feature_stats_view)) {
     // Feature doesn't exist. Need to recursively create it.
 
-    if (!ContainsKey(anomalies_, feature_stats_view.GetPath())) {
+    auto iter = anomalies_.find(key);
+    if (iter == anomalies_.end()) {
       SchemaAnomaly anomaly;
-      TF_RETURN_IF_ERROR(anomaly.InitSchema(serialized_baseline_));
+      TF_RETURN_IF_ERROR(anomaly.InitSchema(baseline_->schema_proto()));
       anomaly.set_path(feature_stats_view.GetPath());
-      anomalies_[feature_stats_view.GetPath()] = std::move(anomaly);
+      iter = anomalies_.emplace(key, std::move(anomaly)).first;
     }
     // Since these features are all new,
     // features_needed == features_to_update.
-    TF_RETURN_IF_ERROR(anomalies_[feature_stats_view.GetPath()].CreateNewField(
-        updater, features_needed, feature_stats_view));
+    TF_RETURN_IF_ERROR(iter->second.CreateNewField(updater, features_needed,
+                                                   feature_stats_view));
   }
   return Status::OK();
 }
@@ -383,6 +393,17 @@ tensorflow::Status SchemaAnomalies::FindChanges(
     const DatasetStatsView& statistics,
     const absl::optional<FeaturesNeeded>& features_needed,
     const FeatureStatisticsToProtoConfig& feature_statistics_to_proto_config) {
+  TF_RETURN_IF_ERROR(FindFeatureChanges(statistics.GetRootFeatures(),
+                                        features_needed,
+                                        feature_statistics_to_proto_config));
+  return FindMissingAndDatasetChanges(statistics, features_needed,
+                                      feature_statistics_to_proto_config);
+}
+
+tensorflow::Status SchemaAnomalies::FindFeatureChanges(
+    const std::vector<FeatureStatsView>& root_features,
+    const absl::optional<FeaturesNeeded>& features_needed,
+    const FeatureStatisticsToProtoConfig& feature_statistics_to_proto_config) {
   Schema::Updater updater(feature_statistics_to_proto_config);
   absl::optional<std::set<Path>> feature_set_to_create;
   if (features_needed) {
@@ -393,20 +414,28 @@ tensorflow::Status SchemaAnomalies::FindChanges(
     }
   }
 
-  for (const FeatureStatsView& feature_stats_view :
-       statistics.GetRootFeatures()) {
+  for (const FeatureStatsView& feature_stats_view : root_features) {
+    UsePathInterner(feature_stats_view.parent_view().path_interner());
     TF_RETURN_IF_ERROR(FindChangesRecursively(feature_stats_view,
                                               feature_set_to_create, updater));
   }
-  Schema baseline;
-  TF_RETURN_IF_ERROR(InitSchema(&baseline));
+  return Status::OK();
+}
+
+tensorflow::Status SchemaAnomalies::FindMissingAndDatasetChanges(
+    const DatasetStatsView& statistics,
+    const absl::optional<FeaturesNeeded>& features_needed,
+    const FeatureStatisticsToProtoConfig& feature_statistics_to_proto_config) {
+  Schema::Updater updater(feature_statistics_to_proto_config);
+  const Schema& baseline = *baseline_;
+  UsePathInterner(statistics.path_interner());
   for (const Path& path : baseline.GetMissingPaths(statistics)) {
     TF_RETURN_IF_ERROR(GenericUpdate(
         [&updater](SchemaAnomaly* schema_anomaly) {
           schema_anomaly->ObserveMissing(updater);
           return Status::OK();
         },
-        path));
+        path_interner_->Intern(path)));
   }
   if (features_needed) {
     for (const auto& p : *features_needed) {
@@ -425,8 +454,27 @@ tensorflow::Status SchemaAnomalies::FindChanges(
   return Status::OK();
 }
 
+tensorflow::Status SchemaAnomalies::MergeFeatureAnomalies(
+    SchemaAnomalies* other) {
+  if (other->anomalies_.empty()) {
+    return Status::OK();
+  }
+  UsePathInterner(other->path_interner_);
+  for (auto& pair : other->anomalies_) {
+    if (!anomalies_.emplace(GetKey(pair.first), std::move(pair.second))
+             .second) {
+      return errors::Internal("Anomalies for feature ",
+                              pair.first.Serialize(),
+                              " were found more than once.");
+    }
+  }
+  other->anomalies_.clear();
+  return Status::OK();
+}
+
 tensorflow::Status SchemaAnomalies::FindSkew(
     const DatasetStatsView& dataset_stats_view) {
+  UsePathInterner(dataset_stats_view.path_interner());
   for (const FeatureStatsView& feature_stats_view :
        dataset_stats_view.features()) {
     // This is a simplified version of finding skew, that ignores the feature
@@ -436,7 +484,7 @@ tensorflow::Status SchemaAnomalies::FindSkew(
           schema_anomaly->UpdateSkewComparator(feature_stats_view);
           return Status::OK();
         },
-        feature_stats_view.GetPath()));
+        GetKey(feature_stats_view.GetInternedPath())));
   }
   return Status::OK();
 }
@@ -22,7 +22,9 @@ limitations under the License.
 #include <string>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "tensorflow_data_validation/anomalies/features_needed.h"
+#include "tensorflow_data_validation/anomalies/interned_path.h"
 #include "tensorflow_data_validation/anomalies/internal_types.h"
 #include "tensorflow_data_validation/anomalies/proto/feature_statistics_to_proto.pb.h"
 #include "tensorflow_data_validation/anomalies/schema.h"
@@ -143,8 +145,12 @@ class SchemaAnomaly : public SchemaAnomalyBase {
 // created the anomaly.
 class SchemaAnomalies {
  public:
-  explicit SchemaAnomalies(const tensorflow::metadata::v0::Schema& schema)
-      : dataset_anomalies_(absl::nullopt), serialized_baseline_(schema) {}
+  explicit SchemaAnomalies(const tensorflow::metadata::v0::Schema& schema);
+
+  // Same as above, but shares <baseline>, which must be initialized, e.g. to
+  // validate several statistics against the same schema without copying it.
+  explicit SchemaAnomalies(std::shared_ptr<const Schema> baseline)
+      : dataset_anomalies_(absl::nullopt), baseline_(std::move(baseline)) {}
 
   // Finds any column- and dataset-level issues. For column-level issues,
   // creates a map where the key is the key of the column with an anomaly, and
@@ -161,11 +167,33 @@ class SchemaAnomalies {
       const absl::optional<FeaturesNeeded>& features_needed,
       const FeatureStatisticsToProtoConfig& feature_statistics_to_proto_config);
 
+  // FindChanges in two steps, so that the first one can be split across
+  // several SchemaAnomalies objects (e.g. to run in parallel):
+  // 1. Finds the column-level issues of the features in the subtrees of
+  //    <root_features>.
+  tensorflow::Status FindFeatureChanges(
+      const std::vector<FeatureStatsView>& root_features,
+      const absl::optional<FeaturesNeeded>& features_needed,
+      const FeatureStatisticsToProtoConfig& feature_statistics_to_proto_config);
+  // 2. Finds the features of the schema missing from <statistics>, and the
+  //    dataset-level issues.
+  tensorflow::Status FindMissingAndDatasetChanges(
+      const DatasetStatsView& statistics,
+      const absl::optional<FeaturesNeeded>& features_needed,
+      const FeatureStatisticsToProtoConfig& feature_statistics_to_proto_config);
+
+  // Moves the column-level anomalies found by <other>, which must have the
+  // same schema, into this object. Fails if both have an anomaly for the same
+  // column.
+  tensorflow::Status MergeFeatureAnomalies(SchemaAnomalies* other);
+
   tensorflow::Status FindSkew(const DatasetStatsView& dataset_stats_view);
 
-  // Records current anomalies as a schema diff.
+  // Records current anomalies as a schema diff. If <baseline_fingerprint_only>
+  // is true, the baseline of the result only references the schema by its
+  // fingerprint (see MakeFingerprintBaseline).
   tensorflow::metadata::v0::Anomalies GetSchemaDiff(
-      bool enable_diff_regions) const;
+      bool enable_diff_regions, bool baseline_fingerprint_only = false) const;
 
  private:
   // Checks a particular column for any issues, and:
@@ -182,36 +210,47 @@ class SchemaAnomalies {
 
   // 1. If there is a SchemaAnomaly for feature_name, applies update,
   // 2. otherwise, creates a new SchemaAnomaly for the feature_name and
-  // initializes it using the serialized_baseline_. Then, it tries the
+  // initializes it using the baseline_. Then, it tries the
   // update(...) function. If there is a problem, then the new SchemaAnomaly
   // gets added.
   tensorflow::Status GenericUpdate(
       const std::function<tensorflow::Status(SchemaAnomaly* anomaly)>& update,
-      const Path& path);
+      const InternedPath& path);
+
+  // Interns the paths of anomalies_ with <path_interner> from now on, unless
+  // there already are anomalies.
+  void UsePathInterner(const std::shared_ptr<PathInterner>& path_interner);
+
+  // Returns the key of anomalies_ for <path>, which is <path> itself unless
+  // it was interned by another interner.
+  InternedPath GetKey(const InternedPath& path) const;
 
   // Find dataset-level anomalies.
   tensorflow::Status FindDatasetChanges(
       const DatasetStatsView& dataset_stats_view);
 
   // Creates a new DatasetSchemaAnomaly and initializes it using the
-  // serialized_baseline_. Then, it tries the update(...) function. If there is
+  // baseline_. Then, it tries the update(...) function. If there is
   // a problem, then the new DatasetSchemaAnomaly gets added to
   // dataset_anomalies_.
   tensorflow::Status GenericDatasetUpdate(
       const std::function<tensorflow::Status(DatasetSchemaAnomaly* anomaly)>&
           update);
 
-  // Initialize a schema from the serialized_baseline_.
-  tensorflow::Status InitSchema(Schema* schema) const;
-
   // A map from feature columns to anomalies in that column.
-  std::map<Path, SchemaAnomaly> anomalies_;
+  absl::flat_hash_map<InternedPath, SchemaAnomaly> anomalies_;
+
+  // The interner of the paths of anomalies_, usually that of the
+  // DatasetStatsView the anomalies are found in, kept so that the paths
+  // outlive the view.
+  std::shared_ptr<PathInterner> path_interner_;
 
   // Dataset-level anomalies.
   absl::optional<DatasetSchemaAnomaly> dataset_anomalies_;
 
-  // The initial schema. Each SchemaAnomaly is initialized from this.
-  tensorflow::metadata::v0::Schema serialized_baseline_;
+  // The initial schema, which is only read. Each SchemaAnomaly is
+  // initialized from its proto.
+  std::shared_ptr<const Schema> baseline_;
 };
 
 }  // namespace data_validation
@@ -0,0 +1,138 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Microbenchmarks of the per-feature validation of Schema.
+// Run with:
+// bazel run -c opt :schema_benchmark -- --benchmarks=all
+
+#include <vector>
+
+#include "tensorflow_data_validation/anomalies/internal_types.h"
+#include "tensorflow_data_validation/anomalies/path.h"
+#include "tensorflow_data_validation/anomalies/proto/feature_statistics_to_proto.pb.h"
+#include "tensorflow_data_validation/anomalies/schema.h"
+#include "tensorflow_data_validation/anomalies/statistics_view.h"
+#include "tensorflow_data_validation/anomalies/test_util.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow_metadata/proto/v0/anomalies.pb.h"
+#include "tensorflow_metadata/proto/v0/schema.pb.h"
+#include "tensorflow_metadata/proto/v0/statistics.pb.h"
+
+namespace tensorflow {
+namespace data_validation {
+namespace {
+
+using ::tensorflow::metadata::v0::AnomalyInfo;
+using ::tensorflow::metadata::v0::DatasetFeatureStatistics;
+using testing::ParseTextProtoOrDie;
+
+FeatureStatisticsToProtoConfig GetConfigWithSeverityOverrides() {
+  FeatureStatisticsToProtoConfig config;
+  for (int type = 0; type < 40; ++type) {
+    if (AnomalyInfo::Type_IsValid(type)) {
+      auto* severity_override = config.add_severity_overrides();
+      severity_override->set_type(static_cast<AnomalyInfo::Type>(type));
+      severity_override->set_severity(AnomalyInfo::WARNING);
+    }
+  }
+  return config;
+}
+
+void BM_UpdateSeverityForAnomaly(int iters) {
+  const Schema::Updater updater(GetConfigWithSeverityOverrides());
+  const std::vector<Description> descriptions = {
+      {AnomalyInfo::ENUM_TYPE_UNEXPECTED_STRING_VALUES, "", ""},
+      {AnomalyInfo::SCHEMA_NEW_COLUMN, "", ""},
+      {AnomalyInfo::UNKNOWN_TYPE, "", ""}};
+  AnomalyInfo::Severity severity = AnomalyInfo::UNKNOWN;
+  for (int i = 0; i < iters; ++i) {
+    updater.UpdateSeverityForAnomaly(descriptions, &severity);
+  }
+  CHECK_NE(severity, AnomalyInfo::UNKNOWN);
+}
+BENCHMARK(BM_UpdateSeverityForAnomaly);
+
+// Validates features whose statistics match the schema, i.e. without
+// anomalies.
+void BM_UpdateFeatureWithoutAnomalies(int iters) {
+  ::tensorflow::testing::StopTiming();
+  const Schema::Updater updater(GetConfigWithSeverityOverrides());
+  Schema schema;
+  TF_CHECK_OK(schema.Init(
+      ParseTextProtoOrDie<tensorflow::metadata::v0::Schema>(R"(
+        feature {
+          name: "bytes"
+          type: BYTES
+          image_domain {}
+        }
+        feature {
+          name: "bool"
+          type: BYTES
+          bool_domain { true_value: "true" false_value: "false" }
+        }
+        feature {
+          name: "int"
+          type: INT
+          int_domain { min: 0 max: 10 }
+        })")));
+  const DatasetFeatureStatistics statistics =
+      ParseTextProtoOrDie<DatasetFeatureStatistics>(R"(
+        num_examples: 10
+        features {
+          path { step: "bytes" }
+          type: BYTES
+          bytes_stats { common_stats { num_non_missing: 10 } }
+        }
+        features {
+          path { step: "bool" }
+          type: STRING
+          string_stats {
+            common_stats { num_non_missing: 10 }
+            rank_histogram {
+              buckets { label: "true" sample_count: 6 }
+              buckets { label: "false" sample_count: 4 }
+            }
+          }
+        }
+        features {
+          path { step: "int" }
+          type: INT
+          num_stats {
+            common_stats { num_non_missing: 10 }
+            min: 1
+            max: 9
+          }
+        })");
+  const DatasetStatsView view(statistics);
+  const std::vector<FeatureStatsView> features = view.features();
+  std::vector<Description> descriptions;
+  ::tensorflow::testing::StartTiming();
+  for (int i = 0; i < iters; ++i) {
+    for (const FeatureStatsView& feature : features) {
+      AnomalyInfo::Severity severity = AnomalyInfo::UNKNOWN;
+      TF_CHECK_OK(
+          schema.UpdateFeature(updater, feature, &descriptions, &severity));
+      CHECK(descriptions.empty());
+    }
+  }
+  ::tensorflow::testing::ItemsProcessed(static_cast<int64>(iters) *
+                                        features.size());
+}
+BENCHMARK(BM_UpdateFeatureWithoutAnomalies);
+
+}  // namespace
+}  // namespace data_validation
+}  // namespace tensorflow
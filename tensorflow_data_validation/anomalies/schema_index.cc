@@ -0,0 +1,118 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/schema_index.h"
+
+#include "absl/memory/memory.h"
+#include "tensorflow/core/lib/core/errors.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+namespace {
+
+using tensorflow::metadata::v0::Feature;
+using tensorflow::metadata::v0::Schema;
+
+bool IsCategorical(const Feature& feature) {
+  switch (feature.type()) {
+    case tensorflow::metadata::v0::BYTES:
+      return true;
+    case tensorflow::metadata::v0::INT:
+      return (feature.has_int_domain() &&
+              feature.int_domain().is_categorical()) ||
+             feature.has_bool_domain();
+    default:
+      return false;
+  }
+}
+
+bool IsUnivalent(const Feature& feature) {
+  return (feature.shape().dim_size() == 1 &&
+          feature.shape().dim(0).size() == 1) ||
+         feature.value_count().max() == 1;
+}
+
+}  // namespace
+
+SchemaIndex::SchemaIndex(const Schema& schema) {
+  AddFeatures(schema.feature(), Path(), {}, /*index_positions=*/true);
+  for (int i = 0; i < schema.string_domain_size(); ++i) {
+    string_domain_positions_.emplace(schema.string_domain(i).name(), i);
+  }
+}
+
+Status SchemaIndex::Create(const string& serialized_schema,
+                           std::unique_ptr<SchemaIndex>* result) {
+  Schema schema;
+  if (!schema.ParseFromString(serialized_schema)) {
+    return errors::InvalidArgument("Failed to parse Schema.");
+  }
+  *result = absl::make_unique<SchemaIndex>(schema);
+  return Status::OK();
+}
+
+void SchemaIndex::AddFeatures(
+    const protobuf::RepeatedPtrField<Feature>& features, const Path& parent,
+    const std::vector<int>& parent_positions, bool index_positions) {
+  for (int i = 0; i < features.size(); ++i) {
+    const Feature& feature = features.Get(i);
+    const Path path = parent.GetChild(feature.name());
+    std::vector<int> positions = parent_positions;
+    positions.push_back(i);
+    // Only the first feature with a name is reachable by its path.
+    const bool index_feature =
+        index_positions &&
+        feature_positions_.emplace(path.Serialize(), positions).second;
+    if (feature.type() == tensorflow::metadata::v0::STRUCT) {
+      AddFeatures(feature.struct_domain().feature(), path, positions,
+                  index_feature);
+    } else {
+      AddLeafFeature(feature, path, positions);
+    }
+  }
+}
+
+void SchemaIndex::AddLeafFeature(const Feature& feature, const Path& path,
+                                 const std::vector<int>& positions) {
+  leaf_features_.push_back(path);
+  leaf_feature_positions_.push_back(positions);
+  if (IsCategorical(feature)) {
+    categorical_features_.push_back(path);
+    if (feature.type() == tensorflow::metadata::v0::INT) {
+      categorical_numeric_features_.push_back(path);
+    }
+  }
+  if (!IsUnivalent(feature)) {
+    multivalent_features_.push_back(path);
+  }
+  if (feature.has_image_domain()) {
+    bytes_features_.push_back(path);
+  }
+}
+
+const std::vector<int>* SchemaIndex::GetFeaturePositions(
+    const Path& path) const {
+  auto iter = feature_positions_.find(path.Serialize());
+  return iter == feature_positions_.end() ? nullptr : &iter->second;
+}
+
+int SchemaIndex::GetStringDomainPosition(const string& name) const {
+  auto iter = string_domain_positions_.find(name);
+  return iter == string_domain_positions_.end() ? -1 : iter->second;
+}
+
+}  // namespace data_validation
+}  // namespace tensorflow
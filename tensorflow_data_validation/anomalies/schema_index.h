@@ -0,0 +1,107 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// An index of the features and global string domains of a schema, built once
+// to look them up in constant time instead of walking the schema.
+#ifndef TENSORFLOW_DATA_VALIDATION_ANOMALIES_SCHEMA_INDEX_H_
+#define TENSORFLOW_DATA_VALIDATION_ANOMALIES_SCHEMA_INDEX_H_
+
+#include <memory>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "tensorflow_data_validation/anomalies/path.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/protobuf.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow_metadata/proto/v0/schema.pb.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+// Indexes the features of a schema by path and its global string domains by
+// name. The features are identified by their positions: the position of the
+// feature in its container (the features of the schema or of a STRUCT
+// feature) at each step of its path. As when walking the schema, the first
+// feature with a given name in a container, and the first global string
+// domain with a given name, are the ones indexed.
+class SchemaIndex {
+ public:
+  explicit SchemaIndex(const tensorflow::metadata::v0::Schema& schema);
+
+  // Indexes a serialized Schema.
+  static Status Create(const string& serialized_schema,
+                       std::unique_ptr<SchemaIndex>* result);
+
+  // Returns the positions of the feature at <path>, or nullptr if there is
+  // none.
+  const std::vector<int>* GetFeaturePositions(const Path& path) const;
+
+  // Returns the position of the global string domain named <name>, or -1 if
+  // there is none.
+  int GetStringDomainPosition(const string& name) const;
+
+  // The paths and positions of the leaf (i.e. non-STRUCT) features, in
+  // depth-first order.
+  const std::vector<Path>& leaf_features() const { return leaf_features_; }
+  const std::vector<std::vector<int>>& leaf_feature_positions() const {
+    return leaf_feature_positions_;
+  }
+
+  // The leaf features which are categorical: BYTES features, and INT features
+  // with a categorical int domain or a bool domain.
+  const std::vector<Path>& categorical_features() const {
+    return categorical_features_;
+  }
+  // The categorical INT features.
+  const std::vector<Path>& categorical_numeric_features() const {
+    return categorical_numeric_features_;
+  }
+  // The leaf features which are not known to be univalent, i.e. which have
+  // neither a shape of one dimension of size 1 nor a max value count of 1.
+  const std::vector<Path>& multivalent_features() const {
+    return multivalent_features_;
+  }
+  // The leaf features which should be treated as bytes, i.e. which have an
+  // image domain.
+  const std::vector<Path>& bytes_features() const { return bytes_features_; }
+
+ private:
+  // Indexes <features>, the container of the features of <parent>. The
+  // positions of the features which are not the first with their name are
+  // not indexed (but their leaves are listed).
+  void AddFeatures(
+      const protobuf::RepeatedPtrField<tensorflow::metadata::v0::Feature>&
+          features,
+      const Path& parent, const std::vector<int>& parent_positions,
+      bool index_positions);
+  void AddLeafFeature(const tensorflow::metadata::v0::Feature& feature,
+                      const Path& path, const std::vector<int>& positions);
+
+  // The positions of the features, by serialized path.
+  absl::flat_hash_map<string, std::vector<int>> feature_positions_;
+  absl::flat_hash_map<string, int> string_domain_positions_;
+  std::vector<Path> leaf_features_;
+  std::vector<std::vector<int>> leaf_feature_positions_;
+  std::vector<Path> categorical_features_;
+  std::vector<Path> categorical_numeric_features_;
+  std::vector<Path> multivalent_features_;
+  std::vector<Path> bytes_features_;
+};
+
+}  // namespace data_validation
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_DATA_VALIDATION_ANOMALIES_SCHEMA_INDEX_H_
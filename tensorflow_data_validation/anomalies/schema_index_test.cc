@@ -0,0 +1,144 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/schema_index.h"
+
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow_data_validation/anomalies/path.h"
+#include "tensorflow_data_validation/anomalies/test_util.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow_metadata/proto/v0/schema.pb.h"
+
+namespace tensorflow {
+namespace data_validation {
+namespace {
+
+using ::tensorflow::metadata::v0::Schema;
+using testing::ParseTextProtoOrDie;
+
+const Schema GetTestSchema() {
+  return ParseTextProtoOrDie<Schema>(R"(
+    feature { name: "bytes" type: BYTES value_count { min: 1 max: 1 } }
+    feature {
+      name: "int_categorical"
+      type: INT
+      int_domain { is_categorical: true }
+      shape { dim { size: 1 } }
+    }
+    feature { name: "bool" type: INT bool_domain {} }
+    feature { name: "image" type: BYTES image_domain {} }
+    feature {
+      name: "struct"
+      type: STRUCT
+      struct_domain {
+        feature { name: "float" type: FLOAT domain: "colors" }
+        feature { name: "float" type: INT }
+      }
+    }
+    feature { name: "leaf" type: FLOAT }
+    feature {
+      name: "leaf"
+      type: STRUCT
+      struct_domain { feature { name: "hidden" type: BYTES } }
+    }
+    string_domain { name: "sizes" }
+    string_domain { name: "colors" }
+    string_domain { name: "colors" }
+  )");
+}
+
+std::vector<Path> MakePaths(
+    const std::vector<std::vector<string>>& steps_list) {
+  std::vector<Path> result;
+  for (const std::vector<string>& steps : steps_list) {
+    result.emplace_back(steps);
+  }
+  return result;
+}
+
+TEST(SchemaIndexTest, GetFeaturePositions) {
+  const SchemaIndex index(GetTestSchema());
+  const std::vector<int>* positions = index.GetFeaturePositions(Path({"bool"}));
+  ASSERT_NE(positions, nullptr);
+  EXPECT_EQ(*positions, std::vector<int>({2}));
+  positions = index.GetFeaturePositions(Path({"struct"}));
+  ASSERT_NE(positions, nullptr);
+  EXPECT_EQ(*positions, std::vector<int>({4}));
+  // The first feature with a name is indexed.
+  positions = index.GetFeaturePositions(Path({"struct", "float"}));
+  ASSERT_NE(positions, nullptr);
+  EXPECT_EQ(*positions, std::vector<int>({4, 0}));
+  positions = index.GetFeaturePositions(Path({"leaf"}));
+  ASSERT_NE(positions, nullptr);
+  EXPECT_EQ(*positions, std::vector<int>({5}));
+  // Not reachable, as the first feature named "leaf" is not a STRUCT.
+  EXPECT_EQ(index.GetFeaturePositions(Path({"leaf", "hidden"})), nullptr);
+  EXPECT_EQ(index.GetFeaturePositions(Path({"missing"})), nullptr);
+  EXPECT_EQ(index.GetFeaturePositions(Path({"bytes", "child"})), nullptr);
+}
+
+TEST(SchemaIndexTest, GetStringDomainPosition) {
+  const SchemaIndex index(GetTestSchema());
+  EXPECT_EQ(index.GetStringDomainPosition("sizes"), 0);
+  EXPECT_EQ(index.GetStringDomainPosition("colors"), 1);
+  EXPECT_EQ(index.GetStringDomainPosition("missing"), -1);
+}
+
+TEST(SchemaIndexTest, LeafFeatures) {
+  const SchemaIndex index(GetTestSchema());
+  EXPECT_EQ(index.leaf_features(),
+            MakePaths({{"bytes"},
+                       {"int_categorical"},
+                       {"bool"},
+                       {"image"},
+                       {"struct", "float"},
+                       {"struct", "float"},
+                       {"leaf"},
+                       {"leaf", "hidden"}}));
+  EXPECT_EQ(index.leaf_feature_positions(),
+            std::vector<std::vector<int>>(
+                {{0}, {1}, {2}, {3}, {4, 0}, {4, 1}, {5}, {6, 0}}));
+  EXPECT_EQ(index.categorical_features(),
+            MakePaths({{"bytes"},
+                       {"int_categorical"},
+                       {"bool"},
+                       {"image"},
+                       {"leaf", "hidden"}}));
+  EXPECT_EQ(index.categorical_numeric_features(),
+            MakePaths({{"int_categorical"}, {"bool"}}));
+  EXPECT_EQ(index.multivalent_features(),
+            MakePaths({{"bool"},
+                       {"image"},
+                       {"struct", "float"},
+                       {"struct", "float"},
+                       {"leaf"},
+                       {"leaf", "hidden"}}));
+  EXPECT_EQ(index.bytes_features(), MakePaths({{"image"}}));
+}
+
+TEST(SchemaIndexTest, Create) {
+  std::unique_ptr<SchemaIndex> index;
+  TF_ASSERT_OK(
+      SchemaIndex::Create(GetTestSchema().SerializeAsString(), &index));
+  EXPECT_EQ(index->leaf_features().size(), 8);
+  EXPECT_FALSE(SchemaIndex::Create("not a proto", &index).ok());
+}
+
+}  // namespace
+}  // namespace data_validation
+}  // namespace tensorflow
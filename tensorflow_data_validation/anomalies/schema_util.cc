@@ -14,6 +14,10 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow_data_validation/anomalies/schema_util.h"
+
+#include "tensorflow_data_validation/anomalies/proto/validation_config.pb.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
+#include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow_metadata/proto/v0/anomalies.pb.h"
 
@@ -41,5 +45,34 @@ tensorflow::metadata::v0::AnomalyInfo::Severity MaxSeverity(
   return (NumericalSeverity(a) > NumericalSeverity(b)) ? a : b;
 }
 
+uint64 SchemaFingerprint(const tensorflow::metadata::v0::Schema& schema) {
+  string serialized;
+  CHECK(SerializeToStringDeterministic(schema, &serialized));
+  return Fingerprint64(serialized);
+}
+
+tensorflow::metadata::v0::Schema MakeFingerprintBaseline(
+    const tensorflow::metadata::v0::Schema& schema) {
+  BaselineSchemaFingerprint baseline_fingerprint;
+  baseline_fingerprint.set_fingerprint(SchemaFingerprint(schema));
+  tensorflow::metadata::v0::Schema baseline;
+  baseline.mutable_annotation()->add_extra_metadata()->PackFrom(
+      baseline_fingerprint);
+  return baseline;
+}
+
+bool GetBaselineFingerprint(const tensorflow::metadata::v0::Schema& baseline,
+                            uint64* fingerprint) {
+  for (const auto& extra_metadata : baseline.annotation().extra_metadata()) {
+    BaselineSchemaFingerprint baseline_fingerprint;
+    if (extra_metadata.Is<BaselineSchemaFingerprint>() &&
+        extra_metadata.UnpackTo(&baseline_fingerprint)) {
+      *fingerprint = baseline_fingerprint.fingerprint();
+      return true;
+    }
+  }
+  return false;
+}
+
 }  // namespace data_validation
 }  // namespace tensorflow
@@ -16,7 +16,9 @@ limitations under the License.
 #ifndef TENSORFLOW_DATA_VALIDATION_ANOMALIES_SCHEMA_UTIL_H_
 #define TENSORFLOW_DATA_VALIDATION_ANOMALIES_SCHEMA_UTIL_H_
 
+#include "tensorflow/core/platform/types.h"
 #include "tensorflow_metadata/proto/v0/anomalies.pb.h"
+#include "tensorflow_metadata/proto/v0/schema.pb.h"
 
 namespace tensorflow {
 namespace data_validation {
@@ -26,6 +28,20 @@ tensorflow::metadata::v0::AnomalyInfo::Severity MaxSeverity(
     tensorflow::metadata::v0::AnomalyInfo::Severity a,
     tensorflow::metadata::v0::AnomalyInfo::Severity b);
 
+// Returns a stable fingerprint of <schema>, i.e. the fingerprint of its
+// deterministic serialization.
+uint64 SchemaFingerprint(const tensorflow::metadata::v0::Schema& schema);
+
+// Returns a baseline that references <schema> by its fingerprint instead of
+// holding a copy of it (see ValidationConfig.baseline_fingerprint_only).
+tensorflow::metadata::v0::Schema MakeFingerprintBaseline(
+    const tensorflow::metadata::v0::Schema& schema);
+
+// Gets the fingerprint of the schema referenced by a baseline made by
+// MakeFingerprintBaseline. Returns false if <baseline> holds no fingerprint.
+bool GetBaselineFingerprint(const tensorflow::metadata::v0::Schema& baseline,
+                            uint64* fingerprint);
+
 }  // namespace data_validation
 }  // namespace tensorflow
 
@@ -17,13 +17,17 @@ limitations under the License.
 
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
+#include "tensorflow_data_validation/anomalies/test_util.h"
 #include "tensorflow_metadata/proto/v0/anomalies.pb.h"
+#include "tensorflow_metadata/proto/v0/schema.pb.h"
 
 namespace tensorflow {
 namespace data_validation {
 
 namespace {
 using tensorflow::metadata::v0::AnomalyInfo;
+using tensorflow::metadata::v0::Schema;
+using testing::ParseTextProtoOrDie;
 
 // Since this method only has nine possible inputs, it is easiest to test them
 // all directly.
@@ -48,6 +52,28 @@ TEST(MaxSeverity, MaxSeverity) {
             MaxSeverity(AnomalyInfo::ERROR, AnomalyInfo::ERROR));
 }
 
+TEST(SchemaFingerprint, SchemaFingerprint) {
+  const Schema schema = ParseTextProtoOrDie<Schema>(R"(
+    feature { name: "a" type: BYTES domain: "MyEnum" }
+    string_domain { name: "MyEnum" value: "A" value: "B" })");
+  const Schema same_schema = schema;
+  Schema other_schema = schema;
+  other_schema.mutable_string_domain(0)->add_value("C");
+  EXPECT_EQ(SchemaFingerprint(schema), SchemaFingerprint(same_schema));
+  EXPECT_NE(SchemaFingerprint(schema), SchemaFingerprint(other_schema));
+}
+
+TEST(SchemaFingerprint, FingerprintBaseline) {
+  const Schema schema = ParseTextProtoOrDie<Schema>(R"(
+    feature { name: "a" type: INT })");
+  const Schema baseline = MakeFingerprintBaseline(schema);
+  EXPECT_EQ(baseline.feature_size(), 0);
+  uint64 fingerprint = 0;
+  ASSERT_TRUE(GetBaselineFingerprint(baseline, &fingerprint));
+  EXPECT_EQ(fingerprint, SchemaFingerprint(schema));
+  EXPECT_FALSE(GetBaselineFingerprint(schema, &fingerprint));
+}
+
 }  // namespace
 
 }  // namespace data_validation
@@ -0,0 +1,274 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/statistics_merge_util.h"
+
+#include <map>
+#include <string>
+#include <utility>
+
+#include "tensorflow_data_validation/anomalies/path.h"
+#include "tensorflow/core/lib/core/errors.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+namespace {
+
+using ::tensorflow::metadata::v0::CommonStatistics;
+using ::tensorflow::metadata::v0::CustomStatistic;
+using ::tensorflow::metadata::v0::DatasetFeatureStatistics;
+using ::tensorflow::metadata::v0::DatasetFeatureStatisticsList;
+using ::tensorflow::metadata::v0::FeatureNameStatistics;
+
+// LINT.IfChange
+constexpr char kDummyFeatureName[] = "__TFDV_INTERNAL_FEATURE__";
+constexpr char kNumExamplesKey[] = "__NUM_EXAMPLES__";
+constexpr char kWeightedNumExamplesKey[] = "__WEIGHTED_NUM_EXAMPLES__";
+// LINT.ThenChange(../statistics/stats_impl.py)
+
+// Returns the common stats of the feature, or nullptr if the feature has no
+// stats set (which can be the case when only custom stats were generated for
+// it, e.g., for a sparse or weighted feature).
+CommonStatistics* GetMutableCommonStats(FeatureNameStatistics* feature) {
+  switch (feature->stats_case()) {
+    case FeatureNameStatistics::kNumStats:
+      return feature->mutable_num_stats()->mutable_common_stats();
+    case FeatureNameStatistics::kStringStats:
+      return feature->mutable_string_stats()->mutable_common_stats();
+    case FeatureNameStatistics::kBytesStats:
+      return feature->mutable_bytes_stats()->mutable_common_stats();
+    case FeatureNameStatistics::kStructStats:
+      return feature->mutable_struct_stats()->mutable_common_stats();
+    case FeatureNameStatistics::STATS_NOT_SET:
+      return nullptr;
+  }
+  return nullptr;
+}
+
+// Returns the number of examples recorded in the common stats of the feature,
+// if it has numeric or string stats with common stats.
+bool GetNumExamplesFromCommonStats(const FeatureNameStatistics& feature,
+                                   int64* num_examples) {
+  const CommonStatistics* common_stats = nullptr;
+  if (feature.has_num_stats()) {
+    if (feature.num_stats().has_common_stats()) {
+      common_stats = &feature.num_stats().common_stats();
+    }
+  } else if (feature.has_string_stats() &&
+             feature.string_stats().has_common_stats()) {
+    common_stats = &feature.string_stats().common_stats();
+  }
+  if (common_stats == nullptr) {
+    return false;
+  }
+  *num_examples = common_stats->num_non_missing() + common_stats->num_missing();
+  return true;
+}
+
+Status GetNumCustomStat(const FeatureNameStatistics& feature,
+                        const string& name, double* value) {
+  for (const CustomStatistic& custom_stat : feature.custom_stats()) {
+    if (custom_stat.name() == name) {
+      *value = custom_stat.num();
+      return Status::OK();
+    }
+  }
+  return errors::InvalidArgument("Custom statistics ", name,
+                                 " not found in the feature statistics.");
+}
+
+Status ParseDatasetFeatureStatistics(const string& serialized,
+                                     DatasetFeatureStatistics* stats) {
+  if (!stats->ParseFromString(serialized)) {
+    return errors::InvalidArgument(
+        "Failed to parse DatasetFeatureStatistics proto.");
+  }
+  return Status::OK();
+}
+
+Status ParsePartialStats(const std::vector<string>& serialized_partial_stats,
+                         std::vector<DatasetFeatureStatistics>* partial_stats) {
+  partial_stats->resize(serialized_partial_stats.size());
+  for (int i = 0; i < serialized_partial_stats.size(); ++i) {
+    TF_RETURN_IF_ERROR(ParseDatasetFeatureStatistics(
+        serialized_partial_stats[i], &(*partial_stats)[i]));
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
+void MergeDatasetFeatureStatistics(
+    std::vector<DatasetFeatureStatistics>* partial_stats,
+    DatasetFeatureStatistics* result) {
+  result->Clear();
+  // Index of the merged stats of each feature in result->features().
+  std::map<Path, int> feature_index;
+  for (DatasetFeatureStatistics& partial : *partial_stats) {
+    for (auto& cross_feature : *partial.mutable_cross_features()) {
+      result->add_cross_features()->Swap(&cross_feature);
+    }
+    for (FeatureNameStatistics& feature : *partial.mutable_features()) {
+      const auto inserted = feature_index.emplace(
+          Path(feature.path()), result->features_size());
+      if (inserted.second) {
+        result->add_features()->Swap(&feature);
+      } else {
+        FeatureNameStatistics* merged =
+            result->mutable_features(inserted.first->second);
+        // MergeFrom would concatenate repeated fields which is not what we
+        // want for path.step.
+        merged->mutable_path()->clear_step();
+        merged->MergeFrom(feature);
+      }
+    }
+  }
+  for (const FeatureNameStatistics& feature : result->features()) {
+    int64 num_examples;
+    if (GetNumExamplesFromCommonStats(feature, &num_examples)) {
+      result->set_num_examples(num_examples);
+      break;
+    }
+  }
+}
+
+Status MergeDatasetFeatureStatistics(
+    const std::vector<string>& serialized_partial_stats,
+    string* serialized_result) {
+  std::vector<DatasetFeatureStatistics> partial_stats;
+  TF_RETURN_IF_ERROR(ParsePartialStats(serialized_partial_stats,
+                                       &partial_stats));
+  DatasetFeatureStatistics result;
+  MergeDatasetFeatureStatistics(&partial_stats, &result);
+  if (!result.SerializeToString(serialized_result)) {
+    return errors::Internal(
+        "Could not serialize the merged DatasetFeatureStatistics proto.");
+  }
+  return Status::OK();
+}
+
+Status UpdateExampleAndMissingCount(DatasetFeatureStatistics* stats) {
+  if (stats->features().empty()) {
+    return Status::OK();
+  }
+  const Path dummy_feature_path(std::vector<string>{kDummyFeatureName});
+  int dummy_feature_index = -1;
+  for (int i = 0; i < stats->features_size(); ++i) {
+    if (Path(stats->features(i).path()) == dummy_feature_path) {
+      dummy_feature_index = i;
+      break;
+    }
+  }
+  if (dummy_feature_index < 0) {
+    return errors::InvalidArgument("Feature ", kDummyFeatureName,
+                                   " not found in the dataset statistics.");
+  }
+  double num_examples;
+  double weighted_num_examples;
+  const FeatureNameStatistics& dummy_feature =
+      stats->features(dummy_feature_index);
+  TF_RETURN_IF_ERROR(
+      GetNumCustomStat(dummy_feature, kNumExamplesKey, &num_examples));
+  TF_RETURN_IF_ERROR(GetNumCustomStat(dummy_feature, kWeightedNumExamplesKey,
+                                      &weighted_num_examples));
+  stats->mutable_features()->DeleteSubrange(dummy_feature_index, 1);
+
+  for (FeatureNameStatistics& feature : *stats->mutable_features()) {
+    // For features nested under a STRUCT feature, their num_missing is computed
+    // in the basic stats generator (because their num_missing is relative to
+    // their parent's value count).
+    if (feature.path().step_size() > 1) {
+      continue;
+    }
+    CommonStatistics* common_stats = GetMutableCommonStats(&feature);
+    if (common_stats == nullptr) {
+      continue;
+    }
+    if (num_examples < common_stats->num_non_missing()) {
+      return errors::InvalidArgument(
+          "Total number of examples: ", num_examples,
+          " is less than number of non missing examples: ",
+          common_stats->num_non_missing(), " for feature ",
+          Path(feature.path()).Serialize(), ".");
+    }
+    const int64 num_missing =
+        static_cast<int64>(num_examples - common_stats->num_non_missing());
+    common_stats->set_num_missing(num_missing);
+    if (common_stats->presence_and_valency_stats_size() > 0) {
+      common_stats->mutable_presence_and_valency_stats(0)->set_num_missing(
+          num_missing);
+    }
+    if (weighted_num_examples != 0) {
+      const double weighted_num_missing =
+          weighted_num_examples -
+          common_stats->weighted_common_stats().num_non_missing();
+      common_stats->mutable_weighted_common_stats()->set_num_missing(
+          weighted_num_missing);
+      if (common_stats->weighted_presence_and_valency_stats_size() > 0) {
+        common_stats->mutable_weighted_presence_and_valency_stats(0)
+            ->set_num_missing(weighted_num_missing);
+      }
+    }
+  }
+  stats->set_num_examples(static_cast<int64>(num_examples));
+  stats->set_weighted_num_examples(weighted_num_examples);
+  return Status::OK();
+}
+
+Status MakeDatasetFeatureStatisticsList(
+    const std::vector<string>& serialized_stats,
+    string* serialized_stats_list) {
+  DatasetFeatureStatisticsList result;
+  for (const string& serialized : serialized_stats) {
+    DatasetFeatureStatistics* stats = result.add_datasets();
+    TF_RETURN_IF_ERROR(ParseDatasetFeatureStatistics(serialized, stats));
+    // We update the example count for the dataset and the missing count for
+    // all the features, using the number of examples computed separately by
+    // NumExamplesStatsGenerator. This avoids ignoring example counts for
+    // features which may be completely missing in a shard.
+    TF_RETURN_IF_ERROR(UpdateExampleAndMissingCount(stats));
+  }
+  if (serialized_stats.empty()) {
+    // If there are no examples, output a dataset with num_examples == 0
+    // instead of an empty DatasetFeatureStatisticsList.
+    result.add_datasets()->set_num_examples(0);
+  }
+  if (!result.SerializeToString(serialized_stats_list)) {
+    return errors::Internal(
+        "Could not serialize the DatasetFeatureStatisticsList proto.");
+  }
+  return Status::OK();
+}
+
+Status MergeAndFinalizeDatasetFeatureStatistics(
+    const std::vector<string>& serialized_partial_stats,
+    string* serialized_stats_list) {
+  std::vector<DatasetFeatureStatistics> partial_stats;
+  TF_RETURN_IF_ERROR(ParsePartialStats(serialized_partial_stats,
+                                       &partial_stats));
+  DatasetFeatureStatisticsList result;
+  DatasetFeatureStatistics* stats = result.add_datasets();
+  MergeDatasetFeatureStatistics(&partial_stats, stats);
+  TF_RETURN_IF_ERROR(UpdateExampleAndMissingCount(stats));
+  if (!result.SerializeToString(serialized_stats_list)) {
+    return errors::Internal(
+        "Could not serialize the DatasetFeatureStatisticsList proto.");
+  }
+  return Status::OK();
+}
+
+}  // namespace data_validation
+}  // namespace tensorflow
@@ -0,0 +1,74 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Utilities for merging the partial DatasetFeatureStatistics protos produced
+// by the statistics generators and for finalizing the merged result.
+#ifndef TENSORFLOW_DATA_VALIDATION_ANOMALIES_STATISTICS_MERGE_UTIL_H_
+#define TENSORFLOW_DATA_VALIDATION_ANOMALIES_STATISTICS_MERGE_UTIL_H_
+
+#include <vector>
+
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow_metadata/proto/v0/statistics.pb.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+// Merges the partial statistics in <partial_stats> into <result>.
+// FeatureNameStatistics protos with the same path are merged field-wise with
+// protobuf MergeFrom semantics, except for path.step which is never
+// concatenated. Features appear in <result> in the order in which they are
+// first seen. Cross feature statistics are concatenated. num_examples is set
+// from the common stats of the first merged feature that has them.
+// The protos in <partial_stats> are consumed (their contents may be moved into
+// <result>).
+void MergeDatasetFeatureStatistics(
+    std::vector<metadata::v0::DatasetFeatureStatistics>* partial_stats,
+    metadata::v0::DatasetFeatureStatistics* result);
+
+// Same as above, but takes serialized DatasetFeatureStatistics protos and
+// outputs the serialized merged proto.
+Status MergeDatasetFeatureStatistics(
+    const std::vector<string>& serialized_partial_stats,
+    string* serialized_result);
+
+// Updates the example count of <stats> and the missing count of all its
+// top-level features, using the example counts stored in the custom stats of
+// the internal dummy feature computed by NumExamplesStatsGenerator. The dummy
+// feature is removed from <stats>. Does nothing if <stats> has no features.
+Status UpdateExampleAndMissingCount(
+    metadata::v0::DatasetFeatureStatistics* stats);
+
+// Constructs a DatasetFeatureStatisticsList from the serialized (merged)
+// DatasetFeatureStatistics protos in <serialized_stats>, finalizing each of
+// them with UpdateExampleAndMissingCount. If <serialized_stats> is empty, the
+// output list contains a single dataset with num_examples == 0.
+Status MakeDatasetFeatureStatisticsList(
+    const std::vector<string>& serialized_stats,
+    string* serialized_stats_list);
+
+// Merges the serialized partial statistics of a single dataset and outputs the
+// serialized finalized DatasetFeatureStatisticsList containing it. This is
+// equivalent to calling MergeDatasetFeatureStatistics followed by
+// MakeDatasetFeatureStatisticsList, without the intermediate serialization.
+Status MergeAndFinalizeDatasetFeatureStatistics(
+    const std::vector<string>& serialized_partial_stats,
+    string* serialized_stats_list);
+
+}  // namespace data_validation
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_DATA_VALIDATION_ANOMALIES_STATISTICS_MERGE_UTIL_H_
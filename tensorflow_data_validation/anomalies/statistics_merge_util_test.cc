@@ -0,0 +1,282 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/statistics_merge_util.h"
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "tensorflow_data_validation/anomalies/test_util.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow_metadata/proto/v0/statistics.pb.h"
+
+namespace tensorflow {
+namespace data_validation {
+namespace {
+
+using ::tensorflow::metadata::v0::DatasetFeatureStatistics;
+using ::tensorflow::metadata::v0::DatasetFeatureStatisticsList;
+using testing::EqualsProto;
+using testing::ParseTextProtoOrDie;
+
+// Adds the dummy feature holding the example counts to <stats>.
+void AddDummyFeature(double num_examples, double weighted_num_examples,
+                     DatasetFeatureStatistics* stats) {
+  *stats->add_features() = ParseTextProtoOrDie<
+      metadata::v0::FeatureNameStatistics>(R"(
+    path { step: "__TFDV_INTERNAL_FEATURE__" }
+    custom_stats { name: "__NUM_EXAMPLES__" }
+    custom_stats { name: "__WEIGHTED_NUM_EXAMPLES__" })");
+  stats->mutable_features()->rbegin()->mutable_custom_stats(0)->set_num(
+      num_examples);
+  stats->mutable_features()->rbegin()->mutable_custom_stats(1)->set_num(
+      weighted_num_examples);
+}
+
+TEST(StatisticsMergeUtilTest, MergeDatasetFeatureStatistics) {
+  std::vector<DatasetFeatureStatistics> partial_stats = {
+      ParseTextProtoOrDie<DatasetFeatureStatistics>(R"(
+        num_examples: 7
+        features: {
+          path { step: "feature1" }
+          type: STRING
+          string_stats: {
+            common_stats: {
+              num_missing: 3
+              num_non_missing: 4
+              min_num_values: 1
+              max_num_values: 1
+            }
+          }
+        })"),
+      ParseTextProtoOrDie<DatasetFeatureStatistics>(R"(
+        features: {
+          path { step: "feature2" }
+          type: INT
+          num_stats: { mean: 2.0 }
+        }
+        features: {
+          path { step: "feature1" }
+          type: STRING
+          string_stats: { unique: 3 }
+        }
+        cross_features: {
+          path_x { step: "feature1" }
+          path_y { step: "feature2" }
+        })")};
+  DatasetFeatureStatistics result;
+  MergeDatasetFeatureStatistics(&partial_stats, &result);
+  EXPECT_THAT(result, EqualsProto(R"(
+    num_examples: 7
+    features: {
+      path { step: "feature1" }
+      type: STRING
+      string_stats: {
+        common_stats: {
+          num_missing: 3
+          num_non_missing: 4
+          min_num_values: 1
+          max_num_values: 1
+        }
+        unique: 3
+      }
+    }
+    features: {
+      path { step: "feature2" }
+      type: INT
+      num_stats: { mean: 2.0 }
+    }
+    cross_features: {
+      path_x { step: "feature1" }
+      path_y { step: "feature2" }
+    })"));
+}
+
+TEST(StatisticsMergeUtilTest, MergeDatasetFeatureStatisticsEmpty) {
+  std::vector<DatasetFeatureStatistics> partial_stats;
+  DatasetFeatureStatistics result;
+  MergeDatasetFeatureStatistics(&partial_stats, &result);
+  EXPECT_THAT(result, EqualsProto(DatasetFeatureStatistics()));
+}
+
+TEST(StatisticsMergeUtilTest, MergeDatasetFeatureStatisticsSerialized) {
+  const std::vector<string> serialized_partial_stats = {
+      ParseTextProtoOrDie<DatasetFeatureStatistics>(R"(
+        features: {
+          path { step: "a" step: "b" }
+          num_stats: { common_stats: { num_non_missing: 2 } }
+        })")
+          .SerializeAsString(),
+      ParseTextProtoOrDie<DatasetFeatureStatistics>(R"(
+        features: {
+          path { step: "a" step: "b" }
+          num_stats: { common_stats: { num_missing: 1 } }
+        })")
+          .SerializeAsString()};
+  string serialized_result;
+  TF_ASSERT_OK(MergeDatasetFeatureStatistics(serialized_partial_stats,
+                                             &serialized_result));
+  DatasetFeatureStatistics result;
+  ASSERT_TRUE(result.ParseFromString(serialized_result));
+  EXPECT_THAT(result, EqualsProto(R"(
+    num_examples: 3
+    features: {
+      path { step: "a" step: "b" }
+      num_stats: { common_stats: { num_non_missing: 2 num_missing: 1 } }
+    })"));
+}
+
+TEST(StatisticsMergeUtilTest, MergeDatasetFeatureStatisticsInvalidInput) {
+  string serialized_result;
+  EXPECT_FALSE(
+      MergeDatasetFeatureStatistics({"not a proto"}, &serialized_result).ok());
+}
+
+TEST(StatisticsMergeUtilTest, UpdateExampleAndMissingCount) {
+  DatasetFeatureStatistics stats =
+      ParseTextProtoOrDie<DatasetFeatureStatistics>(R"(
+        features: {
+          path { step: "feature1" }
+          type: STRING
+          string_stats {
+            common_stats {
+              num_non_missing: 3
+              presence_and_valency_stats { num_non_missing: 3 }
+              weighted_common_stats { num_non_missing: 1.5 }
+              weighted_presence_and_valency_stats { num_non_missing: 1.5 }
+            }
+          }
+        }
+        features: {
+          path { step: "feature1" step: "child" }
+          type: INT
+          num_stats { common_stats { num_non_missing: 1 num_missing: 2 } }
+        }
+        features: {
+          path { step: "sparse_feature" }
+          custom_stats { name: "missing_value" num: 1 }
+        })");
+  AddDummyFeature(7, 4.5, &stats);
+  TF_ASSERT_OK(UpdateExampleAndMissingCount(&stats));
+  EXPECT_THAT(stats, EqualsProto(R"(
+    num_examples: 7
+    weighted_num_examples: 4.5
+    features: {
+      path { step: "feature1" }
+      type: STRING
+      string_stats {
+        common_stats {
+          num_non_missing: 3
+          num_missing: 4
+          presence_and_valency_stats { num_non_missing: 3 num_missing: 4 }
+          weighted_common_stats { num_non_missing: 1.5 num_missing: 3.0 }
+          weighted_presence_and_valency_stats {
+            num_non_missing: 1.5
+            num_missing: 3.0
+          }
+        }
+      }
+    }
+    features: {
+      path { step: "feature1" step: "child" }
+      type: INT
+      num_stats { common_stats { num_non_missing: 1 num_missing: 2 } }
+    }
+    features: {
+      path { step: "sparse_feature" }
+      custom_stats { name: "missing_value" num: 1 }
+    })"));
+}
+
+TEST(StatisticsMergeUtilTest, UpdateExampleAndMissingCountNoFeatures) {
+  DatasetFeatureStatistics stats;
+  TF_ASSERT_OK(UpdateExampleAndMissingCount(&stats));
+  EXPECT_THAT(stats, EqualsProto(DatasetFeatureStatistics()));
+}
+
+TEST(StatisticsMergeUtilTest, UpdateExampleAndMissingCountNoDummyFeature) {
+  DatasetFeatureStatistics stats =
+      ParseTextProtoOrDie<DatasetFeatureStatistics>(R"(
+        features: {
+          path { step: "feature1" }
+          num_stats { common_stats { num_non_missing: 3 } }
+        })");
+  EXPECT_FALSE(UpdateExampleAndMissingCount(&stats).ok());
+}
+
+TEST(StatisticsMergeUtilTest, UpdateExampleAndMissingCountTooManyNonMissing) {
+  DatasetFeatureStatistics stats =
+      ParseTextProtoOrDie<DatasetFeatureStatistics>(R"(
+        features: {
+          path { step: "feature1" }
+          num_stats { common_stats { num_non_missing: 3 } }
+        })");
+  AddDummyFeature(2, 0, &stats);
+  EXPECT_FALSE(UpdateExampleAndMissingCount(&stats).ok());
+}
+
+TEST(StatisticsMergeUtilTest, MakeDatasetFeatureStatisticsListEmpty) {
+  string serialized_list;
+  TF_ASSERT_OK(MakeDatasetFeatureStatisticsList({}, &serialized_list));
+  DatasetFeatureStatisticsList result;
+  ASSERT_TRUE(result.ParseFromString(serialized_list));
+  EXPECT_THAT(result, EqualsProto(R"(datasets { num_examples: 0 })"));
+}
+
+TEST(StatisticsMergeUtilTest, MergeAndFinalizeDatasetFeatureStatistics) {
+  DatasetFeatureStatistics num_examples_stats;
+  AddDummyFeature(7, 0, &num_examples_stats);
+  const std::vector<string> serialized_partial_stats = {
+      ParseTextProtoOrDie<DatasetFeatureStatistics>(R"(
+        features: {
+          path { step: "feature1" }
+          type: STRING
+          string_stats { common_stats { num_non_missing: 3 } }
+        })")
+          .SerializeAsString(),
+      num_examples_stats.SerializeAsString()};
+  const DatasetFeatureStatisticsList expected =
+      ParseTextProtoOrDie<DatasetFeatureStatisticsList>(R"(
+        datasets {
+          num_examples: 7
+          features: {
+            path { step: "feature1" }
+            type: STRING
+            string_stats { common_stats { num_non_missing: 3 num_missing: 4 } }
+          }
+        })");
+
+  string serialized_list;
+  TF_ASSERT_OK(MergeAndFinalizeDatasetFeatureStatistics(
+      serialized_partial_stats, &serialized_list));
+  DatasetFeatureStatisticsList result;
+  ASSERT_TRUE(result.ParseFromString(serialized_list));
+  EXPECT_THAT(result, EqualsProto(expected));
+
+  // Merging and finalizing separately gives the same result.
+  string serialized_merged;
+  TF_ASSERT_OK(MergeDatasetFeatureStatistics(serialized_partial_stats,
+                                             &serialized_merged));
+  TF_ASSERT_OK(
+      MakeDatasetFeatureStatisticsList({serialized_merged}, &serialized_list));
+  ASSERT_TRUE(result.ParseFromString(serialized_list));
+  EXPECT_THAT(result, EqualsProto(expected));
+}
+
+}  // namespace
+}  // namespace data_validation
+}  // namespace tensorflow
@@ -15,12 +15,14 @@ limitations under the License.
 
 #include "tensorflow_data_validation/anomalies/statistics_view.h"
 
+#include <algorithm>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/types/optional.h"
-#include "tensorflow_data_validation/anomalies/map_util.h"
+#include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/platform/types.h"
@@ -30,9 +32,14 @@ namespace tensorflow {
 namespace data_validation {
 
 namespace {
+using ::tensorflow::metadata::v0::CommonStatistics;
+using ::tensorflow::metadata::v0::CustomStatistic;
 using ::tensorflow::metadata::v0::DatasetFeatureStatistics;
 using ::tensorflow::metadata::v0::FeatureNameStatistics;
 using ::tensorflow::metadata::v0::Histogram;
+using ::tensorflow::metadata::v0::NumericStatistics;
+using ::tensorflow::metadata::v0::RankHistogram;
+using ::tensorflow::metadata::v0::StringStatistics;
 using ::tensorflow::protobuf::RepeatedPtrField;
 
 // Returns true if a is a strict prefix of b.
@@ -41,14 +48,215 @@ const bool IsStrictPrefix(const string& a, const string& b) {
 }
 
 // Returns true if the feature has empty stats.
-const bool HasEmptyStats(const FeatureNameStatistics& feature) {
-  if (feature.stats_case() == FeatureNameStatistics::STATS_NOT_SET &&
-      feature.custom_stats_size() == 0) {
+const bool HasEmptyStats(const DatasetStatsBackend& backend, int index) {
+  if (backend.stats_case(index) == FeatureNameStatistics::STATS_NOT_SET &&
+      backend.custom_stats(index).empty()) {
     return true;
   }
   return false;
 }
 
+// A backend reading the statistics from a DatasetFeatureStatistics proto.
+class ProtoDatasetStatsBackend : public DatasetStatsBackend {
+ public:
+  explicit ProtoDatasetStatsBackend(DatasetFeatureStatistics data)
+      : owned_data_(new DatasetFeatureStatistics(std::move(data))),
+        data_(*owned_data_) {}
+
+  // Reads <data>, which must outlive the backend.
+  explicit ProtoDatasetStatsBackend(const DatasetFeatureStatistics* data)
+      : data_(*data) {}
+
+  double num_examples() const override { return data_.num_examples(); }
+
+  double weighted_num_examples() const override {
+    return data_.weighted_num_examples();
+  }
+
+  int num_features() const override { return data_.features_size(); }
+
+  FeatureNameStatistics::FieldIdCase field_id_case(int index) const override {
+    return feature(index).field_id_case();
+  }
+
+  string name(int index) const override { return feature(index).name(); }
+
+  Path path(int index) const override { return Path(feature(index).path()); }
+
+  FeatureNameStatistics::Type type(int index) const override {
+    return feature(index).type();
+  }
+
+  FeatureNameStatistics::StatsCase stats_case(int index) const override {
+    return feature(index).stats_case();
+  }
+
+  const CommonStatistics* common_stats(int index) const override {
+    const FeatureNameStatistics& data = feature(index);
+    if (data.has_num_stats()) {
+      return &data.num_stats().common_stats();
+    } else if (data.has_string_stats()) {
+      return &data.string_stats().common_stats();
+    } else if (data.has_bytes_stats()) {
+      return &data.bytes_stats().common_stats();
+    } else if (data.has_struct_stats()) {
+      return &data.struct_stats().common_stats();
+    }
+    return nullptr;
+  }
+
+  const NumericStatistics& num_stats(int index) const override {
+    return feature(index).num_stats();
+  }
+
+  const RepeatedPtrField<Histogram>& histograms(int index,
+                                                bool by_weight) const override {
+    return by_weight ? num_stats(index).weighted_numeric_stats().histograms()
+                     : num_stats(index).histograms();
+  }
+
+  const RankHistogram& rank_histogram(int index,
+                                      bool by_weight) const override {
+    const StringStatistics& string_stats = feature(index).string_stats();
+    return by_weight ? string_stats.weighted_string_stats().rank_histogram()
+                     : string_stats.rank_histogram();
+  }
+
+  absl::optional<uint64> num_unique(int index) const override {
+    if (feature(index).has_string_stats()) {
+      return feature(index).string_stats().unique();
+    }
+    return absl::nullopt;
+  }
+
+  const RepeatedPtrField<CustomStatistic>& custom_stats(
+      int index) const override {
+    return feature(index).custom_stats();
+  }
+
+ private:
+  // Check-fails if index is out of range.
+  const FeatureNameStatistics& feature(int index) const {
+    CHECK_GE(index, 0);
+    CHECK_LT(index, data_.features_size());
+    return data_.features(index);
+  }
+
+  // The statistics, if owned by the backend.
+  const std::unique_ptr<const DatasetFeatureStatistics> owned_data_;
+  const DatasetFeatureStatistics& data_;
+};
+
+// A backend concatenating the features of several backends.
+class ShardedDatasetStatsBackend : public DatasetStatsBackend {
+ public:
+  explicit ShardedDatasetStatsBackend(
+      std::vector<std::shared_ptr<const DatasetStatsBackend>> shards)
+      : shards_(std::move(shards)) {
+    int num_features = 0;
+    for (const auto& shard : shards_) {
+      num_features += shard->num_features();
+      shard_ends_.push_back(num_features);
+    }
+  }
+
+  double num_examples() const override {
+    return shards_.empty() ? 0 : shards_.front()->num_examples();
+  }
+
+  double weighted_num_examples() const override {
+    return shards_.empty() ? 0 : shards_.front()->weighted_num_examples();
+  }
+
+  int num_features() const override {
+    return shard_ends_.empty() ? 0 : shard_ends_.back();
+  }
+
+  FeatureNameStatistics::FieldIdCase field_id_case(int index) const override {
+    const int shard = GetShard(index);
+    return shards_[shard]->field_id_case(GetShardIndex(shard, index));
+  }
+
+  string name(int index) const override {
+    const int shard = GetShard(index);
+    return shards_[shard]->name(GetShardIndex(shard, index));
+  }
+
+  Path path(int index) const override {
+    const int shard = GetShard(index);
+    return shards_[shard]->path(GetShardIndex(shard, index));
+  }
+
+  FeatureNameStatistics::Type type(int index) const override {
+    const int shard = GetShard(index);
+    return shards_[shard]->type(GetShardIndex(shard, index));
+  }
+
+  FeatureNameStatistics::StatsCase stats_case(int index) const override {
+    const int shard = GetShard(index);
+    return shards_[shard]->stats_case(GetShardIndex(shard, index));
+  }
+
+  const CommonStatistics* common_stats(int index) const override {
+    const int shard = GetShard(index);
+    return shards_[shard]->common_stats(GetShardIndex(shard, index));
+  }
+
+  const NumericStatistics& num_stats(int index) const override {
+    const int shard = GetShard(index);
+    return shards_[shard]->num_stats(GetShardIndex(shard, index));
+  }
+
+  const RepeatedPtrField<Histogram>& histograms(int index,
+                                                bool by_weight) const override {
+    const int shard = GetShard(index);
+    return shards_[shard]->histograms(GetShardIndex(shard, index), by_weight);
+  }
+
+  const RankHistogram& rank_histogram(int index,
+                                      bool by_weight) const override {
+    const int shard = GetShard(index);
+    return shards_[shard]->rank_histogram(GetShardIndex(shard, index),
+                                          by_weight);
+  }
+
+  absl::optional<uint64> num_unique(int index) const override {
+    const int shard = GetShard(index);
+    return shards_[shard]->num_unique(GetShardIndex(shard, index));
+  }
+
+  const RepeatedPtrField<CustomStatistic>& custom_stats(
+      int index) const override {
+    const int shard = GetShard(index);
+    return shards_[shard]->custom_stats(GetShardIndex(shard, index));
+  }
+
+  Status status() const override {
+    for (const auto& shard : shards_) {
+      TF_RETURN_IF_ERROR(shard->status());
+    }
+    return Status::OK();
+  }
+
+ private:
+  // Returns the shard holding the feature at <index>.
+  int GetShard(int index) const {
+    CHECK_GE(index, 0);
+    CHECK_LT(index, num_features());
+    return std::upper_bound(shard_ends_.begin(), shard_ends_.end(), index) -
+           shard_ends_.begin();
+  }
+
+  // Returns the index of the feature at <index> within <shard>.
+  int GetShardIndex(int shard, int index) const {
+    return shard == 0 ? index : index - shard_ends_[shard - 1];
+  }
+
+  const std::vector<std::shared_ptr<const DatasetStatsBackend>> shards_;
+  // The features of shard i are [shard_ends_[i - 1], shard_ends_[i]).
+  std::vector<int> shard_ends_;
+};
+
 }  // namespace
 
 // Context of a feature.
@@ -58,67 +266,80 @@ struct FeatureContext {
   // Index of children of the feature.
   std::vector<int> child_indices;
   Path path;
+  absl::optional<InternedPath> interned_path;
 };
 
-// A class that summarizes the information from the DatasetFeatureStatistics.
+// A class that summarizes the information from a DatasetStatsBackend.
 // Takes O(#features log #features) time to initialize,
 // O(# features) space, and:
 // GetRootFeatures() takes O(# features) time
 // GetChildren() takes O(# children) time
 // GetParent() takes O(1) time
-// GetByPath() takes O(log # features) time.
+// GetByPath() takes O(1) time for an InternedPath, and O(path length) time
+// for a Path.
 class DatasetStatsViewImpl {
  public:
   DatasetStatsViewImpl(
-      const DatasetFeatureStatistics& data, bool by_weight,
+      std::shared_ptr<const DatasetStatsBackend> backend, bool by_weight,
       const absl::optional<string>& environment,
       const std::shared_ptr<DatasetStatsView>& previous_span,
       const std::shared_ptr<DatasetStatsView>& serving,
-      const std::shared_ptr<DatasetStatsView>& previous_version)
-      : data_(data),
+      const std::shared_ptr<DatasetStatsView>& previous_version,
+      std::shared_ptr<PathInterner> path_interner)
+      : backend_(std::move(backend)),
         by_weight_(by_weight),
         environment_(environment),
         previous_span_(previous_span),
         serving_(serving),
-        previous_version_(previous_version) {
-    const auto& features = data_.features();
-    if (std::all_of(features.begin(), features.end(),
-                    [](const FeatureNameStatistics& f) {
-                      // The case of empty feature name is covered by
-                      // FIELD_ID_NOT_SET.
-                      return f.field_id_case() ==
-                                 FeatureNameStatistics::kName ||
-                             f.field_id_case() ==
-                                 FeatureNameStatistics::FIELD_ID_NOT_SET;
-                    })) {
+        previous_version_(previous_version),
+        path_interner_(path_interner != nullptr
+                           ? std::move(path_interner)
+                           : std::make_shared<PathInterner>()) {
+    int num_with_name = 0;
+    int num_with_path = 0;
+    for (int i = 0; i < backend_->num_features(); ++i) {
+      // The case of empty feature name is covered by FIELD_ID_NOT_SET.
+      if (backend_->field_id_case(i) == FeatureNameStatistics::kPath) {
+        ++num_with_path;
+      } else {
+        ++num_with_name;
+      }
+    }
+    if (num_with_path == 0) {
       InitializeWithFeatureName();
-    } else if (std::all_of(features.begin(), features.end(),
-                           [](const FeatureNameStatistics& f) {
-                             return f.field_id_case() ==
-                                    FeatureNameStatistics::kPath;
-                           })) {
+    } else if (num_with_name == 0) {
       InitializeWithFeaturePath();
     } else {
       LOG(QFATAL) << "Some features had .name and some features had .path. "
                      "This is unexpected. "
-                  << data_.DebugString();
+                  << num_with_name << " features had .name and "
+                  << num_with_path << " features had .path.";
     }
   }
 
   void InitializeWithFeaturePath() {
-    for (int i = 0; i < data_.features_size(); ++i) {
-      const FeatureNameStatistics& feature = data_.features(i);
-      path_location_[Path(feature.path())] = i;
+    // If several features have the same path, the last one wins.
+    for (int i = 0; i < backend_->num_features(); ++i) {
+      path_location_[path_interner_->Intern(backend_->path(i))] = i;
       context_[i] = FeatureContext();
     }
-    for (const auto& path_and_index : path_location_) {
-      const Path& path = path_and_index.first;
+    // Visit the features in path order, so that children are listed in path
+    // order.
+    std::vector<std::pair<InternedPath, int>> sorted_locations(
+        path_location_.begin(), path_location_.end());
+    std::sort(sorted_locations.begin(), sorted_locations.end(),
+              [](const std::pair<InternedPath, int>& a,
+                 const std::pair<InternedPath, int>& b) {
+                return a.first < b.first;
+              });
+    for (const auto& path_and_index : sorted_locations) {
+      const InternedPath& path = path_and_index.first;
       const int index = path_and_index.second;
       FeatureContext& context = context_[index];
-      context.path = path;
+      context.path = path.ToPath();
+      context.interned_path = path;
       if (!path.empty()) {
-        const Path parent_path = path.GetParent();
-        auto iter = path_location_.find(parent_path);
+        auto iter = path_location_.find(path.GetParent());
         if (iter != path_location_.end()) {
           context.parent_index = iter->second;
           context_[iter->second].child_indices.push_back(index);
@@ -129,20 +350,20 @@ class DatasetStatsViewImpl {
 
   void InitializeWithFeatureName() {
     // It takes O(n log n) time to construct location, a BST from the name
-    // of a feature to its location in data_.features().
+    // of a feature to its location in the backend.
     // Map from name to location.
-    // data_.features(location[foo]).name() == foo
+    // backend_->name(location[foo]) == foo
     std::map<string, int> location;
 
-    for (int i = 0; i < data_.features_size(); ++i) {
+    for (int i = 0; i < backend_->num_features(); ++i) {
       // TODO(b/124192588): This is a short term fix to ignore features with
       // empty stats. Remove this once we have added a unknown_stats message
       // in the stats proto which would keep track of common_stats for
       // completely missing features.
-      if (HasEmptyStats(data_.features(i))) {
+      if (HasEmptyStats(*backend_, i)) {
         continue;
       }
-      location[data_.features(i).name()] = i;
+      location[backend_->name(i)] = i;
       context_[i] = FeatureContext();
     }
 
@@ -162,44 +383,69 @@ class DatasetStatsViewImpl {
       const string& name = pair.first;
       int index = pair.second;
       while (!current_ancestors.empty() &&
-             !IsStrictPrefix(data_.features()[current_ancestors.back()].name(),
+             !IsStrictPrefix(backend_->name(current_ancestors.back()),
                              name)) {
         current_ancestors.pop_back();
       }
+      FeatureContext& context = context_.at(index);
       if (!current_ancestors.empty()) {
         int parent_index = current_ancestors.back();
-        const string& parent_name = data_.features(parent_index).name();
-        const string& name = data_.features(index).name();
-        context_.at(index).parent_index = parent_index;
-        context_.at(index).path = context_.at(parent_index).path.GetChild(
-            name.substr(parent_name.size() + 1));
-        context_.at(parent_index).child_indices.push_back(index);
+        const string parent_name = backend_->name(parent_index);
+        FeatureContext& parent_context = context_.at(parent_index);
+        const string step = name.substr(parent_name.size() + 1);
+        context.parent_index = parent_index;
+        context.path = parent_context.path.GetChild(step);
+        context.interned_path = parent_context.interned_path->GetChild(step);
+        parent_context.child_indices.push_back(index);
       } else {
-        context_.at(index).path = Path({data_.features(index).name()});
+        context.path = Path({name});
+        context.interned_path = path_interner_->root().GetChild(name);
       }
-      path_location_[context_.at(index).path] = index;
-      if (data_.features(index).type() ==
+      path_location_[*context.interned_path] = index;
+      if (backend_->type(index) ==
           tensorflow::metadata::v0::FeatureNameStatistics::STRUCT) {
         current_ancestors.push_back(index);
       }
     }
   }
 
-  const DatasetFeatureStatistics& data() const { return data_; }
+  const DatasetStatsBackend& backend() const { return *backend_; }
 
   absl::optional<FeatureStatsView> GetByPath(const DatasetStatsView& view,
                                              const Path& path) const {
+    // A path that was never interned is not the path of any feature.
+    const absl::optional<InternedPath> interned_path =
+        path_interner_->Find(path);
+    if (interned_path) {
+      auto ref = path_location_.find(*interned_path);
+      if (ref != path_location_.end()) {
+        return FeatureStatsView(ref->second, view);
+      }
+    }
+    LogMissingPath(view, path);
+    return absl::nullopt;
+  }
+
+  absl::optional<FeatureStatsView> GetByPath(const DatasetStatsView& view,
+                                             const InternedPath& path) const {
+    if (path.interner() != path_interner_.get()) {
+      // E.g. the path of a feature of a view with another interner.
+      return GetByPath(view, path.ToPath());
+    }
     auto ref = path_location_.find(path);
     if (ref == path_location_.end()) {
-      VLOG(0) << "DatasetStatsViewImpl::GetByPath() can't find: "
-              << path.Serialize();
-      for (const FeatureStatsView& feature_view : view.features()) {
-        VLOG(0) << "  DatasetStatsViewImpl::GetByPath(): path: "
-                << feature_view.GetPath().Serialize();
-      }
+      LogMissingPath(view, path.ToPath());
       return absl::nullopt;
-    } else {
-      return FeatureStatsView(ref->second, view);
+    }
+    return FeatureStatsView(ref->second, view);
+  }
+
+  void LogMissingPath(const DatasetStatsView& view, const Path& path) const {
+    VLOG(0) << "DatasetStatsViewImpl::GetByPath() can't find: "
+            << path.Serialize();
+    for (const FeatureStatsView& feature_view : view.features()) {
+      VLOG(0) << "  DatasetStatsViewImpl::GetByPath(): path: "
+              << feature_view.GetPath().Serialize();
     }
   }
 
@@ -207,6 +453,10 @@ class DatasetStatsViewImpl {
     return context_.at(view.index_).path;
   }
 
+  const InternedPath& GetInternedPath(const FeatureStatsView& view) const {
+    return *context_.at(view.index_).interned_path;
+  }
+
   absl::optional<FeatureStatsView> GetParent(
       const FeatureStatsView& view) const {
     absl::optional<int> opt_parent_index
@@ -231,7 +481,7 @@ class DatasetStatsViewImpl {
   friend DatasetStatsView;
 
   // Underlying data.
-  const DatasetFeatureStatistics data_;
+  const std::shared_ptr<const DatasetStatsBackend> backend_;
 
   // Whether DatasetFeatureStatistics is accessed by weight or not.
   const bool by_weight_;
@@ -250,49 +500,90 @@ class DatasetStatsViewImpl {
   // The previous version dataset stats (if available).
   const std::shared_ptr<DatasetStatsView> previous_version_;
 
-  /*********** Cached information below, derivable from data_ *****************/
+  /*********** Cached information below, derivable from backend_ **************/
 
   // Context of each feature: parents and children.
-  // parallel to features() array in data.
+  // Keyed by the index of the feature in the backend.
   std::map<int, FeatureContext> context_;
 
   // Map from path to the index of the FeatureStatistics containing the
   // statistics for that path.
-  std::map<Path, int> path_location_;
+  absl::flat_hash_map<InternedPath, int> path_location_;
+
+  // Interns strings for the users of the view. Thread-safe.
+  mutable StringInterner string_interner_;
+
+  // Interns the paths of the features. Shared with the other views of the
+  // same validation, if any.
+  const std::shared_ptr<PathInterner> path_interner_;
 };
 
+std::shared_ptr<const DatasetStatsBackend> MakeProtoDatasetStatsBackend(
+    DatasetFeatureStatistics data) {
+  return std::make_shared<ProtoDatasetStatsBackend>(std::move(data));
+}
+
+std::shared_ptr<const DatasetStatsBackend> MakeUnownedProtoDatasetStatsBackend(
+    const DatasetFeatureStatistics& data) {
+  return std::make_shared<ProtoDatasetStatsBackend>(&data);
+}
+
+std::shared_ptr<const DatasetStatsBackend> MakeShardedDatasetStatsBackend(
+    std::vector<std::shared_ptr<const DatasetStatsBackend>> shards) {
+  return std::make_shared<ShardedDatasetStatsBackend>(std::move(shards));
+}
+
 DatasetStatsView::DatasetStatsView(
     const DatasetFeatureStatistics& data, bool by_weight,
     const absl::optional<string>& environment,
     std::shared_ptr<DatasetStatsView> previous_span,
     std::shared_ptr<DatasetStatsView> serving,
     std::shared_ptr<DatasetStatsView> previous_version)
-    : impl_(new DatasetStatsViewImpl(data, by_weight, environment,
-                                     previous_span, serving,
-                                     previous_version)) {}
+    : impl_(new DatasetStatsViewImpl(
+          std::make_shared<ProtoDatasetStatsBackend>(data), by_weight,
+          environment, previous_span, serving, previous_version,
+          /*path_interner=*/nullptr)) {}
 
 DatasetStatsView::DatasetStatsView(const DatasetFeatureStatistics& data,
                                    bool by_weight)
-    : impl_(new DatasetStatsViewImpl(data, by_weight, absl::nullopt,
+    : impl_(new DatasetStatsViewImpl(
+          std::make_shared<ProtoDatasetStatsBackend>(data), by_weight,
+          absl::nullopt,
                                      std::shared_ptr<DatasetStatsView>(),
                                      std::shared_ptr<DatasetStatsView>(),
-                                     std::shared_ptr<DatasetStatsView>())) {}
+                                     std::shared_ptr<DatasetStatsView>(),
+                                     /*path_interner=*/nullptr)) {}
 
 DatasetStatsView::DatasetStatsView(
     const tensorflow::metadata::v0::DatasetFeatureStatistics& data)
-    : impl_(new DatasetStatsViewImpl(data, false, absl::nullopt,
+    : impl_(new DatasetStatsViewImpl(
+          std::make_shared<ProtoDatasetStatsBackend>(data), false,
+          absl::nullopt,
+                                     std::shared_ptr<DatasetStatsView>(),
                                      std::shared_ptr<DatasetStatsView>(),
                                      std::shared_ptr<DatasetStatsView>(),
-                                     std::shared_ptr<DatasetStatsView>())) {}
+                                     /*path_interner=*/nullptr)) {}
+
+DatasetStatsView::DatasetStatsView(
+    std::shared_ptr<const DatasetStatsBackend> backend, bool by_weight,
+    const absl::optional<string>& environment,
+    std::shared_ptr<DatasetStatsView> previous_span,
+    std::shared_ptr<DatasetStatsView> serving,
+    std::shared_ptr<DatasetStatsView> previous_version,
+    std::shared_ptr<PathInterner> path_interner)
+    : impl_(new DatasetStatsViewImpl(std::move(backend), by_weight,
+                                     environment, previous_span, serving,
+                                     previous_version,
+                                     std::move(path_interner))) {}
 
 std::vector<FeatureStatsView> DatasetStatsView::features() const {
   std::vector<FeatureStatsView> result;
-  for (int i = 0; i < impl_->data().features_size(); ++i) {
+  for (int i = 0; i < impl_->backend().num_features(); ++i) {
     // TODO(b/124192588): This is a short term fix to ignore features with
     // empty stats. Remove this once we have added a unknown_stats message
     // in the stats proto which would keep track of common_stats for
     // completely missing features.
-    if (HasEmptyStats(impl_->data().features(i))) {
+    if (HasEmptyStats(impl_->backend(), i)) {
       continue;
     }
     result.push_back(FeatureStatsView(i, *this));
@@ -300,18 +591,15 @@ std::vector<FeatureStatsView> DatasetStatsView::features() const {
   return result;
 }
 
-const tensorflow::metadata::v0::FeatureNameStatistics&
-DatasetStatsView::feature_name_statistics(int index) const {
-  CHECK_GE(index, 0);
-  CHECK_LT(index, impl_->data().features_size());
-  return impl_->data().features(index);
+const DatasetStatsBackend& DatasetStatsView::backend() const {
+  return impl_->backend();
 }
 
 double DatasetStatsView::GetNumExamples() const {
   if (impl_->by_weight_) {
-    return impl_->data().weighted_num_examples();
+    return impl_->backend().weighted_num_examples();
   } else {
-    return impl_->data().num_examples();
+    return impl_->backend().num_examples();
   }
 }
 
@@ -320,6 +608,11 @@ absl::optional<FeatureStatsView> DatasetStatsView::GetByPath(
   return impl_->GetByPath(*this, path);
 }
 
+absl::optional<FeatureStatsView> DatasetStatsView::GetByPath(
+    const InternedPath& path) const {
+  return impl_->GetByPath(*this, path);
+}
+
 absl::optional<FeatureStatsView> DatasetStatsView::GetParent(
     const FeatureStatsView& view) const {
   return impl_->GetParent(view);
@@ -329,6 +622,11 @@ const Path& DatasetStatsView::GetPath(const FeatureStatsView& view) const {
   return impl_->GetPath(view);
 }
 
+const InternedPath& DatasetStatsView::GetInternedPath(
+    const FeatureStatsView& view) const {
+  return impl_->GetInternedPath(view);
+}
+
 std::vector<FeatureStatsView> DatasetStatsView::GetChildren(
     const FeatureStatsView& view) const {
   return impl_->GetChildren(view);
@@ -346,7 +644,7 @@ std::vector<FeatureStatsView> DatasetStatsView::GetRootFeatures() const {
 
 // Returns true if the weighted statistics exist.
 bool DatasetStatsView::WeightedStatisticsExist() const {
-  if (impl_->data().weighted_num_examples() == 0.0) {
+  if (impl_->backend().weighted_num_examples() == 0.0) {
     return false;
   }
   for (const FeatureStatsView& feature_stats_view : features()) {
@@ -359,6 +657,14 @@ bool DatasetStatsView::WeightedStatisticsExist() const {
 
 bool DatasetStatsView::by_weight() const { return impl_->by_weight_; }
 
+StringInterner* DatasetStatsView::string_interner() const {
+  return &impl_->string_interner_;
+}
+
+const std::shared_ptr<PathInterner>& DatasetStatsView::path_interner() const {
+  return impl_->path_interner_;
+}
+
 const absl::optional<string>& DatasetStatsView::environment() const {
   return impl_->environment_;
 }
@@ -412,17 +718,13 @@ absl::optional<double> FeatureStatsView::GetFractionPresent() const {
 
 const tensorflow::metadata::v0::CommonStatistics&
 FeatureStatsView::GetCommonStatistics() const {
-  if (data().has_num_stats()) {
-    return data().num_stats().common_stats();
-  } else if (data().has_string_stats()) {
-    return data().string_stats().common_stats();
-  } else if (data().has_bytes_stats()) {
-    return data().bytes_stats().common_stats();
-  } else if (data().has_struct_stats()) {
-    return data().struct_stats().common_stats();
+  const tensorflow::metadata::v0::CommonStatistics* common_stats =
+      backend().common_stats(index_);
+  if (common_stats != nullptr) {
+    return *common_stats;
   }
-  LOG(FATAL) << "Unknown statistics (or missing stats): "
-             << data().DebugString();
+  LOG(FATAL) << "Unknown statistics (or missing stats) for feature: "
+             << GetPath().Serialize();
 }
 
 std::vector<std::pair<int, int>> FeatureStatsView::GetMinMaxNumValues() const {
@@ -454,9 +756,7 @@ double FeatureStatsView::GetNumPresent() const {
 std::map<string, double> FeatureStatsView::GetStringValuesWithCounts() const {
   std::map<string, double> result;
   const tensorflow::metadata::v0::RankHistogram& histogram =
-      (parent_view_.by_weight())
-          ? data().string_stats().weighted_string_stats().rank_histogram()
-          : data().string_stats().rank_histogram();
+      backend().rank_histogram(index_, parent_view_.by_weight());
   for (const tensorflow::metadata::v0::RankHistogram::Bucket& bucket :
        histogram.buckets()) {
     result.insert({bucket.label(), bucket.sample_count()});
@@ -464,14 +764,48 @@ std::map<string, double> FeatureStatsView::GetStringValuesWithCounts() const {
   return result;
 }
 
+std::vector<std::pair<StringInterner::Id, double>>
+FeatureStatsView::GetStringValueIdsWithCounts(StringInterner* interner) const {
+  const tensorflow::metadata::v0::RankHistogram& histogram =
+      backend().rank_histogram(index_, parent_view_.by_weight());
+  std::vector<absl::string_view> labels;
+  labels.reserve(histogram.buckets_size());
+  for (const tensorflow::metadata::v0::RankHistogram::Bucket& bucket :
+       histogram.buckets()) {
+    labels.push_back(bucket.label());
+  }
+  const std::vector<StringInterner::Id> ids = interner->InternAll(labels);
+  std::vector<std::pair<StringInterner::Id, double>> result;
+  result.reserve(ids.size());
+  for (int i = 0; i < ids.size(); ++i) {
+    result.emplace_back(ids[i], histogram.buckets(i).sample_count());
+  }
+  // As in GetStringValuesWithCounts, only the first count of a repeated label
+  // is kept.
+  const auto id_less = [](const std::pair<StringInterner::Id, double>& a,
+                          const std::pair<StringInterner::Id, double>& b) {
+    return a.first < b.first;
+  };
+  std::stable_sort(result.begin(), result.end(), id_less);
+  result.erase(std::unique(result.begin(), result.end(),
+                           [](const std::pair<StringInterner::Id, double>& a,
+                              const std::pair<StringInterner::Id, double>& b) {
+                             return a.first == b.first;
+                           }),
+               result.end());
+  return result;
+}
+
+StringInterner* FeatureStatsView::string_interner() const {
+  return parent_view_.string_interner();
+}
+
 absl::optional<Histogram> FeatureStatsView::GetStandardHistogram() const {
-  if (!data().has_num_stats()) {
+  if (backend().stats_case(index_) != FeatureNameStatistics::kNumStats) {
     return absl::nullopt;
   }
-  RepeatedPtrField<Histogram> histograms =
-      (parent_view_.by_weight())
-          ? data().num_stats().weighted_numeric_stats().histograms()
-          : data().num_stats().histograms();
+  const RepeatedPtrField<Histogram>& histograms =
+      backend().histograms(index_, parent_view_.by_weight());
   for (const auto& histogram : histograms) {
     if (histogram.type() ==
         Histogram::HistogramType::Histogram_HistogramType_STANDARD) {
@@ -496,13 +830,19 @@ bool FeatureStatsView::HasInvalidUTF8Strings() const {
   // generator writes __BYTES_VALUE__. See
   // tensorflow_data_validation/statistics/generators/top_k_uniques_stats_generator.py
   // // NOLINT
-  const string kInvalidString = "__BYTES_VALUE__";
-  return ContainsKey(GetStringValuesWithCounts(), kInvalidString);
+  constexpr char kInvalidString[] = "__BYTES_VALUE__";
+  for (const tensorflow::metadata::v0::RankHistogram::Bucket& bucket :
+       backend().rank_histogram(index_, parent_view_.by_weight()).buckets()) {
+    if (bucket.label() == kInvalidString) {
+      return true;
+    }
+  }
+  return false;
 }
 
 const tensorflow::metadata::v0::NumericStatistics& FeatureStatsView::num_stats()
     const {
-  return data().num_stats();
+  return backend().num_stats(index_);
 }
 
 // Returns the count of values appearing in the feature across all examples,
@@ -535,7 +875,7 @@ absl::optional<FeatureStatsView> FeatureStatsView::GetServing() const {
   absl::optional<DatasetStatsView> dataset_stats_view =
       parent_view_.GetServing();
   if (dataset_stats_view) {
-    return dataset_stats_view->GetByPath(GetPath());
+    return dataset_stats_view->GetByPath(GetInternedPath());
   }
   return absl::nullopt;
 }
@@ -544,7 +884,7 @@ absl::optional<FeatureStatsView> FeatureStatsView::GetPreviousSpan() const {
   absl::optional<DatasetStatsView> dataset_stats_view =
       parent_view_.GetPreviousSpan();
   if (dataset_stats_view) {
-    return dataset_stats_view->GetByPath(GetPath());
+    return dataset_stats_view->GetByPath(GetInternedPath());
   }
   return absl::nullopt;
 }
@@ -577,11 +917,12 @@ const Path& FeatureStatsView::GetPath() const {
   return parent_view_.GetPath(*this);
 }
 
+const InternedPath& FeatureStatsView::GetInternedPath() const {
+  return parent_view_.GetInternedPath(*this);
+}
+
 const absl::optional<uint64> FeatureStatsView::GetNumUnique() const {
-  if (data().has_string_stats()) {
-    return data().string_stats().unique();
-  }
-  return absl::nullopt;
+  return backend().num_unique(index_);
 }
 
 }  // namespace data_validation
@@ -23,7 +23,11 @@ limitations under the License.
 #include <vector>
 
 #include "absl/types/optional.h"
+#include "tensorflow_data_validation/anomalies/interned_path.h"
 #include "tensorflow_data_validation/anomalies/path.h"
+#include "tensorflow_data_validation/anomalies/string_interner.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow_metadata/proto/v0/schema.pb.h"
 #include "tensorflow_metadata/proto/v0/statistics.pb.h"
@@ -35,6 +39,83 @@ class FeatureStatsView;
 
 class DatasetStatsViewImpl;
 
+// The source of the statistics of a DatasetStatsView. Features are identified
+// by their index in [0, num_features()). Implementations may materialize the
+// statistics of a feature lazily (e.g. from a columnar or memory-mapped
+// file), but the references they return must remain valid for the lifetime of
+// the backend. Implementations must be thread-safe.
+class DatasetStatsBackend {
+ public:
+  virtual ~DatasetStatsBackend() = default;
+
+  virtual double num_examples() const = 0;
+
+  virtual double weighted_num_examples() const = 0;
+
+  virtual int num_features() const = 0;
+
+  // Whether the feature is identified by a name or by a path.
+  virtual tensorflow::metadata::v0::FeatureNameStatistics::FieldIdCase
+  field_id_case(int index) const = 0;
+
+  // The name of the feature. Empty if the feature is identified by a path.
+  virtual string name(int index) const = 0;
+
+  // The path of the feature. Empty if the feature is identified by a name.
+  virtual Path path(int index) const = 0;
+
+  virtual tensorflow::metadata::v0::FeatureNameStatistics::Type type(
+      int index) const = 0;
+
+  // Which of num_stats, string_stats, bytes_stats and struct_stats is set.
+  virtual tensorflow::metadata::v0::FeatureNameStatistics::StatsCase
+  stats_case(int index) const = 0;
+
+  // The common statistics of the feature, or nullptr if it has no stats.
+  virtual const tensorflow::metadata::v0::CommonStatistics* common_stats(
+      int index) const = 0;
+
+  // The numeric stats of the feature, or an empty object if there are none.
+  virtual const tensorflow::metadata::v0::NumericStatistics& num_stats(
+      int index) const = 0;
+
+  // The (weighted) numeric histograms of the feature.
+  virtual const protobuf::RepeatedPtrField<tensorflow::metadata::v0::Histogram>&
+  histograms(int index, bool by_weight) const = 0;
+
+  // The (weighted) rank histogram of the feature, or an empty histogram if it
+  // has no string stats.
+  virtual const tensorflow::metadata::v0::RankHistogram& rank_histogram(
+      int index, bool by_weight) const = 0;
+
+  // The number of unique values of the feature, if it has string stats.
+  virtual absl::optional<uint64> num_unique(int index) const = 0;
+
+  virtual const protobuf::RepeatedPtrField<
+      tensorflow::metadata::v0::CustomStatistic>&
+  custom_stats(int index) const = 0;
+
+  // The first error encountered materializing the statistics of a feature, if
+  // any. The statistics of a feature which failed to materialize are empty,
+  // so a validation over the backend must check this before reporting.
+  virtual Status status() const { return Status::OK(); }
+};
+
+// Returns a backend reading the statistics from <data>.
+std::shared_ptr<const DatasetStatsBackend> MakeProtoDatasetStatsBackend(
+    tensorflow::metadata::v0::DatasetFeatureStatistics data);
+
+// Same as MakeProtoDatasetStatsBackend, without copying <data>, which must
+// outlive the backend.
+std::shared_ptr<const DatasetStatsBackend> MakeUnownedProtoDatasetStatsBackend(
+    const tensorflow::metadata::v0::DatasetFeatureStatistics& data);
+
+// Returns a backend over the features of all the <shards>, in order. The
+// shards must hold disjoint sets of features of the same dataset; the example
+// counts are those of the first shard.
+std::shared_ptr<const DatasetStatsBackend> MakeShardedDatasetStatsBackend(
+    std::vector<std::shared_ptr<const DatasetStatsBackend>> shards);
+
 // Wrapper for statistics.
 // Designed to be passed by const reference.
 class DatasetStatsView {
@@ -55,6 +136,17 @@ class DatasetStatsView {
   explicit DatasetStatsView(
       const tensorflow::metadata::v0::DatasetFeatureStatistics& data);
 
+  // Views the statistics provided by <backend> instead of a proto. The paths
+  // of the features are interned by <path_interner>, or by an interner owned
+  // by the view if null. Views sharing an interner (e.g. the views of a
+  // validation) look up each other's features in O(1).
+  DatasetStatsView(std::shared_ptr<const DatasetStatsBackend> backend,
+                   bool by_weight, const absl::optional<string>& environment,
+                   std::shared_ptr<DatasetStatsView> previous_span,
+                   std::shared_ptr<DatasetStatsView> serving,
+                   std::shared_ptr<DatasetStatsView> previous_version,
+                   std::shared_ptr<PathInterner> path_interner = nullptr);
+
   // Perform shallow copies of object, sharing the same
   // DatasetStatsViewImpl through a shared_ptr.
   DatasetStatsView(const DatasetStatsView& other) = default;
@@ -71,14 +163,22 @@ class DatasetStatsView {
 
   bool by_weight() const;
 
+  // A string interner owned by the view, used to handle string values (e.g.
+  // rank histogram labels) as integer ids during a validation. The ids of
+  // values of the comparison datasets (previous span, serving, previous
+  // version) are also taken from it, so that they can be compared.
+  StringInterner* string_interner() const;
+
+  // The interner of the paths of the features, which the InternedPaths of the
+  // view must not outlive.
+  const std::shared_ptr<PathInterner>& path_interner() const;
+
   // If the path does not exist, returns absl::nullopt.
   absl::optional<FeatureStatsView> GetByPath(const Path& path) const;
+  absl::optional<FeatureStatsView> GetByPath(const InternedPath& path) const;
 
-  // Only call from FeatureStatsView::data().
-  // check-fails if index is out of range. However, should never fail if
-  // called from FeatureStatsView::data().
-  const tensorflow::metadata::v0::FeatureNameStatistics&
-  feature_name_statistics(int index) const;
+  // Only call from FeatureStatsView::backend().
+  const DatasetStatsBackend& backend() const;
 
   // Returns true if the weighted statistics exist.
   // Weighted stats must have feature parity with unweighted stats.
@@ -98,6 +198,8 @@ class DatasetStatsView {
 
   const Path& GetPath(const FeatureStatsView& view) const;
 
+  const InternedPath& GetInternedPath(const FeatureStatsView& view) const;
+
   // Gets the children of a FeatureStatsView.
   std::vector<FeatureStatsView> GetChildren(const FeatureStatsView& view) const;
 
@@ -125,12 +227,16 @@ class FeatureStatsView {
 
   const Path& GetPath() const;
 
+  // The path of the feature, interned. Cheaper to hash and compare than
+  // GetPath().
+  const InternedPath& GetInternedPath() const;
+
   const absl::optional<string>& environment() const {
     return parent_view_.environment();
   }
 
   tensorflow::metadata::v0::FeatureNameStatistics::Type type() const {
-    return data().type();
+    return backend().type(index_);
   }
 
   // Gets the FeatureType representing the physical type represented in
@@ -160,6 +266,14 @@ class FeatureStatsView {
   // counts. If there are no string stats, then it returns an empty map.
   std::map<string, double> GetStringValuesWithCounts() const;
 
+  // Same as GetStringValuesWithCounts, but returns the ids of the strings in
+  // <interner>, sorted by id, instead of copying the strings.
+  std::vector<std::pair<StringInterner::Id, double>>
+  GetStringValueIdsWithCounts(StringInterner* interner) const;
+
+  // The string interner of the dataset of this feature.
+  StringInterner* string_interner() const;
+
   // Returns the (weighted) standard histogram, if it exists for the feature.
   absl::optional<tensorflow::metadata::v0::Histogram> GetStandardHistogram()
       const;
@@ -194,7 +308,8 @@ class FeatureStatsView {
 
   // Returns the list of custom_stats of the underlying FeatureNameStatistics.
   std::vector<tensorflow::metadata::v0::CustomStatistic> custom_stats() const {
-    return {data().custom_stats().begin(), data().custom_stats().end()};
+    const auto& custom_stats = backend().custom_stats(index_);
+    return {custom_stats.begin(), custom_stats.end()};
   }
 
   std::vector<FeatureStatsView> GetChildren() const;
@@ -219,11 +334,8 @@ class FeatureStatsView {
 
   friend DatasetStatsViewImpl;
 
-  // Get a reference to the statistics from the parent.
-  // This should never check-fail.
-  const tensorflow::metadata::v0::FeatureNameStatistics& data() const {
-    return parent_view_.feature_name_statistics(index_);
-  }
+  // The source of the statistics of this feature, at index_.
+  const DatasetStatsBackend& backend() const { return parent_view_.backend(); }
 
   const tensorflow::metadata::v0::CommonStatistics& GetCommonStatistics() const;
   // Note that this field guarantees data_ is not a pointer to nowhere.
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow_data_validation/anomalies/statistics_view.h"
 
+#include <memory>
 #include <string>
 
 #include <gmock/gmock.h>
@@ -320,6 +321,36 @@ TEST(DatasetStatsView, GetParentGetPath) {
   ASSERT_TRUE(parent);
   EXPECT_EQ(parent->GetPath(), Path({"foo"}));
   EXPECT_EQ(actual->GetPath(), Path({"foo", "bar"}));
+  EXPECT_EQ(actual->GetInternedPath(),
+            stats.path_interner()->Intern(Path({"foo", "bar"})));
+  EXPECT_EQ(parent->GetInternedPath(), actual->GetInternedPath().GetParent());
+  absl::optional<FeatureStatsView> by_interned_path =
+      stats.GetByPath(actual->GetInternedPath());
+  ASSERT_TRUE(by_interned_path);
+  EXPECT_EQ(by_interned_path->GetPath(), Path({"foo", "bar"}));
+
+  // Paths interned by another interner are looked up by their steps.
+  PathInterner other_interner;
+  absl::optional<FeatureStatsView> by_other_interned_path =
+      stats.GetByPath(other_interner.Intern(Path({"foo", "bar"})));
+  ASSERT_TRUE(by_other_interned_path);
+  EXPECT_EQ(by_other_interned_path->GetPath(), Path({"foo", "bar"}));
+  EXPECT_FALSE(stats.GetByPath(other_interner.Intern(Path({"bar"}))));
+
+  // Views sharing an interner intern the same paths.
+  const auto path_interner = std::make_shared<PathInterner>();
+  const DatasetStatsView shared_stats(
+      MakeProtoDatasetStatsBackend(input), /*by_weight=*/false, absl::nullopt,
+      /*previous_span=*/nullptr, /*serving=*/nullptr,
+      /*previous_version=*/nullptr, path_interner);
+  const DatasetStatsView other_shared_stats(
+      MakeUnownedProtoDatasetStatsBackend(input), /*by_weight=*/false,
+      absl::nullopt,
+      /*previous_span=*/nullptr, /*serving=*/nullptr,
+      /*previous_version=*/nullptr, path_interner);
+  EXPECT_EQ(shared_stats.GetByPath(Path({"foo", "bar"}))->GetInternedPath(),
+            other_shared_stats.GetByPath(Path({"foo", "bar"}))
+                ->GetInternedPath());
 }
 
 // foo is not a parent of foo.bar, as they are both floats.
@@ -459,6 +490,32 @@ TEST(FeatureStatsView, GetStringValuesWithCountsBasicTest) {
                                            Pair("baz", 3)));
 }
 
+TEST(FeatureStatsView, GetStringValueIdsWithCounts) {
+  const FeatureNameStatistics input =
+      ParseTextProtoOrDie<FeatureNameStatistics>(R"(
+        name: 'bar'
+        type: STRING
+        string_stats: {
+          common_stats: { num_missing: 3 max_num_values: 2 }
+          unique: 3
+          rank_histogram: {
+            buckets: { label: "foo" sample_count: 1.5 }
+            buckets: { label: "bar" sample_count: 2 }
+            buckets: { label: "foo" sample_count: 3 }
+          }
+        })");
+
+  const DatasetForTesting dataset(input);
+  StringInterner* interner =
+      dataset.feature_stats_view().string_interner();
+  const StringInterner::Id bar_id = interner->Intern("bar");
+  const std::vector<std::pair<StringInterner::Id, double>> actual =
+      dataset.feature_stats_view().GetStringValueIdsWithCounts(interner);
+  // Only the first count of a repeated label is kept.
+  EXPECT_THAT(actual, ElementsAre(Pair(bar_id, 2),
+                                  Pair(*interner->Find("foo"), 1.5)));
+}
+
 TEST(FeatureStatsView, GetStringValuesWithCountsEmptyResult) {
   const FeatureNameStatistics input =
       ParseTextProtoOrDie<FeatureNameStatistics>(R"(
@@ -47,8 +47,8 @@ FeatureStatisticsToProtoConfig GetDefaultFeatureStatisticsToProtoConfig() {
 using ::tensorflow::metadata::v0::FeatureNameStatistics;
 using ::tensorflow::metadata::v0::StringDomain;
 using ::testing::ElementsAre;
-using ::testing::Field;
 using ::testing::HasSubstr;
+using ::testing::ResultOf;
 using testing::EqualsProto;
 using testing::ParseTextProtoOrDie;
 
@@ -59,6 +59,10 @@ struct EnumTypeIsValidTest {
   const bool expected;
 };
 
+string RenderedLongDescription(const Description& description) {
+  return RenderLongDescription(description);
+}
+
 StringDomain GetStringDomain(const string& name,
                              const std::vector<string>& values) {
   StringDomain string_domain;
@@ -397,7 +401,7 @@ TEST(EnumType, SurfaceFrequenciesOfMissingValues) {
                                .feature_stats_view(),
                            0, &string_domain);
     EXPECT_THAT(summary.descriptions,
-                ElementsAre(Field(&Description::long_description,
+                ElementsAre(ResultOf(RenderedLongDescription,
                                   HasSubstr("gamma (~30%)"))));
   }
 
@@ -433,7 +437,7 @@ TEST(EnumType, SurfaceFrequenciesOfMissingValues) {
                                .feature_stats_view(),
                            0, &string_domain);
     EXPECT_THAT(summary.descriptions,
-                ElementsAre(Field(&Description::long_description,
+                ElementsAre(ResultOf(RenderedLongDescription,
                                   HasSubstr("gamma (<1%)"))));
   }
 }
@@ -475,9 +479,9 @@ TEST(EnumType, DomainSizeLimit) {
     EXPECT_TRUE(summary.clear_field);
     EXPECT_THAT(summary.descriptions,
                 ElementsAre(
-                    Field(&Description::long_description,
+                    ResultOf(RenderedLongDescription,
                                   HasSubstr("gamma (~30%)")),
-                    Field(&Description::long_description,
+                    ResultOf(RenderedLongDescription,
                                   HasSubstr("too many values"))
                     ));
   }
@@ -516,7 +520,7 @@ TEST(EnumType, DomainSizeLimit) {
                            0, &string_domain);
     EXPECT_FALSE(summary.clear_field);
     EXPECT_THAT(summary.descriptions,
-                ElementsAre(Field(&Description::long_description,
+                ElementsAre(ResultOf(RenderedLongDescription,
                                   HasSubstr("gamma (~30%)"))));
   }
 }
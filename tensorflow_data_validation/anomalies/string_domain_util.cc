@@ -15,7 +15,8 @@ limitations under the License.
 
 #include "tensorflow_data_validation/anomalies/string_domain_util.h"
 
-#include <math.h>
+#include <algorithm>
+#include <iterator>
 #include <map>
 #include <set>
 #include <string>
@@ -23,13 +24,12 @@ limitations under the License.
 #include <vector>
 
 #include "absl/algorithm/container.h"
-#include "absl/strings/escaping.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
 #include "absl/types/optional.h"
-#include "tensorflow_data_validation/anomalies/map_util.h"
 #include "tensorflow_data_validation/anomalies/proto/feature_statistics_to_proto.pb.h"
 #include "tensorflow_data_validation/anomalies/statistics_view.h"
+#include "tensorflow_data_validation/anomalies/string_interner.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/platform/types.h"
@@ -43,24 +43,29 @@ namespace {
 using ::tensorflow::metadata::v0::StringDomain;
 using ::tensorflow::strings::Printf;
 
-std::set<string> GetStringDomainValues(const StringDomain& string_domain) {
-  std::set<string> result;
-  for (const string& value : string_domain.value()) {
-    result.insert(value);
-  }
-  return result;
+// Returns the sorted, distinct ids of the values of <string_domain>.
+std::vector<StringInterner::Id> GetStringDomainValueIds(
+    const StringDomain& string_domain, StringInterner* interner) {
+  std::vector<StringInterner::Id> ids =
+      interner->InternAll(std::vector<absl::string_view>(
+          string_domain.value().begin(), string_domain.value().end()));
+  std::sort(ids.begin(), ids.end());
+  ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+  return ids;
 }
 
 std::map<string, double> StringDomainGetMissing(
     const FeatureStatsView& stats, const StringDomain& string_domain) {
+  StringInterner* interner = stats.string_interner();
+  const std::vector<StringInterner::Id> valid =
+      GetStringDomainValueIds(string_domain, interner);
   // Missing values and their frequencies.
-  const std::set<string> valid = GetStringDomainValues(string_domain);
   std::map<string, double> missing;
   // Iterate over values in <stats> and mark those that are missing.
-  for (const auto& p : stats.GetStringValuesWithCounts()) {
-    const string& value = p.first;
-    if (!ContainsKey(valid, value)) {
-      missing.insert(p);
+  for (const auto& id_and_count : stats.GetStringValueIdsWithCounts(interner)) {
+    if (!std::binary_search(valid.begin(), valid.end(), id_and_count.first)) {
+      missing.emplace(string(interner->Get(id_and_count.first)),
+                      id_and_count.second);
     }
   }
   return missing;
@@ -74,39 +79,22 @@ void StringDomainAddMissing(const std::map<string, double>& missing,
   }
 }
 
-// Returns a string representation of <count>/<total> as a percentage. If
-// the ratio is less than 1% then the string "<1%" is returned, otherwise it
-// returns the string "~x%" where x is the floor of the ratio.
-// If total is undefined, return "?".
-string PercentageAsString(double count, absl::optional<double> total) {
-  if ((total == absl::nullopt) || (*total == 0.0)) {
-    return "?";
-  }
-  double percent = 100 * count / *total;
-  if (percent < 1.0) {
-    return "<1%";
-  } else {
-    return Printf("~%d%%", static_cast<int>(floor(percent)));
-  }
-}
-
 }  // namespace
 
 bool IsSimilarStringDomain(const StringDomain& a, const StringDomain& b,
                            const EnumsSimilarConfig& config) {
   // Check the overlap between the valid values in the two enums.
-  int overlap = 0;
-
-  const std::set<string> set_a = GetStringDomainValues(a);
-  const std::set<string> set_b = GetStringDomainValues(b);
-
-  for (const auto& value : set_b) {
-    if (ContainsKey(set_a, value)) {
-      ++overlap;
-    }
-  }
-  const int count_a = set_a.size();
-  const int count_b = set_b.size();
+  StringInterner interner;
+  const std::vector<StringInterner::Id> ids_a =
+      GetStringDomainValueIds(a, &interner);
+  const std::vector<StringInterner::Id> ids_b =
+      GetStringDomainValueIds(b, &interner);
+  std::vector<StringInterner::Id> common_ids;
+  std::set_intersection(ids_a.begin(), ids_a.end(), ids_b.begin(), ids_b.end(),
+                        std::back_inserter(common_ids));
+  const int overlap = common_ids.size();
+  const int count_a = ids_a.size();
+  const int count_b = ids_b.size();
   double jaccard_similarity = static_cast<double>(overlap) /
                               static_cast<double>(count_a + count_b - overlap);
   // For smaller enums, it has to be a perfect match.
@@ -178,28 +166,17 @@ UpdateSummary UpdateStringDomain(const Schema::Updater& updater,
   const double total_value_count = stats.GetTotalValueCountInExamples();
   if ((missing_count / total_value_count) > max_off_domain ||
       (max_off_domain == 0 && !missing.empty())) {
-    const Description description = {
-        tensorflow::metadata::v0::AnomalyInfo::
-            ENUM_TYPE_UNEXPECTED_STRING_VALUES,
-        "Unexpected string values",
-        absl::StrCat(
-            "Examples contain values missing from the schema: ",
-            absl::StrJoin(
-                missing, ", ",
-                [total_value_count](
-                    string* out,
-                    const std::pair<string, int64>& value_and_freq) {
-                  absl::StrAppend(
-                      out,
-                      Printf(
-                          "%s (%s)",
-                          absl::Utf8SafeCEscape(value_and_freq.first).c_str(),
-                          PercentageAsString(value_and_freq.second,
-                                             total_value_count)
-                              .c_str()));
-                }),
-            ". ")};
-    summary.descriptions.push_back(description);
+    // The values are only formatted if the anomaly is reported.
+    DescriptionDetails details;
+    details.values.assign(missing.begin(), missing.end());
+    details.value_total = total_value_count;
+    details.suffix = ". ";
+    summary.descriptions.push_back(
+        {tensorflow::metadata::v0::AnomalyInfo::
+             ENUM_TYPE_UNEXPECTED_STRING_VALUES,
+         "Unexpected string values",
+         "Examples contain values missing from the schema: ",
+         std::move(details)});
     StringDomainAddMissing(missing, string_domain);
   }
   const int domain_size = string_domain->value().size();
@@ -0,0 +1,100 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/string_interner.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace tensorflow {
+namespace data_validation {
+
+namespace {
+
+constexpr size_t kMaxBlockSize = 64 * 1024;
+
+}  // namespace
+
+StringInterner::Id StringInterner::Intern(absl::string_view value) {
+  mutex_lock lock(mu_);
+  return InternLocked(value);
+}
+
+std::vector<StringInterner::Id> StringInterner::InternAll(
+    const std::vector<absl::string_view>& values) {
+  std::vector<Id> result;
+  result.reserve(values.size());
+  mutex_lock lock(mu_);
+  for (const absl::string_view value : values) {
+    result.push_back(InternLocked(value));
+  }
+  return result;
+}
+
+absl::optional<StringInterner::Id> StringInterner::Find(
+    absl::string_view value) const {
+  tf_shared_lock lock(mu_);
+  const auto iter = ids_.find(value);
+  if (iter == ids_.end()) {
+    return absl::nullopt;
+  }
+  return iter->second;
+}
+
+absl::string_view StringInterner::Get(Id id) const {
+  tf_shared_lock lock(mu_);
+  return values_.at(id);
+}
+
+int StringInterner::size() const {
+  tf_shared_lock lock(mu_);
+  return values_.size();
+}
+
+StringInterner::Id StringInterner::InternLocked(absl::string_view value) {
+  const auto iter = ids_.find(value);
+  if (iter != ids_.end()) {
+    return iter->second;
+  }
+  char* data;
+  if (value.size() > kMaxBlockSize / 4) {
+    // Large strings get their own block, which keeps the free space of the
+    // current block for smaller strings.
+    blocks_.emplace_back(new char[value.size()]);
+    data = blocks_.back().get();
+  } else {
+    if (value.size() > free_size_) {
+      // Blocks grow geometrically, so that small interners stay small.
+      free_size_ = std::max(next_block_size_, value.size());
+      blocks_.emplace_back(new char[free_size_]);
+      free_ = blocks_.back().get();
+      next_block_size_ = std::min(2 * next_block_size_, kMaxBlockSize);
+    }
+    data = free_;
+    free_ += value.size();
+    free_size_ -= value.size();
+  }
+  if (!value.empty()) {
+    std::memcpy(data, value.data(), value.size());
+  }
+  const absl::string_view stored(data, value.size());
+  const Id id = values_.size();
+  values_.push_back(stored);
+  ids_.emplace(stored, id);
+  return id;
+}
+
+}  // namespace data_validation
+}  // namespace tensorflow
@@ -0,0 +1,83 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_DATA_VALIDATION_ANOMALIES_STRING_INTERNER_H_
+#define TENSORFLOW_DATA_VALIDATION_ANOMALIES_STRING_INTERNER_H_
+
+#include <memory>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+// Maps strings to dense integer ids, so that sets and maps of strings (e.g.
+// the labels of rank histograms and the values of string domains) can be
+// handled as integers. Each distinct string is copied once into an arena, and
+// the views returned by Get() are valid for the lifetime of the interner.
+// Ids are assigned in interning order, so code that must be deterministic
+// should not depend on their order when the interner is shared between
+// threads. Thread-safe.
+class StringInterner {
+ public:
+  using Id = int32;
+
+  StringInterner() = default;
+  StringInterner(const StringInterner&) = delete;
+  StringInterner& operator=(const StringInterner&) = delete;
+
+  // Returns the id of <value>, interning it if needed.
+  Id Intern(absl::string_view value) LOCKS_EXCLUDED(mu_);
+
+  // Returns the ids of <values>, taking the lock only once.
+  std::vector<Id> InternAll(const std::vector<absl::string_view>& values)
+      LOCKS_EXCLUDED(mu_);
+
+  // Returns the id of <value>, or nullopt if it was never interned.
+  absl::optional<Id> Find(absl::string_view value) const
+      LOCKS_EXCLUDED(mu_);
+
+  // Returns the string with the given id.
+  absl::string_view Get(Id id) const LOCKS_EXCLUDED(mu_);
+
+  // The number of distinct strings interned, i.e. one more than the largest
+  // id.
+  int size() const LOCKS_EXCLUDED(mu_);
+
+ private:
+  Id InternLocked(absl::string_view value) EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  mutable mutex mu_;
+  // The arena holding the interned strings, and the free space at the end
+  // of its current block.
+  std::vector<std::unique_ptr<char[]>> blocks_ GUARDED_BY(mu_);
+  char* free_ GUARDED_BY(mu_) = nullptr;
+  size_t free_size_ GUARDED_BY(mu_) = 0;
+  size_t next_block_size_ GUARDED_BY(mu_) = 1024;
+  // The interned strings, indexed by id, pointing into blocks_.
+  std::vector<absl::string_view> values_ GUARDED_BY(mu_);
+  absl::flat_hash_map<absl::string_view, Id> ids_ GUARDED_BY(mu_);
+};
+
+}  // namespace data_validation
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_DATA_VALIDATION_ANOMALIES_STRING_INTERNER_H_
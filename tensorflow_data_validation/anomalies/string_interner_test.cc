@@ -0,0 +1,62 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/string_interner.h"
+
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace tensorflow {
+namespace data_validation {
+namespace {
+
+TEST(StringInternerTest, Intern) {
+  StringInterner interner;
+  EXPECT_EQ(interner.Intern("a"), 0);
+  EXPECT_EQ(interner.Intern("b"), 1);
+  EXPECT_EQ(interner.Intern(string("a")), 0);
+  EXPECT_EQ(interner.Intern(""), 2);
+  EXPECT_THAT(interner.InternAll({"b", "c", "", "c"}),
+              ::testing::ElementsAre(1, 3, 2, 3));
+  EXPECT_EQ(interner.size(), 4);
+  EXPECT_EQ(interner.Get(0), "a");
+  EXPECT_EQ(interner.Get(3), "c");
+  EXPECT_EQ(interner.Find("c"), 3);
+  EXPECT_EQ(interner.Find("d"), absl::nullopt);
+}
+
+TEST(StringInternerTest, ValuesOutliveInputs) {
+  StringInterner interner;
+  std::vector<absl::string_view> values;
+  // Enough strings to fill several blocks, and a few large ones.
+  for (int i = 0; i < 10000; ++i) {
+    string value = (i % 1000 == 0) ? string(100000, 'x') : "";
+    value += std::to_string(i);
+    ASSERT_EQ(interner.Intern(value), i);
+    values.push_back(interner.Get(i));
+  }
+  for (int i = 0; i < 10000; ++i) {
+    EXPECT_EQ(values[i].substr(values[i].find_first_not_of('x')),
+              std::to_string(i));
+    EXPECT_EQ(interner.Find(values[i]), i);
+  }
+}
+
+}  // namespace
+}  // namespace data_validation
+}  // namespace tensorflow
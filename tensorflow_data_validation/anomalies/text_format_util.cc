@@ -0,0 +1,233 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/text_format_util.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "google/protobuf/io/tokenizer.h"
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/threadpool.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+namespace {
+
+using protobuf::FieldDescriptor;
+using protobuf::Message;
+using protobuf::Reflection;
+
+// Protos smaller than this are printed by a single thread.
+constexpr size_t kMinParallelPrintSize = 1 << 20;
+// Submessages smaller than this are printed as a whole by one thread.
+constexpr size_t kMinSplitSize = 1 << 16;
+
+// Keeps the first error of the text format parser.
+class FirstErrorCollector : public protobuf::io::ErrorCollector {
+ public:
+  void AddError(int line, int column, const string& message) override {
+    if (error_.empty()) {
+      // Lines and columns are zero-based.
+      error_ = absl::StrCat(line + 1, ":", column + 1, ": ", message);
+    }
+  }
+
+  const string& error() const { return error_; }
+
+ private:
+  string error_;
+};
+
+// A part of the text of a proto: either <text>, or <message> printed with
+// <indent_level>, if not null.
+struct TextPart {
+  string text;
+  const Message* message = nullptr;
+  int indent_level = 0;
+};
+
+// Returns true if the fields of <message> can be printed one by one as the
+// TextFormat::Printer does, i.e. if it has no extensions, map fields, groups
+// or unknown fields, whose output is more involved.
+bool CanSplit(const Message& message,
+              const std::vector<const FieldDescriptor*>& fields) {
+  if (!message.GetReflection()->GetUnknownFields(message).empty()) {
+    return false;
+  }
+  for (const FieldDescriptor* field : fields) {
+    if (field->is_extension() || field->is_map() ||
+        field->type() == FieldDescriptor::TYPE_GROUP) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Appends the parts of the text of <message>, printed with <indent_level>, to
+// <parts>. Messages of at least <min_split_size> bytes are split field by
+// field, so that their submessages can be printed in parallel.
+void SplitTextParts(const protobuf::TextFormat::Printer& printer,
+                    const Message& message, int indent_level,
+                    size_t min_split_size, std::vector<TextPart>* parts) {
+  const Reflection* reflection = message.GetReflection();
+  std::vector<const FieldDescriptor*> fields;
+  reflection->ListFields(message, &fields);
+  if (message.ByteSizeLong() < min_split_size ||
+      !CanSplit(message, fields)) {
+    TextPart part;
+    part.message = &message;
+    part.indent_level = indent_level;
+    parts->push_back(std::move(part));
+    return;
+  }
+  const string indent(2 * indent_level, ' ');
+  // Appends <text> to the last part, if it is text.
+  auto append_text = [parts](const string& text) {
+    if (parts->empty() || parts->back().message != nullptr) {
+      parts->emplace_back();
+    }
+    parts->back().text += text;
+  };
+  for (const FieldDescriptor* field : fields) {
+    const int size =
+        field->is_repeated() ? reflection->FieldSize(message, field) : 1;
+    for (int i = 0; i < size; ++i) {
+      if (field->cpp_type() == FieldDescriptor::CPPTYPE_MESSAGE) {
+        const Message& submessage =
+            field->is_repeated()
+                ? reflection->GetRepeatedMessage(message, field, i)
+                : reflection->GetMessage(message, field);
+        append_text(absl::StrCat(indent, field->name(), " {\n"));
+        SplitTextParts(printer, submessage, indent_level + 1, min_split_size,
+                       parts);
+        append_text(absl::StrCat(indent, "}\n"));
+      } else {
+        string value;
+        printer.PrintFieldValueToString(message, field,
+                                        field->is_repeated() ? i : -1, &value);
+        append_text(absl::StrCat(indent, field->name(), ": ", value, "\n"));
+      }
+    }
+  }
+}
+
+// Returns a new message of the type with full name <type_name>.
+Status NewMessage(const string& type_name, std::unique_ptr<Message>* message) {
+  const protobuf::Descriptor* descriptor =
+      protobuf::DescriptorPool::generated_pool()->FindMessageTypeByName(
+          type_name);
+  if (descriptor == nullptr) {
+    return errors::InvalidArgument("Unknown proto type: ", type_name);
+  }
+  message->reset(protobuf::MessageFactory::generated_factory()
+                     ->GetPrototype(descriptor)
+                     ->New());
+  return Status::OK();
+}
+
+}  // namespace
+
+Status ParseTextProto(const string& text, Message* proto) {
+  FirstErrorCollector error_collector;
+  protobuf::TextFormat::Parser parser;
+  parser.RecordErrorsTo(&error_collector);
+  if (!parser.ParseFromString(text, proto)) {
+    return errors::InvalidArgument("Failed to parse ", proto->GetTypeName(),
+                                   " proto in text format: ",
+                                   error_collector.error());
+  }
+  return Status::OK();
+}
+
+Status PrintTextProto(const Message& proto, int num_threads, string* text) {
+  const protobuf::TextFormat::Printer printer;
+  if (num_threads == 0) {
+    num_threads = port::MaxParallelism();
+  }
+  text->clear();
+  if (num_threads <= 1 || proto.ByteSizeLong() < kMinParallelPrintSize) {
+    if (!printer.PrintToString(proto, text)) {
+      return errors::Internal("Could not print ", proto.GetTypeName(),
+                              " proto in text format.");
+    }
+    return Status::OK();
+  }
+
+  std::vector<TextPart> parts;
+  SplitTextParts(printer, proto, /*indent_level=*/0, kMinSplitSize, &parts);
+  const int num_parts = parts.size();
+  std::vector<char> printed(num_parts, true);
+  {
+    thread::ThreadPool pool(Env::Default(), "print_text_proto",
+                            std::min(num_threads, num_parts));
+    for (int i = 0; i < num_parts; ++i) {
+      if (parts[i].message == nullptr) {
+        continue;
+      }
+      pool.Schedule([&parts, &printed, i]() {
+        protobuf::TextFormat::Printer part_printer;
+        part_printer.SetInitialIndentLevel(parts[i].indent_level);
+        printed[i] = part_printer.PrintToString(*parts[i].message,
+                                                &parts[i].text);
+      });
+    }
+  }
+  size_t text_size = 0;
+  for (int i = 0; i < num_parts; ++i) {
+    if (!printed[i]) {
+      return errors::Internal("Could not print ",
+                              parts[i].message->GetTypeName(),
+                              " proto in text format.");
+    }
+    text_size += parts[i].text.size();
+  }
+  text->reserve(text_size);
+  for (const TextPart& part : parts) {
+    text->append(part.text);
+  }
+  return Status::OK();
+}
+
+Status ParseTextProtoToSerialized(const string& type_name, const string& text,
+                                  string* serialized_proto) {
+  std::unique_ptr<Message> proto;
+  TF_RETURN_IF_ERROR(NewMessage(type_name, &proto));
+  TF_RETURN_IF_ERROR(ParseTextProto(text, proto.get()));
+  if (!proto->SerializeToString(serialized_proto)) {
+    return errors::Internal("Could not serialize ", type_name,
+                            " proto to string.");
+  }
+  return Status::OK();
+}
+
+Status PrintSerializedProtoAsText(const string& type_name,
+                                  const string& serialized_proto,
+                                  int num_threads, string* text) {
+  std::unique_ptr<Message> proto;
+  TF_RETURN_IF_ERROR(NewMessage(type_name, &proto));
+  if (!proto->ParseFromString(serialized_proto)) {
+    return errors::InvalidArgument("Failed to parse ", type_name, " proto.");
+  }
+  return PrintTextProto(*proto, num_threads, text);
+}
+
+}  // namespace data_validation
+}  // namespace tensorflow
@@ -0,0 +1,57 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Parsing and printing of protos in text format, which is much faster than
+// the pure Python implementation for large schemas and statistics.
+#ifndef TENSORFLOW_DATA_VALIDATION_ANOMALIES_TEXT_FORMAT_UTIL_H_
+#define TENSORFLOW_DATA_VALIDATION_ANOMALIES_TEXT_FORMAT_UTIL_H_
+
+#include <string>
+
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/protobuf.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+// Parses <proto> from <text>, in text format. Unknown fields are errors.
+// Returns InvalidArgument with the line and column of the first error if the
+// text cannot be parsed.
+Status ParseTextProto(const string& text, protobuf::Message* proto);
+
+// Prints <proto> in text format, with the same output as
+// protobuf::TextFormat::PrintToString. The large submessages of <proto> (e.g.
+// the features of a schema or of statistics) are printed in parallel with
+// <num_threads> threads, or as many as the available CPUs if 0.
+Status PrintTextProto(const protobuf::Message& proto, int num_threads,
+                      string* text);
+
+// Same as ParseTextProto, for a message of the type with full name
+// <type_name> (e.g. "tensorflow.metadata.v0.Schema"), which is output
+// serialized.
+Status ParseTextProtoToSerialized(const string& type_name, const string& text,
+                                  string* serialized_proto);
+
+// Same as PrintTextProto, for a serialized message of the type with full name
+// <type_name>.
+Status PrintSerializedProtoAsText(const string& type_name,
+                                  const string& serialized_proto,
+                                  int num_threads, string* text);
+
+}  // namespace data_validation
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_DATA_VALIDATION_ANOMALIES_TEXT_FORMAT_UTIL_H_
@@ -0,0 +1,145 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/text_format_util.h"
+
+#include <string>
+
+#include <gtest/gtest.h>
+#include "absl/strings/str_cat.h"
+#include "tensorflow_data_validation/anomalies/test_util.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/protobuf.h"
+#include "tensorflow_metadata/proto/v0/schema.pb.h"
+#include "tensorflow_metadata/proto/v0/statistics.pb.h"
+
+namespace tensorflow {
+namespace data_validation {
+namespace {
+
+using ::tensorflow::metadata::v0::DatasetFeatureStatisticsList;
+using ::tensorflow::metadata::v0::FeatureNameStatistics;
+using ::tensorflow::metadata::v0::Schema;
+using testing::EqualsProto;
+using testing::ParseTextProtoOrDie;
+
+// Returns statistics large enough to be printed in parallel.
+DatasetFeatureStatisticsList GetLargeStatistics() {
+  DatasetFeatureStatisticsList statistics;
+  for (int d = 0; d < 2; ++d) {
+    auto* dataset = statistics.add_datasets();
+    dataset->set_name(absl::StrCat("slice_", d));
+    dataset->set_num_examples(1000 + d);
+    for (int f = 0; f < 5000; ++f) {
+      FeatureNameStatistics* feature = dataset->add_features();
+      feature->mutable_path()->add_step(
+          absl::StrCat("feature \"", f, "\"\n"));
+      if (f % 2 == 0) {
+        feature->set_type(FeatureNameStatistics::FLOAT);
+        auto* num_stats = feature->mutable_num_stats();
+        num_stats->set_mean(f / 3.0);
+        num_stats->set_std_dev(0.1);
+        num_stats->mutable_common_stats()->set_num_non_missing(f);
+        auto* histogram = num_stats->add_histograms();
+        for (int b = 0; b < 10; ++b) {
+          auto* bucket = histogram->add_buckets();
+          bucket->set_low_value(b);
+          bucket->set_high_value(b + 1);
+          bucket->set_sample_count(b * 1.5);
+        }
+      } else {
+        feature->set_type(FeatureNameStatistics::STRING);
+        auto* string_stats = feature->mutable_string_stats();
+        string_stats->set_unique(f);
+        auto* top_value = string_stats->add_top_values();
+        top_value->set_value("caf\xc3\xa9\t\\");
+        top_value->set_frequency(f);
+      }
+    }
+  }
+  return statistics;
+}
+
+TEST(TextFormatUtilTest, PrintLargeProtoInParallel) {
+  const DatasetFeatureStatisticsList statistics = GetLargeStatistics();
+  ASSERT_GT(statistics.ByteSizeLong(), 1 << 20);
+  string expected;
+  ASSERT_TRUE(protobuf::TextFormat::PrintToString(statistics, &expected));
+  for (int num_threads : {0, 1, 4}) {
+    string text;
+    TF_ASSERT_OK(PrintTextProto(statistics, num_threads, &text));
+    EXPECT_EQ(text, expected) << "num_threads: " << num_threads;
+  }
+}
+
+TEST(TextFormatUtilTest, PrintSmallProto) {
+  const Schema schema = ParseTextProtoOrDie<Schema>(R"(
+    feature {
+      name: "a\"b"
+      type: BYTES
+      domain: "d"
+    }
+    string_domain { name: "d" value: "x" value: "\001" })");
+  string expected;
+  ASSERT_TRUE(protobuf::TextFormat::PrintToString(schema, &expected));
+  string text;
+  TF_ASSERT_OK(PrintTextProto(schema, /*num_threads=*/4, &text));
+  EXPECT_EQ(text, expected);
+}
+
+TEST(TextFormatUtilTest, ParseTextProto) {
+  const DatasetFeatureStatisticsList statistics = GetLargeStatistics();
+  string text;
+  TF_ASSERT_OK(PrintTextProto(statistics, /*num_threads=*/0, &text));
+  DatasetFeatureStatisticsList parsed;
+  TF_ASSERT_OK(ParseTextProto(text, &parsed));
+  EXPECT_THAT(parsed, EqualsProto(statistics));
+}
+
+TEST(TextFormatUtilTest, ParseTextProtoReportsErrorPosition) {
+  Schema schema;
+  const Status status =
+      ParseTextProto("feature {\n  name: \"a\"\n  unknown: 1\n}\n", &schema);
+  EXPECT_TRUE(errors::IsInvalidArgument(status));
+  EXPECT_NE(status.error_message().find("3:"), string::npos)
+      << status.error_message();
+}
+
+TEST(TextFormatUtilTest, SerializedProtos) {
+  string serialized;
+  TF_ASSERT_OK(ParseTextProtoToSerialized("tensorflow.metadata.v0.Schema",
+                                          "feature { name: \"a\" }",
+                                          &serialized));
+  Schema schema;
+  ASSERT_TRUE(schema.ParseFromString(serialized));
+  EXPECT_THAT(schema, EqualsProto(R"(feature { name: "a" })"));
+
+  string text;
+  TF_ASSERT_OK(PrintSerializedProtoAsText("tensorflow.metadata.v0.Schema",
+                                          serialized, /*num_threads=*/0,
+                                          &text));
+  EXPECT_EQ(text, "feature {\n  name: \"a\"\n}\n");
+}
+
+TEST(TextFormatUtilTest, UnknownType) {
+  string serialized;
+  EXPECT_TRUE(errors::IsInvalidArgument(ParseTextProtoToSerialized(
+      "tensorflow.metadata.v0.NotAProto", "", &serialized)));
+}
+
+}  // namespace
+}  // namespace data_validation
+}  // namespace tensorflow
@@ -0,0 +1,554 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/validation_server.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/types/optional.h"
+#include "tensorflow_data_validation/anomalies/feature_statistics_validator.h"
+#include "tensorflow_data_validation/anomalies/schema_util.h"
+#include "tensorflow/core/lib/core/coding.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/platform/fingerprint.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+namespace {
+
+using ::tensorflow::metadata::v0::DatasetFeatureStatistics;
+
+Status SocketError(const string& context) {
+  return errors::Unavailable(context, ": ", strerror(errno));
+}
+
+// Sends all of <data> to the socket <fd>.
+Status SendFully(int fd, const char* data, size_t size) {
+  while (size > 0) {
+    // MSG_NOSIGNAL avoids a SIGPIPE if the peer has closed the connection.
+    const ssize_t sent = send(fd, data, size, MSG_NOSIGNAL);
+    if (sent < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return SocketError("Failed to send");
+    }
+    data += sent;
+    size -= sent;
+  }
+  return Status::OK();
+}
+
+// Receives exactly <size> bytes from the socket <fd>. Returns OutOfRange if
+// the connection is closed first.
+Status ReceiveFully(int fd, char* data, size_t size) {
+  while (size > 0) {
+    const ssize_t received = recv(fd, data, size, 0);
+    if (received < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return SocketError("Failed to receive");
+    }
+    if (received == 0) {
+      return errors::OutOfRange("Connection closed.");
+    }
+    data += received;
+    size -= received;
+  }
+  return Status::OK();
+}
+
+// Fills <address> with the Unix domain socket address of <socket_path>.
+Status GetSocketAddress(const string& socket_path, sockaddr_un* address) {
+  memset(address, 0, sizeof(*address));
+  address->sun_family = AF_UNIX;
+  if (socket_path.empty() ||
+      socket_path.size() >= sizeof(address->sun_path)) {
+    return errors::InvalidArgument("Invalid socket path: ", socket_path);
+  }
+  memcpy(address->sun_path, socket_path.data(), socket_path.size());
+  return Status::OK();
+}
+
+// Parses the optional statistics in <proto_string> into <statistics>, if not
+// empty.
+Status ParseOptionalStatistics(const string& proto_string,
+                               DatasetFeatureStatistics* statistics) {
+  if (!proto_string.empty() && !statistics->ParseFromString(proto_string)) {
+    return errors::InvalidArgument(
+        "Failed to parse DatasetFeatureStatistics proto.");
+  }
+  return Status::OK();
+}
+
+absl::optional<DatasetFeatureStatistics> GetOptionalStatistics(
+    bool has_statistics, const DatasetFeatureStatistics& statistics) {
+  if (!has_statistics) {
+    return absl::nullopt;
+  }
+  return statistics;
+}
+
+// Serializes <message> for SendValidationMessage.
+Status SerializeValidationMessage(const protobuf::Message& message,
+                                  string* serialized) {
+  if (!message.SerializeToString(serialized)) {
+    return errors::Internal("Could not serialize ", message.GetTypeName(),
+                            " proto to string.");
+  }
+  if (serialized->size() > kMaxValidationMessageSize) {
+    return errors::InvalidArgument(message.GetTypeName(), " of ",
+                                   serialized->size(),
+                                   " bytes exceeds the maximum size.");
+  }
+  return Status::OK();
+}
+
+// Sends a message serialized by SerializeValidationMessage to the socket
+// <fd>.
+Status SendValidationMessage(int fd, const string& serialized) {
+  char length[sizeof(uint64)];
+  core::EncodeFixed64(length, serialized.size());
+  TF_RETURN_IF_ERROR(SendFully(fd, length, sizeof(length)));
+  return SendFully(fd, serialized.data(), serialized.size());
+}
+
+}  // namespace
+
+Status WriteValidationMessage(int fd, const protobuf::Message& message) {
+  string serialized;
+  TF_RETURN_IF_ERROR(SerializeValidationMessage(message, &serialized));
+  return SendValidationMessage(fd, serialized);
+}
+
+Status ReadValidationMessage(int fd, protobuf::Message* message) {
+  char length[sizeof(uint64)];
+  TF_RETURN_IF_ERROR(ReceiveFully(fd, length, sizeof(length)));
+  const uint64 size = core::DecodeFixed64(length);
+  if (size > kMaxValidationMessageSize) {
+    return errors::InvalidArgument(message->GetTypeName(), " of ", size,
+                                   " bytes exceeds the maximum size.");
+  }
+  string serialized(size, '\0');
+  TF_RETURN_IF_ERROR(ReceiveFully(fd, &serialized[0], size));
+  if (!message->ParseFromString(serialized)) {
+    return errors::InvalidArgument("Failed to parse ", message->GetTypeName(),
+                                   " proto.");
+  }
+  return Status::OK();
+}
+
+ValidationService::ValidationService(int max_cached_schemas)
+    : max_cached_schemas_(max_cached_schemas) {}
+
+Status ValidationService::GetSchema(const ValidationRequest& request,
+                                    std::shared_ptr<const Schema>* schema) {
+  if (request.has_schema()) {
+    // The fingerprint is computed rather than trusted, so that a request can
+    // not cache a schema under the fingerprint of another one.
+    const uint64 fingerprint = SchemaFingerprint(request.schema());
+    if (request.has_schema_fingerprint() &&
+        request.schema_fingerprint() != fingerprint) {
+      return errors::InvalidArgument("Schema fingerprint ",
+                                     request.schema_fingerprint(),
+                                     " does not match the schema, whose "
+                                     "fingerprint is ",
+                                     fingerprint, ".");
+    }
+    TF_RETURN_IF_ERROR(MakeValidationSchema(request.schema(), schema));
+    mutex_lock lock(mu_);
+    auto inserted = schemas_.emplace(fingerprint, *schema);
+    if (!inserted.second) {
+      inserted.first->second = *schema;
+      return Status::OK();
+    }
+    schema_order_.push_back(fingerprint);
+    while (schema_order_.size() > static_cast<size_t>(max_cached_schemas_)) {
+      schemas_.erase(schema_order_.front());
+      schema_order_.pop_front();
+    }
+    return Status::OK();
+  }
+  if (!request.has_schema_fingerprint()) {
+    return errors::InvalidArgument("The request has no schema.");
+  }
+  mutex_lock lock(mu_);
+  auto iter = schemas_.find(request.schema_fingerprint());
+  if (iter == schemas_.end()) {
+    return errors::NotFound("Unknown schema fingerprint: ",
+                            request.schema_fingerprint());
+  }
+  *schema = iter->second;
+  return Status::OK();
+}
+
+void ValidationService::Validate(const ValidationRequest& request,
+                                 ValidationResponse* response) {
+  response->Clear();
+  std::shared_ptr<const Schema> schema;
+  Status status = GetSchema(request, &schema);
+  if (status.ok()) {
+    absl::optional<string> environment;
+    if (request.has_environment()) {
+      environment = request.environment();
+    }
+    status = ValidateFeatureStatistics(
+        request.statistics(), schema, environment,
+        GetOptionalStatistics(request.has_previous_span_statistics(),
+                              request.previous_span_statistics()),
+        GetOptionalStatistics(request.has_serving_statistics(),
+                              request.serving_statistics()),
+        GetOptionalStatistics(request.has_previous_version_statistics(),
+                              request.previous_version_statistics()),
+        /*features_needed=*/absl::nullopt, request.validation_config(),
+        request.enable_diff_regions(), response->mutable_anomalies());
+  }
+  if (!status.ok()) {
+    response->Clear();
+    response->set_error_code(status.code());
+    response->set_error_message(status.error_message());
+  }
+}
+
+ValidationServer::ValidationServer(const string& socket_path, int listen_fd,
+                                   int wake_read_fd, int wake_write_fd,
+                                   int num_threads)
+    : socket_path_(socket_path),
+      listen_fd_(listen_fd),
+      wake_read_fd_(wake_read_fd),
+      wake_write_fd_(wake_write_fd),
+      workers_(new thread::ThreadPool(Env::Default(), "validation_server",
+                                      num_threads)) {}
+
+Status ValidationServer::Start(const string& socket_path, int num_threads,
+                               std::unique_ptr<ValidationServer>* server) {
+  if (num_threads < 1) {
+    return errors::InvalidArgument("Invalid number of threads: ", num_threads);
+  }
+  sockaddr_un address;
+  TF_RETURN_IF_ERROR(GetSocketAddress(socket_path, &address));
+  // Remove the socket file left by a server that was not stopped, but nothing
+  // else.
+  struct stat file_stat;
+  if (lstat(socket_path.c_str(), &file_stat) == 0 &&
+      S_ISSOCK(file_stat.st_mode)) {
+    unlink(socket_path.c_str());
+  }
+  const int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (listen_fd < 0) {
+    return SocketError("Failed to create socket");
+  }
+  // The listening socket is non-blocking, so that the dispatcher thread does
+  // not block on a connection aborted between poll and accept.
+  if (fcntl(listen_fd, F_SETFL, O_NONBLOCK) != 0 ||
+      bind(listen_fd, reinterpret_cast<const sockaddr*>(&address),
+           sizeof(address)) != 0 ||
+      listen(listen_fd, SOMAXCONN) != 0) {
+    const Status status = SocketError("Failed to listen on " + socket_path);
+    close(listen_fd);
+    return status;
+  }
+  // The wake-up pipe is non-blocking, so that waking up the dispatcher never
+  // blocks when the pipe is full, nor draining it when it is empty.
+  int wake_fds[2];
+  if (pipe(wake_fds) != 0) {
+    const Status status = SocketError("Failed to create pipe");
+    close(listen_fd);
+    unlink(socket_path.c_str());
+    return status;
+  }
+  if (fcntl(wake_fds[0], F_SETFL, O_NONBLOCK) != 0 ||
+      fcntl(wake_fds[1], F_SETFL, O_NONBLOCK) != 0) {
+    const Status status = SocketError("Failed to create pipe");
+    close(wake_fds[0]);
+    close(wake_fds[1]);
+    close(listen_fd);
+    unlink(socket_path.c_str());
+    return status;
+  }
+  server->reset(new ValidationServer(socket_path, listen_fd, wake_fds[0],
+                                     wake_fds[1], num_threads));
+  ValidationServer* started = server->get();
+  started->dispatch_thread_.reset(Env::Default()->StartThread(
+      ThreadOptions(), "validation_server_dispatch",
+      [started]() { started->DispatchRequests(); }));
+  return Status::OK();
+}
+
+ValidationServer::~ValidationServer() { Stop(); }
+
+void ValidationServer::WakeDispatcher() {
+  const char byte = 0;
+  while (write(wake_write_fd_, &byte, 1) < 0 && errno == EINTR) {
+  }
+}
+
+void ValidationServer::DispatchRequests() {
+  std::vector<pollfd> poll_fds;
+  while (true) {
+    poll_fds.clear();
+    poll_fds.push_back({listen_fd_, POLLIN, 0});
+    poll_fds.push_back({wake_read_fd_, POLLIN, 0});
+    {
+      mutex_lock lock(mu_);
+      if (stopping_) {
+        return;
+      }
+      for (const int fd : idle_connections_) {
+        poll_fds.push_back({fd, POLLIN, 0});
+      }
+    }
+    if (poll(poll_fds.data(), poll_fds.size(), /*timeout=*/-1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG(ERROR) << SocketError("Failed to poll connections");
+      return;
+    }
+    if (poll_fds[1].revents != 0) {
+      char buffer[64];
+      ssize_t size;
+      do {
+        size = read(wake_read_fd_, buffer, sizeof(buffer));
+      } while (size > 0 || (size < 0 && errno == EINTR));
+    }
+    mutex_lock lock(mu_);
+    if (stopping_) {
+      return;
+    }
+    if (poll_fds[0].revents != 0) {
+      const int fd = accept(listen_fd_, nullptr, nullptr);
+      if (fd >= 0) {
+        connections_.insert(fd);
+        idle_connections_.insert(fd);
+      } else if (errno != EINTR && errno != ECONNABORTED &&
+                 errno != EAGAIN && errno != EWOULDBLOCK) {
+        LOG(ERROR) << SocketError("Failed to accept connection");
+      }
+    }
+    // A connection becomes readable when it receives a request, but also when
+    // it is closed or fails, which HandleRequest detects.
+    for (size_t i = 2; i < poll_fds.size(); ++i) {
+      if (poll_fds[i].revents == 0) {
+        continue;
+      }
+      const int fd = poll_fds[i].fd;
+      idle_connections_.erase(fd);
+      workers_->Schedule([this, fd]() { HandleRequest(fd); });
+    }
+  }
+}
+
+void ValidationServer::HandleRequest(int fd) {
+  ValidationRequest request;
+  Status status = ReadValidationMessage(fd, &request);
+  if (status.ok()) {
+    ValidationResponse response;
+    service_.Validate(request, &response);
+    status = WriteValidationMessage(fd, response);
+  }
+  if (!status.ok() && !errors::IsOutOfRange(status)) {
+    LOG(WARNING) << status;
+  }
+  mutex_lock lock(mu_);
+  if (status.ok() && !stopping_) {
+    idle_connections_.insert(fd);
+    WakeDispatcher();
+    return;
+  }
+  connections_.erase(fd);
+  close(fd);
+}
+
+void ValidationServer::Stop() {
+  {
+    mutex_lock lock(mu_);
+    if (stopping_) {
+      return;
+    }
+    stopping_ = true;
+    // Wakes up the workers blocked on their connections.
+    for (const int fd : connections_) {
+      shutdown(fd, SHUT_RDWR);
+    }
+  }
+  WakeDispatcher();
+  dispatch_thread_.reset();
+  // Waits for the requests being handled.
+  workers_.reset();
+  {
+    mutex_lock lock(mu_);
+    for (const int fd : connections_) {
+      close(fd);
+    }
+    connections_.clear();
+    idle_connections_.clear();
+  }
+  close(wake_read_fd_);
+  close(wake_write_fd_);
+  close(listen_fd_);
+  unlink(socket_path_.c_str());
+  mutex_lock lock(mu_);
+  stopped_ = true;
+  stopped_cv_.notify_all();
+}
+
+void ValidationServer::Wait() {
+  mutex_lock lock(mu_);
+  while (!stopped_) {
+    stopped_cv_.wait(lock);
+  }
+}
+
+Status ValidationClient::Connect(const string& socket_path,
+                                 std::unique_ptr<ValidationClient>* client) {
+  sockaddr_un address;
+  TF_RETURN_IF_ERROR(GetSocketAddress(socket_path, &address));
+  const int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0) {
+    return SocketError("Failed to create socket");
+  }
+  if (connect(fd, reinterpret_cast<const sockaddr*>(&address),
+              sizeof(address)) != 0) {
+    const Status status = SocketError("Failed to connect to " + socket_path);
+    close(fd);
+    return status;
+  }
+  client->reset(new ValidationClient(fd));
+  return Status::OK();
+}
+
+ValidationClient::~ValidationClient() { close(fd_); }
+
+Status ValidationClient::Call(const ValidationRequest& request,
+                              ValidationResponse* response) {
+  mutex_lock lock(mu_);
+  return CallLocked(request, response);
+}
+
+Status ValidationClient::CallLocked(const ValidationRequest& request,
+                                    ValidationResponse* response) {
+  TF_RETURN_IF_ERROR(connection_status_);
+  // A request which cannot be serialized is not sent, so the connection is
+  // still usable.
+  string serialized;
+  TF_RETURN_IF_ERROR(SerializeValidationMessage(request, &serialized));
+  Status status = SendValidationMessage(fd_, serialized);
+  if (status.ok()) {
+    status = ReadValidationMessage(fd_, response);
+  }
+  if (!status.ok()) {
+    connection_status_ = errors::FailedPrecondition(
+        "Connection to the validation server is broken: ",
+        status.error_message());
+  }
+  return status;
+}
+
+Status ValidationClient::ValidateWithSerializedInputs(
+    const string& feature_statistics_proto_string,
+    const string& schema_proto_string, const string& environment,
+    const string& previous_span_statistics_proto_string,
+    const string& serving_statistics_proto_string,
+    const string& previous_version_statistics_proto_string,
+    const string& validation_config_string, bool enable_diff_regions,
+    string* anomalies_proto_string) {
+  ValidationRequest request;
+  if (!request.mutable_statistics()->ParseFromString(
+          feature_statistics_proto_string)) {
+    return errors::InvalidArgument(
+        "Failed to parse DatasetFeatureStatistics proto.");
+  }
+  TF_RETURN_IF_ERROR(
+      ParseOptionalStatistics(previous_span_statistics_proto_string,
+                              request.mutable_previous_span_statistics()));
+  TF_RETURN_IF_ERROR(ParseOptionalStatistics(
+      serving_statistics_proto_string, request.mutable_serving_statistics()));
+  TF_RETURN_IF_ERROR(
+      ParseOptionalStatistics(previous_version_statistics_proto_string,
+                              request.mutable_previous_version_statistics()));
+  if (!environment.empty()) {
+    request.set_environment(environment);
+  }
+  if (!request.mutable_validation_config()->ParseFromString(
+          validation_config_string)) {
+    return errors::InvalidArgument("Failed to parse ValidationConfig proto.");
+  }
+  request.set_enable_diff_regions(enable_diff_regions);
+
+  // The SchemaFingerprint requires parsing the schema, so it is only
+  // computed once per serialized schema.
+  mutex_lock lock(mu_);
+  metadata::v0::Schema schema;
+  bool schema_parsed = false;
+  const uint64 serialized_fingerprint = Fingerprint64(schema_proto_string);
+  auto iter = schema_fingerprints_.find(serialized_fingerprint);
+  if (iter == schema_fingerprints_.end()) {
+    if (!schema.ParseFromString(schema_proto_string)) {
+      return errors::InvalidArgument("Failed to parse Schema proto.");
+    }
+    schema_parsed = true;
+    iter = schema_fingerprints_
+               .emplace(serialized_fingerprint, SchemaFingerprint(schema))
+               .first;
+  }
+  const uint64 fingerprint = iter->second;
+  request.set_schema_fingerprint(fingerprint);
+  bool schema_sent = false;
+  if (sent_schemas_.count(fingerprint) == 0) {
+    if (!schema_parsed && !schema.ParseFromString(schema_proto_string)) {
+      return errors::InvalidArgument("Failed to parse Schema proto.");
+    }
+    *request.mutable_schema() = std::move(schema);
+    schema_sent = true;
+  }
+  ValidationResponse response;
+  TF_RETURN_IF_ERROR(CallLocked(request, &response));
+  if (!schema_sent && response.error_code() == error::NOT_FOUND) {
+    // The server evicted the schema, or was restarted.
+    if (!request.mutable_schema()->ParseFromString(schema_proto_string)) {
+      return errors::InvalidArgument("Failed to parse Schema proto.");
+    }
+    TF_RETURN_IF_ERROR(CallLocked(request, &response));
+  }
+  if (response.error_code() == error::OK) {
+    sent_schemas_.insert(fingerprint);
+  }
+  if (response.error_code() != error::OK) {
+    return Status(static_cast<error::Code>(response.error_code()),
+                  response.error_message());
+  }
+  if (!response.anomalies().SerializeToString(anomalies_proto_string)) {
+    return errors::Internal("Could not serialize Anomalies proto to string.");
+  }
+  return Status::OK();
+}
+
+}  // namespace data_validation
+}  // namespace tensorflow
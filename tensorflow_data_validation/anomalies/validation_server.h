@@ -0,0 +1,179 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// A long-lived local validation server, which avoids paying the process
+// startup and the schema parsing for each validation of small statistics.
+// Clients connect to a Unix domain socket and send ValidationRequests (see
+// validation_service.proto), each answered by a ValidationResponse. The
+// server keeps the schemas it receives, initialized for validation and keyed
+// by their SchemaFingerprint, so that clients only send a schema once.
+#ifndef TENSORFLOW_DATA_VALIDATION_ANOMALIES_VALIDATION_SERVER_H_
+#define TENSORFLOW_DATA_VALIDATION_ANOMALIES_VALIDATION_SERVER_H_
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+
+#include "tensorflow_data_validation/anomalies/proto/validation_service.pb.h"
+#include "tensorflow_data_validation/anomalies/schema.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/protobuf.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/threadpool.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow_metadata/proto/v0/anomalies.pb.h"
+#include "tensorflow_metadata/proto/v0/schema.pb.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+// The maximum size of a serialized request or response.
+constexpr uint64 kMaxValidationMessageSize = uint64{1} << 30;
+
+// Writes <message> to the socket <fd>, prefixed by its length.
+Status WriteValidationMessage(int fd, const protobuf::Message& message);
+
+// Reads a message written by WriteValidationMessage from the socket <fd>.
+// Returns OutOfRange if the connection was closed before the message.
+Status ReadValidationMessage(int fd, protobuf::Message* message);
+
+// Validates the statistics of ValidationRequests, caching the most recently
+// received schemas by SchemaFingerprint. Thread-safe.
+class ValidationService {
+ public:
+  explicit ValidationService(int max_cached_schemas = 64);
+
+  // Validates the statistics of <request> with ValidateFeatureStatistics.
+  // Errors are reported in *response.
+  void Validate(const ValidationRequest& request,
+                ValidationResponse* response);
+
+ private:
+  // Gets the schema of <request>, either from the request (caching it) or
+  // from the cache. Returns NotFound if neither has it, and InvalidArgument
+  // if the request has a schema which does not match its fingerprint.
+  Status GetSchema(const ValidationRequest& request,
+                   std::shared_ptr<const Schema>* schema);
+
+  const int max_cached_schemas_;
+  mutex mu_;
+  std::map<uint64, std::shared_ptr<const Schema>> schemas_ GUARDED_BY(mu_);
+  // The fingerprints of schemas_, from the least to the most recently added.
+  std::deque<uint64> schema_order_ GUARDED_BY(mu_);
+};
+
+// Serves ValidationRequests on a Unix domain socket. Each connection may send
+// any number of requests. A dispatcher thread waits for requests on all the
+// open connections, and each request is handled by one of the worker threads,
+// so that idle connections do not hold a worker.
+class ValidationServer {
+ public:
+  // Starts a server listening on <socket_path>, replacing any stale socket
+  // file, with <num_threads> worker threads.
+  static Status Start(const string& socket_path, int num_threads,
+                      std::unique_ptr<ValidationServer>* server);
+
+  // Stops the server.
+  ~ValidationServer();
+
+  // Stops accepting connections, waits for the requests being handled, closes
+  // the open connections and removes the socket file. Idempotent.
+  void Stop();
+
+  // Blocks until the server is stopped.
+  void Wait();
+
+ private:
+  ValidationServer(const string& socket_path, int listen_fd, int wake_read_fd,
+                   int wake_write_fd, int num_threads);
+
+  // Accepts the connections, and schedules the handling of each request
+  // received on an idle connection.
+  void DispatchRequests();
+  // Handles a request received on <fd>, then returns the connection to the
+  // idle connections, or closes it on error.
+  void HandleRequest(int fd);
+  // Wakes up the dispatcher thread.
+  void WakeDispatcher();
+
+  const string socket_path_;
+  const int listen_fd_;
+  // A pipe which wakes up the dispatcher thread when written to.
+  const int wake_read_fd_;
+  const int wake_write_fd_;
+  ValidationService service_;
+  std::unique_ptr<thread::ThreadPool> workers_;
+  std::unique_ptr<Thread> dispatch_thread_;
+  mutex mu_;
+  condition_variable stopped_cv_;
+  bool stopping_ GUARDED_BY(mu_) = false;
+  bool stopped_ GUARDED_BY(mu_) = false;
+  // The open connections.
+  std::set<int> connections_ GUARDED_BY(mu_);
+  // The open connections without a request being handled.
+  std::set<int> idle_connections_ GUARDED_BY(mu_);
+};
+
+// A connection to a ValidationServer. Thread-safe: concurrent calls are
+// serialized on the connection. After a call fails to send its request or to
+// receive its response, the connection is out of sync with the server, and all
+// later calls fail.
+class ValidationClient {
+ public:
+  static Status Connect(const string& socket_path,
+                        std::unique_ptr<ValidationClient>* client);
+
+  ~ValidationClient();
+
+  // Sends <request> and receives the response.
+  Status Call(const ValidationRequest& request, ValidationResponse* response);
+
+  // Validates statistics against a schema as
+  // ValidateFeatureStatisticsWithSerializedInputs, through the server. The
+  // schema is only sent if the server may not have it yet.
+  Status ValidateWithSerializedInputs(
+      const string& feature_statistics_proto_string,
+      const string& schema_proto_string, const string& environment,
+      const string& previous_span_statistics_proto_string,
+      const string& serving_statistics_proto_string,
+      const string& previous_version_statistics_proto_string,
+      const string& validation_config_string, bool enable_diff_regions,
+      string* anomalies_proto_string);
+
+ private:
+  explicit ValidationClient(int fd) : fd_(fd) {}
+
+  Status CallLocked(const ValidationRequest& request,
+                    ValidationResponse* response) EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const int fd_;
+  mutex mu_;
+  // The error which broke the connection, if any.
+  Status connection_status_ GUARDED_BY(mu_);
+  // The SchemaFingerprints of the serialized schemas, by fingerprint of their
+  // serialization, so that each serialized schema is only parsed once.
+  std::map<uint64, uint64> schema_fingerprints_ GUARDED_BY(mu_);
+  // The SchemaFingerprints of the schemas sent to the server.
+  std::set<uint64> sent_schemas_ GUARDED_BY(mu_);
+};
+
+}  // namespace data_validation
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_DATA_VALIDATION_ANOMALIES_VALIDATION_SERVER_H_
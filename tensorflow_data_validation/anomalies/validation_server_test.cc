@@ -0,0 +1,361 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/validation_server.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/strings/str_cat.h"
+#include "absl/types/optional.h"
+#include "tensorflow_data_validation/anomalies/feature_statistics_validator.h"
+#include "tensorflow_data_validation/anomalies/proto/validation_config.pb.h"
+#include "tensorflow_data_validation/anomalies/schema_util.h"
+#include "tensorflow_data_validation/anomalies/test_util.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow_metadata/proto/v0/anomalies.pb.h"
+#include "tensorflow_metadata/proto/v0/schema.pb.h"
+#include "tensorflow_metadata/proto/v0/statistics.pb.h"
+
+namespace tensorflow {
+namespace data_validation {
+namespace {
+
+using ::tensorflow::metadata::v0::Anomalies;
+using ::tensorflow::metadata::v0::DatasetFeatureStatistics;
+using ::tensorflow::metadata::v0::Schema;
+using testing::EqualsProto;
+using testing::ParseTextProtoOrDie;
+
+Schema GetTestSchema() {
+  return ParseTextProtoOrDie<Schema>(R"(
+    string_domain { name: "MyEnum" value: "A" }
+    feature {
+      name: "enum"
+      presence: { min_count: 1 }
+      type: BYTES
+      domain: "MyEnum"
+    })");
+}
+
+DatasetFeatureStatistics GetTestStatistics() {
+  return ParseTextProtoOrDie<DatasetFeatureStatistics>(R"(
+    num_examples: 10
+    features {
+      path { step: "enum" }
+      type: STRING
+      string_stats {
+        common_stats { num_non_missing: 10 min_num_values: 1 max_num_values: 1 }
+        unique: 2
+        rank_histogram {
+          buckets { label: "A" sample_count: 6 }
+          buckets { label: "B" sample_count: 4 }
+        }
+      }
+    })");
+}
+
+Anomalies GetExpectedAnomalies(const Schema& schema,
+                               const DatasetFeatureStatistics& statistics) {
+  Anomalies expected;
+  TF_CHECK_OK(ValidateFeatureStatistics(
+      statistics, schema, /*environment=*/absl::nullopt,
+      /*prev_span_feature_statistics=*/absl::nullopt,
+      /*serving_feature_statistics=*/absl::nullopt,
+      /*prev_version_feature_statistics=*/absl::nullopt,
+      /*features_needed=*/absl::nullopt, ValidationConfig(),
+      /*enable_diff_regions=*/false, &expected));
+  return expected;
+}
+
+// A schema other than the test schema, distinct for each <index>.
+Schema GetOtherSchema(int index) {
+  Schema schema;
+  schema.add_feature()->set_name(absl::StrCat("feature_", index));
+  return schema;
+}
+
+string TestSocketPath(const string& name) {
+  return ::testing::TempDir() + "/" + name;
+}
+
+TEST(ValidationServiceTest, CachesSchemasByFingerprint) {
+  ValidationService service(/*max_cached_schemas=*/1);
+  const Schema schema = GetTestSchema();
+  ValidationRequest request;
+  *request.mutable_statistics() = GetTestStatistics();
+  ValidationResponse response;
+
+  // Unknown schema.
+  request.set_schema_fingerprint(SchemaFingerprint(schema));
+  service.Validate(request, &response);
+  EXPECT_EQ(response.error_code(), error::NOT_FOUND);
+
+  // The schema is cached under its SchemaFingerprint by default.
+  *request.mutable_schema() = schema;
+  request.clear_schema_fingerprint();
+  service.Validate(request, &response);
+  EXPECT_EQ(response.error_code(), error::OK);
+  const Anomalies expected =
+      GetExpectedAnomalies(schema, request.statistics());
+  EXPECT_THAT(response.anomalies(), EqualsProto(expected));
+
+  request.clear_schema();
+  request.set_schema_fingerprint(SchemaFingerprint(schema));
+  service.Validate(request, &response);
+  EXPECT_EQ(response.error_code(), error::OK);
+  EXPECT_THAT(response.anomalies(), EqualsProto(expected));
+
+  // Caching another schema evicts the first one.
+  ValidationRequest other_request = request;
+  *other_request.mutable_schema() = GetOtherSchema(0);
+  other_request.clear_schema_fingerprint();
+  service.Validate(other_request, &response);
+  EXPECT_EQ(response.error_code(), error::OK);
+  service.Validate(request, &response);
+  EXPECT_EQ(response.error_code(), error::NOT_FOUND);
+
+  request.clear_schema_fingerprint();
+  service.Validate(request, &response);
+  EXPECT_EQ(response.error_code(), error::INVALID_ARGUMENT);
+  EXPECT_FALSE(response.has_anomalies());
+}
+
+TEST(ValidationServiceTest, RejectsMismatchedFingerprints) {
+  ValidationService service;
+  const Schema schema = GetTestSchema();
+  const Schema other_schema = GetOtherSchema(0);
+  ValidationRequest request;
+  *request.mutable_statistics() = GetTestStatistics();
+  ValidationResponse response;
+
+  // A schema sent with the fingerprint of another schema is not cached.
+  *request.mutable_schema() = other_schema;
+  request.set_schema_fingerprint(SchemaFingerprint(schema));
+  service.Validate(request, &response);
+  EXPECT_EQ(response.error_code(), error::INVALID_ARGUMENT);
+  EXPECT_FALSE(response.has_anomalies());
+
+  request.clear_schema();
+  service.Validate(request, &response);
+  EXPECT_EQ(response.error_code(), error::NOT_FOUND);
+
+  // Nor does it replace the schema cached under that fingerprint.
+  *request.mutable_schema() = schema;
+  service.Validate(request, &response);
+  EXPECT_EQ(response.error_code(), error::OK);
+  *request.mutable_schema() = other_schema;
+  service.Validate(request, &response);
+  EXPECT_EQ(response.error_code(), error::INVALID_ARGUMENT);
+  request.clear_schema();
+  service.Validate(request, &response);
+  EXPECT_EQ(response.error_code(), error::OK);
+  EXPECT_THAT(response.anomalies(),
+              EqualsProto(GetExpectedAnomalies(schema, request.statistics())));
+}
+
+TEST(ValidationServerTest, Validate) {
+  std::unique_ptr<ValidationServer> server;
+  TF_ASSERT_OK(ValidationServer::Start(TestSocketPath("validate.sock"),
+                                       /*num_threads=*/2, &server));
+  std::unique_ptr<ValidationClient> client;
+  TF_ASSERT_OK(
+      ValidationClient::Connect(TestSocketPath("validate.sock"), &client));
+
+  const Schema schema = GetTestSchema();
+  const DatasetFeatureStatistics statistics = GetTestStatistics();
+  const Anomalies expected = GetExpectedAnomalies(schema, statistics);
+  ASSERT_EQ(expected.anomaly_info().size(), 1);
+  for (int i = 0; i < 3; ++i) {
+    string anomalies_proto_string;
+    TF_ASSERT_OK(client->ValidateWithSerializedInputs(
+        statistics.SerializeAsString(), schema.SerializeAsString(),
+        /*environment=*/"", /*previous_span_statistics_proto_string=*/"",
+        /*serving_statistics_proto_string=*/"",
+        /*previous_version_statistics_proto_string=*/"",
+        ValidationConfig().SerializeAsString(),
+        /*enable_diff_regions=*/false, &anomalies_proto_string));
+    Anomalies result;
+    ASSERT_TRUE(result.ParseFromString(anomalies_proto_string));
+    EXPECT_THAT(result, EqualsProto(expected));
+  }
+
+  // Errors are reported in the response.
+  ValidationResponse response;
+  TF_ASSERT_OK(client->Call(ValidationRequest(), &response));
+  EXPECT_EQ(response.error_code(), error::INVALID_ARGUMENT);
+  EXPECT_FALSE(response.error_message().empty());
+}
+
+TEST(ValidationServerTest, ResendsEvictedSchemas) {
+  std::unique_ptr<ValidationServer> server;
+  TF_ASSERT_OK(ValidationServer::Start(TestSocketPath("resend.sock"),
+                                       /*num_threads=*/1, &server));
+  std::unique_ptr<ValidationClient> client;
+  TF_ASSERT_OK(
+      ValidationClient::Connect(TestSocketPath("resend.sock"), &client));
+  const Schema schema = GetTestSchema();
+  const DatasetFeatureStatistics statistics = GetTestStatistics();
+  string anomalies_proto_string;
+  TF_ASSERT_OK(client->ValidateWithSerializedInputs(
+      statistics.SerializeAsString(), schema.SerializeAsString(), "", "", "",
+      "", "", /*enable_diff_regions=*/false, &anomalies_proto_string));
+
+  // Fills the cache of the server with other schemas.
+  ValidationRequest request;
+  ValidationResponse response;
+  for (int i = 0; i < 64; ++i) {
+    *request.mutable_schema() = GetOtherSchema(i);
+    TF_ASSERT_OK(client->Call(request, &response));
+    EXPECT_EQ(response.error_code(), error::OK);
+  }
+
+  TF_ASSERT_OK(client->ValidateWithSerializedInputs(
+      statistics.SerializeAsString(), schema.SerializeAsString(), "", "", "",
+      "", "", /*enable_diff_regions=*/false, &anomalies_proto_string));
+  Anomalies result;
+  ASSERT_TRUE(result.ParseFromString(anomalies_proto_string));
+  EXPECT_THAT(result, EqualsProto(GetExpectedAnomalies(schema, statistics)));
+}
+
+TEST(ValidationServerTest, ConcurrentClients) {
+  const string socket_path = TestSocketPath("concurrent.sock");
+  std::unique_ptr<ValidationServer> server;
+  TF_ASSERT_OK(
+      ValidationServer::Start(socket_path, /*num_threads=*/4, &server));
+  const Schema schema = GetTestSchema();
+  const DatasetFeatureStatistics statistics = GetTestStatistics();
+  const string expected =
+      GetExpectedAnomalies(schema, statistics).SerializeAsString();
+
+  const int kNumClients = 8;
+  std::vector<Status> statuses(kNumClients);
+  std::vector<string> results(kNumClients);
+  {
+    std::vector<std::unique_ptr<Thread>> threads;
+    for (int i = 0; i < kNumClients; ++i) {
+      threads.emplace_back(Env::Default()->StartThread(
+          ThreadOptions(), "client", [&, i]() {
+            std::unique_ptr<ValidationClient> client;
+            statuses[i] = ValidationClient::Connect(socket_path, &client);
+            for (int j = 0; j < 10 && statuses[i].ok(); ++j) {
+              statuses[i] = client->ValidateWithSerializedInputs(
+                  statistics.SerializeAsString(), schema.SerializeAsString(),
+                  "", "", "", "", "", /*enable_diff_regions=*/false,
+                  &results[i]);
+            }
+          }));
+    }
+  }
+  for (int i = 0; i < kNumClients; ++i) {
+    TF_EXPECT_OK(statuses[i]);
+    EXPECT_EQ(results[i], expected);
+  }
+}
+
+TEST(ValidationServerTest, SharedClient) {
+  const string socket_path = TestSocketPath("shared.sock");
+  std::unique_ptr<ValidationServer> server;
+  TF_ASSERT_OK(
+      ValidationServer::Start(socket_path, /*num_threads=*/2, &server));
+  std::unique_ptr<ValidationClient> client;
+  TF_ASSERT_OK(ValidationClient::Connect(socket_path, &client));
+  const Schema schema = GetTestSchema();
+  const DatasetFeatureStatistics statistics = GetTestStatistics();
+  const string expected =
+      GetExpectedAnomalies(schema, statistics).SerializeAsString();
+
+  // Concurrent calls on the same connection do not interleave their messages.
+  const int kNumThreads = 8;
+  std::vector<Status> statuses(kNumThreads);
+  std::vector<string> results(kNumThreads);
+  {
+    std::vector<std::unique_ptr<Thread>> threads;
+    for (int i = 0; i < kNumThreads; ++i) {
+      threads.emplace_back(Env::Default()->StartThread(
+          ThreadOptions(), "client", [&, i]() {
+            for (int j = 0; j < 10 && statuses[i].ok(); ++j) {
+              statuses[i] = client->ValidateWithSerializedInputs(
+                  statistics.SerializeAsString(), schema.SerializeAsString(),
+                  "", "", "", "", "", /*enable_diff_regions=*/false,
+                  &results[i]);
+            }
+          }));
+    }
+  }
+  for (int i = 0; i < kNumThreads; ++i) {
+    TF_EXPECT_OK(statuses[i]);
+    EXPECT_EQ(results[i], expected);
+  }
+}
+
+TEST(ValidationServerTest, MoreConnectionsThanThreads) {
+  const string socket_path = TestSocketPath("connections.sock");
+  std::unique_ptr<ValidationServer> server;
+  TF_ASSERT_OK(
+      ValidationServer::Start(socket_path, /*num_threads=*/1, &server));
+  const Schema schema = GetTestSchema();
+  const DatasetFeatureStatistics statistics = GetTestStatistics();
+  const string expected =
+      GetExpectedAnomalies(schema, statistics).SerializeAsString();
+
+  // Open connections do not hold the only worker between their requests.
+  std::vector<std::unique_ptr<ValidationClient>> clients(3);
+  for (auto& client : clients) {
+    TF_ASSERT_OK(ValidationClient::Connect(socket_path, &client));
+  }
+  for (int i = 0; i < 3; ++i) {
+    for (auto& client : clients) {
+      string result;
+      TF_ASSERT_OK(client->ValidateWithSerializedInputs(
+          statistics.SerializeAsString(), schema.SerializeAsString(), "", "",
+          "", "", "", /*enable_diff_regions=*/false, &result));
+      EXPECT_EQ(result, expected);
+    }
+  }
+}
+
+TEST(ValidationServerTest, Stop) {
+  const string socket_path = TestSocketPath("stop.sock");
+  std::unique_ptr<ValidationServer> server;
+  TF_ASSERT_OK(
+      ValidationServer::Start(socket_path, /*num_threads=*/1, &server));
+  std::unique_ptr<ValidationClient> client;
+  TF_ASSERT_OK(ValidationClient::Connect(socket_path, &client));
+
+  // Stopping closes the open connections.
+  server->Stop();
+  server->Wait();
+  ValidationResponse response;
+  EXPECT_FALSE(client->Call(ValidationRequest(), &response).ok());
+  // The connection stays broken.
+  EXPECT_EQ(client->Call(ValidationRequest(), &response).code(),
+            error::FAILED_PRECONDITION);
+  EXPECT_FALSE(Env::Default()->FileExists(socket_path).ok());
+  EXPECT_FALSE(ValidationClient::Connect(socket_path, &client).ok());
+
+  // The socket path can be reused.
+  TF_ASSERT_OK(
+      ValidationServer::Start(socket_path, /*num_threads=*/1, &server));
+  TF_ASSERT_OK(ValidationClient::Connect(socket_path, &client));
+}
+
+}  // namespace
+}  // namespace data_validation
+}  // namespace tensorflow
@@ -0,0 +1,296 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/validation_tool.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "google/protobuf/io/tokenizer.h"
+#include "absl/strings/match.h"
+#include "absl/types/optional.h"
+#include "tensorflow_data_validation/anomalies/columnar_statistics.h"
+#include "tensorflow_data_validation/anomalies/feature_statistics_validator.h"
+#include "tensorflow_data_validation/anomalies/proto/validation_config.pb.h"
+#include "tensorflow_data_validation/anomalies/statistics_view.h"
+#include "tensorflow_data_validation/anomalies/text_format_util.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/io/record_reader.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow_metadata/proto/v0/anomalies.pb.h"
+#include "tensorflow_metadata/proto/v0/schema.pb.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+namespace {
+
+using ::tensorflow::metadata::v0::DatasetFeatureStatistics;
+using ::tensorflow::metadata::v0::DatasetFeatureStatisticsList;
+using ::tensorflow::metadata::v0::Feature;
+using ::tensorflow::metadata::v0::Schema;
+
+// Discards the errors of the text format parser, which are expected when
+// trying the formats of a file in turn.
+class SilentErrorCollector : public protobuf::io::ErrorCollector {
+ public:
+  void AddError(int line, int column, const string& message) override {}
+};
+
+// Reads the first record of the TFRecord file at <path>.
+Status ReadFirstRecord(const string& path, string* record) {
+  std::unique_ptr<RandomAccessFile> file;
+  TF_RETURN_IF_ERROR(Env::Default()->NewRandomAccessFile(path, &file));
+  io::RecordReader reader(file.get());
+  uint64 offset = 0;
+  return reader.ReadRecord(&offset, record);
+}
+
+// Parses <proto> from <contents>, the contents of the file at <path>, as
+// described in ReadProtoFile.
+Status ParseProtoFile(const string& path, const string& contents,
+                      protobuf::Message* proto) {
+  string record;
+  if (ReadFirstRecord(path, &record).ok() && proto->ParseFromString(record)) {
+    return Status::OK();
+  }
+  SilentErrorCollector error_collector;
+  protobuf::TextFormat::Parser parser;
+  parser.RecordErrorsTo(&error_collector);
+  if (parser.ParseFromString(contents, proto)) {
+    return Status::OK();
+  }
+  if (proto->ParseFromString(contents)) {
+    return Status::OK();
+  }
+  return errors::InvalidArgument("Failed to parse ", proto->GetTypeName(),
+                                 " proto from ", path, ".");
+}
+
+// Outputs whether the file at <path> is a columnar statistics file, from its
+// first bytes only.
+Status IsColumnarStatisticsFile(const string& path, bool* result) {
+  std::unique_ptr<RandomAccessFile> file;
+  TF_RETURN_IF_ERROR(Env::Default()->NewRandomAccessFile(path, &file));
+  const size_t magic_size = sizeof(kColumnarStatisticsMagic) - 1;
+  char scratch[sizeof(kColumnarStatisticsMagic)];
+  StringPiece magic;
+  const Status status = file->Read(0, magic_size, &magic, scratch);
+  if (!status.ok() && !errors::IsOutOfRange(status)) {
+    return status;
+  }
+  *result = magic == kColumnarStatisticsMagic;
+  return Status::OK();
+}
+
+// Reads the statistics at <path>, if any, and outputs a backend over those of
+// the default slice, or nullptr if there is no path. Columnar statistics are
+// memory-mapped, and only decoded as the validation reads them.
+Status ReadOptionalDefaultDatasetStatsBackend(
+    const string& path, std::shared_ptr<const DatasetStatsBackend>* result) {
+  *result = nullptr;
+  if (path.empty()) {
+    return Status::OK();
+  }
+  bool is_columnar;
+  TF_RETURN_IF_ERROR(IsColumnarStatisticsFile(path, &is_columnar));
+  if (is_columnar) {
+    return OpenDefaultColumnarDatasetStatsBackend(path, kDefaultSliceKey,
+                                                  result);
+  }
+  DatasetFeatureStatisticsList statistics;
+  TF_RETURN_IF_ERROR(ReadStatisticsFile(path, &statistics));
+  const DatasetFeatureStatistics* dataset;
+  TF_RETURN_IF_ERROR(GetDefaultDatasetStatistics(statistics, &dataset));
+  for (DatasetFeatureStatistics& candidate : *statistics.mutable_datasets()) {
+    if (&candidate == dataset) {
+      *result = MakeProtoDatasetStatsBackend(std::move(candidate));
+      break;
+    }
+  }
+  return Status::OK();
+}
+
+// Infers the shape of <feature> and its children, as tfdv.infer_schema. The
+// shape is only inferred for required features with a fixed value count at
+// each nestedness level.
+void InferFeatureShape(Feature* feature) {
+  if (feature->has_struct_domain()) {
+    for (Feature& child :
+         *feature->mutable_struct_domain()->mutable_feature()) {
+      InferFeatureShape(&child);
+    }
+  }
+  if (feature->presence().min_fraction() != 1) {
+    return;
+  }
+  std::vector<int64> sizes;
+  if (feature->has_value_count()) {
+    if (feature->value_count().min() != 0 &&
+        feature->value_count().min() == feature->value_count().max()) {
+      sizes.push_back(feature->value_count().min());
+    }
+  } else if (feature->has_value_counts()) {
+    for (const auto& value_count : feature->value_counts().value_count()) {
+      if (value_count.min() == 0 || value_count.min() != value_count.max()) {
+        return;
+      }
+      sizes.push_back(value_count.min());
+    }
+  }
+  if (sizes.empty()) {
+    return;
+  }
+  // The shape replaces the value counts, as they are in the same oneof.
+  for (const int64 size : sizes) {
+    feature->mutable_shape()->add_dim()->set_size(size);
+  }
+}
+
+}  // namespace
+
+Status ReadProtoFile(const string& path, protobuf::Message* proto) {
+  string contents;
+  TF_RETURN_IF_ERROR(ReadFileToString(Env::Default(), path, &contents));
+  return ParseProtoFile(path, contents, proto);
+}
+
+Status ReadStatisticsFile(const string& path,
+                          DatasetFeatureStatisticsList* statistics) {
+  string contents;
+  TF_RETURN_IF_ERROR(ReadFileToString(Env::Default(), path, &contents));
+  if (absl::StartsWith(contents, kColumnarStatisticsMagic)) {
+    return ColumnarStatisticsToProto(contents, statistics);
+  }
+  return ParseProtoFile(path, contents, statistics);
+}
+
+Status WriteProtoFile(const string& path, bool text_format,
+                      const protobuf::Message& proto) {
+  string contents;
+  if (text_format) {
+    TF_RETURN_IF_ERROR(PrintTextProto(proto, /*num_threads=*/0, &contents));
+  } else if (!proto.SerializeToString(&contents)) {
+    return errors::Internal("Could not serialize ", proto.GetTypeName(),
+                            " proto to string.");
+  }
+  return WriteStringToFile(Env::Default(), path, contents);
+}
+
+Status GetDefaultDatasetStatistics(
+    const DatasetFeatureStatisticsList& statistics,
+    const DatasetFeatureStatistics** result) {
+  if (statistics.datasets_size() == 1) {
+    *result = &statistics.datasets(0);
+    return Status::OK();
+  }
+  for (const DatasetFeatureStatistics& dataset : statistics.datasets()) {
+    if (dataset.name() == kDefaultSliceKey) {
+      *result = &dataset;
+      return Status::OK();
+    }
+  }
+  return errors::InvalidArgument(
+      "Only statistics proto with one dataset or the default slice (i.e., \"",
+      kDefaultSliceKey, "\" slice) is currently supported.");
+}
+
+Status RunValidationTool(const ValidationToolOptions& options) {
+  if (options.statistics_path.empty()) {
+    return errors::InvalidArgument("No statistics path given.");
+  }
+  if (options.output_path.empty()) {
+    return errors::InvalidArgument("No output path given.");
+  }
+  metadata::v0::Schema schema;
+  if (options.mode != ValidationToolMode::kInferSchema) {
+    if (options.schema_path.empty()) {
+      return errors::InvalidArgument("No schema path given.");
+    }
+    TF_RETURN_IF_ERROR(ReadProtoFile(options.schema_path, &schema));
+  }
+
+  switch (options.mode) {
+    case ValidationToolMode::kInferSchema:
+    case ValidationToolMode::kUpdateSchema: {
+      DatasetFeatureStatisticsList statistics_list;
+      TF_RETURN_IF_ERROR(
+          ReadStatisticsFile(options.statistics_path, &statistics_list));
+      const DatasetFeatureStatistics* statistics;
+      TF_RETURN_IF_ERROR(
+          GetDefaultDatasetStatistics(statistics_list, &statistics));
+      FeatureStatisticsToProtoConfig feature_statistics_to_proto_config;
+      feature_statistics_to_proto_config.set_enum_threshold(
+          options.max_string_domain_size);
+      metadata::v0::Schema result;
+      TF_RETURN_IF_ERROR(UpdateSchema(feature_statistics_to_proto_config,
+                                      schema, *statistics,
+                                      /*paths_to_consider=*/absl::nullopt,
+                                      /*environment=*/absl::nullopt, &result));
+      if (options.infer_feature_shape) {
+        for (Feature& feature : *result.mutable_feature()) {
+          InferFeatureShape(&feature);
+        }
+      }
+      return WriteProtoFile(options.output_path, options.text_output, result);
+    }
+    case ValidationToolMode::kValidate: {
+      std::shared_ptr<const DatasetStatsBackend> statistics;
+      TF_RETURN_IF_ERROR(ReadOptionalDefaultDatasetStatsBackend(
+          options.statistics_path, &statistics));
+      std::shared_ptr<const DatasetStatsBackend> previous_span_statistics;
+      TF_RETURN_IF_ERROR(ReadOptionalDefaultDatasetStatsBackend(
+          options.previous_span_statistics_path, &previous_span_statistics));
+      std::shared_ptr<const DatasetStatsBackend> serving_statistics;
+      TF_RETURN_IF_ERROR(ReadOptionalDefaultDatasetStatsBackend(
+          options.serving_statistics_path, &serving_statistics));
+      std::shared_ptr<const DatasetStatsBackend> previous_version_statistics;
+      TF_RETURN_IF_ERROR(ReadOptionalDefaultDatasetStatsBackend(
+          options.previous_version_statistics_path,
+          &previous_version_statistics));
+      absl::optional<string> environment;
+      if (!options.environment.empty()) {
+        if (std::find(schema.default_environment().begin(),
+                      schema.default_environment().end(),
+                      options.environment) ==
+            schema.default_environment().end()) {
+          return errors::InvalidArgument("Environment ", options.environment,
+                                         " not found in the schema.");
+        }
+        environment = options.environment;
+      }
+      ValidationConfig validation_config;
+      if (!options.validation_config_path.empty()) {
+        TF_RETURN_IF_ERROR(ReadProtoFile(options.validation_config_path,
+                                         &validation_config));
+      }
+      metadata::v0::Anomalies anomalies;
+      TF_RETURN_IF_ERROR(ValidateFeatureStatisticsBackends(
+          statistics, schema, environment, previous_span_statistics,
+          serving_statistics, previous_version_statistics,
+          /*features_needed=*/absl::nullopt, validation_config,
+          options.enable_diff_regions, &anomalies));
+      return WriteProtoFile(options.output_path, options.text_output,
+                            anomalies);
+    }
+  }
+  return errors::InvalidArgument("Unknown validation tool mode.");
+}
+
+}  // namespace data_validation
+}  // namespace tensorflow
@@ -0,0 +1,99 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// The library behind the standalone validation binary, which infers, updates
+// or validates schemas without Python, TensorFlow or Beam.
+#ifndef TENSORFLOW_DATA_VALIDATION_ANOMALIES_VALIDATION_TOOL_H_
+#define TENSORFLOW_DATA_VALIDATION_ANOMALIES_VALIDATION_TOOL_H_
+
+#include <string>
+
+#include "tensorflow_data_validation/anomalies/feature_statistics_validator.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/protobuf.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow_metadata/proto/v0/statistics.pb.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+// Reads <proto> from <path>, which holds either a TFRecord file whose first
+// record is the serialized proto, or the proto in text or binary format.
+Status ReadProtoFile(const string& path, protobuf::Message* proto);
+
+// Reads statistics from <path>, which holds either a columnar statistics file
+// (see columnar_statistics.h) or any of the formats of ReadProtoFile.
+Status ReadStatisticsFile(
+    const string& path,
+    metadata::v0::DatasetFeatureStatisticsList* statistics);
+
+// Writes <proto> to <path>, in text format if <text_format> is true and in
+// binary format otherwise.
+Status WriteProtoFile(const string& path, bool text_format,
+                      const protobuf::Message& proto);
+
+// Outputs the statistics to validate in <statistics>: its only dataset, or
+// the dataset of the default slice if there are several.
+Status GetDefaultDatasetStatistics(
+    const metadata::v0::DatasetFeatureStatisticsList& statistics,
+    const metadata::v0::DatasetFeatureStatistics** result);
+
+// What the validation tool does.
+enum class ValidationToolMode {
+  // Infers a schema from the statistics.
+  kInferSchema,
+  // Updates the schema to match the statistics.
+  kUpdateSchema,
+  // Validates the statistics against the schema, writing Anomalies. Columnar
+  // statistics files are memory-mapped rather than loaded.
+  kValidate,
+};
+
+struct ValidationToolOptions {
+  ValidationToolMode mode = ValidationToolMode::kValidate;
+  // The input schema (ignored by kInferSchema).
+  string schema_path;
+  // The statistics to infer, update or validate the schema with.
+  string statistics_path;
+  // Optional control statistics (kValidate only).
+  string previous_span_statistics_path;
+  string serving_statistics_path;
+  string previous_version_statistics_path;
+  // Optional validation environment (kValidate only).
+  string environment;
+  // Optional ValidationConfig proto (kValidate only).
+  string validation_config_path;
+  // Whether to include diff regions in the anomalies (kValidate only).
+  bool enable_diff_regions = false;
+  // The maximum size of the domain of a categorical string feature
+  // (kInferSchema and kUpdateSchema only).
+  int max_string_domain_size = 100;
+  // Whether to infer the shape of the features of the schema, as
+  // tfdv.infer_schema (kInferSchema and kUpdateSchema only).
+  bool infer_feature_shape = true;
+  // Where to write the Schema or Anomalies proto.
+  string output_path;
+  // Whether to write the output in text format rather than binary format.
+  bool text_output = true;
+};
+
+// Runs the validation tool with <options>. As in the Python API, the
+// statistics of the default slice are used.
+Status RunValidationTool(const ValidationToolOptions& options);
+
+}  // namespace data_validation
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_DATA_VALIDATION_ANOMALIES_VALIDATION_TOOL_H_
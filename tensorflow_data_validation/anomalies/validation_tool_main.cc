@@ -0,0 +1,122 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Infers, updates or validates a schema from statistics on disk, without the
+// startup cost of Python. For example, the following flags validate the
+// statistics in stats.tfrecord, with the serving statistics in
+// serving.tfrecord, against schema.pbtxt:
+//   validation_tool --mode=validate --schema=schema.pbtxt
+//     --statistics=stats.tfrecord --serving_statistics=serving.tfrecord
+//     --output=anomalies.pbtxt
+// It can also run as a validation server (see validation_server.h):
+//   validation_tool --mode=serve --socket=/tmp/tfdv.sock --num_threads=4
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tensorflow_data_validation/anomalies/validation_server.h"
+#include "tensorflow_data_validation/anomalies/validation_tool.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/init_main.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/util/command_line_flags.h"
+
+int main(int argc, char** argv) {
+  using tensorflow::Flag;
+  using tensorflow::data_validation::ValidationServer;
+  using tensorflow::data_validation::ValidationToolMode;
+  using tensorflow::data_validation::ValidationToolOptions;
+
+  ValidationToolOptions options;
+  std::string mode = "validate";
+  std::string output_format = "text";
+  std::string socket_path;
+  int num_threads = 4;
+  const std::vector<Flag> flag_list = {
+      Flag("mode", &mode,
+           "One of infer_schema, update_schema, validate or serve."),
+      Flag("schema", &options.schema_path,
+           "The input schema, in text or binary format."),
+      Flag("statistics", &options.statistics_path,
+           "The statistics, as a TFRecord, binary, text or columnar file."),
+      Flag("previous_span_statistics", &options.previous_span_statistics_path,
+           "Optional statistics of the previous span, for drift detection."),
+      Flag("serving_statistics", &options.serving_statistics_path,
+           "Optional statistics of the serving data, for skew detection."),
+      Flag("previous_version_statistics",
+           &options.previous_version_statistics_path,
+           "Optional statistics of the previous version of the data."),
+      Flag("environment", &options.environment,
+           "Optional validation environment."),
+      Flag("validation_config", &options.validation_config_path,
+           "Optional ValidationConfig proto, in text or binary format."),
+      Flag("enable_diff_regions", &options.enable_diff_regions,
+           "Whether to include diff regions in the anomalies."),
+      Flag("max_string_domain_size", &options.max_string_domain_size,
+           "The maximum size of the domain of a categorical string feature."),
+      Flag("infer_feature_shape", &options.infer_feature_shape,
+           "Whether to infer the shape of the features of the schema."),
+      Flag("output", &options.output_path,
+           "Where to write the Schema or Anomalies proto."),
+      Flag("output_format", &output_format, "Either text or binary."),
+      Flag("socket", &socket_path,
+           "The Unix domain socket to serve validations on (serve only)."),
+      Flag("num_threads", &num_threads,
+           "The number of connections served at once (serve only)."),
+  };
+  const std::string usage = tensorflow::Flags::Usage(argv[0], flag_list);
+  if (!tensorflow::Flags::Parse(&argc, argv, flag_list) || argc != 1) {
+    LOG(ERROR) << usage;
+    return 2;
+  }
+  tensorflow::port::InitMain(argv[0], &argc, &argv);
+
+  if (mode == "serve") {
+    std::unique_ptr<ValidationServer> server;
+    const tensorflow::Status status =
+        ValidationServer::Start(socket_path, num_threads, &server);
+    if (!status.ok()) {
+      LOG(ERROR) << status;
+      return 1;
+    }
+    LOG(INFO) << "Serving validations on " << socket_path;
+    server->Wait();
+    return 0;
+  }
+  if (mode == "infer_schema") {
+    options.mode = ValidationToolMode::kInferSchema;
+  } else if (mode == "update_schema") {
+    options.mode = ValidationToolMode::kUpdateSchema;
+  } else if (mode == "validate") {
+    options.mode = ValidationToolMode::kValidate;
+  } else {
+    LOG(ERROR) << "Unknown mode: " << mode << "\n" << usage;
+    return 2;
+  }
+  if (output_format != "text" && output_format != "binary") {
+    LOG(ERROR) << "Unknown output format: " << output_format << "\n" << usage;
+    return 2;
+  }
+  options.text_output = output_format == "text";
+
+  const tensorflow::Status status =
+      tensorflow::data_validation::RunValidationTool(options);
+  if (!status.ok()) {
+    LOG(ERROR) << status;
+    return 1;
+  }
+  return 0;
+}
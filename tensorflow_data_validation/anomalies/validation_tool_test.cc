@@ -0,0 +1,249 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/validation_tool.h"
+
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+#include "absl/types/optional.h"
+#include "tensorflow_data_validation/anomalies/columnar_statistics.h"
+#include "tensorflow_data_validation/anomalies/feature_statistics_validator.h"
+#include "tensorflow_data_validation/anomalies/proto/validation_config.pb.h"
+#include "tensorflow_data_validation/anomalies/test_util.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/record_writer.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow_metadata/proto/v0/anomalies.pb.h"
+#include "tensorflow_metadata/proto/v0/schema.pb.h"
+#include "tensorflow_metadata/proto/v0/statistics.pb.h"
+
+namespace tensorflow {
+namespace data_validation {
+namespace {
+
+using ::tensorflow::metadata::v0::Anomalies;
+using ::tensorflow::metadata::v0::DatasetFeatureStatistics;
+using ::tensorflow::metadata::v0::DatasetFeatureStatisticsList;
+using ::tensorflow::metadata::v0::Schema;
+using testing::EqualsProto;
+using testing::ParseTextProtoOrDie;
+
+DatasetFeatureStatisticsList GetTestStatistics() {
+  return ParseTextProtoOrDie<DatasetFeatureStatisticsList>(R"(
+    datasets {
+      name: "All Examples"
+      num_examples: 10
+      features {
+        path { step: "enum" }
+        type: STRING
+        string_stats {
+          common_stats {
+            num_non_missing: 10
+            min_num_values: 1
+            max_num_values: 1
+          }
+          unique: 2
+          rank_histogram {
+            buckets { label: "A" sample_count: 6 }
+            buckets { label: "B" sample_count: 4 }
+          }
+        }
+      }
+    }
+    datasets {
+      name: "slice"
+      num_examples: 3
+    })");
+}
+
+string TestFilename(const string& name) {
+  return ::testing::TempDir() + "/" + name;
+}
+
+Status WriteTFRecordFile(const string& filename, const string& record) {
+  std::unique_ptr<WritableFile> file;
+  TF_RETURN_IF_ERROR(Env::Default()->NewWritableFile(filename, &file));
+  io::RecordWriter writer(file.get());
+  TF_RETURN_IF_ERROR(writer.WriteRecord(record));
+  TF_RETURN_IF_ERROR(writer.Close());
+  return file->Close();
+}
+
+TEST(ValidationToolTest, ReadStatisticsFileFormats) {
+  const DatasetFeatureStatisticsList statistics = GetTestStatistics();
+
+  const string text_filename = TestFilename("stats.pbtxt");
+  TF_ASSERT_OK(WriteProtoFile(text_filename, /*text_format=*/true, statistics));
+  const string binary_filename = TestFilename("stats.pb");
+  TF_ASSERT_OK(
+      WriteProtoFile(binary_filename, /*text_format=*/false, statistics));
+  const string tfrecord_filename = TestFilename("stats.tfrecord");
+  TF_ASSERT_OK(
+      WriteTFRecordFile(tfrecord_filename, statistics.SerializeAsString()));
+  string columnar;
+  TF_ASSERT_OK(WriteColumnarStatistics(statistics, &columnar));
+  const string columnar_filename = TestFilename("stats.columnar");
+  TF_ASSERT_OK(
+      WriteStringToFile(Env::Default(), columnar_filename, columnar));
+
+  for (const string& filename : {text_filename, binary_filename,
+                                 tfrecord_filename, columnar_filename}) {
+    DatasetFeatureStatisticsList result;
+    TF_ASSERT_OK(ReadStatisticsFile(filename, &result)) << filename;
+    EXPECT_THAT(result, EqualsProto(statistics)) << filename;
+  }
+
+  const string invalid_filename = TestFilename("invalid_stats");
+  TF_ASSERT_OK(
+      WriteStringToFile(Env::Default(), invalid_filename, "datasets {"));
+  DatasetFeatureStatisticsList result;
+  EXPECT_FALSE(ReadStatisticsFile(invalid_filename, &result).ok());
+  EXPECT_FALSE(ReadStatisticsFile(TestFilename("missing"), &result).ok());
+}
+
+TEST(ValidationToolTest, GetDefaultDatasetStatistics) {
+  DatasetFeatureStatisticsList statistics = GetTestStatistics();
+  const DatasetFeatureStatistics* result;
+  TF_ASSERT_OK(GetDefaultDatasetStatistics(statistics, &result));
+  EXPECT_EQ(result, &statistics.datasets(0));
+
+  statistics.mutable_datasets()->SwapElements(0, 1);
+  TF_ASSERT_OK(GetDefaultDatasetStatistics(statistics, &result));
+  EXPECT_EQ(result, &statistics.datasets(1));
+
+  statistics.mutable_datasets(1)->set_name("other_slice");
+  EXPECT_FALSE(GetDefaultDatasetStatistics(statistics, &result).ok());
+
+  statistics.mutable_datasets()->RemoveLast();
+  TF_ASSERT_OK(GetDefaultDatasetStatistics(statistics, &result));
+  EXPECT_EQ(result, &statistics.datasets(0));
+}
+
+TEST(ValidationToolTest, InferAndUpdateSchema) {
+  const DatasetFeatureStatisticsList statistics = GetTestStatistics();
+  const string statistics_filename = TestFilename("infer_stats.pb");
+  TF_ASSERT_OK(
+      WriteProtoFile(statistics_filename, /*text_format=*/false, statistics));
+
+  ValidationToolOptions options;
+  options.mode = ValidationToolMode::kInferSchema;
+  options.statistics_path = statistics_filename;
+  options.output_path = TestFilename("inferred_schema.pbtxt");
+  TF_ASSERT_OK(RunValidationTool(options));
+  Schema inferred_schema;
+  TF_ASSERT_OK(ReadProtoFile(options.output_path, &inferred_schema));
+  EXPECT_THAT(inferred_schema, EqualsProto(R"(
+    feature {
+      name: "enum"
+      type: BYTES
+      domain: "enum"
+      presence { min_fraction: 1 min_count: 1 }
+      shape { dim { size: 1 } }
+    }
+    string_domain { name: "enum" value: "A" value: "B" })"));
+
+  options.infer_feature_shape = false;
+  TF_ASSERT_OK(RunValidationTool(options));
+  TF_ASSERT_OK(ReadProtoFile(options.output_path, &inferred_schema));
+  EXPECT_TRUE(inferred_schema.feature(0).has_value_count());
+
+  // The schema is already up to date.
+  options.mode = ValidationToolMode::kUpdateSchema;
+  options.schema_path = options.output_path;
+  options.output_path = TestFilename("updated_schema.pb");
+  options.text_output = false;
+  TF_ASSERT_OK(RunValidationTool(options));
+  Schema updated_schema;
+  TF_ASSERT_OK(ReadProtoFile(options.output_path, &updated_schema));
+  EXPECT_THAT(updated_schema, EqualsProto(inferred_schema));
+}
+
+TEST(ValidationToolTest, Validate) {
+  const Schema schema = ParseTextProtoOrDie<Schema>(R"(
+    default_environment: "TRAINING"
+    string_domain { name: "MyEnum" value: "A" }
+    feature {
+      name: "enum"
+      presence: { min_count: 1 }
+      type: BYTES
+      domain: "MyEnum"
+      skew_comparator { infinity_norm: { threshold: 0.1 } }
+    })");
+  const DatasetFeatureStatisticsList statistics = GetTestStatistics();
+  DatasetFeatureStatisticsList serving_statistics = statistics;
+  serving_statistics.mutable_datasets()->RemoveLast();
+  serving_statistics.mutable_datasets(0)
+      ->mutable_features(0)
+      ->mutable_string_stats()
+      ->mutable_rank_histogram()
+      ->mutable_buckets(1)
+      ->set_sample_count(1);
+  ValidationConfig validation_config;
+  validation_config.set_new_features_are_warnings(true);
+
+  ValidationToolOptions options;
+  options.schema_path = TestFilename("validate_schema.pbtxt");
+  TF_ASSERT_OK(WriteProtoFile(options.schema_path, /*text_format=*/true,
+                              schema));
+  options.statistics_path = TestFilename("validate_stats.tfrecord");
+  TF_ASSERT_OK(WriteTFRecordFile(options.statistics_path,
+                                 statistics.SerializeAsString()));
+  options.serving_statistics_path = TestFilename("validate_serving.pbtxt");
+  TF_ASSERT_OK(WriteProtoFile(options.serving_statistics_path,
+                              /*text_format=*/true, serving_statistics));
+  options.validation_config_path = TestFilename("validation_config.pbtxt");
+  TF_ASSERT_OK(WriteProtoFile(options.validation_config_path,
+                              /*text_format=*/true, validation_config));
+  options.environment = "TRAINING";
+  options.output_path = TestFilename("anomalies.pbtxt");
+  TF_ASSERT_OK(RunValidationTool(options));
+
+  Anomalies expected;
+  TF_ASSERT_OK(ValidateFeatureStatistics(
+      statistics.datasets(0), schema, string("TRAINING"),
+      /*prev_span_feature_statistics=*/absl::nullopt,
+      serving_statistics.datasets(0),
+      /*prev_version_feature_statistics=*/absl::nullopt,
+      /*features_needed=*/absl::nullopt, validation_config,
+      /*enable_diff_regions=*/false, &expected));
+  ASSERT_EQ(expected.anomaly_info().size(), 1);
+  Anomalies result;
+  TF_ASSERT_OK(ReadProtoFile(options.output_path, &result));
+  EXPECT_THAT(result, EqualsProto(expected));
+
+  options.environment = "SERVING";
+  EXPECT_FALSE(RunValidationTool(options).ok());
+
+  // Columnar statistics are validated through the memory-mapped backend.
+  string columnar;
+  TF_ASSERT_OK(WriteColumnarStatistics(statistics, &columnar));
+  options.statistics_path = TestFilename("validate_stats.columnar");
+  TF_ASSERT_OK(
+      WriteStringToFile(Env::Default(), options.statistics_path, columnar));
+  TF_ASSERT_OK(WriteColumnarStatistics(serving_statistics, &columnar));
+  options.serving_statistics_path = TestFilename("validate_serving.columnar");
+  TF_ASSERT_OK(WriteStringToFile(Env::Default(),
+                                 options.serving_statistics_path, columnar));
+  options.environment = "TRAINING";
+  TF_ASSERT_OK(RunValidationTool(options));
+  TF_ASSERT_OK(ReadProtoFile(options.output_path, &result));
+  EXPECT_THAT(result, EqualsProto(expected));
+}
+
+}  // namespace
+}  // namespace data_validation
+}  // namespace tensorflow
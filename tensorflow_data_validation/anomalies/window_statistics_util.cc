@@ -0,0 +1,926 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/window_statistics_util.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "absl/memory/memory.h"
+#include "absl/types/optional.h"
+#include "tensorflow_data_validation/anomalies/basic_stats_util.h"
+#include "tensorflow_data_validation/anomalies/mergeable_sketches.h"
+#include "tensorflow_data_validation/anomalies/path.h"
+#include "tensorflow/core/lib/core/errors.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+namespace {
+
+using ::tensorflow::metadata::v0::BytesStatistics;
+using ::tensorflow::metadata::v0::CommonStatistics;
+using ::tensorflow::metadata::v0::CustomStatistic;
+using ::tensorflow::metadata::v0::DatasetFeatureStatistics;
+using ::tensorflow::metadata::v0::DatasetFeatureStatisticsList;
+using ::tensorflow::metadata::v0::FeatureNameStatistics;
+using ::tensorflow::metadata::v0::Histogram;
+using ::tensorflow::metadata::v0::NumericStatistics;
+using ::tensorflow::metadata::v0::RankHistogram;
+using ::tensorflow::metadata::v0::StringStatistics;
+using ::tensorflow::metadata::v0::WeightedCommonStatistics;
+using ::tensorflow::metadata::v0::WeightedNumericStatistics;
+using FreqAndValues =
+    google::protobuf::RepeatedPtrField<StringStatistics::FreqAndValue>;
+using Histograms = google::protobuf::RepeatedPtrField<Histogram>;
+
+// The number of quantile intervals per bucket from which the histograms of
+// sketched values are generated.
+constexpr int kQuantileIntervalsPerBucket = 10;
+
+// The label of the top values that are not valid UTF-8, as written by the
+// top-k statistics generators.
+constexpr char kNonUtf8Placeholder[] = "__BYTES_VALUE__";
+
+bool IsValidUtf8(const string& value) {
+  int continuation_bytes = 0;
+  for (const char c : value) {
+    const unsigned char byte = c;
+    if (continuation_bytes > 0) {
+      if ((byte & 0xC0) != 0x80) {
+        return false;
+      }
+      --continuation_bytes;
+    } else if ((byte & 0xE0) == 0xC0 && byte >= 0xC2) {
+      continuation_bytes = 1;
+    } else if ((byte & 0xF0) == 0xE0) {
+      continuation_bytes = 2;
+    } else if ((byte & 0xF8) == 0xF0 && byte <= 0xF4) {
+      continuation_bytes = 3;
+    } else if (byte >= 0x80) {
+      return false;
+    }
+  }
+  return continuation_bytes == 0;
+}
+
+// The count of the values of a histogram bucket, assumed to be uniformly
+// distributed in [low, high].
+struct Mass {
+  double low;
+  double high;
+  double count;
+};
+
+// The values of merged histograms.
+class MergedMasses {
+ public:
+  // Infinite bucket boundaries are clamped to the finite range of all the
+  // histograms added.
+  void AddHistogram(const Histogram& histogram) {
+    for (const Histogram::Bucket& bucket : histogram.buckets()) {
+      masses_.push_back(
+          {bucket.low_value(), bucket.high_value(), bucket.sample_count()});
+      for (const double boundary : {bucket.low_value(), bucket.high_value()}) {
+        if (std::isfinite(boundary)) {
+          min_ = std::min(min_, boundary);
+          max_ = std::max(max_, boundary);
+        }
+      }
+      total_count_ += bucket.sample_count();
+    }
+  }
+
+  bool empty() const { return total_count_ <= 0 || min_ > max_; }
+  double min() const { return min_; }
+  double max() const { return max_; }
+  double total_count() const { return total_count_; }
+
+  // Returns the count of the values below <x>.
+  double CountBelow(double x) const {
+    double count = 0;
+    for (const Mass& mass : masses_) {
+      const double low = Clamp(mass.low);
+      const double high = Clamp(mass.high);
+      if (x >= high) {
+        count += mass.count;
+      } else if (x > low) {
+        count += mass.count * (x - low) / (high - low);
+      }
+    }
+    return count;
+  }
+
+  // Returns the smallest value below which there are <count> values.
+  double InverseCount(double count) const {
+    double low = min_;
+    double high = max_;
+    for (int i = 0; i < 64 && low < high; ++i) {
+      const double middle = low + (high - low) / 2;
+      if (CountBelow(middle) < count) {
+        low = middle;
+      } else {
+        high = middle;
+      }
+    }
+    return high;
+  }
+
+ private:
+  double Clamp(double x) const { return std::min(max_, std::max(min_, x)); }
+
+  std::vector<Mass> masses_;
+  double min_ = std::numeric_limits<double>::infinity();
+  double max_ = -std::numeric_limits<double>::infinity();
+  double total_count_ = 0;
+};
+
+// Merges <histograms>, which have the same type, approximately. The result
+// has as many buckets as the largest histogram.
+void MergeHistograms(const std::vector<const Histogram*>& histograms,
+                     Histogram* result) {
+  MergedMasses masses;
+  int num_buckets = 0;
+  uint64 num_nan = 0;
+  uint64 num_undefined = 0;
+  for (const Histogram* histogram : histograms) {
+    masses.AddHistogram(*histogram);
+    num_buckets = std::max(num_buckets, histogram->buckets_size());
+    num_nan += histogram->num_nan();
+    num_undefined += histogram->num_undefined();
+  }
+  result->clear_buckets();
+  result->set_num_nan(num_nan);
+  result->set_num_undefined(num_undefined);
+  if (masses.empty() || num_buckets == 0) {
+    return;
+  }
+  const double total_count = masses.total_count();
+  if (masses.min() == masses.max()) {
+    Histogram::Bucket* bucket = result->add_buckets();
+    bucket->set_low_value(masses.min());
+    bucket->set_high_value(masses.max());
+    bucket->set_sample_count(total_count);
+    return;
+  }
+  std::vector<double> boundaries = {masses.min()};
+  for (int i = 1; i < num_buckets; ++i) {
+    boundaries.push_back(
+        result->type() == Histogram::QUANTILES
+            ? masses.InverseCount(total_count * i / num_buckets)
+            : masses.min() + (masses.max() - masses.min()) * i / num_buckets);
+  }
+  boundaries.push_back(masses.max());
+  double count_below = 0;
+  for (int i = 0; i < num_buckets; ++i) {
+    const double count = i + 1 == num_buckets
+                             ? total_count
+                             : masses.CountBelow(boundaries[i + 1]);
+    Histogram::Bucket* bucket = result->add_buckets();
+    bucket->set_low_value(boundaries[i]);
+    bucket->set_high_value(boundaries[i + 1]);
+    bucket->set_sample_count(
+        result->type() == Histogram::QUANTILES ? total_count / num_buckets
+                                               : count - count_below);
+    count_below = count;
+  }
+}
+
+// Returns the median of the values of <histograms>, preferring QUANTILES
+// histograms.
+double MedianOfHistograms(const std::vector<const Histograms*>& histograms) {
+  for (const Histogram::HistogramType type :
+       {Histogram::QUANTILES, Histogram::STANDARD}) {
+    MergedMasses masses;
+    for (const auto* repeated_histograms : histograms) {
+      for (const Histogram& histogram : *repeated_histograms) {
+        if (histogram.type() == type) {
+          masses.AddHistogram(histogram);
+        }
+      }
+    }
+    if (!masses.empty()) {
+      return masses.InverseCount(masses.total_count() / 2);
+    }
+  }
+  return 0;
+}
+
+// Merges the repeated histograms (e.g. NumericStatistics.histograms) of the
+// statistics, by type, approximately.
+void MergeRepeatedHistograms(const std::vector<const Histograms*>& histograms,
+                             Histograms* result) {
+  // The types of histograms, in the order of the last statistics.
+  std::vector<Histogram::HistogramType> types;
+  for (auto it = histograms.rbegin(); it != histograms.rend(); ++it) {
+    for (const Histogram& histogram : **it) {
+      if (std::find(types.begin(), types.end(), histogram.type()) ==
+          types.end()) {
+        types.push_back(histogram.type());
+      }
+    }
+  }
+  result->Clear();
+  for (const Histogram::HistogramType type : types) {
+    std::vector<const Histogram*> same_type;
+    for (const auto* repeated_histograms : histograms) {
+      for (const Histogram& histogram : *repeated_histograms) {
+        if (histogram.type() == type) {
+          same_type.push_back(&histogram);
+        }
+      }
+    }
+    Histogram* merged = result->Add();
+    merged->set_type(type);
+    merged->set_name(same_type.back()->name());
+    MergeHistograms(same_type, merged);
+  }
+}
+
+// Merges the (label, count) buckets of rank histograms or top values by
+// summing their counts, and returns the <num_labels> labels with the largest
+// counts, by decreasing count and then by label.
+std::vector<std::pair<string, double>> MergeLabelCounts(
+    const std::vector<std::vector<std::pair<string, double>>>& label_counts,
+    int num_labels) {
+  std::map<string, double> counts;
+  for (const auto& labels : label_counts) {
+    for (const auto& label_count : labels) {
+      counts[label_count.first] += label_count.second;
+    }
+  }
+  std::vector<std::pair<string, double>> result(counts.begin(), counts.end());
+  std::stable_sort(result.begin(), result.end(),
+                   [](const std::pair<string, double>& a,
+                      const std::pair<string, double>& b) {
+                     return a.second > b.second;
+                   });
+  if (result.size() > num_labels) {
+    result.resize(num_labels);
+  }
+  return result;
+}
+
+void SetTopValues(const std::vector<std::pair<string, double>>& top_values,
+                  FreqAndValues* result) {
+  result->Clear();
+  for (const auto& top_value : top_values) {
+    StringStatistics::FreqAndValue* freq_and_value = result->Add();
+    freq_and_value->set_value(top_value.first);
+    freq_and_value->set_frequency(top_value.second);
+  }
+}
+
+void SetRankHistogram(const std::vector<std::pair<string, double>>& top_values,
+                      RankHistogram* result) {
+  result->clear_buckets();
+  for (int rank = 0; rank < top_values.size(); ++rank) {
+    RankHistogram::Bucket* bucket = result->add_buckets();
+    bucket->set_low_rank(rank);
+    bucket->set_high_rank(rank);
+    bucket->set_label(top_values[rank].first);
+    bucket->set_sample_count(top_values[rank].second);
+  }
+}
+
+// Merges top values and rank histograms by summing their counts.
+void MergeTopValuesAndRankHistograms(
+    const std::vector<const FreqAndValues*>& top_values,
+    const std::vector<const RankHistogram*>& rank_histograms,
+    FreqAndValues* top_values_result,
+    RankHistogram* rank_histogram_result) {
+  std::vector<std::vector<std::pair<string, double>>> label_counts;
+  int num_top_values = 0;
+  for (const auto* values : top_values) {
+    label_counts.emplace_back();
+    for (const StringStatistics::FreqAndValue& value : *values) {
+      label_counts.back().emplace_back(value.value(), value.frequency());
+    }
+    num_top_values = std::max(num_top_values, values->size());
+  }
+  SetTopValues(MergeLabelCounts(label_counts, num_top_values),
+               top_values_result);
+
+  label_counts.clear();
+  int num_buckets = 0;
+  for (const RankHistogram* rank_histogram : rank_histograms) {
+    label_counts.emplace_back();
+    for (const RankHistogram::Bucket& bucket : rank_histogram->buckets()) {
+      label_counts.back().emplace_back(bucket.label(), bucket.sample_count());
+    }
+    num_buckets = std::max(num_buckets, rank_histogram->buckets_size());
+  }
+  SetRankHistogram(MergeLabelCounts(label_counts, num_buckets),
+                   rank_histogram_result);
+}
+
+// Accumulates the count, mean and standard deviation of several sets of
+// values.
+class Moments {
+ public:
+  void Add(double count, double mean, double std_dev) {
+    count_ += count;
+    sum_ += count * mean;
+    sum_of_squares_ += count * (std_dev * std_dev + mean * mean);
+  }
+
+  double count() const { return count_; }
+  double mean() const { return count_ > 0 ? sum_ / count_ : 0; }
+  double std_dev() const {
+    if (count_ <= 0) {
+      return 0;
+    }
+    const double mean = sum_ / count_;
+    return std::sqrt(std::max(0.0, sum_of_squares_ / count_ - mean * mean));
+  }
+
+ private:
+  double count_ = 0;
+  double sum_ = 0;
+  double sum_of_squares_ = 0;
+};
+
+const CommonStatistics* GetCommonStats(const FeatureNameStatistics& feature) {
+  switch (feature.stats_case()) {
+    case FeatureNameStatistics::kNumStats:
+      return &feature.num_stats().common_stats();
+    case FeatureNameStatistics::kStringStats:
+      return &feature.string_stats().common_stats();
+    case FeatureNameStatistics::kBytesStats:
+      return &feature.bytes_stats().common_stats();
+    case FeatureNameStatistics::kStructStats:
+      return &feature.struct_stats().common_stats();
+    default:
+      return nullptr;
+  }
+}
+
+CommonStatistics* GetMutableCommonStats(FeatureNameStatistics* feature) {
+  switch (feature->stats_case()) {
+    case FeatureNameStatistics::kNumStats:
+      return feature->mutable_num_stats()->mutable_common_stats();
+    case FeatureNameStatistics::kStringStats:
+      return feature->mutable_string_stats()->mutable_common_stats();
+    case FeatureNameStatistics::kBytesStats:
+      return feature->mutable_bytes_stats()->mutable_common_stats();
+    case FeatureNameStatistics::kStructStats:
+      return feature->mutable_struct_stats()->mutable_common_stats();
+    default:
+      return nullptr;
+  }
+}
+
+// Returns the total number of values at the leaf level.
+uint64 GetLeafNumValues(const CommonStatistics& common_stats) {
+  return common_stats.presence_and_valency_stats().empty()
+             ? common_stats.tot_num_values()
+             : common_stats.presence_and_valency_stats().rbegin()
+                   ->tot_num_values();
+}
+
+void MergeWeightedCommonStats(
+    const std::vector<const WeightedCommonStatistics*>& stats,
+    double extra_num_missing, WeightedCommonStatistics* result) {
+  double num_non_missing = 0;
+  double num_missing = extra_num_missing;
+  double tot_num_values = 0;
+  for (const WeightedCommonStatistics* weighted_stats : stats) {
+    num_non_missing += weighted_stats->num_non_missing();
+    num_missing += weighted_stats->num_missing();
+    tot_num_values += weighted_stats->tot_num_values();
+  }
+  result->set_num_non_missing(num_non_missing);
+  result->set_num_missing(num_missing);
+  result->set_tot_num_values(tot_num_values);
+  result->set_avg_num_values(
+      num_non_missing > 0 ? tot_num_values / num_non_missing : 0);
+}
+
+// Merges the common statistics of a feature. <extra_num_missing> and
+// <extra_weighted_num_missing> are the examples of the datasets without the
+// feature. The num values histogram is generated from <num_values> if not
+// null.
+Status MergeCommonStats(const std::vector<const CommonStatistics*>& stats,
+                        uint64 extra_num_missing,
+                        double extra_weighted_num_missing,
+                        const KllQuantiles* num_values,
+                        CommonStatistics* result) {
+  uint64 num_non_missing = 0;
+  uint64 num_missing = extra_num_missing;
+  uint64 tot_num_values = 0;
+  absl::optional<uint64> min_num_values;
+  uint64 max_num_values = 0;
+  int num_values_buckets = 0;
+  std::vector<const Histogram*> num_values_histograms;
+  std::vector<const Histogram*> feature_list_length_histograms;
+  std::vector<const WeightedCommonStatistics*> weighted_stats;
+  for (const CommonStatistics* common_stats : stats) {
+    num_non_missing += common_stats->num_non_missing();
+    num_missing += common_stats->num_missing();
+    tot_num_values += common_stats->tot_num_values();
+    if (common_stats->num_non_missing() > 0) {
+      min_num_values = std::min(
+          min_num_values.value_or(common_stats->min_num_values()),
+          common_stats->min_num_values());
+      max_num_values =
+          std::max(max_num_values, common_stats->max_num_values());
+    }
+    if (common_stats->has_num_values_histogram()) {
+      num_values_histograms.push_back(&common_stats->num_values_histogram());
+      num_values_buckets =
+          std::max(num_values_buckets,
+                   common_stats->num_values_histogram().buckets_size());
+    }
+    if (common_stats->has_feature_list_length_histogram()) {
+      feature_list_length_histograms.push_back(
+          &common_stats->feature_list_length_histogram());
+    }
+    if (common_stats->has_weighted_common_stats()) {
+      weighted_stats.push_back(&common_stats->weighted_common_stats());
+    }
+  }
+  result->set_num_non_missing(num_non_missing);
+  result->set_num_missing(num_missing);
+  result->set_tot_num_values(tot_num_values);
+  result->set_min_num_values(min_num_values.value_or(0));
+  result->set_max_num_values(max_num_values);
+  result->set_avg_num_values(
+      num_non_missing > 0
+          ? static_cast<double>(tot_num_values) / num_non_missing
+          : 0);
+  if (num_values != nullptr && num_values->count() > 0 &&
+      num_values_buckets > 0) {
+    result->clear_num_values_histogram();
+    TF_RETURN_IF_ERROR(GenerateQuantilesHistogram(
+        num_values->GetQuantiles(num_values_buckets), num_non_missing,
+        num_values_buckets, result->mutable_num_values_histogram()));
+  } else if (!num_values_histograms.empty()) {
+    result->mutable_num_values_histogram()->set_type(
+        num_values_histograms.back()->type());
+    MergeHistograms(num_values_histograms,
+                    result->mutable_num_values_histogram());
+  }
+  if (!feature_list_length_histograms.empty()) {
+    result->mutable_feature_list_length_histogram()->set_type(
+        feature_list_length_histograms.back()->type());
+    MergeHistograms(feature_list_length_histograms,
+                    result->mutable_feature_list_length_histogram());
+  }
+  if (!weighted_stats.empty()) {
+    MergeWeightedCommonStats(weighted_stats, extra_weighted_num_missing,
+                             result->mutable_weighted_common_stats());
+  }
+
+  // The presence and valency statistics of the nest levels are merged if all
+  // the statistics have the same number of levels.
+  const int num_levels = stats.back()->presence_and_valency_stats_size();
+  for (const CommonStatistics* common_stats : stats) {
+    if (common_stats->presence_and_valency_stats_size() != num_levels) {
+      result->clear_presence_and_valency_stats();
+      result->clear_weighted_presence_and_valency_stats();
+      return Status::OK();
+    }
+  }
+  for (int level = 0; level < num_levels; ++level) {
+    metadata::v0::PresenceAndValencyStatistics* level_result =
+        result->mutable_presence_and_valency_stats(level);
+    uint64 level_num_non_missing = 0;
+    uint64 level_num_missing = level == 0 ? extra_num_missing : 0;
+    uint64 level_tot_num_values = 0;
+    absl::optional<uint64> level_min_num_values;
+    uint64 level_max_num_values = 0;
+    std::vector<const WeightedCommonStatistics*> level_weighted_stats;
+    for (const CommonStatistics* common_stats : stats) {
+      const auto& level_stats = common_stats->presence_and_valency_stats(level);
+      level_num_non_missing += level_stats.num_non_missing();
+      level_num_missing += level_stats.num_missing();
+      level_tot_num_values += level_stats.tot_num_values();
+      if (level_stats.num_non_missing() > 0) {
+        level_min_num_values = std::min(
+            level_min_num_values.value_or(level_stats.min_num_values()),
+            level_stats.min_num_values());
+        level_max_num_values =
+            std::max(level_max_num_values, level_stats.max_num_values());
+      }
+      if (level < common_stats->weighted_presence_and_valency_stats_size()) {
+        level_weighted_stats.push_back(
+            &common_stats->weighted_presence_and_valency_stats(level));
+      }
+    }
+    level_result->set_num_non_missing(level_num_non_missing);
+    level_result->set_num_missing(level_num_missing);
+    level_result->set_tot_num_values(level_tot_num_values);
+    level_result->set_min_num_values(level_min_num_values.value_or(0));
+    level_result->set_max_num_values(level_max_num_values);
+    if (level < result->weighted_presence_and_valency_stats_size()) {
+      MergeWeightedCommonStats(
+          level_weighted_stats, level == 0 ? extra_weighted_num_missing : 0,
+          result->mutable_weighted_presence_and_valency_stats(level));
+    }
+  }
+  return Status::OK();
+}
+
+// Merges numeric statistics, whose histograms and median are generated from
+// <values> if not null.
+Status MergeNumericStats(const std::vector<const NumericStatistics*>& stats,
+                         const KllQuantiles* values,
+                         NumericStatistics* result) {
+  Moments moments;
+  uint64 num_zeros = 0;
+  absl::optional<double> min;
+  absl::optional<double> max;
+  std::vector<const Histograms*> histograms;
+  for (const NumericStatistics* numeric_stats : stats) {
+    const uint64 num_nan = numeric_stats->histograms().empty()
+                               ? 0
+                               : numeric_stats->histograms(0).num_nan();
+    const double count =
+        static_cast<double>(GetLeafNumValues(numeric_stats->common_stats())) -
+        num_nan;
+    moments.Add(count, numeric_stats->mean(), numeric_stats->std_dev());
+    num_zeros += numeric_stats->num_zeros();
+    if (count > 0) {
+      min = std::min(min.value_or(numeric_stats->min()), numeric_stats->min());
+      max = std::max(max.value_or(numeric_stats->max()), numeric_stats->max());
+    }
+    histograms.push_back(&numeric_stats->histograms());
+  }
+  result->set_mean(moments.mean());
+  result->set_std_dev(moments.std_dev());
+  result->set_num_zeros(num_zeros);
+  result->set_min(min.value_or(0));
+  result->set_max(max.value_or(0));
+
+  if (values == nullptr || values->count() == 0) {
+    result->set_median(MedianOfHistograms(histograms));
+    MergeRepeatedHistograms(histograms, result->mutable_histograms());
+  } else {
+    result->set_median(values->GetQuantiles(2)[1]);
+    // The histograms have as many buckets as the largest ones of their type.
+    std::map<Histogram::HistogramType, int> num_buckets_by_type;
+    for (const Histograms* repeated_histograms : histograms) {
+      for (const Histogram& histogram : *repeated_histograms) {
+        int& num_buckets = num_buckets_by_type[histogram.type()];
+        num_buckets = std::max(num_buckets, histogram.buckets_size());
+      }
+    }
+    MergeRepeatedHistograms(histograms, result->mutable_histograms());
+    for (Histogram& histogram : *result->mutable_histograms()) {
+      const int num_buckets = num_buckets_by_type[histogram.type()];
+      if (num_buckets == 0) {
+        continue;
+      }
+      histogram.clear_buckets();
+      if (histogram.type() == Histogram::QUANTILES) {
+        TF_RETURN_IF_ERROR(GenerateQuantilesHistogram(
+            values->GetQuantiles(num_buckets), values->count(), num_buckets,
+            &histogram));
+      } else {
+        TF_RETURN_IF_ERROR(GenerateEquiWidthHistogram(
+            values->GetQuantiles(num_buckets * kQuantileIntervalsPerBucket),
+            values->finite_min(), values->finite_max(), values->count(),
+            num_buckets, &histogram));
+      }
+    }
+  }
+
+  std::vector<const WeightedNumericStatistics*> weighted_stats;
+  Moments weighted_moments;
+  std::vector<const Histograms*> weighted_histograms;
+  for (const NumericStatistics* numeric_stats : stats) {
+    if (!numeric_stats->has_weighted_numeric_stats()) {
+      continue;
+    }
+    const WeightedNumericStatistics& weighted =
+        numeric_stats->weighted_numeric_stats();
+    weighted_moments.Add(
+        numeric_stats->common_stats().weighted_common_stats().tot_num_values(),
+        weighted.mean(), weighted.std_dev());
+    weighted_histograms.push_back(&weighted.histograms());
+  }
+  if (!weighted_histograms.empty()) {
+    WeightedNumericStatistics* weighted_result =
+        result->mutable_weighted_numeric_stats();
+    weighted_result->set_mean(weighted_moments.mean());
+    weighted_result->set_std_dev(weighted_moments.std_dev());
+    weighted_result->set_median(MedianOfHistograms(weighted_histograms));
+    MergeRepeatedHistograms(weighted_histograms,
+                            weighted_result->mutable_histograms());
+  }
+  return Status::OK();
+}
+
+// Merges string statistics, whose number of unique values, top values and
+// rank histogram are computed from <sketches> if not null.
+void MergeStringStats(const std::vector<const StringStatistics*>& stats,
+                      const MergeableFeatureSketches* sketches,
+                      StringStatistics* result) {
+  uint64 unique = 0;
+  double total_length = 0;
+  double total_num_values = 0;
+  std::vector<const FreqAndValues*> top_values;
+  std::vector<const RankHistogram*> rank_histograms;
+  std::vector<const FreqAndValues*> weighted_top_values;
+  std::vector<const RankHistogram*> weighted_rank_histograms;
+  for (const StringStatistics* string_stats : stats) {
+    unique = std::max(unique, string_stats->unique());
+    const double num_values = GetLeafNumValues(string_stats->common_stats());
+    total_length += string_stats->avg_length() * num_values;
+    total_num_values += num_values;
+    top_values.push_back(&string_stats->top_values());
+    rank_histograms.push_back(&string_stats->rank_histogram());
+    if (string_stats->has_weighted_string_stats()) {
+      weighted_top_values.push_back(
+          &string_stats->weighted_string_stats().top_values());
+      weighted_rank_histograms.push_back(
+          &string_stats->weighted_string_stats().rank_histogram());
+    }
+  }
+  result->set_avg_length(total_num_values > 0
+                             ? total_length / total_num_values
+                             : 0);
+  if (sketches != nullptr && sketches->has_string_values()) {
+    result->set_unique(sketches->distinct_values().Estimate());
+    int num_top_values = 0;
+    int num_buckets = 0;
+    for (const StringStatistics* string_stats : stats) {
+      num_top_values =
+          std::max(num_top_values, string_stats->top_values_size());
+      num_buckets =
+          std::max(num_buckets, string_stats->rank_histogram().buckets_size());
+    }
+    std::vector<std::pair<string, double>> values =
+        sketches->top_values().GetTopValues(
+            std::max(num_top_values, num_buckets));
+    for (auto& value : values) {
+      if (!IsValidUtf8(value.first)) {
+        value.first = kNonUtf8Placeholder;
+      }
+    }
+    SetRankHistogram({values.begin(),
+                      values.begin() + std::min<int>(num_buckets,
+                                                     values.size())},
+                     result->mutable_rank_histogram());
+    values.resize(std::min<int>(num_top_values, values.size()));
+    SetTopValues(values, result->mutable_top_values());
+  } else {
+    result->set_unique(unique);
+    MergeTopValuesAndRankHistograms(top_values, rank_histograms,
+                                    result->mutable_top_values(),
+                                    result->mutable_rank_histogram());
+  }
+  if (!weighted_top_values.empty()) {
+    MergeTopValuesAndRankHistograms(
+        weighted_top_values, weighted_rank_histograms,
+        result->mutable_weighted_string_stats()->mutable_top_values(),
+        result->mutable_weighted_string_stats()->mutable_rank_histogram());
+  }
+}
+
+void MergeBytesStats(const std::vector<const BytesStatistics*>& stats,
+                     BytesStatistics* result) {
+  uint64 unique = 0;
+  double total_num_bytes = 0;
+  double total_num_values = 0;
+  absl::optional<float> min_num_bytes;
+  float max_num_bytes = 0;
+  for (const BytesStatistics* bytes_stats : stats) {
+    unique = std::max(unique, bytes_stats->unique());
+    const double num_values = bytes_stats->common_stats().tot_num_values();
+    total_num_bytes += bytes_stats->avg_num_bytes() * num_values;
+    total_num_values += num_values;
+    if (num_values > 0) {
+      min_num_bytes = std::min(
+          min_num_bytes.value_or(bytes_stats->min_num_bytes()),
+          bytes_stats->min_num_bytes());
+      max_num_bytes = std::max(max_num_bytes, bytes_stats->max_num_bytes());
+    }
+  }
+  result->set_unique(unique);
+  result->set_avg_num_bytes(
+      total_num_values > 0 ? total_num_bytes / total_num_values : 0);
+  result->set_min_num_bytes(min_num_bytes.value_or(0));
+  result->set_max_num_bytes(max_num_bytes);
+}
+
+// Merges the custom histograms (e.g. the value list length of nested levels)
+// by name. The other custom statistics are those of the last feature.
+void MergeCustomStats(const std::vector<const FeatureNameStatistics*>& features,
+                      FeatureNameStatistics* result) {
+  result->clear_custom_stats();
+  for (const CustomStatistic& custom_stat : features.back()->custom_stats()) {
+    if (custom_stat.name() == kFeatureSketchesCustomStatName) {
+      continue;
+    }
+    CustomStatistic* merged = result->add_custom_stats();
+    *merged = custom_stat;
+    if (custom_stat.val_case() != CustomStatistic::kHistogram) {
+      continue;
+    }
+    std::vector<const Histogram*> histograms;
+    for (const FeatureNameStatistics* feature : features) {
+      for (const CustomStatistic& other : feature->custom_stats()) {
+        if (other.name() == custom_stat.name() &&
+            other.val_case() == CustomStatistic::kHistogram &&
+            other.histogram().type() == custom_stat.histogram().type()) {
+          histograms.push_back(&other.histogram());
+        }
+      }
+    }
+    MergeHistograms(histograms, merged->mutable_histogram());
+  }
+}
+
+// Merges the statistics of a feature in the datasets that have it. The
+// datasets without it have <extra_num_missing> examples, of total weight
+// <extra_weighted_num_missing>.
+Status MergeFeatureStatistics(
+    const std::vector<const FeatureNameStatistics*>& features,
+    uint64 extra_num_missing, double extra_weighted_num_missing,
+    FeatureNameStatistics* result) {
+  // The sketches are only used if all the features have them.
+  std::unique_ptr<MergeableFeatureSketches> sketches;
+  for (const FeatureNameStatistics* feature : features) {
+    absl::optional<FeatureSketches> feature_sketches;
+    TF_RETURN_IF_ERROR(GetFeatureSketches(*feature, &feature_sketches));
+    if (!feature_sketches) {
+      sketches.reset();
+      break;
+    }
+    MergeableFeatureSketches merged_sketches;
+    TF_RETURN_IF_ERROR(MergeableFeatureSketches::FromProto(*feature_sketches,
+                                                           &merged_sketches));
+    if (sketches == nullptr) {
+      sketches = absl::make_unique<MergeableFeatureSketches>(
+          std::move(merged_sketches));
+    } else {
+      TF_RETURN_IF_ERROR(sketches->Merge(merged_sketches));
+    }
+  }
+
+  // The result has the identity, type and the non-mergeable fields of the
+  // last feature.
+  *result = *features.back();
+  std::vector<const CommonStatistics*> common_stats;
+  std::vector<const NumericStatistics*> numeric_stats;
+  std::vector<const StringStatistics*> string_stats;
+  std::vector<const BytesStatistics*> bytes_stats;
+  for (const FeatureNameStatistics* feature : features) {
+    const CommonStatistics* feature_common_stats = GetCommonStats(*feature);
+    if (feature_common_stats != nullptr) {
+      common_stats.push_back(feature_common_stats);
+    }
+    if (feature->stats_case() != result->stats_case()) {
+      continue;
+    }
+    if (feature->has_num_stats()) {
+      numeric_stats.push_back(&feature->num_stats());
+    } else if (feature->has_string_stats()) {
+      string_stats.push_back(&feature->string_stats());
+    } else if (feature->has_bytes_stats()) {
+      bytes_stats.push_back(&feature->bytes_stats());
+    }
+  }
+  CommonStatistics* result_common_stats = GetMutableCommonStats(result);
+  if (result_common_stats != nullptr) {
+    TF_RETURN_IF_ERROR(MergeCommonStats(
+        common_stats, extra_num_missing, extra_weighted_num_missing,
+        sketches != nullptr ? &sketches->num_values() : nullptr,
+        result_common_stats));
+  }
+  if (!numeric_stats.empty()) {
+    TF_RETURN_IF_ERROR(MergeNumericStats(
+        numeric_stats, sketches != nullptr ? &sketches->values() : nullptr,
+        result->mutable_num_stats()));
+  } else if (!string_stats.empty()) {
+    MergeStringStats(string_stats, sketches.get(),
+                     result->mutable_string_stats());
+  } else if (!bytes_stats.empty()) {
+    MergeBytesStats(bytes_stats, result->mutable_bytes_stats());
+  }
+  MergeCustomStats(features, result);
+  if (sketches != nullptr) {
+    FeatureSketches sketches_proto;
+    sketches->ToProto(&sketches_proto);
+    SetFeatureSketches(sketches_proto, result);
+  }
+  return Status::OK();
+}
+
+Path GetFeaturePath(const FeatureNameStatistics& feature) {
+  return feature.has_path() ? Path(feature.path()) : Path({feature.name()});
+}
+
+// Merges the statistics of the same dataset.
+Status MergeDatasetStatistics(
+    const std::vector<const DatasetFeatureStatistics*>& datasets,
+    DatasetFeatureStatistics* result) {
+  result->set_name(datasets.front()->name());
+  uint64 num_examples = 0;
+  double weighted_num_examples = 0;
+  // The features of each dataset (or null), in the order in which they are
+  // first seen.
+  std::vector<Path> paths;
+  std::map<Path, std::vector<const FeatureNameStatistics*>> features;
+  for (int i = 0; i < datasets.size(); ++i) {
+    num_examples += datasets[i]->num_examples();
+    weighted_num_examples += datasets[i]->weighted_num_examples();
+    for (const FeatureNameStatistics& feature : datasets[i]->features()) {
+      const Path path = GetFeaturePath(feature);
+      auto it = features.find(path);
+      if (it == features.end()) {
+        paths.push_back(path);
+        it = features.emplace(path, std::vector<const FeatureNameStatistics*>(
+                                        datasets.size(), nullptr))
+                 .first;
+      }
+      it->second[i] = &feature;
+    }
+  }
+  result->set_num_examples(num_examples);
+  result->set_weighted_num_examples(weighted_num_examples);
+  for (const Path& path : paths) {
+    std::vector<const FeatureNameStatistics*> present;
+    uint64 extra_num_missing = 0;
+    double extra_weighted_num_missing = 0;
+    for (int i = 0; i < datasets.size(); ++i) {
+      const FeatureNameStatistics* feature = features[path][i];
+      if (feature != nullptr) {
+        present.push_back(feature);
+      } else if (path.size() == 1) {
+        // A top-level feature missing from a dataset is missing in all its
+        // examples.
+        extra_num_missing += datasets[i]->num_examples();
+        extra_weighted_num_missing += datasets[i]->weighted_num_examples();
+      }
+    }
+    TF_RETURN_IF_ERROR(MergeFeatureStatistics(present, extra_num_missing,
+                                              extra_weighted_num_missing,
+                                              result->add_features()));
+  }
+  return Status::OK();
+}
+
+}  // namespace
+
+Status MergeStatistics(
+    const std::vector<DatasetFeatureStatisticsList>& statistics,
+    DatasetFeatureStatisticsList* result) {
+  result->Clear();
+  std::vector<string> names;
+  std::map<string, std::vector<const DatasetFeatureStatistics*>> datasets;
+  for (const DatasetFeatureStatisticsList& statistics_list : statistics) {
+    for (const DatasetFeatureStatistics& dataset : statistics_list.datasets()) {
+      auto& same_name = datasets[dataset.name()];
+      if (same_name.empty()) {
+        names.push_back(dataset.name());
+      }
+      same_name.push_back(&dataset);
+    }
+  }
+  for (const string& name : names) {
+    TF_RETURN_IF_ERROR(
+        MergeDatasetStatistics(datasets[name], result->add_datasets()));
+  }
+  return Status::OK();
+}
+
+Status MergeStatistics(const std::vector<string>& serialized_statistics,
+                       string* serialized_result) {
+  std::vector<DatasetFeatureStatisticsList> statistics(
+      serialized_statistics.size());
+  for (int i = 0; i < serialized_statistics.size(); ++i) {
+    if (!statistics[i].ParseFromString(serialized_statistics[i])) {
+      return errors::InvalidArgument(
+          "Failed to parse DatasetFeatureStatisticsList proto.");
+    }
+  }
+  DatasetFeatureStatisticsList result;
+  TF_RETURN_IF_ERROR(MergeStatistics(statistics, &result));
+  if (!result.SerializeToString(serialized_result)) {
+    return errors::Internal(
+        "Could not serialize DatasetFeatureStatisticsList proto to string.");
+  }
+  return Status::OK();
+}
+
+}  // namespace data_validation
+}  // namespace tensorflow
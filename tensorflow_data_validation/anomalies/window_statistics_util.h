@@ -0,0 +1,54 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Merges the statistics of disjoint datasets, e.g. the daily statistics of the
+// days of a rolling window, into the statistics of their union, without
+// recomputing them from the data.
+#ifndef TENSORFLOW_DATA_VALIDATION_ANOMALIES_WINDOW_STATISTICS_UTIL_H_
+#define TENSORFLOW_DATA_VALIDATION_ANOMALIES_WINDOW_STATISTICS_UTIL_H_
+
+#include <vector>
+
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow_metadata/proto/v0/statistics.pb.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+// Merges <statistics> into the statistics of the union of their datasets. The
+// datasets of the lists are matched by name, and their features by path.
+// The counts, means, standard deviations, min and max are exact. If all the
+// merged statistics of a feature embed its sketches (see
+// mergeable_sketches.h), its number of unique values, top values, median and
+// histograms are computed from the merged sketches, which are embedded in the
+// result. Otherwise they are approximated from the statistics: the number of
+// unique values is the largest one (a lower bound), the counts of the top
+// values are summed, and histograms are merged assuming that the values are
+// uniformly distributed within buckets. The other custom statistics are taken
+// from the last statistics, and cross feature statistics are dropped.
+Status MergeStatistics(
+    const std::vector<metadata::v0::DatasetFeatureStatisticsList>& statistics,
+    metadata::v0::DatasetFeatureStatisticsList* result);
+
+// Same as above, but takes and outputs serialized
+// DatasetFeatureStatisticsList protos.
+Status MergeStatistics(const std::vector<string>& serialized_statistics,
+                       string* serialized_result);
+
+}  // namespace data_validation
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_DATA_VALIDATION_ANOMALIES_WINDOW_STATISTICS_UTIL_H_
@@ -0,0 +1,304 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/anomalies/window_statistics_util.h"
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include "absl/strings/str_cat.h"
+#include "absl/types/optional.h"
+#include "tensorflow_data_validation/anomalies/feature_statistics_validator.h"
+#include "tensorflow_data_validation/anomalies/mergeable_sketches.h"
+#include "tensorflow_data_validation/anomalies/proto/validation_config.pb.h"
+#include "tensorflow_data_validation/anomalies/test_util.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow_metadata/proto/v0/anomalies.pb.h"
+#include "tensorflow_metadata/proto/v0/schema.pb.h"
+#include "tensorflow_metadata/proto/v0/statistics.pb.h"
+
+namespace tensorflow {
+namespace data_validation {
+namespace {
+
+using ::tensorflow::metadata::v0::DatasetFeatureStatistics;
+using ::tensorflow::metadata::v0::DatasetFeatureStatisticsList;
+using ::tensorflow::metadata::v0::FeatureNameStatistics;
+using ::tensorflow::metadata::v0::Histogram;
+using testing::EqualsProto;
+using testing::ParseTextProtoOrDie;
+
+TEST(MergeStatisticsTest, MergesCountsAndMoments) {
+  const std::vector<DatasetFeatureStatisticsList> daily = {
+      ParseTextProtoOrDie<DatasetFeatureStatisticsList>(R"(
+        datasets {
+          name: "All Examples"
+          num_examples: 10
+          features {
+            path { step: "x" }
+            type: FLOAT
+            num_stats {
+              common_stats {
+                num_non_missing: 8
+                num_missing: 2
+                min_num_values: 1
+                max_num_values: 2
+                avg_num_values: 1.5
+                tot_num_values: 12
+              }
+              mean: 1
+              std_dev: 1
+              num_zeros: 3
+              min: 0
+              max: 4
+              histograms {
+                num_nan: 2
+                type: QUANTILES
+                buckets { low_value: 0 high_value: 1 sample_count: 5 }
+                buckets { low_value: 1 high_value: 4 sample_count: 5 }
+              }
+            }
+          }
+          features {
+            path { step: "s" }
+            type: STRING
+            string_stats {
+              common_stats { num_non_missing: 10 tot_num_values: 10 }
+              unique: 3
+              avg_length: 2
+              top_values { value: "a" frequency: 6 }
+              top_values { value: "b" frequency: 3 }
+            }
+          }
+        })"),
+      ParseTextProtoOrDie<DatasetFeatureStatisticsList>(R"(
+        datasets {
+          name: "All Examples"
+          num_examples: 5
+          features {
+            path { step: "x" }
+            type: FLOAT
+            num_stats {
+              common_stats {
+                num_non_missing: 5
+                min_num_values: 2
+                max_num_values: 3
+                avg_num_values: 2
+                tot_num_values: 10
+              }
+              mean: 4
+              std_dev: 2
+              num_zeros: 1
+              min: -1
+              max: 10
+              histograms {
+                type: QUANTILES
+                buckets { low_value: -1 high_value: 4 sample_count: 5 }
+                buckets { low_value: 4 high_value: 10 sample_count: 5 }
+              }
+            }
+          }
+        })")};
+  DatasetFeatureStatisticsList merged;
+  TF_ASSERT_OK(MergeStatistics(daily, &merged));
+  ASSERT_EQ(merged.datasets_size(), 1);
+  const DatasetFeatureStatistics& dataset = merged.datasets(0);
+  EXPECT_EQ(dataset.name(), "All Examples");
+  EXPECT_EQ(dataset.num_examples(), 15);
+  ASSERT_EQ(dataset.features_size(), 2);
+
+  const FeatureNameStatistics& x = dataset.features(0);
+  const auto& common_stats = x.num_stats().common_stats();
+  EXPECT_EQ(common_stats.num_non_missing(), 13);
+  EXPECT_EQ(common_stats.num_missing(), 2);
+  EXPECT_EQ(common_stats.min_num_values(), 1);
+  EXPECT_EQ(common_stats.max_num_values(), 3);
+  EXPECT_EQ(common_stats.tot_num_values(), 22);
+  EXPECT_NEAR(common_stats.avg_num_values(), 22.0 / 13, 1e-6);
+  // 10 values with mean 1 and variance 1, and 10 with mean 4 and variance 4.
+  EXPECT_NEAR(x.num_stats().mean(), 2.5, 1e-9);
+  EXPECT_NEAR(x.num_stats().std_dev(), std::sqrt(2.5 + 2.25), 1e-9);
+  EXPECT_EQ(x.num_stats().num_zeros(), 4);
+  EXPECT_EQ(x.num_stats().min(), -1);
+  EXPECT_EQ(x.num_stats().max(), 10);
+  ASSERT_EQ(x.num_stats().histograms_size(), 1);
+  const Histogram& histogram = x.num_stats().histograms(0);
+  EXPECT_EQ(histogram.num_nan(), 2);
+  ASSERT_EQ(histogram.buckets_size(), 2);
+  EXPECT_EQ(histogram.buckets(0).low_value(), -1);
+  // Half of the values are below 17 / 8, assuming they are uniformly
+  // distributed in the buckets.
+  EXPECT_NEAR(histogram.buckets(0).high_value(), 2.125, 1e-6);
+  EXPECT_EQ(histogram.buckets(1).high_value(), 10);
+  EXPECT_NEAR(x.num_stats().median(), 2.125, 1e-6);
+
+  // The feature missing from the second day is missing in its examples.
+  const FeatureNameStatistics& s = dataset.features(1);
+  EXPECT_EQ(s.string_stats().common_stats().num_missing(), 5);
+  EXPECT_EQ(s.string_stats().unique(), 3);
+  EXPECT_THAT(s.string_stats().top_values(0),
+              EqualsProto(R"(value: "a" frequency: 6)"));
+}
+
+// Returns the statistics of a day with the values of a numeric feature "x"
+// and a string feature "s", with their sketches embedded.
+DatasetFeatureStatisticsList GetDailyStatistics(
+    const std::vector<double>& numeric_values,
+    const std::vector<string>& string_values) {
+  DatasetFeatureStatisticsList result;
+  DatasetFeatureStatistics* dataset = result.add_datasets();
+  dataset->set_num_examples(numeric_values.size());
+
+  MergeableFeatureSketches x_sketches;
+  double sum = 0;
+  for (const double value : numeric_values) {
+    x_sketches.AddNumValues(1);
+    x_sketches.AddNumericValue(value);
+    sum += value;
+  }
+  FeatureNameStatistics* x = dataset->add_features();
+  x->mutable_path()->add_step("x");
+  x->set_type(FeatureNameStatistics::FLOAT);
+  auto* x_common_stats = x->mutable_num_stats()->mutable_common_stats();
+  x_common_stats->set_num_non_missing(numeric_values.size());
+  x_common_stats->set_tot_num_values(numeric_values.size());
+  x_common_stats->set_min_num_values(1);
+  x_common_stats->set_max_num_values(1);
+  x_common_stats->mutable_num_values_histogram()->set_type(
+      Histogram::QUANTILES);
+  x_common_stats->mutable_num_values_histogram()->add_buckets();
+  x->mutable_num_stats()->set_mean(sum / numeric_values.size());
+  for (const Histogram::HistogramType type :
+       {Histogram::STANDARD, Histogram::QUANTILES}) {
+    Histogram* histogram = x->mutable_num_stats()->add_histograms();
+    histogram->set_type(type);
+    for (int i = 0; i < 4; ++i) {
+      histogram->add_buckets();
+    }
+  }
+  FeatureSketches x_sketches_proto;
+  x_sketches.ToProto(&x_sketches_proto);
+  SetFeatureSketches(x_sketches_proto, x);
+
+  MergeableFeatureSketches s_sketches;
+  for (const string& value : string_values) {
+    s_sketches.AddStringValue(value);
+  }
+  FeatureNameStatistics* s = dataset->add_features();
+  s->mutable_path()->add_step("s");
+  s->set_type(FeatureNameStatistics::STRING);
+  auto* string_stats = s->mutable_string_stats();
+  string_stats->mutable_common_stats()->set_num_non_missing(
+      string_values.size());
+  string_stats->mutable_common_stats()->set_tot_num_values(
+      string_values.size());
+  for (const auto& top_value : s_sketches.top_values().GetTopValues(2)) {
+    auto* freq_and_value = string_stats->add_top_values();
+    freq_and_value->set_value(top_value.first);
+    freq_and_value->set_frequency(top_value.second);
+  }
+  string_stats->set_unique(s_sketches.distinct_values().Estimate());
+  FeatureSketches s_sketches_proto;
+  s_sketches.ToProto(&s_sketches_proto);
+  SetFeatureSketches(s_sketches_proto, s);
+  return result;
+}
+
+TEST(MergeStatisticsTest, UsesSketches) {
+  std::vector<DatasetFeatureStatisticsList> daily;
+  for (int day = 0; day < 4; ++day) {
+    std::vector<double> numeric_values;
+    std::vector<string> string_values;
+    for (int i = 0; i < 1000; ++i) {
+      numeric_values.push_back(day * 1000 + i);
+      // 100 values a day, half of them shared with the previous day.
+      string_values.push_back(absl::StrCat("value_", day * 50 + i % 100));
+    }
+    string_values.push_back("b\xff");
+    daily.push_back(GetDailyStatistics(numeric_values, string_values));
+  }
+  DatasetFeatureStatisticsList merged;
+  TF_ASSERT_OK(MergeStatistics(daily, &merged));
+  ASSERT_EQ(merged.datasets_size(), 1);
+  const DatasetFeatureStatistics& dataset = merged.datasets(0);
+  EXPECT_EQ(dataset.num_examples(), 4000);
+
+  const FeatureNameStatistics& x = dataset.features(0);
+  EXPECT_NEAR(x.num_stats().median(), 2000, 40);
+  ASSERT_EQ(x.num_stats().histograms_size(), 2);
+  for (const Histogram& histogram : x.num_stats().histograms()) {
+    ASSERT_EQ(histogram.buckets_size(), 4) << histogram.DebugString();
+    EXPECT_EQ(histogram.buckets(0).low_value(), 0);
+    EXPECT_EQ(histogram.buckets(3).high_value(), 3999);
+    for (const Histogram::Bucket& bucket : histogram.buckets()) {
+      EXPECT_NEAR(bucket.sample_count(), 1000, 40) << histogram.DebugString();
+    }
+  }
+  EXPECT_EQ(x.num_stats().common_stats().num_values_histogram().buckets_size(),
+            1);
+
+  const FeatureNameStatistics& s = dataset.features(1);
+  EXPECT_NEAR(s.string_stats().unique(), 251, 5);
+  ASSERT_EQ(s.string_stats().top_values_size(), 2);
+  // The values shared by two days are the most frequent.
+  EXPECT_NEAR(s.string_stats().top_values(0).frequency(), 20, 1);
+
+  // The merged sketches are embedded, so that windows can be merged further.
+  absl::optional<FeatureSketches> sketches;
+  TF_ASSERT_OK(GetFeatureSketches(s, &sketches));
+  ASSERT_TRUE(sketches);
+  EXPECT_TRUE(sketches->has_top_values());
+  TF_ASSERT_OK(GetFeatureSketches(x, &sketches));
+  ASSERT_TRUE(sketches);
+  EXPECT_EQ(sketches->values().count(), 4000);
+}
+
+TEST(MergeStatisticsTest, MergedStatisticsAreValid) {
+  const DatasetFeatureStatisticsList day =
+      GetDailyStatistics({1, 2, 3, 4}, {"a", "b", "c"});
+  DatasetFeatureStatisticsList merged;
+  TF_ASSERT_OK(MergeStatistics({day, day}, &merged));
+  string schema_string;
+  TF_ASSERT_OK(InferSchema(day.datasets(0).SerializeAsString(),
+                           /*max_string_domain_size=*/100, &schema_string));
+  metadata::v0::Schema schema;
+  ASSERT_TRUE(schema.ParseFromString(schema_string));
+  metadata::v0::Anomalies anomalies;
+  TF_ASSERT_OK(ValidateFeatureStatistics(
+      merged.datasets(0), schema, /*environment=*/absl::nullopt,
+      /*prev_span_feature_statistics=*/absl::nullopt,
+      /*serving_feature_statistics=*/absl::nullopt,
+      /*prev_version_feature_statistics=*/absl::nullopt,
+      /*features_needed=*/absl::nullopt, ValidationConfig(),
+      /*enable_diff_regions=*/false, &anomalies));
+  EXPECT_EQ(anomalies.anomaly_info_size(), 0) << anomalies.DebugString();
+}
+
+TEST(MergeStatisticsTest, SerializedInputs) {
+  const DatasetFeatureStatisticsList day = GetDailyStatistics({1, 2}, {"a"});
+  string merged;
+  TF_ASSERT_OK(MergeStatistics(
+      std::vector<string>{day.SerializeAsString(), day.SerializeAsString()},
+      &merged));
+  DatasetFeatureStatisticsList parsed;
+  ASSERT_TRUE(parsed.ParseFromString(merged));
+  EXPECT_EQ(parsed.datasets(0).num_examples(), 4);
+  EXPECT_FALSE(MergeStatistics(std::vector<string>{"invalid"}, &merged).ok());
+}
+
+}  // namespace
+}  // namespace data_validation
+}  // namespace tensorflow
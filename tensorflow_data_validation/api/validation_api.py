@@ -20,7 +20,7 @@ from __future__ import division
 from __future__ import print_function
 
 import logging
-from typing import Callable, List, Optional, Text
+from typing import Callable, Dict, Iterable, List, Optional, Text
 import apache_beam as beam
 import pyarrow as pa
 import tensorflow as tf
@@ -33,7 +33,7 @@ from tensorflow_data_validation.pywrap.tensorflow_data_validation_extension impo
 from tensorflow_data_validation.statistics import stats_impl
 from tensorflow_data_validation.statistics import stats_options
 from tensorflow_data_validation.utils import anomalies_util
-from tensorflow_data_validation.utils import slicing_util
+from tfx_bsl.coders import batch_util
 
 from tensorflow_metadata.proto.v0 import anomalies_pb2
 from tensorflow_metadata.proto.v0 import schema_pb2
@@ -128,6 +128,29 @@ def infer_schema(
   return result
 
 
+def schema_fingerprint(schema: schema_pb2.Schema) -> int:
+  """Returns a stable fingerprint of the schema.
+
+  This is the fingerprint referenced by the `baseline` of the Anomalies
+  computed with `ValidationOptions.baseline_fingerprint_only` (see
+  `anomalies_util.get_baseline_schema_fingerprint`).
+
+  Args:
+    schema: A Schema protocol buffer.
+
+  Returns:
+    The fingerprint of the schema, as an unsigned 64-bit integer.
+
+  Raises:
+    TypeError: If the input argument is not of the expected type.
+  """
+  if not isinstance(schema, schema_pb2.Schema):
+    raise TypeError('schema is of type %s, should be a Schema proto.' %
+                    type(schema).__name__)
+  return pywrap_tensorflow_data_validation.SchemaFingerprint(
+      tf.compat.as_bytes(schema.SerializeToString()))
+
+
 # Note that this flag is legacy code.
 def _may_be_set_legacy_flag(schema: schema_pb2.Schema):
   """Sets legacy flag to False if it exists."""
@@ -386,6 +409,31 @@ def validate_statistics_internal(
     ValueError: If the input statistics proto contains multiple datasets, none
         of which corresponds to the default slice.
   """
+  anomalies_proto_string = _validate_statistics_to_serialized(
+      statistics, schema, environment, previous_span_statistics,
+      serving_statistics, previous_version_statistics, validation_options,
+      enable_diff_regions)
+
+  # Parse the serialized Anomalies proto.
+  result = anomalies_pb2.Anomalies()
+  result.ParseFromString(anomalies_proto_string)
+  return result
+
+
+def _validate_statistics_to_serialized(
+    statistics: statistics_pb2.DatasetFeatureStatisticsList,
+    schema: schema_pb2.Schema,
+    environment: Optional[Text] = None,
+    previous_span_statistics: Optional[
+        statistics_pb2.DatasetFeatureStatisticsList] = None,
+    serving_statistics: Optional[
+        statistics_pb2.DatasetFeatureStatisticsList] = None,
+    previous_version_statistics: Optional[
+        statistics_pb2.DatasetFeatureStatisticsList] = None,
+    validation_options: Optional[vo.ValidationOptions] = None,
+    enable_diff_regions: bool = False
+) -> bytes:
+  """Same as validate_statistics_internal, but returns serialized Anomalies."""
   if not isinstance(statistics, statistics_pb2.DatasetFeatureStatisticsList):
     raise TypeError(
         'statistics is of type %s, should be '
@@ -458,6 +506,196 @@ def validate_statistics_internal(
       previous_version_dataset_statistics.SerializeToString()
       if previous_version_statistics is not None else '')
 
+  serialized_features_needed = _serialize_features_needed(validation_options)
+  serialized_validation_config = _serialize_validation_config(
+      validation_options)
+
+  anomalies_proto_string = (
+      pywrap_tensorflow_data_validation.ValidateFeatureStatistics(
+          tf.compat.as_bytes(serialized_stats),
+          tf.compat.as_bytes(serialized_schema),
+          tf.compat.as_bytes(environment),
+          tf.compat.as_bytes(serialized_previous_span_stats),
+          tf.compat.as_bytes(serialized_serving_stats),
+          tf.compat.as_bytes(serialized_previous_version_stats),
+          tf.compat.as_bytes(serialized_features_needed),
+          tf.compat.as_bytes(serialized_validation_config),
+          enable_diff_regions))
+  return anomalies_proto_string
+
+
+def validate_statistics_slices(
+    statistics: statistics_pb2.DatasetFeatureStatisticsList,
+    schema: schema_pb2.Schema,
+    environment: Optional[Text] = None,
+    previous_span_statistics: Optional[
+        statistics_pb2.DatasetFeatureStatisticsList] = None,
+    serving_statistics: Optional[
+        statistics_pb2.DatasetFeatureStatisticsList] = None,
+    previous_version_statistics: Optional[
+        statistics_pb2.DatasetFeatureStatisticsList] = None,
+    validation_options: Optional[vo.ValidationOptions] = None,
+    enable_diff_regions: bool = False
+) -> Dict[Text, anomalies_pb2.Anomalies]:
+  """Validates the statistics of every slice against the input schema.
+
+  Unlike `validate_statistics_internal`, which only validates the default
+  slice, this method validates each DatasetFeatureStatistics in `statistics`
+  against the `schema`. The control statistics of a slice are the datasets with
+  the same name in `previous_span_statistics`, `serving_statistics` and
+  `previous_version_statistics`, if any. The slices are validated in parallel.
+
+  Args:
+    statistics: A DatasetFeatureStatisticsList protocol buffer denoting the
+       statistics computed over the current data, with one dataset per slice.
+       The dataset names must be unique.
+    schema: A Schema protocol buffer.
+    environment: An optional string denoting the validation environment.
+        Must be one of the default environments specified in the schema.
+    previous_span_statistics: An optional DatasetFeatureStatisticsList protocol
+        buffer denoting the statistics computed over an earlier data, used for
+        drift detection.
+    serving_statistics: An optional DatasetFeatureStatisticsList protocol
+        buffer denoting the statistics computed over the serving data, used for
+        skew detection.
+    previous_version_statistics: An optional DatasetFeatureStatisticsList
+        protocol buffer denoting the statistics computed over an earlier
+        version of the data, used for dataset-level anomaly detection.
+    validation_options: Optional input used to specify the options of this
+        validation.
+    enable_diff_regions: Specifies whether to include a comparison between the
+        existing schema and the fixed schema in the Anomalies protocol buffers
+        output.
+
+  Returns:
+    A dict from slice (i.e. dataset) name to its Anomalies protocol buffer.
+
+  Raises:
+    TypeError: If any of the input arguments is not of the expected type.
+    ValueError: If the environment is not in the schema.
+    RuntimeError: If the dataset names of a statistics list are not unique.
+  """
+  if not isinstance(schema, schema_pb2.Schema):
+    raise TypeError('schema is of type %s, should be a Schema proto.' %
+                    type(schema).__name__)
+
+  if environment is not None:
+    if environment not in schema.default_environment:
+      raise ValueError('Environment %s not found in the schema.' % environment)
+  else:
+    environment = ''
+
+  serialized_statistics_lists = []
+  for stats_list, stats_type in (
+      (statistics, 'statistics'),
+      (previous_span_statistics, 'previous_span_statistics'),
+      (serving_statistics, 'serving_statistics'),
+      (previous_version_statistics, 'previous_version_statistics')):
+    if stats_list is None:
+      serialized_statistics_lists.append(b'')
+      continue
+    if not isinstance(stats_list, statistics_pb2.DatasetFeatureStatisticsList):
+      raise TypeError(
+          '%s is of type %s, should be a DatasetFeatureStatisticsList proto.' %
+          (stats_type, type(stats_list).__name__))
+    for dataset in stats_list.datasets:
+      _check_for_unsupported_stats_fields(dataset, stats_type)
+    serialized_statistics_lists.append(stats_list.SerializeToString())
+
+  anomalies_proto_strings = (
+      pywrap_tensorflow_data_validation.ValidateFeatureStatisticsList(
+          serialized_statistics_lists[0],
+          tf.compat.as_bytes(schema.SerializeToString()),
+          tf.compat.as_bytes(environment),
+          serialized_statistics_lists[1],
+          serialized_statistics_lists[2],
+          serialized_statistics_lists[3],
+          _serialize_features_needed(validation_options),
+          _serialize_validation_config(validation_options),
+          enable_diff_regions))
+
+  result = {}
+  for slice_key, anomalies_proto_string in anomalies_proto_strings.items():
+    result[slice_key] = anomalies_pb2.Anomalies()
+    result[slice_key].ParseFromString(anomalies_proto_string)
+  return result
+
+
+def validate_columnar_statistics(
+    statistics_path: Text,
+    schema: schema_pb2.Schema,
+    environment: Optional[Text] = None,
+    previous_span_statistics_path: Optional[Text] = None,
+    serving_statistics_path: Optional[Text] = None,
+    previous_version_statistics_path: Optional[Text] = None,
+    validation_options: Optional[vo.ValidationOptions] = None,
+    enable_diff_regions: bool = False
+) -> anomalies_pb2.Anomalies:
+  """Validates the statistics in columnar files against the input schema.
+
+  Same as `validate_statistics_internal`, for statistics written by
+  `tfdv.write_stats_columnar`. The files are memory-mapped, and only the
+  statistics of the features that the validation reads are decoded, so this is
+  faster than loading the statistics first when there are many features. Each
+  file must hold a single dataset or the default slice, which is validated.
+
+  Args:
+    statistics_path: Path of the columnar statistics computed over the current
+        data.
+    schema: A Schema protocol buffer.
+    environment: An optional string denoting the validation environment.
+        Must be one of the default environments specified in the schema.
+    previous_span_statistics_path: An optional path of the columnar statistics
+        computed over an earlier data, used for drift detection.
+    serving_statistics_path: An optional path of the columnar statistics
+        computed over the serving data, used for skew detection.
+    previous_version_statistics_path: An optional path of the columnar
+        statistics computed over an earlier version of the data, used for
+        dataset-level anomaly detection.
+    validation_options: Optional input used to specify the options of this
+        validation.
+    enable_diff_regions: Specifies whether to include a comparison between the
+        existing schema and the fixed schema in the Anomalies protocol buffer
+        output.
+
+  Returns:
+    An Anomalies protocol buffer.
+
+  Raises:
+    TypeError: If the schema is not a Schema proto.
+    ValueError: If the environment is not in the schema.
+    RuntimeError: If a file cannot be read, or is not a valid columnar
+        statistics file.
+  """
+  if not isinstance(schema, schema_pb2.Schema):
+    raise TypeError('schema is of type %s, should be a Schema proto.' %
+                    type(schema).__name__)
+
+  if environment is not None:
+    if environment not in schema.default_environment:
+      raise ValueError('Environment %s not found in the schema.' % environment)
+  else:
+    environment = ''
+
+  anomalies_proto_string = (
+      pywrap_tensorflow_data_validation.ValidateColumnarFeatureStatistics(
+          tf.compat.as_bytes(statistics_path),
+          tf.compat.as_bytes(schema.SerializeToString()),
+          tf.compat.as_bytes(environment),
+          tf.compat.as_bytes(previous_span_statistics_path or ''),
+          tf.compat.as_bytes(serving_statistics_path or ''),
+          tf.compat.as_bytes(previous_version_statistics_path or ''),
+          _serialize_features_needed(validation_options),
+          _serialize_validation_config(validation_options),
+          enable_diff_regions))
+  result = anomalies_pb2.Anomalies()
+  result.ParseFromString(anomalies_proto_string)
+  return result
+
+
+def _serialize_features_needed(
+    validation_options: Optional[vo.ValidationOptions]) -> bytes:
+  """Returns the serialized FeaturesNeededProto of the validation options."""
   features_needed_pb = validation_metadata_pb2.FeaturesNeededProto()
   if validation_options is not None and validation_options.features_needed:
     for path, reason_list in validation_options.features_needed.items():
@@ -467,33 +705,21 @@ def validate_statistics_internal(
       for reason in reason_list:
         r = path_and_reason_feature_need.reason_feature_needed.add()
         r.comment = reason.comment
+  return features_needed_pb.SerializeToString()
 
-  serialized_features_needed = features_needed_pb.SerializeToString()
 
+def _serialize_validation_config(
+    validation_options: Optional[vo.ValidationOptions]) -> bytes:
+  """Returns the serialized ValidationConfig of the validation options."""
   validation_config = validation_config_pb2.ValidationConfig()
   if validation_options is not None:
     validation_config.new_features_are_warnings = (
         validation_options.new_features_are_warnings)
     for override in validation_options.severity_overrides:
       validation_config.severity_overrides.append(override)
-  serialized_validation_config = validation_config.SerializeToString()
-
-  anomalies_proto_string = (
-      pywrap_tensorflow_data_validation.ValidateFeatureStatistics(
-          tf.compat.as_bytes(serialized_stats),
-          tf.compat.as_bytes(serialized_schema),
-          tf.compat.as_bytes(environment),
-          tf.compat.as_bytes(serialized_previous_span_stats),
-          tf.compat.as_bytes(serialized_serving_stats),
-          tf.compat.as_bytes(serialized_previous_version_stats),
-          tf.compat.as_bytes(serialized_features_needed),
-          tf.compat.as_bytes(serialized_validation_config),
-          enable_diff_regions))
-
-  # Parse the serialized Anomalies proto.
-  result = anomalies_pb2.Anomalies()
-  result.ParseFromString(anomalies_proto_string)
-  return result
+    validation_config.baseline_fingerprint_only = (
+        validation_options.baseline_fingerprint_only)
+  return validation_config.SerializeToString()
 
 
 def _remove_features_missing_common_stats(
@@ -563,23 +789,61 @@ def validate_instance(
     raise ValueError('options must be a StatsOptions object.')
   if options.schema is None:
     raise ValueError('options must include a schema.')
+  # Remove the anomaly types that do not apply on a per-example basis before
+  # parsing the Anomalies proto, which is then only parsed once.
+  serialized_anomalies = anomalies_util.remove_anomaly_types_from_serialized(
+      [_validate_instance_to_serialized(instance, options, environment)],
+      _GLOBAL_ONLY_ANOMALY_TYPES)[0]
+  anomalies = anomalies_pb2.Anomalies()
+  anomalies.ParseFromString(serialized_anomalies)
+  return anomalies
+
+
+def _validate_instance_to_serialized(
+    instance: pa.RecordBatch,
+    options: stats_options.StatsOptions,
+    environment: Optional[str] = None) -> bytes:
+  """Same as validate_instance, but returns the serialized Anomalies.
+
+  The anomaly types which do not apply on a per-example basis are not removed.
+  """
   feature_statistics_list = (
       stats_impl.generate_statistics_in_memory(instance, options))
-  anomalies = validate_statistics(feature_statistics_list, options.schema,
-                                  environment)
-  if anomalies.anomaly_info:
-    # If anomalies were found, remove anomaly types that do not apply on a
-    # per-example basis from the Anomalies proto.
-    anomalies_util.remove_anomaly_types(anomalies, _GLOBAL_ONLY_ANOMALY_TYPES)
-  return anomalies
+  return _validate_statistics_to_serialized(feature_statistics_list,
+                                            options.schema, environment)
+
+
+def _detect_anomalies_in_examples(
+    record_batches: List[pa.RecordBatch],
+    options: stats_options.StatsOptions
+) -> Iterable[types.SlicedRecordBatch]:
+  """Yields a slice key for each anomaly reason of each example.
 
+  The examples are validated one by one against the schema provided in
+  `options`, but their Anomalies protos are post-processed natively at once,
+  without being parsed.
 
-def _detect_anomalies_in_example(record_batch: pa.RecordBatch,
-                                 options: stats_options.StatsOptions):
-  """Validates the example against the schema provided in `options`."""
-  # Verify that we have a single row.
-  assert record_batch.num_rows == 1
-  return (record_batch, validate_instance(record_batch, options))
+  Args:
+    record_batches: A list of examples, as RecordBatches of a single row.
+    options: `tfdv.StatsOptions` for generating data statistics. This must
+      contain a schema.
+
+  Yields:
+    The (anomaly reason slice key, example) tuples.
+  """
+  serialized_anomalies = []
+  for record_batch in record_batches:
+    # Verify that we have a single row.
+    assert record_batch.num_rows == 1
+    serialized_anomalies.append(
+        _validate_instance_to_serialized(record_batch, options))
+  serialized_anomalies = anomalies_util.remove_anomaly_types_from_serialized(
+      serialized_anomalies, _GLOBAL_ONLY_ANOMALY_TYPES)
+  for record_batch, slice_keys in zip(
+      record_batches,
+      anomalies_util.get_anomaly_reason_slice_keys(serialized_anomalies)):
+    for slice_key in slice_keys:
+      yield slice_key, record_batch
 
 
 def _get_default_dataset_statistics(
@@ -617,20 +881,6 @@ def _get_default_dataset_statistics(
                    'slice (i.e., "All Examples" slice) is currently supported.')
 
 
-@beam.typehints.with_input_types(
-    beam.typehints.Tuple[pa.RecordBatch, anomalies_pb2.Anomalies])
-@beam.typehints.with_output_types(types.BeamSlicedRecordBatch)
-class _GenerateAnomalyReasonSliceKeys(beam.DoFn):
-  """Yields a slice key for each anomaly reason in the Anomalies proto."""
-
-  def process(self, element):
-    record_batch, anomalies_proto = element
-    for slice_key in slicing_util.generate_slices(
-        record_batch, [anomalies_util.anomalies_slicer],
-        anomalies=anomalies_proto):
-      yield slice_key, record_batch
-
-
 @beam.typehints.with_input_types(pa.RecordBatch)
 @beam.typehints.with_output_types(types.BeamSlicedRecordBatch)
 class IdentifyAnomalousExamples(beam.PTransform):
@@ -670,7 +920,107 @@ class IdentifyAnomalousExamples(beam.PTransform):
   def expand(self, dataset: beam.pvalue.PCollection) -> beam.pvalue.PCollection:
     return (
         dataset
-        | 'DetectAnomaliesInExamples' >> beam.Map(
-            _detect_anomalies_in_example, options=self.options)
-        | 'GenerateAnomalyReasonKeys' >> beam.ParDo(
-            _GenerateAnomalyReasonSliceKeys()))
+        | 'BatchExamples' >> beam.BatchElements(
+            **batch_util.GetBatchElementsKwargs(
+                self.options.desired_batch_size))
+        | 'DetectAnomaliesInExamples' >> beam.FlatMap(
+            _detect_anomalies_in_examples, options=self.options))
+
+
+def _serialize_record_batch(record_batch: pa.RecordBatch) -> bytes:
+  """Serializes a RecordBatch in the Arrow IPC stream format."""
+  sink = pa.BufferOutputStream()
+  writer = pa.RecordBatchStreamWriter(sink, record_batch.schema)
+  writer.write_batch(record_batch)
+  writer.close()
+  return sink.getvalue().to_pybytes()
+
+
+def _deserialize_record_batch(serialized: bytes) -> pa.RecordBatch:
+  """Deserializes a RecordBatch serialized by _serialize_record_batch."""
+  return pa.ipc.open_stream(serialized).read_next_batch()
+
+
+def parse_anomalous_examples(
+    serialized: bytes) -> Dict[Text, List[pa.RecordBatch]]:
+  """Parses the output of SampleAnomalousExamples.
+
+  Args:
+    serialized: The serialized samples output by SampleAnomalousExamples.
+
+  Returns:
+    A dict mapping each anomaly reason slice key to the sampled anomalous
+    examples, as RecordBatches of a single row.
+  """
+  reservoir = (
+      pywrap_tensorflow_data_validation.AnomalousExamplesReservoir.Deserialize(
+          serialized))
+  return {
+      slice_key: [_deserialize_record_batch(exemplar)
+                  for exemplar in reservoir.GetExemplars(slice_key)]
+      for slice_key in reservoir.GetSliceKeys()
+  }
+
+
+@beam.typehints.with_input_types(types.BeamSlicedRecordBatch)
+@beam.typehints.with_output_types(bytes)
+class _SampleAnomalousExamplesCombineFn(beam.CombineFn):
+  """Samples the anomalous examples of each anomaly reason natively."""
+
+  def __init__(self, num_examples_per_reason: int) -> None:
+    self._num_examples_per_reason = num_examples_per_reason
+
+  def create_accumulator(self):
+    return pywrap_tensorflow_data_validation.AnomalousExamplesReservoir(
+        self._num_examples_per_reason)
+
+  def add_input(self, accumulator, element):
+    slice_key, record_batch = element
+    if slice_key is None:
+      slice_key = constants.DEFAULT_SLICE_KEY
+    accumulator.Add(slice_key, _serialize_record_batch(record_batch))
+    return accumulator
+
+  def merge_accumulators(self, accumulators):
+    accumulators = iter(accumulators)
+    result = next(accumulators)
+    for accumulator in accumulators:
+      result.Merge(accumulator)
+    return result
+
+  def extract_output(self, accumulator) -> bytes:
+    return accumulator.Serialize()
+
+
+@beam.typehints.with_input_types(types.BeamSlicedRecordBatch)
+@beam.typehints.with_output_types(bytes)
+class SampleAnomalousExamples(beam.PTransform):
+  """API for sampling the anomalous examples of each anomaly reason.
+
+  Takes the output of IdentifyAnomalousExamples and outputs a single serialized
+  sample of at most `num_examples_per_reason` distinct anomalous examples for
+  each anomaly reason, which can be parsed with `parse_anomalous_examples`.
+  The sample is uniform over the distinct examples of each reason and does not
+  depend on how the examples are distributed between the workers, and only
+  `num_examples_per_reason` examples per reason are held in memory.
+  """
+
+  def __init__(self, num_examples_per_reason: int):
+    """Initializes the sampling of anomalous examples.
+
+    Args:
+      num_examples_per_reason: The maximum number of anomalous examples sampled
+        for each anomaly reason.
+
+    Raises:
+      ValueError: If num_examples_per_reason is not positive.
+    """
+    if num_examples_per_reason <= 0:
+      raise ValueError('num_examples_per_reason must be positive.')
+    self._num_examples_per_reason = num_examples_per_reason
+
+  def expand(self, dataset: beam.pvalue.PCollection) -> beam.pvalue.PCollection:
+    return (dataset
+            | 'SampleAnomalousExamplesPerReason' >> beam.CombineGlobally(
+                _SampleAnomalousExamplesCombineFn(
+                    self._num_examples_per_reason)))
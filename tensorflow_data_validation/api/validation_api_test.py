@@ -19,6 +19,8 @@ from __future__ import absolute_import
 from __future__ import division
 from __future__ import print_function
 
+import os
+
 from absl.testing import absltest
 from absl.testing import parameterized
 import apache_beam as beam
@@ -30,7 +32,9 @@ from tensorflow_data_validation.api import validation_api
 from tensorflow_data_validation.api import validation_options
 from tensorflow_data_validation.statistics import stats_options
 from tensorflow_data_validation.types import FeaturePath
+from tensorflow_data_validation.utils import anomalies_util
 from tensorflow_data_validation.utils import schema_util
+from tensorflow_data_validation.utils import stats_util
 
 from google.protobuf import text_format
 
@@ -2182,6 +2186,187 @@ class ValidationApiTest(absltest.TestCase):
     self._assert_equal_anomalies(anomalies, expected_anomalies)
   # pylint: enable=line-too-long
 
+  def test_validate_stats_internal_with_baseline_fingerprint_only(self):
+    statistics = text_format.Parse(
+        """
+        datasets {
+          num_examples: 10
+          features {
+            path { step: 'annotated_enum' }
+            type: STRING
+            string_stats {
+              common_stats { num_non_missing: 10 max_num_values: 1 }
+              rank_histogram { buckets { label: "c" sample_count: 10 } }
+            }
+          }
+        }""", statistics_pb2.DatasetFeatureStatisticsList())
+    schema = text_format.Parse(
+        """
+        string_domain { name: "MyAloneEnum" value: "a" value: "b" }
+        feature {
+          name: "annotated_enum"
+          presence { min_count: 1 }
+          type: BYTES
+          domain: "MyAloneEnum"
+        }
+        """, schema_pb2.Schema())
+
+    expected_anomalies = validation_api.validate_statistics_internal(
+        statistics, schema)
+    anomalies = validation_api.validate_statistics_internal(
+        statistics, schema,
+        validation_options=validation_options.ValidationOptions(
+            baseline_fingerprint_only=True))
+    self.assertEqual(
+        anomalies_util.get_baseline_schema_fingerprint(anomalies),
+        validation_api.schema_fingerprint(schema))
+    self.assertIsNone(
+        anomalies_util.get_baseline_schema_fingerprint(expected_anomalies))
+    anomalies.ClearField('baseline')
+    expected_anomalies.ClearField('baseline')
+    self.assertEqual(anomalies, expected_anomalies)
+
+  def test_validate_statistics_slices(self):
+    statistics = text_format.Parse(
+        """
+        datasets {
+          name: 'All Examples'
+          num_examples: 10
+          features {
+            path { step: 'annotated_enum' }
+            type: STRING
+            string_stats {
+              common_stats { num_non_missing: 10 max_num_values: 1 }
+              rank_histogram { buckets { label: "a" sample_count: 10 } }
+            }
+          }
+        }
+        datasets {
+          name: 'slice'
+          num_examples: 4
+          features {
+            path { step: 'annotated_enum' }
+            type: STRING
+            string_stats {
+              common_stats { num_non_missing: 4 max_num_values: 1 }
+              rank_histogram { buckets { label: "d" sample_count: 4 } }
+            }
+          }
+        }""", statistics_pb2.DatasetFeatureStatisticsList())
+    serving_statistics = text_format.Parse(
+        """
+        datasets {
+          name: 'All Examples'
+          num_examples: 10
+          features {
+            path { step: 'annotated_enum' }
+            type: STRING
+            string_stats {
+              common_stats { num_non_missing: 10 max_num_values: 1 }
+              rank_histogram { buckets { label: "b" sample_count: 10 } }
+            }
+          }
+        }""", statistics_pb2.DatasetFeatureStatisticsList())
+    schema = text_format.Parse(
+        """
+        string_domain { name: "MyAloneEnum" value: "a" value: "b" }
+        feature {
+          name: "annotated_enum"
+          presence { min_count: 1 }
+          type: BYTES
+          domain: "MyAloneEnum"
+          skew_comparator { infinity_norm { threshold: 0.1 } }
+        }
+        """, schema_pb2.Schema())
+
+    anomalies = validation_api.validate_statistics_slices(
+        statistics, schema, serving_statistics=serving_statistics)
+    self.assertCountEqual(anomalies.keys(), ['All Examples', 'slice'])
+    for dataset in statistics.datasets:
+      slice_statistics = statistics_pb2.DatasetFeatureStatisticsList()
+      slice_statistics.datasets.add().CopyFrom(dataset)
+      slice_serving_statistics = None
+      if dataset.name == 'All Examples':
+        slice_serving_statistics = serving_statistics
+      expected_anomalies = validation_api.validate_statistics_internal(
+          slice_statistics, schema,
+          serving_statistics=slice_serving_statistics)
+      self.assertEqual(anomalies[dataset.name], expected_anomalies)
+      self.assertIn('annotated_enum', anomalies[dataset.name].anomaly_info)
+
+  def test_validate_statistics_slices_duplicate_slice_names(self):
+    statistics = text_format.Parse(
+        """
+        datasets { name: 'slice' num_examples: 1 }
+        datasets { name: 'slice' num_examples: 2 }
+        """, statistics_pb2.DatasetFeatureStatisticsList())
+    with self.assertRaisesRegexp(RuntimeError, 'Duplicate dataset name'):
+      _ = validation_api.validate_statistics_slices(statistics,
+                                                    schema_pb2.Schema())
+
+  def test_validate_columnar_statistics(self):
+    statistics = text_format.Parse(
+        """
+        datasets { name: 'slice' num_examples: 4 }
+        datasets {
+          name: 'All Examples'
+          num_examples: 10
+          features {
+            path { step: 'annotated_enum' }
+            type: STRING
+            string_stats {
+              common_stats { num_non_missing: 10 max_num_values: 1 }
+              rank_histogram {
+                buckets { label: "a" sample_count: 9 }
+                buckets { label: "d" sample_count: 1 }
+              }
+            }
+          }
+        }""", statistics_pb2.DatasetFeatureStatisticsList())
+    serving_statistics = text_format.Parse(
+        """
+        datasets {
+          name: 'All Examples'
+          num_examples: 10
+          features {
+            path { step: 'annotated_enum' }
+            type: STRING
+            string_stats {
+              common_stats { num_non_missing: 10 max_num_values: 1 }
+              rank_histogram { buckets { label: "b" sample_count: 10 } }
+            }
+          }
+        }""", statistics_pb2.DatasetFeatureStatisticsList())
+    schema = text_format.Parse(
+        """
+        string_domain { name: "MyAloneEnum" value: "a" value: "b" }
+        feature {
+          name: "annotated_enum"
+          presence { min_count: 1 }
+          type: BYTES
+          domain: "MyAloneEnum"
+          skew_comparator { infinity_norm { threshold: 0.1 } }
+        }
+        """, schema_pb2.Schema())
+    temp_dir = self.create_tempdir().full_path
+    statistics_path = os.path.join(temp_dir, 'statistics')
+    stats_util.write_stats_columnar(statistics, statistics_path)
+    serving_statistics_path = os.path.join(temp_dir, 'serving_statistics')
+    stats_util.write_stats_columnar(serving_statistics,
+                                    serving_statistics_path)
+
+    anomalies = validation_api.validate_columnar_statistics(
+        statistics_path, schema,
+        serving_statistics_path=serving_statistics_path)
+    expected_anomalies = validation_api.validate_statistics_internal(
+        statistics, schema, serving_statistics=serving_statistics)
+    self.assertEqual(anomalies, expected_anomalies)
+    self.assertIn('annotated_enum', anomalies.anomaly_info)
+
+    with self.assertRaises(RuntimeError):
+      _ = validation_api.validate_columnar_statistics(
+          os.path.join(temp_dir, 'missing'), schema)
+
   def test_validate_instance(self):
     instance = pa.RecordBatch.from_arrays([pa.array([['D']])],
                                           ['annotated_enum'])
@@ -2434,5 +2619,54 @@ class IdentifyAnomalousExamplesTest(parameterized.TestCase):
             | validation_api.IdentifyAnomalousExamples(options))
 
 
+class SampleAnomalousExamplesTest(absltest.TestCase):
+
+  def test_sample_anomalous_examples(self):
+    examples = [
+        ('reason_a', pa.RecordBatch.from_arrays(
+            [pa.array([[i]], type=pa.list_(pa.int64()))], ['feature']))
+        for i in range(10)
+    ] + [
+        ('reason_b', pa.RecordBatch.from_arrays(
+            [pa.array([[b'x']], type=pa.list_(pa.binary()))], ['feature'])),
+        # Identical examples are only sampled once.
+        ('reason_b', pa.RecordBatch.from_arrays(
+            [pa.array([[b'x']], type=pa.list_(pa.binary()))], ['feature'])),
+    ]
+
+    def _assert_fn(got):
+      self.assertLen(got, 1)
+      samples = validation_api.parse_anomalous_examples(got[0])
+      self.assertCountEqual(samples.keys(), ['reason_a', 'reason_b'])
+      self.assertLen(samples['reason_a'], 3)
+      sampled_values = set()
+      for record_batch in samples['reason_a']:
+        self.assertEqual(record_batch.num_rows, 1)
+        sampled_values.add(record_batch.column(0).to_pylist()[0][0])
+      self.assertLen(sampled_values, 3)
+      self.assertTrue(sampled_values.issubset(range(10)))
+      self.assertLen(samples['reason_b'], 1)
+      self.assertTrue(samples['reason_b'][0].equals(examples[-1][1]))
+
+    with beam.Pipeline() as p:
+      result = (
+          p | beam.Create(examples, reshuffle=False)
+          | validation_api.SampleAnomalousExamples(3))
+      util.assert_that(result, _assert_fn)
+
+  def test_sample_anomalous_examples_no_examples(self):
+    with beam.Pipeline() as p:
+      result = (
+          p | beam.Create([], reshuffle=False)
+          | validation_api.SampleAnomalousExamples(3)
+          | beam.Map(validation_api.parse_anomalous_examples))
+      util.assert_that(result, util.equal_to([{}]))
+
+  def test_sample_anomalous_examples_invalid_number_of_examples(self):
+    with self.assertRaisesRegexp(ValueError,
+                                 'num_examples_per_reason must be positive'):
+      validation_api.SampleAnomalousExamples(0)
+
+
 if __name__ == '__main__':
   absltest.main()
@@ -43,10 +43,12 @@ class ValidationOptions(object):
                                         List[ReasonFeatureNeeded]]] = None,
       new_features_are_warnings: Optional[bool] = False,
       severity_overrides: Optional[List[
-          validation_config_pb2.SeverityOverride]] = None):
+          validation_config_pb2.SeverityOverride]] = None,
+      baseline_fingerprint_only: bool = False):
     self._features_needed = features_needed
     self._new_features_are_warnings = new_features_are_warnings
     self._severity_overrides = severity_overrides or []
+    self._baseline_fingerprint_only = baseline_fingerprint_only
 
   @property
   def features_needed(
@@ -60,3 +62,7 @@ class ValidationOptions(object):
   @property
   def severity_overrides(self) -> List[validation_config_pb2.SeverityOverride]:
     return self._severity_overrides
+
+  @property
+  def baseline_fingerprint_only(self) -> bool:
+    return self._baseline_fingerprint_only
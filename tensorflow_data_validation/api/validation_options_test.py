@@ -34,15 +34,19 @@ class ValidationOptionsTest(absltest.TestCase):
     }
     new_features_are_warnings = True
     severity_overrides = []
+    baseline_fingerprint_only = True
     options = validation_options.ValidationOptions(features_needed,
                                                    new_features_are_warnings,
-                                                   severity_overrides)
+                                                   severity_overrides,
+                                                   baseline_fingerprint_only)
 
     # Test getters
     self.assertEqual(features_needed, options.features_needed)
     self.assertEqual(new_features_are_warnings,
                      options.new_features_are_warnings)
     self.assertEqual(severity_overrides, options.severity_overrides)
+    self.assertEqual(baseline_fingerprint_only,
+                     options.baseline_fingerprint_only)
 
 
 if __name__ == '__main__':
@@ -0,0 +1,393 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/coders/csv_chunk_decoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#include "absl/strings/ascii.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_split.h"
+#include "tensorflow/core/lib/core/errors.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+namespace {
+
+constexpr uint64 kOnes = 0x0101010101010101ULL;
+constexpr uint64 kHighBits = 0x8080808080808080ULL;
+
+// Returns a non-zero value iff one of the bytes of <word> is zero.
+inline uint64 HasZeroByte(uint64 word) {
+  return (word - kOnes) & ~word & kHighBits;
+}
+
+// Returns a pointer to the first delimiter or line break in [p, end), or end
+// if there is none. Unquoted fields are scanned eight bytes at a time, and only
+// the word containing a match is scanned byte by byte.
+const char* FindFieldEnd(const char* p, const char* end, char delimiter) {
+  const uint64 delimiter_mask = kOnes * static_cast<uint8>(delimiter);
+  constexpr uint64 kNewlineMask = kOnes * static_cast<uint8>('\n');
+  constexpr uint64 kReturnMask = kOnes * static_cast<uint8>('\r');
+  while (end - p >= static_cast<ptrdiff_t>(sizeof(uint64))) {
+    uint64 word;
+    std::memcpy(&word, p, sizeof(word));
+    if (HasZeroByte(word ^ delimiter_mask) | HasZeroByte(word ^ kNewlineMask) |
+        HasZeroByte(word ^ kReturnMask)) {
+      break;
+    }
+    p += sizeof(word);
+  }
+  while (p < end && *p != delimiter && *p != '\n' && *p != '\r') {
+    ++p;
+  }
+  return p;
+}
+
+// Returns true iff <value> is an (optionally signed) integer literal.
+bool IsIntegerLiteral(absl::string_view value) {
+  value = absl::StripAsciiWhitespace(value);
+  if (!value.empty() && (value[0] == '-' || value[0] == '+')) {
+    value.remove_prefix(1);
+  }
+  return !value.empty() &&
+         std::all_of(value.begin(), value.end(),
+                     [](char c) { return absl::ascii_isdigit(c); });
+}
+
+CsvColumnType InferValueType(absl::string_view value) {
+  int64 int_value;
+  if (absl::SimpleAtoi(value, &int_value)) {
+    return CsvColumnType::kInt;
+  }
+  // Integers out of the int64 range are categorical.
+  if (IsIntegerLiteral(value)) {
+    return CsvColumnType::kString;
+  }
+  double float_value;
+  if (absl::SimpleAtod(value, &float_value)) {
+    return CsvColumnType::kFloat;
+  }
+  return CsvColumnType::kString;
+}
+
+void AppendBit(bool bit, int64 index, std::vector<uint8>* bitmap) {
+  if (index % 8 == 0) {
+    bitmap->push_back(0);
+  }
+  if (bit) {
+    bitmap->back() |= static_cast<uint8>(1 << (index % 8));
+  }
+}
+
+Status AppendValue(absl::string_view value, int column, CsvColumn* result) {
+  switch (result->type) {
+    case CsvColumnType::kInt: {
+      int64 int_value;
+      if (!absl::SimpleAtoi(value, &int_value)) {
+        return errors::InvalidArgument("Failed to parse \"", value,
+                                       "\" as an INT value of column ", column,
+                                       ".");
+      }
+      result->int_values.push_back(int_value);
+      return Status::OK();
+    }
+    case CsvColumnType::kFloat: {
+      double float_value;
+      if (!absl::SimpleAtod(value, &float_value)) {
+        return errors::InvalidArgument("Failed to parse \"", value,
+                                       "\" as a FLOAT value of column ", column,
+                                       ".");
+      }
+      result->float_values.push_back(static_cast<float>(float_value));
+      return Status::OK();
+    }
+    case CsvColumnType::kString:
+      if (result->string_data.size() + value.size() >
+          std::numeric_limits<int32>::max()) {
+        return errors::InvalidArgument(
+            "Too much string data in column ", column,
+            " of a single CSV chunk; use smaller chunks.");
+      }
+      result->string_data.append(value.data(), value.size());
+      result->string_offsets.push_back(result->string_data.size());
+      return Status::OK();
+    case CsvColumnType::kUnknown:
+      break;
+  }
+  return errors::InvalidArgument("Found value \"", value, "\" in column ",
+                                 column, " whose type is unknown.");
+}
+
+int32 NumValues(const CsvColumn& column) {
+  switch (column.type) {
+    case CsvColumnType::kInt:
+      return column.int_values.size();
+    case CsvColumnType::kFloat:
+      return column.float_values.size();
+    case CsvColumnType::kString:
+      return column.string_offsets.size() - 1;
+    case CsvColumnType::kUnknown:
+      break;
+  }
+  return 0;
+}
+
+}  // namespace
+
+Status CsvChunkDecoder::Create(int num_columns, CsvDecoderOptions options,
+                               std::unique_ptr<CsvChunkDecoder>* decoder) {
+  if (num_columns < 0) {
+    return errors::InvalidArgument("Invalid number of columns: ", num_columns,
+                                   ".");
+  }
+  if (!options.multivalent.empty() &&
+      options.multivalent.size() != static_cast<size_t>(num_columns)) {
+    return errors::InvalidArgument(
+        "Expected ", num_columns, " multivalent flags, got ",
+        options.multivalent.size(), ".");
+  }
+  decoder->reset(new CsvChunkDecoder(num_columns, std::move(options)));
+  return Status::OK();
+}
+
+CsvChunkDecoder::CsvChunkDecoder(int num_columns, CsvDecoderOptions options)
+    : num_columns_(num_columns), options_(std::move(options)) {}
+
+bool CsvChunkDecoder::ParseRecord(absl::string_view chunk, bool at_eof,
+                                  size_t* pos, Record* record) const {
+  record->fields.clear();
+  record->unescaped.clear();
+  record->blank = false;
+  const char* const begin = chunk.data();
+  const char* const end = begin + chunk.size();
+  const char* p = begin + *pos;
+  // Returns true iff the line break at p is complete, and moves p past it.
+  const auto consume_line_break = [&]() {
+    if (*p == '\r') {
+      if (p + 1 == end && !at_eof) {
+        // This might be the first half of "\r\n".
+        return false;
+      }
+      if (p + 1 < end && p[1] == '\n') {
+        ++p;
+      }
+    }
+    ++p;
+    *pos = p - begin;
+    return true;
+  };
+
+  if (*p == '\n' || *p == '\r') {
+    record->blank = true;
+    return consume_line_break();
+  }
+  while (true) {
+    absl::string_view field;
+    if (p < end && *p == '"') {
+      const char* const start = p + 1;
+      const char* q = start;
+      string* value = nullptr;
+      while (true) {
+        const char* quote =
+            static_cast<const char*>(std::memchr(q, '"', end - q));
+        if (quote == nullptr || (quote + 1 == end && !at_eof)) {
+          return false;
+        }
+        if (quote + 1 < end && quote[1] == '"') {
+          // An escaped quote.
+          if (value == nullptr) {
+            record->unescaped.emplace_back();
+            value = &record->unescaped.back();
+          }
+          value->append(q, quote + 1 - q);
+          q = quote + 2;
+          continue;
+        }
+        // The closing quote. Characters up to the end of the field are
+        // appended as they are.
+        p = FindFieldEnd(quote + 1, end, options_.delimiter);
+        if (value == nullptr && p != quote + 1) {
+          record->unescaped.emplace_back(start, quote - start);
+          value = &record->unescaped.back();
+        } else if (value != nullptr) {
+          value->append(q, quote - q);
+        }
+        if (value != nullptr) {
+          value->append(quote + 1, p - (quote + 1));
+          field = *value;
+        } else {
+          field = absl::string_view(start, quote - start);
+        }
+        break;
+      }
+    } else {
+      const char* const start = p;
+      p = FindFieldEnd(p, end, options_.delimiter);
+      field = absl::string_view(start, p - start);
+    }
+    record->fields.push_back(field);
+    if (p == end) {
+      if (!at_eof) {
+        return false;
+      }
+      *pos = chunk.size();
+      return true;
+    }
+    if (*p == options_.delimiter) {
+      ++p;
+      continue;
+    }
+    return consume_line_break();
+  }
+}
+
+size_t CsvChunkDecoder::FindRecordsEnd(absl::string_view buffer,
+                                       bool at_eof) const {
+  Record record;
+  size_t pos = 0;
+  while (pos < buffer.size()) {
+    size_t next_pos = pos;
+    if (!ParseRecord(buffer, at_eof, &next_pos, &record)) {
+      break;
+    }
+    pos = next_pos;
+  }
+  return pos;
+}
+
+template <typename Fn>
+Status CsvChunkDecoder::ForEachRecord(absl::string_view chunk, Fn fn) const {
+  Record record;
+  size_t pos = 0;
+  while (pos < chunk.size()) {
+    const size_t record_start = pos;
+    if (!ParseRecord(chunk, /*at_eof=*/true, &pos, &record)) {
+      return errors::InvalidArgument(
+          "Incomplete CSV record (unclosed quote) at offset ", record_start,
+          " of the chunk.");
+    }
+    if (record.blank) {
+      if (options_.skip_blank_lines) {
+        continue;
+      }
+    } else if (record.fields.size() != num_columns_) {
+      return errors::InvalidArgument(
+          "Columns do not match specified csv headers: expected ",
+          num_columns_, " columns, found ", record.fields.size(),
+          " in record: ", chunk.substr(record_start, pos - record_start));
+    }
+    TF_RETURN_IF_ERROR(fn(record));
+  }
+  return Status::OK();
+}
+
+Status CsvChunkDecoder::InferTypes(absl::string_view chunk,
+                                   std::vector<CsvColumnType>* types) const {
+  if (types->size() != num_columns_) {
+    return errors::InvalidArgument("Expected ", num_columns_,
+                                   " column types, got ", types->size(), ".");
+  }
+  return ForEachRecord(chunk, [&](const Record& record) {
+    if (record.blank) {
+      return Status::OK();
+    }
+    for (int column = 0; column < num_columns_; ++column) {
+      CsvColumnType& type = (*types)[column];
+      const absl::string_view field = record.fields[column];
+      if (type == CsvColumnType::kString || field.empty()) {
+        continue;
+      }
+      if (is_multivalent(column)) {
+        for (absl::string_view value :
+             absl::StrSplit(field, options_.secondary_delimiter)) {
+          if (!value.empty()) {
+            type = std::max(type, InferValueType(value));
+          }
+        }
+      } else {
+        type = std::max(type, InferValueType(field));
+      }
+    }
+    return Status::OK();
+  });
+}
+
+Status CsvChunkDecoder::Decode(absl::string_view chunk,
+                               const std::vector<CsvColumnType>& types,
+                               std::vector<CsvColumn>* columns,
+                               int64* num_rows) const {
+  if (types.size() != num_columns_) {
+    return errors::InvalidArgument("Expected ", num_columns_,
+                                   " column types, got ", types.size(), ".");
+  }
+  columns->clear();
+  columns->resize(num_columns_);
+  for (int column = 0; column < num_columns_; ++column) {
+    CsvColumn& result = (*columns)[column];
+    result.type = types[column];
+    result.offsets.push_back(0);
+    if (result.type == CsvColumnType::kString) {
+      result.string_offsets.push_back(0);
+    }
+  }
+  *num_rows = 0;
+  TF_RETURN_IF_ERROR(ForEachRecord(chunk, [&](const Record& record) {
+    for (int column = 0; column < num_columns_; ++column) {
+      CsvColumn& result = (*columns)[column];
+      const absl::string_view field =
+          record.blank ? absl::string_view() : record.fields[column];
+      // Multivalent columns with only empty values have an unknown type and
+      // are decoded as missing.
+      const bool valid =
+          !field.empty() &&
+          !(result.type == CsvColumnType::kUnknown && is_multivalent(column) &&
+            field.find_first_not_of(options_.secondary_delimiter) ==
+                absl::string_view::npos);
+      if (valid) {
+        if (is_multivalent(column)) {
+          for (absl::string_view value :
+               absl::StrSplit(field, options_.secondary_delimiter)) {
+            // Empty values are ignored by the type inference, and are only
+            // decoded as empty strings.
+            if (value.empty() && result.type != CsvColumnType::kString) {
+              continue;
+            }
+            TF_RETURN_IF_ERROR(AppendValue(value, column, &result));
+          }
+        } else {
+          TF_RETURN_IF_ERROR(AppendValue(field, column, &result));
+        }
+      } else {
+        ++result.null_count;
+      }
+      AppendBit(valid, *num_rows, &result.validity);
+      result.offsets.push_back(NumValues(result));
+    }
+    ++*num_rows;
+    return Status::OK();
+  }));
+  for (CsvColumn& result : *columns) {
+    AppendBit(true, *num_rows, &result.validity);
+  }
+  return Status::OK();
+}
+
+}  // namespace data_validation
+}  // namespace tensorflow
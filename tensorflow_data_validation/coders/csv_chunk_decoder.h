@@ -0,0 +1,148 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Decodes chunks of CSV files (i.e. many records at a time) into a columnar
+// representation that follows the Arrow memory layout of list<T> arrays, so
+// that the Python side can wrap the buffers into RecordBatches without
+// touching individual values.
+#ifndef TENSORFLOW_DATA_VALIDATION_CODERS_CSV_CHUNK_DECODER_H_
+#define TENSORFLOW_DATA_VALIDATION_CODERS_CSV_CHUNK_DECODER_H_
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+// The type of the values of a CSV column. The order matters: the inferred type
+// of a column is the maximum of the types of its values.
+// LINT.IfChange
+enum class CsvColumnType {
+  // No value was seen for the column. Decoded as an Arrow null array.
+  kUnknown = 0,
+  // Decoded as list<int64>.
+  kInt = 1,
+  // Decoded as list<float32>.
+  kFloat = 2,
+  // Decoded as list<binary>.
+  kString = 3,
+};
+// LINT.ThenChange(csv_decoder.py)
+
+struct CsvDecoderOptions {
+  // The character separating fields.
+  char delimiter = ',';
+  // If true, blank lines are skipped. Otherwise they are decoded as rows in
+  // which all the columns are missing.
+  bool skip_blank_lines = true;
+  // For each column, whether its fields contain multiple values separated by
+  // secondary_delimiter. Either empty or of size num_columns.
+  std::vector<bool> multivalent;
+  // The character separating the values of multivalent columns.
+  char secondary_delimiter = '|';
+};
+
+// A decoded column, in the Arrow memory layout of a list<T> array.
+struct CsvColumn {
+  CsvColumnType type = CsvColumnType::kUnknown;
+  // Number of rows for which the column is missing.
+  int64 null_count = 0;
+  // Validity bitmap (least significant bit first) of num_rows + 1 bits, where
+  // the last bit is always set. This is the validity of the list offsets.
+  std::vector<uint8> validity;
+  // The values of row i are the values in [offsets[i], offsets[i + 1]).
+  std::vector<int32> offsets;
+  // Values of kInt columns.
+  std::vector<int64> int_values;
+  // Values of kFloat columns.
+  std::vector<float> float_values;
+  // Values of kString columns: value j is
+  // string_data[string_offsets[j], string_offsets[j + 1]).
+  std::vector<int32> string_offsets;
+  string string_data;
+};
+
+// Decodes CSV chunks with a fixed number of columns. A chunk is a sequence of
+// complete CSV records (as found by FindRecordsEnd). Fields may be quoted with
+// '"', in which case they may contain the delimiter, line breaks and escaped
+// ('""') quotes. Records may be terminated by "\n", "\r\n" or "\r".
+//
+// Types are either given (e.g., from the schema) or inferred with InferTypes
+// over all the chunks of a dataset before decoding. A value is inferred as
+// kInt if it is an integer in the int64 range, kFloat if it is a number,
+// and kString otherwise (including integers out of the int64 range). Empty
+// fields are missing and do not contribute to the inferred type.
+class CsvChunkDecoder {
+ public:
+  // Creates a decoder of chunks with <num_columns> columns. Fails if
+  // options.multivalent is neither empty nor of size <num_columns>.
+  static Status Create(int num_columns, CsvDecoderOptions options,
+                       std::unique_ptr<CsvChunkDecoder>* decoder);
+
+  // Returns the offset past the last complete record in <buffer>, i.e. the
+  // size of the longest prefix of <buffer> that can be decoded as a chunk. If
+  // <at_eof> is true, <buffer> is the end of the file and its last record does
+  // not need to be terminated by a line break.
+  size_t FindRecordsEnd(absl::string_view buffer, bool at_eof) const;
+
+  // Updates <types> (of size num_columns, initially kUnknown) with the types
+  // of the values in <chunk>.
+  Status InferTypes(absl::string_view chunk,
+                    std::vector<CsvColumnType>* types) const;
+
+  // Decodes <chunk> into <columns> (one per column) given the column <types>.
+  Status Decode(absl::string_view chunk,
+                const std::vector<CsvColumnType>& types,
+                std::vector<CsvColumn>* columns, int64* num_rows) const;
+
+ private:
+  // The fields of a record. Fields that need unescaping point into unescaped.
+  struct Record {
+    std::vector<absl::string_view> fields;
+    std::deque<string> unescaped;
+    // True iff the record is an empty line.
+    bool blank = false;
+  };
+
+  // Parses the record starting at chunk[*pos] into <record> and advances *pos
+  // past its line break. Returns false if the record is not complete (i.e. if
+  // a quoted field is not closed, or if the record has no line break and
+  // <at_eof> is false).
+  bool ParseRecord(absl::string_view chunk, bool at_eof, size_t* pos,
+                   Record* record) const;
+
+  // Calls fn(record) for each record of <chunk> that is not skipped.
+  template <typename Fn>
+  Status ForEachRecord(absl::string_view chunk, Fn fn) const;
+
+  CsvChunkDecoder(int num_columns, CsvDecoderOptions options);
+
+  bool is_multivalent(int column) const {
+    return !options_.multivalent.empty() && options_.multivalent[column];
+  }
+
+  const int num_columns_;
+  const CsvDecoderOptions options_;
+};
+
+}  // namespace data_validation
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_DATA_VALIDATION_CODERS_CSV_CHUNK_DECODER_H_
@@ -0,0 +1,280 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/coders/csv_chunk_decoder.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace data_validation {
+namespace {
+
+using ::testing::ElementsAre;
+
+// Returns the values of each row of <column>, as strings; "null" for missing
+// rows.
+std::vector<string> RowsAsStrings(const CsvColumn& column, int64 num_rows) {
+  std::vector<string> result;
+  for (int64 row = 0; row < num_rows; ++row) {
+    if (!(column.validity[row / 8] & (1 << (row % 8)))) {
+      result.push_back("null");
+      continue;
+    }
+    string values;
+    for (int32 i = column.offsets[row]; i < column.offsets[row + 1]; ++i) {
+      if (i > column.offsets[row]) {
+        values += ";";
+      }
+      switch (column.type) {
+        case CsvColumnType::kInt:
+          values += std::to_string(column.int_values[i]);
+          break;
+        case CsvColumnType::kFloat:
+          values += std::to_string(column.float_values[i]);
+          break;
+        case CsvColumnType::kString:
+          values += column.string_data.substr(
+              column.string_offsets[i],
+              column.string_offsets[i + 1] - column.string_offsets[i]);
+          break;
+        case CsvColumnType::kUnknown:
+          break;
+      }
+    }
+    result.push_back("[" + values + "]");
+  }
+  return result;
+}
+
+std::vector<CsvColumnType> InferTypes(const CsvChunkDecoder& chunk_decoder,
+                                      int num_columns,
+                                      absl::string_view chunk) {
+  std::vector<CsvColumnType> types(num_columns, CsvColumnType::kUnknown);
+  TF_CHECK_OK(chunk_decoder.InferTypes(chunk, &types));
+  return types;
+}
+
+TEST(CsvChunkDecoderTest, InferTypesAndDecode) {
+  std::unique_ptr<CsvChunkDecoder> decoder;
+  TF_ASSERT_OK(CsvChunkDecoder::Create(3, CsvDecoderOptions(), &decoder));
+  const string chunk = "1,2.0,hello\n5,12.34,world\n,3,\n";
+  const std::vector<CsvColumnType> types = InferTypes(*decoder, 3, chunk);
+  EXPECT_THAT(types, ElementsAre(CsvColumnType::kInt, CsvColumnType::kFloat,
+                                 CsvColumnType::kString));
+  std::vector<CsvColumn> columns;
+  int64 num_rows;
+  TF_ASSERT_OK(decoder->Decode(chunk, types, &columns, &num_rows));
+  EXPECT_EQ(num_rows, 3);
+  EXPECT_THAT(RowsAsStrings(columns[0], num_rows),
+              ElementsAre("[1]", "[5]", "null"));
+  EXPECT_THAT(RowsAsStrings(columns[1], num_rows),
+              ElementsAre("[2.000000]", "[12.340000]", "[3.000000]"));
+  EXPECT_THAT(RowsAsStrings(columns[2], num_rows),
+              ElementsAre("[hello]", "[world]", "null"));
+  EXPECT_EQ(columns[0].null_count, 1);
+  EXPECT_EQ(columns[1].null_count, 0);
+  // The trailing validity bit is always set.
+  EXPECT_EQ(columns[0].validity, std::vector<uint8>({0x0b}));
+}
+
+TEST(CsvChunkDecoderTest, InferTypesMixedValues) {
+  std::unique_ptr<CsvChunkDecoder> decoder;
+  TF_ASSERT_OK(CsvChunkDecoder::Create(4, CsvDecoderOptions(), &decoder));
+  EXPECT_THAT(
+      InferTypes(*decoder, 4,
+                 "2,2,2.3,34\n1.5,abc,abc,9223372036854775808\n,,,\n"),
+      ElementsAre(CsvColumnType::kFloat, CsvColumnType::kString,
+                  CsvColumnType::kString, CsvColumnType::kString));
+  EXPECT_THAT(InferTypes(*decoder, 4, ",,,-9223372036854775808\n"),
+              ElementsAre(CsvColumnType::kUnknown, CsvColumnType::kUnknown,
+                          CsvColumnType::kUnknown, CsvColumnType::kInt));
+}
+
+TEST(CsvChunkDecoderTest, QuotedFields) {
+  CsvDecoderOptions options;
+  options.delimiter = '\t';
+  std::unique_ptr<CsvChunkDecoder> decoder;
+  TF_ASSERT_OK(CsvChunkDecoder::Create(2, options, &decoder));
+  const string chunk =
+      "1\t\"this is a \ttext\"\r\n"
+      "2\t\"multi\nline \"\"quoted\"\" text\"\r\n"
+      "3\t\"a\"b\r"
+      "4\t\r\n";
+  const std::vector<CsvColumnType> types = {CsvColumnType::kInt,
+                                            CsvColumnType::kString};
+  std::vector<CsvColumn> columns;
+  int64 num_rows;
+  TF_ASSERT_OK(decoder->Decode(chunk, types, &columns, &num_rows));
+  EXPECT_THAT(RowsAsStrings(columns[0], num_rows),
+              ElementsAre("[1]", "[2]", "[3]", "[4]"));
+  EXPECT_THAT(RowsAsStrings(columns[1], num_rows),
+              ElementsAre("[this is a \ttext]",
+                          "[multi\nline \"quoted\" text]", "[ab]", "null"));
+}
+
+TEST(CsvChunkDecoderTest, BlankLines) {
+  const string chunk = "\n1,2\n\n";
+  const std::vector<CsvColumnType> types = {CsvColumnType::kInt,
+                                            CsvColumnType::kInt};
+  std::vector<CsvColumn> columns;
+  int64 num_rows;
+
+  std::unique_ptr<CsvChunkDecoder> skipping_decoder;
+  TF_ASSERT_OK(
+      CsvChunkDecoder::Create(2, CsvDecoderOptions(), &skipping_decoder));
+  TF_ASSERT_OK(skipping_decoder->Decode(chunk, types, &columns, &num_rows));
+  EXPECT_THAT(RowsAsStrings(columns[0], num_rows), ElementsAre("[1]"));
+
+  CsvDecoderOptions options;
+  options.skip_blank_lines = false;
+  std::unique_ptr<CsvChunkDecoder> decoder;
+  TF_ASSERT_OK(CsvChunkDecoder::Create(2, options, &decoder));
+  TF_ASSERT_OK(decoder->Decode(chunk, types, &columns, &num_rows));
+  EXPECT_THAT(RowsAsStrings(columns[1], num_rows),
+              ElementsAre("null", "[2]", "null"));
+}
+
+TEST(CsvChunkDecoderTest, MultivalentColumns) {
+  CsvDecoderOptions options;
+  options.multivalent = {true, true, true, false};
+  options.secondary_delimiter = '|';
+  std::unique_ptr<CsvChunkDecoder> decoder;
+  TF_ASSERT_OK(CsvChunkDecoder::Create(4, options, &decoder));
+  const string chunk = "12|14,|,1|2.3,a|b\n,a|b,4,c\n";
+  const std::vector<CsvColumnType> types = InferTypes(*decoder, 4, chunk);
+  EXPECT_THAT(types, ElementsAre(CsvColumnType::kInt, CsvColumnType::kString,
+                                 CsvColumnType::kFloat,
+                                 CsvColumnType::kString));
+  std::vector<CsvColumn> columns;
+  int64 num_rows;
+  TF_ASSERT_OK(decoder->Decode(chunk, types, &columns, &num_rows));
+  EXPECT_THAT(RowsAsStrings(columns[0], num_rows),
+              ElementsAre("[12;14]", "null"));
+  EXPECT_THAT(RowsAsStrings(columns[1], num_rows),
+              ElementsAre("[;]", "[a;b]"));
+  EXPECT_THAT(RowsAsStrings(columns[2], num_rows),
+              ElementsAre("[1.000000;2.300000]", "[4.000000]"));
+  EXPECT_THAT(RowsAsStrings(columns[3], num_rows),
+              ElementsAre("[a|b]", "[c]"));
+
+  // A multivalent column with only empty values has an unknown type, and is
+  // missing in all rows.
+  const string empty_values_chunk = "|,x,1,y\n";
+  const std::vector<CsvColumnType> empty_values_types =
+      InferTypes(*decoder, 4, empty_values_chunk);
+  EXPECT_THAT(empty_values_types,
+              ElementsAre(CsvColumnType::kUnknown, CsvColumnType::kString,
+                          CsvColumnType::kInt, CsvColumnType::kString));
+  TF_ASSERT_OK(decoder->Decode(empty_values_chunk, empty_values_types, &columns,
+                              &num_rows));
+  EXPECT_THAT(RowsAsStrings(columns[0], num_rows), ElementsAre("null"));
+}
+
+TEST(CsvChunkDecoderTest, MultivalentColumnsWithEmptyValues) {
+  CsvDecoderOptions options;
+  options.multivalent = {true, true, true};
+  options.secondary_delimiter = '|';
+  std::unique_ptr<CsvChunkDecoder> decoder;
+  TF_ASSERT_OK(CsvChunkDecoder::Create(3, options, &decoder));
+  const string chunk = "1||2,1.5|,a||b\n3|,|2.5,a|\n";
+  const std::vector<CsvColumnType> types = InferTypes(*decoder, 3, chunk);
+  EXPECT_THAT(types, ElementsAre(CsvColumnType::kInt, CsvColumnType::kFloat,
+                                 CsvColumnType::kString));
+  std::vector<CsvColumn> columns;
+  int64 num_rows;
+  TF_ASSERT_OK(decoder->Decode(chunk, types, &columns, &num_rows));
+  // The empty values of numeric columns are skipped, as by the type inference.
+  EXPECT_THAT(RowsAsStrings(columns[0], num_rows),
+              ElementsAre("[1;2]", "[3]"));
+  EXPECT_THAT(RowsAsStrings(columns[1], num_rows),
+              ElementsAre("[1.500000]", "[2.500000]"));
+  // The empty values of string columns are empty strings.
+  EXPECT_THAT(RowsAsStrings(columns[2], num_rows),
+              ElementsAre("[a;;b]", "[a;]"));
+}
+
+TEST(CsvChunkDecoderTest, InvalidRecords) {
+  std::unique_ptr<CsvChunkDecoder> decoder;
+  TF_ASSERT_OK(CsvChunkDecoder::Create(3, CsvDecoderOptions(), &decoder));
+  std::vector<CsvColumnType> types(3, CsvColumnType::kUnknown);
+  const Status status = decoder->InferTypes("1,2.0,hello\n5,12.34\n", &types);
+  EXPECT_FALSE(status.ok());
+  EXPECT_NE(status.error_message().find(
+                "Columns do not match specified csv headers"),
+            string::npos);
+  EXPECT_FALSE(decoder->InferTypes("1,2,\"abc\n", &types).ok());
+
+  std::vector<CsvColumn> columns;
+  int64 num_rows;
+  EXPECT_FALSE(decoder
+                   ->Decode("a,1,1\n",
+                           {CsvColumnType::kInt, CsvColumnType::kInt,
+                            CsvColumnType::kInt},
+                           &columns, &num_rows)
+                   .ok());
+}
+
+TEST(CsvChunkDecoderTest, InvalidOptions) {
+  std::unique_ptr<CsvChunkDecoder> decoder;
+  EXPECT_FALSE(CsvChunkDecoder::Create(-1, CsvDecoderOptions(), &decoder).ok());
+  CsvDecoderOptions options;
+  options.multivalent = {true, false};
+  EXPECT_FALSE(CsvChunkDecoder::Create(3, options, &decoder).ok());
+  TF_EXPECT_OK(CsvChunkDecoder::Create(2, options, &decoder));
+}
+
+TEST(CsvChunkDecoderTest, FindRecordsEnd) {
+  std::unique_ptr<CsvChunkDecoder> decoder;
+  TF_ASSERT_OK(CsvChunkDecoder::Create(2, CsvDecoderOptions(), &decoder));
+  EXPECT_EQ(decoder->FindRecordsEnd("1,2\n3,4\n5,", /*at_eof=*/false), 8);
+  EXPECT_EQ(decoder->FindRecordsEnd("1,2\n3,4\n5,6", /*at_eof=*/true), 11);
+  // A line break in a quoted field does not end the record.
+  EXPECT_EQ(decoder->FindRecordsEnd("1,\"a\nb", /*at_eof=*/false), 0);
+  EXPECT_EQ(decoder->FindRecordsEnd("1,\"a\nb\"\n", /*at_eof=*/false), 8);
+  // "\r" may be followed by "\n" in the next buffer.
+  EXPECT_EQ(decoder->FindRecordsEnd("1,2\r", /*at_eof=*/false), 0);
+  EXPECT_EQ(decoder->FindRecordsEnd("1,2\r", /*at_eof=*/true), 4);
+  // The closing quote may be the first half of an escaped quote.
+  EXPECT_EQ(decoder->FindRecordsEnd("1,\"a\"", /*at_eof=*/false), 0);
+}
+
+TEST(CsvChunkDecoderTest, LongFields) {
+  // Exercises the word-at-a-time scanning of unquoted fields.
+  std::unique_ptr<CsvChunkDecoder> decoder;
+  TF_ASSERT_OK(CsvChunkDecoder::Create(2, CsvDecoderOptions(), &decoder));
+  const string long_value(100, 'x');
+  const string chunk = long_value + "," + long_value + "y\n" + long_value +
+                       "z," + long_value + "\n";
+  std::vector<CsvColumn> columns;
+  int64 num_rows;
+  TF_ASSERT_OK(decoder->Decode(
+      chunk, {CsvColumnType::kString, CsvColumnType::kString}, &columns,
+      &num_rows));
+  EXPECT_THAT(RowsAsStrings(columns[0], num_rows),
+              ElementsAre("[" + long_value + "]", "[" + long_value + "z]"));
+  EXPECT_THAT(RowsAsStrings(columns[1], num_rows),
+              ElementsAre("[" + long_value + "y]", "[" + long_value + "]"));
+}
+
+}  // namespace
+}  // namespace data_validation
+}  // namespace tensorflow
@@ -19,11 +19,13 @@ from __future__ import division
 from __future__ import print_function
 
 import apache_beam as beam
+from apache_beam.io.filesystem import CompressionTypes
 import pyarrow as pa
 from tensorflow_data_validation import constants
 from tensorflow_data_validation import types
+from tensorflow_data_validation.pywrap.tensorflow_data_validation_extension import coders as coders_pywrap
 from tfx_bsl.coders import csv_decoder
-from typing import List, Optional, Text, Union
+from typing import Any, Iterable, List, Optional, Text, Tuple, Union
 
 from tensorflow_metadata.proto.v0 import schema_pb2
 
@@ -88,3 +90,288 @@ class DecodeCSV(beam.PTransform):
         desired_batch_size=self._desired_batch_size,
         multivalent_columns=self._multivalent_columns,
         secondary_delimiter=self._secondary_delimiter))
+
+
+# Column types of the native CSV decoder.
+# LINT.IfChange
+_UNKNOWN = 0
+_INT = 1
+_FLOAT = 2
+_STRING = 3
+# LINT.ThenChange(csv_chunk_decoder.h)
+
+_SCHEMA_TYPE_TO_COLUMN_TYPE = {
+    schema_pb2.INT: _INT,
+    schema_pb2.FLOAT: _FLOAT,
+    schema_pb2.BYTES: _STRING,
+}
+
+_DEFAULT_CHUNK_SIZE_BYTES = 4 << 20
+
+
+def _make_chunk_decoder(
+    column_names: List[types.FeatureName], delimiter: Text,
+    skip_blank_lines: bool,
+    multivalent_columns: Optional[List[types.FeatureName]],
+    secondary_delimiter: Optional[Union[Text, bytes]]
+) -> coders_pywrap.CsvChunkDecoder:
+  """Creates a native CsvChunkDecoder."""
+  multivalent_columns = set(multivalent_columns or [])
+  if isinstance(secondary_delimiter, bytes):
+    secondary_delimiter = secondary_delimiter.decode('utf-8')
+  return coders_pywrap.CsvChunkDecoder(
+      len(column_names), delimiter, skip_blank_lines,
+      [name in multivalent_columns for name in column_names],
+      secondary_delimiter or '|')
+
+
+def _column_types_from_schema(schema: schema_pb2.Schema,
+                              column_names: List[types.FeatureName]
+                             ) -> List[int]:
+  """Returns the native decoder column types given by the schema."""
+  feature_types = {feature.name: feature.type for feature in schema.feature}
+  result = []
+  for name in column_names:
+    if name not in feature_types:
+      raise ValueError('Column %s is not in the schema.' % name)
+    if feature_types[name] not in _SCHEMA_TYPE_TO_COLUMN_TYPE:
+      raise ValueError('Column %s has unsupported type %s in the schema.' %
+                       (name, schema_pb2.FeatureType.Name(feature_types[name])))
+    result.append(_SCHEMA_TYPE_TO_COLUMN_TYPE[feature_types[name]])
+  return result
+
+
+def _column_to_arrow(column: Tuple[Any, ...], num_rows: int) -> pa.Array:
+  """Wraps the buffers of a natively decoded column into an Arrow array."""
+  column_type, null_count, validity, offsets, values, string_offsets = column
+  if column_type == _UNKNOWN:
+    return pa.array([None] * num_rows, type=pa.null())
+  if column_type == _STRING:
+    values_array = pa.Array.from_buffers(
+        pa.binary(), len(string_offsets) // 4 - 1,
+        [None, pa.py_buffer(string_offsets), pa.py_buffer(values)])
+  else:
+    value_type = pa.int64() if column_type == _INT else pa.float32()
+    values_array = pa.Array.from_buffers(
+        value_type, len(values) // (value_type.bit_width // 8),
+        [None, pa.py_buffer(values)])
+  # Null offsets mark null lists. The last offset is always valid.
+  offsets_array = pa.Array.from_buffers(
+      pa.int32(), num_rows + 1,
+      [pa.py_buffer(validity), pa.py_buffer(offsets)], null_count=null_count)
+  return pa.ListArray.from_arrays(offsets_array, values_array)
+
+
+class _ReadCSVChunksDoFn(beam.DoFn):
+  """Reads a CSV file as chunks of complete records."""
+
+  def __init__(self, column_names: List[types.FeatureName], delimiter: Text,
+               skip_header_lines: int, compression_type: Text,
+               chunk_size_bytes: int) -> None:
+    self._column_names = column_names
+    self._delimiter = delimiter
+    self._skip_header_lines = skip_header_lines
+    self._compression_type = compression_type
+    self._chunk_size_bytes = chunk_size_bytes
+    self._decoder = None
+
+  def setup(self):
+    self._decoder = _make_chunk_decoder(
+        self._column_names, self._delimiter, True, None, None)
+
+  def process(self, readable_file: beam.io.fileio.ReadableFile
+             ) -> Iterable[bytes]:
+    lines_to_skip = self._skip_header_lines
+    # The bytes read and not yet output are buffer[start:]. The buffer is only
+    # compacted before reading more data, so that records spanning many reads
+    # are not copied for each read.
+    buffer = bytearray()
+    start = 0
+    with readable_file.open(compression_type=self._compression_type) as f:
+      while True:
+        data = f.read(self._chunk_size_bytes)
+        at_eof = not data
+        del buffer[:start]
+        start = 0
+        buffer += data
+        while lines_to_skip and start < len(buffer):
+          line_end = buffer.find(b'\n', start)
+          if line_end < 0 and not at_eof:
+            break
+          start = line_end + 1 if line_end >= 0 else len(buffer)
+          lines_to_skip -= 1
+        if not lines_to_skip:
+          with memoryview(buffer) as view:
+            end = self._decoder.FindRecordsEnd(view[start:], at_eof)
+            chunk = bytes(view[start:start + end])
+          if end:
+            yield chunk
+            start += end
+        if at_eof:
+          if start < len(buffer):
+            raise ValueError('Incomplete CSV record at the end of %s.' %
+                             readable_file.metadata.path)
+          return
+
+
+class _InferCSVColumnTypesDoFn(beam.DoFn):
+  """Infers the column types of a chunk of CSV records."""
+
+  def __init__(self, column_names: List[types.FeatureName], delimiter: Text,
+               skip_blank_lines: bool,
+               multivalent_columns: Optional[List[types.FeatureName]],
+               secondary_delimiter: Optional[Union[Text, bytes]]) -> None:
+    self._decoder_args = (column_names, delimiter, skip_blank_lines,
+                          multivalent_columns, secondary_delimiter)
+    self._num_columns = len(column_names)
+    self._decoder = None
+
+  def setup(self):
+    self._decoder = _make_chunk_decoder(*self._decoder_args)
+
+  def process(self, chunk: bytes) -> Iterable[List[int]]:
+    yield self._decoder.InferTypes(chunk, [_UNKNOWN] * self._num_columns)
+
+
+class _DecodeCSVChunkDoFn(beam.DoFn):
+  """Decodes a chunk of CSV records into RecordBatches.
+
+  The RecordBatch of a chunk is sliced (without copying) into RecordBatches of
+  at most `desired_batch_size` rows, if set.
+  """
+
+  def __init__(self, column_names: List[types.FeatureName], delimiter: Text,
+               skip_blank_lines: bool,
+               multivalent_columns: Optional[List[types.FeatureName]],
+               secondary_delimiter: Optional[Union[Text, bytes]],
+               desired_batch_size: Optional[int]) -> None:
+    self._decoder_args = (column_names, delimiter, skip_blank_lines,
+                          multivalent_columns, secondary_delimiter)
+    self._column_names = column_names
+    self._desired_batch_size = desired_batch_size
+    self._decoder = None
+
+  def setup(self):
+    self._decoder = _make_chunk_decoder(*self._decoder_args)
+
+  def process(self, chunk: bytes,
+              column_types: List[int]) -> Iterable[pa.RecordBatch]:
+    num_rows, columns = self._decoder.Decode(chunk, column_types)
+    if not num_rows:
+      return
+    record_batch = pa.RecordBatch.from_arrays(
+        [_column_to_arrow(column, num_rows) for column in columns],
+        self._column_names)
+    if not self._desired_batch_size or num_rows <= self._desired_batch_size:
+      yield record_batch
+      return
+    for offset in range(0, num_rows, self._desired_batch_size):
+      yield record_batch.slice(offset, self._desired_batch_size)
+
+
+def _merge_column_types(column_types: Iterable[List[int]],
+                        num_columns: int) -> List[int]:
+  """Merges the column types inferred from different chunks."""
+  result = [_UNKNOWN] * num_columns
+  for chunk_types in column_types:
+    result = [max(a, b) for a, b in zip(result, chunk_types)]
+  return result
+
+
+@beam.typehints.with_input_types(Text)
+@beam.typehints.with_output_types(pa.RecordBatch)
+class DecodeCSVFiles(beam.PTransform):
+  """Reads and decodes CSV files into Arrow RecordBatches.
+
+  Unlike DecodeCSV, which decodes a PCollection of lines, this reads the files
+  matching the input file patterns and decodes them a chunk of records at a
+  time with a native decoder, so lines are never materialized as Python
+  strings. Each output RecordBatch holds records of a single chunk.
+  """
+
+  def __init__(self,
+               column_names: List[types.FeatureName],
+               delimiter: Text = ',',
+               skip_blank_lines: bool = True,
+               schema: Optional[schema_pb2.Schema] = None,
+               multivalent_columns: Optional[List[types.FeatureName]] = None,
+               secondary_delimiter: Optional[Union[Text, bytes]] = None,
+               skip_header_lines: int = 0,
+               compression_type: Text = CompressionTypes.AUTO,
+               chunk_size_bytes: int = _DEFAULT_CHUNK_SIZE_BYTES,
+               desired_batch_size: Optional[int] = constants
+               .DEFAULT_DESIRED_INPUT_BATCH_SIZE):
+    """Initializes the CSV files decoder.
+
+    Args:
+      column_names: List of feature names. Order must match the order in the CSV
+        files.
+      delimiter: A one-character string used to separate fields.
+      skip_blank_lines: A boolean to indicate whether to skip over blank lines
+        rather than interpreting them as missing values.
+      schema: An optional schema of the input data. If provided, types
+        will be taken from the schema, which must contain all the columns.
+        Otherwise types are inferred with one pass over the data.
+      multivalent_columns: Name of column that can contain multiple
+        values.
+      secondary_delimiter: Delimiter used for parsing multivalent columns.
+      skip_header_lines: Number of header lines to skip in each file.
+      compression_type: Used to handle compressed input files.
+      chunk_size_bytes: Number of bytes to read from the files at a time.
+      desired_batch_size: The maximum number of rows of the output
+        RecordBatches, into which the records of a chunk are split. If None,
+        each output RecordBatch holds the records of one chunk.
+    """
+    if not isinstance(column_names, list):
+      raise TypeError('column_names is of type %s, should be a list' %
+                      type(column_names).__name__)
+    self._column_names = column_names
+    self._delimiter = delimiter
+    self._skip_blank_lines = skip_blank_lines
+    self._column_types = (
+        _column_types_from_schema(schema, column_names)
+        if schema is not None else None)
+    self._multivalent_columns = multivalent_columns
+    self._secondary_delimiter = secondary_delimiter
+    self._skip_header_lines = skip_header_lines
+    self._compression_type = compression_type
+    self._chunk_size_bytes = chunk_size_bytes
+    self._desired_batch_size = desired_batch_size
+
+  def expand(self, file_patterns: beam.pvalue.PCollection):
+    """Reads and decodes the CSV files into RecordBatches.
+
+    Args:
+      file_patterns: A PCollection of file patterns of CSV files.
+
+    Returns:
+      A PCollection of RecordBatches representing the CSV records.
+    """
+    decoder_args = (self._column_names, self._delimiter,
+                    self._skip_blank_lines, self._multivalent_columns,
+                    self._secondary_delimiter)
+    chunks = (
+        file_patterns
+        | 'MatchFiles' >> beam.io.fileio.MatchAll()
+        | 'ReadMatches' >> beam.io.fileio.ReadMatches()
+        | 'ReadChunks' >> beam.ParDo(
+            _ReadCSVChunksDoFn(self._column_names, self._delimiter,
+                               self._skip_header_lines, self._compression_type,
+                               self._chunk_size_bytes))
+        | 'ReshuffleChunks' >> beam.Reshuffle())
+    if self._column_types is not None:
+      column_types = beam.pvalue.AsSingleton(
+          chunks.pipeline
+          | 'CreateColumnTypes' >> beam.Create([self._column_types]))
+    else:
+      column_types = beam.pvalue.AsSingleton(
+          chunks
+          | 'InferColumnTypes' >> beam.ParDo(
+              _InferCSVColumnTypesDoFn(*decoder_args))
+          | 'MergeColumnTypes' >> beam.CombineGlobally(
+              _merge_column_types, num_columns=len(self._column_names)))
+    return (chunks
+            | 'DecodeChunks' >> beam.ParDo(
+                _DecodeCSVChunkDoFn(
+                    *decoder_args, desired_batch_size=self._desired_batch_size),
+                column_types))
@@ -21,7 +21,10 @@ from __future__ import division
 
 from __future__ import print_function
 
+import os
 import sys
+import tempfile
+
 from absl.testing import absltest
 from absl.testing import parameterized
 import apache_beam as beam
@@ -395,6 +398,75 @@ class CSVDecoderTest(parameterized.TestCase):
         util.assert_that(
             result, test_util.make_arrow_record_batches_equal_fn(self, None))
 
+  @parameterized.named_parameters(_TEST_CASES)
+  def test_csv_files_decoder(self,
+                             input_lines,
+                             expected_result,
+                             column_names,
+                             delimiter=',',
+                             skip_blank_lines=True,
+                             schema=None,
+                             multivalent_columns=None,
+                             secondary_delimiter=None):
+    input_path = os.path.join(tempfile.mkdtemp(), 'input.csv')
+    with open(input_path, 'wb') as f:
+      f.write(b''.join(
+          (line.encode('utf-8') if isinstance(line, str) else line) + b'\n'
+          for line in input_lines))
+    with beam.Pipeline() as p:
+      result = (
+          p | beam.Create([input_path])
+          | csv_decoder.DecodeCSVFiles(
+              column_names=column_names,
+              delimiter=delimiter,
+              skip_blank_lines=skip_blank_lines,
+              schema=schema,
+              multivalent_columns=multivalent_columns,
+              secondary_delimiter=secondary_delimiter))
+      util.assert_that(
+          result,
+          test_util.make_arrow_record_batches_equal_fn(self, expected_result))
+
+  def test_csv_files_decoder_header_and_small_chunks(self):
+    input_path = os.path.join(tempfile.mkdtemp(), 'input.csv')
+    with open(input_path, 'wb') as f:
+      f.write(b'int_feature,str_feature\n1,"a\nb"\n2,c\n')
+
+    def _to_rows(record_batches):
+      return sorted(
+          row for record_batch in record_batches
+          for row in zip(record_batch.column(0).to_pylist(),
+                         record_batch.column(1).to_pylist()))
+
+    with beam.Pipeline() as p:
+      result = (
+          p | beam.Create([input_path])
+          | csv_decoder.DecodeCSVFiles(
+              column_names=['int_feature', 'str_feature'],
+              skip_header_lines=1,
+              chunk_size_bytes=4)
+          | beam.combiners.ToList()
+          | beam.Map(_to_rows))
+      # Chunks never split records, even with a line break in a quoted field.
+      util.assert_that(result,
+                       util.equal_to([[([1], [b'a\nb']), ([2], [b'c'])]]))
+
+  def test_csv_files_decoder_desired_batch_size(self):
+    input_path = os.path.join(tempfile.mkdtemp(), 'input.csv')
+    with open(input_path, 'wb') as f:
+      f.write(b''.join(b'%d\n' % i for i in range(5)))
+
+    with beam.Pipeline() as p:
+      result = (
+          p | beam.Create([input_path])
+          | csv_decoder.DecodeCSVFiles(
+              column_names=['int_feature'], desired_batch_size=2)
+          | beam.Map(lambda record_batch: (
+              record_batch.num_rows, record_batch.column(0).to_pylist())))
+      # The records of the single chunk are split into batches of 2 rows.
+      util.assert_that(
+          result,
+          util.equal_to([(2, [[0], [1]]), (2, [[2], [3]]), (1, [[4]])]))
 
 if __name__ == '__main__':
   absltest.main()
@@ -0,0 +1,503 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/coders/sequence_example_decoder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#include "tensorflow/core/lib/core/coding.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/platform/byte_order.h"
+#include "tensorflow/core/platform/protobuf.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+namespace {
+
+using ::tensorflow::metadata::v0::Feature;
+using ::tensorflow::metadata::v0::FeatureType;
+using ::tensorflow::metadata::v0::Schema;
+
+// Field numbers and wire types of the messages in
+// tensorflow/core/example/{example,feature}.proto.
+constexpr uint32 kSequenceExampleContext = 1;
+constexpr uint32 kSequenceExampleFeatureLists = 2;
+constexpr uint32 kMapEntryKey = 1;
+constexpr uint32 kMapEntryValue = 2;
+constexpr uint32 kFeatureBytesList = 1;
+constexpr uint32 kFeatureFloatList = 2;
+constexpr uint32 kFeatureInt64List = 3;
+// The field number of Features.feature, FeatureLists.feature_list,
+// FeatureList.feature and {Bytes,Float,Int64}List.value.
+constexpr uint32 kRepeatedField = 1;
+
+constexpr uint32 kWireTypeVarint = 0;
+constexpr uint32 kWireTypeFixed64 = 1;
+constexpr uint32 kWireTypeLengthDelimited = 2;
+constexpr uint32 kWireTypeFixed32 = 5;
+
+// Minimal reader of the protobuf wire format, returning views into the
+// underlying buffer for length-delimited fields.
+class WireReader {
+ public:
+  explicit WireReader(absl::string_view buffer)
+      : buffer_(buffer),
+        input_(reinterpret_cast<const uint8*>(buffer.data()),
+               buffer.size()) {}
+
+  // Reads the next tag. Returns false at the end of the buffer or on error,
+  // which can be told apart with ok().
+  bool Next(uint32* field_number, uint32* wire_type) {
+    const uint32 tag = input_.ReadTag();
+    if (tag == 0) {
+      return false;
+    }
+    *field_number = tag >> 3;
+    *wire_type = tag & 7;
+    return true;
+  }
+
+  // True iff the whole buffer was read successfully.
+  bool ok() const {
+    return !error_ && input_.CurrentPosition() == buffer_.size();
+  }
+
+  bool ReadLengthDelimited(absl::string_view* value) {
+    uint32 size;
+    if (!input_.ReadVarint32(&size)) {
+      return Fail();
+    }
+    const int position = input_.CurrentPosition();
+    if (!input_.Skip(size)) {
+      return Fail();
+    }
+    *value = buffer_.substr(position, size);
+    return true;
+  }
+
+  bool ReadVarint64(uint64* value) {
+    return input_.ReadVarint64(value) || Fail();
+  }
+
+  bool ReadFixed32(uint32* value) {
+    return input_.ReadLittleEndian32(value) || Fail();
+  }
+
+  bool SkipField(uint32 wire_type) {
+    switch (wire_type) {
+      case kWireTypeVarint: {
+        uint64 unused;
+        return ReadVarint64(&unused);
+      }
+      case kWireTypeFixed64:
+        return input_.Skip(8) || Fail();
+      case kWireTypeLengthDelimited: {
+        absl::string_view unused;
+        return ReadLengthDelimited(&unused);
+      }
+      case kWireTypeFixed32:
+        return input_.Skip(4) || Fail();
+      default:
+        // Groups are not used by tf.SequenceExample.
+        return Fail();
+    }
+  }
+
+ private:
+  bool Fail() {
+    error_ = true;
+    return false;
+  }
+
+  const absl::string_view buffer_;
+  protobuf::io::CodedInputStream input_;
+  bool error_ = false;
+};
+
+Status MalformedError() {
+  return errors::DataLoss("Failed to parse serialized SequenceExample.");
+}
+
+void AppendBit(bool bit, int64 index, std::vector<uint8>* bitmap) {
+  if (index % 8 == 0) {
+    bitmap->push_back(0);
+  }
+  if (bit) {
+    bitmap->back() |= static_cast<uint8>(1 << (index % 8));
+  }
+}
+
+int32 NumValues(const DecodedFeature& feature) {
+  switch (feature.type) {
+    case metadata::v0::INT:
+      return feature.int_values.size();
+    case metadata::v0::FLOAT:
+      return feature.float_values.size();
+    case metadata::v0::BYTES:
+      return feature.bytes_offsets.size() - 1;
+    default:
+      return 0;
+  }
+}
+
+// Collects the values of the map entries in <map> (a serialized Features or
+// FeatureLists message) whose keys are in <index> into <values>, by index.
+// Like for proto maps, the last entry with a given key wins.
+Status CollectMapValues(absl::string_view map,
+                        const absl::flat_hash_map<string, int>& index,
+                        std::vector<absl::string_view>* values,
+                        std::vector<bool>* present) {
+  WireReader reader(map);
+  uint32 field_number, wire_type;
+  while (reader.Next(&field_number, &wire_type)) {
+    if (field_number != kRepeatedField ||
+        wire_type != kWireTypeLengthDelimited) {
+      if (!reader.SkipField(wire_type)) {
+        return MalformedError();
+      }
+      continue;
+    }
+    absl::string_view entry;
+    if (!reader.ReadLengthDelimited(&entry)) {
+      return MalformedError();
+    }
+    absl::string_view key;
+    absl::string_view value;
+    WireReader entry_reader(entry);
+    while (entry_reader.Next(&field_number, &wire_type)) {
+      if (wire_type == kWireTypeLengthDelimited &&
+          field_number == kMapEntryKey) {
+        if (!entry_reader.ReadLengthDelimited(&key)) {
+          return MalformedError();
+        }
+      } else if (wire_type == kWireTypeLengthDelimited &&
+                 field_number == kMapEntryValue) {
+        if (!entry_reader.ReadLengthDelimited(&value)) {
+          return MalformedError();
+        }
+      } else if (!entry_reader.SkipField(wire_type)) {
+        return MalformedError();
+      }
+    }
+    if (!entry_reader.ok()) {
+      return MalformedError();
+    }
+    const auto it = index.find(key);
+    if (it != index.end()) {
+      (*values)[it->second] = value;
+      (*present)[it->second] = true;
+    }
+  }
+  if (!reader.ok()) {
+    return MalformedError();
+  }
+  return Status::OK();
+}
+
+// Appends the values of <list> (a serialized BytesList, FloatList or
+// Int64List, as given by <kind>) to <result>.
+Status AppendListValues(absl::string_view list, uint32 kind,
+                        DecodedFeature* result) {
+  WireReader reader(list);
+  uint32 field_number, wire_type;
+  while (reader.Next(&field_number, &wire_type)) {
+    if (field_number != kRepeatedField) {
+      if (!reader.SkipField(wire_type)) {
+        return MalformedError();
+      }
+      continue;
+    }
+    if (kind == kFeatureBytesList && wire_type == kWireTypeLengthDelimited) {
+      absl::string_view value;
+      if (!reader.ReadLengthDelimited(&value)) {
+        return MalformedError();
+      }
+      if (result->bytes_data.size() + value.size() >
+          std::numeric_limits<int32>::max()) {
+        return errors::InvalidArgument("Too much BYTES data for feature ",
+                                       result->path.Serialize(),
+                                       "; decode smaller batches.");
+      }
+      result->bytes_data.append(value.data(), value.size());
+      result->bytes_offsets.push_back(result->bytes_data.size());
+    } else if (kind == kFeatureFloatList && wire_type == kWireTypeFixed32) {
+      uint32 bits;
+      if (!reader.ReadFixed32(&bits)) {
+        return MalformedError();
+      }
+      float value;
+      static_assert(sizeof(value) == sizeof(bits), "float must be 32 bits");
+      std::memcpy(&value, &bits, sizeof(value));
+      result->float_values.push_back(value);
+    } else if (kind == kFeatureInt64List && wire_type == kWireTypeVarint) {
+      uint64 value;
+      if (!reader.ReadVarint64(&value)) {
+        return MalformedError();
+      }
+      result->int_values.push_back(static_cast<int64>(value));
+    } else if (kind != kFeatureBytesList &&
+               wire_type == kWireTypeLengthDelimited) {
+      // Packed float or int64 values.
+      absl::string_view packed;
+      if (!reader.ReadLengthDelimited(&packed)) {
+        return MalformedError();
+      }
+      if (kind == kFeatureFloatList) {
+        if (packed.size() % sizeof(float) != 0) {
+          return MalformedError();
+        }
+        const size_t size = result->float_values.size();
+        const size_t num_values = packed.size() / sizeof(float);
+        result->float_values.resize(size + num_values);
+        if (port::kLittleEndian) {
+          // The packed values are little-endian, as the host.
+          std::memcpy(&result->float_values[size], packed.data(),
+                      packed.size());
+        } else {
+          for (size_t i = 0; i < num_values; ++i) {
+            const uint32 bits =
+                core::DecodeFixed32(packed.data() + i * sizeof(float));
+            std::memcpy(&result->float_values[size + i], &bits,
+                        sizeof(float));
+          }
+        }
+      } else {
+        protobuf::io::CodedInputStream input(
+            reinterpret_cast<const uint8*>(packed.data()), packed.size());
+        while (input.CurrentPosition() < packed.size()) {
+          uint64 value;
+          if (!input.ReadVarint64(&value)) {
+            return MalformedError();
+          }
+          result->int_values.push_back(static_cast<int64>(value));
+        }
+      }
+    } else if (!reader.SkipField(wire_type)) {
+      return MalformedError();
+    }
+  }
+  if (!reader.ok()) {
+    return MalformedError();
+  }
+  return Status::OK();
+}
+
+// Appends the values of <feature> (a serialized tf.train.Feature) to
+// <result>. Sets *has_values to false iff none of its value lists is set.
+Status AppendFeatureValues(absl::string_view feature, DecodedFeature* result,
+                           bool* has_values) {
+  WireReader reader(feature);
+  uint32 field_number, wire_type;
+  uint32 kind = 0;
+  absl::string_view list;
+  // Like for proto oneofs, the last value list wins.
+  while (reader.Next(&field_number, &wire_type)) {
+    if (wire_type == kWireTypeLengthDelimited &&
+        (field_number == kFeatureBytesList ||
+         field_number == kFeatureFloatList ||
+         field_number == kFeatureInt64List)) {
+      kind = field_number;
+      if (!reader.ReadLengthDelimited(&list)) {
+        return MalformedError();
+      }
+    } else if (!reader.SkipField(wire_type)) {
+      return MalformedError();
+    }
+  }
+  if (!reader.ok()) {
+    return MalformedError();
+  }
+  *has_values = kind != 0;
+  if (kind == 0) {
+    return Status::OK();
+  }
+  const uint32 expected_kind =
+      result->type == metadata::v0::BYTES
+          ? kFeatureBytesList
+          : (result->type == metadata::v0::FLOAT ? kFeatureFloatList
+                                                 : kFeatureInt64List);
+  if (kind != expected_kind) {
+    return errors::InvalidArgument(
+        "Feature ", result->path.Serialize(), " has ",
+        kind == kFeatureBytesList
+            ? "bytes_list"
+            : (kind == kFeatureFloatList ? "float_list" : "int64_list"),
+        " values but is of type ", metadata::v0::FeatureType_Name(result->type),
+        " in the schema.");
+  }
+  return AppendListValues(list, kind, result);
+}
+
+// Appends the steps of <feature_list> (a serialized tf.train.FeatureList) to
+// <result>.
+Status AppendFeatureListSteps(absl::string_view feature_list,
+                              DecodedFeature* result) {
+  WireReader reader(feature_list);
+  uint32 field_number, wire_type;
+  while (reader.Next(&field_number, &wire_type)) {
+    if (field_number != kRepeatedField ||
+        wire_type != kWireTypeLengthDelimited) {
+      if (!reader.SkipField(wire_type)) {
+        return MalformedError();
+      }
+      continue;
+    }
+    absl::string_view feature;
+    if (!reader.ReadLengthDelimited(&feature)) {
+      return MalformedError();
+    }
+    bool has_values;
+    TF_RETURN_IF_ERROR(AppendFeatureValues(feature, result, &has_values));
+    AppendBit(has_values, result->step_offsets.size() - 1,
+              &result->step_validity);
+    result->step_offsets.push_back(NumValues(*result));
+  }
+  if (!reader.ok()) {
+    return MalformedError();
+  }
+  return Status::OK();
+}
+
+void AddFeatures(const google::protobuf::RepeatedPtrField<Feature>& features,
+                 const Path& parent,
+                 absl::flat_hash_map<string, int>* feature_index,
+                 std::vector<Path>* feature_paths,
+                 std::vector<FeatureType>* feature_types) {
+  for (const Feature& feature : features) {
+    // Other features (e.g. of type STRUCT or without a type) are not decoded,
+    // as by the Python decoder.
+    if (feature.type() != metadata::v0::INT &&
+        feature.type() != metadata::v0::FLOAT &&
+        feature.type() != metadata::v0::BYTES) {
+      continue;
+    }
+    feature_index->emplace(feature.name(), feature_paths->size());
+    feature_paths->push_back(parent.GetChild(feature.name()));
+    feature_types->push_back(feature.type());
+  }
+}
+
+}  // namespace
+
+Status SequenceExampleDecoder::Create(
+    const Schema& schema, const string& sequence_feature_column_name,
+    std::unique_ptr<SequenceExampleDecoder>* decoder) {
+  std::unique_ptr<SequenceExampleDecoder> result(new SequenceExampleDecoder());
+  google::protobuf::RepeatedPtrField<Feature> context_features;
+  const Feature* sequence_feature = nullptr;
+  for (const Feature& feature : schema.feature()) {
+    if (feature.name() == sequence_feature_column_name) {
+      if (feature.type() != metadata::v0::STRUCT) {
+        return errors::InvalidArgument(
+            "The sequence feature ", sequence_feature_column_name,
+            " must be of type STRUCT.");
+      }
+      sequence_feature = &feature;
+    } else {
+      *context_features.Add() = feature;
+    }
+  }
+  AddFeatures(context_features, Path(), &result->context_feature_index_,
+              &result->feature_paths_, &result->feature_types_);
+  if (sequence_feature != nullptr) {
+    AddFeatures(sequence_feature->struct_domain().feature(),
+                Path({sequence_feature_column_name}),
+                &result->sequence_feature_index_, &result->feature_paths_,
+                &result->feature_types_);
+  }
+  *decoder = std::move(result);
+  return Status::OK();
+}
+
+Status SequenceExampleDecoder::Decode(
+    const std::vector<absl::string_view>& serialized_examples,
+    std::vector<DecodedFeature>* features) const {
+  const int num_features = feature_paths_.size();
+  features->clear();
+  features->resize(num_features);
+  for (int i = 0; i < num_features; ++i) {
+    DecodedFeature& feature = (*features)[i];
+    feature.path = feature_paths_[i];
+    feature.type = feature_types_[i];
+    feature.offsets.push_back(0);
+    if (feature.path.size() > 1) {
+      feature.step_offsets.push_back(0);
+    }
+    if (feature.type == metadata::v0::BYTES) {
+      feature.bytes_offsets.push_back(0);
+    }
+  }
+
+  std::vector<absl::string_view> views(num_features);
+  std::vector<bool> present(num_features);
+  int64 example_index = 0;
+  for (const absl::string_view serialized : serialized_examples) {
+    std::fill(present.begin(), present.end(), false);
+    WireReader reader(serialized);
+    uint32 field_number, wire_type;
+    while (reader.Next(&field_number, &wire_type)) {
+      if (wire_type == kWireTypeLengthDelimited &&
+          (field_number == kSequenceExampleContext ||
+           field_number == kSequenceExampleFeatureLists)) {
+        absl::string_view map;
+        if (!reader.ReadLengthDelimited(&map)) {
+          return MalformedError();
+        }
+        TF_RETURN_IF_ERROR(CollectMapValues(
+            map,
+            field_number == kSequenceExampleContext ? context_feature_index_
+                                                    : sequence_feature_index_,
+            &views, &present));
+      } else if (!reader.SkipField(wire_type)) {
+        return MalformedError();
+      }
+    }
+    if (!reader.ok()) {
+      return MalformedError();
+    }
+
+    for (int i = 0; i < num_features; ++i) {
+      DecodedFeature& feature = (*features)[i];
+      bool valid = present[i];
+      if (valid) {
+        if (feature.step_offsets.empty()) {
+          TF_RETURN_IF_ERROR(AppendFeatureValues(views[i], &feature, &valid));
+        } else {
+          TF_RETURN_IF_ERROR(AppendFeatureListSteps(views[i], &feature));
+        }
+      }
+      AppendBit(valid, example_index, &feature.validity);
+      feature.offsets.push_back(feature.step_offsets.empty()
+                                    ? NumValues(feature)
+                                    : feature.step_offsets.size() - 1);
+    }
+    ++example_index;
+  }
+  for (DecodedFeature& feature : *features) {
+    AppendBit(true, example_index, &feature.validity);
+    if (!feature.step_offsets.empty()) {
+      AppendBit(true, feature.step_offsets.size() - 1,
+                &feature.step_validity);
+    }
+  }
+  return Status::OK();
+}
+
+}  // namespace data_validation
+}  // namespace tensorflow
@@ -0,0 +1,106 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Decodes serialized tf.SequenceExamples into a columnar representation that
+// follows the Arrow memory layout, by reading the protobuf wire format
+// directly (i.e. without parsing intermediate SequenceExample protos).
+#ifndef TENSORFLOW_DATA_VALIDATION_CODERS_SEQUENCE_EXAMPLE_DECODER_H_
+#define TENSORFLOW_DATA_VALIDATION_CODERS_SEQUENCE_EXAMPLE_DECODER_H_
+
+#include <memory>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow_data_validation/anomalies/path.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow_metadata/proto/v0/schema.pb.h"
+
+namespace tensorflow {
+namespace data_validation {
+
+// The default name of the STRUCT feature holding the sequence features.
+// LINT.IfChange
+constexpr char kDefaultSequenceFeatureColumnName[] = "##SEQUENCE##";
+// LINT.ThenChange(tf_example_decoder.py)
+
+// A decoded feature. Context features follow the Arrow memory layout of a
+// list<T> array, with one list per example. Sequence features follow the
+// layout of a list<list<T>> array, with one list of steps per example.
+struct DecodedFeature {
+  // The path of the feature, i.e. {name} for context features and
+  // {sequence_feature_column_name, name} for sequence features.
+  Path path;
+  // One of INT, FLOAT or BYTES.
+  metadata::v0::FeatureType type = metadata::v0::TYPE_UNKNOWN;
+  // Validity bitmap (least significant bit first) of num_examples + 1 bits,
+  // where the last bit is always set. This is the validity of the offsets.
+  std::vector<uint8> validity;
+  // The values (context features) or steps (sequence features) of example i
+  // are in [offsets[i], offsets[i + 1]).
+  std::vector<int32> offsets;
+  // Only for sequence features: the validity (num_steps + 1 bits) and
+  // offsets of the values of each step.
+  std::vector<uint8> step_validity;
+  std::vector<int32> step_offsets;
+  // Values of INT features.
+  std::vector<int64> int_values;
+  // Values of FLOAT features.
+  std::vector<float> float_values;
+  // Values of BYTES features: value j is
+  // bytes_data[bytes_offsets[j], bytes_offsets[j + 1]).
+  std::vector<int32> bytes_offsets;
+  string bytes_data;
+};
+
+// Decodes the features of a schema from serialized tf.SequenceExamples.
+// The features of the STRUCT feature named <sequence_feature_column_name> (if
+// any) are decoded from the feature_lists of the SequenceExamples, and all the
+// other features from their context. Only the features of type INT, FLOAT or
+// BYTES are decoded: the other features of the schema, and the features of the
+// SequenceExamples that are not in the schema, are ignored.
+// A feature that is absent from a SequenceExample, or that has none of its
+// value lists set, is missing (null) for that example. Likewise for the steps
+// of sequence features.
+class SequenceExampleDecoder {
+ public:
+  static Status Create(const metadata::v0::Schema& schema,
+                       const string& sequence_feature_column_name,
+                       std::unique_ptr<SequenceExampleDecoder>* decoder);
+
+  // Decodes <serialized_examples> into <features>, which has one element per
+  // feature, in the order of feature_paths().
+  Status Decode(const std::vector<absl::string_view>& serialized_examples,
+                std::vector<DecodedFeature>* features) const;
+
+  // The paths of the decoded features. These are the paths of the
+  // corresponding statistics (see DatasetStatsView::GetByPath).
+  const std::vector<Path>& feature_paths() const { return feature_paths_; }
+
+ private:
+  SequenceExampleDecoder() = default;
+
+  std::vector<Path> feature_paths_;
+  std::vector<metadata::v0::FeatureType> feature_types_;
+  // Index in feature_paths_ of the features, by name.
+  absl::flat_hash_map<string, int> context_feature_index_;
+  absl::flat_hash_map<string, int> sequence_feature_index_;
+};
+
+}  // namespace data_validation
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_DATA_VALIDATION_CODERS_SEQUENCE_EXAMPLE_DECODER_H_
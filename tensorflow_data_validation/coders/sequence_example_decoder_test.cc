@@ -0,0 +1,288 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow_data_validation/coders/sequence_example_decoder.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include "absl/strings/str_cat.h"
+#include "tensorflow_data_validation/anomalies/statistics_view.h"
+#include "tensorflow_data_validation/anomalies/test_util.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow_metadata/proto/v0/schema.pb.h"
+#include "tensorflow_metadata/proto/v0/statistics.pb.h"
+
+namespace tensorflow {
+namespace data_validation {
+namespace {
+
+using ::tensorflow::data_validation::testing::ParseTextProtoOrDie;
+using ::tensorflow::metadata::v0::DatasetFeatureStatistics;
+using ::tensorflow::metadata::v0::Schema;
+using ::testing::ElementsAre;
+
+// Helpers to serialize tf.SequenceExamples in the protobuf wire format.
+string Varint(uint64 value) {
+  string result;
+  while (value >= 0x80) {
+    result.push_back(static_cast<char>(value | 0x80));
+    value >>= 7;
+  }
+  result.push_back(static_cast<char>(value));
+  return result;
+}
+
+string LengthDelimited(int field_number, const string& value) {
+  return absl::StrCat(Varint(field_number << 3 | 2), Varint(value.size()),
+                      value);
+}
+
+string BytesFeature(const std::vector<string>& values) {
+  string list;
+  for (const string& value : values) {
+    absl::StrAppend(&list, LengthDelimited(1, value));
+  }
+  return LengthDelimited(1, list);
+}
+
+string FloatFeature(const std::vector<float> values) {
+  string packed(values.size() * sizeof(float), '\0');
+  std::memcpy(&packed[0], values.data(), packed.size());
+  return LengthDelimited(2, LengthDelimited(1, packed));
+}
+
+// Serializes the values of an Int64List either packed or not.
+string IntFeature(const std::vector<int64>& values, bool packed = true) {
+  string list;
+  for (const int64 value : values) {
+    absl::StrAppend(&list, packed ? "" : Varint(1 << 3),
+                    Varint(static_cast<uint64>(value)));
+  }
+  return LengthDelimited(
+      3, packed && !values.empty() ? LengthDelimited(1, list) : list);
+}
+
+string EmptyFeature() { return ""; }
+
+string MapEntry(const string& key, const string& value) {
+  return LengthDelimited(
+      1, absl::StrCat(LengthDelimited(1, key), LengthDelimited(2, value)));
+}
+
+string FeatureList(const std::vector<string>& features) {
+  string result;
+  for (const string& feature : features) {
+    absl::StrAppend(&result, LengthDelimited(1, feature));
+  }
+  return result;
+}
+
+string SequenceExample(const string& context, const string& feature_lists) {
+  return absl::StrCat(LengthDelimited(1, context),
+                      LengthDelimited(2, feature_lists));
+}
+
+bool IsValid(const std::vector<uint8>& validity, int64 i) {
+  return validity[i / 8] & (1 << (i % 8));
+}
+
+string ValueAsString(const DecodedFeature& feature, int32 i) {
+  switch (feature.type) {
+    case metadata::v0::INT:
+      return absl::StrCat(feature.int_values[i]);
+    case metadata::v0::FLOAT:
+      return absl::StrCat(feature.float_values[i]);
+    default:
+      return feature.bytes_data.substr(
+          feature.bytes_offsets[i],
+          feature.bytes_offsets[i + 1] - feature.bytes_offsets[i]);
+  }
+}
+
+string ListAsString(const DecodedFeature& feature,
+                    const std::vector<int32>& offsets, int64 i) {
+  string values;
+  for (int32 j = offsets[i]; j < offsets[i + 1]; ++j) {
+    absl::StrAppend(&values, j > offsets[i] ? ";" : "",
+                    ValueAsString(feature, j));
+  }
+  return absl::StrCat("[", values, "]");
+}
+
+// Returns the values of each example of <feature>, as strings; "null" for
+// missing examples (or steps).
+std::vector<string> RowsAsStrings(const DecodedFeature& feature) {
+  std::vector<string> result;
+  for (int64 i = 0; i + 1 < feature.offsets.size(); ++i) {
+    if (!IsValid(feature.validity, i)) {
+      result.push_back("null");
+    } else if (feature.step_offsets.empty()) {
+      result.push_back(ListAsString(feature, feature.offsets, i));
+    } else {
+      string steps;
+      for (int32 j = feature.offsets[i]; j < feature.offsets[i + 1]; ++j) {
+        absl::StrAppend(&steps, j > feature.offsets[i] ? "," : "",
+                        IsValid(feature.step_validity, j)
+                            ? ListAsString(feature, feature.step_offsets, j)
+                            : "null");
+      }
+      result.push_back(absl::StrCat("[", steps, "]"));
+    }
+  }
+  return result;
+}
+
+Schema GetTestSchema() {
+  return ParseTextProtoOrDie<Schema>(R"(
+    feature { name: "context_int" type: INT }
+    feature { name: "context_bytes" type: BYTES }
+    feature {
+      name: "##SEQUENCE##"
+      type: STRUCT
+      struct_domain {
+        feature { name: "sequence_float" type: FLOAT }
+        feature { name: "sequence_bytes" type: BYTES }
+      }
+    })");
+}
+
+TEST(SequenceExampleDecoderTest, Decode) {
+  std::unique_ptr<SequenceExampleDecoder> decoder;
+  TF_ASSERT_OK(SequenceExampleDecoder::Create(
+      GetTestSchema(), kDefaultSequenceFeatureColumnName, &decoder));
+  const std::vector<string> examples = {
+      SequenceExample(
+          absl::StrCat(MapEntry("context_int", IntFeature({1, -2})),
+                       MapEntry("context_bytes", BytesFeature({"a", ""})),
+                       MapEntry("not_in_schema", IntFeature({3}))),
+          absl::StrCat(
+              MapEntry("sequence_float",
+                       FeatureList({FloatFeature({1.5}), EmptyFeature(),
+                                    FloatFeature({})})),
+              MapEntry("sequence_bytes",
+                       FeatureList({BytesFeature({"x", "y"})})))),
+      SequenceExample(
+          MapEntry("context_int", IntFeature({7}, /*packed=*/false)),
+          MapEntry("sequence_float", FeatureList({}))),
+      "",
+  };
+  std::vector<absl::string_view> views(examples.begin(), examples.end());
+  std::vector<DecodedFeature> features;
+  TF_ASSERT_OK(decoder->Decode(views, &features));
+  ASSERT_EQ(features.size(), 4);
+  EXPECT_EQ(features[0].path, Path({"context_int"}));
+  EXPECT_THAT(RowsAsStrings(features[0]), ElementsAre("[1;-2]", "[7]", "null"));
+  EXPECT_EQ(features[1].path, Path({"context_bytes"}));
+  EXPECT_THAT(RowsAsStrings(features[1]), ElementsAre("[a;]", "null", "null"));
+  EXPECT_EQ(features[2].path, Path({"##SEQUENCE##", "sequence_float"}));
+  EXPECT_THAT(RowsAsStrings(features[2]),
+              ElementsAre("[[1.5],null,[]]", "[]", "null"));
+  EXPECT_EQ(features[3].path, Path({"##SEQUENCE##", "sequence_bytes"}));
+  EXPECT_THAT(RowsAsStrings(features[3]),
+              ElementsAre("[[x;y]]", "null", "null"));
+  // The trailing validity bits are always set.
+  EXPECT_EQ(features[0].validity, std::vector<uint8>({0x0b}));
+  EXPECT_EQ(features[2].step_validity, std::vector<uint8>({0x0d}));
+}
+
+TEST(SequenceExampleDecoderTest, LastEntryWins) {
+  std::unique_ptr<SequenceExampleDecoder> decoder;
+  TF_ASSERT_OK(SequenceExampleDecoder::Create(
+      GetTestSchema(), kDefaultSequenceFeatureColumnName, &decoder));
+  // Context maps may be split across several occurrences of the field.
+  const string example = absl::StrCat(
+      LengthDelimited(1, MapEntry("context_int", IntFeature({1}))),
+      LengthDelimited(1, MapEntry("context_int", IntFeature({2, 3}))));
+  std::vector<DecodedFeature> features;
+  TF_ASSERT_OK(decoder->Decode({example}, &features));
+  EXPECT_THAT(RowsAsStrings(features[0]), ElementsAre("[2;3]"));
+}
+
+TEST(SequenceExampleDecoderTest, PathsMatchStatistics) {
+  std::unique_ptr<SequenceExampleDecoder> decoder;
+  TF_ASSERT_OK(SequenceExampleDecoder::Create(
+      GetTestSchema(), kDefaultSequenceFeatureColumnName, &decoder));
+  const DatasetStatsView stats(ParseTextProtoOrDie<DatasetFeatureStatistics>(R"(
+    num_examples: 1
+    features { path { step: "context_int" } type: INT }
+    features { path { step: "context_bytes" } type: STRING }
+    features { path { step: "##SEQUENCE##" } type: STRUCT }
+    features {
+      path { step: "##SEQUENCE##" step: "sequence_float" }
+      type: FLOAT
+    }
+    features {
+      path { step: "##SEQUENCE##" step: "sequence_bytes" }
+      type: STRING
+    })"));
+  for (const Path& path : decoder->feature_paths()) {
+    EXPECT_TRUE(stats.GetByPath(path)) << path.Serialize();
+  }
+}
+
+TEST(SequenceExampleDecoderTest, SkipsFeaturesOfOtherTypes) {
+  std::unique_ptr<SequenceExampleDecoder> decoder;
+  TF_ASSERT_OK(SequenceExampleDecoder::Create(
+      ParseTextProtoOrDie<Schema>(R"(
+        feature { name: "struct" type: STRUCT }
+        feature { name: "untyped" }
+        feature { name: "int" type: INT }
+        feature {
+          name: "##SEQUENCE##"
+          type: STRUCT
+          struct_domain {
+            feature { name: "nested_struct" type: STRUCT }
+            feature { name: "float" type: FLOAT }
+          }
+        })"),
+      kDefaultSequenceFeatureColumnName, &decoder));
+  EXPECT_EQ(decoder->feature_paths(),
+            std::vector<Path>({Path({"int"}), Path({"##SEQUENCE##", "float"})}));
+}
+
+TEST(SequenceExampleDecoderTest, InvalidInputs) {
+  std::unique_ptr<SequenceExampleDecoder> decoder;
+  EXPECT_FALSE(SequenceExampleDecoder::Create(
+                   ParseTextProtoOrDie<Schema>(
+                       R"(feature { name: "##SEQUENCE##" type: INT })"),
+                   kDefaultSequenceFeatureColumnName, &decoder)
+                   .ok());
+
+  TF_ASSERT_OK(SequenceExampleDecoder::Create(
+      GetTestSchema(), kDefaultSequenceFeatureColumnName, &decoder));
+  std::vector<DecodedFeature> features;
+  // Values of the wrong type.
+  const string wrong_type =
+      SequenceExample(MapEntry("context_int", FloatFeature({1})), "");
+  const Status status = decoder->Decode({wrong_type}, &features);
+  EXPECT_FALSE(status.ok());
+  EXPECT_NE(status.error_message().find("context_int"), string::npos);
+  // Truncated input.
+  const string example =
+      LengthDelimited(1, MapEntry("context_int", IntFeature({1})));
+  EXPECT_FALSE(
+      decoder->Decode({absl::string_view(example).substr(0, example.size() - 1)},
+                      &features)
+          .ok());
+}
+
+}  // namespace
+}  // namespace data_validation
+}  // namespace tensorflow
@@ -22,7 +22,18 @@ from __future__ import print_function
 import apache_beam as beam
 import pyarrow as pa
 from tensorflow_data_validation import constants
+from tensorflow_data_validation.pywrap.tensorflow_data_validation_extension import coders as coders_pywrap
 from tensorflow_data_validation.utils import batch_util
+from tfx_bsl.coders import batch_util as tfx_bsl_batch_util
+from typing import Any, Iterable, List, Optional, Text, Tuple
+
+from tensorflow_metadata.proto.v0 import schema_pb2
+
+# The name of the STRUCT feature holding the sequence features of
+# SequenceExamples.
+# LINT.IfChange
+DEFAULT_SEQUENCE_FEATURE_COLUMN_NAME = '##SEQUENCE##'
+# LINT.ThenChange(sequence_example_decoder.h)
 
 
 @beam.ptransform_fn
@@ -46,3 +57,110 @@ def DecodeTFExample(
           | 'BatchSerializedExamplesToArrowRecordBatches' >>
           batch_util.BatchSerializedExamplesToArrowRecordBatches(
               desired_batch_size=desired_batch_size))
+
+
+def _list_array(validity: bytes, offsets: bytes,
+                values: pa.Array) -> pa.Array:
+  """Wraps validity and offsets buffers into an Arrow ListArray."""
+  # Null offsets mark null lists. The last offset is always valid.
+  offsets_array = pa.Array.from_buffers(
+      pa.int32(), len(offsets) // 4,
+      [pa.py_buffer(validity), pa.py_buffer(offsets)])
+  return pa.ListArray.from_arrays(offsets_array, values)
+
+
+def _feature_to_arrow(feature: Tuple[Any, ...]) -> pa.Array:
+  """Wraps the buffers of a natively decoded feature into an Arrow array."""
+  (_, feature_type, validity, offsets, step_validity, step_offsets, values,
+   bytes_offsets) = feature
+  if feature_type == schema_pb2.BYTES:
+    values_array = pa.Array.from_buffers(
+        pa.binary(), len(bytes_offsets) // 4 - 1,
+        [None, pa.py_buffer(bytes_offsets), pa.py_buffer(values)])
+  else:
+    value_type = (pa.int64() if feature_type == schema_pb2.INT
+                  else pa.float32())
+    values_array = pa.Array.from_buffers(
+        value_type, len(values) // (value_type.bit_width // 8),
+        [None, pa.py_buffer(values)])
+  if step_offsets is not None:
+    values_array = _list_array(step_validity, step_offsets, values_array)
+  return _list_array(validity, offsets, values_array)
+
+
+@beam.typehints.with_input_types(List[bytes])
+@beam.typehints.with_output_types(pa.RecordBatch)
+class _DecodeSequenceExamplesDoFn(beam.DoFn):
+  """Decodes batches of serialized SequenceExamples into RecordBatches."""
+
+  def __init__(self, schema: schema_pb2.Schema,
+               sequence_feature_column_name: Text) -> None:
+    self._serialized_schema = schema.SerializeToString()
+    self._sequence_feature_column_name = sequence_feature_column_name
+    self._decoder = None
+
+  def setup(self):
+    self._decoder = coders_pywrap.SequenceExampleDecoder(
+        self._serialized_schema, self._sequence_feature_column_name)
+
+  def process(self, batch: List[bytes]) -> Iterable[pa.RecordBatch]:
+    num_rows, features = self._decoder.Decode(batch)
+    columns = []
+    names = []
+    sequence_fields = []
+    sequence_names = []
+    for feature in features:
+      path = feature[0]
+      if len(path) > 1:
+        sequence_fields.append(_feature_to_arrow(feature))
+        sequence_names.append(path[1])
+      else:
+        columns.append(_feature_to_arrow(feature))
+        names.append(path[0])
+    if sequence_fields:
+      columns.append(
+          pa.StructArray.from_arrays(sequence_fields, sequence_names))
+      names.append(self._sequence_feature_column_name)
+    if not columns:
+      columns.append(pa.array([None] * num_rows, type=pa.null()))
+      names.append(self._sequence_feature_column_name)
+    yield pa.RecordBatch.from_arrays(columns, names)
+
+
+@beam.ptransform_fn
+@beam.typehints.with_input_types(bytes)
+@beam.typehints.with_output_types(pa.RecordBatch)
+def DecodeTFSequenceExample(
+    examples: beam.pvalue.PCollection,
+    schema: schema_pb2.Schema,
+    sequence_feature_column_name: Text = DEFAULT_SEQUENCE_FEATURE_COLUMN_NAME,
+    desired_batch_size: Optional[int] = constants
+    .DEFAULT_DESIRED_INPUT_BATCH_SIZE
+) -> beam.pvalue.PCollection:  # pylint: disable=invalid-name
+  """Decodes serialized tf.SequenceExamples into Arrow RecordBatches.
+
+  The SequenceExamples are decoded natively, without parsing them into
+  intermediate protos. Only the features in `schema` are decoded. The context
+  features are decoded as list<T> columns. The features of the STRUCT feature
+  named `sequence_feature_column_name` are decoded from the feature lists as
+  list<list<T>> fields of a struct column of that name, so that their
+  statistics have paths [sequence_feature_column_name, feature name].
+
+  Args:
+    examples: A PCollection of serialized tf.SequenceExamples.
+    schema: The schema of the SequenceExamples. Features must be of type INT,
+      FLOAT or BYTES.
+    sequence_feature_column_name: The name of the STRUCT feature holding the
+      sequence features in `schema`.
+    desired_batch_size: Batch size. The output Arrow RecordBatches will have as
+      many rows as the `desired_batch_size`.
+
+  Returns:
+    A PCollection of Arrow RecordBatches.
+  """
+  return (examples
+          | 'BatchSerializedSequenceExamples' >> beam.BatchElements(
+              **tfx_bsl_batch_util.GetBatchElementsKwargs(desired_batch_size))
+          | 'DecodeSequenceExamples' >> beam.ParDo(
+              _DecodeSequenceExamplesDoFn(schema,
+                                          sequence_feature_column_name)))
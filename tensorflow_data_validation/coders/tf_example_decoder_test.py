@@ -20,12 +20,14 @@ from absl.testing import absltest
 from absl.testing import parameterized
 import apache_beam as beam
 from apache_beam.testing import util
+import pyarrow as pa
 import tensorflow as tf
 from tensorflow_data_validation.coders import tf_example_decoder
 from tensorflow_data_validation.coders import tf_example_decoder_test_data
 from tensorflow_data_validation.utils import test_util
 
 from google.protobuf import text_format
+from tensorflow_metadata.proto.v0 import schema_pb2
 
 
 class TFExampleDecoderTest(parameterized.TestCase):
@@ -45,6 +47,53 @@ class TFExampleDecoderTest(parameterized.TestCase):
           result,
           test_util.make_arrow_record_batches_equal_fn(self,
                                                        [decoded_record_batch]))
+  def test_decode_sequence_example_with_beam_pipeline(self):
+    sequence_example = text_format.Parse(
+        """
+        context {
+          feature { key: "context_int" value { int64_list { value: [1, 2] } } }
+          feature { key: "not_in_schema" value { float_list { value: 1 } } }
+        }
+        feature_lists {
+          feature_list {
+            key: "sequence_bytes"
+            value {
+              feature { bytes_list { value: ["a", "b"] } }
+              feature { }
+            }
+          }
+        }
+        """, tf.train.SequenceExample())
+    schema = text_format.Parse(
+        """
+        feature { name: "context_int" type: INT }
+        feature {
+          name: "##SEQUENCE##"
+          type: STRUCT
+          struct_domain {
+            feature { name: "sequence_bytes" type: BYTES }
+            feature { name: "sequence_float" type: FLOAT }
+          }
+        }
+        """, schema_pb2.Schema())
+    expected_record_batch = pa.RecordBatch.from_arrays([
+        pa.array([[1, 2], None], type=pa.list_(pa.int64())),
+        pa.StructArray.from_arrays([
+            pa.array([[[b'a', b'b'], None], None],
+                     type=pa.list_(pa.list_(pa.binary()))),
+            pa.array([None, None], type=pa.list_(pa.list_(pa.float32()))),
+        ], ['sequence_bytes', 'sequence_float']),
+    ], ['context_int', '##SEQUENCE##'])
+    with beam.Pipeline() as p:
+      result = (p
+                | beam.Create([sequence_example.SerializeToString(), b''])
+                | tf_example_decoder.DecodeTFSequenceExample(
+                    schema, desired_batch_size=2))
+      util.assert_that(
+          result,
+          test_util.make_arrow_record_batches_equal_fn(
+              self, [expected_record_batch]))
+
 
 if __name__ == '__main__':
   absltest.main()
@@ -0,0 +1,70 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+// Little-endian encoding of fixed-width integers, as
+// tensorflow/core/lib/core/coding.h.
+#ifndef TENSORFLOW_DATA_VALIDATION_CORE_LITE_LIB_CORE_CODING_H_
+#define TENSORFLOW_DATA_VALIDATION_CORE_LITE_LIB_CORE_CODING_H_
+
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace core {
+
+inline void EncodeFixed32(char* buf, uint32 value) {
+  for (int i = 0; i < 4; ++i) {
+    buf[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+  }
+}
+
+inline void EncodeFixed64(char* buf, uint64 value) {
+  for (int i = 0; i < 8; ++i) {
+    buf[i] = static_cast<char>((value >> (8 * i)) & 0xff);
+  }
+}
+
+inline void PutFixed32(string* dst, uint32 value) {
+  char buf[sizeof(value)];
+  EncodeFixed32(buf, value);
+  dst->append(buf, sizeof(buf));
+}
+
+inline void PutFixed64(string* dst, uint64 value) {
+  char buf[sizeof(value)];
+  EncodeFixed64(buf, value);
+  dst->append(buf, sizeof(buf));
+}
+
+inline uint32 DecodeFixed32(const char* ptr) {
+  uint32 result = 0;
+  for (int i = 0; i < 4; ++i) {
+    result |= static_cast<uint32>(static_cast<unsigned char>(ptr[i]))
+              << (8 * i);
+  }
+  return result;
+}
+
+inline uint64 DecodeFixed64(const char* ptr) {
+  uint64 result = 0;
+  for (int i = 0; i < 8; ++i) {
+    result |= static_cast<uint64>(static_cast<unsigned char>(ptr[i]))
+              << (8 * i);
+  }
+  return result;
+}
+
+}  // namespace core
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_DATA_VALIDATION_CORE_LITE_LIB_CORE_CODING_H_
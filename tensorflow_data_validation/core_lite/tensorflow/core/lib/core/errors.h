@@ -0,0 +1,69 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_DATA_VALIDATION_CORE_LITE_LIB_CORE_ERRORS_H_
+#define TENSORFLOW_DATA_VALIDATION_CORE_LITE_LIB_CORE_ERRORS_H_
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/lib/core/status.h"
+
+namespace tensorflow {
+namespace errors {
+
+typedef ::tensorflow::error::Code Code;
+
+// Appends some context to an error message.
+template <typename... Args>
+void AppendToMessage(::tensorflow::Status* status, Args... args) {
+  *status = ::tensorflow::Status(
+      status->code(),
+      absl::StrCat(status->error_message(), "\n\t", args...));
+}
+
+// For each canonical error code, a function creating a status with the
+// concatenation of <args> as message, e.g. errors::InvalidArgument(...), and
+// a predicate, e.g. errors::IsInvalidArgument(status).
+#define DECLARE_ERROR(FUNC, CONST)                                       \
+  template <typename... Args>                                            \
+  ::tensorflow::Status FUNC(Args... args) {                              \
+    return ::tensorflow::Status(::tensorflow::error::CONST,              \
+                                absl::StrCat(args...));                  \
+  }                                                                      \
+  inline bool Is##FUNC(const ::tensorflow::Status& status) {             \
+    return status.code() == ::tensorflow::error::CONST;                  \
+  }
+
+DECLARE_ERROR(Cancelled, CANCELLED)
+DECLARE_ERROR(InvalidArgument, INVALID_ARGUMENT)
+DECLARE_ERROR(NotFound, NOT_FOUND)
+DECLARE_ERROR(AlreadyExists, ALREADY_EXISTS)
+DECLARE_ERROR(ResourceExhausted, RESOURCE_EXHAUSTED)
+DECLARE_ERROR(Unavailable, UNAVAILABLE)
+DECLARE_ERROR(FailedPrecondition, FAILED_PRECONDITION)
+DECLARE_ERROR(OutOfRange, OUT_OF_RANGE)
+DECLARE_ERROR(Unimplemented, UNIMPLEMENTED)
+DECLARE_ERROR(Internal, INTERNAL)
+DECLARE_ERROR(Aborted, ABORTED)
+DECLARE_ERROR(DeadlineExceeded, DEADLINE_EXCEEDED)
+DECLARE_ERROR(DataLoss, DATA_LOSS)
+DECLARE_ERROR(Unknown, UNKNOWN)
+DECLARE_ERROR(PermissionDenied, PERMISSION_DENIED)
+DECLARE_ERROR(Unauthenticated, UNAUTHENTICATED)
+
+#undef DECLARE_ERROR
+
+}  // namespace errors
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_DATA_VALIDATION_CORE_LITE_LIB_CORE_ERRORS_H_
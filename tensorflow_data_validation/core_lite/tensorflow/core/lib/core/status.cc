@@ -0,0 +1,101 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/lib/core/status.h"
+
+namespace tensorflow {
+
+namespace {
+
+const char* CodeName(error::Code code) {
+  switch (code) {
+    case error::CANCELLED:
+      return "Cancelled";
+    case error::UNKNOWN:
+      return "Unknown";
+    case error::INVALID_ARGUMENT:
+      return "Invalid argument";
+    case error::DEADLINE_EXCEEDED:
+      return "Deadline exceeded";
+    case error::NOT_FOUND:
+      return "Not found";
+    case error::ALREADY_EXISTS:
+      return "Already exists";
+    case error::PERMISSION_DENIED:
+      return "Permission denied";
+    case error::UNAUTHENTICATED:
+      return "Unauthenticated";
+    case error::RESOURCE_EXHAUSTED:
+      return "Resource exhausted";
+    case error::FAILED_PRECONDITION:
+      return "Failed precondition";
+    case error::ABORTED:
+      return "Aborted";
+    case error::OUT_OF_RANGE:
+      return "Out of range";
+    case error::UNIMPLEMENTED:
+      return "Unimplemented";
+    case error::INTERNAL:
+      return "Internal";
+    case error::UNAVAILABLE:
+      return "Unavailable";
+    case error::DATA_LOSS:
+      return "Data loss";
+    case error::OK:
+      break;
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+Status::Status(error::Code code, const string& msg) {
+  CHECK(code != error::OK);
+  state_.reset(new State{code, msg});
+}
+
+const string& Status::error_message() const {
+  static const string* const empty_string = new string;
+  return ok() ? *empty_string : state_->msg;
+}
+
+bool Status::operator==(const Status& x) const {
+  return code() == x.code() && error_message() == x.error_message();
+}
+
+void Status::Update(const Status& new_status) {
+  if (ok()) {
+    *this = new_status;
+  }
+}
+
+string Status::ToString() const {
+  if (ok()) {
+    return "OK";
+  }
+  const char* name = CodeName(code());
+  string result = name != nullptr
+                      ? string(name)
+                      : "Unknown code(" + std::to_string(code()) + ")";
+  result += ": ";
+  result += state_->msg;
+  return result;
+}
+
+std::ostream& operator<<(std::ostream& os, const Status& x) {
+  os << x.ToString();
+  return os;
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,121 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+// A Status compatible with tensorflow::Status, for the code paths of the
+// library which do not link TensorFlow.
+#ifndef TENSORFLOW_DATA_VALIDATION_CORE_LITE_LIB_CORE_STATUS_H_
+#define TENSORFLOW_DATA_VALIDATION_CORE_LITE_LIB_CORE_STATUS_H_
+
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace error {
+
+// The canonical error codes of tensorflow/core/protobuf/error_codes.proto.
+enum Code {
+  OK = 0,
+  CANCELLED = 1,
+  UNKNOWN = 2,
+  INVALID_ARGUMENT = 3,
+  DEADLINE_EXCEEDED = 4,
+  NOT_FOUND = 5,
+  ALREADY_EXISTS = 6,
+  PERMISSION_DENIED = 7,
+  UNAUTHENTICATED = 16,
+  RESOURCE_EXHAUSTED = 8,
+  FAILED_PRECONDITION = 9,
+  ABORTED = 10,
+  OUT_OF_RANGE = 11,
+  UNIMPLEMENTED = 12,
+  INTERNAL = 13,
+  UNAVAILABLE = 14,
+  DATA_LOSS = 15,
+};
+
+}  // namespace error
+
+class Status {
+ public:
+  // Creates a success status.
+  Status() {}
+
+  // Creates a status with the specified error code and message. <code> must
+  // not be OK.
+  Status(error::Code code, const string& msg);
+
+  Status(const Status& s)
+      : state_(s.state_ == nullptr ? nullptr : new State(*s.state_)) {}
+  Status& operator=(const Status& s) {
+    if (this != &s) {
+      state_.reset(s.state_ == nullptr ? nullptr : new State(*s.state_));
+    }
+    return *this;
+  }
+  Status(Status&& s) = default;
+  Status& operator=(Status&& s) = default;
+
+  static Status OK() { return Status(); }
+
+  bool ok() const { return state_ == nullptr; }
+
+  error::Code code() const { return ok() ? error::OK : state_->code; }
+
+  const string& error_message() const;
+
+  bool operator==(const Status& x) const;
+  bool operator!=(const Status& x) const { return !(*this == x); }
+
+  // If "ok()", stores "new_status" into *this. If "!ok()", preserves the
+  // current status.
+  void Update(const Status& new_status);
+
+  // Returns a string representation of this status, e.g.
+  // "Invalid argument: <message>".
+  string ToString() const;
+
+  // Ignores any errors, making explicit that they are not checked.
+  void IgnoreError() const {}
+
+ private:
+  struct State {
+    error::Code code;
+    string msg;
+  };
+  // OK status has a null state_.
+  std::unique_ptr<State> state_;
+};
+
+std::ostream& operator<<(std::ostream& os, const Status& x);
+
+}  // namespace tensorflow
+
+#define TF_RETURN_IF_ERROR(...)                          \
+  do {                                                   \
+    const ::tensorflow::Status _status = (__VA_ARGS__);  \
+    if (!_status.ok()) return _status;                   \
+  } while (0)
+
+#define TF_CHECK_OK(val)                          \
+  do {                                            \
+    const ::tensorflow::Status _status = (val);   \
+    CHECK(_status.ok()) << _status;               \
+  } while (0)
+#define TF_QCHECK_OK(val) TF_CHECK_OK(val)
+
+#endif  // TENSORFLOW_DATA_VALIDATION_CORE_LITE_LIB_CORE_STATUS_H_
@@ -0,0 +1,27 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_DATA_VALIDATION_CORE_LITE_LIB_CORE_STATUS_TEST_UTIL_H_
+#define TENSORFLOW_DATA_VALIDATION_CORE_LITE_LIB_CORE_STATUS_TEST_UTIL_H_
+
+#include <gtest/gtest.h>
+#include "tensorflow/core/lib/core/status.h"
+
+// Macros for testing the results of functions that return tensorflow::Status.
+#define TF_EXPECT_OK(statement) \
+  EXPECT_EQ(::tensorflow::Status::OK(), (statement))
+#define TF_ASSERT_OK(statement) \
+  ASSERT_EQ(::tensorflow::Status::OK(), (statement))
+
+#endif  // TENSORFLOW_DATA_VALIDATION_CORE_LITE_LIB_CORE_STATUS_TEST_UTIL_H_
@@ -0,0 +1,33 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/lib/strings/proto_serialization.h"
+
+namespace tensorflow {
+
+bool SerializeToStringDeterministic(const protobuf::MessageLite& msg,
+                                    string* result) {
+  result->clear();
+  {
+    protobuf::io::StringOutputStream stream(result);
+    protobuf::io::CodedOutputStream output(&stream);
+    output.SetSerializationDeterministic(true);
+    if (!msg.SerializeToCodedStream(&output)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace tensorflow
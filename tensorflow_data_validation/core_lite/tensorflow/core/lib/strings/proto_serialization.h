@@ -0,0 +1,30 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_DATA_VALIDATION_CORE_LITE_LIB_STRINGS_PROTO_SERIALIZATION_H_
+#define TENSORFLOW_DATA_VALIDATION_CORE_LITE_LIB_STRINGS_PROTO_SERIALIZATION_H_
+
+#include "tensorflow/core/platform/protobuf.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// Serializes <msg> into *result with a deterministic order of the map
+// entries. Returns false on error.
+bool SerializeToStringDeterministic(const protobuf::MessageLite& msg,
+                                    string* result);
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_DATA_VALIDATION_CORE_LITE_LIB_STRINGS_PROTO_SERIALIZATION_H_
@@ -0,0 +1,65 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/lib/strings/stringprintf.h"
+
+#include <stdio.h>
+
+#include <vector>
+
+namespace tensorflow {
+namespace strings {
+
+void Appendv(string* dst, const char* format, va_list ap) {
+  // First try with a small fixed size buffer.
+  char space[1024];
+  va_list backup_ap;
+  va_copy(backup_ap, ap);
+  int result = vsnprintf(space, sizeof(space), format, backup_ap);
+  va_end(backup_ap);
+  if (result < 0) {
+    return;
+  }
+  if (result < static_cast<int>(sizeof(space))) {
+    dst->append(space, result);
+    return;
+  }
+  // The output was truncated: retry with a buffer of the exact size.
+  std::vector<char> buffer(result + 1);
+  va_copy(backup_ap, ap);
+  result = vsnprintf(buffer.data(), buffer.size(), format, backup_ap);
+  va_end(backup_ap);
+  if (result >= 0 && result < static_cast<int>(buffer.size())) {
+    dst->append(buffer.data(), result);
+  }
+}
+
+string Printf(const char* format, ...) {
+  va_list ap;
+  va_start(ap, format);
+  string result;
+  Appendv(&result, format, ap);
+  va_end(ap);
+  return result;
+}
+
+void Appendf(string* dst, const char* format, ...) {
+  va_list ap;
+  va_start(ap, format);
+  Appendv(dst, format, ap);
+  va_end(ap);
+}
+
+}  // namespace strings
+}  // namespace tensorflow
@@ -0,0 +1,42 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_DATA_VALIDATION_CORE_LITE_LIB_STRINGS_STRINGPRINTF_H_
+#define TENSORFLOW_DATA_VALIDATION_CORE_LITE_LIB_STRINGS_STRINGPRINTF_H_
+
+#include <stdarg.h>
+
+#include <string>
+
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace strings {
+
+// Returns a C++ string formatted as printf.
+string Printf(const char* format, ...)
+    __attribute__((__format__(__printf__, 1, 2)));
+
+// Appends the printf-formatted string to *dst.
+void Appendf(string* dst, const char* format, ...)
+    __attribute__((__format__(__printf__, 2, 3)));
+
+// Lower-level routine that takes a va_list and appends to a specified
+// string. All other routines are just convenience wrappers around it.
+void Appendv(string* dst, const char* format, va_list ap);
+
+}  // namespace strings
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_DATA_VALIDATION_CORE_LITE_LIB_STRINGS_STRINGPRINTF_H_
@@ -0,0 +1,31 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+// The byte order of the host, as tensorflow/core/platform/byte_order.h.
+#ifndef TENSORFLOW_DATA_VALIDATION_CORE_LITE_PLATFORM_BYTE_ORDER_H_
+#define TENSORFLOW_DATA_VALIDATION_CORE_LITE_PLATFORM_BYTE_ORDER_H_
+
+namespace tensorflow {
+namespace port {
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+constexpr bool kLittleEndian = true;
+#else
+constexpr bool kLittleEndian = false;
+#endif
+
+}  // namespace port
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_DATA_VALIDATION_CORE_LITE_PLATFORM_BYTE_ORDER_H_
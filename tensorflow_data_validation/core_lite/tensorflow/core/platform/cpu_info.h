@@ -0,0 +1,32 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_DATA_VALIDATION_CORE_LITE_PLATFORM_CPU_INFO_H_
+#define TENSORFLOW_DATA_VALIDATION_CORE_LITE_PLATFORM_CPU_INFO_H_
+
+#include <thread>
+
+namespace tensorflow {
+namespace port {
+
+// Returns an estimate of the number of schedulable CPUs for this process.
+inline int MaxParallelism() {
+  const int num_cpus = std::thread::hardware_concurrency();
+  return num_cpus > 0 ? num_cpus : 1;
+}
+
+}  // namespace port
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_DATA_VALIDATION_CORE_LITE_PLATFORM_CPU_INFO_H_
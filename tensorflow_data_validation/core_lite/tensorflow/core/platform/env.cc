@@ -0,0 +1,203 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/platform/env.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <thread>
+
+#include "absl/strings/str_cat.h"
+#include "tensorflow/core/lib/core/errors.h"
+
+namespace tensorflow {
+
+namespace {
+
+// Returns the status of a failed system call on <context>, from errno.
+Status IOError(const string& context, int err_number) {
+  const string message = absl::StrCat(context, "; ", strerror(err_number));
+  switch (err_number) {
+    case ENOENT:
+    case ENOTDIR:
+      return errors::NotFound(message);
+    case EACCES:
+    case EPERM:
+    case EROFS:
+      return errors::PermissionDenied(message);
+    case EEXIST:
+      return errors::AlreadyExists(message);
+    case EINVAL:
+    case ENAMETOOLONG:
+    case EISDIR:
+      return errors::InvalidArgument(message);
+    case ENOMEM:
+    case ENOSPC:
+    case EMFILE:
+    case ENFILE:
+      return errors::ResourceExhausted(message);
+    default:
+      return errors::Unknown(message);
+  }
+}
+
+class PosixReadOnlyMemoryRegion : public ReadOnlyMemoryRegion {
+ public:
+  PosixReadOnlyMemoryRegion(const void* address, uint64 length)
+      : address_(address), length_(length) {}
+  ~PosixReadOnlyMemoryRegion() override {
+    if (length_ > 0) {
+      munmap(const_cast<void*>(address_), length_);
+    }
+  }
+  const void* data() override { return address_; }
+  uint64 length() override { return length_; }
+
+ private:
+  const void* const address_;
+  const uint64 length_;
+};
+
+class StdThread : public Thread {
+ public:
+  explicit StdThread(std::function<void()> fn) : thread_(std::move(fn)) {}
+  ~StdThread() override { thread_.join(); }
+
+ private:
+  std::thread thread_;
+};
+
+}  // namespace
+
+Thread::~Thread() {}
+
+Env* Env::Default() {
+  static Env* const default_env = new Env;
+  return default_env;
+}
+
+Status Env::FileExists(const string& fname) {
+  if (access(fname.c_str(), F_OK) == 0) {
+    return Status::OK();
+  }
+  return errors::NotFound(fname, " not found");
+}
+
+Status Env::NewReadOnlyMemoryRegionFromFile(
+    const string& fname, std::unique_ptr<ReadOnlyMemoryRegion>* result) {
+  const int fd = open(fname.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return IOError(fname, errno);
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    const Status status = IOError(fname, errno);
+    close(fd);
+    return status;
+  }
+  const void* address = nullptr;
+  if (st.st_size > 0) {
+    address = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (address == MAP_FAILED) {
+      const Status status = IOError(fname, errno);
+      close(fd);
+      return status;
+    }
+  }
+  close(fd);
+  result->reset(new PosixReadOnlyMemoryRegion(address, st.st_size));
+  return Status::OK();
+}
+
+Thread* Env::StartThread(const ThreadOptions& /*thread_options*/,
+                         const string& /*name*/, std::function<void()> fn) {
+  return new StdThread(std::move(fn));
+}
+
+uint64 Env::NowMicros() {
+  timeval now;
+  gettimeofday(&now, nullptr);
+  return static_cast<uint64>(now.tv_sec) * 1000000 + now.tv_usec;
+}
+
+void Env::SleepForMicroseconds(int64 micros) {
+  while (micros > 0) {
+    timespec sleep_time;
+    sleep_time.tv_sec = micros / 1000000;
+    sleep_time.tv_nsec = (micros % 1000000) * 1000;
+    timespec remaining;
+    if (nanosleep(&sleep_time, &remaining) == 0) {
+      return;
+    }
+    micros = remaining.tv_sec * 1000000 + remaining.tv_nsec / 1000;
+  }
+}
+
+Status ReadFileToString(Env* /*env*/, const string& fname, string* data) {
+  const int fd = open(fname.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return IOError(fname, errno);
+  }
+  data->clear();
+  char buffer[1 << 16];
+  while (true) {
+    const ssize_t read_size = read(fd, buffer, sizeof(buffer));
+    if (read_size < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      const Status status = IOError(fname, errno);
+      close(fd);
+      return status;
+    }
+    if (read_size == 0) {
+      break;
+    }
+    data->append(buffer, read_size);
+  }
+  close(fd);
+  return Status::OK();
+}
+
+Status WriteStringToFile(Env* /*env*/, const string& fname,
+                         absl::string_view data) {
+  const int fd = open(fname.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    return IOError(fname, errno);
+  }
+  while (!data.empty()) {
+    const ssize_t written = write(fd, data.data(), data.size());
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      const Status status = IOError(fname, errno);
+      close(fd);
+      return status;
+    }
+    data.remove_prefix(written);
+  }
+  if (close(fd) != 0) {
+    return IOError(fname, errno);
+  }
+  return Status::OK();
+}
+
+}  // namespace tensorflow
@@ -0,0 +1,102 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+// The subset of tensorflow/core/platform/env.h used by the library, for POSIX
+// systems.
+#ifndef TENSORFLOW_DATA_VALIDATION_CORE_LITE_PLATFORM_ENV_H_
+#define TENSORFLOW_DATA_VALIDATION_CORE_LITE_PLATFORM_ENV_H_
+
+#include <functional>
+#include <memory>
+#include <string>
+
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// A readonly memmapped file abstraction.
+class ReadOnlyMemoryRegion {
+ public:
+  ReadOnlyMemoryRegion() {}
+  virtual ~ReadOnlyMemoryRegion() = default;
+
+  // Returns a pointer to the memory region.
+  virtual const void* data() = 0;
+
+  // Returns the length of the memory region in bytes.
+  virtual uint64 length() = 0;
+};
+
+// Options to configure a Thread.
+struct ThreadOptions {
+  // Thread stack size to use (in bytes), 0 for the default.
+  size_t stack_size = 0;
+};
+
+// Represents a thread used to run a function.
+class Thread {
+ public:
+  Thread() {}
+
+  // Blocks until the thread of control stops running.
+  virtual ~Thread();
+
+ private:
+  Thread(const Thread&) = delete;
+  void operator=(const Thread&) = delete;
+};
+
+class Env {
+ public:
+  Env() {}
+  virtual ~Env() = default;
+
+  // Returns the default environment.
+  static Env* Default();
+
+  // Returns OK if the named path exists and NotFound otherwise.
+  Status FileExists(const string& fname);
+
+  // Maps the contents of <fname> in memory.
+  Status NewReadOnlyMemoryRegionFromFile(
+      const string& fname, std::unique_ptr<ReadOnlyMemoryRegion>* result);
+
+  // Returns a new thread that is running <fn>. The caller takes ownership
+  // of the result, whose deletion blocks until <fn> stops running.
+  Thread* StartThread(const ThreadOptions& thread_options, const string& name,
+                      std::function<void()> fn);
+
+  // Returns the number of micro-seconds since the Unix epoch.
+  uint64 NowMicros();
+
+  // Sleeps for the given number of micro-seconds.
+  void SleepForMicroseconds(int64 micros);
+
+ private:
+  Env(const Env&) = delete;
+  void operator=(const Env&) = delete;
+};
+
+// Reads the contents of the file <fname> into *data.
+Status ReadFileToString(Env* env, const string& fname, string* data);
+
+// Writes <data> to the file <fname>, overwriting any existing content.
+Status WriteStringToFile(Env* env, const string& fname,
+                         absl::string_view data);
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_DATA_VALIDATION_CORE_LITE_PLATFORM_ENV_H_
@@ -0,0 +1,32 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_DATA_VALIDATION_CORE_LITE_PLATFORM_FINGERPRINT_H_
+#define TENSORFLOW_DATA_VALIDATION_CORE_LITE_PLATFORM_FINGERPRINT_H_
+
+#include "absl/strings/string_view.h"
+#include "farmhash.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// Returns a 64-bit fingerprint of <s>, the same as TensorFlow's (FarmHash
+// Fingerprint64), so that fingerprints can be compared across builds.
+inline uint64 Fingerprint64(absl::string_view s) {
+  return ::util::Fingerprint64(s.data(), s.size());
+}
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_DATA_VALIDATION_CORE_LITE_PLATFORM_FINGERPRINT_H_
@@ -0,0 +1,76 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/platform/logging.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <time.h>
+
+namespace tensorflow {
+namespace internal {
+
+namespace {
+
+// Parses the integer value of the environment variable <name>, 0 if unset.
+int64 GetEnvInt(const char* name) {
+  const char* value = getenv(name);
+  return value == nullptr ? 0 : strtoll(value, nullptr, 10);
+}
+
+int64 MinLogLevel() {
+  static const int64 min_log_level = GetEnvInt("TF_CPP_MIN_LOG_LEVEL");
+  return min_log_level;
+}
+
+}  // namespace
+
+LogMessage::LogMessage(const char* fname, int line, int severity)
+    : fname_(fname), line_(line), severity_(severity) {}
+
+LogMessage::~LogMessage() {
+  if (severity_ >= MinLogLevel()) {
+    GenerateLogMessage();
+  }
+}
+
+int64 LogMessage::MinVLogLevel() {
+  static const int64 min_vlog_level = GetEnvInt("TF_CPP_MIN_VLOG_LEVEL");
+  return min_vlog_level;
+}
+
+void LogMessage::GenerateLogMessage() {
+  timeval now;
+  gettimeofday(&now, nullptr);
+  const time_t now_seconds = now.tv_sec;
+  tm now_tm;
+  localtime_r(&now_seconds, &now_tm);
+  char time_buffer[30];
+  strftime(time_buffer, sizeof(time_buffer), "%Y-%m-%d %H:%M:%S", &now_tm);
+  fprintf(stderr, "%s.%06ld: %c %s:%d] %s\n", time_buffer,
+          static_cast<long>(now.tv_usec), "IWEF"[severity_], fname_, line_,
+          str().c_str());
+}
+
+LogMessageFatal::LogMessageFatal(const char* file, int line)
+    : LogMessage(file, line, FATAL) {}
+
+LogMessageFatal::~LogMessageFatal() {
+  GenerateLogMessage();
+  abort();
+}
+
+}  // namespace internal
+}  // namespace tensorflow
@@ -0,0 +1,174 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+// The LOG, VLOG and CHECK macros of tensorflow/core/platform/logging.h, which
+// write to stderr. As in TensorFlow, the TF_CPP_MIN_LOG_LEVEL and
+// TF_CPP_MIN_VLOG_LEVEL environment variables set the minimum severity and
+// verbosity of the messages.
+#ifndef TENSORFLOW_DATA_VALIDATION_CORE_LITE_PLATFORM_LOGGING_H_
+#define TENSORFLOW_DATA_VALIDATION_CORE_LITE_PLATFORM_LOGGING_H_
+
+#include <sstream>
+#include <string>
+#include <utility>
+
+#include "absl/base/attributes.h"
+#include "absl/base/optimization.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+const int INFO = 0;
+const int WARNING = 1;
+const int ERROR = 2;
+const int FATAL = 3;
+const int NUM_SEVERITIES = 4;
+
+namespace internal {
+
+class LogMessage : public std::basic_ostringstream<char> {
+ public:
+  LogMessage(const char* fname, int line, int severity);
+  ~LogMessage() override;
+
+  // Returns the minimum log level for VLOG statements.
+  static int64 MinVLogLevel();
+
+ protected:
+  void GenerateLogMessage();
+
+ private:
+  const char* fname_;
+  int line_;
+  int severity_;
+};
+
+// Aborts after logging the message.
+class LogMessageFatal : public LogMessage {
+ public:
+  LogMessageFatal(const char* file, int line);
+  ABSL_ATTRIBUTE_NORETURN ~LogMessageFatal() override;
+};
+
+// Turns a stream into void, to be used in ?: expressions.
+struct Voidifier {
+  template <typename T>
+  void operator&(const T&) const {}
+};
+
+template <typename T>
+T&& CheckNotNull(const char* file, int line, const char* exprtext, T&& t) {
+  if (t == nullptr) {
+    LogMessageFatal(file, line) << string(exprtext);
+  }
+  return std::forward<T>(t);
+}
+
+// The message of a failed CHECK_EQ, etc, if any.
+struct CheckOpString {
+  explicit CheckOpString(string* str) : str_(str) {}
+  explicit operator bool() const { return ABSL_PREDICT_FALSE(str_ != nullptr); }
+  string* str_;
+};
+
+template <typename T1, typename T2>
+string* MakeCheckOpString(const T1& v1, const T2& v2, const char* exprtext) {
+  std::ostringstream os;
+  os << exprtext << " (" << v1 << " vs. " << v2 << ")";
+  return new string(os.str());
+}
+
+#define TF_DEFINE_CHECK_OP_IMPL(name, op)                             \
+  template <typename T1, typename T2>                                 \
+  inline string* name(const T1& v1, const T2& v2, const char* exprtext) { \
+    if (ABSL_PREDICT_TRUE(v1 op v2)) {                                \
+      return nullptr;                                                 \
+    }                                                                 \
+    return ::tensorflow::internal::MakeCheckOpString(v1, v2, exprtext); \
+  }
+TF_DEFINE_CHECK_OP_IMPL(Check_EQ, ==)
+TF_DEFINE_CHECK_OP_IMPL(Check_NE, !=)
+TF_DEFINE_CHECK_OP_IMPL(Check_LE, <=)
+TF_DEFINE_CHECK_OP_IMPL(Check_LT, <)
+TF_DEFINE_CHECK_OP_IMPL(Check_GE, >=)
+TF_DEFINE_CHECK_OP_IMPL(Check_GT, >)
+#undef TF_DEFINE_CHECK_OP_IMPL
+
+}  // namespace internal
+}  // namespace tensorflow
+
+#define _TF_LOG_INFO \
+  ::tensorflow::internal::LogMessage(__FILE__, __LINE__, ::tensorflow::INFO)
+#define _TF_LOG_WARNING \
+  ::tensorflow::internal::LogMessage(__FILE__, __LINE__, ::tensorflow::WARNING)
+#define _TF_LOG_ERROR \
+  ::tensorflow::internal::LogMessage(__FILE__, __LINE__, ::tensorflow::ERROR)
+#define _TF_LOG_FATAL \
+  ::tensorflow::internal::LogMessageFatal(__FILE__, __LINE__)
+#define _TF_LOG_QFATAL _TF_LOG_FATAL
+
+#define LOG(severity) _TF_LOG_##severity
+
+#define VLOG_IS_ON(lvl) \
+  ((lvl) <= ::tensorflow::internal::LogMessage::MinVLogLevel())
+
+#define VLOG(level)                           \
+  ABSL_PREDICT_TRUE(!VLOG_IS_ON(level))       \
+  ? (void)0                                   \
+  : ::tensorflow::internal::Voidifier() &     \
+        ::tensorflow::internal::LogMessage(__FILE__, __LINE__, \
+                                           ::tensorflow::INFO)
+
+#define CHECK(condition)                 \
+  if (ABSL_PREDICT_FALSE(!(condition))) \
+  LOG(FATAL) << "Check failed: " #condition " "
+
+#define CHECK_OP_LOG(name, op, val1, val2)                            \
+  while (::tensorflow::internal::CheckOpString _result{             \
+      ::tensorflow::internal::name((val1), (val2),                  \
+                                   #val1 " " #op " " #val2)})       \
+  ::tensorflow::internal::LogMessageFatal(__FILE__, __LINE__) << *(_result.str_)
+
+#define CHECK_EQ(val1, val2) CHECK_OP_LOG(Check_EQ, ==, val1, val2)
+#define CHECK_NE(val1, val2) CHECK_OP_LOG(Check_NE, !=, val1, val2)
+#define CHECK_LE(val1, val2) CHECK_OP_LOG(Check_LE, <=, val1, val2)
+#define CHECK_LT(val1, val2) CHECK_OP_LOG(Check_LT, <, val1, val2)
+#define CHECK_GE(val1, val2) CHECK_OP_LOG(Check_GE, >=, val1, val2)
+#define CHECK_GT(val1, val2) CHECK_OP_LOG(Check_GT, >, val1, val2)
+#define CHECK_NOTNULL(val)                                   \
+  ::tensorflow::internal::CheckNotNull(__FILE__, __LINE__, \
+                                       "'" #val "' Must be non NULL", (val))
+
+#ifndef NDEBUG
+#define DCHECK(condition) CHECK(condition)
+#define DCHECK_EQ(val1, val2) CHECK_EQ(val1, val2)
+#define DCHECK_NE(val1, val2) CHECK_NE(val1, val2)
+#define DCHECK_LE(val1, val2) CHECK_LE(val1, val2)
+#define DCHECK_LT(val1, val2) CHECK_LT(val1, val2)
+#define DCHECK_GE(val1, val2) CHECK_GE(val1, val2)
+#define DCHECK_GT(val1, val2) CHECK_GT(val1, val2)
+#else
+#define DCHECK(condition) \
+  while (false && (condition)) LOG(FATAL)
+#define _TF_DCHECK_NOP(x, y) \
+  while (false && ((void)(x), (void)(y), 0)) LOG(FATAL)
+#define DCHECK_EQ(x, y) _TF_DCHECK_NOP(x, y)
+#define DCHECK_NE(x, y) _TF_DCHECK_NOP(x, y)
+#define DCHECK_LE(x, y) _TF_DCHECK_NOP(x, y)
+#define DCHECK_LT(x, y) _TF_DCHECK_NOP(x, y)
+#define DCHECK_GE(x, y) _TF_DCHECK_NOP(x, y)
+#define DCHECK_GT(x, y) _TF_DCHECK_NOP(x, y)
+#endif
+
+#endif  // TENSORFLOW_DATA_VALIDATION_CORE_LITE_PLATFORM_LOGGING_H_
@@ -0,0 +1,87 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+// The mutex, locks and condition variable of tensorflow/core/platform/mutex.h,
+// on absl::Mutex.
+#ifndef TENSORFLOW_DATA_VALIDATION_CORE_LITE_PLATFORM_MUTEX_H_
+#define TENSORFLOW_DATA_VALIDATION_CORE_LITE_PLATFORM_MUTEX_H_
+
+#include "absl/synchronization/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+
+class condition_variable;
+
+class LOCKABLE mutex {
+ public:
+  mutex() {}
+
+  void lock() EXCLUSIVE_LOCK_FUNCTION() { mu_.Lock(); }
+  bool try_lock() EXCLUSIVE_LOCK_FUNCTION() { return mu_.TryLock(); }
+  void unlock() UNLOCK_FUNCTION() { mu_.Unlock(); }
+
+  void lock_shared() SHARED_LOCK_FUNCTION() { mu_.ReaderLock(); }
+  bool try_lock_shared() SHARED_LOCK_FUNCTION() {
+    return mu_.ReaderTryLock();
+  }
+  void unlock_shared() UNLOCK_FUNCTION() { mu_.ReaderUnlock(); }
+
+ private:
+  friend class condition_variable;
+  absl::Mutex mu_;
+};
+
+class SCOPED_LOCKABLE mutex_lock {
+ public:
+  explicit mutex_lock(tensorflow::mutex& mu) EXCLUSIVE_LOCK_FUNCTION(mu)
+      : mu_(&mu) {
+    mu_->lock();
+  }
+  mutex_lock(const mutex_lock&) = delete;
+  mutex_lock& operator=(const mutex_lock&) = delete;
+  ~mutex_lock() UNLOCK_FUNCTION() { mu_->unlock(); }
+
+  tensorflow::mutex* mutex() { return mu_; }
+
+ private:
+  tensorflow::mutex* const mu_;
+};
+
+class SCOPED_LOCKABLE tf_shared_lock {
+ public:
+  explicit tf_shared_lock(mutex& mu) SHARED_LOCK_FUNCTION(mu) : mu_(&mu) {
+    mu_->lock_shared();
+  }
+  tf_shared_lock(const tf_shared_lock&) = delete;
+  tf_shared_lock& operator=(const tf_shared_lock&) = delete;
+  ~tf_shared_lock() UNLOCK_FUNCTION() { mu_->unlock_shared(); }
+
+ private:
+  mutex* const mu_;
+};
+
+class condition_variable {
+ public:
+  void wait(mutex_lock& lock) { cv_.Wait(&lock.mutex()->mu_); }
+  void notify_one() { cv_.Signal(); }
+  void notify_all() { cv_.SignalAll(); }
+
+ private:
+  absl::CondVar cv_;
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_DATA_VALIDATION_CORE_LITE_PLATFORM_MUTEX_H_
@@ -0,0 +1,76 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/platform/threadpool.h"
+
+#include <utility>
+
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+namespace thread {
+
+ThreadPool::ThreadPool(Env* env, const string& name, int num_threads)
+    : ThreadPool(env, ThreadOptions(), name, num_threads) {}
+
+ThreadPool::ThreadPool(Env* env, const ThreadOptions& thread_options,
+                       const string& name, int num_threads) {
+  CHECK_GE(num_threads, 1);
+  threads_.reserve(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    threads_.emplace_back(env->StartThread(thread_options, name,
+                                           [this]() { WorkerLoop(); }));
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    mutex_lock lock(mu_);
+    done_ = true;
+  }
+  work_available_.notify_all();
+  // Joins the threads, which first run the remaining work.
+  threads_.clear();
+}
+
+void ThreadPool::Schedule(std::function<void()> fn) {
+  {
+    mutex_lock lock(mu_);
+    work_.push_back(std::move(fn));
+  }
+  work_available_.notify_one();
+}
+
+int ThreadPool::NumThreads() const { return threads_.size(); }
+
+void ThreadPool::WorkerLoop() {
+  while (true) {
+    std::function<void()> fn;
+    {
+      mutex_lock lock(mu_);
+      while (work_.empty() && !done_) {
+        work_available_.wait(lock);
+      }
+      if (work_.empty()) {
+        return;
+      }
+      fn = std::move(work_.front());
+      work_.pop_front();
+    }
+    fn();
+  }
+}
+
+}  // namespace thread
+}  // namespace tensorflow
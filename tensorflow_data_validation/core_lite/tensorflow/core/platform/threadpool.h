@@ -0,0 +1,68 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+// A fixed-size thread pool with the interface of
+// tensorflow/core/platform/threadpool.h.
+#ifndef TENSORFLOW_DATA_VALIDATION_CORE_LITE_PLATFORM_THREADPOOL_H_
+#define TENSORFLOW_DATA_VALIDATION_CORE_LITE_PLATFORM_THREADPOOL_H_
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace thread {
+
+class ThreadPool {
+ public:
+  // Constructs a pool that contains <num_threads> threads with specified
+  // <name>. env->StartThread() is used to create individual threads.
+  ThreadPool(Env* env, const string& name, int num_threads);
+  ThreadPool(Env* env, const ThreadOptions& thread_options,
+             const string& name, int num_threads);
+
+  // Waits until all scheduled work has finished and then destroys the set of
+  // threads.
+  ~ThreadPool();
+
+  // Schedules fn() for execution in the pool of threads.
+  void Schedule(std::function<void()> fn);
+
+  // Returns the number of threads in the pool.
+  int NumThreads() const;
+
+ private:
+  void WorkerLoop();
+
+  mutex mu_;
+  condition_variable work_available_;
+  std::deque<std::function<void()>> work_ GUARDED_BY(mu_);
+  bool done_ GUARDED_BY(mu_) = false;
+  std::vector<std::unique_ptr<Thread>> threads_;
+
+  ThreadPool(const ThreadPool&) = delete;
+  void operator=(const ThreadPool&) = delete;
+};
+
+}  // namespace thread
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_DATA_VALIDATION_CORE_LITE_PLATFORM_THREADPOOL_H_
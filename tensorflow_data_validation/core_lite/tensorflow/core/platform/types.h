@@ -0,0 +1,38 @@
+/* Copyright 2020 Google LLC
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    https://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// The integral types of tensorflow/core/platform/types.h.
+#ifndef TENSORFLOW_DATA_VALIDATION_CORE_LITE_PLATFORM_TYPES_H_
+#define TENSORFLOW_DATA_VALIDATION_CORE_LITE_PLATFORM_TYPES_H_
+
+#include <cstdint>
+#include <string>
+
+namespace tensorflow {
+
+using std::string;
+
+typedef int8_t int8;
+typedef int16_t int16;
+typedef int32_t int32;
+typedef int64_t int64;
+typedef uint8_t uint8;
+typedef uint16_t uint16;
+typedef uint32_t uint32;
+typedef uint64_t uint64;
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_DATA_VALIDATION_CORE_LITE_PLATFORM_TYPES_H_
@@ -46,3 +46,13 @@ def tfdv_proto_library_py(name, proto_library, srcs = [], deps = [], visibility
         visibility = visibility,
         testonly = testonly,
     )
+
+def _tfdv_incompatible_target_impl(ctx):
+    fail(ctx.attr.message)
+
+# A target whose analysis fails with <message>, for the branches of a select
+# which a target does not support.
+tfdv_incompatible_target = rule(
+    implementation = _tfdv_incompatible_target_impl,
+    attrs = {"message": attr.string(mandatory = True)},
+)
@@ -0,0 +1,232 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "tensorflow_data_validation/pywrap/coders_submodule.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/string_view.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow_data_validation/coders/csv_chunk_decoder.h"
+#include "tensorflow_data_validation/coders/sequence_example_decoder.h"
+#include "tensorflow_metadata/proto/v0/path.pb.h"
+#include "tensorflow_metadata/proto/v0/schema.pb.h"
+#include "include/pybind11/pybind11.h"
+#include "include/pybind11/stl.h"
+
+namespace tensorflow {
+namespace data_validation {
+namespace py = pybind11;
+
+namespace {
+
+// Returns a view of the contents of a Python bytes object, without copying.
+absl::string_view AsStringView(const py::bytes& bytes) {
+  char* data;
+  Py_ssize_t size;
+  if (PyBytes_AsStringAndSize(bytes.ptr(), &data, &size) != 0) {
+    throw py::error_already_set();
+  }
+  return absl::string_view(data, size);
+}
+
+template <typename T>
+py::bytes AsBytes(const std::vector<T>& values) {
+  return py::bytes(reinterpret_cast<const char*>(values.data()),
+                   values.size() * sizeof(T));
+}
+
+std::vector<CsvColumnType> ToColumnTypes(const std::vector<int>& types) {
+  std::vector<CsvColumnType> result;
+  result.reserve(types.size());
+  for (int type : types) {
+    result.push_back(static_cast<CsvColumnType>(type));
+  }
+  return result;
+}
+
+}  // namespace
+
+void DefineCodersSubmodule(py::module main_module) {
+  auto m = main_module.def_submodule("coders");
+  m.doc() = "Native decoders of input data formats.";
+
+  py::class_<CsvChunkDecoder>(m, "CsvChunkDecoder")
+      .def(py::init([](int num_columns, char delimiter, bool skip_blank_lines,
+                       const std::vector<bool>& multivalent,
+                       char secondary_delimiter) {
+             CsvDecoderOptions options;
+             options.delimiter = delimiter;
+             options.skip_blank_lines = skip_blank_lines;
+             options.multivalent = multivalent;
+             options.secondary_delimiter = secondary_delimiter;
+             std::unique_ptr<CsvChunkDecoder> decoder;
+             const tensorflow::Status status = CsvChunkDecoder::Create(
+                 num_columns, std::move(options), &decoder);
+             if (!status.ok()) {
+               throw std::invalid_argument(status.ToString());
+             }
+             return decoder.release();
+           }))
+      // The buffer is any contiguous bytes-like object (e.g. a memoryview of
+      // the unread part of a bytearray), so that it is not copied.
+      .def("FindRecordsEnd",
+           [](const CsvChunkDecoder& decoder, const py::buffer& buffer,
+              bool at_eof) -> size_t {
+             const py::buffer_info info = buffer.request();
+             const absl::string_view buffer_view(
+                 static_cast<const char*>(info.ptr), info.size * info.itemsize);
+             py::gil_scoped_release release_gil;
+             return decoder.FindRecordsEnd(buffer_view, at_eof);
+           })
+      .def("InferTypes",
+           [](const CsvChunkDecoder& decoder, const py::bytes& chunk,
+              const std::vector<int>& types) -> std::vector<int> {
+             const absl::string_view chunk_view = AsStringView(chunk);
+             std::vector<CsvColumnType> column_types = ToColumnTypes(types);
+             tensorflow::Status status;
+             {
+               py::gil_scoped_release release_gil;
+               status = decoder.InferTypes(chunk_view, &column_types);
+             }
+             if (!status.ok()) {
+               throw std::runtime_error(status.ToString());
+             }
+             std::vector<int> result;
+             result.reserve(column_types.size());
+             for (CsvColumnType type : column_types) {
+               result.push_back(static_cast<int>(type));
+             }
+             return result;
+           })
+      .def("Decode",
+           [](const CsvChunkDecoder& decoder, const py::bytes& chunk,
+              const std::vector<int>& types) -> py::object {
+             const absl::string_view chunk_view = AsStringView(chunk);
+             std::vector<CsvColumn> columns;
+             int64 num_rows;
+             tensorflow::Status status;
+             {
+               py::gil_scoped_release release_gil;
+               status = decoder.Decode(chunk_view, ToColumnTypes(types),
+                                       &columns, &num_rows);
+             }
+             if (!status.ok()) {
+               throw std::runtime_error(status.ToString());
+             }
+             // Each column is returned as a tuple of (type, null_count,
+             // validity, offsets, values, string_offsets), where the last four
+             // are buffers in the Arrow memory layout.
+             py::list result_columns;
+             for (const CsvColumn& column : columns) {
+               py::bytes values;
+               py::object string_offsets = py::none();
+               switch (column.type) {
+                 case CsvColumnType::kInt:
+                   values = AsBytes(column.int_values);
+                   break;
+                 case CsvColumnType::kFloat:
+                   values = AsBytes(column.float_values);
+                   break;
+                 case CsvColumnType::kString:
+                   values = py::bytes(column.string_data);
+                   string_offsets = AsBytes(column.string_offsets);
+                   break;
+                 case CsvColumnType::kUnknown:
+                   break;
+               }
+               result_columns.append(py::make_tuple(
+                   static_cast<int>(column.type), column.null_count,
+                   AsBytes(column.validity), AsBytes(column.offsets), values,
+                   string_offsets));
+             }
+             return py::make_tuple(num_rows, result_columns);
+           });
+
+  py::class_<SequenceExampleDecoder>(m, "SequenceExampleDecoder")
+      .def(py::init([](const std::string& schema_proto_string,
+                       const std::string& sequence_feature_column_name) {
+             metadata::v0::Schema schema;
+             if (!schema.ParseFromString(schema_proto_string)) {
+               throw std::runtime_error("Failed to parse Schema.");
+             }
+             std::unique_ptr<SequenceExampleDecoder> decoder;
+             const tensorflow::Status status = SequenceExampleDecoder::Create(
+                 schema, sequence_feature_column_name, &decoder);
+             if (!status.ok()) {
+               throw std::runtime_error(status.ToString());
+             }
+             return decoder.release();
+           }))
+      .def("Decode",
+           [](const SequenceExampleDecoder& decoder,
+              const std::vector<py::bytes>& serialized_examples)
+               -> py::object {
+             std::vector<absl::string_view> views;
+             views.reserve(serialized_examples.size());
+             for (const py::bytes& serialized : serialized_examples) {
+               views.push_back(AsStringView(serialized));
+             }
+             std::vector<DecodedFeature> features;
+             tensorflow::Status status;
+             {
+               py::gil_scoped_release release_gil;
+               status = decoder.Decode(views, &features);
+             }
+             if (!status.ok()) {
+               throw std::runtime_error(status.ToString());
+             }
+             // Each feature is returned as a tuple of (path steps, type,
+             // validity, offsets, step_validity, step_offsets, values,
+             // bytes_offsets), where the last six are buffers in the Arrow
+             // memory layout, and step_* are None for context features.
+             py::list result_features;
+             for (const DecodedFeature& feature : features) {
+               py::bytes values;
+               py::object bytes_offsets = py::none();
+               switch (feature.type) {
+                 case metadata::v0::INT:
+                   values = AsBytes(feature.int_values);
+                   break;
+                 case metadata::v0::FLOAT:
+                   values = AsBytes(feature.float_values);
+                   break;
+                 default:
+                   values = py::bytes(feature.bytes_data);
+                   bytes_offsets = AsBytes(feature.bytes_offsets);
+                   break;
+               }
+               py::object step_validity = py::none();
+               py::object step_offsets = py::none();
+               if (!feature.step_offsets.empty()) {
+                 step_validity = AsBytes(feature.step_validity);
+                 step_offsets = AsBytes(feature.step_offsets);
+               }
+               const metadata::v0::Path path = feature.path.AsProto();
+               result_features.append(py::make_tuple(
+                   std::vector<std::string>(path.step().begin(),
+                                            path.step().end()),
+                   static_cast<int>(feature.type), AsBytes(feature.validity),
+                   AsBytes(feature.offsets), step_validity, step_offsets,
+                   values, bytes_offsets));
+             }
+             return py::make_tuple(serialized_examples.size(),
+                                   result_features);
+           });
+}
+
+}  // namespace data_validation
+}  // namespace tensorflow
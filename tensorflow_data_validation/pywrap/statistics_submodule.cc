@@ -0,0 +1,562 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "tensorflow_data_validation/pywrap/statistics_submodule.h"
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "absl/memory/memory.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "tensorflow_data_validation/anomalies/basic_stats_util.h"
+#include "tensorflow_data_validation/anomalies/columnar_statistics.h"
+#include "tensorflow_data_validation/anomalies/compact_statistics.h"
+#include "tensorflow_data_validation/anomalies/mergeable_sketches.h"
+#include "tensorflow_data_validation/anomalies/mutual_information.h"
+#include "tensorflow_data_validation/anomalies/partitioned_statistics.h"
+#include "tensorflow_data_validation/anomalies/path.h"
+#include "tensorflow_data_validation/anomalies/statistics_merge_util.h"
+#include "tensorflow_data_validation/anomalies/window_statistics_util.h"
+#include "tensorflow_metadata/proto/v0/path.pb.h"
+#include "tensorflow_metadata/proto/v0/statistics.pb.h"
+#include "include/pybind11/numpy.h"
+#include "include/pybind11/pybind11.h"
+#include "include/pybind11/stl.h"
+
+namespace tensorflow {
+namespace data_validation {
+namespace py = pybind11;
+
+namespace {
+
+// A numpy array of doubles, converted if needed.
+using DoubleArray =
+    py::array_t<double, py::array::c_style | py::array::forcecast>;
+// A numpy array of int64s, converted if needed.
+using Int64Array =
+    py::array_t<int64, py::array::c_style | py::array::forcecast>;
+// A numpy array of bytes, e.g. a null mask, converted if needed.
+using UInt8Array =
+    py::array_t<uint8, py::array::c_style | py::array::forcecast>;
+
+MutualInformationColumn ToMutualInformationColumn(const DoubleArray& values,
+                                                  bool is_discrete) {
+  MutualInformationColumn column;
+  column.values.assign(values.data(), values.data() + values.size());
+  column.is_discrete = is_discrete;
+  return column;
+}
+
+}  // namespace
+
+void DefineStatisticsSubmodule(py::module main_module) {
+  auto m = main_module.def_submodule("statistics");
+  m.doc() = "Statistics API.";
+
+  m.def("MergeDatasetFeatureStatistics",
+        [](const std::vector<std::string>& partial_statistics_proto_strings)
+            -> py::object {
+          std::string statistics_proto_string;
+          const tensorflow::Status status =
+              MergeDatasetFeatureStatistics(
+                  partial_statistics_proto_strings, &statistics_proto_string);
+          if (!status.ok()) {
+            throw std::runtime_error(status.ToString());
+          }
+          return py::bytes(statistics_proto_string);
+        });
+
+  m.def("MakeDatasetFeatureStatisticsList",
+        [](const std::vector<std::string>& statistics_proto_strings)
+            -> py::object {
+          std::string statistics_list_proto_string;
+          const tensorflow::Status status =
+              MakeDatasetFeatureStatisticsList(
+                  statistics_proto_strings, &statistics_list_proto_string);
+          if (!status.ok()) {
+            throw std::runtime_error(status.ToString());
+          }
+          return py::bytes(statistics_list_proto_string);
+        });
+
+  m.def("MergeAndFinalizeDatasetFeatureStatistics",
+        [](const std::vector<std::string>& partial_statistics_proto_strings)
+            -> py::object {
+          std::string statistics_list_proto_string;
+          const tensorflow::Status status =
+              MergeAndFinalizeDatasetFeatureStatistics(
+                  partial_statistics_proto_strings,
+                  &statistics_list_proto_string);
+          if (!status.ok()) {
+            throw std::runtime_error(status.ToString());
+          }
+          return py::bytes(statistics_list_proto_string);
+        });
+
+  py::class_<PresenceAndValencyStats>(m, "PresenceAndValencyStats")
+      .def(py::init<>())
+      .def_readwrite("num_non_missing",
+                     &PresenceAndValencyStats::num_non_missing)
+      .def_readwrite("min_num_values", &PresenceAndValencyStats::min_num_values)
+      .def_readwrite("max_num_values", &PresenceAndValencyStats::max_num_values)
+      .def_readwrite("total_num_values",
+                     &PresenceAndValencyStats::total_num_values)
+      .def_readwrite("weighted_num_non_missing",
+                     &PresenceAndValencyStats::weighted_num_non_missing)
+      .def_readwrite("weighted_total_num_values",
+                     &PresenceAndValencyStats::weighted_total_num_values);
+
+  py::class_<PartialBasicStats>(m, "PartialBasicStats")
+      .def(py::init<>())
+      .def_property(
+          "path",
+          [](const PartialBasicStats& stats) {
+            const metadata::v0::Path path = stats.path.AsProto();
+            return std::vector<std::string>(path.step().begin(),
+                                            path.step().end());
+          },
+          [](PartialBasicStats& stats, const std::vector<std::string>& steps) {
+            stats.path = Path(steps);
+          })
+      .def_property(
+          "type",
+          [](const PartialBasicStats& stats) -> py::object {
+            if (!stats.has_type) {
+              return py::none();
+            }
+            return py::int_(static_cast<int>(stats.type));
+          },
+          [](PartialBasicStats& stats, py::object type) {
+            stats.has_type = !type.is_none();
+            if (stats.has_type) {
+              stats.type = static_cast<metadata::v0::FeatureNameStatistics::Type>(
+                  type.cast<int>());
+            }
+          })
+      .def_readwrite("is_bytes", &PartialBasicStats::is_bytes)
+      .def_readwrite("is_categorical", &PartialBasicStats::is_categorical)
+      .def_readwrite("presence_and_valency_stats",
+                     &PartialBasicStats::presence_and_valency_stats)
+      .def_readwrite("num_values_quantiles",
+                     &PartialBasicStats::num_values_quantiles)
+      .def_readwrite("sum", &PartialBasicStats::sum)
+      .def_readwrite("sum_of_squares", &PartialBasicStats::sum_of_squares)
+      .def_readwrite("num_zeros", &PartialBasicStats::num_zeros)
+      .def_readwrite("num_nan", &PartialBasicStats::num_nan)
+      .def_readwrite("min", &PartialBasicStats::min)
+      .def_readwrite("max", &PartialBasicStats::max)
+      .def_readwrite("finite_min", &PartialBasicStats::finite_min)
+      .def_readwrite("finite_max", &PartialBasicStats::finite_max)
+      .def_readwrite("quantiles", &PartialBasicStats::quantiles)
+      .def_readwrite("weighted_sum", &PartialBasicStats::weighted_sum)
+      .def_readwrite("weighted_sum_of_squares",
+                     &PartialBasicStats::weighted_sum_of_squares)
+      .def_readwrite("weighted_total_num_values",
+                     &PartialBasicStats::weighted_total_num_values)
+      .def_readwrite("weighted_quantiles",
+                     &PartialBasicStats::weighted_quantiles)
+      .def_readwrite("total_bytes_length",
+                     &PartialBasicStats::total_bytes_length)
+      .def_readwrite("total_num_bytes", &PartialBasicStats::total_num_bytes)
+      .def_readwrite("min_num_bytes", &PartialBasicStats::min_num_bytes)
+      .def_readwrite("max_num_bytes", &PartialBasicStats::max_num_bytes);
+
+  m.def("MakeBasicStatistics",
+        [](const std::vector<PartialBasicStats>& features,
+           int num_values_histogram_buckets, int num_histogram_buckets,
+           int num_quantiles_histogram_buckets,
+           bool has_weights) -> py::object {
+          BasicStatsOptions options;
+          options.num_values_histogram_buckets = num_values_histogram_buckets;
+          options.num_histogram_buckets = num_histogram_buckets;
+          options.num_quantiles_histogram_buckets =
+              num_quantiles_histogram_buckets;
+          options.has_weights = has_weights;
+          metadata::v0::DatasetFeatureStatistics statistics;
+          std::string statistics_proto_string;
+          tensorflow::Status status;
+          {
+            py::gil_scoped_release release_gil;
+            status = MakeBasicStatistics(features, options, &statistics);
+            if (status.ok()) {
+              statistics.SerializeToString(&statistics_proto_string);
+            }
+          }
+          if (!status.ok()) {
+            throw std::runtime_error(status.ToString());
+          }
+          return py::bytes(statistics_proto_string);
+        });
+
+  m.def("WriteColumnarStatistics",
+        [](const std::string& statistics_list_proto_string) -> py::object {
+          metadata::v0::DatasetFeatureStatisticsList statistics;
+          if (!statistics.ParseFromString(statistics_list_proto_string)) {
+            throw std::runtime_error(
+                "Unable to parse the DatasetFeatureStatisticsList.");
+          }
+          std::string columnar;
+          tensorflow::Status status;
+          {
+            py::gil_scoped_release release_gil;
+            status = WriteColumnarStatistics(statistics, &columnar);
+          }
+          if (!status.ok()) {
+            throw std::runtime_error(status.ToString());
+          }
+          return py::bytes(columnar);
+        });
+
+  // Returns the serialized DatasetFeatureStatisticsList read from the
+  // columnar statistics file <filename>. <feature_paths> (a list of lists of
+  // steps) and <slice_keys> restrict the features and datasets read, unless
+  // they are None.
+  m.def("ReadColumnarStatistics",
+        [](const std::string& filename, py::object feature_paths,
+           py::object slice_keys, bool include_histograms,
+           bool include_custom_stats) -> py::object {
+          ColumnarStatisticsReadOptions options;
+          options.include_histograms = include_histograms;
+          options.include_custom_stats = include_custom_stats;
+          if (!feature_paths.is_none()) {
+            options.feature_paths.emplace();
+            for (const auto& steps :
+                 feature_paths.cast<std::vector<std::vector<std::string>>>()) {
+              options.feature_paths->insert(Path(steps));
+            }
+          }
+          const bool read_all_slices = slice_keys.is_none();
+          std::vector<std::string> selected_slices;
+          if (!read_all_slices) {
+            selected_slices = slice_keys.cast<std::vector<std::string>>();
+          }
+          std::string statistics_list_proto_string;
+          tensorflow::Status status;
+          {
+            py::gil_scoped_release release_gil;
+            status = [&]() -> tensorflow::Status {
+              std::unique_ptr<ColumnarStatisticsReader> reader;
+              TF_RETURN_IF_ERROR(
+                  ColumnarStatisticsReader::Open(filename, &reader));
+              metadata::v0::DatasetFeatureStatisticsList statistics;
+              if (read_all_slices) {
+                TF_RETURN_IF_ERROR(reader->ReadAll(options, &statistics));
+              } else {
+                for (const std::string& slice_key : selected_slices) {
+                  const int index = reader->FindDataset(slice_key);
+                  if (index < 0) {
+                    return errors::InvalidArgument("Invalid slice key: ",
+                                                   slice_key);
+                  }
+                  TF_RETURN_IF_ERROR(reader->ReadDataset(
+                      index, options, statistics.add_datasets()));
+                }
+              }
+              statistics.SerializeToString(&statistics_list_proto_string);
+              return tensorflow::Status::OK();
+            }();
+          }
+          if (!status.ok()) {
+            throw std::runtime_error(status.ToString());
+          }
+          return py::bytes(statistics_list_proto_string);
+        });
+
+  m.def("CompactStatisticsForValidation",
+        [](const std::string& statistics_list_proto_string,
+           bool keep_weighted_stats) -> py::object {
+          CompactStatisticsOptions options;
+          options.keep_weighted_stats = keep_weighted_stats;
+          std::string result;
+          tensorflow::Status status;
+          {
+            py::gil_scoped_release release_gil;
+            status = CompactStatisticsForValidation(
+                options, statistics_list_proto_string, &result);
+          }
+          if (!status.ok()) {
+            throw std::runtime_error(status.ToString());
+          }
+          return py::bytes(result);
+        });
+
+  m.def("MergeStatistics",
+        [](const std::vector<std::string>& statistics_list_proto_strings)
+            -> py::object {
+          std::string result;
+          tensorflow::Status status;
+          {
+            py::gil_scoped_release release_gil;
+            status = MergeStatistics(statistics_list_proto_strings, &result);
+          }
+          if (!status.ok()) {
+            throw std::runtime_error(status.ToString());
+          }
+          return py::bytes(result);
+        });
+
+  // Returns, for each feature, None or the tuple (MI, MI with shuffled
+  // labels). Discrete columns hold category codes, continuous columns NaN for
+  // the missing values.
+  m.def(
+      "ComputeMutualInformation",
+      [](const std::vector<DoubleArray>& features,
+         const std::vector<bool>& features_are_discrete,
+         const DoubleArray& label, bool label_is_discrete, int num_neighbors,
+         uint64 seed, int num_threads) -> py::list {
+        if (features.size() != features_are_discrete.size()) {
+          throw std::runtime_error(
+              "features and features_are_discrete must have the same size.");
+        }
+        std::vector<MutualInformationColumn> feature_columns;
+        for (int i = 0; i < features.size(); ++i) {
+          feature_columns.push_back(ToMutualInformationColumn(
+              features[i], features_are_discrete[i]));
+        }
+        const MutualInformationColumn label_column =
+            ToMutualInformationColumn(label, label_is_discrete);
+        MutualInformationOptions options;
+        options.num_neighbors = num_neighbors;
+        options.seed = seed;
+        options.num_threads = num_threads;
+        std::vector<absl::optional<MutualInformationResult>> results;
+        tensorflow::Status status;
+        {
+          py::gil_scoped_release release_gil;
+          status = ComputeMutualInformation(feature_columns, label_column,
+                                            options, &results);
+        }
+        if (!status.ok()) {
+          throw std::runtime_error(status.ToString());
+        }
+        py::list result;
+        for (const auto& feature_result : results) {
+          if (feature_result) {
+            result.append(
+                py::make_tuple(feature_result->mutual_information,
+                               feature_result->shuffled_mutual_information));
+          } else {
+            result.append(py::none());
+          }
+        }
+        return result;
+      },
+      py::arg("features"), py::arg("features_are_discrete"), py::arg("label"),
+      py::arg("label_is_discrete"), py::arg("num_neighbors") = 3,
+      py::arg("seed") = 0, py::arg("num_threads") = 0);
+
+  // The mergeable sketches of the values of a feature, which are embedded in
+  // its statistics as a custom statistic. Picklable, as a Beam accumulator.
+  py::class_<MergeableFeatureSketches>(m, "MergeableFeatureSketches")
+      .def(py::init([](int hyperloglog_precision, int kll_k,
+                       int top_values_capacity) {
+             FeatureSketchesOptions options;
+             options.hyperloglog_precision = hyperloglog_precision;
+             options.kll_k = kll_k;
+             options.top_values_capacity = top_values_capacity;
+             const tensorflow::Status status =
+                 ValidateFeatureSketchesOptions(options);
+             if (!status.ok()) {
+               throw std::invalid_argument(status.ToString());
+             }
+             return new MergeableFeatureSketches(options);
+           }),
+           py::arg("hyperloglog_precision") = 12, py::arg("kll_k") = 200,
+           py::arg("top_values_capacity") = 1000)
+      // The numpy array overloads are registered first, so that they are
+      // preferred over the list overloads for arrays.
+      .def("AddNumValues",
+           [](MergeableFeatureSketches& sketches,
+              const Int64Array& num_values) {
+             const int64* data = num_values.data();
+             const py::ssize_t size = num_values.size();
+             py::gil_scoped_release release_gil;
+             for (py::ssize_t i = 0; i < size; ++i) {
+               sketches.AddNumValues(data[i]);
+             }
+           })
+      .def("AddNumValues",
+           [](MergeableFeatureSketches& sketches,
+              const std::vector<int64>& num_values) {
+             for (const int64 value : num_values) {
+               sketches.AddNumValues(value);
+             }
+           })
+      .def("AddNumericValues",
+           [](MergeableFeatureSketches& sketches, const DoubleArray& values) {
+             const double* data = values.data();
+             const py::ssize_t size = values.size();
+             py::gil_scoped_release release_gil;
+             for (py::ssize_t i = 0; i < size; ++i) {
+               sketches.AddNumericValue(data[i]);
+             }
+           })
+      .def("AddNumericValues",
+           [](MergeableFeatureSketches& sketches,
+              const std::vector<double>& values) {
+             for (const double value : values) {
+               sketches.AddNumericValue(value);
+             }
+           })
+      // Adds the values of an Arrow binary-like array from its buffers: value
+      // i is data[offsets[i], offsets[i + 1]), and is skipped if is_null[i].
+      .def("AddStringValues",
+           [](MergeableFeatureSketches& sketches, const Int64Array& offsets,
+              const py::buffer& data, const UInt8Array& is_null) {
+             const py::buffer_info data_info = data.request();
+             const absl::string_view data_view(
+                 static_cast<const char*>(data_info.ptr),
+                 data_info.size * data_info.itemsize);
+             if (offsets.size() != is_null.size() + 1) {
+               throw std::invalid_argument(
+                   "Expected one more offset than null mask entries.");
+             }
+             const int64* offsets_data = offsets.data();
+             const uint8* is_null_data = is_null.data();
+             const py::ssize_t size = is_null.size();
+             const int64 data_size = data_view.size();
+             for (py::ssize_t i = 0; i < size; ++i) {
+               if (!is_null_data[i] &&
+                   (offsets_data[i] < 0 ||
+                    offsets_data[i] > offsets_data[i + 1] ||
+                    offsets_data[i + 1] > data_size)) {
+                 throw std::invalid_argument("Invalid string offsets.");
+               }
+             }
+             py::gil_scoped_release release_gil;
+             for (py::ssize_t i = 0; i < size; ++i) {
+               if (!is_null_data[i]) {
+                 sketches.AddStringValue(data_view.substr(
+                     offsets_data[i], offsets_data[i + 1] - offsets_data[i]));
+               }
+             }
+           })
+      // Adds int64 values as strings (i.e. their decimal representations),
+      // skipping value i if is_null[i].
+      .def("AddIntValuesAsStrings",
+           [](MergeableFeatureSketches& sketches, const Int64Array& values,
+              const UInt8Array& is_null) {
+             if (values.size() != is_null.size()) {
+               throw std::invalid_argument(
+                   "Expected as many null mask entries as values.");
+             }
+             const int64* data = values.data();
+             const uint8* is_null_data = is_null.data();
+             const py::ssize_t size = values.size();
+             py::gil_scoped_release release_gil;
+             for (py::ssize_t i = 0; i < size; ++i) {
+               if (!is_null_data[i]) {
+                 sketches.AddStringValue(absl::StrCat(data[i]));
+               }
+             }
+           })
+      .def("AddStringValues",
+           [](MergeableFeatureSketches& sketches,
+              const std::vector<std::string>& values) {
+             py::gil_scoped_release release_gil;
+             for (const std::string& value : values) {
+               sketches.AddStringValue(value);
+             }
+           })
+      .def("Merge",
+           [](MergeableFeatureSketches& sketches,
+              const MergeableFeatureSketches& other) {
+             const tensorflow::Status status = sketches.Merge(other);
+             if (!status.ok()) {
+               throw std::runtime_error(status.ToString());
+             }
+           })
+      // Returns the serialized CustomStatistic embedding the sketches.
+      .def("ToCustomStatistic",
+           [](const MergeableFeatureSketches& sketches) -> py::object {
+             FeatureSketches proto;
+             sketches.ToProto(&proto);
+             metadata::v0::FeatureNameStatistics feature;
+             SetFeatureSketches(proto, &feature);
+             return py::bytes(feature.custom_stats(0).SerializeAsString());
+           })
+      .def(py::pickle(
+          [](const MergeableFeatureSketches& sketches) {
+            FeatureSketches proto;
+            sketches.ToProto(&proto);
+            return py::bytes(proto.SerializeAsString());
+          },
+          [](const py::bytes& state) {
+            FeatureSketches proto;
+            if (!proto.ParseFromString(std::string(state))) {
+              throw std::runtime_error("Invalid FeatureSketches state.");
+            }
+            auto sketches = absl::make_unique<MergeableFeatureSketches>();
+            const tensorflow::Status status =
+                MergeableFeatureSketches::FromProto(proto, sketches.get());
+            if (!status.ok()) {
+              throw std::runtime_error(status.ToString());
+            }
+            return sketches.release();
+          }));
+
+  // Computes the meta-statistics of the custom statistics computed over the
+  // partitions of a dataset. Picklable, as a Beam accumulator.
+  py::class_<PartitionedStatisticsCombiner>(m,
+                                            "PartitionedStatisticsCombiner")
+      .def(py::init<>())
+      // Adds a serialized DatasetFeatureStatistics.
+      .def("Add",
+           [](PartitionedStatisticsCombiner& combiner,
+              const std::string& serialized_statistics) {
+             const tensorflow::Status status =
+                 combiner.Add(serialized_statistics);
+             if (!status.ok()) {
+               throw std::runtime_error(status.ToString());
+             }
+           })
+      .def("Merge", &PartitionedStatisticsCombiner::Merge)
+      // Returns a serialized DatasetFeatureStatistics.
+      .def("Summarize",
+           [](const PartitionedStatisticsCombiner& combiner,
+              int min_partitions_stat_presence) -> py::object {
+             return py::bytes(
+                 combiner.Summarize(min_partitions_stat_presence)
+                     .SerializeAsString());
+           },
+           py::arg("min_partitions_stat_presence"))
+      .def(py::pickle(
+          [](const PartitionedStatisticsCombiner& combiner) {
+            PartitionedStatisticsValues proto;
+            combiner.ToProto(&proto);
+            return py::bytes(proto.SerializeAsString());
+          },
+          [](const py::bytes& state) {
+            PartitionedStatisticsValues proto;
+            if (!proto.ParseFromString(std::string(state))) {
+              throw std::runtime_error(
+                  "Invalid PartitionedStatisticsValues state.");
+            }
+            auto combiner = absl::make_unique<PartitionedStatisticsCombiner>();
+            const tensorflow::Status status =
+                PartitionedStatisticsCombiner::FromProto(proto,
+                                                         combiner.get());
+            if (!status.ok()) {
+              throw std::runtime_error(status.ToString());
+            }
+            return combiner.release();
+          }));
+}
+
+}  // namespace data_validation
+}  // namespace tensorflow
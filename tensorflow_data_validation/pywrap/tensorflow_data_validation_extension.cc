@@ -19,6 +19,9 @@
 // pybind11). -fexception may harm performance and increase the binary size,
 // therefore do not put any non-trivial logic here.
 
+#include "tensorflow_data_validation/pywrap/coders_submodule.h"
+#include "tensorflow_data_validation/pywrap/statistics_submodule.h"
+#include "tensorflow_data_validation/pywrap/text_format_submodule.h"
 #include "tensorflow_data_validation/pywrap/validation_submodule.h"
 #include "include/pybind11/pybind11.h"
 
@@ -32,6 +35,9 @@ PYBIND11_MODULE(
     m) {
   m.doc() = "TensorFlow Data Validation extension module";
   DefineValidationSubmodule(m);
+  DefineStatisticsSubmodule(m);
+  DefineCodersSubmodule(m);
+  DefineTextFormatSubmodule(m);
 }
 
 }  // namespace data_validation
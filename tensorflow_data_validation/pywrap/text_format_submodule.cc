@@ -0,0 +1,70 @@
+// Copyright 2020 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     https://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "tensorflow_data_validation/pywrap/text_format_submodule.h"
+
+#include <string>
+
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow_data_validation/anomalies/text_format_util.h"
+#include "include/pybind11/pybind11.h"
+
+namespace tensorflow {
+namespace data_validation {
+namespace py = pybind11;
+
+void DefineTextFormatSubmodule(py::module main_module) {
+  auto m = main_module.def_submodule("text_format");
+  m.doc() = "Native proto text format API.";
+
+  // Parses a proto of the given full type name (e.g.
+  // "tensorflow.metadata.v0.Schema") from text format, and returns it
+  // serialized.
+  m.def("ParseTextProto",
+        [](const std::string& type_name,
+           const std::string& text) -> py::object {
+          std::string serialized_proto;
+          tensorflow::Status status;
+          {
+            py::gil_scoped_release release_gil;
+            status = ParseTextProtoToSerialized(type_name, text,
+                                                &serialized_proto);
+          }
+          if (!status.ok()) {
+            throw std::runtime_error(status.ToString());
+          }
+          return py::bytes(serialized_proto);
+        });
+
+  // Prints a serialized proto of the given full type name in text format,
+  // using num_threads threads (0 for the number of CPUs) for large protos.
+  m.def("PrintTextProto",
+        [](const std::string& type_name,
+           const std::string& serialized_proto,
+           int num_threads) -> py::object {
+          std::string text;
+          tensorflow::Status status;
+          {
+            py::gil_scoped_release release_gil;
+            status = PrintSerializedProtoAsText(type_name, serialized_proto,
+                                                num_threads, &text);
+          }
+          if (!status.ok()) {
+            throw std::runtime_error(status.ToString());
+          }
+          return py::str(text);
+        });
+}
+
+}  // namespace data_validation
+}  // namespace tensorflow
@@ -13,15 +13,67 @@
 // limitations under the License.
 #include "tensorflow_data_validation/pywrap/validation_submodule.h"
 
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "absl/memory/memory.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow_data_validation/anomalies/anomalies_util.h"
+#include "tensorflow_data_validation/anomalies/anomalous_examples.h"
 #include "tensorflow_data_validation/anomalies/feature_statistics_validator.h"
+#include "tensorflow_data_validation/anomalies/path.h"
+#include "tensorflow_data_validation/anomalies/proto/anomalous_examples.pb.h"
+#include "tensorflow_data_validation/anomalies/schema_index.h"
+#include "tensorflow_data_validation/anomalies/validation_server.h"
+#include "tensorflow_metadata/proto/v0/anomalies.pb.h"
 #include "include/pybind11/pybind11.h"
+#include "include/pybind11/stl.h"
 
 
 namespace tensorflow {
 namespace data_validation {
 namespace py = pybind11;
 
+namespace {
+
+// Returns the steps of each of <paths>.
+std::vector<std::vector<std::string>> GetSteps(const std::vector<Path>& paths) {
+  std::vector<std::vector<std::string>> result;
+  result.reserve(paths.size());
+  for (const Path& path : paths) {
+    result.push_back(path.steps());
+  }
+  return result;
+}
+
+// Parses a reservoir serialized by SerializeAnomalousExamplesReservoir.
+std::unique_ptr<AnomalousExamplesReservoir> ParseAnomalousExamplesReservoir(
+    const std::string& serialized) {
+  AnomalousExamples proto;
+  if (!proto.ParseFromString(serialized)) {
+    throw std::runtime_error("Failed to parse AnomalousExamples.");
+  }
+  auto reservoir = absl::make_unique<AnomalousExamplesReservoir>(0);
+  const tensorflow::Status status =
+      AnomalousExamplesReservoir::FromProto(proto, reservoir.get());
+  if (!status.ok()) {
+    throw std::runtime_error(status.ToString());
+  }
+  return reservoir;
+}
+
+py::bytes SerializeAnomalousExamplesReservoir(
+    const AnomalousExamplesReservoir& reservoir) {
+  AnomalousExamples proto;
+  reservoir.ToProto(&proto);
+  return py::bytes(proto.SerializeAsString());
+}
+
+}  // namespace
+
 void DefineValidationSubmodule(py::module main_module) {
   auto m = main_module.def_submodule("validation");
   m.doc() = "Validation API.";
@@ -55,6 +107,17 @@ void DefineValidationSubmodule(py::module main_module) {
           return py::bytes(output_schema_proto_string);
         });
 
+  m.def("SchemaFingerprint",
+        [](const std::string& schema_proto_string) -> py::object {
+          uint64 fingerprint;
+          const tensorflow::Status status =
+              GetSchemaFingerprint(schema_proto_string, &fingerprint);
+          if (!status.ok()) {
+            throw std::runtime_error(status.ToString());
+          }
+          return py::int_(fingerprint);
+        });
+
   m.def("ValidateFeatureStatistics",
         [](const std::string& statistics_proto_string,
            const std::string& schema_proto_string,
@@ -79,6 +142,238 @@ void DefineValidationSubmodule(py::module main_module) {
           }
           return py::bytes(anomalies_proto_string);
         });
+
+  // Validates the statistics in columnar statistics files, which are
+  // memory-mapped and only decoded as the validation reads them.
+  m.def("ValidateColumnarFeatureStatistics",
+        [](const std::string& statistics_path,
+           const std::string& schema_proto_string,
+           const std::string& environment,
+           const std::string& previous_span_statistics_path,
+           const std::string& serving_statistics_path,
+           const std::string& previous_version_statistics_path,
+           const std::string& feature_needed_string,
+           const std::string& validation_config_string,
+           const bool enable_diff_regions) -> py::object {
+          std::string anomalies_proto_string;
+          tensorflow::Status status;
+          {
+            py::gil_scoped_release release_gil;
+            status = ValidateColumnarFeatureStatisticsWithSerializedInputs(
+                statistics_path, schema_proto_string, environment,
+                previous_span_statistics_path, serving_statistics_path,
+                previous_version_statistics_path, feature_needed_string,
+                validation_config_string, enable_diff_regions,
+                &anomalies_proto_string);
+          }
+          if (!status.ok()) {
+            throw std::runtime_error(status.ToString());
+          }
+          return py::bytes(anomalies_proto_string);
+        });
+
+  m.def("ValidateFeatureStatisticsList",
+        [](const std::string& statistics_list_proto_string,
+           const std::string& schema_proto_string,
+           const std::string& environment,
+           const std::string& previous_span_statistics_list_proto_string,
+           const std::string& serving_statistics_list_proto_string,
+           const std::string& previous_version_statistics_list_proto_string,
+           const std::string& feature_needed_string,
+           const std::string& validation_config_string,
+           const bool enable_diff_regions) -> py::object {
+          std::map<std::string, std::string> anomalies_proto_strings;
+          tensorflow::Status status;
+          {
+            py::gil_scoped_release release_gil;
+            status = ValidateFeatureStatisticsListWithSerializedInputs(
+                statistics_list_proto_string, schema_proto_string,
+                environment, previous_span_statistics_list_proto_string,
+                serving_statistics_list_proto_string,
+                previous_version_statistics_list_proto_string,
+                feature_needed_string, validation_config_string,
+                enable_diff_regions, &anomalies_proto_strings);
+          }
+          if (!status.ok()) {
+            throw std::runtime_error(status.ToString());
+          }
+          py::dict result;
+          for (const auto& slice_anomalies : anomalies_proto_strings) {
+            result[py::str(slice_anomalies.first)] =
+                py::bytes(slice_anomalies.second);
+          }
+          return std::move(result);
+        });
+
+  // Removes the reasons of the given types from each of a list of serialized
+  // Anomalies protos, and returns the updated protos.
+  m.def("RemoveAnomalyTypes",
+        [](std::vector<std::string> anomalies_proto_strings,
+           const std::vector<int>& types_to_remove) -> py::object {
+          std::set<metadata::v0::AnomalyInfo::Type> types;
+          for (const int type : types_to_remove) {
+            types.insert(static_cast<metadata::v0::AnomalyInfo::Type>(type));
+          }
+          tensorflow::Status status;
+          {
+            py::gil_scoped_release release_gil;
+            status = RemoveAnomalyTypes(types, &anomalies_proto_strings);
+          }
+          if (!status.ok()) {
+            throw std::runtime_error(status.ToString());
+          }
+          py::list result;
+          for (const std::string& anomalies_proto_string :
+               anomalies_proto_strings) {
+            result.append(py::bytes(anomalies_proto_string));
+          }
+          return std::move(result);
+        });
+
+  // Returns the slice keys of the anomaly reasons of each of a list of
+  // serialized Anomalies protos.
+  m.def("GetAnomalyReasonSliceKeys",
+        [](const std::vector<std::string>& anomalies_proto_strings)
+            -> std::vector<std::vector<std::string>> {
+          std::vector<std::vector<std::string>> slice_keys;
+          tensorflow::Status status;
+          {
+            py::gil_scoped_release release_gil;
+            status =
+                GetAnomalyReasonSliceKeys(anomalies_proto_strings, &slice_keys);
+          }
+          if (!status.ok()) {
+            throw std::runtime_error(status.ToString());
+          }
+          return slice_keys;
+        });
+
+  // A connection to a validation server started with
+  // `validation_tool --mode=serve`. It can be shared by threads, as the
+  // client serializes the calls on the connection.
+  py::class_<ValidationClient>(m, "ValidationClient")
+      .def(py::init([](const std::string& socket_path) {
+             std::unique_ptr<ValidationClient> client;
+             const tensorflow::Status status =
+                 ValidationClient::Connect(socket_path, &client);
+             if (!status.ok()) {
+               throw std::runtime_error(status.ToString());
+             }
+             return client.release();
+           }))
+      .def("ValidateFeatureStatistics",
+           [](ValidationClient& client,
+              const std::string& statistics_proto_string,
+              const std::string& schema_proto_string,
+              const std::string& environment,
+              const std::string& previous_span_statistics_proto_string,
+              const std::string& serving_statistics_proto_string,
+              const std::string& previous_version_statistics_proto_string,
+              const std::string& validation_config_string,
+              const bool enable_diff_regions) -> py::object {
+             std::string anomalies_proto_string;
+             tensorflow::Status status;
+             {
+               py::gil_scoped_release release_gil;
+               status = client.ValidateWithSerializedInputs(
+                   statistics_proto_string, schema_proto_string, environment,
+                   previous_span_statistics_proto_string,
+                   serving_statistics_proto_string,
+                   previous_version_statistics_proto_string,
+                   validation_config_string, enable_diff_regions,
+                   &anomalies_proto_string);
+             }
+             if (!status.ok()) {
+               throw std::runtime_error(status.ToString());
+             }
+             return py::bytes(anomalies_proto_string);
+           });
+
+  // An index of the features and global string domains of a schema. The
+  // features are returned as the steps of their paths, and identified by
+  // their positions in their containers (see schema_index.h).
+  py::class_<SchemaIndex>(m, "SchemaIndex")
+      .def(py::init([](const std::string& schema_proto_string) {
+             std::unique_ptr<SchemaIndex> index;
+             const tensorflow::Status status =
+                 SchemaIndex::Create(schema_proto_string, &index);
+             if (!status.ok()) {
+               throw std::runtime_error(status.ToString());
+             }
+             return index.release();
+           }))
+      // Returns an empty list if there is no feature at the path.
+      .def("GetFeaturePositions",
+           [](const SchemaIndex& index,
+              const std::vector<std::string>& steps) -> std::vector<int> {
+             const std::vector<int>* positions =
+                 index.GetFeaturePositions(Path(steps));
+             return positions == nullptr ? std::vector<int>() : *positions;
+           })
+      .def("GetStringDomainPosition", &SchemaIndex::GetStringDomainPosition)
+      .def("LeafFeatures",
+           [](const SchemaIndex& index) {
+             return GetSteps(index.leaf_features());
+           })
+      .def("LeafFeaturePositions", &SchemaIndex::leaf_feature_positions)
+      .def("CategoricalFeatures",
+           [](const SchemaIndex& index) {
+             return GetSteps(index.categorical_features());
+           })
+      .def("CategoricalNumericFeatures",
+           [](const SchemaIndex& index) {
+             return GetSteps(index.categorical_numeric_features());
+           })
+      .def("MultivalentFeatures",
+           [](const SchemaIndex& index) {
+             return GetSteps(index.multivalent_features());
+           })
+      .def("BytesFeatures", [](const SchemaIndex& index) {
+        return GetSteps(index.bytes_features());
+      });
+
+  // Samples up to max_exemplars_per_slice exemplars of the anomalous examples
+  // of each slice (see anomalous_examples.h). Picklable, as a Beam
+  // accumulator.
+  py::class_<AnomalousExamplesReservoir>(m, "AnomalousExamplesReservoir")
+      .def(py::init<tensorflow::int64>(), py::arg("max_exemplars_per_slice"))
+      .def("Add",
+           [](AnomalousExamplesReservoir& reservoir,
+              const std::string& slice_key, const py::bytes& exemplar) {
+             reservoir.Add(slice_key, std::string(exemplar));
+           })
+      .def("Merge",
+           [](AnomalousExamplesReservoir& reservoir,
+              const AnomalousExamplesReservoir& other) {
+             const tensorflow::Status status = reservoir.Merge(other);
+             if (!status.ok()) {
+               throw std::runtime_error(status.ToString());
+             }
+           })
+      .def("GetSliceKeys", &AnomalousExamplesReservoir::GetSliceKeys)
+      .def("GetExemplars",
+           [](const AnomalousExamplesReservoir& reservoir,
+              const std::string& slice_key) {
+             py::list result;
+             for (const std::string& exemplar :
+                  reservoir.GetExemplars(slice_key)) {
+               result.append(py::bytes(exemplar));
+             }
+             return result;
+           })
+      .def("GetNumExamples", &AnomalousExamplesReservoir::GetNumExamples)
+      // Returns a serialized AnomalousExamples.
+      .def("Serialize", &SerializeAnomalousExamplesReservoir)
+      .def_static("Deserialize",
+                  [](const py::bytes& serialized) {
+                    return ParseAnomalousExamplesReservoir(serialized)
+                        .release();
+                  })
+      .def(py::pickle(&SerializeAnomalousExamplesReservoir,
+                      [](const py::bytes& state) {
+                        return ParseAnomalousExamplesReservoir(state)
+                            .release();
+                      }));
 }
 
 }  // namespace data_validation
@@ -60,8 +60,6 @@ from __future__ import division
 from __future__ import print_function
 
 import collections
-import itertools
-import math
 import sys
 from typing import Any, Dict, Iterable, List, Optional, Text
 
@@ -72,6 +70,7 @@ import six
 from tensorflow_data_validation import constants
 from tensorflow_data_validation import types
 from tensorflow_data_validation.arrow import arrow_util
+from tensorflow_data_validation.pywrap.tensorflow_data_validation_extension import statistics as statistics_pywrap
 from tensorflow_data_validation.statistics.generators import stats_generator
 from tensorflow_data_validation.utils import quantiles_util
 from tensorflow_data_validation.utils import schema_util
@@ -487,409 +486,118 @@ class _PartialBasicStats(object):
     self.bytes_stats = _PartialBytesStats()
 
 
-def _make_presence_and_valency_stats_protos(
-    parent_presence_and_valency: Optional[_PresenceAndValencyStats],
-    presence_and_valency: List[_PresenceAndValencyStats]
-    ) -> List[statistics_pb2.PresenceAndValencyStatistics]:
-  """Converts presence and valency stats to corresponding protos."""
-  result = []
-  # The top-level non-missing is computed by
-  # num_examples - top_level.num_non_missing (outside BasicStatsGenerator as
-  # num_examples cannot be computed here). For all other levels,
-  # it's previous_level.total_num_values - this_level.num_non_missing.
-  for prev_s, s in zip(
-      itertools.chain([parent_presence_and_valency], presence_and_valency),
-      presence_and_valency):
-    proto = statistics_pb2.PresenceAndValencyStatistics()
-    if prev_s is not None:
-      proto.num_missing = (prev_s.total_num_values - s.num_non_missing)
-    proto.num_non_missing = s.num_non_missing
-    if s.num_non_missing > 0:
-      proto.min_num_values = s.min_num_values
-      proto.max_num_values = s.max_num_values
-      proto.tot_num_values = s.total_num_values
-    result.append(proto)
+def _extract_quantiles(quantiles_combiner: quantiles_util.QuantilesCombiner,
+                       summary: Any) -> List[float]:
+  """Extracts the quantile boundaries from a quantiles summary."""
+  return quantiles_combiner.extract_output(summary).astype(np.float64).tolist()
+
+
+def _make_native_presence_and_valency_stats(
+    presence_and_valency: _PresenceAndValencyStats
+    ) -> statistics_pywrap.PresenceAndValencyStats:
+  """Converts presence and valency stats to their native counterpart."""
+  result = statistics_pywrap.PresenceAndValencyStats()
+  result.num_non_missing = presence_and_valency.num_non_missing
+  result.min_num_values = presence_and_valency.min_num_values
+  result.max_num_values = presence_and_valency.max_num_values
+  result.total_num_values = presence_and_valency.total_num_values
+  result.weighted_num_non_missing = (
+      presence_and_valency.weighted_num_non_missing)
+  result.weighted_total_num_values = (
+      presence_and_valency.weighted_total_num_values)
   return result
 
 
-def _make_weighted_presence_and_valency_stats_protos(
-    parent_presence_and_valency: Optional[_PresenceAndValencyStats],
-    presence_and_valency: List[_PresenceAndValencyStats]
-    ) -> List[statistics_pb2.WeightedCommonStatistics]:
-  """Converts weighted presence and valency stats to corresponding protos."""
-  result = []
-  # The top-level non-missing is computed by
-  # weighted_num_examples - top_level.weighted_num_non_missing (outside
-  # BasicStatsGenerator as num_examples cannot be computed here).
-  # For all other levels,
-  # it's (previous_level.weighted_total_num_values -
-  # this_level.weighted_num_non_missing).
-  for prev_s, s in zip(
-      itertools.chain([parent_presence_and_valency], presence_and_valency),
-      presence_and_valency):
-    proto = statistics_pb2.WeightedCommonStatistics()
-    if prev_s is not None:
-      proto.num_missing = (
-          prev_s.weighted_total_num_values - s.weighted_num_non_missing)
-    proto.num_non_missing = s.weighted_num_non_missing
-    proto.tot_num_values = s.weighted_total_num_values
-    if s.weighted_num_non_missing > 0:
-      proto.avg_num_values = (
-          s.weighted_total_num_values / s.weighted_num_non_missing)
-    result.append(proto)
-  return result
-
-
-def _make_common_stats_proto(
-    common_stats: _PartialCommonStats,
-    parent_common_stats: Optional[_PartialCommonStats],
-    q_combiner: quantiles_util.QuantilesCombiner,
-    num_values_histogram_buckets: int,
-    has_weights: bool
-) -> statistics_pb2.CommonStatistics:
-  """Convert the partial common stats into a CommonStatistics proto."""
-  result = statistics_pb2.CommonStatistics()
-  parent_presence_and_valency = None
-  if parent_common_stats is not None:
-    parent_presence_and_valency = (
-        _PresenceAndValencyStats()
-        if parent_common_stats.presence_and_valency_stats is None else
-        parent_common_stats.presence_and_valency_stats[-1])
-
-  presence_and_valency_stats = common_stats.presence_and_valency_stats
-  # the CommonStatistics already contains the presence and valency
-  # for a 1-nested feature.
-  if (presence_and_valency_stats is not None and
-      len(presence_and_valency_stats) > 1):
-    result.presence_and_valency_stats.extend(
-        _make_presence_and_valency_stats_protos(
-            parent_presence_and_valency,
-            common_stats.presence_and_valency_stats))
-    if has_weights:
-      result.weighted_presence_and_valency_stats.extend(
-          _make_weighted_presence_and_valency_stats_protos(
-              parent_presence_and_valency,
-              common_stats.presence_and_valency_stats))
-
-  top_level_presence_and_valency = (
-      _PresenceAndValencyStats()
-      if common_stats.presence_and_valency_stats is None else
-      common_stats.presence_and_valency_stats[0])
-  result.num_non_missing = top_level_presence_and_valency.num_non_missing
-
-  if parent_presence_and_valency is not None:
-    result.num_missing = (
-        parent_presence_and_valency.total_num_values -
-        top_level_presence_and_valency.num_non_missing)
-  result.tot_num_values = top_level_presence_and_valency.total_num_values
-
-  # TODO(b/79685042): Need to decide on what is the expected values for
-  # statistics like min_num_values, max_num_values, avg_num_values, when
-  # all the values for the feature are missing.
-  if top_level_presence_and_valency.num_non_missing > 0:
-    result.min_num_values = top_level_presence_and_valency.min_num_values
-    result.max_num_values = top_level_presence_and_valency.max_num_values
-    result.avg_num_values = (
-        top_level_presence_and_valency.total_num_values /
-        top_level_presence_and_valency.num_non_missing)
-
-    if common_stats.num_values_summaries is not None:
-      # Add num_values_histogram to the common stats proto.
-      num_values_quantiles = q_combiner.extract_output(
-          common_stats.num_values_summaries[0])
-      histogram = quantiles_util.generate_quantiles_histogram(
-          num_values_quantiles, top_level_presence_and_valency.num_non_missing,
-          num_values_histogram_buckets)
-      result.num_values_histogram.CopyFrom(histogram)
-
-  # Add weighted common stats to the proto.
-  if has_weights:
-    weighted_common_stats_proto = statistics_pb2.WeightedCommonStatistics(
-        num_non_missing=top_level_presence_and_valency.weighted_num_non_missing,
-        tot_num_values=top_level_presence_and_valency.weighted_total_num_values)
-    if parent_presence_and_valency is not None:
-      weighted_common_stats_proto.num_missing = (
-          parent_presence_and_valency.weighted_total_num_values -
-          top_level_presence_and_valency.weighted_num_non_missing)
-
-    if top_level_presence_and_valency.weighted_num_non_missing > 0:
-      weighted_common_stats_proto.avg_num_values = (
-          top_level_presence_and_valency.weighted_total_num_values /
-          top_level_presence_and_valency.weighted_num_non_missing)
-
-    result.weighted_common_stats.CopyFrom(
-        weighted_common_stats_proto)
-  return result
-
-
-def _make_numeric_stats_proto(
-    numeric_stats: _PartialNumericStats,
-    total_num_values: int,
-    quantiles_combiner: quantiles_util.QuantilesCombiner,
-    num_histogram_buckets: int,
-    num_quantiles_histogram_buckets: int,
-    has_weights: bool
-    ) -> statistics_pb2.NumericStatistics:
-  """Convert the partial numeric statistics into NumericStatistics proto."""
-  result = statistics_pb2.NumericStatistics()
-
-  if numeric_stats.num_nan > 0:
-    total_num_values -= numeric_stats.num_nan
-
-  if total_num_values == 0:
-    # If we only have nan values, we only set num_nan.
-    if numeric_stats.num_nan > 0:
-      result.histograms.add(type=statistics_pb2.Histogram.STANDARD).num_nan = (
-          numeric_stats.num_nan)
-      result.histograms.add(type=statistics_pb2.Histogram.QUANTILES).num_nan = (
-          numeric_stats.num_nan)
-    return result
-
-  mean = numeric_stats.sum / total_num_values
-  variance = max(
-      0, (numeric_stats.sum_of_squares / total_num_values) -
-      mean * mean)
-  result.mean = float(mean)
-  result.std_dev = math.sqrt(variance)
-  result.num_zeros = numeric_stats.num_zeros
-  result.min = float(numeric_stats.min)
-  result.max = float(numeric_stats.max)
-
-  # Extract the quantiles from the summary.
-  quantiles = quantiles_combiner.extract_output(
-      numeric_stats.quantiles_summary)
-
-  # Find the median from the quantiles and update the numeric stats proto.
-  result.median = float(quantiles_util.find_median(quantiles))
-
-  # Construct the equi-width histogram from the quantiles and add it to the
-  # numeric stats proto.
-  std_histogram = quantiles_util.generate_equi_width_histogram(
-      quantiles, numeric_stats.finite_min, numeric_stats.finite_max,
-      total_num_values, num_histogram_buckets)
-  std_histogram.num_nan = numeric_stats.num_nan
-  new_std_histogram = result.histograms.add()
-  new_std_histogram.CopyFrom(std_histogram)
-
-  # Construct the quantiles histogram from the quantiles and add it to the
-  # numeric stats proto.
-  q_histogram = quantiles_util.generate_quantiles_histogram(
-      quantiles, total_num_values, num_quantiles_histogram_buckets)
-  q_histogram.num_nan = numeric_stats.num_nan
-  new_q_histogram = result.histograms.add()
-  new_q_histogram.CopyFrom(q_histogram)
-
-  # Add weighted numeric stats to the proto.
-  if has_weights:
-    weighted_numeric_stats_proto = statistics_pb2.WeightedNumericStatistics()
-
-    if numeric_stats.weighted_total_num_values == 0:
-      weighted_mean = 0
-      weighted_variance = 0
-    else:
-      weighted_mean = (numeric_stats.weighted_sum /
-                       numeric_stats.weighted_total_num_values)
-      weighted_variance = max(0, (numeric_stats.weighted_sum_of_squares /
-                                  numeric_stats.weighted_total_num_values)
-                              - weighted_mean**2)
-    weighted_numeric_stats_proto.mean = weighted_mean
-    weighted_numeric_stats_proto.std_dev = math.sqrt(weighted_variance)
-
-    # Extract the weighted quantiles from the summary.
-    weighted_quantiles = quantiles_combiner.extract_output(
-        numeric_stats.weighted_quantiles_summary)
-
-    # Find the weighted median from the quantiles and update the proto.
-    weighted_numeric_stats_proto.median = float(
-        quantiles_util.find_median(weighted_quantiles))
-
-    # Construct the weighted equi-width histogram from the quantiles and
-    # add it to the numeric stats proto.
-    weighted_std_histogram = quantiles_util.generate_equi_width_histogram(
-        weighted_quantiles, numeric_stats.finite_min, numeric_stats.finite_max,
-        numeric_stats.weighted_total_num_values, num_histogram_buckets)
-    weighted_std_histogram.num_nan = numeric_stats.num_nan
-    weighted_numeric_stats_proto.histograms.extend([weighted_std_histogram])
-
-    # Construct the weighted quantiles histogram from the quantiles and
-    # add it to the numeric stats proto.
-    weighted_q_histogram = quantiles_util.generate_quantiles_histogram(
-        weighted_quantiles, numeric_stats.weighted_total_num_values,
-        num_quantiles_histogram_buckets)
-    weighted_q_histogram.num_nan = numeric_stats.num_nan
-    weighted_numeric_stats_proto.histograms.extend([weighted_q_histogram])
-
-    result.weighted_numeric_stats.CopyFrom(
-        weighted_numeric_stats_proto)
-  return result
-
-
-def _make_string_stats_proto(string_stats: _PartialStringStats,
-                             total_num_values: int
-                            ) -> statistics_pb2.StringStatistics:
-  """Convert the partial string statistics into StringStatistics proto."""
-  result = statistics_pb2.StringStatistics()
-  if total_num_values > 0:
-    result.avg_length = string_stats.total_bytes_length / total_num_values
-  return result
-
-
-def _make_bytes_stats_proto(bytes_stats: _PartialBytesStats,
-                            total_num_values: int
-                           ) -> statistics_pb2.BytesStatistics:
-  """Convert the partial bytes statistics into BytesStatistics proto."""
-  result = statistics_pb2.BytesStatistics()
-  if total_num_values > 0:
-    result.avg_num_bytes = bytes_stats.total_num_bytes / total_num_values
-    result.min_num_bytes = bytes_stats.min_num_bytes
-    result.max_num_bytes = bytes_stats.max_num_bytes
-  return result
-
-
-def _make_num_values_custom_stats_proto(
-    common_stats: _PartialCommonStats,
-    q_combiner: quantiles_util.QuantilesCombiner,
-    num_histogram_buckets: int,
-    ) -> List[statistics_pb2.CustomStatistic]:
-  """Returns a list of CustomStatistic protos that contains histograms.
-
-  Those histograms captures the distribution of number of values at each
-  nest level.
-
-  It will only create histograms for nest levels greater than 1. Because
-  the histogram of nest level 1 is already in
-  CommonStatistics.num_values_histogram.
-
-  Args:
-    common_stats: a _PartialCommonStats.
-    q_combiner: the QuantilesCombiners to extract the quantiles from summaries.
-    num_histogram_buckets: number of buckets in the histogram.
-  Returns:
-    a (potentially empty) list of statistics_pb2.CustomStatistic.
-  """
-  result = []
-  if common_stats.type is None:
-    return result
-  num_values_summaries = common_stats.num_values_summaries
-  presence_and_valency_stats = common_stats.presence_and_valency_stats
-  if num_values_summaries is None or presence_and_valency_stats is None:
-    return result
-
-  assert presence_and_valency_stats is not None
-  # The top level histogram is included in CommonStats -- skip.
-  for level, summary, parent_presence_and_valency in zip(
-      itertools.count(2), num_values_summaries[1:], presence_and_valency_stats):
-    num_values_quantiles = q_combiner.extract_output(
-        summary)
-    histogram = quantiles_util.generate_quantiles_histogram(
-        num_values_quantiles, parent_presence_and_valency.num_non_missing,
-        num_histogram_buckets)
-    proto = statistics_pb2.CustomStatistic()
-    proto.name = 'level_{}_value_list_length'.format(level)
-    proto.histogram.CopyFrom(histogram)
-    result.append(proto)
-  return result
-
-
-def _make_feature_stats_proto(
+def _make_native_partial_stats(
     feature_path: types.FeaturePath,
     basic_stats: _PartialBasicStats,
-    parent_basic_stats: Optional[_PartialBasicStats],
     num_values_q_combiner: quantiles_util.QuantilesCombiner,
     values_q_combiner: quantiles_util.QuantilesCombiner,
-    num_values_histogram_buckets: int,
-    num_histogram_buckets: int,
-    num_quantiles_histogram_buckets: int,
     is_bytes: bool, is_categorical: bool, has_weights: bool
-) -> statistics_pb2.FeatureNameStatistics:
-  """Convert the partial basic stats into a FeatureNameStatistics proto.
+) -> statistics_pywrap.PartialBasicStats:
+  """Converts the partial basic stats into their native counterpart.
+
+  Only the quantiles of the histograms that are output are extracted from the
+  quantiles summaries. The FeatureNameStatistics proto is then constructed
+  natively (see MakeBasicStatistics).
 
   Args:
     feature_path: The path of the feature.
     basic_stats: The partial basic stats associated with the feature.
-    parent_basic_stats: The partial basic stats of the parent of the feature.
     num_values_q_combiner: The quantiles combiner used to construct the
         quantiles histogram for the number of values in the feature.
     values_q_combiner: The quantiles combiner used to construct the
         histogram for the values in the feature.
-    num_values_histogram_buckets: Number of buckets in the quantiles
-        histogram for the number of values per feature.
-    num_histogram_buckets: Number of buckets in a standard
-        NumericStatistics.histogram with equal-width buckets.
-    num_quantiles_histogram_buckets: Number of buckets in a
-        quantiles NumericStatistics.histogram.
     is_bytes: A boolean indicating whether the feature is bytes.
     is_categorical: A boolean indicating whether the feature is categorical.
     has_weights: A boolean indicating whether a weight feature is specified.
 
   Returns:
-    A statistics_pb2.FeatureNameStatistics proto.
+    A statistics_pywrap.PartialBasicStats.
   """
-  # Create a new FeatureNameStatistics proto.
-  result = statistics_pb2.FeatureNameStatistics()
-  result.path.CopyFrom(feature_path.to_proto())
-  # Set the feature type.
-  # If we have a categorical feature, we preserve the type to be the original
-  # INT type. Currently we don't set the type if we cannot infer it, which
-  # happens when all the values are missing. We need to add an UNKNOWN type
-  # to the stats proto to handle this case.
-  if is_categorical:
-    result.type = statistics_pb2.FeatureNameStatistics.INT
-  elif is_bytes:
-    result.type = statistics_pb2.FeatureNameStatistics.BYTES
-  elif basic_stats.common_stats.type is None:
-    # If a feature is completely missing, we assume the type to be STRING.
-    result.type = statistics_pb2.FeatureNameStatistics.STRING
-  else:
-    result.type = basic_stats.common_stats.type
-
-  # Construct common statistics proto.
-  common_stats_proto = _make_common_stats_proto(
-      basic_stats.common_stats,
-      parent_basic_stats.common_stats
-      if parent_basic_stats is not None else None,
-      num_values_q_combiner,
-      num_values_histogram_buckets, has_weights)
-
-  # this is the total number of values at the leaf level.
-  total_num_values = (
-      0 if basic_stats.common_stats.presence_and_valency_stats is None else
-      basic_stats.common_stats.presence_and_valency_stats[-1].total_num_values)
-
-  # Copy the common stats into appropriate numeric/string stats.
-  # If the type is not set, we currently wrap the common stats
-  # within numeric stats.
+  result = statistics_pywrap.PartialBasicStats()
+  result.path = list(feature_path.steps())
+  result.type = basic_stats.common_stats.type
+  result.is_bytes = is_bytes
+  result.is_categorical = is_categorical
+
+  common_stats = basic_stats.common_stats
+  presence_and_valency_stats = common_stats.presence_and_valency_stats or []
+  result.presence_and_valency_stats = [
+      _make_native_presence_and_valency_stats(s)
+      for s in presence_and_valency_stats
+  ]
+  # The num values histogram of the top level is output if it has non-missing
+  # values, and those of the other levels if the type is known. Features
+  # without presence and valency stats are treated as always missing, as
+  # MakeBasicStatistics does.
+  top_level_num_non_missing = (
+      presence_and_valency_stats[0].num_non_missing
+      if presence_and_valency_stats else 0)
+  num_values_quantiles = []
+  if common_stats.num_values_summaries is not None:
+    for level, summary in enumerate(common_stats.num_values_summaries):
+      if (level == 0 and top_level_num_non_missing == 0 or
+          level > 0 and common_stats.type is None):
+        num_values_quantiles.append([])
+      else:
+        num_values_quantiles.append(
+            _extract_quantiles(num_values_q_combiner, summary))
+  result.num_values_quantiles = num_values_quantiles
+
   if is_bytes:
-    # Construct bytes statistics proto.
-    bytes_stats_proto = _make_bytes_stats_proto(
-        basic_stats.bytes_stats, common_stats_proto.tot_num_values)
-    # Add the common stats into bytes stats.
-    bytes_stats_proto.common_stats.CopyFrom(common_stats_proto)
-    result.bytes_stats.CopyFrom(bytes_stats_proto)
+    bytes_stats = basic_stats.bytes_stats
+    result.total_num_bytes = bytes_stats.total_num_bytes
+    result.min_num_bytes = bytes_stats.min_num_bytes
+    result.max_num_bytes = bytes_stats.max_num_bytes
   if (is_categorical or
-      result.type == statistics_pb2.FeatureNameStatistics.STRING):
-    # Construct string statistics proto.
-    string_stats_proto = _make_string_stats_proto(basic_stats.string_stats,
-                                                  total_num_values)
-    # Add the common stats into string stats.
-    string_stats_proto.common_stats.CopyFrom(common_stats_proto)
-    result.string_stats.CopyFrom(string_stats_proto)
-  elif result.type == statistics_pb2.FeatureNameStatistics.STRUCT:
-    result.struct_stats.common_stats.CopyFrom(common_stats_proto)
-  elif result.type in (statistics_pb2.FeatureNameStatistics.INT,
-                       statistics_pb2.FeatureNameStatistics.FLOAT):
-    # Construct numeric statistics proto.
-    numeric_stats_proto = _make_numeric_stats_proto(
-        basic_stats.numeric_stats, total_num_values, values_q_combiner,
-        num_histogram_buckets, num_quantiles_histogram_buckets, has_weights)
-    # Add the common stats into numeric stats.
-    numeric_stats_proto.common_stats.CopyFrom(common_stats_proto)
-    result.num_stats.CopyFrom(numeric_stats_proto)
-
-  result.custom_stats.extend(_make_num_values_custom_stats_proto(
-      basic_stats.common_stats,
-      num_values_q_combiner,
-      num_values_histogram_buckets))
+      common_stats.type is None or
+      common_stats.type == statistics_pb2.FeatureNameStatistics.STRING):
+    result.total_bytes_length = basic_stats.string_stats.total_bytes_length
+  elif common_stats.type in (statistics_pb2.FeatureNameStatistics.INT,
+                             statistics_pb2.FeatureNameStatistics.FLOAT):
+    numeric_stats = basic_stats.numeric_stats
+    result.sum = numeric_stats.sum
+    result.sum_of_squares = numeric_stats.sum_of_squares
+    result.num_zeros = numeric_stats.num_zeros
+    result.num_nan = numeric_stats.num_nan
+    result.min = numeric_stats.min
+    result.max = numeric_stats.max
+    result.finite_min = numeric_stats.finite_min
+    result.finite_max = numeric_stats.finite_max
+    total_num_values = (
+        0 if not presence_and_valency_stats else
+        presence_and_valency_stats[-1].total_num_values)
+    if total_num_values > numeric_stats.num_nan:
+      result.quantiles = _extract_quantiles(
+          values_q_combiner, numeric_stats.quantiles_summary)
+      if has_weights:
+        result.weighted_sum = numeric_stats.weighted_sum
+        result.weighted_sum_of_squares = numeric_stats.weighted_sum_of_squares
+        result.weighted_total_num_values = (
+            numeric_stats.weighted_total_num_values)
+        result.weighted_quantiles = _extract_quantiles(
+            values_q_combiner, numeric_stats.weighted_quantiles_summary)
   return result
 
 
@@ -1164,24 +872,21 @@ class BasicStatsGenerator(stats_generator.CombinerStatsGenerator):
     # Update TFDV telemetry.
     _update_tfdv_telemetry(accumulator)
 
-    # Create a new DatasetFeatureStatistics proto.
-    result = statistics_pb2.DatasetFeatureStatistics()
-
-    for feature_path, basic_stats in six.iteritems(accumulator):
-      # Construct the FeatureNameStatistics proto from the partial
-      # basic stats.
-      feature_stats_proto = _make_feature_stats_proto(
-          feature_path,
-          basic_stats,
-          accumulator.get(feature_path.parent()),
-          self._num_values_quantiles_combiner, self._values_quantiles_combiner,
-          self._num_values_histogram_buckets, self._num_histogram_buckets,
-          self._num_quantiles_histogram_buckets,
-          feature_path in self._bytes_features,
-          feature_path in self._categorical_features,
-          self._weight_feature is not None)
-      # Copy the constructed FeatureNameStatistics proto into the
-      # DatasetFeatureStatistics proto.
-      new_feature_stats_proto = result.features.add()
-      new_feature_stats_proto.CopyFrom(feature_stats_proto)
-    return result
+    # Construct the FeatureNameStatistics protos natively from the partial
+    # basic stats.
+    native_stats = [
+        _make_native_partial_stats(
+            feature_path,
+            basic_stats,
+            self._num_values_quantiles_combiner,
+            self._values_quantiles_combiner,
+            feature_path in self._bytes_features,
+            feature_path in self._categorical_features,
+            self._weight_feature is not None)
+        for feature_path, basic_stats in six.iteritems(accumulator)
+    ]
+    return statistics_pb2.DatasetFeatureStatistics.FromString(
+        statistics_pywrap.MakeBasicStatistics(
+            native_stats, self._num_values_histogram_buckets,
+            self._num_histogram_buckets, self._num_quantiles_histogram_buckets,
+            self._weight_feature is not None))
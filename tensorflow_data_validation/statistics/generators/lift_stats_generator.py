@@ -779,8 +779,11 @@ class _LiftStatsGenerator(beam.PTransform):
 
     # If a schema is provided, we can do some additional validation of the
     # provided y_feature and boundaries.
-    if self._schema is not None:
-      y_feature = schema_util.get_feature(self._schema, y_path)
+    schema_index = (
+        schema_util.SchemaIndex(self._schema)
+        if self._schema is not None else None)
+    if schema_index is not None:
+      y_feature = schema_index.get_feature(y_path)
       y_is_categorical = schema_util.is_categorical_feature(y_feature)
       if self._y_boundaries is not None:
         if y_is_categorical:
@@ -792,9 +795,8 @@ class _LiftStatsGenerator(beam.PTransform):
                            'y_path.')
     if x_paths is not None:
       self._x_paths = x_paths
-    elif self._schema is not None:
-      self._x_paths = (
-          set(schema_util.get_categorical_features(schema)) - set([y_path]))
+    elif schema_index is not None:
+      self._x_paths = schema_index.get_categorical_features() - set([y_path])
     else:
       raise ValueError('Either a schema or x_paths must be provided.')
 
@@ -0,0 +1,152 @@
+# Copyright 2020 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+"""Module that embeds mergeable sketches of the feature values in statistics.
+
+The sketches (a HyperLogLog of the distinct values, a SpaceSaving summary of
+the most frequent values and KLL quantiles of the values and of the number of
+values) are stored as a custom statistic of each feature. Statistics carrying
+them can be merged without the data with stats_util.merge_statistics, e.g. to
+validate a rolling window of spans, with the unique count, the top values and
+the histograms of the merged statistics computed from the merged sketches.
+"""
+
+from __future__ import absolute_import
+from __future__ import division
+
+from __future__ import print_function
+
+import numpy as np
+import pyarrow as pa
+from tensorflow_data_validation import types
+from tensorflow_data_validation.arrow import arrow_util
+from tensorflow_data_validation.pywrap.tensorflow_data_validation_extension import statistics as statistics_pywrap
+from tensorflow_data_validation.statistics.generators import stats_generator
+from tensorflow_data_validation.utils import schema_util
+from tensorflow_data_validation.utils import stats_util
+from tfx_bsl.arrow import array_util
+from typing import Iterable, Optional, Text
+
+from tensorflow_metadata.proto.v0 import schema_pb2
+from tensorflow_metadata.proto.v0 import statistics_pb2
+
+
+def _get_binary_array_buffers(values: pa.Array):
+  """Returns the offsets (as a numpy array) and data of a binary-like array."""
+  buffers = values.buffers()
+  offset_type = np.int64 if (
+      pa.types.is_large_binary(values.type) or
+      pa.types.is_large_unicode(values.type)) else np.int32
+  offsets = np.frombuffer(buffers[1], dtype=offset_type)[
+      values.offset:values.offset + len(values) + 1]
+  data = buffers[2] if buffers[2] is not None else b''
+  return offsets, data
+
+
+class MergeableSketchStatsGenerator(
+    stats_generator.CombinerFeatureStatsGenerator):
+  """Generates the mergeable sketches of the values of each feature."""
+
+  def __init__(self,
+               name: Text = 'MergeableSketchStatsGenerator',
+               schema: Optional[schema_pb2.Schema] = None,
+               hyperloglog_precision: int = 12,
+               kll_k: int = 200,
+               top_values_capacity: int = 1000) -> None:
+    """Initializes a mergeable sketch statistics generator.
+
+    Args:
+      name: An optional unique name associated with the statistics generator.
+      schema: An optional schema for the dataset, used to sketch categorical
+        int features as strings.
+      hyperloglog_precision: The number of index bits of the HyperLogLog
+        sketch of the distinct values, in [4, 18]. Its relative error is about
+        1.04 / sqrt(2^precision).
+      kll_k: The size of the largest compactor of the KLL quantiles sketches.
+      top_values_capacity: The number of values tracked by the SpaceSaving
+        sketch of the most frequent values.
+    """
+    super(MergeableSketchStatsGenerator, self).__init__(name, schema)
+    self._hyperloglog_precision = hyperloglog_precision
+    self._kll_k = kll_k
+    self._top_values_capacity = top_values_capacity
+    self._categorical_features = set(
+        schema_util.get_categorical_numeric_features(schema) if schema else [])
+
+  def create_accumulator(self) -> statistics_pywrap.MergeableFeatureSketches:
+    return statistics_pywrap.MergeableFeatureSketches(
+        self._hyperloglog_precision, self._kll_k, self._top_values_capacity)
+
+  def add_input(self, accumulator: statistics_pywrap.MergeableFeatureSketches,
+                feature_path: types.FeaturePath, feature_array: pa.Array
+               ) -> statistics_pywrap.MergeableFeatureSketches:
+    """Returns the result of folding a batch of inputs into accumulator.
+
+    Args:
+      accumulator: The current accumulator.
+      feature_path: The path of the feature.
+      feature_array: An arrow Array representing a batch of feature values
+        which should be added to the accumulator.
+
+    Returns:
+      The accumulator after updating the sketches for the batch of inputs.
+    """
+    feature_type = stats_util.get_feature_type_from_arrow_type(
+        feature_path, feature_array.type)
+    # Ignore null array.
+    if feature_type is None or not feature_array:
+      return accumulator
+    # Only the number of values of the outermost level is sketched.
+    if arrow_util.is_list_like(feature_array.type):
+      presence_mask = ~np.asarray(
+          array_util.GetArrayNullBitmapAsByteArray(feature_array)).view(np.bool)
+      num_values = np.asarray(
+          array_util.ListLengthsFromListArray(feature_array))
+      accumulator.AddNumValues(
+          num_values[presence_mask].astype(np.int64, copy=False))
+
+    values, _ = arrow_util.flatten_nested(feature_array)
+    if not values:
+      return accumulator
+    # The values are passed to the sketches as numpy arrays or Arrow buffers,
+    # without converting them to Python objects.
+    is_null = np.asarray(array_util.GetArrayNullBitmapAsByteArray(values))
+    if feature_type == statistics_pb2.FeatureNameStatistics.STRING:
+      offsets, data = _get_binary_array_buffers(values)
+      accumulator.AddStringValues(offsets, data, is_null)
+    elif feature_path in self._categorical_features:
+      # The values of null slots are arbitrary, and skipped.
+      int_values = np.frombuffer(
+          values.buffers()[1], dtype=values.type.to_pandas_dtype())[
+              values.offset:values.offset + len(values)]
+      accumulator.AddIntValuesAsStrings(int_values, is_null)
+    else:
+      accumulator.AddNumericValues(
+          np.asarray(values.to_numpy(), dtype=np.float64))
+    return accumulator
+
+  def merge_accumulators(
+      self,
+      accumulators: Iterable[statistics_pywrap.MergeableFeatureSketches]
+  ) -> statistics_pywrap.MergeableFeatureSketches:
+    result = self.create_accumulator()
+    for accumulator in accumulators:
+      result.Merge(accumulator)
+    return result
+
+  def extract_output(self,
+                     accumulator: statistics_pywrap.MergeableFeatureSketches
+                    ) -> statistics_pb2.FeatureNameStatistics:
+    result = statistics_pb2.FeatureNameStatistics()
+    result.custom_stats.add().MergeFromString(accumulator.ToCustomStatistic())
+    return result
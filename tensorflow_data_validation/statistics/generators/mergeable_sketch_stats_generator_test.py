@@ -0,0 +1,109 @@
+# Copyright 2020 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+"""Tests for mergeable_sketch_stats_generator."""
+
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+
+import pickle
+
+from absl.testing import absltest
+import pyarrow as pa
+from tensorflow_data_validation import types
+from tensorflow_data_validation.statistics.generators import mergeable_sketch_stats_generator
+from tensorflow_data_validation.utils import stats_util
+
+from tensorflow_metadata.proto.v0 import statistics_pb2
+
+_SKETCHES_STAT_NAME = 'tfdv_mergeable_sketches'
+
+
+def _make_stats(feature_stats, num_examples):
+  result = statistics_pb2.DatasetFeatureStatisticsList()
+  dataset = result.datasets.add(num_examples=num_examples)
+  dataset.features.add().CopyFrom(feature_stats)
+  return result
+
+
+class MergeableSketchStatsGeneratorTest(absltest.TestCase):
+
+  def _generate(self, generator, path, batches):
+    accumulators = []
+    for batch in batches:
+      accumulators.append(generator.add_input(generator.create_accumulator(),
+                                              path, batch))
+    # Accumulators are pickled between the stages of a Beam pipeline.
+    accumulators = [pickle.loads(pickle.dumps(a)) for a in accumulators]
+    return generator.extract_output(
+        generator.merge_accumulators(accumulators))
+
+  def test_embeds_sketches(self):
+    generator = mergeable_sketch_stats_generator.MergeableSketchStatsGenerator()
+    path = types.FeaturePath(['a'])
+    result = self._generate(
+        generator, path,
+        [pa.array([['x', 'y'], ['x']]), pa.array([None, ['z']])])
+    self.assertLen(result.custom_stats, 1)
+    self.assertEqual(result.custom_stats[0].name, _SKETCHES_STAT_NAME)
+    self.assertTrue(result.custom_stats[0].str)
+
+  def test_merged_statistics_use_sketches(self):
+    generator = mergeable_sketch_stats_generator.MergeableSketchStatsGenerator()
+    path = types.FeaturePath(['a'])
+    stats_list = []
+    for batch in [pa.array([['x', 'y'], ['x']]), pa.array([['x'], ['z']])]:
+      feature_stats = self._generate(generator, path, [batch])
+      feature_stats.path.CopyFrom(path.to_proto())
+      feature_stats.type = statistics_pb2.FeatureNameStatistics.STRING
+      feature_stats.string_stats.common_stats.num_non_missing = 2
+      stats_list.append(_make_stats(feature_stats, 2))
+    merged = stats_util.merge_statistics(stats_list)
+    string_stats = merged.datasets[0].features[0].string_stats
+    self.assertEqual(merged.datasets[0].num_examples, 4)
+    self.assertEqual(string_stats.common_stats.num_non_missing, 4)
+    self.assertEqual(string_stats.unique, 3)
+    self.assertEqual(string_stats.top_values[0].value, 'x')
+    self.assertEqual(string_stats.top_values[0].frequency, 3)
+
+  def test_sliced_values_with_nulls(self):
+    generator = mergeable_sketch_stats_generator.MergeableSketchStatsGenerator()
+    path = types.FeaturePath(['a'])
+    # The values are read from the Arrow buffers, which the slice shares.
+    batch = pa.array([['w'], ['x', None, 'y'], ['x'], ['z']]).slice(1, 2)
+    stats_list = []
+    for _ in range(2):
+      feature_stats = self._generate(generator, path, [batch])
+      feature_stats.path.CopyFrom(path.to_proto())
+      feature_stats.type = statistics_pb2.FeatureNameStatistics.STRING
+      feature_stats.string_stats.common_stats.num_non_missing = 2
+      stats_list.append(_make_stats(feature_stats, 2))
+    string_stats = stats_util.merge_statistics(
+        stats_list).datasets[0].features[0].string_stats
+    self.assertEqual(string_stats.unique, 2)
+    self.assertEqual(string_stats.top_values[0].value, 'x')
+    self.assertEqual(string_stats.top_values[0].frequency, 4)
+
+  def test_invalid_parameters(self):
+    for kwargs in ({'hyperloglog_precision': 3}, {'kll_k': 0},
+                   {'top_values_capacity': -1}):
+      generator = (
+          mergeable_sketch_stats_generator.MergeableSketchStatsGenerator(
+              **kwargs))
+      with self.assertRaises(ValueError):
+        generator.create_accumulator()
+
+
+if __name__ == '__main__':
+  absltest.main()
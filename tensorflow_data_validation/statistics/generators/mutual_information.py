@@ -0,0 +1,217 @@
+# Copyright 2020 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+"""Module that computes Mutual Information with a native k-NN estimator.
+
+The estimators are those of sk-learn's mutual_info_classif and
+mutual_info_regression, implemented natively: all the features of a partition
+are estimated in a single multithreaded pass, together with the MI with
+shuffled labels used for the adjusted MI, and without scikit-learn.
+"""
+
+from __future__ import absolute_import
+from __future__ import division
+
+from __future__ import print_function
+
+import numpy as np
+import pyarrow as pa
+from tensorflow_data_validation import types
+from tensorflow_data_validation.arrow import arrow_util
+from tensorflow_data_validation.pywrap.tensorflow_data_validation_extension import statistics as statistics_pywrap
+from tensorflow_data_validation.statistics.generators import partitioned_stats_generator
+from tensorflow_data_validation.utils import schema_util
+from tensorflow_data_validation.utils import stats_util
+from typing import Union
+
+from tensorflow_metadata.proto.v0 import schema_pb2
+from tensorflow_metadata.proto.v0 import statistics_pb2
+
+MUTUAL_INFORMATION_KEY = "mutual_information"
+ADJUSTED_MUTUAL_INFORMATION_KEY = "adjusted_mutual_information"
+
+
+def remove_unsupported_feature_columns(
+    examples: pa.RecordBatch,
+    schema: Union[schema_pb2.Schema, schema_util.SchemaIndex]
+) -> pa.RecordBatch:
+  """Removes feature columns that contain unsupported values.
+
+  All feature columns that are multivalent are dropped since they are
+  not supported by the MI estimators.
+
+  All columns of STRUCT type are also dropped, as are the columns that are not
+  in the schema.
+
+  Args:
+    examples: Arrow RecordBatch containing a batch of examples.
+    schema: The schema for the data, or its SchemaIndex.
+
+  Returns:
+    Arrow RecordBatch.
+  """
+  if not isinstance(schema, schema_util.SchemaIndex):
+    schema = schema_util.SchemaIndex(schema)
+  columns = set(examples.schema.names)
+  schema_features = set([
+      feature_path for (feature_path, _) in schema.get_all_leaf_features()
+  ])
+
+  multivalent_features = schema.get_multivalent_features()
+  unsupported_columns = set()
+  for f in multivalent_features:
+    # Drop the column if they were in the examples.
+    if f.steps()[0] in columns:
+      unsupported_columns.add(f.steps()[0])
+  for column_name, column in zip(examples.schema.names,
+                                 examples.columns):
+    # only support 1-nested non-struct arrays.
+    column_type = column.type
+    if (arrow_util.get_nest_level(column_type) != 1 or
+        stats_util.get_feature_type_from_arrow_type(
+            types.FeaturePath([column_name]), column_type)
+        == statistics_pb2.FeatureNameStatistics.STRUCT):
+      unsupported_columns.add(column_name)
+    # Drop columns that were not in the schema.
+    if types.FeaturePath([column_name]) not in schema_features:
+      unsupported_columns.add(column_name)
+
+  supported_columns = []
+  supported_column_names = []
+  for column_name, column in zip(examples.schema.names,
+                                 examples.columns):
+    if column_name not in unsupported_columns:
+      supported_columns.append(column)
+      supported_column_names.append(column_name)
+
+  return pa.RecordBatch.from_arrays(supported_columns, supported_column_names)
+
+
+def _to_column(feature_array: pa.Array, num_rows: int,
+               is_categorical: bool) -> np.ndarray:
+  """Converts a univalent feature column to one value per example.
+
+  Missing values are NaN. The values of categorical features are replaced by
+  the codes of a hash-based dictionary encoding.
+
+  Args:
+    feature_array: An arrow Array of lists of at most one value.
+    num_rows: The number of examples.
+    is_categorical: Whether the feature is categorical.
+
+  Returns:
+    A 1D numpy array of doubles.
+  """
+  result = np.full(num_rows, np.nan)
+  if pa.types.is_null(feature_array.type):
+    return result
+  flattened_array, non_missing_parent_indices = arrow_util.flatten_nested(
+      feature_array, return_parent_indices=True)
+  if is_categorical:
+    flattened_array = flattened_array.dictionary_encode().indices
+  result[non_missing_parent_indices] = np.asarray(
+      flattened_array, dtype=np.float64)
+  return result
+
+
+class MutualInformation(partitioned_stats_generator.PartitionedStatsFn):
+  """Computes Mutual Information(MI) between each feature and the label.
+
+  Adjusted Mutual Information(AMI) and MI are estimated between all valid
+  features and the label, as by SkLearnMutualInformation. AMI prevents
+  overestimation of MI for high entropy features. It is defined as
+  MI(feature, labels) - MI(feature, shuffled labels).
+
+  MutualInformation will "gracefully fail" on all features that are
+  multivalent. The compute method will not report statistics for these invalid
+  features.
+  """
+
+  def __init__(self, label_feature: types.FeaturePath,
+               schema: schema_pb2.Schema, seed: int,
+               num_neighbors: int = 3, num_threads: int = 0):
+    """Initializes MutualInformation.
+
+    Args:
+      label_feature: The key used to identify labels in the ExampleBatch.
+      schema: The schema of the dataset.
+      seed: An int value to seed the RNG used in MI computation.
+      num_neighbors: The number of neighbors of the k-NN estimators.
+      num_threads: The number of threads the features are split between. If
+        0, the number of cores is used.
+
+    Raises:
+      ValueError: If label_feature does not exist in the schema.
+    """
+    self._label_feature = label_feature
+    self._schema = schema
+    self._schema_index = schema_util.SchemaIndex(schema)
+    self._categorical_features = self._schema_index.get_categorical_features()
+    assert self._schema_index.get_feature(self._label_feature)
+    self._label_feature_is_categorical = (
+        self._label_feature in self._categorical_features)
+    self._seed = seed
+    self._num_neighbors = num_neighbors
+    self._num_threads = num_threads
+
+  def compute(self, examples: pa.RecordBatch
+             ) -> statistics_pb2.DatasetFeatureStatistics:
+    """Computes MI and AMI between all valid features and labels.
+
+    Args:
+      examples: Arrow RecordBatch containing a batch of examples.
+
+    Returns:
+      DatasetFeatureStatistics proto containing AMI and MI for each valid
+        feature in the dataset. Some features may filtered out by
+        remove_unsupported_feature_columns if they are inavlid. In this case,
+        AMI and MI will not be calculated for the invalid feature.
+
+    Raises:
+      ValueError: If label_feature contains unsupported data.
+    """
+    examples = remove_unsupported_feature_columns(examples,
+                                                  self._schema_index)
+    label = None
+    feature_paths = []
+    features = []
+    features_are_discrete = []
+    for column_name, feature_array in zip(examples.schema.names,
+                                          examples.columns):
+      feature_path = types.FeaturePath([column_name])
+      is_categorical = feature_path in self._categorical_features
+      column = _to_column(feature_array, examples.num_rows, is_categorical)
+      if feature_path == self._label_feature:
+        label = column
+      else:
+        feature_paths.append(feature_path)
+        features.append(column)
+        features_are_discrete.append(is_categorical)
+    if label is None:
+      raise ValueError("Label column contains unsupported data.")
+
+    mi_per_feature = statistics_pywrap.ComputeMutualInformation(
+        features, features_are_discrete, label,
+        self._label_feature_is_categorical, self._num_neighbors, self._seed,
+        self._num_threads)
+    result = {}
+    for feature_path, mi in zip(feature_paths, mi_per_feature):
+      if mi is None:
+        continue
+      mutual_information, shuffled_mutual_information = mi
+      result[feature_path] = {
+          MUTUAL_INFORMATION_KEY: mutual_information,
+          ADJUSTED_MUTUAL_INFORMATION_KEY: (
+              mutual_information - shuffled_mutual_information)
+      }
+    return stats_util.make_dataset_feature_stats_proto(result)
@@ -0,0 +1,158 @@
+# Copyright 2020 Google LLC
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+"""Tests for the native Mutual Information statistics."""
+
+from __future__ import absolute_import
+from __future__ import division
+from __future__ import print_function
+
+from absl.testing import absltest
+import numpy as np
+import pyarrow as pa
+from tensorflow_data_validation import types
+from tensorflow_data_validation.statistics.generators import mutual_information
+
+from google.protobuf import text_format
+from tensorflow.python.util.protobuf import compare
+from tensorflow_metadata.proto.v0 import schema_pb2
+from tensorflow_metadata.proto.v0 import statistics_pb2
+
+TEST_SEED = 10
+
+_SCHEMA = text_format.Parse(
+    """
+    feature {
+      name: "label_key"
+      type: INT
+      int_domain {
+        is_categorical: true
+      }
+      shape {
+        dim {
+          size: 1
+        }
+      }
+    }
+    feature {
+      name: "perfect_feature"
+      type: BYTES
+      shape {
+        dim {
+          size: 1
+        }
+      }
+    }
+    feature {
+      name: "float_feature"
+      type: FLOAT
+      shape {
+        dim {
+          size: 1
+        }
+      }
+    }
+    feature {
+      name: "multivalent_feature"
+      type: INT
+      value_count: {
+        min: 2
+        max: 2
+      }
+    }
+    """, schema_pb2.Schema())
+
+
+class MutualInformationTest(absltest.TestCase):
+  """Tests for MutualInformation."""
+
+  def _compute(self, batch, schema=_SCHEMA):
+    return mutual_information.MutualInformation(
+        types.FeaturePath(["label_key"]), schema, TEST_SEED).compute(batch)
+
+  def test_mi_classif_with_categorical_feature(self):
+    label_array = pa.array([
+        [0], [2], [0], [1], [2], [1], [1], [0], [2], [1], [0]])
+    # A categorical feature that maps directly on to the label.
+    perfect_feat_array = pa.array([
+        ["Red"], ["Blue"], ["Red"], ["Green"], ["Blue"], ["Green"], ["Green"],
+        ["Red"], ["Blue"], ["Green"], ["Red"]])
+    batch = pa.RecordBatch.from_arrays([label_array, perfect_feat_array],
+                                       ["label_key", "perfect_feature"])
+    actual = self._compute(batch)
+    self.assertLen(actual.features, 1)
+    feature = actual.features[0]
+    self.assertEqual(feature.path.step, ["perfect_feature"])
+    custom_stats = {s.name: s.num for s in feature.custom_stats}
+    # The MI is the entropy of the labels, as given by sk-learn.
+    self.assertAlmostEqual(
+        custom_stats[mutual_information.MUTUAL_INFORMATION_KEY], 1.0900597)
+    self.assertLess(
+        custom_stats[mutual_information.ADJUSTED_MUTUAL_INFORMATION_KEY],
+        custom_stats[mutual_information.MUTUAL_INFORMATION_KEY])
+
+  def test_mi_classif_with_imputed_numeric_feature(self):
+    np.random.seed(TEST_SEED)
+    labels = np.random.randint(2, size=500)
+    # A float feature separating the labels, with missing values.
+    values = labels + np.random.normal(scale=0.1, size=500)
+    float_feat_array = pa.array(
+        [None if i % 10 == 0 else [v] for i, v in enumerate(values)])
+    batch = pa.RecordBatch.from_arrays(
+        [pa.array([[l] for l in labels]), float_feat_array],
+        ["label_key", "float_feature"])
+    actual = self._compute(batch)
+    self.assertLen(actual.features, 1)
+    custom_stats = {s.name: s.num for s in actual.features[0].custom_stats}
+    self.assertGreater(
+        custom_stats[mutual_information.MUTUAL_INFORMATION_KEY], 0.4)
+    self.assertGreater(
+        custom_stats[mutual_information.ADJUSTED_MUTUAL_INFORMATION_KEY], 0.4)
+
+  def test_mi_with_invalid_features(self):
+    batch = pa.RecordBatch.from_arrays(
+        [pa.array([[1]]), pa.array([[1, 2]])],
+        ["label_key", "multivalent_feature"])
+    expected = statistics_pb2.DatasetFeatureStatistics()
+    compare.assertProtoEqual(self, self._compute(batch), expected)
+
+  def test_mi_with_multivalent_label(self):
+    schema = text_format.Parse(
+        """
+          feature {
+            name: "fa"
+            type: FLOAT
+            shape {
+              dim {
+                size: 1
+              }
+            }
+          }
+          feature {
+            name: "label_key"
+            type: FLOAT
+            value_count: {
+              min: 1
+              max: 2
+            }
+          }
+          """, schema_pb2.Schema())
+    batch = pa.RecordBatch.from_arrays(
+        [pa.array([[1, 2]]), pa.array([[1]])], ["label_key", "fa"])
+    with self.assertRaisesRegexp(ValueError,
+                                 "Label column contains unsupported data."):
+      self._compute(batch, schema)
+
+
+if __name__ == "__main__":
+  absltest.main()
@@ -23,43 +23,144 @@ from __future__ import division
 from __future__ import print_function
 
 import collections
-import functools
+import hashlib
+import heapq
 import apache_beam as beam
 import numpy as np
 import pyarrow as pa
 from tensorflow_data_validation import types
+from tensorflow_data_validation.pywrap.tensorflow_data_validation_extension import statistics as statistics_pywrap
 from tensorflow_data_validation.statistics.generators import stats_generator
-from tensorflow_data_validation.utils import stats_util
 from tfx_bsl.arrow import table_util
-from typing import Dict, Iterable, List, Text, Tuple
+from typing import Dict, Iterable, List, Optional, Text, Tuple
 
 from tensorflow_metadata.proto.v0 import statistics_pb2
 
 
-def _assign_to_partition(sliced_record_batch: types.SlicedRecordBatch,
-                         num_partitions: int
-                        ) -> Tuple[Tuple[types.SliceKey, int], pa.RecordBatch]:
-  """Assigns an example to a partition key."""
+def _fingerprint_record_batch(record_batch: pa.RecordBatch, seed: int) -> int:
+  """Returns a 64-bit fingerprint of the contents of a record batch.
+
+  The fingerprint covers the column names and types and the values of the
+  columns, so that it is deterministic for a given input. Only the values
+  within the batch are hashed: the columns of a slice are compacted first, so
+  that fingerprinting all the slices of a batch is linear in its size.
+
+  Args:
+    record_batch: The record batch.
+    seed: An int which is fingerprinted with the contents.
+
+  Returns:
+    The fingerprint.
+  """
+  hasher = hashlib.blake2b(digest_size=8)
+  hasher.update(str(seed).encode())
+  for name, column in zip(record_batch.schema.names, record_batch.columns):
+    hasher.update(name.encode())
+    hasher.update(str(column.type).encode())
+    hasher.update(str(len(column)).encode())
+    # Concatenation copies only the range of the column within its buffers.
+    for buf in pa.concat_arrays([column]).buffers():
+      if buf is not None:
+        hasher.update(buf)
+  return int.from_bytes(hasher.digest(), 'little')
+
+
+def _assign_to_partition(
+    sliced_record_batch: types.SlicedRecordBatch,
+    num_partitions: int,
+    seed: int = 0
+) -> Tuple[Tuple[types.SliceKey, int], Tuple[int, pa.RecordBatch]]:
+  """Assigns a record batch to a partition key.
+
+  The partition and the sampling priority of the batch are derived from the
+  fingerprint of its contents, so that the assignment is deterministic and
+  does not depend on the order of the input.
+
+  Args:
+    sliced_record_batch: The slice key and the record batch.
+    num_partitions: The number of partitions.
+    seed: An int which determines the assignment.
+
+  Returns:
+    The (slice key, partition) key, and the (priority, record batch) value.
+  """
   slice_key, record_batch = sliced_record_batch
-  return (slice_key, np.random.randint(num_partitions)), record_batch
+  fingerprint = _fingerprint_record_batch(record_batch, seed)
+  return ((slice_key, fingerprint % num_partitions),
+          (fingerprint // num_partitions, record_batch))
 
 
-def _get_partitioned_statistics_summary(
-    statistics: Dict[types.FeaturePath, Dict[Text, np.ndarray]]
-) -> Dict[types.FeaturePath, Dict[Text, float]]:
-  """Computes meta-statistics over the custom stats in the input dict."""
+def _get_record_batch_nbytes(record_batch: pa.RecordBatch) -> int:
+  """Returns the number of bytes of the buffers of a record batch."""
+  return sum(column.nbytes for column in record_batch.columns)
 
-  summary = collections.defaultdict(collections.defaultdict)
-  for feature_path, feature_statistics in statistics.items():
-    summary_for_feature = summary[feature_path]
-    for stat_name, stat_values in feature_statistics.items():
-      summary_for_feature['min_' + stat_name] = np.min(stat_values)
-      summary_for_feature['max_' + stat_name] = np.max(stat_values)
-      summary_for_feature['mean_' + stat_name] = np.mean(stat_values)
-      summary_for_feature['median_' + stat_name] = np.median(stat_values)
-      summary_for_feature['std_dev_' + stat_name] = np.std(stat_values)
-      summary_for_feature['num_partitions_' + stat_name] = stat_values.size
-  return summary
+
+class _PartitionSample(object):
+  """The record batches sampled from a partition, in a max-heap by priority."""
+
+  def __init__(self):
+    # Entries are (-priority, insertion number, size in bytes, record batch).
+    # The insertion number breaks ties without comparing record batches.
+    self.heap = []
+    self.num_bytes = 0
+    self.num_inserted = 0
+
+
+class _PartitionSampleCombineFn(beam.CombineFn):
+  """Samples the record batches of a partition, within a memory budget.
+
+  The sample is made of the batches of lowest priority: the longest prefix,
+  by increasing priority, of the input batches which has at most max_batches
+  batches and max_bytes bytes, but at least one batch. As the prefix of the
+  union of several inputs is the prefix of the union of their prefixes, the
+  accumulators never hold more than the sample, and the sample does not
+  depend on how the inputs are combined.
+  """
+
+  def __init__(self, max_batches: int, max_bytes: Optional[int] = None):
+    self._max_batches = max_batches
+    self._max_bytes = max_bytes
+
+  def create_accumulator(self) -> _PartitionSample:
+    return _PartitionSample()
+
+  def _add(self, accumulator: _PartitionSample, priority: int,
+           batch_bytes: int, record_batch: pa.RecordBatch) -> None:
+    """Adds a record batch to the accumulator, then fits it in the budget."""
+    heapq.heappush(accumulator.heap, (-priority, accumulator.num_inserted,
+                                      batch_bytes, record_batch))
+    accumulator.num_inserted += 1
+    accumulator.num_bytes += batch_bytes
+    # Drops the batches of highest priority until the rest fits.
+    while len(accumulator.heap) > 1 and (
+        len(accumulator.heap) > self._max_batches or
+        (self._max_bytes is not None and
+         accumulator.num_bytes > self._max_bytes)):
+      _, _, dropped_bytes, _ = heapq.heappop(accumulator.heap)
+      accumulator.num_bytes -= dropped_bytes
+
+  def add_input(self, accumulator: _PartitionSample,
+                element: Tuple[int, pa.RecordBatch]) -> _PartitionSample:
+    priority, record_batch = element
+    self._add(accumulator, priority, _get_record_batch_nbytes(record_batch),
+              record_batch)
+    return accumulator
+
+  def merge_accumulators(
+      self, accumulators: Iterable[_PartitionSample]) -> _PartitionSample:
+    result = None
+    for accumulator in accumulators:
+      if result is None:
+        result = accumulator
+        continue
+      for negative_priority, _, batch_bytes, record_batch in accumulator.heap:
+        self._add(result, -negative_priority, batch_bytes, record_batch)
+    return result if result is not None else self.create_accumulator()
+
+  def extract_output(self, accumulator: _PartitionSample
+                    ) -> List[pa.RecordBatch]:
+    return [record_batch for _, _, _, record_batch in
+            sorted(accumulator.heap, key=lambda entry: (-entry[0], entry[1]))]
 
 
 def get_valid_statistics(
@@ -108,21 +209,13 @@ class PartitionedStatsFn(object):
     raise NotImplementedError()
 
 
-class _PartitionedStatisticsAnalyzerAccumulator(object):
-  """Holds the partial state of partitioned statistics summaries."""
-
-  def __init__(self):
-    # A partial is used so that the class is pickleable.
-    self.statistics = collections.defaultdict(
-        functools.partial(collections.defaultdict, list))
-
-
 class PartitionedStatisticsAnalyzer(beam.CombineFn):
   """Computes meta-statistics for non-streaming partitioned statistics.
 
   This analyzer computes meta-statistics including the min, max, mean, median
   and std dev of numeric statistics that are calculated over partitions
-  of the dataset. Statistics may be missing from some partitions if
+  of the dataset. The values of the statistics are accumulated and summarized
+  natively. Statistics may be missing from some partitions if
   the partition contains invalid feature values causing PartitionedStatsFn to
   "gracefully fail". Meta-statistics for a feature are only calculated if the
   number of partitions in which the statistic is computed passes a configurable
@@ -136,44 +229,40 @@ class PartitionedStatisticsAnalyzer(beam.CombineFn):
     # min_partitions_stat_presence number of partitions.
     self._min_partitions_stat_presence = min_partitions_stat_presence
 
-  def create_accumulator(self) -> _PartitionedStatisticsAnalyzerAccumulator:
+  def create_accumulator(
+      self) -> statistics_pywrap.PartitionedStatisticsCombiner:
     """Creates an accumulator, which stores partial state of meta-statistics."""
 
-    return _PartitionedStatisticsAnalyzerAccumulator()
+    return statistics_pywrap.PartitionedStatisticsCombiner()
 
-  def add_input(self, accumulator: _PartitionedStatisticsAnalyzerAccumulator,
+  def add_input(self,
+                accumulator: statistics_pywrap.PartitionedStatisticsCombiner,
                 statistic: statistics_pb2.DatasetFeatureStatistics
-               ) -> _PartitionedStatisticsAnalyzerAccumulator:
+               ) -> statistics_pywrap.PartitionedStatisticsCombiner:
     """Adds the input (DatasetFeatureStatistics) into the accumulator."""
 
-    for feature in statistic.features:
-      for stat in feature.custom_stats:
-        accumulator.statistics[
-            types.FeaturePath.from_proto(feature.path)][stat.name].append(
-                stat.num)
+    accumulator.Add(statistic.SerializeToString())
     return accumulator
 
   def merge_accumulators(
-      self, accumulators: Iterable[_PartitionedStatisticsAnalyzerAccumulator]
-  ) -> _PartitionedStatisticsAnalyzerAccumulator:
-    """Merges together a list of PartitionedStatisticsAnalyzerAccumulators."""
+      self,
+      accumulators: Iterable[statistics_pywrap.PartitionedStatisticsCombiner]
+  ) -> statistics_pywrap.PartitionedStatisticsCombiner:
+    """Merges together a list of PartitionedStatisticsCombiners."""
 
-    result = _PartitionedStatisticsAnalyzerAccumulator()
+    result = self.create_accumulator()
     for accumulator in accumulators:
-      for feature_path, feature_statistics in accumulator.statistics.items():
-        for stat_name, stat_values in feature_statistics.items():
-          result.statistics[feature_path][stat_name].extend(stat_values)
+      result.Merge(accumulator)
     return result
 
-  def extract_output(self,
-                     accumulator: _PartitionedStatisticsAnalyzerAccumulator
-                    ) -> statistics_pb2.DatasetFeatureStatistics:
+  def extract_output(
+      self, accumulator: statistics_pywrap.PartitionedStatisticsCombiner
+  ) -> statistics_pb2.DatasetFeatureStatistics:
     """Returns meta-statistics as a DatasetFeatureStatistics proto."""
 
-    valid_stats_summary = _get_partitioned_statistics_summary(
-        get_valid_statistics(accumulator.statistics,
-                             self._min_partitions_stat_presence))
-    return stats_util.make_dataset_feature_stats_proto(valid_stats_summary)
+    return statistics_pb2.DatasetFeatureStatistics.FromString(
+        accumulator.Summarize(
+            min_partitions_stat_presence=self._min_partitions_stat_presence))
 
 
 def _process_partition(
@@ -197,7 +286,8 @@ class _GenerateNonStreamingCustomStats(beam.PTransform):
   def __init__(self, stats_fn: PartitionedStatsFn,
                num_partitions: int, min_partitions_stat_presence: int,
                seed: int, max_examples_per_partition: int, batch_size: int,
-               name: Text) -> None:
+               name: Text, max_bytes_per_partition: Optional[int] = None
+              ) -> None:
     """Initializes _GenerateNonStreamingCustomStats."""
 
     self._stats_fn = stats_fn
@@ -207,8 +297,7 @@ class _GenerateNonStreamingCustomStats(beam.PTransform):
     self._seed = seed
     self._max_batches_per_partition = int(max_examples_per_partition /
                                           batch_size)
-    # Seeds the random number generator used in the partitioner.
-    np.random.seed(self._seed)
+    self._max_bytes_per_partition = max_bytes_per_partition
 
   def expand(self, pcoll: beam.pvalue.PCollection) -> beam.pvalue.PCollection:
     """Estimates the user defined statistic."""
@@ -216,9 +305,12 @@ class _GenerateNonStreamingCustomStats(beam.PTransform):
     return (
         pcoll
         | 'AssignBatchToPartition' >> beam.Map(
-            _assign_to_partition, num_partitions=self._num_partitions)
+            _assign_to_partition, num_partitions=self._num_partitions,
+            seed=self._seed)
         | 'GroupPartitionsIntoList' >> beam.CombinePerKey(
-            beam.combiners.SampleCombineFn(self._max_batches_per_partition))
+            _PartitionSampleCombineFn(
+                max_batches=self._max_batches_per_partition,
+                max_bytes=self._max_bytes_per_partition))
         | 'ProcessPartition' >> beam.Map(_process_partition,
                                          stats_fn=self._stats_fn)
         | 'ComputeMetaStats' >> beam.CombinePerKey(
@@ -238,8 +330,12 @@ class NonStreamingCustomStatsGenerator(stats_generator.TransformStatsGenerator):
   only calculated if the number of partitions where the statistic is computed
   exceeds a configurable threshold.
 
-  A large number of examples in a partition may result in worker OOM errors.
-  This can be prevented by setting max_examples_per_partition.
+  Record batches are assigned to partitions by the fingerprint of their
+  contents, and each partition keeps a deterministic sample of its batches, so
+  that the statistics do not depend on the order of the input. A large number
+  of examples in a partition may result in worker OOM errors. This can be
+  prevented by setting max_examples_per_partition and max_bytes_per_partition,
+  which bound the memory used by each partition while its sample is built.
   """
 
   def __init__(
@@ -250,7 +346,8 @@ class NonStreamingCustomStatsGenerator(stats_generator.TransformStatsGenerator):
       seed: int,
       max_examples_per_partition: int,
       batch_size: int = 1000,
-      name: Text = 'NonStreamingCustomStatsGenerator') -> None:
+      name: Text = 'NonStreamingCustomStatsGenerator',
+      max_bytes_per_partition: Optional[int] = None) -> None:
     """Initializes NonStreamingCustomStatsGenerator.
 
     Args:
@@ -258,13 +355,17 @@ class NonStreamingCustomStatsGenerator(stats_generator.TransformStatsGenerator):
       num_partitions: The number of partitions the stat will be calculated on.
       min_partitions_stat_presence: The minimum number of partitions a stat
         computation must succeed in for the result to be returned.
-      seed: An int used to seed the numpy random number generator.
+      seed: An int which determines the assignment of the record batches to
+        partitions and their sampling.
       max_examples_per_partition: An integer used to specify the maximum
         number of examples per partition to limit memory usage in a worker. If
         the number of examples per partition exceeds this value, the examples
         are randomly selected.
       batch_size: Number of examples per input batch.
       name: An optional unique name associated with the statistics generator.
+      max_bytes_per_partition: An optional maximum number of bytes of the
+        record batches of a partition. If the batches of a partition exceed
+        it, they are randomly selected (but at least one batch is kept).
     """
 
     super(NonStreamingCustomStatsGenerator, self).__init__(
@@ -276,5 +377,5 @@ class NonStreamingCustomStatsGenerator(stats_generator.TransformStatsGenerator):
             seed=seed,
             max_examples_per_partition=max_examples_per_partition,
             batch_size=batch_size,
-            name=name
-            ))
+            name=name,
+            max_bytes_per_partition=max_bytes_per_partition))
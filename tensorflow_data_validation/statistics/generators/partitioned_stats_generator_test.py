@@ -38,38 +38,131 @@ class AssignToPartitionTest(absltest.TestCase):
   """Tests for _asssign_to_partition."""
 
   def test_partitioner(self):
-    """Tests that batches are randomly partitioned.
+    """Tests that batches are evenly partitioned.
 
-    Tests an input batch with one univalent feature taking on values in {0,1,2}.
-    The input batch has 4500 examples. The partitioner is configured to have 3
-    partitions. So, we expect there to be around 4500/3/3 = 500 of each.
-    {0,1,2} in each partition.
+    Tests 4500 input batches with one univalent feature taking distinct values.
+    The partitioner is configured to have 3 partitions. So, we expect there to
+    be around 4500/3 = 1500 batches in each partition.
     """
 
-    np.random.seed(TEST_SEED)
     record_batches = [
-        pa.RecordBatch.from_arrays([pa.array([x])], ['a'])
-        for x in np.random.randint(0, 3, (4500, 1))
+        (constants.DEFAULT_SLICE_KEY,
+         pa.RecordBatch.from_arrays([pa.array([[x]])], ['a']))
+        for x in range(4500)
     ]
-    record_batches = [(constants.DEFAULT_SLICE_KEY, record_batch)
-                      for record_batch in record_batches]
     num_partitions = 3
 
-    # The i,jth value of result represents the number of examples with value j
-    # assigned to partition i.
-    result = [[0, 0, 0], [0, 0, 0], [0, 0, 0]]
+    # The ith value of result is the number of batches assigned to partition i.
+    result = [0, 0, 0]
 
     partitioned_record_batches = [
         partitioned_stats_generator._assign_to_partition(
-            record_batch, num_partitions) for record_batch in record_batches
+            record_batch, num_partitions, seed=TEST_SEED)
+        for record_batch in record_batches
     ]
-    for (unused_slice_key,
-         partition_key), record_batch in partitioned_record_batches:
-      result[partition_key][record_batch.column(0).to_pylist()[0][0]] += 1
+    for (unused_slice_key, partition_key), _ in partitioned_record_batches:
+      result[partition_key] += 1
 
-    for partition in result:
-      for count in partition:
-        self.assertBetween(count, 400, 600)
+    for count in result:
+      self.assertBetween(count, 1350, 1650)
+
+  def test_partitioner_is_deterministic(self):
+    """Tests that the assignment only depends on the contents and seed."""
+
+    def assign(values, seed):
+      record_batch = pa.RecordBatch.from_arrays(
+          [pa.array([[value] for value in values])], ['a'])
+      return partitioned_stats_generator._assign_to_partition(
+          (constants.DEFAULT_SLICE_KEY, record_batch), 10, seed=seed)
+
+    for x in range(20):
+      (key, (priority, _)) = assign([x, x + 1], TEST_SEED)
+      (other_key, (other_priority, _)) = assign([x, x + 1], TEST_SEED)
+      self.assertEqual(key, other_key)
+      self.assertEqual(priority, other_priority)
+
+    self.assertNotEqual(
+        [assign([x], TEST_SEED)[1][0] for x in range(20)],
+        [assign([x], TEST_SEED + 1)[1][0] for x in range(20)])
+
+  def test_partitioner_distinguishes_slices(self):
+    """Tests that slices sharing buffers are fingerprinted by their contents."""
+
+    record_batch = pa.RecordBatch.from_arrays([pa.array(range(100))], ['a'])
+    fingerprints = set(
+        partitioned_stats_generator._fingerprint_record_batch(
+            record_batch.slice(offset, 10), TEST_SEED)
+        for offset in range(0, 100, 10))
+    self.assertLen(fingerprints, 10)
+
+  def test_partitioner_ignores_slice_offsets(self):
+    """Tests that a slice is fingerprinted as a batch of the same contents."""
+
+    record_batch = pa.RecordBatch.from_arrays(
+        [pa.array([[x] for x in range(100)])], ['a'])
+    self.assertEqual(
+        partitioned_stats_generator._fingerprint_record_batch(
+            record_batch.slice(40, 10), TEST_SEED),
+        partitioned_stats_generator._fingerprint_record_batch(
+            pa.RecordBatch.from_arrays(
+                [pa.array([[x] for x in range(40, 50)])], ['a']), TEST_SEED))
+
+
+class PartitionSampleCombineFnTest(absltest.TestCase):
+  """Tests for _PartitionSampleCombineFn."""
+
+  def _combine(self, combiner, inputs):
+    accumulators = []
+    for element in inputs:
+      accumulators.append(
+          combiner.add_input(combiner.create_accumulator(), element))
+    return combiner.extract_output(combiner.merge_accumulators(accumulators))
+
+  def _get_inputs(self, num_batches):
+    return [(priority,
+             pa.RecordBatch.from_arrays([pa.array([priority] * 10)], ['a']))
+            for priority in range(num_batches)]
+
+  def _get_priorities(self, record_batches):
+    return [record_batch.column(0).to_pylist()[0]
+            for record_batch in record_batches]
+
+  def test_keeps_lowest_priorities(self):
+    inputs = self._get_inputs(10)
+    combiner = partitioned_stats_generator._PartitionSampleCombineFn(
+        max_batches=3)
+    self.assertEqual(
+        self._get_priorities(self._combine(combiner, reversed(inputs))),
+        [0, 1, 2])
+
+  def test_byte_budget(self):
+    inputs = self._get_inputs(10)
+    batch_bytes = partitioned_stats_generator._get_record_batch_nbytes(
+        inputs[0][1])
+    combiner = partitioned_stats_generator._PartitionSampleCombineFn(
+        max_batches=5, max_bytes=batch_bytes * 2 + 1)
+    self.assertEqual(
+        self._get_priorities(self._combine(combiner, inputs)), [0, 1])
+    # At least one batch is kept.
+    combiner = partitioned_stats_generator._PartitionSampleCombineFn(
+        max_batches=5, max_bytes=1)
+    self.assertEqual(
+        self._get_priorities(self._combine(combiner, inputs)), [0])
+
+  def test_sample_does_not_depend_on_combination_order(self):
+    inputs = self._get_inputs(20)
+    combiner = partitioned_stats_generator._PartitionSampleCombineFn(
+        max_batches=4)
+    accumulator = combiner.create_accumulator()
+    for element in inputs[::-1]:
+      accumulator = combiner.add_input(accumulator, element)
+    halves = [combiner.create_accumulator(), combiner.create_accumulator()]
+    for i, element in enumerate(inputs):
+      halves[i % 2] = combiner.add_input(halves[i % 2], element)
+    self.assertEqual(
+        self._get_priorities(combiner.extract_output(accumulator)),
+        self._get_priorities(
+            combiner.extract_output(combiner.merge_accumulators(halves))))
 
 
 class PartitionedStatisticsAnalyzer(absltest.TestCase):
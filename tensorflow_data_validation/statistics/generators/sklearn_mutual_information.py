@@ -24,12 +24,13 @@ import pandas as pd
 import pyarrow as pa
 from tensorflow_data_validation import types
 from tensorflow_data_validation.arrow import arrow_util
+from tensorflow_data_validation.statistics.generators import mutual_information
 from tensorflow_data_validation.statistics.generators import partitioned_stats_generator
 from tensorflow_data_validation.utils import schema_util
 from tensorflow_data_validation.utils import stats_util
 from tfx_bsl.arrow import array_util
 
-from typing import Dict, List, Set, Text
+from typing import Dict, List, Set, Text, Union
 
 from tensorflow_metadata.proto.v0 import schema_pb2
 from tensorflow_metadata.proto.v0 import statistics_pb2
@@ -139,15 +140,12 @@ class SkLearnMutualInformation(partitioned_stats_generator.PartitionedStatsFn):
     """
     self._label_feature = label_feature
     self._schema = schema
-    self._categorical_features = schema_util.get_categorical_features(schema)
-    assert schema_util.get_feature(self._schema, self._label_feature)
+    self._schema_index = schema_util.SchemaIndex(schema)
+    self._categorical_features = self._schema_index.get_categorical_features()
+    assert self._schema_index.get_feature(self._label_feature)
     self._label_feature_is_categorical = (
         self._label_feature in self._categorical_features)
     self._seed = seed
-    self._schema_features = set([
-        feature_path for (feature_path,
-                          _) in schema_util.get_all_leaf_features(schema)
-    ])
 
     # Seed the RNG used for shuffling and for MI computations.
     np.random.seed(seed)
@@ -168,7 +166,8 @@ class SkLearnMutualInformation(partitioned_stats_generator.PartitionedStatsFn):
     Raises:
       ValueError: If label_feature contains unsupported data.
     """
-    examples = self._remove_unsupported_feature_columns(examples, self._schema)
+    examples = self._remove_unsupported_feature_columns(examples,
+                                                        self._schema_index)
 
     flattened_examples = _flatten_and_impute(examples,
                                              self._categorical_features)
@@ -287,7 +286,8 @@ class SkLearnMutualInformation(partitioned_stats_generator.PartitionedStatsFn):
     return is_categorical_feature
 
   def _remove_unsupported_feature_columns(
-      self, examples: pa.RecordBatch, schema: schema_pb2.Schema
+      self, examples: pa.RecordBatch,
+      schema: Union[schema_pb2.Schema, schema_util.SchemaIndex]
       ) -> pa.RecordBatch:
     """Removes feature columns that contain unsupported values.
 
@@ -298,38 +298,10 @@ class SkLearnMutualInformation(partitioned_stats_generator.PartitionedStatsFn):
 
     Args:
       examples: Arrow RecordBatch containing a batch of examples.
-      schema: The schema for the data.
+      schema: The schema for the data, or its SchemaIndex.
 
     Returns:
       Arrow RecordBatch.
     """
-    columns = set(examples.schema.names)
-
-    multivalent_features = schema_util.get_multivalent_features(schema)
-    unsupported_columns = set()
-    for f in multivalent_features:
-      # Drop the column if they were in the examples.
-      if f.steps()[0] in columns:
-        unsupported_columns.add(f.steps()[0])
-    for column_name, column in zip(examples.schema.names,
-                                   examples.columns):
-      # only support 1-nested non-struct arrays.
-      column_type = column.type
-      if (arrow_util.get_nest_level(column_type) != 1 or
-          stats_util.get_feature_type_from_arrow_type(
-              types.FeaturePath([column_name]), column_type)
-          == statistics_pb2.FeatureNameStatistics.STRUCT):
-        unsupported_columns.add(column_name)
-      # Drop columns that were not in the schema.
-      if types.FeaturePath([column_name]) not in self._schema_features:
-        unsupported_columns.add(column_name)
-
-    supported_columns = []
-    supported_column_names = []
-    for column_name, column in zip(examples.schema.names,
-                                   examples.columns):
-      if column_name not in unsupported_columns:
-        supported_columns.append(column)
-        supported_column_names.append(column_name)
-
-    return pa.RecordBatch.from_arrays(supported_columns, supported_column_names)
+    return mutual_information.remove_unsupported_feature_columns(
+        examples, schema)
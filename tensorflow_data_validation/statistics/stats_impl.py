@@ -31,10 +31,12 @@ from six.moves import zip
 from tensorflow_data_validation import constants
 from tensorflow_data_validation import types
 from tensorflow_data_validation.arrow import arrow_util
+from tensorflow_data_validation.pywrap.tensorflow_data_validation_extension import statistics as statistics_pywrap
 from tensorflow_data_validation.statistics import stats_options
 from tensorflow_data_validation.statistics.generators import basic_stats_generator
 from tensorflow_data_validation.statistics.generators import image_stats_generator
 from tensorflow_data_validation.statistics.generators import lift_stats_generator
+from tensorflow_data_validation.statistics.generators import mergeable_sketch_stats_generator
 from tensorflow_data_validation.statistics.generators import natural_language_stats_generator
 from tensorflow_data_validation.statistics.generators import sparse_feature_stats_generator
 from tensorflow_data_validation.statistics.generators import stats_generator
@@ -43,7 +45,6 @@ from tensorflow_data_validation.statistics.generators import top_k_uniques_combi
 from tensorflow_data_validation.statistics.generators import top_k_uniques_stats_generator
 from tensorflow_data_validation.statistics.generators import weighted_feature_stats_generator
 from tensorflow_data_validation.utils import slicing_util
-from tensorflow_data_validation.utils import stats_util
 from tfx_bsl.arrow import table_util
 from typing import Any, Callable, Dict, Iterable, List, Optional, Text, Tuple
 
@@ -190,6 +191,10 @@ def get_generators(options: stats_options.StatsOptions,
             semantic_domain_feature_stats_generators,
             weight_feature=options.weight_feature,
             sample_rate=options.semantic_domain_stats_sample_rate))
+  if options.enable_mergeable_sketches:
+    generators.append(
+        mergeable_sketch_stats_generator.MergeableSketchStatsGenerator(
+            schema=options.schema))
   if options.schema is not None:
     if _schema_has_sparse_features(options.schema):
       generators.append(
@@ -343,105 +348,18 @@ def _merge_dataset_feature_stats_protos(
 ) -> statistics_pb2.DatasetFeatureStatistics:
   """Merges together a list of DatasetFeatureStatistics protos.
 
+  The FeatureNameStatistics protos of each feature are merged natively, see
+  MergeDatasetFeatureStatistics in anomalies/statistics_merge_util.h.
+
   Args:
     stats_protos: A list of DatasetFeatureStatistics protos to merge.
 
   Returns:
     The merged DatasetFeatureStatistics proto.
   """
-  stats_per_feature = {}
-  # Create a new DatasetFeatureStatistics proto.
-  result = statistics_pb2.DatasetFeatureStatistics()
-  # Iterate over each DatasetFeatureStatistics proto and merge the
-  # FeatureNameStatistics protos per feature and add the cross feature stats.
-  for stats_proto in stats_protos:
-    if stats_proto.cross_features:
-      result.cross_features.extend(stats_proto.cross_features)
-    for feature_stats_proto in stats_proto.features:
-      feature_path = types.FeaturePath.from_proto(feature_stats_proto.path)
-      if feature_path not in stats_per_feature:
-        # Make a copy for the "cache" since we are modifying it in 'else' below.
-        new_feature_stats_proto = statistics_pb2.FeatureNameStatistics()
-        new_feature_stats_proto.CopyFrom(feature_stats_proto)
-        stats_per_feature[feature_path] = new_feature_stats_proto
-      else:
-        stats_for_feature = stats_per_feature[feature_path]
-        # MergeFrom would concatenate repeated fields which is not what we want
-        # for path.step.
-        del stats_for_feature.path.step[:]
-        stats_for_feature.MergeFrom(feature_stats_proto)
-
-  num_examples = None
-  for feature_stats_proto in six.itervalues(stats_per_feature):
-    # Add the merged FeatureNameStatistics proto for the feature
-    # into the DatasetFeatureStatistics proto.
-    new_feature_stats_proto = result.features.add()
-    new_feature_stats_proto.CopyFrom(feature_stats_proto)
-
-    # Get the number of examples from one of the features that
-    # has common stats.
-    if num_examples is None:
-      stats_type = feature_stats_proto.WhichOneof('stats')
-      stats_proto = None
-      if stats_type == 'num_stats':
-        stats_proto = feature_stats_proto.num_stats
-      else:
-        stats_proto = feature_stats_proto.string_stats
-
-      if stats_proto.HasField('common_stats'):
-        num_examples = (stats_proto.common_stats.num_non_missing +
-                        stats_proto.common_stats.num_missing)
-
-  # Set the num_examples field.
-  if num_examples is not None:
-    result.num_examples = num_examples
-  return result
-
-
-def _update_example_and_missing_count(
-    stats: statistics_pb2.DatasetFeatureStatistics) -> None:
-  """Updates example count of the dataset and missing count for all features."""
-  if not stats.features:
-    return
-  dummy_feature = stats_util.get_feature_stats(stats, _DUMMY_FEATURE_PATH)
-  num_examples = stats_util.get_custom_stats(dummy_feature, _NUM_EXAMPLES_KEY)
-  weighted_num_examples = stats_util.get_custom_stats(
-      dummy_feature, _WEIGHTED_NUM_EXAMPLES_KEY)
-  stats.features.remove(dummy_feature)
-  for feature_stats in stats.features:
-    # For features nested under a STRUCT feature, their num_missing is computed
-    # in the basic stats generator (because their num_missing is relative to
-    # their parent's value count).
-    if len(feature_stats.path.step) > 1:
-      continue
-    common_stats = None
-    which_oneof_stats = feature_stats.WhichOneof('stats')
-    if which_oneof_stats is None:
-      # There are not common_stats for this feature (which can be the case when
-      # generating only custom_stats for a sparse or weighted feature). In that
-      # case, simply continue without modifying the common stats.
-      continue
-    common_stats = getattr(feature_stats, which_oneof_stats).common_stats
-    assert num_examples >= common_stats.num_non_missing, (
-        'Total number of examples: {} is less than number of non missing '
-        'examples: {} for feature {}.'.format(
-            num_examples, common_stats.num_non_missing,
-            '.'.join(feature_stats.path.step)))
-    num_missing = int(num_examples - common_stats.num_non_missing)
-    common_stats.num_missing = num_missing
-    if common_stats.presence_and_valency_stats:
-      common_stats.presence_and_valency_stats[0].num_missing = num_missing
-    if weighted_num_examples != 0:
-      weighted_num_missing = (
-          weighted_num_examples -
-          common_stats.weighted_common_stats.num_non_missing)
-      common_stats.weighted_common_stats.num_missing = weighted_num_missing
-      if common_stats.weighted_presence_and_valency_stats:
-        common_stats.weighted_presence_and_valency_stats[0].num_missing = (
-            weighted_num_missing)
-
-  stats.num_examples = int(num_examples)
-  stats.weighted_num_examples = weighted_num_examples
+  return statistics_pb2.DatasetFeatureStatistics.FromString(
+      statistics_pywrap.MergeDatasetFeatureStatistics(
+          [stats_proto.SerializeToString() for stats_proto in stats_protos]))
 
 
 def _make_dataset_feature_statistics_list_proto(
@@ -449,38 +367,30 @@ def _make_dataset_feature_statistics_list_proto(
 ) -> statistics_pb2.DatasetFeatureStatisticsList:
   """Constructs a DatasetFeatureStatisticsList proto.
 
+  We update the example count for each dataset and the missing count for all
+  the features, using the number of examples computed separately using
+  NumExamplesStatsGenerator. Note that we compute the number of examples
+  separately to avoid ignoring example counts for features which may be
+  completely missing in a shard. We set the missing count of a feature to be
+  num_examples - non_missing_count. If there are no input stats protos, the
+  output contains a dataset with num_examples == 0.
+
   Args:
     stats_protos: List of DatasetFeatureStatistics protos.
 
   Returns:
     The DatasetFeatureStatisticsList proto containing the input stats protos.
   """
-  # Create a new DatasetFeatureStatisticsList proto.
-  result = statistics_pb2.DatasetFeatureStatisticsList()
-
-  for stats_proto in stats_protos:
-
-    # Add the input DatasetFeatureStatistics proto.
-    new_stats_proto = result.datasets.add()
-    new_stats_proto.CopyFrom(stats_proto)
-    # We now update the example count for the dataset and the missing count
-    # for all the features, using the number of examples computed separately
-    # using NumExamplesStatsGenerator. Note that we compute the number of
-    # examples separately to avoid ignoring example counts for features which
-    # may be completely missing in a shard. We set the missing count of a
-    # feature to be num_examples - non_missing_count.
-    _update_example_and_missing_count(new_stats_proto)
-  if not stats_protos:
-    # Handle the case in which there are no examples. In that case, we want to
-    # output a DatasetFeatureStatisticsList proto with a dataset containing
-    # num_examples == 0 instead of an empty DatasetFeatureStatisticsList proto.
-    result.datasets.add(num_examples=0)
-  return result
+  return statistics_pb2.DatasetFeatureStatisticsList.FromString(
+      statistics_pywrap.MakeDatasetFeatureStatisticsList(
+          [stats_proto.SerializeToString() for stats_proto in stats_protos]))
 
 
+# LINT.IfChange
 _DUMMY_FEATURE_PATH = types.FeaturePath(['__TFDV_INTERNAL_FEATURE__'])
 _NUM_EXAMPLES_KEY = '__NUM_EXAMPLES__'
 _WEIGHTED_NUM_EXAMPLES_KEY = '__WEIGHTED_NUM_EXAMPLES__'
+# LINT.ThenChange(../anomalies/statistics_merge_util.cc)
 
 
 class NumExamplesStatsGenerator(stats_generator.CombinerStatsGenerator):
@@ -797,11 +707,11 @@ def extract_statistics_output(
 ) -> statistics_pb2.DatasetFeatureStatisticsList:
   """Extracts final stats output from the accumulators holding partial stats."""
   outputs = [
-      gen.extract_output(stats)
+      gen.extract_output(stats).SerializeToString()
       for (gen, stats) in zip(stats_generators, partial_stats)  # pytype: disable=attribute-error
   ]
-  return _make_dataset_feature_statistics_list_proto(
-      [_merge_dataset_feature_stats_protos(outputs)])
+  return statistics_pb2.DatasetFeatureStatisticsList.FromString(
+      statistics_pywrap.MergeAndFinalizeDatasetFeatureStatistics(outputs))
 
 
 # Type for the wrapper_accumulator of a CombinerFeatureStatsWrapperGenerator.
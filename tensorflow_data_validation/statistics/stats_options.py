@@ -62,7 +62,8 @@ class StatsOptions(object):
       infer_type_from_schema: bool = False,
       desired_batch_size: Optional[int] = None,
       enable_semantic_domain_stats: bool = False,
-      semantic_domain_stats_sample_rate: Optional[float] = None):
+      semantic_domain_stats_sample_rate: Optional[float] = None,
+      enable_mergeable_sketches: bool = False):
     """Initializes statistics options.
 
     Args:
@@ -119,6 +120,11 @@ class StatsOptions(object):
       semantic_domain_stats_sample_rate: An optional sampling rate for semantic
         domain statistics. If specified, semantic domain statistics is computed
         over a sample.
+      enable_mergeable_sketches: If True mergeable sketches of the values of
+        each feature are embedded in the statistics as a custom statistic, so
+        that statistics of different spans can be merged with
+        stats_util.merge_statistics without losing the unique counts, the top
+        values and the quantiles.
     """
     self.generators = generators
     self.feature_whitelist = feature_whitelist
@@ -140,6 +146,7 @@ class StatsOptions(object):
     self.desired_batch_size = desired_batch_size
     self.enable_semantic_domain_stats = enable_semantic_domain_stats
     self.semantic_domain_stats_sample_rate = semantic_domain_stats_sample_rate
+    self.enable_mergeable_sketches = enable_mergeable_sketches
 
   def to_json(self) -> Text:
     """Convert from an object to JSON representation of the __dict__ attribute.
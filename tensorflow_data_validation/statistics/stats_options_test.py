@@ -245,6 +245,7 @@ class StatsOptionsTest(parameterized.TestCase):
     desired_batch_size = 100
     enable_semantic_domain_stats = True
     semantic_domain_stats_sample_rate = 0.1
+    enable_mergeable_sketches = True
 
     options = stats_options.StatsOptions(
         generators=generators,
@@ -265,7 +266,8 @@ class StatsOptionsTest(parameterized.TestCase):
         infer_type_from_schema=infer_type_from_schema,
         desired_batch_size=desired_batch_size,
         enable_semantic_domain_stats=enable_semantic_domain_stats,
-        semantic_domain_stats_sample_rate=semantic_domain_stats_sample_rate)
+        semantic_domain_stats_sample_rate=semantic_domain_stats_sample_rate,
+        enable_mergeable_sketches=enable_mergeable_sketches)
 
     options_json = options.to_json()
     options = stats_options.StatsOptions.from_json(options_json)
@@ -295,6 +297,8 @@ class StatsOptionsTest(parameterized.TestCase):
                      options.enable_semantic_domain_stats)
     self.assertEqual(semantic_domain_stats_sample_rate,
                      options.semantic_domain_stats_sample_rate)
+    self.assertEqual(enable_mergeable_sketches,
+                     options.enable_mergeable_sketches)
 
   def test_stats_options_from_json(self):
     options_json = """{
@@ -18,31 +18,18 @@ from __future__ import division
 
 from __future__ import print_function
 
-from typing import FrozenSet, List, Text, Tuple
+from typing import FrozenSet, List, Optional, Text
 import pyarrow as pa
 from tensorflow_data_validation import types
+from tensorflow_data_validation.anomalies.proto import validation_config_pb2
+from tensorflow_data_validation.pywrap.tensorflow_data_validation_extension import validation as validation_pywrap
 from tensorflow_data_validation.utils import io_util
 from google.protobuf import text_format
 from tensorflow_metadata.proto.v0 import anomalies_pb2
 
 # LINT.IfChange
 MULTIPLE_ERRORS_SHORT_DESCRIPTION = 'Multiple errors'
-
-
-def _make_updated_descriptions(
-    reasons: List[anomalies_pb2.AnomalyInfo.Reason]) -> Tuple[Text, Text]:
-  """Returns descriptions based on the specified reasons."""
-  # If we only have one reason, use its descriptions. Alternatively, if the only
-  # reasons for the anomaly are of type SCHEMA_NEW_COLUMN, then just use one of
-  # them for the description.
-  if len(reasons) == 1 or all(
-      reason.type == anomalies_pb2.AnomalyInfo.SCHEMA_NEW_COLUMN
-      for reason in reasons):
-    return (reasons[0].description, reasons[0].short_description)
-  else:
-    return (' '.join([reason.description for reason in reasons]),
-            MULTIPLE_ERRORS_SHORT_DESCRIPTION)
-# LINT.ThenChange(../anomalies/schema_anomalies.cc)
+# LINT.ThenChange(../anomalies/anomalies_util.cc)
 
 
 def remove_anomaly_types(
@@ -58,36 +45,31 @@ def remove_anomaly_types(
       the specified types.
     types_to_remove: A set of the types of reasons to remove.
   """
-  features_to_remove = []
-  for feature_name, anomaly_info in anomalies.anomaly_info.items():
-    retained_reasons = [
-        reason for reason in anomaly_info.reason
-        if reason.type not in types_to_remove
-    ]
-
-    # Clear the diff regions entirely since we do not have a way of readily
-    # separating the comparisons that are attributable to the retained reasons
-    # from those that are attributable to the removed reasons.
-    anomaly_info.ClearField('diff_regions')
-    anomaly_info.ClearField('reason')
-    if retained_reasons:
-      # If there are anomaly reasons that are retained, update the anomaly info
-      # for the feature to include only those retained reasons.
-      anomaly_info.reason.extend(retained_reasons)
-      # Replace the description and short_description based on the reasons that
-      # are retained.
-      (updated_description,
-       updated_short_description) = _make_updated_descriptions(retained_reasons)
-      anomaly_info.description = updated_description
-      anomaly_info.short_description = updated_short_description
-
-    else:
-      # If there are no anomaly types that are retained for a given feature,
-      # remove that feature from the anomaly_info map entirely.
-      features_to_remove.append(feature_name)
-
-  for feature_name in features_to_remove:
-    del anomalies.anomaly_info[feature_name]
+  anomalies.ParseFromString(
+      remove_anomaly_types_from_serialized([anomalies.SerializeToString()],
+                                           types_to_remove)[0])
+
+
+def remove_anomaly_types_from_serialized(
+    serialized_anomalies: List[bytes],
+    types_to_remove: FrozenSet['anomalies_pb2.AnomalyInfo.Type']
+) -> List[bytes]:
+  """Removes the specified types of anomaly reasons from Anomalies protos.
+
+  Same as remove_anomaly_types, but processes a list of serialized Anomalies
+  protos natively at once. The description of an anomaly is rebuilt from its
+  retained reasons as when it is computed (see anomalies_util.h), and its diff
+  regions are cleared.
+
+  Args:
+    serialized_anomalies: A list of serialized Anomalies protos.
+    types_to_remove: A set of the types of reasons to remove.
+
+  Returns:
+    The list of the updated serialized Anomalies protos.
+  """
+  return validation_pywrap.RemoveAnomalyTypes(serialized_anomalies,
+                                              list(types_to_remove))
 
 
 def anomalies_slicer(
@@ -105,13 +87,45 @@ def anomalies_slicer(
   Returns:
     A list of slice keys.
   """
-  slice_keys = []
-  for feature_name, anomaly_info in anomalies.anomaly_info.items():
-    for anomaly_reason in anomaly_info.reason:
-      slice_keys.append(
-          feature_name + '_' +
-          anomalies_pb2.AnomalyInfo.Type.Name(anomaly_reason.type))
-  return slice_keys
+  return get_anomaly_reason_slice_keys([anomalies.SerializeToString()])[0]
+
+
+def get_anomaly_reason_slice_keys(
+    serialized_anomalies: List[bytes]) -> List[types.SliceKeysList]:
+  """Returns the slice keys of the anomaly reasons of Anomalies protos.
+
+  Same as anomalies_slicer, but processes a list of serialized Anomalies protos
+  natively at once. The slice key of a reason is
+  "<feature name>_<reason type name>", and the slice keys of an Anomalies proto
+  are ordered by feature name.
+
+  Args:
+    serialized_anomalies: A list of serialized Anomalies protos.
+
+  Returns:
+    The list of slice keys of each Anomalies proto.
+  """
+  return validation_pywrap.GetAnomalyReasonSliceKeys(serialized_anomalies)
+
+
+def get_baseline_schema_fingerprint(
+    anomalies: anomalies_pb2.Anomalies) -> Optional[int]:
+  """Gets the fingerprint of the schema referenced by the anomalies baseline.
+
+  Args:
+    anomalies: An Anomalies protocol buffer computed with
+      `ValidationOptions.baseline_fingerprint_only`.
+
+  Returns:
+    The fingerprint of the baseline schema (see
+    `validation_api.schema_fingerprint`), or None if the baseline does not
+    reference the schema by its fingerprint.
+  """
+  for extra_metadata in anomalies.baseline.annotation.extra_metadata:
+    baseline_fingerprint = validation_config_pb2.BaselineSchemaFingerprint()
+    if extra_metadata.Unpack(baseline_fingerprint):
+      return baseline_fingerprint.fingerprint
+  return None
 
 
 def write_anomalies_text(anomalies: anomalies_pb2.Anomalies,
@@ -22,6 +22,7 @@ from absl import flags
 from absl.testing import absltest
 from absl.testing import parameterized
 import pyarrow as pa
+from tensorflow_data_validation.anomalies.proto import validation_config_pb2
 from tensorflow_data_validation.utils import anomalies_util
 
 from google.protobuf import text_format
@@ -503,6 +504,45 @@ class AnomaliesUtilTest(parameterized.TestCase):
     slice_keys = anomalies_util.anomalies_slicer(example, anomalies)
     self.assertCountEqual(slice_keys, expected_slice_keys)
 
+  def test_remove_anomaly_types_from_serialized(self):
+    test_case = SET_REMOVE_ANOMALY_TYPES_CHANGES_PROTO_TESTS[0]
+    input_anomalies_proto = text_format.Parse(
+        test_case['input_anomalies_proto_text'], anomalies_pb2.Anomalies())
+    expected_anomalies_proto = text_format.Parse(
+        test_case['expected_anomalies_proto_text'], anomalies_pb2.Anomalies())
+    results = anomalies_util.remove_anomaly_types_from_serialized(
+        [input_anomalies_proto.SerializeToString(),
+         anomalies_pb2.Anomalies().SerializeToString()],
+        test_case['anomaly_types_to_remove'])
+    self.assertLen(results, 2)
+    compare.assertProtoEqual(self,
+                             anomalies_pb2.Anomalies.FromString(results[0]),
+                             expected_anomalies_proto)
+    compare.assertProtoEqual(self,
+                             anomalies_pb2.Anomalies.FromString(results[1]),
+                             anomalies_pb2.Anomalies())
+
+  def test_get_anomaly_reason_slice_keys(self):
+    serialized_anomalies = [
+        text_format.Parse(test_case['input_anomalies_proto_text'],
+                          anomalies_pb2.Anomalies()).SerializeToString()
+        for test_case in ANOMALIES_SLICER_TESTS
+    ]
+    self.assertEqual(
+        anomalies_util.get_anomaly_reason_slice_keys(serialized_anomalies),
+        [test_case['expected_slice_keys']
+         for test_case in ANOMALIES_SLICER_TESTS])
+
+  def test_get_baseline_schema_fingerprint(self):
+    anomalies = anomalies_pb2.Anomalies()
+    self.assertIsNone(anomalies_util.get_baseline_schema_fingerprint(anomalies))
+    baseline_fingerprint = validation_config_pb2.BaselineSchemaFingerprint(
+        fingerprint=2**64 - 1)
+    anomalies.baseline.annotation.extra_metadata.add().Pack(
+        baseline_fingerprint)
+    self.assertEqual(
+        anomalies_util.get_baseline_schema_fingerprint(anomalies), 2**64 - 1)
+
   def test_write_load_anomalies_text(self):
     anomalies = text_format.Parse(
         """
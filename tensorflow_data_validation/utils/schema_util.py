@@ -18,11 +18,15 @@ from __future__ import division
 
 from __future__ import print_function
 
+import collections
+import functools
 import logging
 import six
 from tensorflow_data_validation import types
+from tensorflow_data_validation.pywrap.tensorflow_data_validation_extension import text_format as text_format_pywrap
+from tensorflow_data_validation.pywrap.tensorflow_data_validation_extension import validation as validation_pywrap
 from tensorflow_data_validation.utils import io_util
-from typing import Iterable, List, Optional, Set, Text, Tuple, Union
+from typing import Callable, Iterable, List, Optional, Set, Text, Tuple, Union
 from google.protobuf import text_format
 from tensorflow_metadata.proto.v0 import schema_pb2
 
@@ -99,7 +103,22 @@ def get_domain(schema: schema_pb2.Schema,
     raise TypeError('schema is of type %s, should be a Schema proto.' %
                     type(schema).__name__)
 
-  feature = get_feature(schema, feature_path)
+  def _get_global_domain(name: Text) -> Optional[schema_pb2.StringDomain]:
+    for domain in schema.string_domain:
+      if domain.name == name:
+        return domain
+    return None
+
+  return _get_feature_domain(
+      get_feature(schema, feature_path), feature_path, _get_global_domain)
+
+
+def _get_feature_domain(
+    feature: schema_pb2.Feature,
+    feature_path: Union[types.FeatureName, types.FeaturePath],
+    get_global_domain: Callable[[Text], Optional[schema_pb2.StringDomain]]
+) -> FEATURE_DOMAIN:
+  """Returns the domain of a feature, looking up global domains by name."""
   domain_info = feature.WhichOneof('domain_info')
 
   if domain_info is None:
@@ -113,9 +132,9 @@ def get_domain(schema: schema_pb2.Schema,
   elif domain_info == 'string_domain':
     return feature.string_domain
   elif domain_info == 'domain':
-    for domain in schema.string_domain:
-      if domain.name == feature.domain:
-        return domain
+    domain = get_global_domain(feature.domain)
+    if domain is not None:
+      return domain
   elif domain_info == 'bool_domain':
     return feature.bool_domain
 
@@ -205,7 +224,8 @@ def write_schema_text(schema: schema_pb2.Schema, output_path: Text) -> None:
     raise TypeError('schema is of type %s, should be a Schema proto.' %
                     type(schema).__name__)
 
-  schema_text = text_format.MessageToString(schema)
+  schema_text = text_format_pywrap.PrintTextProto(
+      schema.DESCRIPTOR.full_name, schema.SerializeToString(), 0)
   io_util.write_string_to_file(output_path, schema_text)
 
 
@@ -218,10 +238,12 @@ def load_schema_text(input_path: Text) -> schema_pb2.Schema:
   Returns:
     A Schema protocol buffer.
   """
-  schema = schema_pb2.Schema()
   schema_text = io_util.read_file_to_string(input_path)
-  text_format.Parse(schema_text, schema)
-  return schema
+  try:
+    return schema_pb2.Schema.FromString(text_format_pywrap.ParseTextProto(
+        schema_pb2.Schema.DESCRIPTOR.full_name, schema_text))
+  except RuntimeError as e:
+    raise text_format.ParseError(str(e))
 
 
 def get_bytes_features(schema: schema_pb2.Schema) -> List[types.FeaturePath]:
@@ -233,12 +255,7 @@ def get_bytes_features(schema: schema_pb2.Schema) -> List[types.FeaturePath]:
   Returns:
     A list of features that should be considered bytes.
   """
-  bytes_features = []
-  for feature_path, feature in get_all_leaf_features(schema):
-    domain_info = feature.WhichOneof('domain_info')
-    if domain_info == 'image_domain':
-      bytes_features.append(feature_path)
-  return bytes_features
+  return SchemaIndex(schema).get_bytes_features()
 
 
 def is_categorical_feature(feature: schema_pb2.Feature):
@@ -263,11 +280,7 @@ def get_categorical_numeric_features(
   Returns:
     A list of int features that should be considered categorical.
   """
-  categorical_features = []
-  for feature_path, feature in get_all_leaf_features(schema):
-    if feature.type == schema_pb2.INT and is_categorical_feature(feature):
-      categorical_features.append(feature_path)
-  return categorical_features
+  return SchemaIndex(schema).get_categorical_numeric_features()
 
 
 def get_categorical_features(schema: schema_pb2.Schema
@@ -280,10 +293,7 @@ def get_categorical_features(schema: schema_pb2.Schema
   Returns:
     A set containing the names of all categorical features.
   """
-  return {
-      feature_path for feature_path, feature in get_all_leaf_features(schema)
-      if is_categorical_feature(feature)
-  }
+  return SchemaIndex(schema).get_categorical_features()
 
 
 def get_multivalent_features(schema: schema_pb2.Schema
@@ -296,17 +306,7 @@ def get_multivalent_features(schema: schema_pb2.Schema
   Returns:
     A set containing the names of all multivalent features.
   """
-
-  # Check if the feature is not univalent. A univalent feature will either
-  # have the shape field set with one dimension of size 1 or the value_count
-  # field set with a max value_count of 1.
-  # pylint: disable=g-complex-comprehension
-  return {
-      feature_path for feature_path, feature in get_all_leaf_features(schema)
-      if not ((feature.shape and feature.shape.dim and
-               len(feature.shape.dim) == feature.shape.dim[0].size == 1) or
-              (feature.value_count and feature.value_count.max == 1))
-  }
+  return SchemaIndex(schema).get_multivalent_features()
 
 
 def look_up_feature(
@@ -323,17 +323,128 @@ def get_all_leaf_features(
     schema: schema_pb2.Schema
 ) -> List[Tuple[types.FeaturePath, schema_pb2.Feature]]:
   """Returns all leaf features in a schema."""
-  def _recursion_helper(
-      parent_path: types.FeaturePath,
-      feature_container: Iterable[schema_pb2.Feature],
-      result: List[Tuple[types.FeaturePath, schema_pb2.Feature]]):
-    for f in feature_container:
-      feature_path = parent_path.child(f.name)
-      if f.type != schema_pb2.STRUCT:
-        result.append((feature_path, f))
-      else:
-        _recursion_helper(feature_path, f.struct_domain.feature, result)
+  return SchemaIndex(schema).get_all_leaf_features()
+
+
+# The precomputed part of a SchemaIndex, which only depends on the serialized
+# schema and is shared by the indexes of equal schemas.
+_IndexedSchema = collections.namedtuple('_IndexedSchema', [
+    'index', 'leaf_features', 'categorical_features',
+    'categorical_numeric_features', 'multivalent_features', 'bytes_features'
+])
+
+
+# The module-level helpers above build an index on every call, so the indexes
+# of the most recently used schemas are cached.
+@functools.lru_cache(maxsize=8)
+def _index_serialized_schema(serialized_schema: bytes) -> _IndexedSchema:
+  """Indexes a serialized schema natively."""
+  index = validation_pywrap.SchemaIndex(serialized_schema)
+  return _IndexedSchema(
+      index=index,
+      leaf_features=tuple(
+          (types.FeaturePath(steps), positions) for steps, positions in zip(
+              index.LeafFeatures(), index.LeafFeaturePositions())),
+      categorical_features=frozenset(
+          types.FeaturePath(steps) for steps in index.CategoricalFeatures()),
+      categorical_numeric_features=tuple(
+          types.FeaturePath(steps)
+          for steps in index.CategoricalNumericFeatures()),
+      multivalent_features=frozenset(
+          types.FeaturePath(steps) for steps in index.MultivalentFeatures()),
+      bytes_features=tuple(
+          types.FeaturePath(steps) for steps in index.BytesFeatures()))
+
+
+class SchemaIndex(object):
+  """An index of the features and global string domains of a schema.
+
+  The index is built natively, and then looks up the features by path and the
+  global string domains by name in constant time. The leaf, categorical,
+  multivalent and bytes features are computed when the index is built, and
+  indexes of equal schemas share them. Features must not be added to, removed
+  from or renamed in the schema while it is indexed. The indexed features can
+  be modified, but the index must be rebuilt for changes to their type,
+  domain, shape or value count to be reflected in the categorical,
+  multivalent and bytes features. The index is picklable.
+  """
 
-  result = []
-  _recursion_helper(types.FeaturePath([]), schema.feature, result)
-  return result
+  def __init__(self, schema: schema_pb2.Schema):
+    if not isinstance(schema, schema_pb2.Schema):
+      raise TypeError('schema is of type %s, should be a Schema proto.' %
+                      type(schema).__name__)
+    self._schema = schema
+    indexed_schema = _index_serialized_schema(schema.SerializeToString())
+    self._index = indexed_schema.index
+    self._leaf_features = indexed_schema.leaf_features
+    self._categorical_features = indexed_schema.categorical_features
+    self._categorical_numeric_features = (
+        indexed_schema.categorical_numeric_features)
+    self._multivalent_features = indexed_schema.multivalent_features
+    self._bytes_features = indexed_schema.bytes_features
+
+  def __getstate__(self):
+    return self._schema.SerializeToString()
+
+  def __setstate__(self, state):
+    self.__init__(schema_pb2.Schema.FromString(state))
+
+  @property
+  def schema(self) -> schema_pb2.Schema:
+    return self._schema
+
+  def _get_feature_at(self, positions: List[int]) -> schema_pb2.Feature:
+    feature = self._schema.feature[positions[0]]
+    for position in positions[1:]:
+      feature = feature.struct_domain.feature[position]
+    return feature
+
+  def get_feature(self,
+                  feature_path: Union[types.FeatureName, types.FeaturePath]
+                 ) -> schema_pb2.Feature:
+    """Gets a feature from the schema, as get_feature."""
+    if not isinstance(feature_path, types.FeaturePath):
+      feature_path = types.FeaturePath([feature_path])
+    positions = self._index.GetFeaturePositions(list(feature_path.steps()))
+    if not positions:
+      # Raises the error describing why the feature is not found.
+      return get_feature(self._schema, feature_path)
+    return self._get_feature_at(positions)
+
+  def get_domain(self,
+                 feature_path: Union[types.FeatureName, types.FeaturePath]
+                ) -> FEATURE_DOMAIN:
+    """Gets the domain of a feature from the schema, as get_domain."""
+
+    def _get_global_domain(name: Text) -> Optional[schema_pb2.StringDomain]:
+      position = self._index.GetStringDomainPosition(name)
+      return self._schema.string_domain[position] if position >= 0 else None
+
+    return _get_feature_domain(
+        self.get_feature(feature_path), feature_path, _get_global_domain)
+
+  def get_all_leaf_features(
+      self) -> List[Tuple[types.FeaturePath, schema_pb2.Feature]]:
+    """Returns all leaf features in the schema."""
+    return [(feature_path, self._get_feature_at(positions))
+            for feature_path, positions in self._leaf_features]
+
+  def get_categorical_features(self) -> Set[types.FeaturePath]:
+    """Returns the set of the paths of the categorical features."""
+    return set(self._categorical_features)
+
+  def get_categorical_numeric_features(self) -> List[types.FeaturePath]:
+    """Returns the int features that should be treated as categorical."""
+    return list(self._categorical_numeric_features)
+
+  def get_multivalent_features(self) -> Set[types.FeaturePath]:
+    """Returns the set of the paths of the multivalent features.
+
+    A feature is univalent if it either has a shape of one dimension of size 1
+    or a max value count of 1.
+    """
+    return set(self._multivalent_features)
+
+  def get_bytes_features(self) -> List[types.FeaturePath]:
+    """Returns the features that should be treated as bytes."""
+    return list(self._bytes_features)
@@ -18,6 +18,7 @@ from __future__ import division
 from __future__ import print_function
 
 import os
+import pickle
 from absl import flags
 from absl.testing import absltest
 from absl.testing import parameterized
@@ -353,6 +354,13 @@ class SchemaUtilTest(parameterized.TestCase):
     loaded_schema = schema_util.load_schema_text(input_path=schema_path)
     self.assertEqual(schema, loaded_schema)
 
+  def test_load_schema_text_invalid_text(self):
+    schema_path = os.path.join(FLAGS.test_tmpdir, 'invalid_schema.pbtxt')
+    with open(schema_path, 'w') as f:
+      f.write('feature { unknown_field: 1 }')
+    with self.assertRaisesRegexp(text_format.ParseError, '1:11'):
+      _ = schema_util.load_schema_text(input_path=schema_path)
+
   def test_write_schema_text_invalid_schema_input(self):
     with self.assertRaisesRegexp(TypeError, 'should be a Schema proto'):
       _ = schema_util.write_schema_text({}, 'schema.pbtxt')
@@ -658,5 +666,122 @@ class SchemaUtilTest(parameterized.TestCase):
         schema_util.look_up_feature('feature2', container), feature_2)
     self.assertEqual(schema_util.look_up_feature('feature3', container), None)
 
+
+class SchemaIndexTest(absltest.TestCase):
+
+  def setUp(self):
+    super(SchemaIndexTest, self).setUp()
+    self._schema = text_format.Parse(
+        """
+        feature {
+          name: "fa"
+          type: BYTES
+          domain: "colors"
+          value_count { min: 1 max: 1 }
+        }
+        feature {
+          name: "fb"
+          type: INT
+          int_domain { is_categorical: true }
+        }
+        feature {
+          name: "fc"
+          type: BYTES
+          image_domain {}
+          shape { dim { size: 1 } }
+        }
+        feature {
+          name: "fd"
+          type: STRUCT
+          struct_domain {
+            feature { name: "fd_fa" type: FLOAT }
+            feature { name: "fd_fb" type: INT bool_domain {} }
+          }
+        }
+        string_domain { name: "sizes" value: "small" }
+        string_domain { name: "colors" value: "red" }
+        string_domain { name: "colors" value: "blue" }
+        """, schema_pb2.Schema())
+    self._index = schema_util.SchemaIndex(self._schema)
+
+  def test_get_feature(self):
+    self.assertIs(self._index.get_feature('fa'), self._schema.feature[0])
+    self.assertIs(
+        self._index.get_feature(types.FeaturePath(['fd', 'fd_fb'])),
+        self._schema.feature[3].struct_domain.feature[1])
+    # The indexed features can be modified.
+    self._index.get_feature('fb').int_domain.max = 10
+    self.assertEqual(self._schema.feature[1].int_domain.max, 10)
+
+  def test_get_feature_not_present(self):
+    with self.assertRaisesRegexp(ValueError,
+                                 'Feature.*not found in the schema.*'):
+      self._index.get_feature(types.FeaturePath(['fd', 'fd_fc']))
+    with self.assertRaisesRegexp(ValueError,
+                                 'does not refer to a valid STRUCT feature'):
+      self._index.get_feature(types.FeaturePath(['fa', 'fa_fa']))
+
+  def test_get_domain(self):
+    self.assertIs(self._index.get_domain('fa'), self._schema.string_domain[1])
+    self.assertIs(
+        self._index.get_domain(types.FeaturePath(['fd', 'fd_fb'])),
+        self._schema.feature[3].struct_domain.feature[1].bool_domain)
+    with self.assertRaisesRegexp(ValueError, 'has no domain'):
+      self._index.get_domain(types.FeaturePath(['fd', 'fd_fa']))
+
+  def test_features_sets(self):
+    self.assertEqual(self._index.get_all_leaf_features(),
+                     [(types.FeaturePath(['fa']), self._schema.feature[0]),
+                      (types.FeaturePath(['fb']), self._schema.feature[1]),
+                      (types.FeaturePath(['fc']), self._schema.feature[2]),
+                      (types.FeaturePath(['fd', 'fd_fa']),
+                       self._schema.feature[3].struct_domain.feature[0]),
+                      (types.FeaturePath(['fd', 'fd_fb']),
+                       self._schema.feature[3].struct_domain.feature[1])])
+    self.assertEqual(
+        self._index.get_categorical_features(),
+        set([types.FeaturePath(['fa']),
+             types.FeaturePath(['fb']),
+             types.FeaturePath(['fc']),
+             types.FeaturePath(['fd', 'fd_fb'])]))
+    self.assertEqual(
+        self._index.get_categorical_numeric_features(),
+        [types.FeaturePath(['fb']), types.FeaturePath(['fd', 'fd_fb'])])
+    self.assertEqual(
+        self._index.get_multivalent_features(),
+        set([types.FeaturePath(['fb']),
+             types.FeaturePath(['fd', 'fd_fa']),
+             types.FeaturePath(['fd', 'fd_fb'])]))
+    self.assertEqual(self._index.get_bytes_features(),
+                     [types.FeaturePath(['fc'])])
+
+  def test_equal_and_modified_schemas(self):
+    schema = schema_pb2.Schema()
+    schema.CopyFrom(self._schema)
+    index = schema_util.SchemaIndex(schema)
+    # The features are looked up in the schema the index was built for.
+    self.assertIs(index.get_feature('fb'), schema.feature[1])
+    self.assertIs(index.get_all_leaf_features()[1][1], schema.feature[1])
+    # The feature sets reflect modified features once the index is rebuilt.
+    schema.feature[1].int_domain.is_categorical = False
+    self.assertIn(types.FeaturePath(['fb']), index.get_categorical_features())
+    self.assertNotIn(
+        types.FeaturePath(['fb']),
+        schema_util.SchemaIndex(schema).get_categorical_features())
+    self.assertIn(types.FeaturePath(['fb']),
+                  self._index.get_categorical_features())
+
+  def test_pickle(self):
+    index = pickle.loads(pickle.dumps(self._index))
+    self.assertEqual(index.schema, self._schema)
+    self.assertEqual(index.get_feature('fb'), self._schema.feature[1])
+    self.assertEqual(index.get_multivalent_features(),
+                     self._index.get_multivalent_features())
+
+  def test_invalid_schema_input(self):
+    with self.assertRaisesRegexp(TypeError, '.*should be a Schema proto.*'):
+      schema_util.SchemaIndex({})
+
+
 if __name__ == '__main__':
   absltest.main()
@@ -174,17 +174,17 @@ def generate_statistics_from_csv(
     skip_header_lines = 1 if column_names is None else 0
     if column_names is None:
       column_names = get_csv_header(data_location, delimiter)
+    # The files are read and decoded a chunk of records at a time natively.
     _ = (
         p
-        | 'ReadData' >> beam.io.textio.ReadFromText(
-            file_pattern=data_location,
-            skip_header_lines=skip_header_lines,
-            compression_type=compression_type)
-        | 'DecodeData' >> csv_decoder.DecodeCSV(
+        | 'CreateFilePattern' >> beam.Create([data_location])
+        | 'ReadAndDecodeData' >> csv_decoder.DecodeCSVFiles(
             column_names=column_names,
             delimiter=delimiter,
             schema=stats_options.schema
             if stats_options.infer_type_from_schema else None,
+            skip_header_lines=skip_header_lines,
+            compression_type=compression_type,
             desired_batch_size=batch_size)
         | 'GenerateStatistics' >> stats_api.GenerateStatistics(stats_options)
         | 'WriteStatsOutput' >> stats_api.WriteStatisticsToTFRecord(
@@ -24,8 +24,10 @@ import pyarrow as pa
 import tensorflow as tf
 from tensorflow_data_validation import types
 from tensorflow_data_validation.arrow import arrow_util
+from tensorflow_data_validation.pywrap.tensorflow_data_validation_extension import statistics as statistics_pywrap
+from tensorflow_data_validation.pywrap.tensorflow_data_validation_extension import text_format as text_format_pywrap
 from tensorflow_data_validation.utils import io_util
-from typing import Dict, Optional, Text, Union
+from typing import Dict, Iterable, Optional, Text, Union
 from google.protobuf import text_format
 from tensorflow_metadata.proto.v0 import statistics_pb2
 
@@ -46,6 +48,11 @@ _NP_DTYPE_KIND_TO_FEATURE_TYPE = {
 DOMAIN_INFO = 'domain_info'
 # LINT.ThenChange(../anomalies/custom_domain_util.cc)
 
+# LINT.IfChange
+# The first bytes of files written by write_stats_columnar.
+_COLUMNAR_STATS_MAGIC = b'TFDVCST1'
+# LINT.ThenChange(../anomalies/columnar_statistics.h)
+
 
 def maybe_get_utf8(value: bytes) -> Optional[Text]:
   """Returns the value decoded as utf-8, or None if it cannot be decoded.
@@ -195,7 +202,8 @@ def write_stats_text(stats: statistics_pb2.DatasetFeatureStatisticsList,
         'stats is of type %s, should be a '
         'DatasetFeatureStatisticsList proto.' % type(stats).__name__)
 
-  stats_proto_text = text_format.MessageToString(stats)
+  stats_proto_text = text_format_pywrap.PrintTextProto(
+      stats.DESCRIPTOR.full_name, stats.SerializeToString(), 0)
   io_util.write_string_to_file(output_path, stats_proto_text)
 
 
@@ -210,10 +218,14 @@ def load_stats_text(
   Returns:
     A DatasetFeatureStatisticsList proto.
   """
-  stats_proto = statistics_pb2.DatasetFeatureStatisticsList()
   stats_text = io_util.read_file_to_string(input_path)
-  text_format.Parse(stats_text, stats_proto)
-  return stats_proto
+  try:
+    return statistics_pb2.DatasetFeatureStatisticsList.FromString(
+        text_format_pywrap.ParseTextProto(
+            statistics_pb2.DatasetFeatureStatisticsList.DESCRIPTOR.full_name,
+            stats_text))
+  except RuntimeError as e:
+    raise text_format.ParseError(str(e))
 
 
 def load_stats_tfrecord(
@@ -232,6 +244,137 @@ def load_stats_tfrecord(
   return result
 
 
+def write_stats_columnar(stats: statistics_pb2.DatasetFeatureStatisticsList,
+                         output_path: Text) -> None:
+  """Writes a DatasetFeatureStatisticsList proto to a file in columnar format.
+
+  The columnar format stores one row per (slice, feature), with the common
+  statistics, histograms and custom statistics in separate columns. It is
+  lossless, and load_stats_columnar can read a subset of its slices, features
+  and columns without parsing the rest of the file.
+
+  Args:
+    stats: A DatasetFeatureStatisticsList proto.
+    output_path: File path to write the columnar statistics.
+
+  Raises:
+    TypeError: If the input proto is not of the expected type.
+  """
+  if not isinstance(stats, statistics_pb2.DatasetFeatureStatisticsList):
+    raise TypeError(
+        'stats is of type %s, should be a '
+        'DatasetFeatureStatisticsList proto.' % type(stats).__name__)
+
+  columnar_stats = statistics_pywrap.WriteColumnarStatistics(
+      stats.SerializeToString())
+  with tf.io.gfile.GFile(output_path, mode='wb') as f:
+    f.write(columnar_stats)
+
+
+def load_stats_columnar(
+    input_path: Text,
+    feature_paths: Optional[Iterable[types.FeaturePath]] = None,
+    slice_keys: Optional[Iterable[Text]] = None,
+    include_histograms: bool = True,
+    include_custom_stats: bool = True
+) -> statistics_pb2.DatasetFeatureStatisticsList:
+  """Loads statistics written by write_stats_columnar.
+
+  The file is memory-mapped, and only the requested parts of it are decoded.
+
+  Args:
+    input_path: Local path of the columnar statistics file.
+    feature_paths: If not None, only the statistics of these features are
+      loaded. Features identified by name match the single-step path.
+    slice_keys: If not None, only the statistics of these slices are loaded,
+      in this order.
+    include_histograms: Whether to load the numeric and rank histograms.
+    include_custom_stats: Whether to load the custom statistics.
+
+  Returns:
+    A DatasetFeatureStatisticsList proto.
+  """
+  if feature_paths is not None:
+    feature_paths = [list(path.steps()) for path in feature_paths]
+  if slice_keys is not None:
+    slice_keys = list(slice_keys)
+  return statistics_pb2.DatasetFeatureStatisticsList.FromString(
+      statistics_pywrap.ReadColumnarStatistics(
+          input_path, feature_paths, slice_keys, include_histograms,
+          include_custom_stats))
+
+
+def compact_stats_for_validation(
+    stats: statistics_pb2.DatasetFeatureStatisticsList,
+    keep_weighted_stats: bool = True
+) -> statistics_pb2.DatasetFeatureStatisticsList:
+  """Removes the statistics that are not used to validate or infer a schema.
+
+  The compacted statistics give the same anomalies as the original ones when
+  validated, but are smaller to store and faster to parse. Removed are the
+  cross-feature statistics, the value count histograms, the buckets of the
+  quantiles histograms, the top values and the custom statistics that are not
+  used for validation.
+
+  Args:
+    stats: A DatasetFeatureStatisticsList proto.
+    keep_weighted_stats: If False, the weighted statistics are removed too,
+      and the compacted statistics are always validated as unweighted.
+
+  Returns:
+    The compacted DatasetFeatureStatisticsList proto.
+
+  Raises:
+    TypeError: If the input proto is not of the expected type.
+  """
+  if not isinstance(stats, statistics_pb2.DatasetFeatureStatisticsList):
+    raise TypeError(
+        'stats is of type %s, should be a '
+        'DatasetFeatureStatisticsList proto.' % type(stats).__name__)
+  return statistics_pb2.DatasetFeatureStatisticsList.FromString(
+      statistics_pywrap.CompactStatisticsForValidation(
+          stats.SerializeToString(), keep_weighted_stats))
+
+
+def merge_statistics(
+    stats_list: Iterable[statistics_pb2.DatasetFeatureStatisticsList]
+) -> statistics_pb2.DatasetFeatureStatisticsList:
+  """Merges the statistics of disjoint datasets, e.g. of a window of spans.
+
+  Datasets are matched by name and features by path. The counts, the moments
+  and the ranges are merged exactly. If every input carries the mergeable
+  sketches of a feature (see StatsOptions.enable_mergeable_sketches), its
+  unique count, top values, median and histograms are computed from the
+  merged sketches. Otherwise they are approximated from the histograms and
+  the top values of the inputs.
+
+  Args:
+    stats_list: DatasetFeatureStatisticsList protos to merge.
+
+  Returns:
+    The merged DatasetFeatureStatisticsList proto.
+
+  Raises:
+    TypeError: If an input proto is not of the expected type.
+    RuntimeError: If the statistics cannot be merged, e.g. if a feature has
+      different types in the inputs.
+  """
+  serialized = []
+  for stats in stats_list:
+    if not isinstance(stats, statistics_pb2.DatasetFeatureStatisticsList):
+      raise TypeError(
+          'stats is of type %s, should be a '
+          'DatasetFeatureStatisticsList proto.' % type(stats).__name__)
+    serialized.append(stats.SerializeToString())
+  return statistics_pb2.DatasetFeatureStatisticsList.FromString(
+      statistics_pywrap.MergeStatistics(serialized))
+
+
+def _is_columnar_stats_file(input_path: Text) -> bool:
+  with tf.io.gfile.GFile(input_path, mode='rb') as f:
+    return f.read(len(_COLUMNAR_STATS_MAGIC)) == _COLUMNAR_STATS_MAGIC
+
+
 def get_feature_stats(stats: statistics_pb2.DatasetFeatureStatistics,
                       feature_path: types.FeaturePath
                      ) -> statistics_pb2.FeatureNameStatistics:
@@ -323,7 +466,8 @@ def load_statistics(
 
   Args:
     input_path: Data statistics file path. The file should be a one-record
-      TFRecord file or a plain file containing the serialized statistics proto.
+      TFRecord file, a plain file containing the serialized statistics proto
+      or a columnar statistics file written by write_stats_columnar.
 
   Returns:
     A DatasetFeatureStatisticsList proto.
@@ -333,6 +477,8 @@ def load_statistics(
   """
   if not tf.io.gfile.exists(input_path):
     raise IOError('Invalid input path {}.'.format(input_path))
+  if _is_columnar_stats_file(input_path):
+    return load_stats_columnar(input_path)
   try:
     return load_stats_tfrecord(input_path)
   except Exception:  # pylint: disable=broad-except
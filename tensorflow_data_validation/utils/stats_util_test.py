@@ -148,6 +148,127 @@ class StatsUtilTest(absltest.TestCase):
                      stats_util.load_stats_tfrecord(input_path=stats_path))
     self.assertEqual(stats, stats_util.load_statistics(input_path=stats_path))
 
+  def test_write_load_stats_columnar(self):
+    stats = text_format.Parse("""
+      datasets {
+        name: 'abc'
+        num_examples: 2
+        features {
+          path { step: 'a' }
+          type: STRING
+          string_stats {
+            common_stats { num_non_missing: 2 }
+            unique: 1
+            rank_histogram { buckets { label: 'x' sample_count: 2 } }
+          }
+          custom_stats { name: 'c' num: 1 }
+        }
+        features {
+          path { step: 'b' }
+          type: INT
+          num_stats { common_stats { num_missing: 2 } }
+        }
+      }
+      datasets { name: 'def' }
+    """, statistics_pb2.DatasetFeatureStatisticsList())
+    stats_path = os.path.join(FLAGS.test_tmpdir, 'stats.columnar')
+    stats_util.write_stats_columnar(stats=stats, output_path=stats_path)
+    self.assertEqual(stats,
+                     stats_util.load_stats_columnar(input_path=stats_path))
+    self.assertEqual(stats, stats_util.load_statistics(input_path=stats_path))
+
+    expected = text_format.Parse("""
+      datasets {
+        name: 'abc'
+        num_examples: 2
+        features {
+          path { step: 'a' }
+          type: STRING
+          string_stats {
+            common_stats { num_non_missing: 2 }
+            unique: 1
+          }
+        }
+      }
+    """, statistics_pb2.DatasetFeatureStatisticsList())
+    self.assertEqual(
+        expected,
+        stats_util.load_stats_columnar(
+            input_path=stats_path,
+            feature_paths=[types.FeaturePath(['a'])],
+            slice_keys=['abc'],
+            include_histograms=False,
+            include_custom_stats=False))
+
+  def test_compact_stats_for_validation(self):
+    stats = text_format.Parse("""
+      datasets {
+        num_examples: 2
+        features {
+          path { step: 'a' }
+          type: STRING
+          string_stats {
+            common_stats {
+              num_non_missing: 2
+              num_values_histogram { buckets { sample_count: 2 } }
+              weighted_common_stats { num_non_missing: 3 }
+            }
+            top_values { value: 'x' frequency: 2 }
+            rank_histogram {
+              buckets { low_rank: 0 high_rank: 0 label: 'x' sample_count: 2 }
+            }
+          }
+          custom_stats { name: 'c' num: 1 }
+          custom_stats { name: 'domain_info' str: 'int_domain {}' }
+        }
+      }
+    """, statistics_pb2.DatasetFeatureStatisticsList())
+    expected = text_format.Parse("""
+      datasets {
+        num_examples: 2
+        features {
+          path { step: 'a' }
+          type: STRING
+          string_stats {
+            common_stats { num_non_missing: 2 }
+            rank_histogram { buckets { label: 'x' sample_count: 2 } }
+          }
+          custom_stats { name: 'domain_info' str: 'int_domain {}' }
+        }
+      }
+    """, statistics_pb2.DatasetFeatureStatisticsList())
+    self.assertEqual(
+        expected,
+        stats_util.compact_stats_for_validation(
+            stats, keep_weighted_stats=False))
+
+  def test_merge_statistics(self):
+    stats = text_format.Parse("""
+      datasets {
+        num_examples: 2
+        features {
+          path { step: 'a' }
+          type: INT
+          num_stats {
+            common_stats { num_non_missing: 2 min_num_values: 1 }
+            min: 1
+            max: 3
+          }
+        }
+      }
+    """, statistics_pb2.DatasetFeatureStatisticsList())
+    merged = stats_util.merge_statistics([stats, stats])
+    self.assertEqual(merged.datasets[0].num_examples, 4)
+    num_stats = merged.datasets[0].features[0].num_stats
+    self.assertEqual(num_stats.common_stats.num_non_missing, 4)
+    self.assertEqual(num_stats.min, 1)
+    self.assertEqual(num_stats.max, 3)
+
+  def test_merge_statistics_invalid_stats_input(self):
+    with self.assertRaisesRegexp(
+        TypeError, '.*should be a DatasetFeatureStatisticsList proto.'):
+      _ = stats_util.merge_statistics([{}])
+
   def test_write_stats_text_invalid_stats_input(self):
     with self.assertRaisesRegexp(
         TypeError, '.*should be a DatasetFeatureStatisticsList proto.'):
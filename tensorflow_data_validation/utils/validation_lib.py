@@ -21,9 +21,10 @@ from __future__ import print_function
 import os
 import tempfile
 
-from typing import List, Optional, Text
+from typing import Dict, List, Optional, Text
 import apache_beam as beam
 from apache_beam.options.pipeline_options import PipelineOptions
+import pyarrow as pa
 import tensorflow as tf
 from tensorflow_data_validation import types
 from tensorflow_data_validation.api import stats_api
@@ -37,14 +38,16 @@ from tensorflow_data_validation.utils import stats_util
 
 from tensorflow_metadata.proto.v0 import statistics_pb2
 
+_ANOMALOUS_EXAMPLES_FILE_NAME = 'anomalous_examples.tfrecord'
+
 
 def validate_examples_in_tfrecord(
     data_location: Text,
     stats_options: options.StatsOptions,
     output_path: Optional[Text] = None,
-    # TODO(b/131719250): Add option to output a sample of anomalous examples for
-    # each anomaly reason.
     pipeline_options: Optional[PipelineOptions] = None,
+    num_anomalous_examples_per_reason: int = 0,
+    anomalous_examples_output_path: Optional[Text] = None,
 ) -> statistics_pb2.DatasetFeatureStatisticsList:
   """Validates TFExamples in TFRecord files.
 
@@ -72,35 +75,57 @@ def validate_examples_in_tfrecord(
       (DirectRunner or DataflowRunner), cloud dataflow service project id, etc.
       See https://cloud.google.com/dataflow/pipelines/specifying-exec-params for
       more details.
+    num_anomalous_examples_per_reason: The maximum number of anomalous examples
+      to output for each anomaly reason. If 0, no anomalous examples are
+      output.
+    anomalous_examples_output_path: The file path to output the anomalous
+      examples to, which can be read with the 'load_anomalous_examples'
+      function. If None, the function uses 'anomalous_examples.tfrecord' in the
+      directory of output_path.
 
   Returns:
     A DatasetFeatureStatisticsList proto in which each dataset consists of the
       set of examples that exhibit a particular anomaly.
 
   Raises:
-    ValueError: If the specified stats_options does not include a schema.
+    ValueError: If the specified stats_options does not include a schema, or
+      if num_anomalous_examples_per_reason is negative.
   """
   if stats_options.schema is None:
     raise ValueError('The specified stats_options must include a schema.')
+  if num_anomalous_examples_per_reason < 0:
+    raise ValueError('num_anomalous_examples_per_reason must not be negative.')
   if output_path is None:
     output_path = os.path.join(tempfile.mkdtemp(), 'anomaly_stats.tfrecord')
   output_dir_path = os.path.dirname(output_path)
   if not tf.io.gfile.exists(output_dir_path):
     tf.io.gfile.makedirs(output_dir_path)
+  if anomalous_examples_output_path is None:
+    anomalous_examples_output_path = os.path.join(
+        output_dir_path, _ANOMALOUS_EXAMPLES_FILE_NAME)
 
   with beam.Pipeline(options=pipeline_options) as p:
-    _ = (
+    anomalous_examples = (
         p
         | 'ReadData' >> beam.io.ReadFromTFRecord(file_pattern=data_location)
         | 'DecodeData' >> tf_example_decoder.DecodeTFExample(
             desired_batch_size=1)
         | 'DetectAnomalies' >>
-        validation_api.IdentifyAnomalousExamples(stats_options)
+        validation_api.IdentifyAnomalousExamples(stats_options))
+    _ = (
+        anomalous_examples
         |
         'GenerateSummaryStatistics' >> stats_impl.GenerateSlicedStatisticsImpl(
             stats_options, is_slicing_enabled=True)
         | 'WriteStatsOutput' >> stats_api.WriteStatisticsToTFRecord(
             output_path))
+    if num_anomalous_examples_per_reason:
+      _ = (
+          anomalous_examples
+          | 'SampleAnomalousExamples' >> validation_api.SampleAnomalousExamples(
+              num_anomalous_examples_per_reason)
+          | 'WriteAnomalousExamples' >> beam.io.WriteToTFRecord(
+              anomalous_examples_output_path, shard_name_template=''))
 
   return stats_util.load_statistics(output_path)
 
@@ -111,9 +136,9 @@ def validate_examples_in_csv(
     column_names: Optional[List[types.FeatureName]] = None,
     delimiter: Text = ',',
     output_path: Optional[Text] = None,
-    # TODO(b/131719250): Add option to output a sample of anomalous examples for
-    # each anomaly reason.
     pipeline_options: Optional[PipelineOptions] = None,
+    num_anomalous_examples_per_reason: int = 0,
+    anomalous_examples_output_path: Optional[Text] = None,
 ) -> statistics_pb2.DatasetFeatureStatisticsList:
   """Validates examples in csv files.
 
@@ -146,21 +171,34 @@ def validate_examples_in_csv(
       (DirectRunner or DataflowRunner), cloud dataflow service project id, etc.
       See https://cloud.google.com/dataflow/pipelines/specifying-exec-params for
         more details.
+    num_anomalous_examples_per_reason: The maximum number of anomalous examples
+      to output for each anomaly reason. If 0, no anomalous examples are
+      output.
+    anomalous_examples_output_path: The file path to output the anomalous
+      examples to, which can be read with the 'load_anomalous_examples'
+      function. If None, the function uses 'anomalous_examples.tfrecord' in the
+      directory of output_path.
 
   Returns:
     A DatasetFeatureStatisticsList proto in which each dataset consists of the
       set of examples that exhibit a particular anomaly.
 
   Raises:
-    ValueError: If the specified stats_options does not include a schema.
+    ValueError: If the specified stats_options does not include a schema, or
+      if num_anomalous_examples_per_reason is negative.
   """
   if stats_options.schema is None:
     raise ValueError('The specified stats_options must include a schema.')
+  if num_anomalous_examples_per_reason < 0:
+    raise ValueError('num_anomalous_examples_per_reason must not be negative.')
   if output_path is None:
     output_path = os.path.join(tempfile.mkdtemp(), 'anomaly_stats.tfrecord')
   output_dir_path = os.path.dirname(output_path)
   if not tf.io.gfile.exists(output_dir_path):
     tf.io.gfile.makedirs(output_dir_path)
+  if anomalous_examples_output_path is None:
+    anomalous_examples_output_path = os.path.join(
+        output_dir_path, _ANOMALOUS_EXAMPLES_FILE_NAME)
 
   # If a header is not provided, assume the first line in a file
   # to be the header.
@@ -169,7 +207,7 @@ def validate_examples_in_csv(
     column_names = stats_gen_lib.get_csv_header(data_location, delimiter)
 
   with beam.Pipeline(options=pipeline_options) as p:
-    _ = (
+    anomalous_examples = (
         p
         | 'ReadData' >> beam.io.textio.ReadFromText(
             file_pattern=data_location, skip_header_lines=skip_header_lines)
@@ -180,11 +218,41 @@ def validate_examples_in_csv(
             if stats_options.infer_type_from_schema else None,
             desired_batch_size=1)
         | 'DetectAnomalies' >>
-        validation_api.IdentifyAnomalousExamples(stats_options)
+        validation_api.IdentifyAnomalousExamples(stats_options))
+    _ = (
+        anomalous_examples
         |
         'GenerateSummaryStatistics' >> stats_impl.GenerateSlicedStatisticsImpl(
             stats_options, is_slicing_enabled=True)
         | 'WriteStatsOutput' >> stats_api.WriteStatisticsToTFRecord(
             output_path))
+    if num_anomalous_examples_per_reason:
+      _ = (
+          anomalous_examples
+          | 'SampleAnomalousExamples' >> validation_api.SampleAnomalousExamples(
+              num_anomalous_examples_per_reason)
+          | 'WriteAnomalousExamples' >> beam.io.WriteToTFRecord(
+              anomalous_examples_output_path, shard_name_template=''))
 
   return stats_util.load_statistics(output_path)
+
+
+def load_anomalous_examples(
+    input_path: Text) -> Dict[Text, List[pa.RecordBatch]]:
+  """Loads the anomalous examples output by the validate_examples functions.
+
+  Args:
+    input_path: The file path the anomalous examples were output to.
+
+  Returns:
+    A dict mapping each anomaly reason to a sample of its anomalous examples,
+    as RecordBatches of a single row. The anomaly reasons are the names of the
+    datasets of the statistics output by the validate_examples functions.
+
+  Raises:
+    IOError: If the input path does not exist.
+  """
+  if not tf.io.gfile.exists(input_path):
+    raise IOError('Invalid input path {}.'.format(input_path))
+  serialized = next(tf.compat.v1.io.tf_record_iterator(input_path))
+  return validation_api.parse_anomalous_examples(serialized)
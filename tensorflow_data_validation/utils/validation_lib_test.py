@@ -529,5 +529,56 @@ class ValidationLibTest(absltest.TestCase):
     compare_fn([result])
 
 
+  def test_validate_examples_in_csv_with_anomalous_examples(self):
+    data_location, _, options, expected_result = (
+        self._get_anomalous_csv_test(
+            delimiter=',',
+            output_column_names=False,
+            generate_single_file=True,
+            has_schema=True))
+    output_path = os.path.join(self.create_tempdir().full_path,
+                               'anomaly_stats.tfrecord')
+
+    result = validation_lib.validate_examples_in_csv(
+        data_location=data_location,
+        stats_options=options,
+        column_names=None,
+        delimiter=',',
+        output_path=output_path,
+        num_anomalous_examples_per_reason=2)
+    compare_fn = test_util.make_dataset_feature_stats_list_proto_equal_fn(
+        self, expected_result)
+    compare_fn([result])
+    # The anomalous examples are output next to the statistics by default.
+    anomalous_examples = validation_lib.load_anomalous_examples(
+        os.path.join(os.path.dirname(output_path),
+                     'anomalous_examples.tfrecord'))
+    self.assertCountEqual(
+        anomalous_examples.keys(),
+        ['annotated_enum_ENUM_TYPE_UNEXPECTED_STRING_VALUES'])
+    examples = anomalous_examples[
+        'annotated_enum_ENUM_TYPE_UNEXPECTED_STRING_VALUES']
+    self.assertLen(examples, 1)
+    self.assertEqual(
+        examples[0].column(
+            examples[0].schema.get_field_index('annotated_enum')).to_pylist(),
+        [[b'D']])
+
+  def test_validate_examples_in_csv_negative_anomalous_examples(self):
+    data_location, _, options, _ = (
+        self._get_anomalous_csv_test(
+            delimiter=',',
+            output_column_names=False,
+            generate_single_file=True,
+            has_schema=True))
+
+    with self.assertRaisesRegexp(
+        ValueError, 'num_anomalous_examples_per_reason must not be negative'):
+      validation_lib.validate_examples_in_csv(
+          data_location=data_location,
+          stats_options=options,
+          num_anomalous_examples_per_reason=-1)
+
+
 if __name__ == '__main__':
   absltest.main()